@@ -0,0 +1,109 @@
+//! -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+//!
+//! This file is part of the Feel++ library
+//!
+//! This library is free software; you can redistribute it and/or
+//! modify it under the terms of the GNU Lesser General Public
+//! License as published by the Free Software Foundation; either
+//! version 2.1 of the License, or (at your option) any later version.
+//!
+//! This library is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//! Lesser General Public License for more details.
+//!
+//! You should have received a copy of the GNU Lesser General Public
+//! License along with this library; if not, write to the Free Software
+//! Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//!
+//! @file
+//! @copyright 2023 Feel++ Consortium
+//!
+
+#include <random>
+
+#include <benchmark/benchmark.h>
+#include <feel/feelfilters/unitcube.hpp>
+#include <feel/feelmesh/bvh.hpp>
+
+using namespace Feel;
+
+namespace
+{
+std::string bvhKind( int k ) { return k == 0 ? "in-house" : "third-party"; }
+
+//! surface mesh of the unit cube with mesh size 1/n
+auto cubeBoundary( int n )
+{
+    static std::map<int,std::shared_ptr<Mesh<Simplex<3>>>> meshes;
+    auto & mesh = meshes[n];
+    if ( !mesh )
+        mesh = unitCube( 1./n );
+    return boundaryfaces( mesh );
+}
+
+//! rays inside the cube, coherent rays are sent by packets of 8 rays of the same direction
+std::vector<BVHRay<3>> cubeRays( int nRays, bool coherent )
+{
+    std::mt19937 gen( 42 );
+    std::uniform_real_distribution<double> dist( 0.1, 0.9 );
+    std::vector<BVHRay<3>> rays;
+    Eigen::Vector3d dir;
+    for ( int k = 0; k < nRays; ++k )
+    {
+        Eigen::Vector3d origin( dist( gen ), dist( gen ), dist( gen ) );
+        if ( !coherent || k % 8 == 0 )
+            dir = Eigen::Vector3d( dist( gen )-0.5, dist( gen )-0.5, dist( gen )-0.5 ).normalized();
+        rays.push_back( BVHRay<3>( origin, dir ) );
+    }
+    return rays;
+}
+}
+
+// build of the tree : args = mesh size, kind, number of threads
+void BM_BVHBuild( benchmark::State& state )
+{
+    auto range = cubeBoundary( state.range(0) );
+    std::size_t nPrimitives = 0;
+    for (auto _ : state)
+    {
+        auto bvh = boundingVolumeHierarchy(_range=range,_kind=bvhKind( state.range(1) ),_nthreads=int(state.range(2)));
+        nPrimitives = bvh->primitiveInfo().size();
+    }
+    state.SetItemsProcessed( state.iterations()*nPrimitives );
+    state.SetLabel( bvhKind( state.range(1) ) + " nthreads=" + std::to_string( state.range(2) ) + " nfaces=" + std::to_string( nPrimitives ) );
+}
+BENCHMARK(BM_BVHBuild)->Unit(benchmark::kMillisecond)
+->Args({32,0,1})->Args({32,0,4})->Args({32,1,1})->Args({32,1,4})
+->Args({64,0,1})->Args({64,0,4})->Args({64,1,1})->Args({64,1,4});
+
+// closest intersection of a batch of rays, the items processed per second are rays per second :
+// args = mesh size, kind, number of threads, coherent rays
+void BM_BVHIntersect( benchmark::State& state )
+{
+    auto range = cubeBoundary( state.range(0) );
+    auto bvh = boundingVolumeHierarchy(_range=range,_kind=bvhKind( state.range(1) ),_nthreads=int(state.range(2)));
+    auto rays = cubeRays( 1 << 16, state.range(3) );
+    std::vector<typename std::decay_t<decltype(*bvh)>::rayintersection_result_type> res( rays.size() );
+    for (auto _ : state)
+    {
+        bvh->intersectClosest( rays.data(), rays.size(), res.data() );
+        benchmark::DoNotOptimize( res.data() );
+    }
+    state.SetItemsProcessed( state.iterations()*rays.size() );
+    state.SetLabel( bvhKind( state.range(1) ) + " nthreads=" + std::to_string( state.range(2) ) + ( state.range(3) ? " coherent" : " incoherent" ) );
+}
+BENCHMARK(BM_BVHIntersect)->Unit(benchmark::kMillisecond)
+->Args({64,0,1,0})->Args({64,0,1,1})->Args({64,0,4,0})->Args({64,0,4,1})
+->Args({64,1,1,0})->Args({64,1,1,1})->Args({64,1,4,0})->Args({64,1,4,1});
+
+int main(int argc, char** argv)
+{
+    Environment env( _argc=argc, _argv=argv,
+                     _about=about(_name="feelpp_bench_bvh",
+                                  _author="Feel++ Consortium",
+                                  _email="feelpp-devel@feelpp.org"));
+
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+}
@@ -118,6 +118,7 @@ OPTION(FEELPP_ENABLE_SYSTEM_EIGEN3 "enable system eigen3 support" OFF)
 OPTION(FEELPP_ENABLE_MOVE_SEMANTICS "enable move semantics(elision)" ON )
 OPTION(FEELPP_ENABLE_INSTANTIATION_MODE "Instantiation mode" ON )
 OPTION(FEELPP_ENABLE_MPI_MODE "Instantiation mode" ON )
+OPTION(FEELPP_ENABLE_MESH_DENSE_STORAGE "store the mesh entities in dense id-indexed pages instead of hash maps" OFF )
 OPTION(FEELPP_ENABLE_SCHED_SLURM "Enable Feel++ slurm submission scripts generation" OFF)
 OPTION(FEELPP_ENABLE_SCHED_CCC "Enable Feel++ tgcc/ccc submission scripts generation" OFF)
 OPTION(FEELPP_ENABLE_SCHED_LOADLEVELER "Enable Feel++ ibm(supermuc) submission scripts generation" OFF)
@@ -168,6 +169,11 @@ IF ( FEELPP_ENABLE_MPI_MODE )
   SET( FEELPP_ENABLE_MPI_MODE 1 )
 ENDIF()
 
+# mesh entities storage
+IF ( FEELPP_ENABLE_MESH_DENSE_STORAGE )
+  SET( FEELPP_ENABLE_MESH_DENSE_STORAGE 1 )
+ENDIF()
+
 # disable alignement
 MARK_AS_ADVANCED(FEELPP_DISABLE_EIGEN_ALIGNMENT)
 if ( FEELPP_DISABLE_EIGEN_ALIGNMENT )
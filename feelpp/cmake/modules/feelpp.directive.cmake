@@ -107,6 +107,7 @@ function(feelpp_print_directive)
   MESSAGE(STATUS " FEELPP_ENABLE_SIMPLE_WEB_SERVER: ${FEELPP_ENABLE_SIMPLE_WEB_SERVER}")
   MESSAGE(STATUS "")
   MESSAGE(STATUS "           FEELPP_MESH_MAX_ORDER: ${FEELPP_MESH_MAX_ORDER}")
+  MESSAGE(STATUS "FEELPP_ENABLE_MESH_DENSE_STORAGE: ${FEELPP_ENABLE_MESH_DENSE_STORAGE}")
   MESSAGE(STATUS "       FEELPP_INSTANTIATION_MODE: ${FEELPP_INSTANTIATION_MODE}")
   MESSAGE(STATUS "  FEELPP_INSTANTIATION_ORDER_MAX: ${FEELPP_INSTANTIATION_ORDER_MAX}")
   MESSAGE(STATUS "")
@@ -32,6 +32,7 @@
 #include <boost/serialization/complex.hpp>
 
 #include <feel/feelalg/backend.hpp>
+#include <feel/feelcore/profiler.hpp>
 // PETSc defines MatType which is used as a typename by eigen3 and it conflicts
 // undef MatType here to ensure compilation since it is not needed to compile this file
 #undef MatType
@@ -290,6 +291,7 @@ Backend<T,SizeT>::solve( sparse_matrix_ptrtype const& A,
                    vector_ptrtype const& b,
                    bool reusePC )
 {
+    FEELPP_PROFILE_REGION( "Backend::solve" );
     M_reusePC = reusePC;
 
     MatrixStructure matStructInitial = this->precMatrixStructure();
@@ -356,6 +358,7 @@ Backend<T,SizeT>::nlSolve( sparse_matrix_ptrtype& A,
                      const double tol, const int its,
                      bool reusePC, bool reuseJac )
 {
+    FEELPP_PROFILE_REGION( "Backend::nlSolve" );
     MatrixStructure matStructInitial = this->precMatrixStructure();
 
     M_nlsolver->setPreconditionerType( this->pcEnumType() );
@@ -482,6 +485,7 @@ Backend<T,SizeT>::nlSolve( sparse_matrix_ptrtype& A,
                      vector_ptrtype& b,
                      const double tol, const int its )
 {
+    FEELPP_PROFILE_REGION( "Backend::nlSolve" );
 
     M_nlsolver->setPreconditionerType( this->pcEnumType() );
     M_nlsolver->setKspSolverType( this->kspEnumType() );
@@ -0,0 +1,100 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*-
+
+ This file is part of the Feel++ library
+
+ Copyright (C) 2023 Feel++ Consortium
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Feel
+{
+/**
+ * Per thread buffer of the contributions which can not be added in place
+ * during a concurrent insertion (see MatrixSparse::addMatrixConcurrent and
+ * Vector::addVectorConcurrent) : rows of other processes (ghost rows),
+ * entries out of the sparsity pattern or containers which do not support the
+ * concurrent insertion at all.
+ *
+ * Each row is stored with its (process local) index, its column indices (none
+ * for a vector entry) and its values in three flat arrays, the buffer is
+ * then added in the container by one thread.
+ */
+template<typename T>
+class ConcurrentInsertionBuffer
+{
+public:
+    using value_type = T;
+
+    ConcurrentInsertionBuffer() : M_offsets( 1, 0 ) {}
+
+    //! add the row \p row of a matrix block with \p ncols columns
+    void addRow( int row, int ncols, int const* cols, value_type const* values )
+    {
+        M_rows.push_back( row );
+        M_cols.insert( M_cols.end(), cols, cols+ncols );
+        M_values.insert( M_values.end(), values, values+ncols );
+        M_offsets.push_back( M_values.size() );
+    }
+
+    //! add the entry \p row of a vector
+    void addEntry( int row, value_type value )
+    {
+        M_rows.push_back( row );
+        M_values.push_back( value );
+        M_offsets.push_back( M_values.size() );
+    }
+
+    //! number of rows (matrix) or entries (vector) in the buffer
+    std::size_t size() const { return M_rows.size(); }
+    bool empty() const { return M_rows.empty(); }
+
+    //! index of the k-th row
+    int row( std::size_t k ) const { return M_rows[k]; }
+    //! number of values of the k-th row
+    int nValues( std::size_t k ) const { return M_offsets[k+1]-M_offsets[k]; }
+    //! column indices of the k-th row of a matrix block
+    int* cols( std::size_t k ) { return M_cols.data()+M_offsets[k]; }
+    //! values of the k-th row
+    value_type* values( std::size_t k ) { return M_values.data()+M_offsets[k]; }
+
+    //! indices and values of the vector entries
+    int* rows() { return M_rows.data(); }
+    value_type* values() { return M_values.data(); }
+
+    void clear()
+    {
+        M_rows.clear();
+        M_cols.clear();
+        M_values.clear();
+        M_offsets.resize( 1 );
+    }
+
+    //! scratch array of the in place positions of a row, used by the containers
+    std::vector<value_type*>& positions() { return M_positions; }
+
+private:
+    std::vector<int> M_rows;
+    std::vector<std::size_t> M_offsets;
+    std::vector<int> M_cols;
+    std::vector<value_type> M_values;
+    std::vector<value_type*> M_positions;
+};
+
+} // namespace Feel
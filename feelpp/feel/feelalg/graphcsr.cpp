@@ -47,7 +47,9 @@ GraphCSR::GraphCSR( size_type n,
     M_n_oz( n, 0 ),
     M_storage(),
     M_mapRow( new datamap_type(this->worldCommPtr()) ),
-    M_mapCol( new datamap_type(this->worldCommPtr()) )
+    M_mapCol( new datamap_type(this->worldCommPtr()) ),
+    M_flatRowsAddDiagonal( false ),
+    M_closedFromFlatRows( false )
 {
     const int myrank = this->worldComm().globalRank();
     const int worldsize = this->worldComm().globalSize();
@@ -113,7 +115,9 @@ GraphCSR::GraphCSR( datamap_ptrtype const& mapRow,
     M_n_oz( 0 ),
     M_storage(),
     M_mapRow(mapRow),
-    M_mapCol(mapCol)
+    M_mapCol(mapCol),
+    M_flatRowsAddDiagonal( false ),
+    M_closedFromFlatRows( false )
 {}
 
 GraphCSR::GraphCSR( datamap_type const& mapRow,
@@ -127,7 +131,9 @@ GraphCSR::GraphCSR( datamap_type const& mapRow,
     M_n_oz( 0 ),
     M_storage(),
     M_mapRow( new datamap_type(mapRow) ),
-    M_mapCol( new datamap_type(mapCol) )
+    M_mapCol( new datamap_type(mapCol) ),
+    M_flatRowsAddDiagonal( false ),
+    M_closedFromFlatRows( false )
 {}
 
 
@@ -144,7 +150,9 @@ GraphCSR::GraphCSR( vf::BlocksBase<self_ptrtype> const & blockSet,
     M_n_oz( /*n*/0, 0 ),
     M_storage(),
     M_mapRow(),
-    M_mapCol()
+    M_mapCol(),
+    M_flatRowsAddDiagonal( false ),
+    M_closedFromFlatRows( false )
 {
     DVLOG(2) << " GraphCSR constructor from block graph\n";
 
@@ -207,11 +215,15 @@ GraphCSR::GraphCSR( GraphCSR const & g )
     M_n_nz( g.M_n_nz ),
     M_n_oz( g.M_n_oz ),
     M_storage( g.M_storage ),
+    M_ia( g.M_ia ),
+    M_ja( g.M_ja ),
     M_graphT( g.M_graphT ),
     M_mapRow(g.M_mapRow),
-    M_mapCol(g.M_mapCol)
-{
-}
+    M_mapCol(g.M_mapCol),
+    M_flatRows( g.M_flatRows ),
+    M_flatRowsAddDiagonal( g.M_flatRowsAddDiagonal ),
+    M_closedFromFlatRows( g.M_closedFromFlatRows )
+{}
 
 GraphCSR::~GraphCSR()
 {
@@ -233,6 +245,11 @@ GraphCSR::operator=( GraphCSR const& g )
         M_is_closed = g.M_is_closed;
         M_mapRow = g.M_mapRow;
         M_mapCol = g.M_mapCol;
+        M_ia = g.M_ia;
+        M_ja = g.M_ja;
+        M_flatRows = g.M_flatRows;
+        M_flatRowsAddDiagonal = g.M_flatRowsAddDiagonal;
+        M_closedFromFlatRows = g.M_closedFromFlatRows;
     }
 
     return *this;
@@ -267,6 +284,7 @@ void
 GraphCSR::mergeBlockGraph( self_ptrtype const& g,
                            size_type start_i, size_type start_j )
 {
+    g->expandFlatRows();
 
     auto it = g->begin();
     auto en = g->end();
@@ -315,6 +333,7 @@ GraphCSR::mergeBlockGraphMPI( self_ptrtype const& g,vf::BlocksBase<self_ptrtype>
     const size_type nLocalDofWithGhostOnProcStartRow = this->nLocalDofWithGhostOnProcStartRow( blockSet,g->worldComm().globalRank(), i,j );
     const size_type nLocalDofWithoutGhostOnProcStartRow = this->nLocalDofWithoutGhostOnProcStartRow( blockSet,g->worldComm().globalRank(), i,j );
     rank_type myrank=g->worldComm().globalRank();
+    g->expandFlatRows();
     auto it = g->begin();
     auto const en = g->end();
     for ( ; it != en; ++it )
@@ -433,7 +452,11 @@ GraphCSR::nLocalDofWithGhostOnProcStartCol( vf::BlocksBase<self_ptrtype> const &
 void
 GraphCSR::zero()
 {
-    if ( !this->empty() )
+    bool hadFlatRows = this->hasFlatRows();
+    M_flatRows.reset();
+    M_flatRowsAddDiagonal = false;
+    M_closedFromFlatRows = false;
+    if ( hadFlatRows || !M_storage.empty() )
     {
         M_storage.clear();
         M_is_closed = false;
@@ -454,14 +477,9 @@ GraphCSR::transpose( bool doClose )
 
     const int myrank = M_graphT->mapRow().worldComm().globalRank();
     const size_type myfirstGC = M_graphT->mapRow().firstDofGlobalCluster(myrank);
-    for ( auto it = M_storage.begin(), en = M_storage.end() ; it != en; ++it )
+    this->forEachRow( [&]( size_type globalindex, rank_type /*proc*/, size_type /*localindex*/, auto colBegin, auto colEnd )
     {
-        // Get the row of the sparsity pattern
-        row_type const& irow = it->second;
-        // num line
-        size_type globalindex = it->first;
-
-        for ( auto colit = boost::get<2>( irow ).begin(), colen=boost::get<2>( irow ).end() ; colit!=colen ; ++colit )
+        for ( auto colit = colBegin ; colit!=colEnd ; ++colit )
             {
                 bool hasEntry = M_graphT->storage().find( *colit )!=M_graphT->end();
 
@@ -495,7 +513,7 @@ GraphCSR::transpose( bool doClose )
                     }
                 }
             } // for ( auto colit ... )
-    }
+    } );
 
 
     if ( doClose ) M_graphT->close();
@@ -573,10 +591,8 @@ GraphCSR::createSubGraph( std::vector<size_type> const& _rows, std::vector<size_
     // build sub graph
     self_ptrtype subgraph( new self_type(subMapRow, subMapCol) );
 
-    for ( auto it = M_storage.begin(), en = M_storage.end() ; it != en; ++it )
+    this->forEachRow( [&]( size_type gdofRow, rank_type proc, size_type /*localindex*/, auto colBegin, auto colEnd )
     {
-        size_type gdofRow = it->first;
-
         size_type subDofRowGP = invalid_v<size_type>, subDofRowGC = invalid_v<size_type>;
         if ( theMapRow.dofGlobalClusterIsOnProc( gdofRow ) )
         {
@@ -593,18 +609,16 @@ GraphCSR::createSubGraph( std::vector<size_type> const& _rows, std::vector<size_
             }
         }
         // ignore this row if dof not present in extraction
-        if ( subDofRowGC == invalid_v<size_type> ) continue;
-
-        // Get the row of the sparsity pattern
-        row_type const& datarow = it->second;
+        if ( subDofRowGC == invalid_v<size_type> ) return;
 
         row_type& subdatarow = subgraph->row(subDofRowGC);
-        subdatarow.get<0>() = datarow.get<0>(); // same proc
+        subdatarow.get<0>() = proc; // same proc
         subdatarow.get<1>() = subDofRowGP; // global process dof
 
         // iterate on each column dof
-        for ( size_type dofColGC : datarow.get<2>() )
+        for ( auto colit = colBegin ; colit != colEnd ; ++colit )
         {
+            size_type dofColGC = *colit;
             size_type subDofColGC = invalid_v<size_type>;
             if ( theMapCol.dofGlobalClusterIsOnProc( dofColGC ) )
             {
@@ -622,7 +636,7 @@ GraphCSR::createSubGraph( std::vector<size_type> const& _rows, std::vector<size_
             if ( subDofColGC != invalid_v<size_type> )
                 subdatarow.get<2>().insert( subDofColGC );
         }
-    }
+    } );
 
     subgraph->close();
 
@@ -639,6 +653,14 @@ GraphCSR::addMissingZeroEntriesDiagonal()
 
     DVLOG(2) << " GraphCSR addMissingZeroEntriesDiagonal in graph\n";
 
+    if ( M_flatRows )
+    {
+        // added when closing the flat rows
+        M_flatRowsAddDiagonal = true;
+        return;
+    }
+    this->expandFlatRows();
+
     const size_type firstRow = this->firstRowEntryOnProc();
     //size_type firstCol = this->firstColEntryOnProc();
     //const size_type rowEnd = firstRow+std::min(this->mapRow().nLocalDofWithoutGhost(),this->mapCol().nLocalDofWithoutGhost());
@@ -659,6 +681,163 @@ GraphCSR::addMissingZeroEntriesDiagonal()
 }
 
 
+void
+GraphCSR::setFlatRows( GraphCSRBuilder&& rows )
+{
+    CHECK( rows.isFinalized() ) << "the flat rows must be finalized";
+    CHECK( rows.nRows() == this->mapRow().nLocalDofWithGhost() ) << "invalid number of rows " << rows.nRows()
+                                                                  << " (expected " << this->mapRow().nLocalDofWithGhost() << ")";
+    M_storage.clear();
+    M_flatRows = std::make_shared<GraphCSRBuilder>( std::move( rows ) );
+    M_flatRowsAddDiagonal = false;
+    M_closedFromFlatRows = false;
+    M_is_closed = false;
+}
+
+void
+GraphCSR::expandFlatRows()
+{
+    if ( !this->hasFlatRows() )
+        return;
+    storage_type storage;
+    this->forEachRow( [&storage]( size_type ig, rank_type proc, size_type il, auto colBegin, auto colEnd )
+                      {
+                          row_type& row = storage[ig];
+                          row.get<0>() = proc;
+                          row.get<1>() = il;
+                          row.get<2>().insert( colBegin, colEnd );
+                      } );
+    M_storage = std::move( storage );
+    M_flatRows.reset();
+    M_closedFromFlatRows = false;
+    if ( M_flatRowsAddDiagonal )
+    {
+        M_flatRowsAddDiagonal = false;
+        this->addMissingZeroEntriesDiagonal();
+    }
+}
+
+GraphCSR::size_type
+GraphCSR::nFlatRows() const
+{
+    size_type n = 0;
+    if ( M_flatRows )
+    {
+        for ( size_type il = 0; il < M_flatRows->nRows(); ++il )
+            if ( M_flatRows->rowSize( il ) > 0 )
+                ++n;
+    }
+    else if ( M_closedFromFlatRows )
+    {
+        for ( size_type i = 0; i+1 < M_ia.size(); ++i )
+            if ( M_ia[i+1] > M_ia[i] )
+                ++n;
+    }
+    return n;
+}
+
+void
+GraphCSR::closeFlatRows()
+{
+    DVLOG(2) << "[closeFlatRows] nrows=" << M_flatRows->nRows() << " nnz=" << M_flatRows->nnz();
+    auto flatRows = M_flatRows;
+    M_flatRows.reset();
+
+    const rank_type procId = this->worldComm().globalRank();
+    const size_type nRowLoc = this->mapRow().nLocalDofWithoutGhost();
+    const size_type firstRow = this->firstRowEntryOnProc();
+
+    // rows owned by other processes are packed as [ global row, number of entries, entries... ]
+    std::map<rank_type,std::vector<size_type>> dataToSend, dataToRecv;
+    for ( size_type il = 0; il < flatRows->nRows(); ++il )
+    {
+        if ( flatRows->rowSize( il ) == 0 )
+            continue;
+        size_type ig = this->mapRow().mapGlobalProcessToGlobalCluster( il );
+        if ( this->mapRow().dofGlobalClusterIsOnProc( ig ) )
+            continue;
+        auto & data = dataToSend[this->mapRow().procOnGlobalCluster( ig )];
+        data.push_back( ig );
+        data.push_back( flatRows->rowSize( il ) );
+        data.insert( data.end(), flatRows->rowBegin( il ), flatRows->rowEnd( il ) );
+    }
+
+    if ( this->worldComm().globalSize() > 1 )
+    {
+        auto const& neighbors = M_mapRow->neighborSubdomains();
+        std::vector<mpi::request> reqs;
+        for ( rank_type procIdNeigh : neighbors )
+        {
+            reqs.push_back( this->worldComm().globalComm().isend( procIdNeigh, 0, dataToSend[procIdNeigh] ) );
+            reqs.push_back( this->worldComm().globalComm().irecv( procIdNeigh, 0, dataToRecv[procIdNeigh] ) );
+        }
+        mpi::wait_all( reqs.begin(), reqs.end() );
+    }
+
+    // merge local and received rows in a new pattern indexed by the local
+    // (without ghost) row index
+    auto forEachEntries = [&]( auto&& insert )
+        {
+            for ( size_type il = 0; il < flatRows->nRows(); ++il )
+            {
+                if ( flatRows->rowSize( il ) == 0 )
+                    continue;
+                size_type ig = this->mapRow().mapGlobalProcessToGlobalCluster( il );
+                if ( !this->mapRow().dofGlobalClusterIsOnProc( ig ) )
+                    continue;
+                insert( ig-firstRow, flatRows->rowBegin( il ), flatRows->rowEnd( il ) );
+            }
+            for ( auto const& [proc,data] : dataToRecv )
+            {
+                for ( size_type k = 0; k < data.size(); )
+                {
+                    size_type ig = data[k];
+                    size_type n = data[k+1];
+                    DCHECK( this->mapRow().dofGlobalClusterIsOnProc( ig ) ) << "row " << ig << " received from " << proc << " is not on proc";
+                    insert( ig-firstRow, data.begin()+k+2, data.begin()+k+2+n );
+                    k += n+2;
+                }
+            }
+            // only square matrix
+            if ( M_flatRowsAddDiagonal && this->mapRow().nDof() == this->mapCol().nDof() )
+            {
+                for ( size_type i = 0; i < nRowLoc; ++i )
+                {
+                    size_type ig = firstRow+i;
+                    insert( i, &ig, &ig+1 );
+                }
+            }
+        };
+    GraphCSRBuilder closedRows( nRowLoc, flatRows->nThreads() );
+    flatRows.reset();
+    closedRows.build( forEachEntries );
+    M_flatRowsAddDiagonal = false;
+
+    M_n_total_nz.assign( this->mapRow().nLocalDofWithGhost(), 0 );
+    M_n_nz.assign( this->mapRow().nLocalDofWithGhost(), 0 );
+    M_n_oz.assign( this->mapRow().nLocalDofWithGhost(), 0 );
+    M_max_nnz = 0;
+    const bool hasLocalCol = this->mapCol().nLocalDofWithoutGhost() > 0;
+    const size_type firstCol = this->firstColEntryOnProc();
+    const size_type lastCol = this->lastColEntryOnProc();
+    for ( size_type i = 0; i < nRowLoc; ++i )
+    {
+        M_n_total_nz[i] = closedRows.rowSize( i );
+        for ( auto it = closedRows.rowBegin( i ), en = closedRows.rowEnd( i ); it != en; ++it )
+        {
+            if ( hasLocalCol && *it >= firstCol && *it <= lastCol )
+                ++M_n_nz[i];
+            else
+                ++M_n_oz[i];
+        }
+        M_max_nnz = std::max( M_max_nnz, M_n_total_nz[i] );
+    }
+    M_ia.assign( closedRows.ia().begin(), closedRows.ia().end() );
+    M_ja.assign( closedRows.ja().begin(), closedRows.ja().end() );
+    M_closedFromFlatRows = true;
+    VLOG(2) << "Closing graph from flat rows done " << nRowLoc << "," << M_ja.size() << " on proc " << procId;
+}
+
 void
 GraphCSR::close()
 {
@@ -670,6 +849,12 @@ GraphCSR::close()
     }
 
     M_is_closed = true;
+
+    if ( M_flatRows )
+    {
+        this->closeFlatRows();
+        return;
+    }
     //return;
     //std::cout << "closing graph " << this << "...\n";
     DVLOG(2) << "[close] nrows=" << this->size() << "\n";
@@ -1040,30 +1225,24 @@ GraphCSR::showMe( std::ostream& __out ) const
             __out << "last_col_entry_on_proc " << this->lastColEntryOnProc() << std::endl;
             __out << "max_nnz " << M_max_nnz << std::endl;
 
-            for ( auto it = M_storage.begin(), en = M_storage.end() ; it != en; ++it )
+            this->forEachRow( [&]( size_type globalindex, rank_type rowproc, size_type localindex, auto colBegin, auto colEnd )
             {
-                // Get the row of the sparsity pattern
-                row_type const& row = it->second;
-
-                __out << " proc " << row.get<0>()
-                      << " globalindex " << it->first
-                      << " localindex " << row.get<1>();
+                __out << " proc " << rowproc
+                      << " globalindex " << globalindex
+                      << " localindex " << localindex;
 #if 1
-                if ( it->first>=this->firstRowEntryOnProc() && it->first<=this->lastRowEntryOnProc() )
+                if ( globalindex>=this->firstRowEntryOnProc() && globalindex<=this->lastRowEntryOnProc() )
                 {
-                    __out << "(nz " << M_n_nz[row.get<1>()]
-                          << " oz " << M_n_oz[row.get<1>()]
+                    __out << "(nz " << M_n_nz[localindex]
+                          << " oz " << M_n_oz[localindex]
                           << ") : ";
 
-                    //size_type vec_size = boost::get<2>( irow ).size();
-                    //size_type globalindex = it->first;
-                    //size_type localindex = boost::get<1>( irow );
-                    for ( auto it = row.get<2>().begin(), en= row.get<2>().end() ; it!=en ; ++it )
+                    for ( auto it = colBegin ; it!=colEnd ; ++it )
                         __out << *it << " ";
                 }
 #endif
                 __out << std::endl;
-            }
+            } );
 
             __out << "--------------------------------------------------------------" << std::endl;
 
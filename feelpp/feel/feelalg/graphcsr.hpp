@@ -43,6 +43,7 @@
 #include <feel/feelcore/environment.hpp>
 #include <feel/feelcore/commobject.hpp>
 #include <feel/feelalg/datamap.hpp>
+#include <feel/feelalg/graphcsrbuilder.hpp>
 #include <feel/feelvf/pattern.hpp>
 #include <feel/feelvf/block.hpp>
 #include <feel/feelalg/products.hpp>
@@ -136,6 +137,12 @@ public:
      */
     //@{
 
+    //! \return true if the graph is closed
+    bool isClosed() const
+    {
+        return M_is_closed;
+    }
+
     size_type nRows() const
     {
         return M_mapRow->nDof();
@@ -181,6 +188,8 @@ public:
      */
     size_type size() const
     {
+        if ( this->hasFlatRows() )
+            return this->nFlatRows();
         return M_storage.size();
     }
     /**
@@ -188,13 +197,14 @@ public:
      */
     bool empty() const
     {
-        return M_storage.empty();
+        return this->size() == 0;
     }
     /**
      * \return begin (rw) iterator on graph
      */
     iterator begin()
     {
+        CHECK( !this->hasFlatRows() ) << "the rows are held in flat form, call expandFlatRows() first";
         return M_storage.begin();
     }
 
@@ -203,6 +213,7 @@ public:
      */
     iterator end()
     {
+        CHECK( !this->hasFlatRows() ) << "the rows are held in flat form, call expandFlatRows() first";
         return M_storage.end();
     }
 
@@ -211,6 +222,7 @@ public:
      */
     const_iterator begin() const
     {
+        CHECK( !this->hasFlatRows() ) << "the rows are held in flat form, call expandFlatRows() first";
         return M_storage.begin();
     }
     /**
@@ -218,6 +230,7 @@ public:
      */
     const_iterator end() const
     {
+        CHECK( !this->hasFlatRows() ) << "the rows are held in flat form, call expandFlatRows() first";
         return M_storage.end();
     }
     /**
@@ -225,6 +238,7 @@ public:
      */
     row_type& row( size_type i )
     {
+        DCHECK( !this->hasFlatRows() ) << "the rows are held in flat form, call expandFlatRows() first";
         return M_storage[i];
     }
 
@@ -233,6 +247,7 @@ public:
      */
     row_type const& row( size_type i ) const
     {
+        DCHECK( !this->hasFlatRows() ) << "the rows are held in flat form, call expandFlatRows() first";
         return M_storage.find( i )->second;
     }
 
@@ -241,9 +256,19 @@ public:
      */
     storage_type const& storage() const
     {
+        CHECK( !this->hasFlatRows() ) << "the rows are held in flat form, call expandFlatRows() first";
         return M_storage;
     }
 
+    /**
+     * \return true if the pattern is (still) held in flat CSR form, i.e. the
+     * \c std::set based row storage has not been built
+     */
+    bool hasFlatRows() const
+    {
+        return M_flatRows || M_closedFromFlatRows;
+    }
+
 
     /**
      * \return the maximum number of non-zero entries per row
@@ -315,6 +340,17 @@ public:
     datamap_ptrtype mapRowPtr() { return M_mapRow; }
     datamap_ptrtype mapColPtr() { return M_mapCol; }
 
+    /**
+     * bind the graph to the maps \p mapRow and \p mapCol, they must have the
+     * same numbering as the current maps (graph reused with rebuilt function spaces)
+     */
+    void setMaps( datamap_ptrtype const& mapRow, datamap_ptrtype const& mapCol )
+        {
+            M_mapRow = mapRow;
+            M_mapCol = mapCol;
+            M_graphT.reset();
+        }
+
     //@}
 
     /** @name  Methods
@@ -350,6 +386,26 @@ public:
      */
     void addMissingZeroEntriesDiagonal();
 
+    /**
+     * set the pattern from a flat CSR built with GraphCSRBuilder : the rows
+     * of \p rows are the process dof ids of mapRow() (ghosts included) and
+     * the columns are global cluster dof ids of mapCol().
+     *
+     * The rows are kept in flat form : close() sends the rows owned by other
+     * processes to their owner and computes ia(), ja(), nNzOnProc() and
+     * nNzOffProc() without building the \c std::set row storage. This
+     * storage must be built with expandFlatRows() before accessing the rows
+     * (row(), begin(), storage()...).
+     */
+    void setFlatRows( GraphCSRBuilder&& rows );
+
+    /**
+     * build the \c std::set row storage from the flat rows, if any : the rows
+     * of the process and its ghosts if the graph is not closed, only the rows
+     * of the process otherwise
+     */
+    void expandFlatRows();
+
     //! allow to add new entries after called a close
     void unlock() { M_is_closed = false; }
 
@@ -364,6 +420,47 @@ public:
 
 private :
 
+    //! close a graph whose rows are held by a GraphCSRBuilder
+    void closeFlatRows();
+
+    //! \return the number of non empty rows held in flat form
+    size_type nFlatRows() const;
+
+    /**
+     * apply \p f( global row, proc, local row, first col, last col ) to each
+     * non empty row of the pattern, whether it is held in flat form or not
+     */
+    template <typename FuncType>
+    void forEachRow( FuncType&& f ) const
+    {
+        if ( M_flatRows )
+        {
+            for ( size_type il = 0; il < M_flatRows->nRows(); ++il )
+            {
+                if ( M_flatRows->rowSize( il ) == 0 )
+                    continue;
+                size_type ig = this->mapRow().mapGlobalProcessToGlobalCluster( il );
+                f( ig, this->mapRow().procOnGlobalCluster( ig ), il, M_flatRows->rowBegin( il ), M_flatRows->rowEnd( il ) );
+            }
+        }
+        else if ( M_closedFromFlatRows )
+        {
+            const size_type firstRow = this->firstRowEntryOnProc();
+            const rank_type procId = this->worldComm().globalRank();
+            for ( size_type i = 0; i+1 < M_ia.size(); ++i )
+            {
+                if ( M_ia[i+1] == M_ia[i] )
+                    continue;
+                f( firstRow+i, procId, i, M_ja.begin()+M_ia[i], M_ja.begin()+M_ia[i+1] );
+            }
+        }
+        else
+        {
+            for ( auto const& [ig,row] : M_storage )
+                f( ig, row.template get<0>(), row.template get<1>(), row.template get<2>().begin(), row.template get<2>().end() );
+        }
+    }
+
     void mergeBlockGraph( self_ptrtype const& g,
                           size_type start_i, size_type start_j );
 
@@ -391,7 +488,21 @@ private :
         ar & BOOST_SERIALIZATION_NVP(M_n_total_nz);
         ar & BOOST_SERIALIZATION_NVP(M_n_nz);
         ar & BOOST_SERIALIZATION_NVP(M_n_oz);
-        ar & BOOST_SERIALIZATION_NVP(M_storage);
+        if ( this->hasFlatRows() )
+        {
+            // the archive holds the std::set row storage
+            storage_type storage;
+            this->forEachRow( [&storage]( size_type ig, rank_type proc, size_type il, auto colBegin, auto colEnd )
+                              {
+                                  row_type& row = storage[ig];
+                                  row.template get<0>() = proc;
+                                  row.template get<1>() = il;
+                                  row.template get<2>().insert( colBegin, colEnd );
+                              } );
+            ar & boost::serialization::make_nvp( "M_storage", storage );
+        }
+        else
+            ar & BOOST_SERIALIZATION_NVP(M_storage);
         ar & BOOST_SERIALIZATION_NVP(M_ia);
         ar & BOOST_SERIALIZATION_NVP(M_ja);
         ar & BOOST_SERIALIZATION_NVP(M_a);
@@ -415,6 +526,9 @@ private :
         ar & BOOST_SERIALIZATION_NVP(M_ia);
         ar & BOOST_SERIALIZATION_NVP(M_ja);
         ar & BOOST_SERIALIZATION_NVP(M_a);
+        M_flatRows.reset();
+        M_flatRowsAddDiagonal = false;
+        M_closedFromFlatRows = false;
 
         M_mapRow = std::make_shared<Feel::DataMap<>>( map_row );
         M_mapCol = std::make_shared<Feel::DataMap<>>( map_col );
@@ -438,6 +552,13 @@ private:
     self_ptrtype M_graphT;
 
     datamap_ptrtype M_mapRow, M_mapCol;
+
+    //! rows not yet closed in flat form (process dof id rows, global cluster columns)
+    std::shared_ptr<GraphCSRBuilder> M_flatRows;
+    //! diagonal entries to add when closing the flat rows
+    bool M_flatRowsAddDiagonal;
+    //! true if the graph has been closed from flat rows and the row storage is not built
+    bool M_closedFromFlatRows;
 };
 
 
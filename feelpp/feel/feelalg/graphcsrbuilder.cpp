@@ -0,0 +1,114 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+
+  This file is part of the Feel++ library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3.0 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include <algorithm>
+#include <future>
+#include <numeric>
+
+#include <feel/feelalg/graphcsrbuilder.hpp>
+
+namespace Feel
+{
+GraphCSRBuilder::GraphCSRBuilder( size_type nRows, int nThreads )
+    :
+    M_nRows( nRows ),
+    M_nThreads( std::max( nThreads, 1 ) ),
+    M_isFinalized( false ),
+    M_ia( nRows+1, 0 )
+{}
+
+GraphCSRBuilder::size_type
+GraphCSRBuilder::maxRowSize() const
+{
+    size_type res = 0;
+    for ( size_type i = 0; i < M_nRows; ++i )
+        res = std::max( res, this->rowSize( i ) );
+    return res;
+}
+
+template<typename F>
+void
+GraphCSRBuilder::parallelForRows( F&& f ) const
+{
+    int nThreads = std::min( (size_type)M_nThreads, std::max( M_nRows, size_type(1) ) );
+    if ( nThreads <= 1 )
+    {
+        f( 0, M_nRows );
+        return;
+    }
+    size_type chunkSize = M_nRows/nThreads;
+    size_type remainder = M_nRows%nThreads;
+    std::vector<std::future<void>> futures;
+    size_type start = 0;
+    for ( int t = 0; t < nThreads; ++t )
+    {
+        size_type end = start + chunkSize + ( (size_type)t < remainder ? 1 : 0 );
+        if ( t == nThreads-1 )
+            f( start, end );
+        else
+            futures.push_back( std::async( std::launch::async, f, start, end ) );
+        start = end;
+    }
+    for ( auto& fut : futures )
+        fut.get();
+}
+
+void
+GraphCSRBuilder::allocate()
+{
+    std::partial_sum( M_ia.begin(), M_ia.end(), M_ia.begin() );
+    M_ja.resize( M_ia.back() );
+    M_fillPos.assign( M_ia.begin(), M_ia.end()-1 );
+    M_isFinalized = false;
+}
+
+void
+GraphCSRBuilder::finalize()
+{
+    // sort and unique each row in place, the new row sizes are stored in M_fillPos
+    this->parallelForRows( [this]( size_type rowStart, size_type rowEnd )
+                           {
+                               for ( size_type i = rowStart; i < rowEnd; ++i )
+                               {
+                                   auto first = M_ja.begin()+M_ia[i];
+                                   auto last = M_ja.begin()+M_fillPos[i];
+                                   std::sort( first, last );
+                                   M_fillPos[i] = std::distance( first, std::unique( first, last ) );
+                               }
+                           } );
+
+    // compact the column array
+    std::vector<size_type> newIa( M_nRows+1, 0 );
+    for ( size_type i = 0; i < M_nRows; ++i )
+        newIa[i+1] = newIa[i] + M_fillPos[i];
+    std::vector<index_type> newJa( newIa.back() );
+    this->parallelForRows( [this,&newIa,&newJa]( size_type rowStart, size_type rowEnd )
+                           {
+                               for ( size_type i = rowStart; i < rowEnd; ++i )
+                                   std::copy( M_ja.begin()+M_ia[i], M_ja.begin()+M_ia[i]+M_fillPos[i], newJa.begin()+newIa[i] );
+                           } );
+    M_ia = std::move( newIa );
+    M_ja = std::move( newJa );
+    M_fillPos.clear();
+    M_fillPos.shrink_to_fit();
+    M_isFinalized = true;
+}
+
+} // Feel
@@ -0,0 +1,175 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+
+  This file is part of the Feel++ library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3.0 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#ifndef FEELPP_ALG_GRAPHCSRBUILDER_H
+#define FEELPP_ALG_GRAPHCSRBUILDER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <feel/feelcore/feel.hpp>
+
+namespace Feel
+{
+/**
+ * \class GraphCSRBuilder
+ * \brief two-pass builder of a flat Compressed Sparse Row pattern
+ *
+ * The pattern is built without any per-row container :
+ *  -# count pass : the number of (possibly duplicated) entries of each row is counted
+ *  -# prefix sum : the row pointers are computed and the column array is allocated once
+ *  -# fill pass : the columns are written contiguously in each row
+ *  -# each row is sorted and the duplicates removed, then the column array is compacted
+ *
+ * The last step runs on \c nThreads threads (rows are split in contiguous chunks).
+ *
+ * \code
+ * GraphCSRBuilder b( nRows, nThreads );
+ * b.build( [&]( auto&& insert ) {
+ *              for ( auto const& elt : elements )
+ *                  for ( auto r : rowsOf( elt ) )
+ *                      insert( r, colsOf( elt ).begin(), colsOf( elt ).end() );
+ *          } );
+ * \endcode
+ */
+class FEELPP_EXPORT GraphCSRBuilder
+{
+public:
+    using size_type = Feel::size_type;
+    using index_type = Feel::size_type;
+
+    explicit GraphCSRBuilder( size_type nRows = 0, int nThreads = 1 );
+    GraphCSRBuilder( GraphCSRBuilder const& ) = default;
+    GraphCSRBuilder( GraphCSRBuilder && ) = default;
+    GraphCSRBuilder& operator=( GraphCSRBuilder const& ) = default;
+    GraphCSRBuilder& operator=( GraphCSRBuilder && ) = default;
+
+    //! number of rows
+    size_type nRows() const { return M_nRows; }
+
+    //! number of threads used by finalize()
+    int nThreads() const { return M_nThreads; }
+    void setNThreads( int n ) { M_nThreads = std::max( n, 1 ); }
+
+    //! \return true if finalize() has been called
+    bool isFinalized() const { return M_isFinalized; }
+
+    //! row pointers (size nRows+1), valid after allocate()
+    std::vector<size_type> const& ia() const { return M_ia; }
+    //! column indices, sorted and unique in each row after finalize()
+    std::vector<index_type> const& ja() const { return M_ja; }
+
+    size_type rowSize( size_type i ) const { return M_ia[i+1]-M_ia[i]; }
+    index_type const* rowBegin( size_type i ) const { return M_ja.data()+M_ia[i]; }
+    index_type const* rowEnd( size_type i ) const { return M_ja.data()+M_ia[i+1]; }
+
+    //! total number of entries
+    size_type nnz() const { return M_ja.size(); }
+
+    //! maximum number of entries in a row
+    size_type maxRowSize() const;
+
+    /**
+     * pass 1 : add \p n entries to the count of row \p i
+     */
+    void count( size_type i, size_type n ) { M_ia[i+1] += n; }
+
+    /**
+     * prefix sum of the row counts and allocation of the column array
+     */
+    void allocate();
+
+    /**
+     * pass 2 : append the columns [\p begin,\p end) to row \p i
+     */
+    template<typename IteratorType>
+    void fill( size_type i, IteratorType begin, IteratorType end )
+        {
+            DCHECK( M_fillPos[i] + std::distance( begin, end ) <= M_ia[i+1] ) << "row " << i << " overflow in fill pass";
+            index_type* out = M_ja.data() + M_fillPos[i];
+            for ( ; begin != end; ++begin )
+                *out++ = *begin;
+            M_fillPos[i] = out - M_ja.data();
+        }
+
+    /**
+     * sort and remove duplicates in each row then compact the column array
+     */
+    void finalize();
+
+    /**
+     * run the two passes : \p forEachEntries is called twice with a functor
+     * \c insert(row,begin,end), first for counting and then for filling the
+     * rows. The pattern is finalized at the end.
+     */
+    template<typename ForEachEntriesType>
+    void build( ForEachEntriesType&& forEachEntries )
+        {
+            forEachEntries( [this]( size_type i, auto begin, auto end ) { this->count( i, std::distance( begin, end ) ); } );
+            this->allocate();
+            forEachEntries( [this]( size_type i, auto begin, auto end ) { this->fill( i, begin, end ); } );
+            this->finalize();
+        }
+
+    /**
+     * build the pattern from a finalized pattern \p old : the rows \c i such
+     * that \p rowsToUpdate[i] is false are copied from \p old, the other rows
+     * are built from the entries given by \p forEachEntries (see build()), the
+     * entries of the copied rows are ignored. The rows which do not exist in
+     * \p old must be updated.
+     */
+    template<typename ForEachEntriesType>
+    void buildIncremental( GraphCSRBuilder const& old, std::vector<bool> const& rowsToUpdate, ForEachEntriesType&& forEachEntries )
+        {
+            CHECK( old.isFinalized() ) << "invalid pattern for incremental build";
+            CHECK( rowsToUpdate.size() == M_nRows ) << "invalid number of rows to update";
+            for ( size_type i = old.nRows(); i < M_nRows; ++i )
+                CHECK( rowsToUpdate[i] ) << "the row " << i << " does not exist in the old pattern";
+            this->build( [&]( auto&& insert )
+                         {
+                             for ( size_type i = 0, n = std::min( old.nRows(), M_nRows ); i < n; ++i )
+                                 if ( !rowsToUpdate[i] )
+                                     insert( i, old.rowBegin( i ), old.rowEnd( i ) );
+                             forEachEntries( [&]( size_type i, auto begin, auto end )
+                                             {
+                                                 if ( rowsToUpdate[i] )
+                                                     insert( i, begin, end );
+                                             } );
+                         } );
+        }
+
+private:
+    //! apply f(rowStart,rowEnd) on contiguous chunks of rows, in parallel
+    template<typename F>
+    void parallelForRows( F&& f ) const;
+
+private:
+    size_type M_nRows;
+    int M_nThreads;
+    bool M_isFinalized;
+    std::vector<size_type> M_ia;
+    std::vector<size_type> M_fillPos;
+    std::vector<index_type> M_ja;
+};
+
+} // Feel
+
+#endif
@@ -0,0 +1,316 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+
+  This file is part of the Feel library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3.0 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#ifndef FEELPP_ALG_IQNILS_H
+#define FEELPP_ALG_IQNILS_H 1
+
+#include <deque>
+#include <vector>
+
+#include <feel/feeldiscr/functionspace.hpp>
+#include <feel/feelalg/vector.hpp>
+
+namespace Feel
+{
+/**
+ * \class IQNILS
+ * \brief interface quasi-Newton method with an inverse Jacobian from a least-squares model (IQN-ILS)
+ *
+ * Accelerates the fixed point iterations x^{k+1} = H(x^k), see J. Degroote,
+ * K.-J. Bathe and J. Vierendeels (2009). The differences of the residuals
+ * r^k = H(x^k) - x^k and of the outputs H(x^k) of the previous iterations
+ * are stored as the columns of V and W, and the new iterate is
+ *   x^{k+1} = H(x^k) + W c  with  c = argmin || V c + r^k ||
+ * The least-squares problem is solved with a QR decomposition of V (modified
+ * Gram-Schmidt), the columns which are almost linearly dependent of the
+ * newer ones are filtered out. The columns of the last \c reuse time steps
+ * are kept after restart(), which often makes the first iterations of the
+ * next time step quasi-Newton ones.
+ * When no column is available, a relaxation step x^{k+1} = x^k + theta r^k
+ * is done.
+ *
+ *\code
+ * IQNILS<space_type> iqnils( Xh, initial_theta, tol, reuse );
+ * iqnils.restart();
+ * while( !iqnils.isFinished() )
+ * {
+ *     u_old = u;
+ *     compute u = H(u_old);
+ *     residual = u-u_old;
+ *     iqnils.apply( u, residual, u );
+ *     iqnils.shiftRight();
+ * }
+ *\endcode
+ */
+template< typename fs_type >
+class IQNILS
+{
+public:
+
+    typedef IQNILS<fs_type> self_type;
+
+    typedef fs_type functionspace_type;
+    typedef std::shared_ptr<functionspace_type> functionspace_ptrtype;
+
+    typedef typename functionspace_type::element_type element_type;
+
+    /**
+     * Constructor
+     * @param _initialTheta relaxation parameter when no secant column is available
+     * @param _tol relative tolerance on the residual
+     * @param _reuse number of previous time steps whose columns are reused
+     * @param _maxColumns maximal number of columns of the least-squares problem
+     * @param _filteringTolerance a column is removed when the norm of its part orthogonal to the newer
+     *        columns is lower than this tolerance times its norm
+     */
+    IQNILS( functionspace_ptrtype _Xh,
+            double _initialTheta = 1.0,
+            double _tol = 1.0e-6,
+            size_type _reuse = 0,
+            size_type _maxColumns = 100,
+            double _filteringTolerance = 1.0e-8,
+            size_type _maxit = 1000 )
+        :
+        M_Xh( _Xh ),
+        M_initialTheta( _initialTheta ),
+        M_tolerance( _tol ),
+        M_reuse( _reuse ),
+        M_maxColumns( _maxColumns ),
+        M_filteringTolerance( _filteringTolerance ),
+        M_maxit( _maxit ),
+        M_previousResidual( M_Xh, "previous residual" ),
+        M_previousTildeElement( M_Xh, "previous tilde element" ),
+        M_cptIteration( 1 ),
+        M_nColumnsUsed( 0 ),
+        M_residualConvergence( 1. ),
+        M_hasConverged( false )
+        {}
+
+    IQNILS( IQNILS const& ) = default;
+
+    /**
+     * compute the new iterate \p newElt from the residual \p residual = H(x^k) - x^k
+     * and \p currentElt = H(x^k), \p newElt and \p currentElt can be the same element
+     */
+    void apply( element_type & newElt, element_type const& residual, element_type const& currentElt );
+
+    /**
+     * go to the next iteration
+     */
+    void shiftRight() { ++M_cptIteration; }
+
+    /**
+     * start a new time step, the columns of the current one are kept for reuse
+     */
+    void restart();
+
+    /**
+     * remove all the columns (current and previous time steps)
+     */
+    void clear()
+        {
+            M_V.clear();
+            M_W.clear();
+            M_reusedV.clear();
+            M_reusedW.clear();
+        }
+
+    double theta() const { return M_initialTheta; }
+    void setTheta( double v ) { M_initialTheta = v; }
+
+    size_type nIterations() const { return M_cptIteration; }
+    size_type maxit() const { return M_maxit; }
+
+    bool isFinished() const { return M_hasConverged || ( this->nIterations() > this->maxit() ); }
+    bool hasConverged() const { return M_hasConverged; }
+    double residualNorm() const { return M_residualConvergence; }
+
+    //! number of columns used by the last least-squares problem
+    size_type nColumnsUsed() const { return M_nColumnsUsed; }
+
+    void printInfo() const;
+
+private:
+
+    functionspace_ptrtype M_Xh;
+    double M_initialTheta;
+    double M_tolerance;
+    size_type M_reuse;
+    size_type M_maxColumns;
+    double M_filteringTolerance;
+    size_type M_maxit;
+
+    element_type M_previousResidual, M_previousTildeElement;
+    //! columns of the current time step, the newest first
+    std::deque<element_type> M_V, M_W;
+    //! columns of the previous time steps, the newest first
+    std::deque<std::deque<element_type>> M_reusedV, M_reusedW;
+
+    size_type M_cptIteration;
+    size_type M_nColumnsUsed;
+    double M_residualConvergence;
+    bool M_hasConverged;
+};
+
+//-----------------------------------------------------------------------------------------//
+
+template< typename fs_type >
+void
+IQNILS<fs_type>::apply( element_type & newElt, element_type const& residual, element_type const& currentElt )
+{
+    // convergence relative to x^k = H(x^k) - r^k
+    element_type oldElt = currentElt;
+    oldElt.add( -1., residual );
+    double oldEltL2Norm = oldElt.l2Norm();
+    double residualL2Norm = residual.l2Norm();
+    M_residualConvergence = ( oldEltL2Norm > 1e-13 )? residualL2Norm/oldEltL2Norm : residualL2Norm;
+    if ( M_cptIteration >= 2 && M_residualConvergence < M_tolerance )
+        M_hasConverged = true;
+
+    // new secant columns
+    if ( M_cptIteration >= 2 )
+    {
+        element_type deltaResidual = residual;
+        deltaResidual.add( -1., M_previousResidual );
+        element_type deltaTildeElement = currentElt;
+        deltaTildeElement.add( -1., M_previousTildeElement );
+        M_V.push_front( std::move( deltaResidual ) );
+        M_W.push_front( std::move( deltaTildeElement ) );
+        if ( M_V.size() > M_maxColumns )
+        {
+            M_V.pop_back();
+            M_W.pop_back();
+        }
+    }
+    M_previousResidual = residual;
+    M_previousTildeElement = currentElt;
+
+    if ( M_hasConverged )
+    {
+        newElt = currentElt;
+        return;
+    }
+
+    // columns of the least-squares problem, the newest first
+    std::vector<std::pair<element_type const*,element_type const*>> columns;
+    for ( size_type i = 0; i < M_V.size() && columns.size() < M_maxColumns; ++i )
+        columns.push_back( std::make_pair( &M_V[i], &M_W[i] ) );
+    for ( size_type t = 0; t < M_reusedV.size(); ++t )
+        for ( size_type i = 0; i < M_reusedV[t].size() && columns.size() < M_maxColumns; ++i )
+            columns.push_back( std::make_pair( &M_reusedV[t][i], &M_reusedW[t][i] ) );
+
+    if ( columns.empty() )
+    {
+        // relaxation step : x^{k+1} = x^k + theta r^k
+        M_nColumnsUsed = 0;
+        newElt = oldElt;
+        newElt.add( M_initialTheta, residual );
+        return;
+    }
+
+    // QR decomposition of V with modified Gram-Schmidt and filtering
+    std::vector<element_type> Q;
+    std::vector<std::vector<double>> R; // R[j] : column j of R
+    std::vector<size_type> columnsKept;
+    for ( size_type j = 0; j < columns.size(); ++j )
+    {
+        element_type q = *columns[j].first;
+        double initialNorm = q.l2Norm();
+        if ( initialNorm <= 0 )
+            continue;
+        std::vector<double> rCol( Q.size()+1, 0. );
+        for ( size_type i = 0; i < Q.size(); ++i )
+        {
+            rCol[i] = Q[i].dot( q );
+            q.add( -rCol[i], Q[i] );
+        }
+        double orthNorm = q.l2Norm();
+        if ( orthNorm < M_filteringTolerance*initialNorm )
+            continue;
+        rCol[Q.size()] = orthNorm;
+        q.scale( 1./orthNorm );
+        Q.push_back( std::move( q ) );
+        R.push_back( std::move( rCol ) );
+        columnsKept.push_back( j );
+    }
+    M_nColumnsUsed = Q.size();
+
+    // solve R c = -Q^T r and x^{k+1} = H(x^k) + W c
+    const int m = Q.size();
+    std::vector<double> rhs( m ), c( m, 0. );
+    for ( int i = 0; i < m; ++i )
+        rhs[i] = -Q[i].dot( residual );
+    for ( int i = m-1; i >= 0; --i )
+    {
+        double s = rhs[i];
+        for ( int j = i+1; j < m; ++j )
+            s -= R[j][i]*c[j];
+        c[i] = s/R[i][i];
+    }
+    if ( &newElt != &currentElt )
+        newElt = currentElt;
+    for ( int i = 0; i < m; ++i )
+        newElt.add( c[i], *columns[columnsKept[i]].second );
+}
+
+//-----------------------------------------------------------------------------------------//
+
+template< typename fs_type >
+void
+IQNILS<fs_type>::restart()
+{
+    if ( M_reuse > 0 && !M_V.empty() )
+    {
+        M_reusedV.push_front( std::move( M_V ) );
+        M_reusedW.push_front( std::move( M_W ) );
+        while ( M_reusedV.size() > M_reuse )
+        {
+            M_reusedV.pop_back();
+            M_reusedW.pop_back();
+        }
+    }
+    M_V.clear();
+    M_W.clear();
+    M_cptIteration = 1;
+    M_nColumnsUsed = 0;
+    M_residualConvergence = 1.;
+    M_hasConverged = false;
+}
+
+//-----------------------------------------------------------------------------------------//
+
+template< typename fs_type >
+void
+IQNILS<fs_type>::printInfo() const
+{
+    std::cout << "[IQN-ILS] iteration : "<< M_cptIteration
+              <<" columns=" << M_nColumnsUsed
+              <<" residualNorm : " << M_residualConvergence
+              << "\n";
+
+    LOG(INFO) << "[IQN-ILS] iteration : "<< M_cptIteration
+              <<" columns=" << M_nColumnsUsed
+              <<" residualNorm : " << M_residualConvergence
+              << "\n";
+}
+
+} // namespace Feel
+
+#endif /* FEELPP_ALG_IQNILS_H */
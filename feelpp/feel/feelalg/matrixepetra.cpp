@@ -149,6 +149,7 @@ MatrixEpetra::init ( const size_type m,
         //int stop = M_emap.MaxMyGID()+1;
 
         // insert global indices, even the non-local ones
+        this->graph()->expandFlatRows();
         graph_type::const_iterator it = this->graph()->begin();
         graph_type::const_iterator en = this->graph()->end();
 
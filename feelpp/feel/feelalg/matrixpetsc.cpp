@@ -935,6 +935,171 @@ MatrixPetsc<T>::addMatrix ( int* rows, int nrows,
     CHKERRABORT( this->comm(),ierr );
 }
 
+template <typename T>
+bool
+MatrixPetsc<T>::beginConcurrentInsertion()
+{
+    CHECK( !M_concurrentInsertion ) << "concurrent insertion already started";
+    if ( !this->isInitialized() )
+        return false;
+
+    // the sparsity pattern must be final : the matrix is assembled (the
+    // preallocation with the graph assembles it) and stored in AIJ format
+    int ierr = 0;
+    PetscBool isAssembled = PETSC_FALSE;
+    ierr = MatAssembled( M_mat, &isAssembled );
+    CHKERRABORT( this->comm(),ierr );
+    if ( !isAssembled )
+        return false;
+
+    PetscBool isSeqAIJ = PETSC_FALSE, isMPIAIJ = PETSC_FALSE;
+    ierr = PetscObjectTypeCompare( (PetscObject)M_mat, MATSEQAIJ, &isSeqAIJ );
+    CHKERRABORT( this->comm(),ierr );
+    ierr = PetscObjectTypeCompare( (PetscObject)M_mat, MATMPIAIJ, &isMPIAIJ );
+    CHKERRABORT( this->comm(),ierr );
+
+    Mat matDiag = M_mat, matOffDiag = nullptr;
+    const PetscInt* colmap = nullptr;
+    if ( isMPIAIJ )
+    {
+        ierr = MatMPIAIJGetSeqAIJ( M_mat, &matDiag, &matOffDiag, &colmap );
+        CHKERRABORT( this->comm(),ierr );
+        PetscBool isAssembledDiag = PETSC_FALSE, isAssembledOffDiag = PETSC_FALSE;
+        MatAssembled( matDiag, &isAssembledDiag );
+        MatAssembled( matOffDiag, &isAssembledOffDiag );
+        if ( !isAssembledDiag || !isAssembledOffDiag || !colmap )
+            return false;
+        PetscInt nRowsOffDiag = 0;
+        ierr = MatGetSize( matOffDiag, &nRowsOffDiag, &M_concurrentNOffDiagCols );
+        CHKERRABORT( this->comm(),ierr );
+        if ( !std::is_sorted( colmap, colmap+M_concurrentNOffDiagCols ) )
+            return false;
+    }
+    else if ( !isSeqAIJ )
+        return false;
+
+    auto getBlock = [this]( Mat m, ConcurrentInsertionBlock& block )
+        {
+            block.mat = m;
+            PetscBool done = PETSC_FALSE;
+            int ierr = MatGetRowIJ( m, 0, PETSC_FALSE, PETSC_FALSE, &block.nRows, &block.ia, &block.ja, &done );
+            CHKERRABORT( this->comm(),ierr );
+            CHECK( done ) << "the row structure of the matrix is not available";
+            ierr = MatSeqAIJGetArray( m, &block.a );
+            CHKERRABORT( this->comm(),ierr );
+        };
+    getBlock( matDiag, M_concurrentDiag );
+    if ( matOffDiag )
+    {
+        getBlock( matOffDiag, M_concurrentOffDiag );
+        M_concurrentOffDiagCols = colmap;
+    }
+
+    ierr = MatGetOwnershipRange( M_mat, &M_concurrentRowStart, &M_concurrentRowEnd );
+    CHKERRABORT( this->comm(),ierr );
+    ierr = MatGetOwnershipRangeColumn( M_mat, &M_concurrentColStart, &M_concurrentColEnd );
+    CHKERRABORT( this->comm(),ierr );
+    M_concurrentRowMap = nullptr;
+    M_concurrentColMap = nullptr;
+    M_concurrentInsertion = true;
+    return true;
+}
+
+template <typename T>
+PetscScalar*
+MatrixPetsc<T>::concurrentInsertionEntry( PetscInt row, PetscInt col ) const
+{
+    ConcurrentInsertionBlock const* block = &M_concurrentDiag;
+    if ( col >= M_concurrentColStart && col < M_concurrentColEnd )
+        col -= M_concurrentColStart;
+    else
+    {
+        if ( !M_concurrentOffDiag.mat )
+            return nullptr;
+        auto itCol = std::lower_bound( M_concurrentOffDiagCols, M_concurrentOffDiagCols+M_concurrentNOffDiagCols, col );
+        if ( itCol == M_concurrentOffDiagCols+M_concurrentNOffDiagCols || *itCol != col )
+            return nullptr;
+        col = itCol - M_concurrentOffDiagCols;
+        block = &M_concurrentOffDiag;
+    }
+    row -= M_concurrentRowStart;
+    auto first = block->ja + block->ia[row], last = block->ja + block->ia[row+1];
+    auto it = std::lower_bound( first, last, col );
+    if ( it == last || *it != col )
+        return nullptr;
+    return block->a + ( it - block->ja );
+}
+
+template <typename T>
+void
+MatrixPetsc<T>::addMatrixConcurrent( int* rows, int nrows,
+                                     int* cols, int ncols,
+                                     value_type* data,
+                                     ConcurrentInsertionBuffer<value_type>& buffer )
+{
+    if ( !M_concurrentInsertion )
+    {
+        super::addMatrixConcurrent( rows, nrows, cols, ncols, data, buffer );
+        return;
+    }
+
+    auto& positions = buffer.positions();
+    positions.resize( ncols );
+    for ( int k = 0; k < nrows; ++k )
+    {
+        // negative indices are ignored (as in MatSetValues)
+        if ( rows[k] < 0 )
+            continue;
+        value_type* rowData = data+k*ncols;
+        PetscInt row = M_concurrentRowMap? M_concurrentRowMap[rows[k]] : rows[k];
+        // a row is added in place only if all its entries are found
+        bool inPlace = ( row >= M_concurrentRowStart ) && ( row < M_concurrentRowEnd );
+        for ( int q = 0; q < ncols && inPlace; ++q )
+        {
+            if ( cols[q] < 0 )
+            {
+                positions[q] = nullptr;
+                continue;
+            }
+            PetscInt col = M_concurrentColMap? M_concurrentColMap[cols[q]] : cols[q];
+            positions[q] = reinterpret_cast<value_type*>( this->concurrentInsertionEntry( row, col ) );
+            inPlace = ( positions[q] != nullptr );
+        }
+        if ( !inPlace )
+        {
+            buffer.addRow( rows[k], ncols, cols, rowData );
+            continue;
+        }
+        for ( int q = 0; q < ncols; ++q )
+            if ( positions[q] )
+                *positions[q] += rowData[q];
+    }
+}
+
+template <typename T>
+void
+MatrixPetsc<T>::endConcurrentInsertion()
+{
+    if ( !M_concurrentInsertion )
+        return;
+    auto restoreBlock = [this]( ConcurrentInsertionBlock& block )
+        {
+            if ( !block.mat )
+                return;
+            PetscBool done = PETSC_FALSE;
+            int ierr = MatSeqAIJRestoreArray( block.mat, &block.a );
+            CHKERRABORT( this->comm(),ierr );
+            ierr = MatRestoreRowIJ( block.mat, 0, PETSC_FALSE, PETSC_FALSE, &block.nRows, &block.ia, &block.ja, &done );
+            CHKERRABORT( this->comm(),ierr );
+            block = ConcurrentInsertionBlock{};
+        };
+    restoreBlock( M_concurrentDiag );
+    restoreBlock( M_concurrentOffDiag );
+    M_concurrentOffDiagCols = nullptr;
+    M_concurrentNOffDiagCols = 0;
+    M_concurrentInsertion = false;
+}
+
 template <typename T>
 void
 MatrixPetsc<T>::setDiagonal( const Vector<T>& vecDiag )
@@ -2301,6 +2466,7 @@ void MatrixPetsc<T>::zeroEntriesDiagonal()
 #else
 
     //std::cout << "zeroEntriesDiagonal()"<< std::endl;
+    this->graph()->expandFlatRows();
     for ( auto it=this->graph()->begin(), en=this->graph()->end() ; it!=en ; ++it )
     {
         size_type index = it->first;
@@ -2483,15 +2649,15 @@ void MatrixPetsc<T>::serialize(Archive & ar, const unsigned int version )
         auto itVal = matValues.begin();
         PetscInt rowIds[1];
         std::vector<PetscInt> colIds;
-        for ( auto const& rowDataEntries : this->graph()->storage() )
+        // rows of the process in CSR form (local rows, global cluster columns)
+        auto const& ia = this->graph()->ia();
+        auto const& ja = this->graph()->ja();
+        for ( size_type i = 0; i+1 < ia.size(); ++i )
         {
-            if ( !this->mapRow().dofGlobalClusterIsOnProc( rowDataEntries.first ) )
+            if ( ia[i+1] == ia[i] )
                 continue;
-            rowIds[0] = rowDataEntries.first;
-            auto const& colData = boost::get<2>( rowDataEntries.second );
-            if ( colData.empty() )
-                continue;
-            colIds.assign( colData.begin(),colData.end() );
+            rowIds[0] = this->graph()->firstRowEntryOnProc()+i;
+            colIds.assign( ja.begin()+ia[i], ja.begin()+ia[i+1] );
             itVal = matValues.end();
             matValues.resize( matValues.size() + colIds.size() );
             ierr = MatGetValues( this->mat(), 1, rowIds, colIds.size(), colIds.data(), &(*itVal)/*matValues.data()*/ );
@@ -2508,15 +2674,14 @@ void MatrixPetsc<T>::serialize(Archive & ar, const unsigned int version )
         auto itVal = matValues.begin();
         PetscInt rowIds[1];
         std::vector<PetscInt> colIds;
-        for ( auto const& rowDataEntries : this->graph()->storage() )
+        auto const& ia = this->graph()->ia();
+        auto const& ja = this->graph()->ja();
+        for ( size_type i = 0; i+1 < ia.size(); ++i )
         {
-            if ( !this->mapRow().dofGlobalClusterIsOnProc( rowDataEntries.first ) )
-                continue;
-            rowIds[0] = rowDataEntries.first;
-            auto const& colData = boost::get<2>( rowDataEntries.second );
-            if ( colData.empty() )
+            if ( ia[i+1] == ia[i] )
                 continue;
-            colIds.assign( colData.begin(),colData.end() );
+            rowIds[0] = this->graph()->firstRowEntryOnProc()+i;
+            colIds.assign( ja.begin()+ia[i], ja.begin()+ia[i+1] );
             ierr = MatSetValues( this->mat(), 1, rowIds, colIds.size(), colIds.data(), &(*itVal), INSERT_VALUES );
             CHKERRABORT( this->comm(),ierr );
             itVal += colIds.size();
@@ -2881,6 +3046,18 @@ MatrixPetscMPI<T>::addMatrix( int* rows, int nrows,
     CHKERRABORT( this->comm(),ierr );
 }
 
+template <typename T>
+bool
+MatrixPetscMPI<T>::beginConcurrentInsertion()
+{
+    if ( !super::beginConcurrentInsertion() )
+        return false;
+    // the element contributions are given with process indices (MatSetValuesLocal)
+    this->M_concurrentRowMap = this->mapRow().mapGlobalProcessToGlobalCluster().data();
+    this->M_concurrentColMap = this->mapCol().mapGlobalProcessToGlobalCluster().data();
+    return true;
+}
+
 //----------------------------------------------------------------------------------------------------//
 #if 0
 template <typename T>
@@ -384,6 +384,18 @@ public:
                      size_type K = 0,
                      size_type K2 = invalid_v<size_type>) override;
 
+    /**
+     * concurrent insertion in the CSR arrays of an assembled (Seq/MPI) AIJ
+     * matrix : the rows owned by the process are added in place, one
+     * thread by row, without going through MatSetValues
+     */
+    bool beginConcurrentInsertion() override;
+    void addMatrixConcurrent( int* rows, int nrows,
+                              int* cols, int ncols,
+                              value_type* data,
+                              ConcurrentInsertionBuffer<value_type>& buffer ) override;
+    void endConcurrentInsertion() override;
+
     /**
      * Same, but assumes the row and column maps are the same.
      * Thus the matrix \p dm must be square.
@@ -608,6 +620,29 @@ protected:
      */
     Mat M_mat;
 
+    //! CSR arrays of a sequential AIJ block written in place by addMatrixConcurrent()
+    struct ConcurrentInsertionBlock
+    {
+        Mat mat = nullptr;
+        PetscInt nRows = 0;
+        const PetscInt* ia = nullptr;
+        const PetscInt* ja = nullptr;
+        PetscScalar* a = nullptr;
+    };
+    //! \return the position of the entry (row,col) (global indices) in the CSR arrays, null if not in the pattern
+    PetscScalar* concurrentInsertionEntry( PetscInt row, PetscInt col ) const;
+
+    bool M_concurrentInsertion = false;
+    //! diagonal and off-diagonal (MPI) blocks
+    ConcurrentInsertionBlock M_concurrentDiag, M_concurrentOffDiag;
+    //! global column of each column of the off-diagonal block (sorted)
+    const PetscInt* M_concurrentOffDiagCols = nullptr;
+    PetscInt M_concurrentNOffDiagCols = 0;
+    PetscInt M_concurrentRowStart = 0, M_concurrentRowEnd = 0, M_concurrentColStart = 0, M_concurrentColEnd = 0;
+    //! global indices of the process indices given to addMatrix (null when the indices are already global)
+    const size_type* M_concurrentRowMap = nullptr;
+    const size_type* M_concurrentColMap = nullptr;
+
 
 
 private:
@@ -694,6 +729,9 @@ public :
                     int* cols, int ncols,
                     value_type* data, size_type K = 0, size_type K2 = invalid_v<size_type> ) override;
 
+    //! same as MatrixPetsc, the rows and columns are process indices
+    bool beginConcurrentInsertion() override;
+
     //void addMatrix( const T a, MatrixSparse<T> const&X );
 
 
@@ -497,6 +497,45 @@ public:
                              int* cols, int ncols,
                              value_type* data, size_type K, size_type K2 ) = 0;
 
+    /**
+     * prepare the concurrent insertion of element contributions : until
+     * endConcurrentInsertion(), addMatrixConcurrent() can be called by
+     * several threads as long as they never add into the same row (e.g. the
+     * elements of one colour, see elementColoring()).
+     * \return false if the storage does not allow an insertion in place,
+     * addMatrixConcurrent() keeps then all the rows in the buffers
+     */
+    virtual bool beginConcurrentInsertion() { return false; }
+
+    /**
+     * add the element matrix \p data (row major, \p nrows x \p ncols) in
+     * place into the rows owned by the process when all its entries are in
+     * the sparsity pattern, the other rows are kept in \p buffer and added by
+     * addConcurrentInsertionBuffer() after endConcurrentInsertion()
+     */
+    virtual void addMatrixConcurrent( int* rows, int nrows,
+                                      int* cols, int ncols,
+                                      value_type* data,
+                                      ConcurrentInsertionBuffer<value_type>& buffer )
+    {
+        for ( int k = 0; k < nrows; ++k )
+            buffer.addRow( rows[k], ncols, cols, data+k*ncols );
+    }
+
+    //! end the concurrent insertion started by beginConcurrentInsertion()
+    virtual void endConcurrentInsertion() {}
+
+    //! add the rows kept in \p buffer and clear it
+    void addConcurrentInsertionBuffer( ConcurrentInsertionBuffer<value_type>& buffer )
+    {
+        for ( std::size_t k = 0; k < buffer.size(); ++k )
+        {
+            int row = buffer.row( k );
+            this->addMatrix( &row, 1, buffer.cols( k ), buffer.nValues( k ), buffer.values( k ), 0, invalid_v<size_type> );
+        }
+        buffer.clear();
+    }
+
     /**
      * Same, but assumes the row and column maps are the same.
      * Thus the matrix \p dm must be square.
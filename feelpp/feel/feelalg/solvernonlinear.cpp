@@ -63,6 +63,9 @@ SolverNonLinear<T,SizeT>::SolverNonLinear ( std::string const& prefix, worldcomm
     M_nbItMax( 0 ),
     M_reuse_jac( 0 ),
     M_reuse_prec( 0 ),
+    M_jacobianFree( false ),
+    M_jacobianFreeLagPreconditioner( 1 ),
+    M_jacobianFreeLagPreconditionerPersists( false ),
     M_showKSPMonitor( boption(_prefix=prefix,_name="ksp-monitor",_vm=vm) ),
     M_showSNESMonitor( boption(_prefix=prefix,_name="snes-monitor",_vm=vm ) ),
     M_showKSPConvergedReason( vm.count(prefixvm( prefix,"ksp-converged-reason")) ),
@@ -99,6 +102,9 @@ SolverNonLinear<T,SizeT>::SolverNonLinear ( SolverNonLinear const& snl )
     M_nbItMax( snl.M_nbItMax ),
     M_reuse_jac( snl.M_reuse_jac ),
     M_reuse_prec( snl.M_reuse_prec ),
+    M_jacobianFree( snl.M_jacobianFree ),
+    M_jacobianFreeLagPreconditioner( snl.M_jacobianFreeLagPreconditioner ),
+    M_jacobianFreeLagPreconditionerPersists( snl.M_jacobianFreeLagPreconditionerPersists ),
     M_showKSPMonitor( snl.M_showKSPMonitor ),
     M_showSNESMonitor( snl.M_showSNESMonitor ),
     M_showKSPConvergedReason( snl.M_showKSPConvergedReason ), M_showSNESConvergedReason( snl.M_showSNESConvergedReason ),
@@ -276,6 +276,23 @@ public:
         return M_reuse_prec;
     }
 
+    /**
+     * \return true if the action of the jacobian is computed by finite differences
+     * of the residual (Jacobian-free Newton-Krylov)
+     */
+    bool jacobianFree() const { return M_jacobianFree; }
+
+    /**
+     * \return the number of Newton iterations between two assemblies of the jacobian
+     * used as preconditioner in jacobian-free mode (-1 : only at the first one)
+     */
+    int jacobianFreeLagPreconditioner() const { return M_jacobianFreeLagPreconditioner; }
+
+    /**
+     * \return true if the lag of the preconditioner is counted across the nonlinear solves
+     */
+    bool jacobianFreeLagPreconditionerPersists() const { return M_jacobianFreeLagPreconditionerPersists; }
+
     /**
      * \return the prefix
      */
@@ -423,6 +440,19 @@ public:
         M_reuse_prec=prec;
     }
 
+    /**
+     * set the Jacobian-free Newton-Krylov mode : the jacobian action is approximated by finite
+     * differences of the residual and the assembled jacobian is only used to build the preconditioner,
+     * it is rebuilt every \p lag Newton iterations (-1 : only at the first one), across the nonlinear
+     * solves if \p persists
+     */
+    void setJacobianFree( bool b, int lag = 1, bool persists = false )
+    {
+        M_jacobianFree = b;
+        M_jacobianFreeLagPreconditioner = lag;
+        M_jacobianFreeLagPreconditionerPersists = persists;
+    }
+
     /**
      * Define values of tolerance for the non linear solver
      */
@@ -709,6 +739,13 @@ protected:
      */
     int M_reuse_prec;
 
+    /**
+     * Jacobian-free Newton-Krylov mode and lag of the assembled preconditioner
+     */
+    bool M_jacobianFree;
+    int M_jacobianFreeLagPreconditioner;
+    bool M_jacobianFreeLagPreconditionerPersists;
+
     bool M_showKSPMonitor, M_showSNESMonitor;
     bool M_showKSPConvergedReason, M_showSNESConvergedReason;
     bool M_viewSNESInfo;
@@ -259,26 +259,28 @@ extern "C"
         Feel::SolverNonLinearPetsc<double>* solver =
             static_cast<Feel::SolverNonLinearPetsc<double>*> ( ctx );
 
+        // in jacobian-free mode, the jacobian is a matrix-free operator and
+        // the assembly is done in the preconditioner matrix
+#if PETSC_VERSION_LESS_THAN(3,5,0)
+        Mat matJacobian = *jac;
+        Mat matAssembly = ( solver->jacobianFree() )? *pc : *jac;
+#else
+        Mat matJacobian = jac;
+        Mat matAssembly = ( solver->jacobianFree() )? pc : jac;
+#endif
+
         std::shared_ptr<Feel::MatrixSparse<double> > Jac;
         std::shared_ptr<Feel::Vector<double> > X_global;
 
         if ( solver->comm().size()>1 )
         {
-#if PETSC_VERSION_LESS_THAN(3,5,0)
-            Jac.reset( new Feel::MatrixPetscMPI<double>( *jac,solver->mapRowPtr(),solver->mapColPtr() ) );
-#else
-            Jac.reset( new Feel::MatrixPetscMPI<double>( jac,solver->mapRowPtr(),solver->mapColPtr() ) );
-#endif
+            Jac.reset( new Feel::MatrixPetscMPI<double>( matAssembly,solver->mapRowPtr(),solver->mapColPtr() ) );
             X_global.reset( new Feel::VectorPetscMPI<double>( x,solver->mapColPtr() ) );
         }
 
         else
         {
-#if PETSC_VERSION_LESS_THAN(3,5,0)
-            Jac.reset( new Feel::MatrixPetsc<double>( *jac,solver->mapRowPtr(),solver->mapColPtr() ) );
-#else
-            Jac.reset( new Feel::MatrixPetsc<double>( jac,solver->mapRowPtr(),solver->mapColPtr() ) );
-#endif
+            Jac.reset( new Feel::MatrixPetsc<double>( matAssembly,solver->mapRowPtr(),solver->mapColPtr() ) );
             X_global.reset( new Feel::VectorPetsc<double>( x,solver->mapColPtr() ) );
         }
 
@@ -291,6 +293,15 @@ extern "C"
         //PC->close();
         //Jac = PC;
         Jac->close();
+
+        // update the base point of the matrix-free operator
+        if ( solver->jacobianFree() )
+        {
+            ierr = MatAssemblyBegin( matJacobian, MAT_FINAL_ASSEMBLY );
+            CHKERRABORT( solver->worldComm().globalComm(),ierr );
+            ierr = MatAssemblyEnd( matJacobian, MAT_FINAL_ASSEMBLY );
+            CHKERRABORT( solver->worldComm().globalComm(),ierr );
+        }
         //*PC = Jac;
         //PC->printMatlab( "pc.m" );
         //Jac->printMatlab( "jac.m" );
@@ -553,12 +564,23 @@ void SolverNonLinearPetsc<T>::clear ()
 
         int ierr=0;
 #if (PETSC_VERSION_MAJOR == 3) && (PETSC_VERSION_MINOR >= 2)
+        if ( M_jacMatrixFree )
+        {
+            ierr = MatDestroy( &M_jacMatrixFree );
+            CHKERRABORT( this->worldComm().globalComm(),ierr );
+        }
         ierr = SNESDestroy( &M_snes );
         CHKERRABORT( this->worldComm().globalComm(),ierr );
 #else
+        if ( M_jacMatrixFree )
+        {
+            ierr = MatDestroy( M_jacMatrixFree );
+            CHKERRABORT( this->worldComm().globalComm(),ierr );
+        }
         ierr = SNESDestroy( M_snes );
         CHKERRABORT( this->worldComm().globalComm(),ierr );
 #endif
+        M_jacMatrixFree = NULL;
     }
 }
 // SolverNonLinearPetsc<> methods
@@ -921,21 +943,53 @@ SolverNonLinearPetsc<T>::solve ( sparse_matrix_ptrtype&  jac_in,  // System Jaco
     ierr = SNESSetFunction ( M_snes, r->vec(), __feel_petsc_snes_residual, this );
     CHKERRABORT( this->worldComm().globalComm(),ierr );
 
+    // Jacobian-free Newton-Krylov : the operator is the finite differences of the residual,
+    // the assembled jacobian is only the preconditioner matrix and is rebuilt with a lag
+    Mat jacOperator = jac->mat();
+    if ( this->jacobianFree() )
+    {
+        if ( M_jacMatrixFree )
+        {
+#if (PETSC_VERSION_MAJOR == 3) && (PETSC_VERSION_MINOR >= 2)
+            ierr = MatDestroy( &M_jacMatrixFree );
+#else
+            ierr = MatDestroy( M_jacMatrixFree );
+#endif
+            CHKERRABORT( this->worldComm().globalComm(),ierr );
+        }
+        ierr = MatCreateSNESMF( M_snes, &M_jacMatrixFree );
+        CHKERRABORT( this->worldComm().globalComm(),ierr );
+        ierr = MatSetFromOptions( M_jacMatrixFree );
+        CHKERRABORT( this->worldComm().globalComm(),ierr );
+        jacOperator = M_jacMatrixFree;
+
+        // -2 : built at the first Newton iteration and never after
+        // (it replaces the lag of the jacobian given by setReuse)
+        LOG_IF( WARNING, this->reuseJacobian() != 1 ) << "the jacobian-free lag of the preconditioner overrides the jacobian reuse " << this->reuseJacobian();
+        int lag = this->jacobianFreeLagPreconditioner();
+        ierr = SNESSetLagJacobian( M_snes, ( lag < 0 )? -2 : lag );
+        CHKERRABORT( this->worldComm().globalComm(),ierr );
+    }
+#if !PETSC_VERSION_LESS_THAN(3,5,0)
+    ierr = SNESSetLagJacobianPersists( M_snes, ( this->jacobianFree() && this->jacobianFreeLagPreconditionerPersists() )? PETSC_TRUE : PETSC_FALSE );
+    CHKERRABORT( this->worldComm().globalComm(),ierr );
+#endif
+
 #if PETSC_VERSION_LESS_THAN(3,5,0)
-    ierr = SNESSetJacobian ( M_snes, jac->mat(), jac->mat(), __feel_petsc_snes_jacobian, this );
+    ierr = SNESSetJacobian ( M_snes, jacOperator, jac->mat(), __feel_petsc_snes_jacobian, this );
 #else
-    ierr = SNESSetJacobian ( M_snes, jac->mat(), jac->mat(), &__feel_petsc_snes_jacobian, this );
+    ierr = SNESSetJacobian ( M_snes, jacOperator, jac->mat(), &__feel_petsc_snes_jacobian, this );
 #endif
     CHKERRABORT( this->worldComm().globalComm(),ierr );
 
 #if PETSC_VERSION_LESS_THAN(3,5,0)
-    ierr = KSPSetOperators( M_ksp, jac->mat(), jac->mat(),
+    ierr = KSPSetOperators( M_ksp, jacOperator, jac->mat(),
                             PetscGetMatStructureEnum(this->precMatrixStructure()) );
 #else
     // no longer necessary here!
     //ierr = KSPSetReusePreconditioner( M_ksp, (this->precMatrixStructure() == Feel::SAME_PRECONDITIONER)? PETSC_TRUE : PETSC_FALSE );
     //CHKERRABORT( this->worldComm().globalComm(),ierr );
-    ierr = KSPSetOperators( M_ksp, jac->mat(), jac->mat() );
+    ierr = KSPSetOperators( M_ksp, jacOperator, jac->mat() );
 #endif
     CHKERRABORT( this->worldComm().globalComm(),ierr );
 
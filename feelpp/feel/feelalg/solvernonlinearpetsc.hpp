@@ -249,6 +249,11 @@ private:
      */
     KSP M_ksp;
 
+    /**
+     * matrix-free jacobian used in Jacobian-free Newton-Krylov mode
+     */
+    Mat M_jacMatrixFree;
+
 
     datamap_ptrtype M_mapRow,M_mapCol;
 
@@ -259,6 +264,7 @@ inline
 SolverNonLinearPetsc<T>::SolverNonLinearPetsc( std::string const& prefix, worldcomm_ptr_t const& worldComm, po::variables_map const& vm )
 :
     super( prefix,worldComm,vm ),
+    M_jacMatrixFree( NULL ),
     M_mapRow(new datamap_type(worldComm)),
     M_mapCol(new datamap_type(worldComm))
 {}
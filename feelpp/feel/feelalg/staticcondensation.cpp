@@ -38,18 +38,7 @@ void StaticCondensation<T,IndexT>::addLocalMatrix ( int* rows, int nrows,
     //tic();
     if ( K == invalid_v<size_type> ) return;
     if ( K2 == invalid_v<size_type> ) return;
-    auto key = std::make_pair(K,K2);
-    auto entry = this->M_local_matrices[this->M_block_rowcol].find(key);
-    if ( entry == this->M_local_matrices[this->M_block_rowcol].end() )
-    {
-        this->M_local_matrices[this->M_block_rowcol][key].noalias() = raw_matrix_map_t( data, nrows, ncols );
-        //cout << "SC inserting matrix entry [" << this->M_block_rowcol << "][" << key << "]=" << this->M_local_matrices[this->M_block_rowcol][key] << std::endl;
-    }
-    else
-    {
-        this->M_local_matrices[this->M_block_rowcol][key].noalias()+=raw_matrix_map_t( data, nrows, ncols );
-        //cout << "SC adding matrix entry [" << this->M_block_rowcol << "][" << key << "]=" << this->M_local_matrices[this->M_block_rowcol][key] << std::endl;
-    }
+    this->M_local_matrices[this->M_block_rowcol].add( std::make_pair(K,K2), raw_matrix_map_t( data, nrows, ncols ) );
     //LOG(INFO) << "[" << this->M_block_rowcol << "][" << key << "]=" << this->M_local_matrices[this->M_block_rowcol][key];
 #if 0
     this->M_local_rows[this->M_block_rowcol][key] = raw_index_map_t( rows, nrows );
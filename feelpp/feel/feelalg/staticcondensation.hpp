@@ -28,9 +28,12 @@
 
 
 #include <boost/functional/hash.hpp>
+#include <boost/serialization/complex.hpp>
+#include <boost/serialization/vector.hpp>
 
 #include <unordered_map>
 #include <Eigen/Core>
+#include <Eigen/LU>
 #include <boost/hana/equal.hpp>
 #include <boost/hana/integral_constant.hpp>
 #include <boost/hana/length.hpp>
@@ -58,22 +61,211 @@ enum class scstate
 namespace detail {
 
 
+//!
+//! store of the local matrices of a block indexed by a pair of element ids
+//!
+//! the matrices are stored in contiguous batches grouped by shape (the
+//! matrices associated to the same type of element share the same shape) :
+//! the matrix of a batch with \c n rows and \c m columns is stored in row
+//! major order at the offset \c index*n*m of the batch buffer. The accessors
+//! return \c Eigen::Map on the batch buffers which are invalidated by the
+//! insertion of a new matrix in the same batch.
+//!
 template<typename block_element_t, typename local_matrices_t>
-class LocalMatrix: public std::unordered_map<block_element_t,local_matrices_t,boost::hash<block_element_t>>
+class LocalMatrix
 {
 public:
-    using super = std::unordered_map<block_element_t,local_matrices_t,boost::hash<block_element_t>>;
+    using key_type = block_element_t;
+    using scalar_type = typename local_matrices_t::Scalar;
+    using matrix_map_t = Eigen::Map<local_matrices_t>;
+    using matrix_const_map_t = Eigen::Map<const local_matrices_t>;
+
+    //! contiguous storage of the matrices of same shape
+    struct Batch
+    {
+        int rows = 0;
+        int cols = 0;
+        std::vector<key_type> keys;
+        std::vector<scalar_type> values;
+
+        std::size_t size() const { return keys.size(); }
+        scalar_type* data( std::size_t i ) { return values.data() + i*rows*cols; }
+        scalar_type const* data( std::size_t i ) const { return values.data() + i*rows*cols; }
+    };
+
+private:
+    struct Slot
+    {
+        int batch;
+        std::size_t index;
+    };
+
+    template<bool IsConst>
+    class iterator_impl
+    {
+        using store_t = std::conditional_t<IsConst,LocalMatrix const,LocalMatrix>;
+        using map_t = std::conditional_t<IsConst,matrix_const_map_t,matrix_map_t>;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<key_type const,map_t>;
+        using difference_type = std::ptrdiff_t;
+        using reference = value_type;
+        struct pointer
+        {
+            value_type v;
+            value_type const* operator->() const { return &v; }
+        };
+
+        iterator_impl() = default;
+        iterator_impl( store_t* s, int b, std::size_t i ) : M_store( s ), M_batch( b ), M_index( i ) { this->skipEmpty(); }
+        template<bool C = IsConst, std::enable_if_t<C,int> = 0>
+        iterator_impl( iterator_impl<false> const& it ) : M_store( it.store() ), M_batch( it.batchIndex() ), M_index( it.index() ) {}
+
+        value_type operator*() const
+            {
+                auto& b = M_store->M_batches[M_batch];
+                return value_type( b.keys[M_index], map_t( b.data( M_index ), b.rows, b.cols ) );
+            }
+        pointer operator->() const { return pointer{ **this }; }
+        iterator_impl& operator++() { ++M_index; this->skipEmpty(); return *this; }
+        iterator_impl operator++( int ) { iterator_impl tmp( *this ); ++*this; return tmp; }
+
+        store_t* store() const { return M_store; }
+        int batchIndex() const { return M_batch; }
+        std::size_t index() const { return M_index; }
+
+        template<bool C>
+        bool operator==( iterator_impl<C> const& it ) const { return M_batch == it.batchIndex() && M_index == it.index(); }
+        template<bool C>
+        bool operator!=( iterator_impl<C> const& it ) const { return !( *this == it ); }
+    private:
+        void skipEmpty()
+            {
+                while ( M_store && M_batch < int( M_store->M_batches.size() ) && M_index >= M_store->M_batches[M_batch].size() )
+                {
+                    ++M_batch;
+                    M_index = 0;
+                }
+            }
+        store_t* M_store = nullptr;
+        int M_batch = 0;
+        std::size_t M_index = 0;
+    };
+
+public:
+    using iterator = iterator_impl<false>;
+    using const_iterator = iterator_impl<true>;
 
-    LocalMatrix() : super(), M_state( scstate::none ) {}
-    LocalMatrix( LocalMatrix const& lm ) : super(lm), M_state( lm.M_state )  {}
-    LocalMatrix( LocalMatrix && lm ) : super(lm), M_state( lm.M_state ) {}
+    LocalMatrix() : M_state( scstate::none ) {}
+    LocalMatrix( LocalMatrix const& lm ) = default;
+    LocalMatrix( LocalMatrix && lm ) = default;
+    LocalMatrix& operator=( LocalMatrix const& lm ) = default;
+    LocalMatrix& operator=( LocalMatrix && lm ) = default;
 
     bool isUpdated() const { return M_state == scstate::updated; }
     bool isModified() const { return M_state == scstate::modified; }
     scstate state() const { return M_state; }
     void setState( scstate s ) { M_state = s; }
+
+    std::size_t size() const { return M_slots.size(); }
+    bool empty() const { return M_slots.empty(); }
+    std::size_t count( key_type const& k ) const { return M_slots.count( k ); }
+
+    iterator begin() { return iterator( this, 0, 0 ); }
+    const_iterator begin() const { return const_iterator( this, 0, 0 ); }
+    iterator end() { return iterator( this, M_batches.size(), 0 ); }
+    const_iterator end() const { return const_iterator( this, M_batches.size(), 0 ); }
+
+    iterator find( key_type const& k )
+        {
+            auto it = M_slots.find( k );
+            return ( it == M_slots.end() )? this->end() : iterator( this, it->second.batch, it->second.index );
+        }
+    const_iterator find( key_type const& k ) const
+        {
+            auto it = M_slots.find( k );
+            return ( it == M_slots.end() )? this->end() : const_iterator( this, it->second.batch, it->second.index );
+        }
+
+    matrix_map_t at( key_type const& k )
+        {
+            auto const& s = M_slots.at( k );
+            auto& b = M_batches[s.batch];
+            return matrix_map_t( b.data( s.index ), b.rows, b.cols );
+        }
+    matrix_const_map_t at( key_type const& k ) const
+        {
+            auto const& s = M_slots.at( k );
+            auto const& b = M_batches[s.batch];
+            return matrix_const_map_t( b.data( s.index ), b.rows, b.cols );
+        }
+
+    //! add \p m to the matrix \p k, the matrix is created if it does not exist
+    template<typename MatrixT>
+    void add( key_type const& k, Eigen::MatrixBase<MatrixT> const& m )
+        {
+            auto [mk,inserted] = this->emplace( k, m.rows(), m.cols() );
+            if ( inserted )
+                mk.noalias() = m;
+            else
+                mk.noalias() += m;
+        }
+    //! set the matrix \p k to \p m, the matrix is created if it does not exist
+    template<typename MatrixT>
+    void set( key_type const& k, Eigen::MatrixBase<MatrixT> const& m )
+        {
+            this->emplace( k, m.rows(), m.cols() ).first.noalias() = m;
+        }
+    //! create a matrix \p k of size \p rows x \p cols if it does not exist
+    //! \return the matrix \p k and \c true if it has been created
+    std::pair<matrix_map_t,bool> emplace( key_type const& k, int rows, int cols )
+        {
+            auto it = M_slots.find( k );
+            if ( it != M_slots.end() )
+            {
+                auto& b = M_batches[it->second.batch];
+                CHECK( b.rows == rows && b.cols == cols ) << "invalid local matrix size " << rows << "x" << cols
+                                                          << " (stored " << b.rows << "x" << b.cols << ")";
+                return std::make_pair( matrix_map_t( b.data( it->second.index ), b.rows, b.cols ), false );
+            }
+            int bid = this->batchIndex( rows, cols );
+            auto& b = M_batches[bid];
+            b.keys.push_back( k );
+            b.values.resize( b.values.size() + std::size_t( rows )*cols, scalar_type( 0 ) );
+            M_slots.emplace( k, Slot{ bid, b.size()-1 } );
+            return std::make_pair( matrix_map_t( b.data( b.size()-1 ), rows, cols ), true );
+        }
+
+    //! zero out the matrices, the memory is preserved
+    void setZero()
+        {
+            for ( auto& b : M_batches )
+                std::fill( b.values.begin(), b.values.end(), scalar_type( 0 ) );
+        }
+    void clear()
+        {
+            M_slots.clear();
+            M_batches.clear();
+        }
+
+    //! number of batches (shapes of matrices)
+    int nBatches() const { return M_batches.size(); }
+    Batch const& batch( int i ) const { return M_batches[i]; }
+    Batch& batch( int i ) { return M_batches[i]; }
+
 private:
+    int batchIndex( int rows, int cols )
+        {
+            for ( int i = 0; i < int( M_batches.size() ); ++i )
+                if ( M_batches[i].rows == rows && M_batches[i].cols == cols )
+                    return i;
+            M_batches.push_back( Batch{ rows, cols, {}, {} } );
+            return M_batches.size()-1;
+        }
+
     scstate M_state;
+    std::unordered_map<key_type,Slot,boost::hash<key_type>> M_slots;
+    std::vector<Batch> M_batches;
 };
 
 template<typename local_vector_t, typename SizeT = uint32_type>
@@ -128,6 +320,62 @@ private:
     std::vector<size_type> M_f2;
 };
 
+//! this data structure stores the local solves A^{-1}B and A^{-1}F of the
+//! condensed elements in two contiguous buffers, the k-th block is a view
+//! at the offsets given at its insertion (no copy by element)
+template<typename T>
+class LocalSolves
+{
+public:
+    using value_type = T;
+    using local_vector_t = Eigen::Matrix<value_type,Eigen::Dynamic,1>;
+    using local_matrix_t = Eigen::Matrix<value_type,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor>;
+    using matrix_map_t = Eigen::Map<const local_matrix_t>;
+    using vector_map_t = Eigen::Map<const local_vector_t>;
+
+    //! remove the blocks and take the buffers of the local solves
+    void reset( std::vector<value_type>&& AinvBs, std::vector<value_type>&& AinvFs, std::size_t nBlocks = 0 )
+        {
+            M_AinvBs = std::move( AinvBs );
+            M_AinvFs = std::move( AinvFs );
+            M_blocks.clear();
+            M_blocks.reserve( nBlocks );
+        }
+    //! add the block of the element \p K : a \p N x \p M matrix and a vector of size \p N
+    void add( int K, int N, int M, std::size_t offsetB, std::size_t offsetF )
+        {
+            DCHECK( offsetB+N*M <= M_AinvBs.size() && offsetF+N <= M_AinvFs.size() ) << "invalid offsets for element " << K;
+            M_blocks.push_back( Block{ K, N, M, offsetB, offsetF } );
+        }
+
+    std::size_t size() const { return M_blocks.size(); }
+    bool empty() const { return M_blocks.empty(); }
+
+    //! @return the element of the k-th block
+    int element( std::size_t k ) const { return M_blocks[k].K; }
+    //! @return A^{-1}B of the k-th block
+    matrix_map_t AinvB( std::size_t k ) const
+        {
+            auto const& b = M_blocks[k];
+            return matrix_map_t( M_AinvBs.data()+b.offsetB, b.N, b.M );
+        }
+    //! @return A^{-1}F of the k-th block
+    vector_map_t AinvF( std::size_t k ) const
+        {
+            auto const& b = M_blocks[k];
+            return vector_map_t( M_AinvFs.data()+b.offsetF, b.N );
+        }
+
+private:
+    struct Block
+    {
+        int K, N, M;
+        std::size_t offsetB, offsetF;
+    };
+    std::vector<Block> M_blocks;
+    std::vector<value_type> M_AinvBs, M_AinvFs;
+};
+
 }
 
 template<typename T,typename IndexT=uint32_type>
@@ -298,102 +546,57 @@ public:
             }
 
 
-#undef FEELPP_STATICCONDENSATION_DETECT_LOCALDOF_PERMUTATIONS
-#define FEELPP_STATICCONDENSATION_DETECT_LOCALDOF_PERMUTATIONS 0
-
-#if FEELPP_STATICCONDENSATION_DETECT_LOCALDOF_PERMUTATIONS
-            std::map<rank_type,std::vector<boost::tuple<size_type,size_type,local_matrix_t,std::vector<size_type>,std::vector<size_type> > > > dataToSend;
-            std::map<rank_type,std::vector<boost::tuple<size_type,size_type,local_matrix_t,std::vector<size_type>,std::vector<size_type> > > > dataToRecv;
-#else
-            std::map<rank_type,std::vector<boost::tuple<size_type,size_type,local_matrix_t> > > dataToSend;
-            std::map<rank_type,std::vector<boost::tuple<size_type,size_type,local_matrix_t> > > dataToRecv;
-#endif
-
             std::set<rank_type> neighborSubdomainsRowCol;
             for ( rank_type neighborPid : rowSpace->mesh()->neighborSubdomains() )
                 neighborSubdomainsRowCol.insert( neighborPid );
             for ( rank_type neighborPid : colSpace->mesh()->neighborSubdomains() )
                 neighborSubdomainsRowCol.insert( neighborPid );
 
-            // update dataToSend
+            // pack the local matrices : for each matrix the ids of the row and
+            // column elements in the other partition and the sizes, the entries
+            // of all the matrices are stored contiguously
+            auto const& localMatrices = this->M_local_matrices[this->M_block_rowcol];
+            std::map<rank_type,std::vector<size_type>> keysToSend, keysToRecv;
+            std::map<rank_type,std::vector<value_type>> valuesToSend, valuesToRecv;
             for ( auto const& dataByProcess : localMatKeysToSynchronize )
             {
                 rank_type pid = dataByProcess.first;
+                auto& keys = keysToSend[pid];
+                auto& values = valuesToSend[pid];
                 for ( auto const& dataSync : dataByProcess.second )
                 {
-                    auto key = std::make_pair(std::get<0>(dataSync),std::get<1>(dataSync));
-                    local_matrix_t localMat = this->M_local_matrices.find(this->M_block_rowcol)->second.find(key)->second;
-
-#if FEELPP_STATICCONDENSATION_DETECT_LOCALDOF_PERMUTATIONS
-                    auto localDofInEltRow = rowSpace->dof()->localDof( key.first/*K*/ );
-                    auto localDofInEltCol = colSpace->dof()->localDof( key.second/*K2*/ );
-                    if ( localDofInEltRow.first == localDofInEltRow.second || localDofInEltCol.first == localDofInEltCol.second )
-                        continue;
-                    dataToSend[pid].push_back( boost::make_tuple( std::get<2>( dataSync ),std::get<3>( dataSync ), localMat,
-                                                                  rowSpace->dof()->getIndicesOnGlobalCluster( key.first ),
-                                                                  colSpace->dof()->getIndicesOnGlobalCluster( key.second ) ) );
-#else
-                    dataToSend[pid].push_back( boost::make_tuple( std::get<2>( dataSync ),std::get<3>( dataSync ), localMat ) );
-#endif
+                    auto localMat = localMatrices.at( std::make_pair( std::get<0>( dataSync ), std::get<1>( dataSync ) ) );
+                    keys.insert( keys.end(), { std::get<2>( dataSync ), std::get<3>( dataSync ), size_type( localMat.rows() ), size_type( localMat.cols() ) } );
+                    values.insert( values.end(), localMat.data(), localMat.data() + localMat.size() );
                 }
             }
             // send/recv
             int neighborSubdomains = neighborSubdomainsRowCol.size();
-            int nbRequest = 2*neighborSubdomains;
+            int nbRequest = 4*neighborSubdomains;
             mpi::request * reqs = new mpi::request[nbRequest];
             int cptRequest=0;
             WorldComm const& worldComm = rowSpace->mesh()->worldComm();
             for ( rank_type neighborPid : neighborSubdomainsRowCol )
             {
-                reqs[cptRequest++] = worldComm.localComm().isend( neighborPid , 0, dataToSend[neighborPid] );
-                reqs[cptRequest++] = worldComm.localComm().irecv( neighborPid , 0, dataToRecv[neighborPid] );
+                reqs[cptRequest++] = worldComm.localComm().isend( neighborPid , 0, keysToSend[neighborPid] );
+                reqs[cptRequest++] = worldComm.localComm().irecv( neighborPid , 0, keysToRecv[neighborPid] );
+                reqs[cptRequest++] = worldComm.localComm().isend( neighborPid , 1, valuesToSend[neighborPid] );
+                reqs[cptRequest++] = worldComm.localComm().irecv( neighborPid , 1, valuesToRecv[neighborPid] );
             }
             mpi::wait_all(reqs, reqs + nbRequest);
 
             delete [] reqs;
 
             // update local matrix
-            for ( auto const& dataRecvByProcess : dataToRecv )
+            auto& localMatricesUpdated = this->M_local_matrices[this->M_block_rowcol];
+            for ( auto const& [pid,keys] : keysToRecv )
             {
-                rank_type pid = dataRecvByProcess.first;
-                for ( auto const& dataSync : dataRecvByProcess.second )
+                value_type const* values = valuesToRecv[pid].data();
+                for ( std::size_t k = 0; k+3 < keys.size(); k += 4 )
                 {
-                    // std::cout << "recv mat\n " << boost::get<2>(dataSync) << "\n";
-                    auto key = std::make_pair(boost::get<0>(dataSync),boost::get<1>(dataSync));
-
-#if FEELPP_STATICCONDENSATION_DETECT_LOCALDOF_PERMUTATIONS
-                    auto localDofInEltRow = rowSpace->dof()->localDof( key.first/*K*/ );
-                    auto localDofInEltCol = colSpace->dof()->localDof( key.second/*K2*/ );
-                    if ( localDofInEltRow.first == localDofInEltRow.second || localDofInEltCol.first == localDofInEltCol.second )
-                        continue;
-
-                    auto const& locIndicesFromCurrentProcRow = rowSpace->dof()->getIndicesOnGlobalCluster( key.first );
-                    auto const& locIndicesFromCurrentProcCol = colSpace->dof()->getIndicesOnGlobalCluster( key.second );
-                    auto const& locIndicesFromOtherProcRow = boost::get<3>(dataSync);
-                    auto const& locIndicesFromOtherProcCol = boost::get<4>(dataSync);
-                    for (int locDofCurrentProc = 0; locDofCurrentProc<locIndicesFromCurrentProcRow.size(); ++locDofCurrentProc )
-                    {
-                        size_type gcdof = locIndicesFromCurrentProcRow[locDofCurrentProc];
-                        for (int locDofOtherProc = 0; locDofOtherProc<locIndicesFromOtherProcRow.size(); ++locDofOtherProc )
-                        {
-                            if ( locIndicesFromOtherProcRow[locDofOtherProc] == gcdof )
-                            {
-                                if ( locDofCurrentProc != locDofOtherProc )
-                                    std::cout << "["<<Environment::worldComm().rank() << "] FIND permutation in local matrix (row) : "
-                                              << locDofCurrentProc << " and " << locDofOtherProc << "\n";
-                                break;
-                            }
-                        }
-                    }
-                    // BK.col(4).swap(BK.col(5));
-                    // CK.row(4).swap(CK.row(5));
-#endif
-
-                    auto entry = this->M_local_matrices[this->M_block_rowcol].find(key);
-                    if ( entry == this->M_local_matrices[this->M_block_rowcol].end() )
-                        this->M_local_matrices[this->M_block_rowcol][key] = boost::get<2>(dataSync);
-                    else
-                        this->M_local_matrices[this->M_block_rowcol][key] += boost::get<2>(dataSync);
+                    int nrows = keys[k+2], ncols = keys[k+3];
+                    localMatricesUpdated.add( std::make_pair( keys[k], keys[k+1] ), raw_const_matrix_map_t( values, nrows, ncols ) );
+                    values += nrows*ncols;
                 }
             }
 
@@ -430,15 +633,8 @@ public:
     //!
     void zeroMatrix()
         {
-            std::for_each( M_local_matrices.begin(), M_local_matrices.end(),
-                           []( auto& m )
-                           {
-                               for( auto& e : m.second )
-                               {
-                                   e.second.setZero();
-                               }
-                           } );
-                           
+            for( auto& [block,m] : M_local_matrices )
+                m.setZero();
         }
     //!
     //! zero out the block matrix @arg n1,n2
@@ -446,10 +642,7 @@ public:
     //!
     void zero( int n1, int n2 )
         {
-            for( auto& e: M_local_matrices[std::make_pair(n1,n2)] )
-            {
-                e.second.setZero();
-            }
+            M_local_matrices[std::make_pair(n1,n2)].setZero();
         }
     //!
     //! zero out the set of local vectors
@@ -484,10 +677,13 @@ public:
     //!
     void transpose( int n1, int n2 )
         {
-            for( auto const& [key,matrix]: M_local_matrices[std::make_pair(n1,n2)] )
+            // copy the block, the insertions invalidate the matrices if n1 == n2
+            auto const matrices = M_local_matrices[std::make_pair(n1,n2)];
+            auto& matricesTransposed = this->M_local_matrices[std::pair{n2,n1}];
+            for( auto const& [key,matrix]: matrices )
             {
                 auto const & [id1,id2] = key;
-                this->M_local_matrices[std::pair{n2,n1}][std::pair{id2,id1}].noalias() = matrix.transpose();
+                matricesTransposed.set( std::pair{id2,id1}, matrix.transpose() );
             }
         }
     using local_vector_t = Eigen::Matrix<value_type,Eigen::Dynamic,1>;
@@ -495,12 +691,10 @@ public:
     using local_index_t = Eigen::Matrix<int,Eigen::Dynamic,1>;
     using raw_vector_map_t = Eigen::Map<local_vector_t>;
     using raw_matrix_map_t = Eigen::Map<local_matrix_t>;
+    using raw_const_matrix_map_t = Eigen::Map<const local_matrix_t>;
     using raw_index_map_t = Eigen::Map<local_index_t>;
 
-    using ainvb_t = std::unordered_map<int,local_matrix_t>;
-    using ainvb_iterator_t = typename ainvb_t::iterator;
-    using ainvb_const_iterator_t = typename ainvb_t::const_iterator;
-    using ainvf_t = std::unordered_map<int,local_vector_t>;
+    using local_solves_t = Feel::detail::LocalSolves<value_type>;
     using dk_t = std::unordered_map<int,Feel::detail::ElementFaces<>>;
 #if 0
     local_vector_t& localVector( size_type K ) { return M_local_vectors[this->M_block_row][K]; }
@@ -555,8 +749,7 @@ private:
     std::unordered_map<block_index_t,block_local_cols_t,boost::hash<block_index_t>> M_local_cols;
 
     
-    std::unordered_map<int,local_matrix_t> M_AinvB;
-    std::unordered_map<int,local_vector_t> M_AinvF;
+    local_solves_t M_localSolves;
     std::unordered_map<int,local_matrix_t> M_AK;
     std::unordered_map<int,local_matrix_t> M_BK;
     std::unordered_map<int,local_matrix_t> M_CK;
@@ -769,195 +962,6 @@ extractBlock( F0K_t const& F0K, size_type K,
         FK.head(N0) = F0K.at(K);
 }
 
-template<typename E, typename T, typename M_t, typename V_t>
-struct Condenser
-{
-    using value_t = T;
-    using size_type = uint32_type;
-    using sc_t=StaticCondensation<value_t> ;
-
-    using local_vector_t = typename sc_t::local_vector_t;
-    using local_matrix_t = typename sc_t::local_matrix_t;
-    using block_local_matrices_t = typename sc_t::block_local_matrices_t;
-    using block_local_vectors_t = typename sc_t::block_local_vectors_t;
-    using ainvb_t = typename sc_t::ainvb_t;
-    using ainvb_const_iterator_t = typename sc_t::ainvb_const_iterator_t;
-    using ainvf_t = typename sc_t::ainvf_t;
-    
-    using dk_t = typename sc_t::dk_t;
-    
-    template<typename LM_t, typename LV_t,typename Data_t>
-    Condenser( LM_t const& lm, LV_t const& lv, E& _e, dk_t& _dkset, ainvb_t& _ainvb, ainvf_t& _ainvf,  M_t& _m, V_t& _v, Data_t const& d )
-        :
-        A00K( lm.at(std::make_pair(0,0)) ),
-        A10K( lm.at(std::make_pair(1,0)) ),
-        A20K( lm.at(std::make_pair(2,0)) ),
-        A01K( lm.at(std::make_pair(0,1)) ),
-        A11K( lm.at(std::make_pair(1,1)) ),
-        A21K( lm.at(std::make_pair(2,1)) ),
-        A02K( lm.at(std::make_pair(0,2)) ),
-        A12K( lm.at(std::make_pair(1,2)) ),
-        A22K( lm.at(std::make_pair(2,2)) ),
-        F0K( lv.at(0) ),
-        F1K( lv.at(1) ),
-        F2K( lv.at(2) ),
-        e( _e ),
-        dkset( _dkset ),
-        AinvB( _ainvb ),
-        AinvF( _ainvf ),
-        S( _m ),
-        V( _v ),
-        grain(d.grain(A00K.size()) )
-        {
-            auto& e1 = e(0_c);
-            auto& e2 = e(1_c);
-            auto& e3 = e(2_c);
-            
-            N00 = e1.dof()->nLocalDof();
-            N0 = e1.dof()->nRealLocalDof();
-            N1 = e2.dof()->nLocalDof();
-            N = N0+N1;
-            N2 = e3.dof()->nLocalDof();
-            N3 = N2*e1.mesh()->numLocalTopologicalFaces();
-            LOG(INFO) << "[staticcondensation] N=" << N << " N0=" << N0 << " N1=" << N1 << " N2=" << N2 << " N3=" << N3 << " ntf=" << e1.mesh()->numLocalTopologicalFaces()<< std::endl;
-        }
-
-    template<typename EltIteratorT>
-    void operator()( EltIteratorT beg, EltIteratorT end )
-        {
-            auto& e1 = e(0_c);
-            auto& e2 = e(1_c);
-            auto& e3 = e(2_c);
-            int len = std::distance( beg, end );
-            if ( len < grain )
-            {
-                local_matrix_t AK( N, N ),A00(N0,N0),A01(N0,N1),A10(N1,N0), A11(N1,N1), A20(N3,N0), A21(N3,N1), A22(N3,N3);
-                local_matrix_t BK( N, N3 );
-                local_matrix_t CK( N3, N );
-                local_matrix_t DK( N3, N3 );
-                local_vector_t FK( N );
-                local_vector_t DKF( N3 );
-                local_vector_t F2( N3 );
-                //ocal_matrix_t Aldlt( N, N );
-                for( auto it= beg  ; it != end ; ++it )
-                {
-                    auto key = it->first;
-                    size_type K = key.first;
-
-                    DVLOG(2) << "======= Key=" << key ;
-
-                    DVLOG(2) << "A00K=" << A00K.at(key);
-                    DVLOG(2) << "A01K=" << A01K.at(key);
-                    DVLOG(2) << "A10K=" << A10K.at(key);
-
-                    AK = local_matrix_t::Zero( N, N );
-                    BK = local_matrix_t::Zero( N, N3 );
-                    CK = local_matrix_t::Zero( N3, N );
-
-
-                    extractBlock( A00K.at(key), A01K.at(key), A10K.at(key), AK, e1, e2 );
-                    AK.bottomRightCorner(N1, N1 ) = A11K.at(key);
-
-                    A22 = local_matrix_t::Zero(N3,N3);
-                    A20 = local_matrix_t::Zero(N3,N0);
-                    A21 = local_matrix_t::Zero(N3,N1);
-                    CK = local_matrix_t::Zero(N3,N);
-                    FK = local_vector_t::Zero(N);
-                    F2 = local_vector_t::Zero(N3);
-
-                    //std::cout << "AK=\n" << AK << std::endl;
-                    //std::cout << "AK-AK^T=\n" << (AK-AK.transpose()) << std::endl;
-                    // dK contains the set of faces ids in the submesh associated to the boundary of K
-                    std::pair<typename dk_t::iterator,bool> dK;
-                    
-                    {
-                        std::lock_guard<std::mutex> guard(this->mutex_dk);
-                        dK = dkset.emplace(key.first,
-                                           Feel::detail::ElementFaces<>(e3.mesh()->meshToSubMesh( e1.mesh()->element(key.first).facesId()).first) );
-                    }
-        
-                    int n = 0;
-                    std::for_each( dK.first->second.faces1().begin(), dK.first->second.faces1().end(), [&]( auto dKi )
-                                   {
-                                       auto key2 = std::make_pair(key.first, dKi );
-                                       auto key3 = std::make_pair(dKi,key.first);
-                                       auto key4 = std::make_pair(dKi, dKi);
-
-                                       DVLOG(2) << "A02.count(" << key2 << ")"  << A02K.count(key2);
-                                       DVLOG(2) << "A20.count(" << key3 << ")"  << A20K.count(key3);
-                                       DVLOG(2) << "A12.count(" << key2 << ")"  << A12K.count(key2);
-                                       DVLOG(2) << "A21.count(" << key3 << ")"  << A21K.count(key3);
-                                       DVLOG(2) << "A22.count(" << key4 << ")"  << A22K.count(key4);
-                                       DVLOG(2) << "F2.count(" << dKi << ")"  << F2K.count(dKi);
-
-                                       extractBlock( A02K, key2, A20K, key3, BK, CK, n, e1, e3 );
-
-                                       if ( A12K.count(key2) )
-                                           BK.block(N0,n*N2, N1, N2 ) = A12K.at(key2);
-
-                                       if ( A21K.count(key3) )
-                                           CK.block(n*N2, N0, N2, N1 ) = A21K.at(key3);
-
-                                       if ( A22K.count(key4) )
-                                           A22.block(n*N2, n*N2, N2, N2 ) = A22K.at(key4);
-
-                                       if ( F2K.count(dKi) )
-                                       {
-                                           F2.segment(n*N2,N2)=F2K.at(dKi);
-                                       }
-
-                                       ++n;
-                                   } );
-
-                    extractBlock( F0K, K, FK, e1 );
-                    FK.tail(N1) = F1K.at(K);
-
-                    auto Aldlt = AK.lu();
-
-                    auto _AinvB = Aldlt.solve( BK );
-                    auto _AinvF = Aldlt.solve( FK );
-
-                    // local assemble DK and DKF
-                    DK=-CK*_AinvB+A22 ;
-                    DKF=-CK*_AinvF+F2;
-
-                    auto dofs = e3.dofs(dK.first->second.faces1());
-
-                    {
-                        std::lock_guard<std::mutex> guard(this->mutex_dk);
-                        AinvB.emplace( K, _AinvB );
-                        AinvF.emplace( K, _AinvF );
-
-                        S(0_c,0_c).addMatrix( dofs.data(), dofs.size(), dofs.data(), dofs.size(), DK.data(), invalid_v<size_type>, invalid_v<size_type> );
-                        V(0_c).addVector( dofs.data(), dofs.size(), DKF.data(), invalid_v<size_type>, invalid_v<size_type> );
-                    }
-                }
-                return;
-            } // len < grain
-            EltIteratorT mid = beg;
-            std::advance( mid, len / 2 );
-            auto handle = std::async( std::launch::async,
-                                      &Condenser<E,T,M_t,V_t>::operator()<EltIteratorT>, this, mid, end );
-            this->operator()( beg, mid );
-            handle.get();
-        }
-    
-private:
-    int N00, N, N0, N1, N2, N3;
-    block_local_matrices_t const& A00K, A10K, A20K, A30K,
-        A01K, A11K, A21K, A31K,
-        A02K, A12K, A22K, A32K,
-        A03K, A13K, A23K, A33K;
-    block_local_vectors_t const& F0K, F1K, F2K, F3K;
-    E& e;
-    dk_t& dkset;
-    ainvb_t& AinvB;
-    ainvf_t& AinvF;
-    M_t& S;
-    V_t& V;
-    int grain;
-    std::mutex mutex_dk;
-};
 template<typename T, typename IndexT>
 template<typename E, typename M_ptrtype, typename V_ptrtype>
 void
@@ -995,124 +999,115 @@ StaticCondensation<T,IndexT>::condense( std::shared_ptr<StaticCondensation<T>> c
     auto const& F2K = rhs->M_local_vectors[2];
     LOG(INFO) << "F2K.size=" << F2K.size();
 
-    if ( M_condense.parallel )
+    int N0 = e1.dof()->nRealLocalDof();
+    int N1 = e2.dof()->nLocalDof();
+    int N = N0+N1;
+    int N2 = e3.dof()->nLocalDof();
+    int N3 = N2*e1.mesh()->numLocalTopologicalFaces();
+    LOG(INFO) << "[staticcondensation] N=" << N << " N0=" << N0 << " N1=" << N1 << " N2=" << N2 << " N3=" << N3 << " ntf=" << e1.mesh()->numLocalTopologicalFaces();
+
+    tic();
+    // dK contains the set of faces ids in the submesh associated to the boundary of K
+    std::vector<block_element_t> keys;
+    std::vector<Feel::detail::ElementFaces<> const*> dKs;
+    keys.reserve( A00K.size() );
+    dKs.reserve( A00K.size() );
+    for( auto it = A00K.begin(), en = A00K.end(); it != en; ++it )
     {
-        tic();
-        Condenser<E,T,M_ptrtype,V_ptrtype> c( M_local_matrices, rhs->M_local_vectors, e, M_dK, M_AinvB, M_AinvF, S, V, M_condense );
-        c( A00K.begin(), A00K.end() );
-        toc("sc.condense.parallel",FLAGS_v>0);
+        auto key = it->first;
+        auto dK = M_dK.emplace( key.first, Feel::detail::ElementFaces<>(e3.mesh()->meshToSubMesh( e1.mesh()->element(key.first).facesId()).first) );
+        keys.push_back( key );
+        dKs.push_back( &dK.first->second );
     }
-    else
-    {
-        tic();
-        auto it = A00K.begin();
-        auto en = A00K.end();
-
-        int N00 = e1.dof()->nLocalDof();
-        int N0 = e1.dof()->nRealLocalDof();
-        int N1 = e2.dof()->nLocalDof();
-        int N = N0+N1;
-        int N2 = e3.dof()->nLocalDof();
-        int N3 = N2*e1.mesh()->numLocalTopologicalFaces();
-        cout << "[staticcondensation] N=" << N << " N0=" << N0 << " N1=" << N1 << " N2=" << N2 << " N3=" << N3 << " ntf=" << e1.mesh()->numLocalTopologicalFaces()<< std::endl;
-        local_matrix_t AK( N, N ),A00(N0,N0),A01(N0,N1),A10(N1,N0), A11(N1,N1), A20(N3,N0), A21(N3,N1), A22(N3,N3);
-        local_matrix_t BK( N, N3 );
-        local_matrix_t CK( N3, N );
-        local_matrix_t DK( N3, N3 );
-        local_vector_t FK( N );
-        local_vector_t DKF( N3 );
-        local_vector_t F2( N3 );
-        //ocal_matrix_t Aldlt( N, N );
-        for( ; it != en ; ++it )
+    toc("sc.condense.faces",FLAGS_v>1);
+
+    // the local solves and the Schur complements of the elements are computed
+    // by chunks of elements (one by task) and stored in contiguous buffers
+    tic();
+    const std::size_t nElts = keys.size();
+    std::vector<value_type> AinvBs( nElts*N*N3 ), AinvFs( nElts*N ), DKs( nElts*N3*N3 ), DKFs( nElts*N3 );
+    auto condenseElements = [&]( std::size_t begin, std::size_t end )
         {
-            tic();
-            auto key = it->first;
-            size_type K = key.first;
-
-            DVLOG(2) << "======= Key=" << key ;
-
-            DVLOG(2) << "A00K=" << A00K.at(key);
-            DVLOG(2) << "A01K=" << A01K.at(key);
-            DVLOG(2) << "A10K=" << A10K.at(key);
-
-            AK = local_matrix_t::Zero( N, N );
-            BK = local_matrix_t::Zero( N, N3 );
-            CK = local_matrix_t::Zero( N3, N );
-
+            local_matrix_t AK( N, N ), A22( N3, N3 ), BK( N, N3 ), CK( N3, N );
+            local_vector_t FK( N ), F2( N3 );
+            Eigen::PartialPivLU<local_matrix_t> Alu( N );
+            for( std::size_t k = begin; k < end; ++k )
+            {
+                auto const& key = keys[k];
+                size_type K = key.first;
 
-            extractBlock( A00K.at(key), A01K.at(key), A10K.at(key), AK, e1, e2 );
-            AK.bottomRightCorner(N1, N1 ) = A11K.at(key);
+                DVLOG(2) << "======= Key=" << key ;
 
-            A22 = local_matrix_t::Zero(N3,N3);
-            A20 = local_matrix_t::Zero(N3,N0);
-            A21 = local_matrix_t::Zero(N3,N1);
-            CK = local_matrix_t::Zero(N3,N);
-            FK = local_vector_t::Zero(N);
-            F2 = local_vector_t::Zero(N3);
+                AK.setZero();
+                BK.setZero();
+                CK.setZero();
+                A22.setZero();
+                FK.setZero();
+                F2.setZero();
 
-            //std::cout << "AK=\n" << AK << std::endl;
-            //std::cout << "AK-AK^T=\n" << (AK-AK.transpose()) << std::endl;
-            // dK contains the set of faces ids in the submesh associated to the boundary of K
-            auto dK = M_dK.emplace(key.first, Feel::detail::ElementFaces<>(e3.mesh()->meshToSubMesh( e1.mesh()->element(key.first).facesId()).first) );
-        
-            int n = 0;
-            std::for_each( dK.first->second.faces1().begin(), dK.first->second.faces1().end(), [&]( auto dKi )
-                           {
-                               auto key2 = std::make_pair(key.first, dKi );
-                               auto key3 = std::make_pair(dKi,key.first);
-                               auto key4 = std::make_pair(dKi, dKi);
+                extractBlock( A00K.at(key), A01K.at(key), A10K.at(key), AK, e1, e2 );
+                AK.bottomRightCorner(N1, N1 ) = A11K.at(key);
 
-                               DVLOG(2) << "A02.count(" << key2 << ")"  << A02K.count(key2);
-                               DVLOG(2) << "A20.count(" << key3 << ")"  << A20K.count(key3);
-                               DVLOG(2) << "A12.count(" << key2 << ")"  << A12K.count(key2);
-                               DVLOG(2) << "A21.count(" << key3 << ")"  << A21K.count(key3);
-                               DVLOG(2) << "A22.count(" << key4 << ")"  << A22K.count(key4);
-                               DVLOG(2) << "F2.count(" << dKi << ")"  << F2K.count(dKi);
+                int n = 0;
+                for( auto dKi : dKs[k]->faces1() )
+                {
+                    auto key2 = std::make_pair(key.first, dKi );
+                    auto key3 = std::make_pair(dKi,key.first);
+                    auto key4 = std::make_pair(dKi, dKi);
 
-                               extractBlock( A02K, key2, A20K, key3, BK, CK, n, e1, e3 );
+                    extractBlock( A02K, key2, A20K, key3, BK, CK, n, e1, e3 );
 
-                               if ( A12K.count(key2) )
-                                   BK.block(N0,n*N2, N1, N2 ) = A12K.at(key2);
+                    if ( A12K.count(key2) )
+                        BK.block(N0,n*N2, N1, N2 ) = A12K.at(key2);
 
-                               if ( A21K.count(key3) )
-                                   CK.block(n*N2, N0, N2, N1 ) = A21K.at(key3);
+                    if ( A21K.count(key3) )
+                        CK.block(n*N2, N0, N2, N1 ) = A21K.at(key3);
 
-                               if ( A22K.count(key4) )
-                                   A22.block(n*N2, n*N2, N2, N2 ) = A22K.at(key4);
+                    if ( A22K.count(key4) )
+                        A22.block(n*N2, n*N2, N2, N2 ) = A22K.at(key4);
 
-                               if ( F2K.count(dKi) )
-                               {
-                                   F2.segment(n*N2,N2)=F2K.at(dKi);
-                               }
+                    if ( F2K.count(dKi) )
+                        F2.segment(n*N2,N2)=F2K.at(dKi);
 
-                               ++n;
-                           } );
-
-            extractBlock( F0K, K, FK, e1 );
-            FK.tail(N1) = F1K.at(K);
-
-            auto Aldlt = AK.lu();
+                    ++n;
+                }
 
-            auto AinvB = Aldlt.solve( BK );
-            auto AinvF = Aldlt.solve( FK );
+                extractBlock( F0K, K, FK, e1 );
+                FK.tail(N1) = F1K.at(K);
 
-            // local assemble DK and DKF
-            DK=-CK*AinvB+A22 ;
-            DKF=-CK*AinvF+F2;
+                Alu.compute( AK );
+                raw_matrix_map_t AinvB( AinvBs.data()+k*N*N3, N, N3 );
+                raw_vector_map_t AinvF( AinvFs.data()+k*N, N );
+                AinvB.noalias() = Alu.solve( BK );
+                AinvF.noalias() = Alu.solve( FK );
 
-            M_AinvB.emplace( K, AinvB );
-            M_AinvF.emplace( K, AinvF );
-            toc("sc.condense.localassembly", FLAGS_v>1);
-            tic();
-            auto dofs = e3.dofs(dK.first->second.faces1());
+                // local assemble DK and DKF
+                raw_matrix_map_t( DKs.data()+k*N3*N3, N3, N3 ).noalias() = A22 - CK*AinvB;
+                raw_vector_map_t( DKFs.data()+k*N3, N3 ).noalias() = F2 - CK*AinvF;
+            }
+        };
+    int nTasks = M_condense.parallel ? std::max( 1, M_condense.tasks ) : 1;
+    std::size_t chunk = ( nElts+nTasks-1 )/nTasks;
+    std::vector<std::future<void>> futs;
+    for( int t = 1; t < nTasks; ++t )
+        futs.push_back( std::async( std::launch::async, condenseElements, std::min( nElts, t*chunk ), std::min( nElts, (t+1)*chunk ) ) );
+    condenseElements( 0, std::min( nElts, chunk ) );
+    for( auto& fut : futs )
+        fut.get();
+    toc("sc.condense.localassembly",FLAGS_v>0);
 
-            S(0_c,0_c).addMatrix( dofs.data(), dofs.size(), dofs.data(), dofs.size(), DK.data(), invalid_v<size_type>, invalid_v<size_type> );
-            V(0_c).addVector( dofs.data(), dofs.size(), DKF.data(), invalid_v<size_type>, invalid_v<size_type> );
-            toc("sc.condense.globalassembly", FLAGS_v>1);
-        } // else
-        toc("sc.condense.sequential", FLAGS_v>0);
+    tic();
+    M_localSolves.reset( std::move( AinvBs ), std::move( AinvFs ), nElts );
+    for( std::size_t k = 0; k < nElts; ++k )
+    {
+        size_type K = keys[k].first;
+        M_localSolves.add( K, N, N3, k*N*N3, k*N );
 
+        auto dofs = e3.dofs(dKs[k]->faces1());
+        S(0_c,0_c).addMatrix( dofs.data(), dofs.size(), dofs.data(), dofs.size(), DKs.data()+k*N3*N3, invalid_v<size_type>, invalid_v<size_type> );
+        V(0_c).addVector( dofs.data(), dofs.size(), DKFs.data()+k*N3, invalid_v<size_type>, invalid_v<size_type> );
     }
+    toc("sc.condense.globalassembly",FLAGS_v>0);
     M_nnz = S.nnz();
 }
 
@@ -1133,40 +1128,38 @@ StaticCondensation<T,IndexT>::condense( std::shared_ptr<StaticCondensation<T>> c
     auto& e2 = e(1_c);
     auto& e3 = e(2_c);
     auto const& A00K = M_local_matrices[std::make_pair(0,0)];
-    //LOG(INFO) << "A00K.size=" << A00K.size();
     auto const& A10K = M_local_matrices[std::make_pair(1,0)];
-    //LOG(INFO) << "A10K.size=" << A10K.size();
     auto const& A01K = M_local_matrices[std::make_pair(0,1)];
-    //LOG(INFO) << "A01K.size=" << A01K.size();
     auto const& A11K = M_local_matrices[std::make_pair(1,1)];
-    //LOG(INFO) << "A11K.size=" << A11K.size();
     auto const& A02K = M_local_matrices[std::make_pair(0,2)];
-    //LOG(INFO) << "A02K.size=" << A02K.size();
     auto const& A12K = M_local_matrices[std::make_pair(1,2)];
-    //LOG(INFO) << "A12K.size=" << A12K.size();
     auto const& A20K = M_local_matrices[std::make_pair(2,0)];
-    //LOG(INFO) << "A20K.size=" << A20K.size();
     auto const& A21K = M_local_matrices[std::make_pair(2,1)];
-    //LOG(INFO) << "A21K.size=" << A21K.size();
     auto const& A22K = M_local_matrices[std::make_pair(2,2)];
-    //LOG(INFO) << "A22K.size=" << A22K.size();
-
-    auto Adyn = [this]( int row, int col ){ return M_local_matrices[std::pair{row,col}]; };
-    auto Fdyn = [rhs]( int row ){ return rhs->M_local_vectors[row]; };
 
     auto const& F0K = rhs->M_local_vectors[0];
-    //LOG(INFO) << "F0K.size=" << F0K.size();
     auto const& F1K = rhs->M_local_vectors[1];
-    //LOG(INFO) << "F1K.size=" << F1K.size();
     auto const& F2K = rhs->M_local_vectors[2];
-    
-    //LOG(INFO) << "F2K.size=" << F2K.size();
-    auto F4K = [&rhs]( int i ) { return rhs->M_local_vectors[i]; };
 
-    auto it = A00K.begin();
-    auto en = A00K.end();
+    // the blocks of the subspaces of the fourth space are fetched before the
+    // (possibly multithreaded) local computations
+    int nSpaces3 = e.functionSpace(3_c)->numberOfSpaces();
+    auto Adyn = [this]( int row, int col ) { return &M_local_matrices[std::pair{row,col}]; };
+    auto Fdyn = [&rhs]( int row ) { return &rhs->M_local_vectors[row]; };
+    std::vector<block_local_matrices_t const*> A30Ks( nSpaces3 ), A31Ks( nSpaces3 ), A03Ks( nSpaces3 ), A13Ks( nSpaces3 );
+    std::vector<std::vector<block_local_matrices_t const*>> A33Ks( nSpaces3, std::vector<block_local_matrices_t const*>( nSpaces3 ) );
+    std::vector<block_local_vectors_t const*> F3Ks( nSpaces3 );
+    for ( int i = 0; i < nSpaces3; ++i )
+    {
+        A30Ks[i] = Adyn( 3+i, 0 );
+        A31Ks[i] = Adyn( 3+i, 1 );
+        A03Ks[i] = Adyn( 0, 3+i );
+        A13Ks[i] = Adyn( 1, 3+i );
+        for ( int j = 0; j < nSpaces3; ++j )
+            A33Ks[i][j] = Adyn( 3+i, 3+j );
+        F3Ks[i] = Fdyn( 3+i );
+    }
 
-    int N00 = e1.dof()->nLocalDof();
     int N0 = e1.dof()->nRealLocalDof();
     int N1 = e2.dof()->nLocalDof();
     int N = N0+N1;
@@ -1188,364 +1181,248 @@ StaticCondensation<T,IndexT>::condense( std::shared_ptr<StaticCondensation<T>> c
     int N4 = N41+N42;
     bool other_than_ibc_space = e.functionSpace(3_c)->hasOtherThanIbcSpace();
     cout << "[staticcondensation] N=" << N << " N0=" << N0 << " N1=" << N1 << " N2=" << N2 << " N3=" << N3 << " N4=" << N4 << "(" << N41 << "+" << N42 << ")" << " ntf=" << e1.mesh()->numLocalTopologicalFaces()<< std::endl;
-    local_matrix_t AK( N, N ),A00(N0,N0),A01(N0,N1),A10(N1,N0), A11(N1,N1), A20(N3,N0), A21(N3,N1), A22(N3,N3);
-    local_matrix_t A03(N0,N42),A30(N42,N0), A13(N1,N42),A31(N42,N1), A23(N2,N42),A32(N42,N2), A33(N42,N42);
-    local_matrix_t A43(N43,N42),A34(N42,N43), A44(N43,N43);
-    local_matrix_t BK( N, N3 ),BK3( N,N4);
-    local_matrix_t CK( N3, N ),CK3( N4,N);
-    local_matrix_t DK( N3, N3 ), DK3( N4,N4);
-    local_vector_t FK( N );
-    local_vector_t DKF( N3 );
-    local_vector_t DKF3(N4);
-    local_vector_t F2( N3 ), F3(N4), F4(N43);
-    for( ; it != en ; ++it )
+
+    // dK contains the set of faces ids in the submesh associated to the boundary of K,
+    // the faces of the ibc spaces are added to the elements with missing faces
+    tic();
+    struct ElementInfo
+    {
+        block_element_t key;
+        Feel::detail::ElementFaces<> const* dK;
+        uint16_type index_not_ibc;
+        bool has_ibc_coupling;
+        // size of the trace unknowns and offsets of the results in the buffers
+        int M;
+        std::size_t offsetB, offsetD, offsetF, offsetDF;
+    };
+    std::vector<ElementInfo> elts;
+    elts.reserve( A00K.size() );
+    std::size_t sizeB = 0, sizeD = 0, sizeF = 0, sizeDF = 0;
+    for( auto it = A00K.begin(), en = A00K.end(); it != en; ++it )
     {
         auto key = it->first;
         size_type K = key.first;
-        DVLOG(2) << "======= Key=" << key ;
-
-        DVLOG(2) << "A00K=" << A00K.at(key);
-        DVLOG(2) << "A01K=" << A01K.at(key);
-        DVLOG(2) << "A10K=" << A10K.at(key);
-
-        AK = local_matrix_t::Zero( N, N );
-        BK = local_matrix_t::Zero( N, N3 );
-        CK = local_matrix_t::Zero( N3, N );
-        
-        tic();
-        extractBlock( A00K.at(key), A01K.at(key), A10K.at(key), AK, e1, e2 );
-        AK.bottomRightCorner(N1, N1 ) = A11K.at(key);
-
-        dK_iterator_type dK_it;
         // index of the function space in e4
         uint16_type index = 0, index_not_ibc = 0;
         bool has_ibc_coupling = false;
+        dK_iterator_type dK_it = M_dK.end();
+        auto dK = e3.mesh()->meshToSubMesh( e1.mesh()->element(key.first).facesId());
+        decltype(dK) dK1;
+        if ( dK.second ) // there are missing
         {
-            auto dK = e3.mesh()->meshToSubMesh( e1.mesh()->element(key.first).facesId());
-            decltype(dK) dK1;
-            dK_it = M_dK.end();
-            if ( dK.second ) // there are missing
+            for ( int i = 0; i < nSpaces3; ++i )
             {
-                //Feel::cout << "missing faces" << key.first << ":" << dK << " -- " << e.functionSpace(3_c)->numberOfSpaces() << std::endl;
-                for ( int i = 0; i < e.functionSpace(3_c)->numberOfSpaces(); ++i )
+                if ( e.functionSpace(3_c)->isIbcSpace( i ) )
                 {
-                    if ( e.functionSpace(3_c)->isIbcSpace( i ) )
+                    dK1 = e(3_c,i).mesh()->meshToSubMesh( e1.mesh()->element(key.first).facesId());
+                    LOG(INFO) << "possibly adding faces from space " << i << " element " << key.first << ":" << dK1 << " fIds" << e1.mesh()->element(key.first).facesId();
+                    if ( !dK1.first.empty() )
                     {
-                        dK1 = e(3_c,i).mesh()->meshToSubMesh( e1.mesh()->element(key.first).facesId());
-                        LOG(INFO) << "possibly adding faces from space " << i << " element " << key.first << ":" << dK1 << " fIds" << e1.mesh()->element(key.first).facesId();
-                        if ( !dK1.first.empty() )
-                        {
-                            //Feel::cout << " . added face from space index " << i << std::endl;
-                            index = i;
-                            dK_it = M_dK.emplace( K, Feel::detail::ElementFaces<>( std::move(dK.first), std::move(dK1.first), index ) ).first;
-                        }
+                        index = i;
+                        dK_it = M_dK.emplace( K, Feel::detail::ElementFaces<>( std::move(dK.first), std::move(dK1.first), index ) ).first;
                     }
-                    else
+                }
+                else
+                {
+                    dK1 = e(3_c,i).mesh()->meshToSubMesh( e1.mesh()->element(key.first).facesId());
+                    if ( !dK1.first.empty() )
                     {
-                        dK1 = e(3_c,i).mesh()->meshToSubMesh( e1.mesh()->element(key.first).facesId());
-                        if ( !dK1.first.empty() )
-                        {
-                            
-                            index_not_ibc = i;
-                            has_ibc_coupling = true;
-                            //Feel::cout << "index_not_ibc: " << index_not_ibc << std::endl;
-                        }
+                        index_not_ibc = i;
+                        has_ibc_coupling = true;
                     }
-                    
                 }
-                DCHECK( dK_it != M_dK.end() ) << "could not find missing faces";
             }
-            else
-                dK_it = M_dK.emplace( K, Feel::detail::ElementFaces<>( std::move(dK.first) ) ).first;
+            DCHECK( dK_it != M_dK.end() ) << "could not find missing faces";
         }
-
-        auto & dK = dK_it->second;
-        if ( dK.hasSameTrace() )
+        else
+            dK_it = M_dK.emplace( K, Feel::detail::ElementFaces<>( std::move(dK.first) ) ).first;
+
+        int M = dK_it->second.hasSameTrace()? N3 : N4;
+        elts.push_back( ElementInfo{ key, &dK_it->second, index_not_ibc, has_ibc_coupling, M, sizeB, sizeD, sizeF, sizeDF } );
+        sizeB += N*M;
+        sizeD += M*M;
+        sizeF += N;
+        sizeDF += M;
+    }
+    toc("sc.condense.faces",FLAGS_v>1);
+
+    // the local solves and the Schur complements of the elements are computed
+    // by chunks of elements (one by task) and stored in contiguous buffers
+    tic();
+    const std::size_t nElts = elts.size();
+    std::vector<value_type> AinvBs( sizeB ), AinvFs( sizeF ), DKs( sizeD ), DKFs( sizeDF );
+    auto condenseElements = [&]( std::size_t begin, std::size_t end )
         {
-            A22 = local_matrix_t::Zero(N3,N3);
-            A20 = local_matrix_t::Zero(N3,N0);
-            A21 = local_matrix_t::Zero(N3,N1);
-            CK = local_matrix_t::Zero(N3,N);
-            FK = local_vector_t::Zero(N);
-            F2 = local_vector_t::Zero(N3);
-            //std::cout << "AK=\n" << AK << std::endl;
-            //std::cout << "AK-AK^T=\n" << (AK-AK.transpose()) << std::endl;
-            // dK contains the set of faces ids in the submesh associated to the boundary of K
-        
-            int n = 0;
-            std::for_each( dK.faces1().begin(), dK.faces1().end(), [&]( auto dKi )
-                           {
-                               auto key2 = std::make_pair(key.first, dKi );
-                               auto key3 = std::make_pair(dKi,key.first);
-                               auto key4 = std::make_pair(dKi, dKi);
+            local_matrix_t AK( N, N ), A22, BK, CK;
+            local_vector_t FK( N ), F2;
+            Eigen::PartialPivLU<local_matrix_t> Alu( N );
+            for( std::size_t k = begin; k < end; ++k )
+            {
+                auto const& info = elts[k];
+                auto const& key = info.key;
+                auto const& dK = *info.dK;
+                size_type K = key.first;
+                int M = info.M;
+                DVLOG(2) << "======= Key=" << key ;
+
+                AK.setZero();
+                FK.setZero();
+                BK = local_matrix_t::Zero( N, M );
+                CK = local_matrix_t::Zero( M, N );
+                A22 = local_matrix_t::Zero( M, M );
+                F2 = local_vector_t::Zero( M );
+
+                extractBlock( A00K.at(key), A01K.at(key), A10K.at(key), AK, e1, e2 );
+                AK.bottomRightCorner(N1, N1 ) = A11K.at(key);
+
+                int n = 0;
+                for( auto dKi : dK.faces1() )
+                {
+                    auto key2 = std::make_pair(key.first, dKi );
+                    auto key3 = std::make_pair(dKi,key.first);
+                    auto key4 = std::make_pair(dKi, dKi);
 
-                               DVLOG(2) << "A02.count(" << key2 << ")"  << A02K.count(key2);
-                               DVLOG(2) << "A20.count(" << key3 << ")"  << A20K.count(key3);
-                               DVLOG(2) << "A12.count(" << key2 << ")"  << A12K.count(key2);
-                               DVLOG(2) << "A21.count(" << key3 << ")"  << A21K.count(key3);
-                               DVLOG(2) << "A22.count(" << key4 << ")"  << A22K.count(key4);
-                               DVLOG(2) << "F2.count(" << dKi << ")"  << F2K.count(dKi);
+                    extractBlock( A02K, key2, A20K, key3, BK, CK, n, e1, e3 );
 
-                               extractBlock( A02K, key2, A20K, key3, BK, CK, n, e1, e3 );
+                    if ( A12K.count(key2) )
+                        BK.block(N0,n*N2, N1, N2 ) = A12K.at(key2);
 
-                               if ( A12K.count(key2) )
-                                   BK.block(N0,n*N2, N1, N2 ) = A12K.at(key2);
+                    if ( A21K.count(key3) )
+                        CK.block(n*N2, N0, N2, N1 ) = A21K.at(key3);
 
-                               if ( A21K.count(key3) )
-                                   CK.block(n*N2, N0, N2, N1 ) = A21K.at(key3);
+                    if ( A22K.count(key4) )
+                        A22.block(n*N2, n*N2, N2, N2 ) = A22K.at(key4);
 
-                               if ( A22K.count(key4) )
-                                   A22.block(n*N2, n*N2, N2, N2 ) = A22K.at(key4);
+                    if ( F2K.count(dKi) )
+                        F2.segment(n*N2,N2)=F2K.at(dKi);
 
-                               if ( F2K.count(dKi) )
-                               {
-                                   F2.segment(n*N2,N2)=F2K.at(dKi);
-                               }
+                    ++n;
+                }
+                if ( !dK.hasSameTrace() )
+                {
+                    int si = dK.spaceIndex();
+                    auto const& A30K = *A30Ks[si];
+                    auto const& A31K = *A31Ks[si];
+                    auto const& A03K = *A03Ks[si];
+                    auto const& A13K = *A13Ks[si];
+                    auto const& A33K = *A33Ks[si][si];
+                    auto const& F3K = *F3Ks[si];
+                    int n2 = 0;
+                    for( auto dKi : dK.faces2() )
+                    {
+                        auto key2 = std::make_pair(key.first, dKi );
+                        auto key3 = std::make_pair(dKi,key.first);
+                        auto key4 = std::make_pair(dKi, dKi);
+
+                        extractBlock( A03K, key2, A30K, key3, BK, CK, n2, e1, e(3_c,si), n*e3.dof()->nLocalDof() );
+                        if ( A13K.count(key2) )
+                            BK.block(N0,n*N2+n2*N42, N1, N42 ) = A13K.at(key2);
+                        if ( A31K.count(key3) )
+                            CK.block(n*N2+n2*N42, N0, N42, N1 ) = A31K.at(key3);
+                        if ( A33K.count(key4) )
+                            A22.block(n*N2+n2*N42, n*N2, N42, N42 ) = A33K.at(key4);
+                        if ( F3K.count(dKi) )
+                            F2.segment(n*N2+n2*N42,N42)=F3K.at(dKi);
+
+                        ++n2;
+                    }
+                }
 
-                               ++n;
-                           } );
-            extractBlock( F0K, K, FK, e1 );
-            FK.tail(N1) = F1K.at(K);
-            if ( VLOG_IS_ON(2) )
-            {
-                cout<< "A22=" << A22 << std::endl;
-                cout<< "BK=" << BK << std::endl;
-                cout<< "CK=" << CK << std::endl;
-                cout<< "CK.T=" << CK.transpose() << std::endl;
-                cout<< "FK=" << FK << std::endl;
-                cout<< "F2=" << F2 << std::endl;
-            }
+                extractBlock( F0K, K, FK, e1 );
+                FK.tail(N1) = F1K.at(K);
 
-            auto Aldlt = AK.lu();
+                Alu.compute( AK );
+                raw_matrix_map_t AinvB( AinvBs.data()+info.offsetB, N, M );
+                raw_vector_map_t AinvF( AinvFs.data()+info.offsetF, N );
+                AinvB.noalias() = Alu.solve( BK );
+                AinvF.noalias() = Alu.solve( FK );
 
-            auto AinvB = Aldlt.solve( BK );
-            auto AinvF = Aldlt.solve( FK );
+                // local assemble DK and DKF
+                raw_matrix_map_t( DKs.data()+info.offsetD, M, M ).noalias() = A22 - CK*AinvB;
+                raw_vector_map_t( DKFs.data()+info.offsetDF, M ).noalias() = F2 - CK*AinvF;
+            }
+        };
+    int nTasks = M_condense.parallel ? std::max( 1, M_condense.tasks ) : 1;
+    std::size_t chunk = ( nElts+nTasks-1 )/nTasks;
+    std::vector<std::future<void>> futs;
+    for( int t = 1; t < nTasks; ++t )
+        futs.push_back( std::async( std::launch::async, condenseElements, std::min( nElts, t*chunk ), std::min( nElts, (t+1)*chunk ) ) );
+    condenseElements( 0, std::min( nElts, chunk ) );
+    for( auto& fut : futs )
+        fut.get();
+    toc("sc.condense.localassembly",FLAGS_v>0);
 
-            // local assemble DK and DKF
-            DK=-CK*AinvB+A22 ;
-            DKF=-CK*AinvF+F2;
+    tic();
+    local_matrix_t A34(N42,N43), A43(N43,N42), A44(N43,N43);
+    local_vector_t F4(N43);
+    M_localSolves.reset( std::move( AinvBs ), std::move( AinvFs ), nElts );
+    for( std::size_t k = 0; k < nElts; ++k )
+    {
+        auto const& info = elts[k];
+        auto const& dK = *info.dK;
+        size_type K = info.key.first;
+        int M = info.M;
+        M_localSolves.add( K, N, M, info.offsetB, info.offsetF );
+        raw_matrix_map_t DK( DKs.data()+info.offsetD, M, M );
+        raw_vector_map_t DKF( DKFs.data()+info.offsetDF, M );
 
-            M_AinvB.emplace( K, AinvB );
-            M_AinvF.emplace( K, AinvF );
-            toc("sc.condense.localassembly", FLAGS_v>1);
-            tic();
+        if ( dK.hasSameTrace() )
+        {
             auto dofs = e3.dofs(dK.faces1(),S.matrixPtr()->mapRow(),0);
-            
             S(0_c,0_c).addMatrix( dofs.data(), dofs.size(), dofs.data(), dofs.size(), DK.data(), invalid_v<size_type>, invalid_v<size_type> );
             V(0_c).addVector( dofs.data(), dofs.size(), DKF.data(), invalid_v<size_type>, invalid_v<size_type> );
-            toc("sc.condense.globalassembly", FLAGS_v>1);
-
+            continue;
         }
-        else
-        {
-            A22 = local_matrix_t::Zero(N4,N4);
-            A20 = local_matrix_t::Zero(N4,N0);
-            A21 = local_matrix_t::Zero(N4,N1);
-            A34 = local_matrix_t::Zero(N42,N43);
-            A43 = local_matrix_t::Zero(N43,N42);
-            A44 = local_matrix_t::Zero(N43,N43);
-            CK = local_matrix_t::Zero(N4,N);
-            FK = local_vector_t::Zero(N);
-            F2 = local_vector_t::Zero(N4);
-            F4 = local_vector_t::Zero(N43);
-            BK3 = local_matrix_t::Zero(N, N4);
-            
-            auto const& A30K = Adyn( 3+dK.spaceIndex(), 0 );
-            auto const& A31K = Adyn( 3+dK.spaceIndex(), 1 );
-            auto const& A03K = Adyn( 0, 3+dK.spaceIndex() );
-            auto const& A13K = Adyn( 1, 3+dK.spaceIndex() );
-            auto const& A33K = Adyn( 3+dK.spaceIndex(), 3+dK.spaceIndex() );
-            auto const& F3K = Fdyn( 3+dK.spaceIndex() );
-
-            auto const& A34K = Adyn( 3+dK.spaceIndex(), 3+index_not_ibc );
-            auto const& A43K = Adyn( 3+index_not_ibc, 3+dK.spaceIndex() );
-            auto const& A44K = Adyn( 3+index_not_ibc, 3+index_not_ibc );
-            auto const& F4K = Fdyn( 3+index_not_ibc );
-            int n = 0;
-            std::for_each( dK.faces1().begin(), dK.faces1().end(), [&]( auto dKi )
-                           {
-                               //std::cout << "face1 key.first=" << key.first << " dKi=" << dKi << std::endl;
-                               auto key2 = std::make_pair(key.first, dKi );
-                               auto key3 = std::make_pair(dKi,key.first);
-                               auto key4 = std::make_pair(dKi, dKi);
-
-                               DVLOG(2) << "A02.count(" << key2 << ")"  << A02K.count(key2);
-                               DVLOG(2) << "A20.count(" << key3 << ")"  << A20K.count(key3);
-                               DVLOG(2) << "A12.count(" << key2 << ")"  << A12K.count(key2);
-                               DVLOG(2) << "A21.count(" << key3 << ")"  << A21K.count(key3);
-                               DVLOG(2) << "A22.count(" << key4 << ")"  << A22K.count(key4);
-                               DVLOG(2) << "F2.count(" << dKi << ")"  << F2K.count(dKi);
-
-                               extractBlock( A02K, key2, A20K, key3, BK3, CK, n, e1, e3 );
-                               //std::cout << "a CK=" << CK << std::endl;
-                               if ( A12K.count(key2) )
-                                   BK3.block(N0,n*N2, N1, N2 ) = A12K.at(key2);
-
-                               if ( A21K.count(key3) )
-                                   CK.block(n*N2, N0, N2, N1 ) = A21K.at(key3);
-                               //std::cout << "d CK=" << CK << std::endl;
-                               if ( A22K.count(key4) )
-                                   A22.block(n*N2, n*N2, N2, N2 ) = A22K.at(key4);
-
-                               if ( F2K.count(dKi) )
-                               {
-                                   F2.segment(n*N2,N2)=F2K.at(dKi);
-                               }
 
-                               ++n;
-                           } );
-            if ( VLOG_IS_ON(2) )
-            {
-                cout<< "A22=" << A22 << std::endl;
-                cout<< "BK3=" << BK3 << std::endl;
-                cout<< "CK=" << CK << std::endl;
-                cout<< "CK.T=" << CK.transpose() << std::endl;
-                cout<< "FK=" << FK << std::endl;
-                cout<< "F2=" << F2 << std::endl;
-                std::cout << "AK=" << AK << std::endl;
-            }
-            int n2 = 0;
-            std::for_each( dK.faces2().begin(), dK.faces2().end(), [&]( auto dKi )
-                           {
-                               // std::cout << "face2 key.first=" << key.first << " dKi=" << dKi << std::endl;
-                               auto key2 = std::make_pair(key.first, dKi );
-                               auto key3 = std::make_pair(dKi,key.first);
-                               auto key4 = std::make_pair(dKi, dKi);
-
-                               DVLOG(2) << "A03.count(" << key2 << ")"  << A02K.count(key2);
-                               DVLOG(2) << "A30.count(" << key3 << ")"  << A20K.count(key3);
-                               DVLOG(2) << "A13.count(" << key2 << ")"  << A12K.count(key2);
-                               DVLOG(2) << "A31.count(" << key3 << ")"  << A21K.count(key3);
-                               DVLOG(2) << "A33.count(" << key4 << ")"  << A22K.count(key4);
-                               DVLOG(2) << "F3.count(" << dKi << ")"  << F3K.count(dKi);
-
-                               //std::cout << "d BK=" << BK3 << std::endl;
-                               extractBlock( A03K, key2, A30K, key3, BK3, CK, n2, e1, e(3_c,index), n*e3.dof()->nLocalDof() );
-                               //std::cout << "e CK=" << CK << std::endl;
-                               //std::cout << "e BK=" << BK3 << std::endl;
-                               if ( A13K.count(key2) )
-                                   BK3.block(N0,n*N2+n2*N42, N1, N42 ) = A13K.at(key2);
-                               //std::cout << "g BK=" << BK3 << std::endl;
-                               if ( A31K.count(key3) )
-                                   CK.block(n*N2+n2*N42, N0, N42, N1 ) = A31K.at(key3);
-                               //std::cout << "f CK=" << CK << std::endl;
-                               if ( A33K.count(key4) )
-                                   A22.block(n*N2+n2*N42, n*N2, N42, N42 ) = A33K.at(key4);
-                               if ( other_than_ibc_space )
-                               {
-                                   if ( A34K.count( key4 ) )
-                                       A34 = A34K.at(key4);
-                                   if ( A43K.count( key4 ) )
-                                       A43 = A43K.at(key4);
-                                   if ( A44K.count( key4 ) )
-                                       A44 = A44K.at(key4);
-                                   if ( F4K.count( dKi ) )
-                                       F4 = F4K.at( dKi );
-                                   //Feel::cout << "A43:" << A43 << std::endl;
-                                   //Feel::cout << "A34:" << A34 << std::endl;
-                                   //Feel::cout << "A44:" << A44 << std::endl;
-                                   //Feel::cout << "F4:" << F4 << std::endl;
-                               }
-                               if ( F3K.count(dKi) )
-                               {
-                                   F2.segment(n*N2+n2*N42,N42)=F3K.at(dKi);
-                               }
+        auto dofs1 = e3.dofs(dK.faces1(),S.matrixPtr()->mapRow(),0);
+        auto dofs2 = e(3_c,dK.spaceIndex()).dofs(dK.faces2(),S.matrixPtr()->mapRow(),1);
 
-                               ++n2;
-                           } );
-            extractBlock( F0K, K, FK, e1 );
-            FK.tail(N1) = F1K.at(K);
-            if ( VLOG_IS_ON(2) )
-            {
-                cout<< "A22=" << A22 << std::endl;
-                cout<< "BK3=" << BK3 << std::endl;
-                cout<< "CK=" << CK << std::endl;
-                cout<< "CK.T=" << CK.transpose() << std::endl;
-                cout<< "FK=" << FK << std::endl;
-                cout<< "F2=" << F2 << std::endl;
-                std::cout << "AK=" << AK << std::endl;
-            }
+        local_matrix_t DK00( DK.block( 0, 0, N41, N41 ) );
+        local_matrix_t DK01( DK.block( 0, N41, N41, N42 ) );
+        local_matrix_t DK10( DK.block( N41, 0, N42, N41 ) );
+        local_matrix_t DK11( DK.block( N41, N41, N42, N42 ) );
+        local_vector_t DKF1( DKF.head( N41 ) );
+        local_vector_t DKF2( DKF.segment( N41, N42 ) );
 
+        S(0_c,0_c).addMatrix( dofs1.data(), dofs1.size(), dofs1.data(), dofs1.size(), DK00.data(), invalid_v<size_type>, invalid_v<size_type> );
+        S(0_c,1_c,0,dK.spaceIndex()).addMatrix( dofs1.data(), dofs1.size(), dofs2.data(), dofs2.size(), DK01.data(), invalid_v<size_type>, invalid_v<size_type> );
+        S(1_c,0_c,dK.spaceIndex(),0).addMatrix( dofs2.data(), dofs2.size(), dofs1.data(), dofs1.size(), DK10.data(), invalid_v<size_type>, invalid_v<size_type> );
+        S(1_c,1_c,dK.spaceIndex(),dK.spaceIndex()).addMatrix( dofs2.data(), dofs2.size(), dofs2.data(), dofs2.size(), DK11.data(), invalid_v<size_type>, invalid_v<size_type> );
+        V(0_c).addVector( dofs1.data(), dofs1.size(), DKF1.data(), invalid_v<size_type>, invalid_v<size_type> );
+        V(1_c,dK.spaceIndex()).addVector( dofs2.data(), dofs2.size(), DKF2.data(), invalid_v<size_type>, invalid_v<size_type> );
 
-            auto Aldlt = AK.lu();
-
-#if 0
-            local_vector_t pK(N4);
-            pK=local_vector_t::Constant(N4,1);
-            Eigen::VectorXd upK( N0 + N1 );
-            upK.segment(0,N0)=local_vector_t::Zero(N0);
-            upK.segment(N0,N1)=local_vector_t::Constant(N1,1.);
-            
-            std::cout << "AK*U=" << AK*upK << std::endl;
-            std::cout << "BK*K=" << BK3*pK << std::endl;
-            std::cout << "FK=" << FK << std::endl;
-#endif
-            auto AinvB = Aldlt.solve( BK3 );
-            auto AinvF = Aldlt.solve( FK );
-
-            // local assemble DK and DKF
-            DK3=-CK*AinvB+A22 ;
-            DKF3=-CK*AinvF+F2;
-
-#if 0
-            std::cout << "DK3 = " << DK3 << std::endl;
-            std::cout << "DKF3 = " << DKF3 << std::endl;
-            std::cout << "DK3*pK=" << DK3*pK << std::endl;
-
-            std::cout << "AinvB = " << AinvB << std::endl;
-            std::cout << "AinvF = " << AinvF << std::endl;
-            auto Dldlt = DK3.lu();
-            auto p  = Dldlt.solve( DKF3);
-            std::cout << "pdK=" << p  << std::endl;
-            std::cout << "uK = " << -AinvB*p + AinvF << std::endl;
-#endif            
-            M_AinvB.emplace( K, AinvB );
-            M_AinvF.emplace( K, AinvF );
-            toc("sc.condense.localassembly", FLAGS_v>1);
-            tic();
-            auto dofs1 = e3.dofs(dK.faces1(),S.matrixPtr()->mapRow(),0);
-
-            auto dofs2 = e(3_c,dK.spaceIndex()).dofs(dK.faces2(),S.matrixPtr()->mapRow(),1);
-
-            local_matrix_t DK00( DK3.block( 0, 0, N41, N41 ) );
-            local_matrix_t DK01( DK3.block( 0, N41, N41, N42 ) );
-            local_matrix_t DK10( DK3.block( N41, 0, N42, N41 ) );
-            local_matrix_t DK11( DK3.block( N41, N41, N42, N42 ) );
-            local_vector_t DKF1( DKF3.head( N41 ) );
-            local_vector_t DKF2( DKF3.segment( N41, N42 ) );
-            
-            S(0_c,0_c).addMatrix( dofs1.data(), dofs1.size(), dofs1.data(), dofs1.size(), DK00.data(), invalid_v<size_type>, invalid_v<size_type> );
-            //S.matrixPtr()->printMatlab("S1.m");
-            S(0_c,1_c,0,dK.spaceIndex()).addMatrix( dofs1.data(), dofs1.size(), dofs2.data(), dofs2.size(), DK01.data(), invalid_v<size_type>, invalid_v<size_type> );
-            //S.matrixPtr()->printMatlab("S2.m");
-            S(1_c,0_c,dK.spaceIndex(),0).addMatrix( dofs2.data(), dofs2.size(), dofs1.data(), dofs1.size(), DK10.data(), invalid_v<size_type>, invalid_v<size_type> );
-            //S.matrixPtr()->printMatlab("S3.m");
-            S(1_c,1_c,dK.spaceIndex(),dK.spaceIndex()).addMatrix( dofs2.data(), dofs2.size(), dofs2.data(), dofs2.size(), DK11.data(), invalid_v<size_type>, invalid_v<size_type> );
-            
-            //S.matrixPtr()->printMatlab("S4.m");
-            V(0_c).addVector( dofs1.data(), dofs1.size(), DKF1.data(), invalid_v<size_type>, invalid_v<size_type> );
-            //V.vectorPtr()->printMatlab("g1.m");
-            V(1_c,dK.spaceIndex()).addVector( dofs2.data(), dofs2.size(), DKF2.data(), invalid_v<size_type>, invalid_v<size_type> );
-
-            //Feel::cout << " -- index_not_ibc: " << index_not_ibc << std::endl;
-            if ( other_than_ibc_space && has_ibc_coupling ) //index_not_ibc != invalid_v<uint16_type> )
+        if ( other_than_ibc_space && info.has_ibc_coupling )
+        {
+            // coupling between the ibc space and the other space, not condensed
+            uint16_type index_not_ibc = info.index_not_ibc;
+            auto const& A34K = *A33Ks[dK.spaceIndex()][index_not_ibc];
+            auto const& A43K = *A33Ks[index_not_ibc][dK.spaceIndex()];
+            auto const& A44K = *A33Ks[index_not_ibc][index_not_ibc];
+            auto const& F4K = *F3Ks[index_not_ibc];
+            A34.setZero();
+            A43.setZero();
+            A44.setZero();
+            F4.setZero();
+            for( auto dKi : dK.faces2() )
             {
-                auto dofs3 = e(3_c,index_not_ibc).dofs(dK.faces2(),S.matrixPtr()->mapRow(),2);
-                S(1_c,1_c,dK.spaceIndex(),index_not_ibc).addMatrix( dofs2.data(), dofs2.size(), dofs3.data(), dofs3.size(), A34.data(), invalid_v<size_type>, invalid_v<size_type> );
-                S(1_c,1_c,index_not_ibc,dK.spaceIndex()).addMatrix( dofs3.data(), dofs3.size(), dofs2.data(), dofs2.size(), A43.data(), invalid_v<size_type>, invalid_v<size_type> );
-                S(1_c,1_c,index_not_ibc,index_not_ibc).addMatrix( dofs3.data(), dofs3.size(), dofs3.data(), dofs3.size(), A44.data(), invalid_v<size_type>, invalid_v<size_type> );
-            
-                V(1_c,index_not_ibc).addVector( dofs3.data(), dofs3.size(), F4.data(), invalid_v<size_type>, invalid_v<size_type> );
-
+                auto key4 = std::make_pair(dKi, dKi);
+                if ( A34K.count( key4 ) )
+                    A34 = A34K.at(key4);
+                if ( A43K.count( key4 ) )
+                    A43 = A43K.at(key4);
+                if ( A44K.count( key4 ) )
+                    A44 = A44K.at(key4);
+                if ( F4K.count( dKi ) )
+                    F4 = F4K.at( dKi );
             }
-            
-            //condense2( dK, rhs, e, S, V );
-           //V.vectorPtr()->printMatlab("g2.m");
-            toc("sc.condense.globalassembly", FLAGS_v>1);
-
+            auto dofs3 = e(3_c,index_not_ibc).dofs(dK.faces2(),S.matrixPtr()->mapRow(),2);
+            S(1_c,1_c,dK.spaceIndex(),index_not_ibc).addMatrix( dofs2.data(), dofs2.size(), dofs3.data(), dofs3.size(), A34.data(), invalid_v<size_type>, invalid_v<size_type> );
+            S(1_c,1_c,index_not_ibc,dK.spaceIndex()).addMatrix( dofs3.data(), dofs3.size(), dofs2.data(), dofs2.size(), A43.data(), invalid_v<size_type>, invalid_v<size_type> );
+            S(1_c,1_c,index_not_ibc,index_not_ibc).addMatrix( dofs3.data(), dofs3.size(), dofs3.data(), dofs3.size(), A44.data(), invalid_v<size_type>, invalid_v<size_type> );
+            V(1_c,index_not_ibc).addVector( dofs3.data(), dofs3.size(), F4.data(), invalid_v<size_type>, invalid_v<size_type> );
         }
-
     }
+    toc("sc.condense.globalassembly",FLAGS_v>0);
     M_nnz = S.nnz();
 }
 template<typename T, typename IndexT>
@@ -1627,25 +1504,22 @@ struct LocalSolver
     using sc_t=StaticCondensation<value_t> ;
     using local_vector_t = typename sc_t::local_vector_t;
     using local_matrix_t = typename sc_t::local_matrix_t;
-    using ainvb_t = typename sc_t::ainvb_t;
-    using ainvb_const_iterator_t = typename sc_t::ainvb_const_iterator_t;
-    using ainvf_t = typename sc_t::ainvf_t;
+    using local_solves_t = typename sc_t::local_solves_t;
     
     using dk_t = typename sc_t::dk_t;
 
     template<typename Data_t>
-    LocalSolver( int _N0, int _N1, int _N2, E& _e, ainvb_t const& _AinvB, ainvf_t const& _AinvF, dk_t const& _dK, Data_t const& d )
+    LocalSolver( int _N0, int _N1, int _N2, E& _e, local_solves_t const& _Ainv, dk_t const& _dK, Data_t const& d )
         :
         N0(_N0),
         N1(_N1),
         N2(_N2),
         e(_e),
-        AinvB(_AinvB),
-        AinvF(_AinvF),
+        Ainv(_Ainv),
         dK(_dK),
-        grain(d.grain( AinvB.size() ) )
+        grain(d.grain( Ainv.size() ) )
         {}
-    void operator()( ainvb_const_iterator_t beg, ainvb_const_iterator_t end )
+    void operator()( std::size_t beg, std::size_t end )
         {
             // flux
             auto& e0 = e(0_c);
@@ -1659,15 +1533,15 @@ struct LocalSolver
             trace_interpolant_t pdK( N2 );
 
             // get the amount of work within task 
-            int len = std::distance( beg, end );
+            int len = end-beg;
             // do the local solve if amount of work not too much
             if ( len < grain )
             {
-                for( auto it= beg ;  it != end; ++it ) 
+                for( std::size_t k = beg; k < end; ++k )
                 {
-                    auto K = it->first;
-                    auto const& A = it->second;
-                    auto const& F = AinvF.at( K );
+                    auto K = Ainv.element( k );
+                    auto A = Ainv.AinvB( k );
+                    auto F = Ainv.AinvF( k );
 
                     e2.element( dK.at(K).faces1(), pdK );
                     upK.noalias() = -A*pdK + F;
@@ -1678,8 +1552,7 @@ struct LocalSolver
                 return;
             }
             // split in half if too much work and start new task until amount of work is ok
-            ainvb_const_iterator_t mid = beg;
-            std::advance(mid,len/2);
+            std::size_t mid = beg+len/2;
 #if 0
             handles.emplace_back( std::async( std::launch::async,
                                               &LocalSolver<E>::operator(), this, mid, end ) );
@@ -1694,8 +1567,7 @@ struct LocalSolver
 private:
     int N0,N1,N2;
     E& e;
-    ainvb_t const& AinvB;
-    ainvf_t const& AinvF;
+    local_solves_t const& Ainv;
     dk_t const& dK;
     std::vector<std::future<void>> handles;
     int grain;
@@ -1715,8 +1587,8 @@ StaticCondensation<T,IndexT>::localSolve( std::shared_ptr<StaticCondensation<T>>
     if ( M_localsolve.parallel ) 
     {
         tic();
-        LocalSolver<E,T> ls( N0, N1, N3, e, M_AinvB, M_AinvF, M_dK, M_localsolve );
-        ls( M_AinvB.cbegin(), M_AinvB.cend() );
+        LocalSolver<E,T> ls( N0, N1, N3, e, M_localSolves, M_dK, M_localsolve );
+        ls( 0, M_localSolves.size() );
         for( auto & f : ls.futures() )
             f.get();
         toc("sc.localsolve.parallel",FLAGS_v>0);
@@ -1776,8 +1648,8 @@ StaticCondensation<T,IndexT>::localSolve( std::shared_ptr<StaticCondensation<T>>
     if ( M_localsolve.parallel ) 
     {
         tic();
-        LocalSolver<E,T> ls( N0, N1, N3, e, M_AinvB, M_AinvF, M_dK, M_localsolve );
-        ls( M_AinvB.cbegin(), M_AinvB.cend() );
+        LocalSolver<E,T> ls( N0, N1, N3, e, M_localSolves, M_dK, M_localsolve );
+        ls( 0, M_localSolves.size() );
         for( auto & f : ls.futures() )
             f.get();
         toc("sc.localsolve.parallel",FLAGS_v>0);
@@ -1789,13 +1661,13 @@ StaticCondensation<T,IndexT>::localSolve( std::shared_ptr<StaticCondensation<T>>
         Eigen::VectorXd upK( N0+N1 );
         trace_interpolant_t pdK( N3 );
 
-        for( auto const& e : M_AinvB )
+        for( std::size_t k = 0; k < M_localSolves.size(); ++k )
         {
             auto f = [&,this]()
                 {
-                    auto K = e.first;
-                    auto const& A = e.second;
-                    auto const& F = M_AinvF.at( K );
+                    auto K = M_localSolves.element( k );
+                    auto A = M_localSolves.AinvB( k );
+                    auto F = M_localSolves.AinvF( k );
                     e3.element( M_dK[K].faces1(), pdK );
                     upK.noalias() = -A*pdK + F;
 
@@ -1832,16 +1704,16 @@ StaticCondensation<T,IndexT>::localSolve( std::shared_ptr<StaticCondensation<T>>
     int N3 = N2*e1.mesh()->numLocalTopologicalFaces();
     using trace_interpolant_t  = typename std::decay_t<decltype(e(2_c))>::local_interpolant_type;
     std::vector<std::future<void>> futs;
-    futs.reserve( M_AinvB.size() );
-    for( auto const& m : M_AinvB )
+    futs.reserve( M_localSolves.size() );
+    for( std::size_t k = 0; k < M_localSolves.size(); ++k )
     {
-        //f(m);
+        //f(k);
 
-        auto f = [N0,N1,N4d1,N4d11,N4,&m,this,&e,&e1,&e2,&e3](  )
+        auto f = [N0,N1,N4d1,N4d11,N4,k,this,&e,&e1,&e2,&e3](  )
             {
-                auto K = m.first;
-                auto const& A = m.second;
-                auto const& F = M_AinvF.at( K );
+                auto K = M_localSolves.element( k );
+                auto A = M_localSolves.AinvB( k );
+                auto F = M_localSolves.AinvF( k );
                 Eigen::VectorXd upK( N0 + N1 );
                 auto & dK = M_dK[K];
                 if ( dK.hasSameTrace() )
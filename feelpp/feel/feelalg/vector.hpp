@@ -41,6 +41,7 @@
 #include <feel/feelcore/traits.hpp>
 
 #include <feel/feelalg/datamap.hpp>
+#include <feel/feelalg/concurrentinsertionbuffer.hpp>
 
 namespace Feel
 {
@@ -452,6 +453,37 @@ public:
      */
     virtual void addVector ( int* i, int n, value_type* v, size_type K, size_type K2 ) = 0;
 
+    /**
+     * prepare the concurrent insertion of element contributions : until
+     * endConcurrentInsertion(), addVectorConcurrent() can be called by
+     * several threads as long as they never add into the same entry.
+     * \return false if the storage does not allow an insertion in place,
+     * addVectorConcurrent() keeps then all the entries in the buffers
+     */
+    virtual bool beginConcurrentInsertion() { return false; }
+
+    /**
+     * v([i1,i2,...,in]) += [value1,...,valuen] in place for the entries owned
+     * by the process, the other entries are kept in \p buffer and added by
+     * addConcurrentInsertionBuffer() after endConcurrentInsertion()
+     */
+    virtual void addVectorConcurrent( int* i, int n, value_type* v, ConcurrentInsertionBuffer<value_type>& buffer )
+    {
+        for ( int k = 0; k < n; ++k )
+            buffer.addEntry( i[k], v[k] );
+    }
+
+    //! end the concurrent insertion started by beginConcurrentInsertion()
+    virtual void endConcurrentInsertion() {}
+
+    //! add the entries kept in \p buffer and clear it
+    void addConcurrentInsertionBuffer( ConcurrentInsertionBuffer<value_type>& buffer )
+    {
+        if ( !buffer.empty() )
+            this->addVector( buffer.rows(), buffer.size(), buffer.values(), 0, invalid_v<size_type> );
+        buffer.clear();
+    }
+
     /**
      * \f$U(0-DIM)+=s\f$.
      * Addition of \p s to all components. Note
@@ -187,6 +187,55 @@ VectorPetsc<T>::addVector ( int* i, int n, value_type* v, size_type K, size_type
     ierr = VecSetValues ( M_vec, n, i, v, ADD_VALUES );
     CHKERRABORT( this->comm(),ierr );
 }
+
+template <typename T>
+bool
+VectorPetsc<T>::beginConcurrentInsertion()
+{
+    CHECK( !M_concurrentArray ) << "concurrent insertion already started";
+    if ( !this->isInitialized() )
+        return false;
+    int ierr = VecGetOwnershipRange( M_vec, &M_concurrentStart, &M_concurrentEnd );
+    CHKERRABORT( this->comm(),ierr );
+    ierr = VecGetArray( M_vec, &M_concurrentArray );
+    CHKERRABORT( this->comm(),ierr );
+    M_concurrentMap = nullptr;
+    return true;
+}
+
+template <typename T>
+void
+VectorPetsc<T>::addVectorConcurrent( int* i, int n, value_type* v, ConcurrentInsertionBuffer<value_type>& buffer )
+{
+    if ( !M_concurrentArray )
+    {
+        super::addVectorConcurrent( i, n, v, buffer );
+        return;
+    }
+    for ( int k = 0; k < n; ++k )
+    {
+        // negative indices are ignored (as in VecSetValues)
+        if ( i[k] < 0 )
+            continue;
+        PetscInt g = M_concurrentMap? M_concurrentMap[i[k]] : i[k];
+        if ( g >= M_concurrentStart && g < M_concurrentEnd )
+            M_concurrentArray[g-M_concurrentStart] += v[k];
+        else
+            buffer.addEntry( i[k], v[k] );
+    }
+}
+
+template <typename T>
+void
+VectorPetsc<T>::endConcurrentInsertion()
+{
+    if ( !M_concurrentArray )
+        return;
+    int ierr = VecRestoreArray( M_vec, &M_concurrentArray );
+    CHKERRABORT( this->comm(),ierr );
+    M_concurrentArray = nullptr;
+    M_concurrentMap = nullptr;
+}
 template <typename T>
 typename VectorPetsc<T>::value_type
 VectorPetsc<T>::operator() ( const size_type i ) const
@@ -1392,6 +1441,17 @@ VectorPetscMPI<T>::addVector ( int* i, int n, value_type* v, size_type K, size_t
     CHKERRABORT( this->comm(),ierr );
 }
 
+template <typename T>
+bool
+VectorPetscMPI<T>::beginConcurrentInsertion()
+{
+    if ( !super::beginConcurrentInsertion() )
+        return false;
+    // the element contributions are given with process indices (VecSetValuesLocal)
+    this->M_concurrentMap = this->map().mapGlobalProcessToGlobalCluster().data();
+    return true;
+}
+
 //----------------------------------------------------------------------------------------------------//
 
 template <typename T>
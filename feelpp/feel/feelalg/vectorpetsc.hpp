@@ -506,6 +506,15 @@ public:
      */
     void addVector( int* i, int n, value_type* v, size_type K = 0, size_type K2 = invalid_v<size_type> ) override;
 
+    /**
+     * concurrent insertion in the local array of the vector : the entries
+     * owned by the process are added in place, one thread by entry, without
+     * going through VecSetValues
+     */
+    bool beginConcurrentInsertion() override;
+    void addVectorConcurrent( int* i, int n, value_type* v, ConcurrentInsertionBuffer<value_type>& buffer ) override;
+    void endConcurrentInsertion() override;
+
     /**
      * \f$ U+=v \f$ where \p v is a std::vector<T>
      * and you
@@ -825,6 +834,12 @@ protected:
      * for the constructor which takes a PETSc Vec object.
      */
     bool M_destroy_vec_on_exit;
+
+    //! local array written in place by addVectorConcurrent()
+    PetscScalar* M_concurrentArray = nullptr;
+    PetscInt M_concurrentStart = 0, M_concurrentEnd = 0;
+    //! global indices of the process indices given to addVector (null when the indices are already global)
+    const size_type* M_concurrentMap = nullptr;
 };
 
 
@@ -923,6 +938,9 @@ public:
      */
     void addVector( int* i, int n, value_type* v, size_type K = 0, size_type K2 = invalid_v<size_type> ) override;
 
+    //! same as VectorPetsc, the indices are global process indices
+    bool beginConcurrentInsertion() override;
+
     /**
      *  \f$v = x*y\f$: coefficient-wise multiplication
      */
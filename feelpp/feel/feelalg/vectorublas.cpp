@@ -25,6 +25,9 @@
 
 #include <feel/feelalg/vectorublas.hpp>
 #include <feel/feelcore/hdf5.hpp>
+#include <feel/feelcore/hashtables.hpp>
+#include <unordered_map>
+#include <unordered_set>
 
 #define FEELPP_INSTANTIATE_VECTORUBLAS 1
 
@@ -620,6 +623,207 @@ void VectorUblasBase<T>::loadHDF5( const std::string & filename, const std::stri
     }
     sync( *this );
 }
+
+namespace
+{
+//! process which stores the directory entry of a dof key (the same on all processes)
+rank_type
+dofKeyDirectoryProcess( std::uint64_t const* key, int keySize, rank_type nProc )
+{
+    return rank_type( boost::hash_range( key, key+keySize ) % nProc );
+}
+
+using dof_key_type = std::vector<std::uint64_t>;
+}
+
+template< typename T >
+void VectorUblasBase<T>::saveHDF5WithKeys( const std::string & filename, std::vector<std::uint64_t> const& dofKeys, int keySize, const std::string & tableName ) const
+{
+    bool useTransposedStorage = true;
+    const int dimsComp0 = (useTransposedStorage)? 1 : 0;
+    const int dimsComp1 = (useTransposedStorage)? 0 : 1;
+    DataMap<> const& dm = this->map();
+    auto const& comm = this->comm().localComm();
+    rank_type nProc = this->comm().localSize();
+    size_type nLocalDof = dm.nLocalDofWithoutGhost();
+    CHECK( keySize > 0 ) << "invalid key size : " << keySize;
+    CHECK( dofKeys.size() >= nLocalDof*keySize ) << "invalid number of dof keys : " << dofKeys.size() << " vs " << nLocalDof*keySize;
+
+    // the keys must identify the dofs : each key is sent to its directory process which checks that it is unique
+    std::vector<std::vector<std::uint64_t>> keysToSend( nProc ), keysRecv;
+    for ( size_type k=0;k<nLocalDof;++k )
+    {
+        std::uint64_t const* key = dofKeys.data() + k*keySize;
+        auto & keysOnProc = keysToSend[dofKeyDirectoryProcess( key, keySize, nProc )];
+        keysOnProc.insert( keysOnProc.end(), key, key+keySize );
+    }
+    mpi::all_to_all( comm, keysToSend, keysRecv );
+    std::unordered_set<dof_key_type,Feel::HashTables::HasherContainers<std::uint64_t>> keysInDirectory;
+    for ( auto const& keysFromProc : keysRecv )
+    {
+        for ( size_type k=0;k<keysFromProc.size();k+=keySize )
+        {
+            bool isNewKey = keysInDirectory.emplace( keysFromProc.begin()+k, keysFromProc.begin()+k+keySize ).second;
+            CHECK( isNewKey ) << "the dof keys are not unique, the table " << tableName << " can not be saved in " << filename;
+        }
+    }
+
+    hsize_t dimsElt[2];
+    dimsElt[dimsComp0] = dm.nDof();
+    dimsElt[dimsComp1] = 1;
+
+    hsize_t dimsElt2[2];
+    dimsElt2[dimsComp0] = nLocalDof;
+    dimsElt2[dimsComp1] = 1;
+    hsize_t offsetElt[2];
+    size_type offsetCount = 0;
+    for (rank_type p=0 ; p < this->comm().localRank() ; ++p )
+        offsetCount += dm.nLocalDofWithoutGhost( p );
+
+    offsetElt[dimsComp0] = offsetCount;
+    offsetElt[dimsComp1] = 0;
+
+    // the keys table is stored row by row (one row of keySize words by dof)
+    hsize_t dimsKeys[2] = { dm.nDof(), hsize_t( keySize ) };
+    hsize_t dimsKeys2[2] = { nLocalDof, hsize_t( keySize ) };
+    hsize_t offsetKeys[2] = { offsetCount, 0 };
+
+    std::vector<double> dataStorage( nLocalDof );
+    for ( size_type k=0;k<nLocalDof;++k )
+        dataStorage[k] = this->operator()( k );
+
+    // the writes are collective : the processes without dof write an empty block
+    std::uint64_t uselessKey = 0;
+    double uselessValue = 0;
+
+    HDF5 hdf5;
+    hdf5.openFile( filename, comm, false );
+
+    std::string keysTableName = tableName + "_dofkeys";
+    hdf5.createTable( keysTableName, H5T_NATIVE_UINT64, dimsKeys, 2, true );
+    hdf5.write( keysTableName, H5T_NATIVE_UINT64, dimsKeys2, offsetKeys, ( nLocalDof > 0 )? dofKeys.data() : &uselessKey );
+    hdf5.closeTable( keysTableName );
+
+    hdf5.createTable( tableName, H5T_NATIVE_DOUBLE, dimsElt, 2, true );
+    hdf5.write( tableName, H5T_NATIVE_DOUBLE, dimsElt2, offsetElt, ( nLocalDof > 0 )? dataStorage.data() : &uselessValue );
+    hdf5.closeTable( tableName );
+
+    hdf5.closeFile();
+}
+
+template< typename T >
+void VectorUblasBase<T>::loadHDF5WithKeys( const std::string & filename, std::vector<std::uint64_t> const& dofKeys, int keySize, const std::string & tableName )
+{
+    bool useTransposedStorage = true;
+    const int dimsComp0 = (useTransposedStorage)? 1 : 0;
+    const int dimsComp1 = (useTransposedStorage)? 0 : 1;
+    DataMap<> const& dm = this->map();
+    if ( dm.nDof() == 0 )
+        return;
+
+    auto const& comm = this->comm().localComm();
+    rank_type nProc = this->comm().localSize();
+    rank_type rank = this->comm().localRank();
+    size_type nLocalDof = dm.nLocalDofWithoutGhost();
+    CHECK( keySize > 0 ) << "invalid key size : " << keySize;
+    CHECK( dofKeys.size() >= nLocalDof*keySize ) << "invalid number of dof keys : " << dofKeys.size() << " vs " << nLocalDof*keySize;
+
+    HDF5 hdf5;
+    hdf5.openFile( filename, comm, true );
+
+    std::string keysTableName = tableName + "_dofkeys";
+    hsize_t dimsGlob[2];
+    hdf5.openTable( keysTableName, dimsGlob );
+    CHECK( dimsGlob[0] == dm.nDof() ) << "invalid table dimension";
+    CHECK( dimsGlob[1] == hsize_t( keySize ) ) << "invalid key size in " << filename << " : " << dimsGlob[1] << " vs " << keySize;
+
+    // each process reads a contiguous block of the tables (the reads are collective)
+    size_type nDofInFile = dimsGlob[0];
+    size_type blockBegin = ( nDofInFile*rank )/nProc;
+    size_type blockSize = ( nDofInFile*(rank+1) )/nProc - blockBegin;
+    hsize_t dimsKeysBlock[2] = { blockSize, hsize_t( keySize ) };
+    hsize_t offsetKeysBlock[2] = { blockBegin, 0 };
+    hsize_t dimsBlock[2];
+    dimsBlock[dimsComp0] = blockSize;
+    dimsBlock[dimsComp1] = 1;
+    hsize_t offsetBlock[2];
+    offsetBlock[dimsComp0] = blockBegin;
+    offsetBlock[dimsComp1] = 0;
+
+    std::vector<std::uint64_t> keysRead( blockSize*keySize );
+    std::vector<double> valuesRead( blockSize );
+    std::uint64_t uselessKey = 0;
+    double uselessValue = 0;
+
+    hdf5.read( keysTableName, H5T_NATIVE_UINT64, dimsKeysBlock, offsetKeysBlock, ( blockSize > 0 )? keysRead.data() : &uselessKey );
+    hdf5.closeTable( keysTableName );
+
+    hdf5.openTable( tableName, dimsGlob );
+    CHECK( dimsGlob[dimsComp0] == nDofInFile ) << "invalid table dimension";
+    hdf5.read( tableName, H5T_NATIVE_DOUBLE, dimsBlock, offsetBlock, ( blockSize > 0 )? valuesRead.data() : &uselessValue );
+    hdf5.closeTable( tableName );
+
+    hdf5.closeFile();
+
+    // the values read are sent to the directory process of their key
+    std::vector<std::vector<std::uint64_t>> keysToSend( nProc ), keysRecv;
+    std::vector<std::vector<double>> valuesToSend( nProc ), valuesRecv;
+    for ( size_type k=0;k<blockSize;++k )
+    {
+        std::uint64_t const* key = keysRead.data() + k*keySize;
+        rank_type pid = dofKeyDirectoryProcess( key, keySize, nProc );
+        keysToSend[pid].insert( keysToSend[pid].end(), key, key+keySize );
+        valuesToSend[pid].push_back( valuesRead[k] );
+    }
+    mpi::all_to_all( comm, keysToSend, keysRecv );
+    mpi::all_to_all( comm, valuesToSend, valuesRecv );
+
+    std::unordered_map<dof_key_type,double,Feel::HashTables::HasherContainers<std::uint64_t>> directory;
+    for ( rank_type p=0;p<nProc;++p )
+    {
+        for ( size_type k=0;k<valuesRecv[p].size();++k )
+        {
+            bool isNewKey = directory.emplace( dof_key_type( keysRecv[p].begin()+k*keySize, keysRecv[p].begin()+(k+1)*keySize ), valuesRecv[p][k] ).second;
+            CHECK( isNewKey ) << "the dof keys stored in " << filename << " are not unique";
+        }
+    }
+
+    // ask the directory the values of the active dofs
+    std::vector<rank_type> directoryProcesses( nLocalDof );
+    for ( rank_type p=0;p<nProc;++p )
+        keysToSend[p].clear();
+    for ( size_type k=0;k<nLocalDof;++k )
+    {
+        std::uint64_t const* key = dofKeys.data() + k*keySize;
+        rank_type pid = dofKeyDirectoryProcess( key, keySize, nProc );
+        directoryProcesses[k] = pid;
+        keysToSend[pid].insert( keysToSend[pid].end(), key, key+keySize );
+    }
+    mpi::all_to_all( comm, keysToSend, keysRecv );
+
+    dof_key_type keySearched( keySize );
+    for ( rank_type p=0;p<nProc;++p )
+    {
+        size_type nKeysRecv = keysRecv[p].size()/keySize;
+        valuesToSend[p].resize( nKeysRecv );
+        for ( size_type k=0;k<nKeysRecv;++k )
+        {
+            std::copy( keysRecv[p].begin()+k*keySize, keysRecv[p].begin()+(k+1)*keySize, keySearched.begin() );
+            auto itFind = directory.find( keySearched );
+            CHECK( itFind != directory.end() ) << "dof key not found in " << filename;
+            valuesToSend[p][k] = itFind->second;
+        }
+    }
+    mpi::all_to_all( comm, valuesToSend, valuesRecv );
+
+    std::vector<size_type> nValuesUsed( nProc, 0 );
+    for ( size_type k=0;k<nLocalDof;++k )
+    {
+        rank_type pid = directoryProcesses[k];
+        this->set( k, valuesRecv[pid][nValuesUsed[pid]++] );
+    }
+    sync( *this );
+}
 #endif
 
 template< typename T >
@@ -278,6 +278,10 @@ class FEELPP_EXPORT VectorUblas : public Vector<T>
         void loadHDF5( const std::string & filename, const std::string & tableName = "element" ) { return M_vectorImpl->loadHDF5( filename, tableName ); }
         FEELPP_DONT_INLINE
         void loadHDF5( const std::string & filename, std::optional<std::vector<index_type>> const& mappingFromInput, const std::string & tableName = "element" ) { return M_vectorImpl->loadHDF5( filename, tableName, mappingFromInput ); }
+        FEELPP_DONT_INLINE
+        void saveHDF5WithKeys( const std::string & filename, std::vector<std::uint64_t> const& dofKeys, int keySize, const std::string & tableName = "element" ) const { return M_vectorImpl->saveHDF5WithKeys( filename, dofKeys, keySize, tableName ); }
+        FEELPP_DONT_INLINE
+        void loadHDF5WithKeys( const std::string & filename, std::vector<std::uint64_t> const& dofKeys, int keySize, const std::string & tableName = "element" ) { return M_vectorImpl->loadHDF5WithKeys( filename, dofKeys, keySize, tableName ); }
 #endif
 
         // Range and slice API
@@ -619,6 +623,18 @@ class FEELPP_EXPORT VectorUblasBase: public Vector<T>
 #ifdef FEELPP_HAS_HDF5
         void saveHDF5( const std::string & filename, const std::string & tableName = "element", bool appendMode = false ) const;
         void loadHDF5( const std::string & filename, const std::string & tableName = "element", std::optional<std::vector<index_type>> const& mappingFromInput = {} );
+        /**
+         * save the active dofs in one table written collectively, each value is stored
+         * with its key (the \p keySize words starting at \p dofKeys[k*keySize], an
+         * identification of the dof independent of the partition). The keys must be unique.
+         */
+        void saveHDF5WithKeys( const std::string & filename, std::vector<std::uint64_t> const& dofKeys, int keySize, const std::string & tableName = "element" ) const;
+        /**
+         * load a table written by saveHDF5WithKeys, the number of processes can be different :
+         * the file is read by contiguous blocks and the values are sent to the process
+         * which owns the dof with the same key
+         */
+        void loadHDF5WithKeys( const std::string & filename, std::vector<std::uint64_t> const& dofKeys, int keySize, const std::string & tableName = "element" );
 #endif
 
         // Localization (parallel global to one proc local)
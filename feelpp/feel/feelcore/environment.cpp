@@ -23,6 +23,7 @@
  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
 #include <cstdlib>
+#include <mutex>
 #include <pwd.h>
 #ifdef __cplusplus
 extern "C"
@@ -80,6 +81,7 @@ extern "C"
 #include <feel/feelcore/feelpetsc.hpp>
 #endif
 #include <feel/feelcore/timertable.hpp>
+#include <feel/feelcore/profiler.hpp>
 #include <feel/feelcore/utility.hpp>
 #include <feel/feeltiming/tic.hpp>
 #include <feel/options.hpp>
@@ -551,6 +553,9 @@ Environment::Environment( int argc, char** argv,
     S_informationObject = std::make_unique<JournalWatcher>( std::bind( &Environment::updateInformationObject, this, std::placeholders::_1 ), "Environment", "", false );
 
     S_timers = std::make_unique<TimerTable>();
+    Profiler::instance().setEnabled( boption(_name="profiler") );
+    Profiler::instance().setTraceEnabled( boption(_name="profiler.trace") );
+    Profiler::instance().setTraceMaxEvents( std::max( ioption(_name="profiler.trace.max-events"), 0 ) );
 
     boost::gregorian::date today = boost::gregorian::day_clock::local_day();
     tic();
@@ -723,6 +728,17 @@ Environment::~Environment()
     if ( boption( _name="display-stats" ) )
         Environment::saveTimers( true );
 
+    // the profiler files are relative to the application repository
+    auto profilerFilename = []( std::string const& name ) -> std::string
+        {
+            if ( name.empty() || fs::path( name ).is_absolute() )
+                return name;
+            return ( fs::path( Environment::appRepository() )/fs::path( name ) ).string();
+        };
+    Profiler::instance().finalize( Environment::worldComm(),
+                                   profilerFilename( soption(_name="profiler.summary.filename") ),
+                                   profilerFilename( soption(_name="profiler.trace.filename") ) );
+
     double t = toc("env",no_display);
     Table summary;
     summary.add_row( { S_about.appName() } );
@@ -2530,6 +2546,8 @@ Environment::addTimer( std::string const& msg,
                        std::pair<double,int> const& t,
                        std::string const& uiname = "" )
 {
+    static std::mutex timersMutex;
+    std::lock_guard<std::mutex> lock( timersMutex );
     S_timers->add( msg, t, uiname );
 }
 
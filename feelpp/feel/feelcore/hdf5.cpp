@@ -198,7 +198,8 @@ void Feel::HDF5::createTable ( const std::string& groupName,
 void Feel::HDF5::createTable( const std::string& tableName,
                               hid_t& fileDataType,
                               hsize_t tableDimensions[],
-                              unsigned int nbDims )
+                              unsigned int nbDims,
+                              bool useCollectiveTransfer )
 {
     tableHandle& currentTable = M_tableList[tableName];
 
@@ -214,7 +215,7 @@ void Feel::HDF5::createTable( const std::string& tableName,
 #endif
 #if defined( H5_HAVE_PARALLEL )
     currentTable.plist = H5Pcreate (H5P_DATASET_XFER);
-    H5Pset_dxpl_mpio (currentTable.plist, H5FD_MPIO_INDEPENDENT);
+    H5Pset_dxpl_mpio (currentTable.plist, (useCollectiveTransfer)? H5FD_MPIO_COLLECTIVE : H5FD_MPIO_INDEPENDENT);
 #endif    
 }
 
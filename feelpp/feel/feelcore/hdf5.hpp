@@ -170,11 +170,14 @@ public:
      * \param tableDimensions array of hsize_t of size nbDims which holds the
      *        dimensions of the table
      * \param nbDims the number of dimensions of the array to store 
+     * \param useCollectiveTransfer if true the writes in the table are collective
+     *        (all the processes must call write(), possibly with an empty block)
      */
     void createTable( const std::string& tableName,
                       hid_t& fileDataType,
                       hsize_t tableDimensions[],
-                      unsigned int nbDims = 2 );
+                      unsigned int nbDims = 2,
+                      bool useCollectiveTransfer = false );
 
     //! Create a new table
     /*!
@@ -349,6 +349,7 @@ using physic = NA::named_argument_t<struct physic_tag>;
 using quality = NA::named_argument_t<struct quality_tag>;
 using robust = NA::named_argument_t<struct robust_tag>;
 using ray = NA::named_argument_t<struct ray_tag>;
+using nthreads = NA::named_argument_t<struct nthreads_tag>;
 
 } // namespace na
 
@@ -664,6 +665,7 @@ inline constexpr auto& _selector = NA::identifier<na::selector>;
 inline constexpr auto& _quality = NA::identifier<na::quality>;
 inline constexpr auto& _robust = NA::identifier<na::robust>;
 inline constexpr auto& _ray = NA::identifier<na::ray>;
+inline constexpr auto& _nthreads = NA::identifier<na::nthreads>;
 
 } // Feel
 
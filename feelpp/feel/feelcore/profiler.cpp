@@ -0,0 +1,364 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*-
+
+ This file is part of the Feel++ library
+
+ Copyright (C) 2023 Feel++ Consortium
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <feel/feelcore/profiler.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <feel/feelcore/json.hpp>
+#include <feel/feelcore/table.hpp>
+#include <feel/feelcore/worldcomm.hpp>
+
+namespace Feel
+{
+
+struct Profiler::ThreadData
+{
+    struct Node
+    {
+        std::string name;
+        int parent = -1;
+        std::vector<int> children;
+        size_type count = 0;
+        double total = 0;
+        double min = std::numeric_limits<double>::max();
+        double max = 0;
+    };
+    struct Frame
+    {
+        int node;
+        clock_type::time_point start;
+    };
+    //! call of a region, the times are in microseconds since the start of the profiler
+    struct Event
+    {
+        int node;
+        double start;
+        double duration;
+    };
+
+    explicit ThreadData( int t ) : tid( t ) { this->clear(); }
+
+    void clear()
+        {
+            nodes.assign( 1, Node{} );
+            stack.clear();
+            events.clear();
+        }
+
+    int currentNode() const { return stack.empty()? 0 : stack.back().node; }
+
+    //! child \p name of \p parent, created if it does not exist
+    int child( int parent, std::string_view name )
+        {
+            for ( int c : nodes[parent].children )
+                if ( nodes[c].name == name )
+                    return c;
+            int c = nodes.size();
+            Node n;
+            n.name = std::string( name );
+            n.parent = parent;
+            nodes.push_back( std::move( n ) );
+            nodes[parent].children.push_back( c );
+            return c;
+        }
+
+    //! record a call of \p node
+    void record( int node, clock_type::time_point start, clock_type::time_point end,
+                 clock_type::time_point profilerStart, bool trace, size_type maxEvents )
+        {
+            double duration = std::chrono::duration<double>( end - start ).count();
+            auto& n = nodes[node];
+            ++n.count;
+            n.total += duration;
+            n.min = std::min( n.min, duration );
+            n.max = std::max( n.max, duration );
+            if ( trace && events.size() < maxEvents )
+                events.push_back( { node, std::chrono::duration<double,std::micro>( start - profilerStart ).count(), duration*1e6 } );
+        }
+
+    std::string path( int node ) const
+        {
+            std::string p = nodes[node].name;
+            for ( int n = nodes[node].parent; n > 0; n = nodes[n].parent )
+                p = nodes[n].name + "/" + p;
+            return p;
+        }
+
+    int tid;
+    std::vector<Node> nodes;
+    std::vector<Frame> stack;
+    std::vector<Event> events;
+};
+
+Profiler::Profiler()
+    :
+    M_enabled( false ),
+    M_traceEnabled( false ),
+    M_traceMaxEvents( 1000000 ),
+    M_start( clock_type::now() )
+{}
+
+Profiler&
+Profiler::instance()
+{
+    static Profiler p;
+    return p;
+}
+
+Profiler::ThreadData&
+Profiler::threadData()
+{
+    thread_local ThreadData* td = nullptr;
+    if ( !td )
+    {
+        std::lock_guard<std::mutex> lock( M_mutex );
+        M_threadData.push_back( std::make_unique<ThreadData>( M_threadData.size() ) );
+        td = M_threadData.back().get();
+    }
+    return *td;
+}
+
+void
+Profiler::enter( std::string_view name )
+{
+    auto& td = this->threadData();
+    int node = td.child( td.currentNode(), name );
+    td.stack.push_back( { node, clock_type::now() } );
+}
+
+void
+Profiler::leave()
+{
+    auto end = clock_type::now();
+    auto& td = this->threadData();
+    if ( td.stack.empty() )
+    {
+        LOG(WARNING) << "[Profiler] leave a region without entering it";
+        return;
+    }
+    auto frame = td.stack.back();
+    td.stack.pop_back();
+    td.record( frame.node, frame.start, end, M_start, M_traceEnabled, M_traceMaxEvents );
+}
+
+void
+Profiler::addRegion( std::string_view name, double duration )
+{
+    auto end = clock_type::now();
+    auto start = end - std::chrono::duration_cast<clock_type::duration>( std::chrono::duration<double>( duration ) );
+    auto& td = this->threadData();
+    int node = td.child( td.currentNode(), name );
+    td.record( node, start, end, M_start, M_traceEnabled, M_traceMaxEvents );
+}
+
+std::vector<Profiler::RegionStats>
+Profiler::localStats() const
+{
+    std::vector<RegionStats> res;
+    std::map<std::string,int> pathToIndex;
+    std::lock_guard<std::mutex> lock( M_mutex );
+    for ( auto const& td : M_threadData )
+    {
+        // depth-first traversal of the tree of the thread
+        std::vector<std::pair<int,int>> stack;
+        for ( auto it = td->nodes[0].children.rbegin(); it != td->nodes[0].children.rend(); ++it )
+            stack.push_back( { *it, 0 } );
+        while ( !stack.empty() )
+        {
+            auto [node,level] = stack.back();
+            stack.pop_back();
+            auto const& n = td->nodes[node];
+            for ( auto it = n.children.rbegin(); it != n.children.rend(); ++it )
+                stack.push_back( { *it, level+1 } );
+            if ( n.count == 0 )
+                continue;
+            std::string p = td->path( node );
+            auto [itPath,inserted] = pathToIndex.insert( { p, res.size() } );
+            if ( inserted )
+            {
+                RegionStats s;
+                s.path = p;
+                s.level = level;
+                s.min = n.min;
+                res.push_back( s );
+            }
+            auto& s = res[itPath->second];
+            s.count += n.count;
+            s.total += n.total;
+            s.min = std::min( s.min, n.min );
+            s.max = std::max( s.max, n.max );
+        }
+    }
+    return res;
+}
+
+std::vector<Profiler::ReducedRegionStats>
+Profiler::reducedStats( WorldComm const& comm ) const
+{
+    auto stats = this->localStats();
+    std::vector<std::string> paths;
+    std::vector<double> values;
+    for ( auto const& s : stats )
+    {
+        paths.push_back( s.path );
+        values.insert( values.end(), { (double)s.level, (double)s.count, s.total } );
+    }
+    std::vector<std::vector<std::string>> allPaths;
+    std::vector<std::vector<double>> allValues;
+    mpi::gather( comm, paths, allPaths, comm.masterRank() );
+    mpi::gather( comm, values, allValues, comm.masterRank() );
+
+    std::vector<ReducedRegionStats> res;
+    if ( comm.localRank() != comm.masterRank() )
+        return res;
+
+    // the ranks which have not entered a region count for 0 in the min and the mean
+    std::map<std::string,int> pathToIndex;
+    for ( int r = 0; r < (int)allPaths.size(); ++r )
+    {
+        for ( int k = 0; k < (int)allPaths[r].size(); ++k )
+        {
+            auto [itPath,inserted] = pathToIndex.insert( { allPaths[r][k], res.size() } );
+            if ( inserted )
+            {
+                ReducedRegionStats s;
+                s.path = allPaths[r][k];
+                s.level = allValues[r][3*k];
+                s.minTotal = std::numeric_limits<double>::max();
+                res.push_back( s );
+            }
+            auto& s = res[itPath->second];
+            double total = allValues[r][3*k+2];
+            ++s.nRanks;
+            s.count += allValues[r][3*k+1];
+            s.meanTotal += total;
+            s.minTotal = std::min( s.minTotal, total );
+            s.maxTotal = std::max( s.maxTotal, total );
+        }
+    }
+    int nRanks = comm.localSize();
+    for ( auto& s : res )
+    {
+        s.meanTotal /= nRanks;
+        if ( s.nRanks < nRanks )
+            s.minTotal = 0;
+    }
+    return res;
+}
+
+Table
+Profiler::summaryTable( std::vector<ReducedRegionStats> const& stats )
+{
+    Table table;
+    table.add_row( { "Region", "Ranks", "Count", "Min(s)", "Mean(s)", "Max(s)", "Imbalance(%)" } );
+    table.format().setFirstRowIsHeader( true );
+    for ( auto const& s : stats )
+    {
+        auto pos = s.path.find_last_of( '/' );
+        std::string name = std::string( 2*s.level, ' ' ) + ( ( pos == std::string::npos )? s.path : s.path.substr( pos+1 ) );
+        table.add_row( { name, s.nRanks, s.count, s.minTotal, s.meanTotal, s.maxTotal, 100*s.imbalance() } );
+    }
+    return table;
+}
+
+void
+Profiler::saveTrace( WorldComm const& comm, std::string const& filename ) const
+{
+    // events of the rank separated by commas
+    std::ostringstream ostr;
+    {
+        std::lock_guard<std::mutex> lock( M_mutex );
+        int rank = comm.localRank();
+        nl::json meta = { { "name", "process_name" }, { "ph", "M" }, { "pid", rank }, { "args", { { "name", "rank " + std::to_string( rank ) } } } };
+        ostr << meta.dump();
+        for ( auto const& td : M_threadData )
+        {
+            for ( auto const& e : td->events )
+            {
+                nl::json j = { { "name", td->nodes[e.node].name },
+                               { "cat", td->path( e.node ) },
+                               { "ph", "X" },
+                               { "ts", e.start },
+                               { "dur", e.duration },
+                               { "pid", rank },
+                               { "tid", td->tid } };
+                ostr << ",\n" << j.dump();
+            }
+        }
+    }
+    std::vector<std::string> allEvents;
+    mpi::gather( comm, ostr.str(), allEvents, comm.masterRank() );
+    if ( comm.localRank() != comm.masterRank() )
+        return;
+
+    std::ofstream ofs( filename );
+    if ( !ofs )
+    {
+        LOG(WARNING) << "[Profiler] cannot write the trace in " << filename;
+        return;
+    }
+    ofs << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for ( int r = 0; r < (int)allEvents.size(); ++r )
+        ofs << ( ( r > 0 )? ",\n" : "" ) << allEvents[r];
+    ofs << "\n]}\n";
+}
+
+void
+Profiler::finalize( WorldComm const& comm, std::string const& summaryFilename, std::string const& traceFilename, bool display )
+{
+    if ( !M_enabled )
+        return;
+
+    // only the master rank has the reduced stats, the other ranks display nothing
+    auto stats = this->reducedStats( comm );
+    if ( comm.isMasterRank() )
+    {
+        Table table = summaryTable( stats );
+        if ( display )
+            std::cout << table << std::endl;
+        if ( !summaryFilename.empty() )
+        {
+            std::ofstream ofs( summaryFilename );
+            ofs << table << std::endl;
+        }
+    }
+    if ( M_traceEnabled && !traceFilename.empty() )
+        this->saveTrace( comm, traceFilename );
+}
+
+void
+Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock( M_mutex );
+    for ( auto& td : M_threadData )
+        td->clear();
+}
+
+} // namespace Feel
@@ -0,0 +1,206 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*-
+
+ This file is part of the Feel++ library
+
+ Copyright (C) 2023 Feel++ Consortium
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef FEELPP_PROFILER_HPP
+#define FEELPP_PROFILER_HPP 1
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/preprocessor/cat.hpp>
+
+#include <feel/feelcore/feel.hpp>
+
+namespace Feel
+{
+class WorldComm;
+class Table;
+
+/**
+ * @brief profiler of nested regions
+ *
+ * The regions are entered and left in a scoped way (see ProfilerRegion and
+ * FEELPP_PROFILE_REGION) and stored in a tree by thread : a region is
+ * identified by its path from the root (e.g. \c solve/assembly/matrix). For
+ * each region the number of calls, the total, min and max times are
+ * recorded. When the trace is enabled, each call is also recorded as an
+ * event which is written in the Chrome trace format (chrome://tracing,
+ * https://ui.perfetto.dev).
+ *
+ * At the end of the run (Environment destructor), finalize() reduces the
+ * profiles of all the ranks : the summary gives for each region the min,
+ * mean and max over the ranks of the total time and the load imbalance
+ * (max/mean - 1).
+ *
+ * @code
+ * {
+ *     FEELPP_PROFILE_REGION( "assembly" );
+ *     ...
+ * }
+ * @endcode
+ *
+ * Options : \c profiler (enable), \c profiler.trace, \c profiler.trace.filename,
+ * \c profiler.trace.max-events, \c profiler.summary.filename (the relative
+ * filenames are resolved in Environment::appRepository())
+ */
+class FEELPP_EXPORT Profiler
+{
+public:
+    using clock_type = std::chrono::steady_clock;
+
+    //! statistics of a region
+    struct RegionStats
+    {
+        //! path of the region, the names are separated by '/'
+        std::string path;
+        //! depth of the region (0 for the top regions)
+        int level = 0;
+        size_type count = 0;
+        double total = 0;
+        double min = 0;
+        double max = 0;
+    };
+
+    //! statistics of a region over the ranks
+    struct ReducedRegionStats
+    {
+        std::string path;
+        int level = 0;
+        //! number of ranks which have entered the region
+        int nRanks = 0;
+        size_type count = 0;
+        //! min, mean and max over the ranks of the total time in the region (the
+        //! ranks which have not entered the region count for 0)
+        double minTotal = 0;
+        double meanTotal = 0;
+        double maxTotal = 0;
+        //! max/mean - 1
+        double imbalance() const { return ( meanTotal > 0 )? maxTotal/meanTotal - 1 : 0.; }
+    };
+
+    //! the profiler
+    static Profiler& instance();
+
+    Profiler( Profiler const& ) = delete;
+    Profiler& operator=( Profiler const& ) = delete;
+
+    //! \return true if the regions are recorded
+    bool isEnabled() const { return M_enabled; }
+    void setEnabled( bool b ) { M_enabled = b; }
+
+    //! \return true if the calls of the regions are recorded as trace events
+    bool isTraceEnabled() const { return M_traceEnabled; }
+    void setTraceEnabled( bool b ) { M_traceEnabled = b; }
+
+    //! maximum number of trace events recorded by thread
+    void setTraceMaxEvents( size_type n ) { M_traceMaxEvents = n; }
+
+    //! enter the region \p name (child of the current region of the thread)
+    void enter( std::string_view name );
+
+    //! leave the current region of the thread
+    void leave();
+
+    /**
+     * add a call of the region \p name which has lasted \p duration seconds
+     * and ends now, as a child of the current region of the thread (used by
+     * the timers which are named when they are stopped)
+     */
+    void addRegion( std::string_view name, double duration );
+
+    //! statistics of the regions of this rank (merged over the threads), in depth-first order
+    std::vector<RegionStats> localStats() const;
+
+    //! statistics of the regions reduced over the ranks of \p comm (valid on the master rank)
+    std::vector<ReducedRegionStats> reducedStats( WorldComm const& comm ) const;
+
+    //! summary table of the reduced statistics
+    static Table summaryTable( std::vector<ReducedRegionStats> const& stats );
+
+    /**
+     * write the trace events of all the ranks of \p comm in \p filename
+     * (Chrome trace format, the pid is the rank)
+     */
+    void saveTrace( WorldComm const& comm, std::string const& filename ) const;
+
+    /**
+     * reduce the profiles of the ranks of \p comm, display the summary on the
+     * master rank (if \p display) and save it in \p summaryFilename, save the trace in
+     * \p traceFilename (if the trace is enabled). The filenames can be empty.
+     */
+    void finalize( WorldComm const& comm, std::string const& summaryFilename, std::string const& traceFilename, bool display = true );
+
+    //! remove all the regions and the events
+    void clear();
+
+private:
+    Profiler();
+
+    struct ThreadData;
+    //! data of the calling thread
+    ThreadData& threadData();
+
+private:
+    bool M_enabled;
+    bool M_traceEnabled;
+    size_type M_traceMaxEvents;
+    clock_type::time_point M_start;
+    mutable std::mutex M_mutex;
+    std::vector<std::unique_ptr<ThreadData>> M_threadData;
+};
+
+/**
+ * @brief scoped region of the Profiler
+ *
+ * The region is entered in the constructor and left in the destructor, it does
+ * nothing if the profiler is disabled.
+ */
+class ProfilerRegion
+{
+public:
+    explicit ProfilerRegion( std::string_view name )
+        :
+        M_active( Profiler::instance().isEnabled() )
+        {
+            if ( M_active )
+                Profiler::instance().enter( name );
+        }
+    ProfilerRegion( ProfilerRegion const& ) = delete;
+    ProfilerRegion& operator=( ProfilerRegion const& ) = delete;
+    ~ProfilerRegion()
+        {
+            if ( M_active )
+                Profiler::instance().leave();
+        }
+private:
+    bool M_active;
+};
+
+} // namespace Feel
+
+//! profile the enclosing scope as the region \p name
+#define FEELPP_PROFILE_REGION( name ) \
+    Feel::ProfilerRegion BOOST_PP_CAT( feelpp_profiler_region_, __LINE__ )( name )
+
+#endif /* FEELPP_PROFILER_HPP */
@@ -0,0 +1,171 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*-
+
+ This file is part of the Feel++ library
+
+ Copyright (C) 2023 Feel++ Consortium
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+ */
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Feel
+{
+
+/**
+ * @brief fixed size pool of worker threads
+ *
+ * The threads are created once and process the submitted tasks in FIFO
+ * order, which avoids creating threads for each small piece of work
+ * (std::async). The destructor waits for the pending tasks.
+ *
+ * @code
+ * ThreadPool pool( 4 );
+ * std::vector<std::future<double>> res;
+ * for ( auto const& item : workItems )
+ *     res.push_back( pool.submit( [&item]{ return process( item ); } ) );
+ * for ( auto & r : res )
+ *     sum += r.get();
+ * @endcode
+ */
+class ThreadPool
+{
+public:
+    //! create a pool of \p nThreads threads (hardware concurrency if 0)
+    explicit ThreadPool( unsigned int nThreads = 0 )
+        {
+            if ( nThreads == 0 )
+                nThreads = std::max( 1u, std::thread::hardware_concurrency() );
+            M_workers.reserve( nThreads );
+            for ( unsigned int t = 0; t < nThreads; ++t )
+                M_workers.emplace_back( [this]{ this->run(); } );
+        }
+
+    ThreadPool( ThreadPool const& ) = delete;
+    ThreadPool& operator=( ThreadPool const& ) = delete;
+
+    ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock( M_mutex );
+                M_stop = true;
+            }
+            M_cv.notify_all();
+            for ( auto& w : M_workers )
+                w.join();
+        }
+
+    //! number of worker threads
+    std::size_t size() const { return M_workers.size(); }
+
+    //! add a task in the queue, the result (or exception) is returned through the future
+    template <typename F>
+    auto submit( F&& f ) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+        {
+            using result_type = std::invoke_result_t<std::decay_t<F>>;
+            auto task = std::make_shared<std::packaged_task<result_type()>>( std::forward<F>( f ) );
+            std::future<result_type> res = task->get_future();
+            {
+                std::lock_guard<std::mutex> lock( M_mutex );
+                M_tasks.emplace_back( [task]{ (*task)(); } );
+            }
+            M_cv.notify_one();
+            return res;
+        }
+
+private:
+    void run()
+        {
+            for ( ;; )
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock( M_mutex );
+                    M_cv.wait( lock, [this]{ return M_stop || !M_tasks.empty(); } );
+                    if ( M_tasks.empty() )
+                        return;
+                    task = std::move( M_tasks.front() );
+                    M_tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+private:
+    std::vector<std::thread> M_workers;
+    std::deque<std::function<void()>> M_tasks;
+    std::mutex M_mutex;
+    std::condition_variable M_cv;
+    bool M_stop = false;
+};
+
+/**
+ * @brief pool shared by the library
+ *
+ * The pool is created on the first call and kept alive between the calls,
+ * it is recreated only when a different number of threads is requested.
+ * The returned pointer keeps the pool alive while it is used.
+ */
+inline std::shared_ptr<ThreadPool>
+sharedThreadPool( unsigned int nThreads )
+{
+    static std::mutex m;
+    static std::shared_ptr<ThreadPool> pool;
+    std::lock_guard<std::mutex> lock( m );
+    if ( !pool || pool->size() != std::max( 1u, nThreads ) )
+        pool = std::make_shared<ThreadPool>( std::max( 1u, nThreads ) );
+    return pool;
+}
+
+/**
+ * apply \p f( begin, end ) on \p nThreads contiguous chunks of [0,n), using
+ * at most one thread by \p grainSize items. The chunks are run on threads
+ * created for the call (not on a pool), so \p f can itself wait on a
+ * ThreadPool. Pass a \p grainSize of 1 to get one thread by item.
+ */
+template<typename IndexT, typename FuncType>
+void
+parallelForChunks( IndexT n, int nThreads, FuncType&& f, std::common_type_t<IndexT> grainSize = 1024 )
+{
+    grainSize = std::max( IndexT( 1 ), grainSize );
+    nThreads = std::max( 1, std::min<int>( nThreads, ( n+grainSize-1 )/grainSize ) );
+    if ( nThreads == 1 )
+    {
+        f( IndexT( 0 ), n );
+        return;
+    }
+    std::vector<std::thread> threads;
+    IndexT chunk = ( n+nThreads-1 )/nThreads;
+    for ( int t = 0; t < nThreads; ++t )
+    {
+        IndexT begin = std::min( n, t*chunk ), end = std::min( n, begin+chunk );
+        threads.emplace_back( [&f,begin,end]() { f( begin, end ); } );
+    }
+    for ( auto& t : threads )
+        t.join();
+}
+
+} // namespace Feel
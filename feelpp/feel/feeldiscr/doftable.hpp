@@ -110,6 +110,8 @@ struct hash<std::tuple<TT...>>
 #include <feel/feelpoly/hdivpolynomialset.hpp>
 #include <feel/feelpoly/hcurlpolynomialset.hpp>
 #include <feel/feeldiscr/doftablebase.hpp>
+#include <feel/feeldiscr/doftablecontainers.hpp>
+#include <feel/feeldiscr/elementcoloring.hpp>
 #include <feel/feeldiscr/doffromelement.hpp>
 #include <feel/feeldiscr/doffrommortar.hpp>
 #include <feel/feeldiscr/doffromboundary.hpp>
@@ -270,9 +272,9 @@ public:
 
 
     typedef boost::tuple<node_type, size_type, uint16_type > dof_point_type;
-    typedef std::unordered_map<size_type,dof_point_type> dof_points_type;
-    typedef typename std::unordered_map<size_type,dof_point_type>::iterator dof_points_iterator;
-    typedef typename std::unordered_map<size_type,dof_point_type>::const_iterator dof_points_const_iterator;
+    typedef DofPointsContainer<dof_point_type> dof_points_type;
+    typedef typename dof_points_type::iterator dof_points_iterator;
+    typedef typename dof_points_type::const_iterator dof_points_const_iterator;
 
     typedef std::vector<dof_point_type> dof_periodic_points_type;
     typedef typename std::vector<dof_point_type>::iterator dof_periodic_points_iterator;
@@ -311,7 +313,6 @@ public:
     typedef typename dof_map_type::iterator dof_map_iterator;
     typedef typename dof_map_type::const_iterator dof_map_const_iterator;
 
-    typedef std::map<size_type, std::set<size_type> > dof_procset_type;
     /**
      * This type is useful to construct the sign map in the modal case
      **/
@@ -338,9 +339,12 @@ public:
     typedef std::multimap<size_type /*gid*/, periodic_dof_type> periodic_dof_map_type;
 
     //typedef typename std::vector<localglobal_indices_type,Eigen::aligned_allocator<localglobal_indices_type> > vector_indices_type;
-    using vector_indices_type = std::unordered_map<size_type,localglobal_indices_type,
+    using vector_signs_type = std::unordered_map<size_type,localglobal_indices_type,
                                         std::hash<size_type>,std::equal_to<size_type>,
                                         Eigen::aligned_allocator<std::pair<const size_type,localglobal_indices_type > > >;
+    //! local to global indices of the elements (CSR storage)
+    using vector_indices_type = ElementDofIndices<int>;
+    using localglobal_indices_const_map_type = typename vector_indices_type::const_map_type;
 
     DofTable( WorldComm const& _worldComm )
         :
@@ -727,13 +731,21 @@ public:
         }
 
     /**
-     * \return the local to global indices
+     * \return a view on the local to global indices of the element \p ElId,
+     * valid as long as the dof table is not rebuilt
+     */
+    localglobal_indices_const_map_type localToGlobalIndices( size_type ElId ) const
+        {
+            DCHECK( M_locglob_indices.has( ElId ) ) << "no locglob_indices in elt : " << ElId;
+            return M_locglob_indices[ElId];
+        }
+
+    /**
+     * \return the cache of the element colourings used by the coloured assembly
      */
-    localglobal_indices_type const& localToGlobalIndices( size_type ElId ) const
+    ElementColoringCache& elementColoringCache() const
         {
-            auto itFindElt = M_locglob_indices.find( ElId );
-            DCHECK( itFindElt != M_locglob_indices.end() ) << "no locglob_indices in elt : " << ElId;
-            return itFindElt->second;
+            return M_elementColoringCache;
         }
 
     /**
@@ -1107,13 +1119,13 @@ public:
      */
     void buildGlobalProcessToGlobalClusterDofMapContinuous( mesh_type& mesh );
     void buildGlobalProcessToGlobalClusterDofMapContinuousActifDof( mesh_type& mesh,
-                                                                    std::vector< std::map<size_type,std::set<std::vector<size_type> > > > & listToSend,
+                                                                    std::vector< FaceDofsContainer<size_type> > & listToSend,
                                                                     std::set<rank_type> & procRecvData );
     void buildGlobalProcessToGlobalClusterDofMapContinuousGhostDofBlockingComm( mesh_type& mesh,
-                                                                                std::vector< std::map<size_type,std::set<std::vector<size_type> > > > const& listToSend,
+                                                                                std::vector< FaceDofsContainer<size_type> > const& listToSend,
                                                                                 std::set<rank_type> const& procRecvData );
     void buildGlobalProcessToGlobalClusterDofMapContinuousGhostDofNonBlockingComm( mesh_type& mesh,
-                                                                                   std::vector< std::map<size_type,std::set<std::vector<size_type> > > > const& listToSend,
+                                                                                   std::vector< FaceDofsContainer<size_type> > const& listToSend,
                                                                                    std::set<rank_type> const& procRecvData );
     void buildGlobalProcessToGlobalClusterDofMapDiscontinuous();
 
@@ -1569,7 +1581,7 @@ private:
     //dof_container_type M_dof_view;
 
     vector_indices_type M_locglob_indices;
-    vector_indices_type M_locglob_signs;
+    vector_signs_type M_locglob_signs;
     localglobal_indices_type M_locglob_nosigns;
 
     bool M_buildDofTableMPIExtended;
@@ -1579,6 +1591,9 @@ private:
 
     dof_from_edge_type M_dfe;
 
+    //! colourings of the element ranges assembled with parallel.cpu.impl=coloring
+    mutable ElementColoringCache M_elementColoringCache;
+
 public:
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
@@ -1761,8 +1776,6 @@ DofTable<MeshType, FEType, PeriodicityType, MortarType>::initDofMap( mesh_type&
     const size_type nV = numMeshElements;
     int ntldof = is_product?nComponents*nldof:nldof;//this->getIndicesSize();
 
-    //M_locglob_indices.resize( nV, localglobal_indices_type::Zero( nDofPerElement ) );
-    M_locglob_indices.reserve( nV );
     this->initNumberOfDofIdToContainerId( 1 );
 
     if ( is_hdiv_conforming || is_hcurl_conforming )
@@ -1773,24 +1786,23 @@ DofTable<MeshType, FEType, PeriodicityType, MortarType>::initDofMap( mesh_type&
     else
         M_locglob_nosigns = localglobal_indices_type::Ones( nDofPerElement );
 
+    std::vector<size_type> eltIds;
     if ( this->hasMeshSupport() && this->meshSupport()->isPartialSupport() )
     {
-        for ( size_type eltId : this->meshSupport()->rangeMeshElementsIdsPartialSupport() )
-        {
-            M_locglob_indices[eltId] = localglobal_indices_type::Zero( nDofPerElement );
-            if ( is_hdiv_conforming || is_hcurl_conforming )
-                M_locglob_signs[eltId] = localglobal_indices_type::Ones( nDofPerElement );
-        }
+        auto const& eltIdsPartialSupport = this->meshSupport()->rangeMeshElementsIdsPartialSupport();
+        eltIds.assign( eltIdsPartialSupport.begin(), eltIdsPartialSupport.end() );
     }
     else
     {
+        eltIds.reserve( nV );
         for ( auto const& elt : allelements( M ) )
-        {
-            size_type eltId = unwrap_ref( elt ).id();
-            M_locglob_indices[eltId] = localglobal_indices_type::Zero( nDofPerElement );
-            if ( is_hdiv_conforming || is_hcurl_conforming )
-                M_locglob_signs[eltId] = localglobal_indices_type::Ones( nDofPerElement );
-        }
+            eltIds.push_back( unwrap_ref( elt ).id() );
+    }
+    M_locglob_indices.init( eltIds, nDofPerElement );
+    if ( is_hdiv_conforming || is_hcurl_conforming )
+    {
+        for ( size_type eltId : eltIds )
+            M_locglob_signs[eltId] = localglobal_indices_type::Ones( nDofPerElement );
     }
 
     const bool doperm = ( ( ( Shape == SHAPE_TETRA ) && ( nOrder > 2 ) ) || ( ( Shape == SHAPE_HEXA ) && ( nOrder > 1 ) ) );
@@ -1803,6 +1815,7 @@ DofTable<MeshType, FEType, PeriodicityType, MortarType>::build( mesh_type& M )
 {
     tic();
     M_mesh = boost::addressof( M );
+    M_elementColoringCache.clear();
     wc( this )->print( fmt::format( "[DofTable::build] starts, has mesh support: {}", this->hasMeshSupport() ), 
                        FLAGS_v > 1, FLAGS_v > 0, FLAGS_v > 1 );
 
@@ -2013,6 +2026,7 @@ DofTable<MeshType, FEType, PeriodicityType, MortarType>::build( mesh_type& M )
                 faceDataDof.setIndex( previousGlobalIdToNewGlobalId[faceDataDof.index()] );
 
         dof_points_type newDofPoints;
+        newDofPoints.reserve( _nLocalDofWithGhost );
         for ( auto const& dofPt : M_dof_points )
         {
             size_type newDofId = previousGlobalIdToNewGlobalId[ dofPt.first ];
@@ -2039,19 +2053,26 @@ DofTable<MeshType, FEType, PeriodicityType, MortarType>::build( mesh_type& M )
     else
         rangeMeshElt = elements( M, entityProcess );
 
+    if ( is_mortar )
+    {
+        // the mortar elements have a different number of dofs : the indices
+        // storage is resized once
+        std::map<size_type,int> mortarSizes;
+        for ( auto const& eltWrap : rangeMeshElt )
+        {
+            auto const& elt = boost::unwrap_ref(eltWrap);
+            if ( !elt.isOnBoundary() )
+                continue;
+            auto const& ldof = this->localDof( elt.id() );
+            mortarSizes[elt.id()] = std::distance( ldof.first, ldof.second );
+        }
+        VLOG(1) << "resizing indices for mortar: " << mortarSizes.size() << " elements";
+        M_locglob_indices.resize( mortarSizes );
+    }
     for ( auto const& eltWrap : rangeMeshElt )
     {
         auto const& elt = boost::unwrap_ref(eltWrap);
         size_type elid= elt.id();
-        if ( is_mortar && elt.isOnBoundary() )
-        {
-            VLOG(1) << "resizing indices and signs for mortar...";
-            auto const& ldof = this->localDof( elid );
-            size_type ne = std::distance( ldof.first, ldof.second );
-            VLOG(1) << "resizing indices and signs for mortar:  " << ne;
-            M_locglob_indices[elid].resize( ne );
-            //M_locglob_signs[elid].resize( ne );
-        }
         for( auto const& dof: this->localDof( elid ) )
         {
             M_locglob_indices[elid][dof.first.localDof()] = dof.second.index();
@@ -2878,6 +2899,8 @@ DofTable<MeshType, FEType, PeriodicityType, MortarType>::generateDofPoints(  mes
     if ( it_elt == en_elt )
         return;
 
+    M_dof_points.reserve( this->nLocalDofWithGhost() );
+
     auto gm = M.gm();
     // Precompute some data in the reference element for
     // geometric mapping and reference finite element
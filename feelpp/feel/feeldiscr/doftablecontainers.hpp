@@ -0,0 +1,330 @@
+//! -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+//!
+//! This file is part of the Feel++ library
+//!
+//! This library is free software; you can redistribute it and/or
+//! modify it under the terms of the GNU Lesser General Public
+//! License as published by the Free Software Foundation; either
+//! version 2.1 of the License, or (at your option) any later version.
+//!
+//! This library is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//! Lesser General Public License for more details.
+//!
+//! You should have received a copy of the GNU Lesser General Public
+//! License along with this library; if not, write to the Free Software
+//! Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//!
+//! @file
+//! @copyright 2023 Feel++ Consortium
+//!
+#ifndef FEELPP_DOFTABLECONTAINERS_HPP
+#define FEELPP_DOFTABLECONTAINERS_HPP 1
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <boost/iterator/filter_iterator.hpp>
+#include <Eigen/Core>
+
+#include <feel/feelcore/feel.hpp>
+
+namespace Feel
+{
+
+/**
+ * local to global dof indices of the elements stored in compressed sparse
+ * row format : the indices of the element \c id are
+ * \c values[offsets[id]:offsets[id+1]], the offsets being indexed by the
+ * element ids. An element without dofs has an empty row.
+ */
+template <typename IndexT = int>
+class ElementDofIndices
+{
+public:
+    using index_type = IndexT;
+    using indices_type = Eigen::Matrix<index_type, Eigen::Dynamic, 1>;
+    using map_type = Eigen::Map<indices_type>;
+    using const_map_type = Eigen::Map<const indices_type>;
+
+    ElementDofIndices() = default;
+    ElementDofIndices( ElementDofIndices const& ) = default;
+    ElementDofIndices( ElementDofIndices && ) = default;
+    ElementDofIndices& operator=( ElementDofIndices const& ) = default;
+    ElementDofIndices& operator=( ElementDofIndices && ) = default;
+
+    void clear()
+        {
+            M_offsets.clear();
+            M_values.clear();
+        }
+
+    //! \return the number of elements (including the empty rows)
+    size_type size() const { return M_offsets.empty() ? 0 : M_offsets.size()-1; }
+
+    //! \return the total number of indices
+    size_type nIndices() const { return M_values.size(); }
+
+    //! \return true if the element \p eltId has indices
+    bool has( size_type eltId ) const
+        {
+            return eltId+1 < M_offsets.size() && M_offsets[eltId+1] > M_offsets[eltId];
+        }
+
+    //! \return a view on the indices of the element \p eltId, the view is
+    //! valid until the storage is rebuilt (init, resize, clear)
+    const_map_type operator[]( size_type eltId ) const
+        {
+            DCHECK( this->has( eltId ) ) << "no indices in elt : " << eltId;
+            return const_map_type( M_values.data()+M_offsets[eltId], M_offsets[eltId+1]-M_offsets[eltId] );
+        }
+    map_type operator[]( size_type eltId )
+        {
+            DCHECK( this->has( eltId ) ) << "no indices in elt : " << eltId;
+            return map_type( M_values.data()+M_offsets[eltId], M_offsets[eltId+1]-M_offsets[eltId] );
+        }
+
+    //!
+    //! allocate \p n indices (set to 0) for each element id of \p eltIds
+    //!
+    template <typename EltIdRangeType>
+    void init( EltIdRangeType const& eltIds, int n )
+        {
+            size_type maxEltId = 0;
+            bool isEmpty = true;
+            for ( size_type eltId : eltIds )
+            {
+                maxEltId = std::max( maxEltId, eltId );
+                isEmpty = false;
+            }
+            this->clear();
+            if ( isEmpty )
+                return;
+            std::vector<size_type> counts( maxEltId+1, 0 );
+            for ( size_type eltId : eltIds )
+                counts[eltId] = n;
+            this->initFromCounts( counts );
+        }
+
+    //!
+    //! change the number of indices of some elements, the indices of the
+    //! other elements are kept (the storage is rebuilt once)
+    //!
+    void resize( std::map<size_type,int> const& newSizes )
+        {
+            if ( newSizes.empty() )
+                return;
+            std::vector<size_type> counts( std::max( this->size(), newSizes.rbegin()->first+1 ), 0 );
+            for ( size_type eltId = 0; eltId < this->size(); ++eltId )
+                counts[eltId] = M_offsets[eltId+1]-M_offsets[eltId];
+            for ( auto const& [eltId,n] : newSizes )
+                counts[eltId] = n;
+            std::vector<size_type> oldOffsets;
+            std::vector<index_type> oldValues;
+            oldOffsets.swap( M_offsets );
+            oldValues.swap( M_values );
+            this->initFromCounts( counts );
+            for ( size_type eltId = 0; eltId+1 < oldOffsets.size(); ++eltId )
+            {
+                size_type n = std::min( oldOffsets[eltId+1]-oldOffsets[eltId], counts[eltId] );
+                std::copy_n( oldValues.begin()+oldOffsets[eltId], n, M_values.begin()+M_offsets[eltId] );
+            }
+        }
+
+private:
+    void initFromCounts( std::vector<size_type> const& counts )
+        {
+            M_offsets.resize( counts.size()+1 );
+            M_offsets[0] = 0;
+            for ( size_type k = 0; k < counts.size(); ++k )
+                M_offsets[k+1] = M_offsets[k] + counts[k];
+            M_values.assign( M_offsets.back(), 0 );
+        }
+
+private:
+    std::vector<size_type> M_offsets;
+    std::vector<index_type> M_values;
+};
+
+/**
+ * dof points stored contiguously and indexed by the local dof ids. The
+ * container keeps the interface of the associative container it replaces :
+ * the iterators point to \c std::pair<dof id, dof point> and only visit the
+ * dofs whose point has been set.
+ */
+template <typename DofPointType>
+class DofPointsContainer
+{
+public:
+    using dof_point_type = DofPointType;
+    using value_type = std::pair<size_type, dof_point_type>;
+    using storage_type = std::vector<value_type>;
+
+    struct IsSet
+    {
+        bool operator()( value_type const& v ) const { return v.first != invalid_v<size_type>; }
+    };
+    using iterator = boost::filter_iterator<IsSet, typename storage_type::iterator>;
+    using const_iterator = boost::filter_iterator<IsSet, typename storage_type::const_iterator>;
+
+    DofPointsContainer() = default;
+    DofPointsContainer( DofPointsContainer const& ) = default;
+    DofPointsContainer( DofPointsContainer && ) = default;
+    DofPointsContainer& operator=( DofPointsContainer const& ) = default;
+    DofPointsContainer& operator=( DofPointsContainer && ) = default;
+
+    //! allocate the storage of the dof ids in [0,n)
+    void reserve( size_type n )
+        {
+            if ( n > M_points.size() )
+                M_points.resize( n, value_type( invalid_v<size_type>, dof_point_type() ) );
+        }
+
+    void clear()
+        {
+            storage_type().swap( M_points );
+            M_size = 0;
+        }
+    void swap( DofPointsContainer & c )
+        {
+            M_points.swap( c.M_points );
+            std::swap( M_size, c.M_size );
+        }
+
+    //! \return the number of dof points set
+    size_type size() const { return M_size; }
+    bool empty() const { return M_size == 0; }
+
+    //! \return the dof point of \p dofId, created if not set
+    dof_point_type& operator[]( size_type dofId )
+        {
+            this->reserve( dofId+1 );
+            auto & v = M_points[dofId];
+            if ( v.first == invalid_v<size_type> )
+            {
+                v.first = dofId;
+                ++M_size;
+            }
+            return v.second;
+        }
+
+    iterator find( size_type dofId )
+        {
+            if ( dofId >= M_points.size() || M_points[dofId].first == invalid_v<size_type> )
+                return this->end();
+            return iterator( IsSet{}, M_points.begin()+dofId, M_points.end() );
+        }
+    const_iterator find( size_type dofId ) const
+        {
+            if ( dofId >= M_points.size() || M_points[dofId].first == invalid_v<size_type> )
+                return this->end();
+            return const_iterator( IsSet{}, M_points.begin()+dofId, M_points.end() );
+        }
+
+    iterator begin() { return iterator( IsSet{}, M_points.begin(), M_points.end() ); }
+    iterator end() { return iterator( IsSet{}, M_points.end(), M_points.end() ); }
+    const_iterator begin() const { return const_iterator( IsSet{}, M_points.begin(), M_points.end() ); }
+    const_iterator end() const { return const_iterator( IsSet{}, M_points.end(), M_points.end() ); }
+
+private:
+    storage_type M_points;
+    size_type M_size = 0;
+};
+
+/**
+ * global dofs of the faces shared with another process, grouped by face id
+ * and stored in compressed sparse row format. A record holds the
+ * \c nComponents global dofs of one face dof. The records are appended by
+ * \c add, \c finalize sorts them by face id and by dofs and removes the
+ * duplicates : the records of the \c f -th face are then
+ * \c [offset(f),offset(f+1)).
+ */
+template <typename IndexT = size_type>
+class FaceDofsContainer
+{
+public:
+    using index_type = IndexT;
+
+    explicit FaceDofsContainer( int nComponents = 1 )
+        :
+        M_nComponents( nComponents )
+        {}
+    FaceDofsContainer( FaceDofsContainer const& ) = default;
+    FaceDofsContainer( FaceDofsContainer && ) = default;
+    FaceDofsContainer& operator=( FaceDofsContainer const& ) = default;
+    FaceDofsContainer& operator=( FaceDofsContainer && ) = default;
+
+    int nComponents() const { return M_nComponents; }
+
+    //! append the record \p dofs (of size \c nComponents) to the face \p faceId
+    template <typename DofsType>
+    void add( size_type faceId, DofsType const& dofs )
+        {
+            DCHECK( M_offsets.empty() ) << "container already finalized";
+            DCHECK( dofs.size() == M_nComponents ) << "invalid record size " << dofs.size();
+            M_values.push_back( faceId );
+            M_values.insert( M_values.end(), dofs.begin(), dofs.end() );
+        }
+
+    //! sort the records, remove the duplicates and build the offsets of the faces
+    void finalize()
+        {
+            const int w = M_nComponents+1;
+            size_type nRecords = M_values.size()/w;
+            std::vector<size_type> perm( nRecords );
+            std::iota( perm.begin(), perm.end(), 0 );
+            auto record = [this,w]( size_type r ) { return M_values.begin()+r*w; };
+            std::sort( perm.begin(), perm.end(), [&]( size_type a, size_type b ) {
+                    return std::lexicographical_compare( record( a ), record( a )+w, record( b ), record( b )+w );
+                } );
+            perm.erase( std::unique( perm.begin(), perm.end(), [&]( size_type a, size_type b ) {
+                        return std::equal( record( a ), record( a )+w, record( b ) );
+                    } ), perm.end() );
+
+            std::vector<index_type> values;
+            values.reserve( perm.size()*M_nComponents );
+            M_faceIds.clear();
+            M_offsets.assign( 1, 0 );
+            for ( size_type r : perm )
+            {
+                auto it = record( r );
+                if ( M_faceIds.empty() || M_faceIds.back() != *it )
+                {
+                    if ( !M_faceIds.empty() )
+                        M_offsets.push_back( values.size()/M_nComponents );
+                    M_faceIds.push_back( *it );
+                }
+                values.insert( values.end(), it+1, it+w );
+            }
+            if ( !M_faceIds.empty() )
+                M_offsets.push_back( values.size()/M_nComponents );
+            M_values.swap( values );
+        }
+
+    //! \return the number of faces
+    size_type size() const { return M_faceIds.size(); }
+    bool empty() const { return M_faceIds.empty(); }
+
+    //! \return the id of the \p f -th face
+    size_type faceId( size_type f ) const { return M_faceIds[f]; }
+
+    //! \return the number of records of the \p f -th face
+    size_type nDofs( size_type f ) const { return M_offsets[f+1]-M_offsets[f]; }
+
+    //! \return the component \p c of the record \p d of the \p f -th face
+    index_type dof( size_type f, size_type d, int c ) const { return M_values[( M_offsets[f]+d )*M_nComponents+c]; }
+
+private:
+    int M_nComponents;
+    std::vector<size_type> M_faceIds;
+    std::vector<size_type> M_offsets;
+    std::vector<index_type> M_values;
+};
+
+} // namespace Feel
+
+#endif /* FEELPP_DOFTABLECONTAINERS_HPP */
@@ -107,8 +107,8 @@ DofTable<MeshType, FEType, PeriodicityType, MortarType>::buildGlobalProcessToGlo
     if ( nbFaceDof == 0 ) return;
     //------------------------------------------------------------------------------//
     // build GlobalProcessToGlobalClusterDofMap for actif dofs and prepare send for ghost dof
-    //std::vector< std::map<size_type,std::set<boost::tuple<size_type,uint16_type> > > > listToSend(this->worldComm().size());
-    std::vector< std::map<size_type,std::set< std::vector<size_type> > > > listToSend(this->worldComm().size());
+    // ( proc, ( idFace, ( globDof comp 0, comp 1,.. ),.. ),.. )
+    std::vector< FaceDofsContainer<size_type> > listToSend( this->worldComm().size(), FaceDofsContainer<size_type>( is_product?nComponents:1 ) );
     std::set<rank_type> procRecvData;
     this->buildGlobalProcessToGlobalClusterDofMapContinuousActifDof(mesh,listToSend,procRecvData);
     //------------------------------------------------------------------------------//
@@ -456,11 +456,11 @@ updateDofOnEdges( DofTableType const& doftable, typename DofTableType::mesh_type
 template<typename MeshType, typename FEType, typename PeriodicityType, typename MortarType>
 void
 DofTable<MeshType, FEType, PeriodicityType,MortarType>::buildGlobalProcessToGlobalClusterDofMapContinuousActifDof( mesh_type& mesh,
-                                                                                                        std::vector< std::map<size_type,std::set<std::vector<size_type> > > > & listToSend,
+                                                                                                        std::vector< FaceDofsContainer<size_type> > & listToSend,
                                                                                                         std::set<rank_type> & procRecvData )
 {
     // goal init container listToSend
-    // std::vector< std::map<size_type,std::set<size_type> > > ( proc,( idFace,(globDof,..)), ...   )) )
+    // ( proc, ( idFace, ( globDof comp 0, comp 1,.. ),.. ),.. )
     const rank_type myRank = this->worldComm().rank();
     //------------------------------------------------------------------------------//
     // get nbFaceDof
@@ -557,7 +557,7 @@ DofTable<MeshType, FEType, PeriodicityType,MortarType>::buildGlobalProcessToGlob
                     //listToSend[IdProcessOfGhost][idFaceInPartition].insert(boost::make_tuple(theglobdof,c));
                     ++nDofNotPresent;
                 }
-                listToSend[IdProcessOfGhost][idFaceInPartition].insert( compglobdofs );
+                listToSend[IdProcessOfGhost].add( idFaceInPartition, compglobdofs );
             }
 
             dofdone[theglobdoftest]=true;
@@ -566,6 +566,9 @@ DofTable<MeshType, FEType, PeriodicityType,MortarType>::buildGlobalProcessToGlob
 
     } // for ( ; face_it != face_en ; ++face_it )
 
+    for ( auto & faceDofs : listToSend )
+        faceDofs.finalize();
+
     //------------------------------------------------------------------------------//
     //------------------------------------------------------------------------------//
     //------------------------------------------------------------------------------//
@@ -645,7 +648,7 @@ template<typename MeshType, typename FEType, typename PeriodicityType, typename
 void
 DofTable<MeshType, FEType, PeriodicityType,MortarType>::
 buildGlobalProcessToGlobalClusterDofMapContinuousGhostDofBlockingComm( mesh_type& mesh,
-                                                                       std::vector< std::map<size_type,std::set<std::vector<size_type> > > > const& listToSend,
+                                                                       std::vector< FaceDofsContainer<size_type> > const& listToSend,
                                                                        std::set<rank_type> const& procRecvData )
 {
     const int myRank = this->worldComm().rank();
@@ -671,9 +674,8 @@ buildGlobalProcessToGlobalClusterDofMapContinuousGhostDofBlockingComm( mesh_type
 
     for ( int proc=0; proc<this->worldComm().size(); ++proc )
     {
-        auto itFaces = listToSend[proc].begin();
-        auto const enFaces = listToSend[proc].end();
-        const int nFaceToSend = std::distance(itFaces,enFaces);
+        auto const& faceDofs = listToSend[proc];
+        const int nFaceToSend = faceDofs.size();
         memoryInitialRequest[proc].resize(nFaceToSend);
         if ( nFaceToSend>0 )
         {
@@ -681,20 +683,18 @@ buildGlobalProcessToGlobalClusterDofMapContinuousGhostDofBlockingComm( mesh_type
             ++nbMsgToSend[proc];
         }
 
-        for ( int cptFaces=0 ; itFaces!=enFaces ; ++itFaces, ++cptFaces)
+        for ( int cptFaces=0 ; cptFaces<nFaceToSend ; ++cptFaces)
         {
-            auto itDof = itFaces->second.begin();
-            auto const enDof = itFaces->second.end();
-            const int nDofsInFace = std::distance(itDof,enDof);
+            const int nDofsInFace = faceDofs.nDofs( cptFaces );
             CHECK( nDofsInFace>0 ) << "error in data to send : nDofsInFace=" << nDofsInFace<<" must be > 0 \n";
 
             dofs_in_face_subcontainer_type dofsInFaceContainer(nDofsInFace);
             memoryInitialRequest[proc][cptFaces].resize(nDofsInFace);
-            for (int cptDof=0 ; itDof!=enDof ; ++itDof/*,++cptDof*/)
+            for (int cptDof=0, cptDof2=0 ; cptDof2<nDofsInFace ; ++cptDof2)
             {
                 for (uint16_type comp=0; comp<ncdof ; ++comp,++cptDof)
                 {
-                    const size_type theglobdof = itDof->operator[](comp);
+                    const size_type theglobdof = faceDofs.dof( cptFaces, cptDof2, comp );
                     //auto const theglobdof = itDof->get<0>();
                     //auto const comp = itDof->get<1>();
                     // save the tag of mpi send
@@ -715,9 +715,9 @@ buildGlobalProcessToGlobalClusterDofMapContinuousGhostDofBlockingComm( mesh_type
                 }
             }
 
-            this->worldComm().send( proc , nbMsgToSend[proc], boost::make_tuple(itFaces->first,dofsInFaceContainer) );
+            this->worldComm().send( proc , nbMsgToSend[proc], boost::make_tuple(faceDofs.faceId( cptFaces ),dofsInFaceContainer) );
             ++nbMsgToSend[proc];
-        } // for ( int cptFaces=0 ; itFaces!=enFaces ; ++itFaces, ++cptFaces)
+        } // for ( int cptFaces=0 ; cptFaces<nFaceToSend ; ++cptFaces)
 
     } // for ( int proc=0; proc<this->worldComm().size(); ++proc )
 
@@ -887,7 +887,7 @@ buildGlobalProcessToGlobalClusterDofMapContinuousGhostDofBlockingComm( mesh_type
 template<typename MeshType, typename FEType, typename PeriodicityType,typename MortarType>
 void
 DofTable<MeshType, FEType, PeriodicityType,MortarType>::buildGlobalProcessToGlobalClusterDofMapContinuousGhostDofNonBlockingComm( mesh_type& mesh,
-                                                                            std::vector< std::map<size_type,std::set<std::vector<size_type> > > > const& listToSend,
+                                                                            std::vector< FaceDofsContainer<size_type> > const& listToSend,
                                                                                                         std::set<rank_type> const& procRecvData )
 {
     typedef std::vector< boost::tuple<uint16_type, ublas::vector<double> > > dofs_in_face_subcontainer_type;
@@ -936,27 +936,25 @@ DofTable<MeshType, FEType, PeriodicityType,MortarType>::buildGlobalProcessToGlob
     {
         if ( listToSend[proc].size() == 0 ) continue;
 
-        auto itFaces = listToSend[proc].begin();
-        auto const enFaces = listToSend[proc].end();
-        const int nFaceToSend = std::distance(itFaces,enFaces);
+        auto const& faceDofs = listToSend[proc];
+        const int nFaceToSend = faceDofs.size();
         memoryInitialRequest[proc].resize(nFaceToSend);
 
-        for ( int cptFaces=0 ; itFaces!=enFaces ; ++itFaces, ++cptFaces)
+        for ( int cptFaces=0 ; cptFaces<nFaceToSend ; ++cptFaces)
         {
-            auto itDof = itFaces->second.begin();
-            auto const enDof = itFaces->second.end();
-            const int nDofsInFace = std::distance(itDof,enDof)*ncdof;
-            const int nDofsInFaceForComm = (componentsAreSamePoint)?std::distance(itDof,enDof) : nDofsInFace;
+            const int nRecords = faceDofs.nDofs( cptFaces );
+            const int nDofsInFace = nRecords*ncdof;
+            const int nDofsInFaceForComm = (componentsAreSamePoint)? nRecords : nDofsInFace;
 
             CHECK( nDofsInFace>0 ) << "error in data to send : nDofsInFace=" << nDofsInFace<<" must be > 0 \n";
 
             dofs_in_face_subcontainer_type dofsInFaceContainer(nDofsInFaceForComm);
             memoryInitialRequest[proc][cptFaces].resize(nDofsInFace);
-            for (int cptDof=0, cptDof2=0 ; itDof!=enDof ; ++itDof,++cptDof2)
+            for (int cptDof=0, cptDof2=0 ; cptDof2<nRecords ; ++cptDof2)
             {
                 for (uint16_type comp=0; comp<ncdof ; ++comp,++cptDof)
                 {
-                    const size_type theglobdof = itDof->operator[](comp);
+                    const size_type theglobdof = faceDofs.dof( cptFaces, cptDof2, comp );
 
                     //auto const theglobdof = itDof->get<0>();
                     //auto const comp = itDof->get<1>();
@@ -1000,10 +998,10 @@ DofTable<MeshType, FEType, PeriodicityType,MortarType>::buildGlobalProcessToGlob
             if ( nDataInVecToSendBis.find(proc) == nDataInVecToSendBis.end() )
                 nDataInVecToSendBis[proc]=0;
             // update container
-            dataToSend[proc][nDataInVecToSendBis[proc]] = boost::make_tuple(itFaces->first,dofsInFaceContainer);
+            dataToSend[proc][nDataInVecToSendBis[proc]] = boost::make_tuple(faceDofs.faceId( cptFaces ),dofsInFaceContainer);
             // update counter
             nDataInVecToSendBis[proc]++;
-        } // for ( int cptFaces=0 ; itFaces!=enFaces ; ++itFaces, ++cptFaces)
+        } // for ( int cptFaces=0 ; cptFaces<nFaceToSend ; ++cptFaces)
     }
 
     //--------------------------------------------------------------------------------------------------------//
@@ -0,0 +1,169 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*-
+
+ This file is part of the Feel++ library
+
+ Copyright (C) 2023 Feel++ Consortium
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/functional/hash.hpp>
+
+#include <feel/feelcore/feel.hpp>
+
+namespace Feel
+{
+/**
+ * Greedy colouring of a set of elements such that two elements of the same
+ * colour never share a degree of freedom.
+ *
+ * \p nElements is the number of elements to colour, \p nDofs the number of
+ * (process local) dofs and \p dofs a callable such that \c dofs(k) returns
+ * the dof indices of the k-th element as a random access container
+ * (\c size() and \c operator[], e.g. a \c std::vector or an Eigen vector).
+ * The returned vector holds, for each colour, the indices (in [0,nElements))
+ * of the elements of that colour. Elements of one colour can be assembled concurrently since
+ * they write into disjoint rows of the global matrix/vector.
+ *
+ * The dof to element adjacency is stored as a CSR array (count, prefix sum,
+ * fill) so that no per-dof container is allocated.
+ */
+template<typename DofsOfElementType>
+std::vector<std::vector<size_type>>
+elementColoring( size_type nElements, size_type nDofs, DofsOfElementType&& dofs )
+{
+    std::vector<std::vector<size_type>> colors;
+    if ( nElements == 0 )
+        return colors;
+
+    // dof -> elements adjacency in CSR format
+    std::vector<size_type> dofToEltPtr( nDofs+1, 0 );
+    for ( size_type k = 0; k < nElements; ++k )
+    {
+        auto const& eltDofs = dofs( k );
+        for ( size_type i = 0, n = eltDofs.size(); i < n; ++i )
+            ++dofToEltPtr[eltDofs[i]+1];
+    }
+    std::partial_sum( dofToEltPtr.begin(), dofToEltPtr.end(), dofToEltPtr.begin() );
+    std::vector<size_type> dofToElt( dofToEltPtr.back() );
+    std::vector<size_type> fillPos( dofToEltPtr.begin(), dofToEltPtr.end()-1 );
+    for ( size_type k = 0; k < nElements; ++k )
+    {
+        auto const& eltDofs = dofs( k );
+        for ( size_type i = 0, n = eltDofs.size(); i < n; ++i )
+            dofToElt[fillPos[eltDofs[i]]++] = k;
+    }
+
+    // greedy colouring : each element takes the smallest colour not used
+    // by an already coloured neighbour (i.e. an element sharing a dof)
+    std::vector<size_type> eltColor( nElements, invalid_v<size_type> );
+    // forbidden[c] == k means colour c is already used by a neighbour of element k
+    std::vector<size_type> forbidden;
+    for ( size_type k = 0; k < nElements; ++k )
+    {
+        auto const& eltDofs = dofs( k );
+        for ( size_type i = 0, n = eltDofs.size(); i < n; ++i )
+        {
+            size_type d = eltDofs[i];
+            for ( size_type p = dofToEltPtr[d]; p < dofToEltPtr[d+1]; ++p )
+            {
+                size_type c = eltColor[dofToElt[p]];
+                if ( c != invalid_v<size_type> )
+                    forbidden[c] = k;
+            }
+        }
+        size_type c = 0;
+        while ( c < forbidden.size() && forbidden[c] == k )
+            ++c;
+        if ( c == forbidden.size() )
+        {
+            forbidden.push_back( invalid_v<size_type> );
+            colors.emplace_back();
+        }
+        eltColor[k] = c;
+        colors[c].push_back( k );
+    }
+    return colors;
+}
+
+/**
+ * Cache of the colourings computed by elementColoring()
+ *
+ * A colouring only depends on the elements and on their dofs : it is stored
+ * by the dof table and reused as long as the same elements (same ids in the
+ * same order) are assembled. The element ids are kept with each colouring so
+ * that a hash collision never returns the colouring of another range.
+ */
+class ElementColoringCache
+{
+public:
+    using colors_type = std::vector<std::vector<size_type>>;
+    using colors_ptrtype = std::shared_ptr<const colors_type>;
+
+    ElementColoringCache() = default;
+    //! the cache is not shared by copies (e.g. of the dof table)
+    ElementColoringCache( ElementColoringCache const& ) {}
+    ElementColoringCache& operator=( ElementColoringCache const& ) { this->clear(); return *this; }
+
+    /**
+     * \return the colouring of the elements \p eltIds, computed with
+     * elementColoring( eltIds.size(), nDofs, dofs ) the first time
+     */
+    template<typename DofsOfElementType>
+    colors_ptrtype
+    get( std::vector<size_type> const& eltIds, size_type nDofs, DofsOfElementType&& dofs )
+    {
+        std::size_t key = boost::hash_range( eltIds.begin(), eltIds.end() );
+        {
+            std::lock_guard<std::mutex> lock( M_mutex );
+            auto range = M_colorings.equal_range( key );
+            for ( auto it = range.first; it != range.second; ++it )
+                if ( it->second.first == eltIds )
+                    return it->second.second;
+        }
+        auto colors = std::make_shared<const colors_type>( elementColoring( eltIds.size(), nDofs, std::forward<DofsOfElementType>( dofs ) ) );
+        std::lock_guard<std::mutex> lock( M_mutex );
+        M_colorings.emplace( key, std::make_pair( eltIds, colors ) );
+        return colors;
+    }
+
+    //! number of colourings in the cache
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock( M_mutex );
+        return M_colorings.size();
+    }
+
+    //! remove all the colourings (e.g. when the dofs are rebuilt)
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock( M_mutex );
+        M_colorings.clear();
+    }
+
+private:
+    mutable std::mutex M_mutex;
+    std::unordered_multimap<std::size_t, std::pair<std::vector<size_type>, colors_ptrtype>> M_colorings;
+};
+
+} // namespace Feel
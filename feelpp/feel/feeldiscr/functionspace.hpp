@@ -4019,7 +4019,9 @@ public:
         //!
         //! save function space element in file
         //! @param path path to files
-        //! @param type file type binary, ascii, hdf5, xml
+        //! @param type file type binary, ascii, hdf5, xml, hdf5-global
+        //! (one file keyed by a partition independent numbering of the dofs, see partitionIndependentDofKeys(),
+        //! which can be loaded with another number of processes)
         //! @param suffix filename suffix to use
         //! @param sep separator to use in filenames
         //!
@@ -4035,9 +4037,9 @@ public:
 #endif
             }
 
-            if ( typeUsed != "binary" && typeUsed != "text" && typeUsed != "xml" &&  typeUsed != "hdf5" )
+            if ( typeUsed != "binary" && typeUsed != "text" && typeUsed != "xml" &&  typeUsed != "hdf5" && typeUsed != "hdf5-global" )
             {
-                LOG(WARNING)  << "[save] : invalid format " << typeUsed << " (type available : binary,text,xml,hdf5)";
+                LOG(WARNING)  << "[save] : invalid format " << typeUsed << " (type available : binary,text,xml,hdf5,hdf5-global)";
                 return;
             }
 
@@ -4085,6 +4087,18 @@ public:
                 this->saveHDF5( filename.string() );
 #else
                 CHECK( false ) << "Feel++ is not compiled with hdf5";
+#endif
+            }
+            else if ( typeUsed == "hdf5-global" )
+            {
+                std::ostringstream os2;
+                os2 << name << sep << suffix << ".h5";
+                fs::path filename = fs::path( path ) / os2.str();
+#ifdef FEELPP_HAS_HDF5
+                auto [dofKeys,keySize] = this->functionSpace()->partitionIndependentDofKeys();
+                this->saveHDF5WithKeys( filename.string(), dofKeys, keySize );
+#else
+                CHECK( false ) << "Feel++ is not compiled with hdf5";
 #endif
             }
         }
@@ -4105,7 +4119,7 @@ public:
         //!
         //! load function space element from file
         //! @param path path to file
-        //! @param type file type binary, ascii, hdf5, xml
+        //! @param type file type binary, ascii, hdf5, xml, hdf5-global
         //! @param suffix filename suffix to use
         //! @param sep separator to use in filename
         //! @param space_path path to space file related to input file path
@@ -4133,7 +4147,7 @@ public:
 
             if ( fs::is_directory(path) )
             {
-                if ( typeUsed == "hdf5" )
+                if ( typeUsed == "hdf5" || typeUsed == "hdf5-global" )
                     oss << name << sep << suffix << ".h5";
                 else
                     oss << name << sep << suffix << "-" <<  this->worldComm().globalSize() << "." << this->worldComm().globalRank() << ".fdb";
@@ -4191,11 +4205,20 @@ public:
                 this->loadHDF5( p.string(), spacesRelation );
 #else
                 CHECK( false ) << "Feel++ is not compiled with hdf5";
+#endif
+            }
+            else if ( typeUsed == "hdf5-global" )
+            {
+#ifdef FEELPP_HAS_HDF5
+                auto [dofKeys,keySize] = this->functionSpace()->partitionIndependentDofKeys();
+                this->loadHDF5WithKeys( p.string(), dofKeys, keySize );
+#else
+                CHECK( false ) << "Feel++ is not compiled with hdf5";
 #endif
             }
             else
             {
-                LOG(WARNING)  << "[load] : invalid format " << typeUsed << " (type available : binary,text,xml,hdf5)";
+                LOG(WARNING)  << "[load] : invalid format " << typeUsed << " (type available : binary,text,xml,hdf5,hdf5-global)";
                 return false;
             }
 
@@ -5637,10 +5660,116 @@ public:
     template <typename TT=functionspace_type,std::enable_if_t< TT::is_composite, bool> = true >
     std::vector<index_type> relationFromFile( std::string const& filepathstr ) const
         {
-            CHECK( false ) << "composite case not implemented";
+            CHECK( false ) << "composite case not implemented, the format hdf5-global supports the composite spaces";
             return {};
         }
 
+    /**
+     * @brief identification of the dofs which does not depend on the partition of the mesh
+     *
+     * The key of a (element,local dof) pair is made of the sorted ids of the element vertices
+     * (the point ids are the same for any partition of the mesh) followed by the local dof.
+     * The key of a dof is the lexicographically smallest key among the elements which contain
+     * the dof, so two dofs have different keys. The keys are valid on the active dofs of the process.
+     *
+     * @return the keys stored contiguously (keySize words by dof) and the key size
+     */
+    template <typename TT=functionspace_type,std::enable_if_t< !TT::is_composite, bool> = true >
+    std::tuple<std::vector<std::uint64_t>,int> partitionIndependentDofKeys() const
+        {
+            auto dof = this->dof();
+            auto mesh = this->mesh();
+            const int nVerticesInElt = mesh_type::element_type::numVertices;
+            const int keySize = nVerticesInElt+1;
+            std::vector<std::uint64_t> keys( dof->nLocalDofWithGhost()*keySize, invalid_v<std::uint64_t> );
+            auto updateKey = [&keys,&keySize]( size_type thedof, std::uint64_t const* key )
+                {
+                    auto itKey = keys.begin() + thedof*keySize;
+                    if ( std::lexicographical_compare( key, key+keySize, itKey, itKey+keySize ) )
+                        std::copy( key, key+keySize, itKey );
+                };
+
+            std::vector<std::uint64_t> key( keySize );
+            index_type currentEltId = invalid_v<index_type>;
+            auto [itLocalDof,enLocalDof] = dof->localDof();
+            for ( ; itLocalDof != enLocalDof; ++itLocalDof )
+            {
+                index_type eltId = itLocalDof->first.elementId();
+                if ( eltId != currentEltId )
+                {
+                    auto const& elt = mesh->element( eltId );
+                    for ( int p=0;p<nVerticesInElt;++p )
+                        key[p] = elt.point( p ).id();
+                    std::sort( key.begin(), key.begin()+nVerticesInElt );
+                    currentEltId = eltId;
+                }
+                key[nVerticesInElt] = itLocalDof->first.localDof();
+                updateKey( itLocalDof->second.index(), key.data() );
+            }
+
+            // the keys computed from the ghost elements are sent to the process which owns the dof
+            rank_type nProc = this->worldComm().localSize();
+            if ( nProc > 1 )
+            {
+                std::vector<std::vector<std::uint64_t>> dataToSend( nProc ), dataRecv;
+                for ( size_type k=0;k<dof->nLocalDofWithGhost();++k )
+                {
+                    if ( !dof->dofGlobalProcessIsGhost( k ) )
+                        continue;
+                    size_type gcdof = dof->mapGlobalProcessToGlobalCluster( k );
+                    rank_type pid = dof->procOnGlobalCluster( gcdof );
+                    dataToSend[pid].push_back( gcdof );
+                    dataToSend[pid].insert( dataToSend[pid].end(), keys.begin()+k*keySize, keys.begin()+(k+1)*keySize );
+                }
+                mpi::all_to_all( this->worldComm().localComm(), dataToSend, dataRecv );
+                size_type firstDofGC = dof->firstDofGlobalCluster();
+                for ( auto const& data : dataRecv )
+                {
+                    for ( size_type k=0;k<data.size();k+=keySize+1 )
+                    {
+                        size_type thedof = data[k] - firstDofGC;
+                        DCHECK( dof->mapGlobalProcessToGlobalCluster( thedof ) == data[k] ) << "active dofs are not contiguous";
+                        updateKey( thedof, data.data()+k+1 );
+                    }
+                }
+            }
+            return { std::move( keys ), keySize };
+        }
+
+    /**
+     * @brief identification of the dofs which does not depend on the partition of the mesh
+     *
+     * The key of a dof is the index of its subspace followed by the key of the dof in the
+     * subspace (padded to the largest key size of the subspaces).
+     */
+    template <typename TT=functionspace_type,std::enable_if_t< TT::is_composite, bool> = true >
+    std::tuple<std::vector<std::uint64_t>,int> partitionIndependentDofKeys() const
+        {
+            std::vector<std::vector<std::uint64_t>> subKeys( nSpaces );
+            std::vector<int> subKeySizes( nSpaces );
+            hana::for_each( hana::make_range( hana::int_c<0>, hana::int_c<nSpaces> ), [this,&subKeys,&subKeySizes]( auto spaceId )
+                            {
+                                std::tie( subKeys[spaceId], subKeySizes[spaceId] ) = this->template functionSpace<decltype(spaceId)::value>()->partitionIndependentDofKeys();
+                            });
+            const int keySize = 1 + *std::max_element( subKeySizes.begin(), subKeySizes.end() );
+
+            auto dof = this->dof();
+            CHECK( dof->numberOfDofIdToContainerId() == nSpaces ) << "the subspaces should not be composite";
+            std::vector<std::uint64_t> keys( dof->nLocalDofWithGhost()*keySize, invalid_v<std::uint64_t> );
+            for ( int spaceId=0;spaceId<nSpaces;++spaceId )
+            {
+                int subKeySize = subKeySizes[spaceId];
+                auto const& dofIdToContainerId = dof->dofIdToContainerId( spaceId );
+                for ( size_type k=0;k<dofIdToContainerId.size();++k )
+                {
+                    auto itKey = keys.begin() + dofIdToContainerId[k]*keySize;
+                    *itKey = spaceId;
+                    std::copy( subKeys[spaceId].begin()+k*subKeySize, subKeys[spaceId].begin()+(k+1)*subKeySize, itKey+1 );
+                }
+            }
+            return { std::move( keys ), keySize };
+        }
+
     //@}
 
 
@@ -24,7 +24,12 @@
 #ifndef FEELPP_LOCALIZATION_HPP
 #define FEELPP_LOCALIZATION_HPP 1
 
+#include <future>
+#include <thread>
 
+#include <feel/feelcore/threadpool.hpp>
+#include <feel/feelmesh/morton.hpp>
+#include <feel/feelmesh/widebvh.hpp>
 
 namespace Feel {
 
@@ -90,6 +95,8 @@ public:
         M_isInit( false ),
         M_isInitBoundaryFaces( false ),
         M_doExtrapolation( boption( _name=(boost::format("mesh%1%d.localisation.use-extrapolation") % nDim).str() ) ),
+        M_useBVH( boption( _name=(boost::format("mesh%1%d.localisation.use-bvh") % nDim).str() ) ),
+        M_nThreadsBVH( ioption( _name=(boost::format("mesh%1%d.localisation.bvh.nthreads") % nDim).str() ) ),
         M_barycenter(),
         M_barycentersWorld()
         {
@@ -110,6 +117,11 @@ public:
             M_isInitBoundaryFaces( L.M_isInitBoundaryFaces ),
             M_resultAnalysis( L.M_resultAnalysis ),
             M_doExtrapolation( L.M_doExtrapolation ),
+            M_useBVH( L.M_useBVH ),
+            M_nThreadsBVH( L.M_nThreadsBVH ),
+            M_bvh( L.M_bvh ),
+            M_bvhEltIds( L.M_bvhEltIds ),
+            M_bvhAffineInverse( L.M_bvhAffineInverse ),
             M_gic( L.M_gic ), M_gic1( L.M_gic1 ),
             M_barycenter( L.M_barycenter ),
             M_barycentersWorld( L.M_barycentersWorld )
@@ -192,6 +204,25 @@ public:
             return M_doExtrapolation;
         }
 
+        //! --------------------------------------------------------------
+         //!  Define if run_analysis uses the batched search with the bounding volume hierarchy
+         //!
+        void setUseBVH( bool b )
+        {
+            M_useBVH = b;
+        }
+
+        bool useBVH() const
+        {
+            return M_useBVH;
+        }
+
+        //! set the number of threads of the batched search (0 : hardware concurrency)
+        void setNThreadsBVH( int n )
+        {
+            M_nThreadsBVH = n;
+        }
+
         mesh_ptrtype mesh()
         {
             return M_mesh;
@@ -299,6 +330,17 @@ public:
             return run_analysis( m,eltHypothetical );
         }
 
+        //! ---------------------------------------------------------------
+         //!  Research the element which contains the node p, forall p in the
+         //!  matrix_node_type m, with a bounding volume hierarchy of the element boxes.
+         //!  The points are sorted along a Morton curve and localised by batches
+         //!  (on several threads), the reference coordinates of the P1 simplices are
+         //!  computed for all the candidates of a batch at once. The points which
+         //!  are not found are searched with the kd tree (and extrapolation).
+         //!  The result is save by this object as in run_analysis
+         //!
+        boost::tuple<std::vector<bool>, size_type> run_analysis_batch( const matrix_node_type & m );
+
         //! ---------------------------------------------------------------
          //!  Research the element which contains the node p, forall p in the
          //!  matrix_node_type m. The result is save by this object
@@ -320,6 +362,9 @@ public:
             M_geoGlob_Elts.clear();
             if ( M_kd_tree )
                 M_kd_tree->clear();
+            M_bvh.reset();
+            M_bvhEltIds.clear();
+            M_bvhAffineInverse.clear();
             //this->updateForUse();
         }
 
@@ -348,6 +393,24 @@ public:
         FEELPP_NO_EXPORT void searchInKdTree( const node_type & p,
                                               std::list< std::pair<size_type, uint> > & listTri );
 
+        //! ---------------------------------------------------------------
+        //! localisation of the points with the kd tree
+        //!
+        FEELPP_NO_EXPORT boost::tuple<std::vector<bool>, size_type> runAnalysisWithKdTree( const matrix_node_type & m,
+                                                                                           const size_type & eltHypothetical );
+
+        //! ---------------------------------------------------------------
+        //! build the bounding volume hierarchy of the element boxes
+        //!
+        FEELPP_NO_EXPORT void initBVH();
+
+        //! ---------------------------------------------------------------
+        //! True if the node p is in elt (the inverse geometric transformations are given)
+        //!
+        template <typename EltType>
+        FEELPP_NO_EXPORT boost::tuple<bool,node_type,double> isIn( EltType const& elt, const node_type & _pt,
+                                                                   gmc_inverse_type & gic, gmc1_inverse_type & gic1 ) const;
+
         //! ---------------------------------------------------------------
         //!  computed barycenter
         //!
@@ -366,6 +429,14 @@ public:
         container_search_type M_resultAnalysis;
         bool M_doExtrapolation;
 
+        bool M_useBVH;
+        int M_nThreadsBVH;
+        std::shared_ptr<WideBVH<nRealDim> const> M_bvh;
+        //! element id of each box of the bvh
+        std::vector<size_type> M_bvhEltIds;
+        //! P1 simplices : inverse of the jacobian and first vertex of each element of the bvh
+        std::vector<double> M_bvhAffineInverse;
+
         ref_convex_type M_refelem;
         ref_convex1_type M_refelem1;
         mutable std::shared_ptr<gmc_inverse_type> M_gic;
@@ -477,54 +548,41 @@ Localization<MeshType>::initBoundaryFaces()
 template<typename MeshType>
 boost::tuple<bool,typename MeshType::node_type,double>
 Localization<MeshType>::isIn( size_type _id, const node_type & _pt ) const
+{
+    auto mesh = M_mesh.lock();
+    //get element with the id
+    return this->isIn( mesh->element( _id ), _pt, *M_gic, *M_gic1 );
+}
+
+template<typename MeshType>
+template <typename EltType>
+boost::tuple<bool,typename MeshType::node_type,double>
+Localization<MeshType>::isIn( EltType const& elt, const node_type & _pt,
+                              gmc_inverse_type & gic, gmc1_inverse_type & gic1 ) const
 {
     bool isin=false;
     double dmin=0;
     node_type x_ref;
 
-    auto mesh = M_mesh.lock();
-    //get element with the id
-    auto const& elt = mesh->element( _id );
-
     if ( elt.isOnBoundary() || nDim != nRealDim )
         {
-#if 0
-            // get inverse geometric transformation
-            gmc_inverse_type gic( mesh->gm(), elt, mesh->worldComm().subWorldCommSeqPtr() );
-            //apply the inverse geometric transformation for the point p
+            gic.update( elt );
             gic.setXReal( _pt);
             x_ref=gic.xRef();
-            // the point is in the reference element ?
-            boost::tie( isin, dmin ) = M_refelem.isIn( gic.xRef() );
-#else
-            M_gic->update( elt );
-            M_gic->setXReal( _pt);
-            x_ref=M_gic->xRef();
             if ( nDim == nRealDim )
-                isin = M_gic->isIn();
+                isin = gic.isIn();
             else // in this case, result given with gic->isIn() seems not work (see geomap.hpp)
-                boost::tie( isin, dmin ) = M_refelem.isIn( M_gic->xRef() );
-#endif
+                boost::tie( isin, dmin ) = M_refelem.isIn( gic.xRef() );
         }
     else
         {
-#if 0
-            // get inverse geometric transformation
-            gmc1_inverse_type gic( mesh->gm1(), elt, mpl::int_<1>(), mesh->worldComm().subWorldCommSeqPtr() );
-            //apply the inverse geometric transformation for the point p
-            gic.setXReal( _pt);
-            x_ref=gic.xRef();
-            // the point is in the reference element ?
-            boost::tie( isin, dmin ) = M_refelem1.isIn( gic.xRef() );
-#else
-            M_gic1->update( elt, mpl::int_<1>() );
-            M_gic1->setXReal( _pt);
-            x_ref=M_gic1->xRef();
+            gic1.update( elt, mpl::int_<1>() );
+            gic1.setXReal( _pt);
+            x_ref=gic1.xRef();
             if ( nDim == nRealDim )
-                isin = M_gic1->isIn();
+                isin = gic1.isIn();
             else // in this case, result given with gic->isIn() seems not work (see geomap.hpp)
-                boost::tie( isin, dmin ) = M_refelem1.isIn( M_gic1->xRef() );
-#endif
+                boost::tie( isin, dmin ) = M_refelem1.isIn( gic1.xRef() );
         }
 
     return boost::make_tuple(isin,x_ref,dmin);
@@ -657,6 +715,16 @@ template<typename MeshType>
 boost::tuple<std::vector<bool>, typename Localization<MeshType>::size_type>
 Localization<MeshType>::run_analysis( const matrix_node_type & m,
                                       const size_type & eltHypothetical )
+{
+    if ( M_useBVH && eltHypothetical == invalid_v<size_type> )
+        return this->run_analysis_batch( m );
+    return this->runAnalysisWithKdTree( m, eltHypothetical );
+}
+
+template<typename MeshType>
+boost::tuple<std::vector<bool>, typename Localization<MeshType>::size_type>
+Localization<MeshType>::runAnalysisWithKdTree( const matrix_node_type & m,
+                                               const size_type & eltHypothetical )
 {
     // if no init then init with all geo point
     if ( !( this->isInit() || this->isInitBoundaryFaces() ) )
@@ -760,6 +828,286 @@ Localization<MeshType>::run_analysis( const matrix_node_type & m,
 
 } //run_analysis
 
+template<typename MeshType>
+void
+Localization<MeshType>::initBVH()
+{
+    auto mesh = M_mesh.lock();
+    auto rangeElt = M_rangeElements? *M_rangeElements : elements(mesh);
+
+    static constexpr bool useAffineInverse = mesh_type::element_type::is_simplex && nOrder == 1 && nDim == nRealDim;
+    static constexpr int nAffine = nDim*nDim+nDim;
+
+    std::vector<double> boxes;
+    M_bvhEltIds.clear();
+    M_bvhAffineInverse.clear();
+    for ( auto const& eltWrap : rangeElt )
+    {
+        auto const& elt = unwrap_ref( eltWrap );
+        auto const& G = elt.G();
+        std::array<double,nRealDim> bmin, bmax;
+        bmin.fill( std::numeric_limits<double>::max() );
+        bmax.fill( std::numeric_limits<double>::lowest() );
+        for ( int p=0;p<G.size2();++p )
+            for ( int c=0;c<nRealDim;++c )
+            {
+                bmin[c] = std::min( bmin[c], G( c, p ) );
+                bmax[c] = std::max( bmax[c], G( c, p ) );
+            }
+        // the box is enlarged : a high order element can be curved between its nodes
+        // and a point can be close to a surface element without being on it
+        double h = 0;
+        for ( int c=0;c<nRealDim;++c )
+            h = std::max( h, bmax[c]-bmin[c] );
+        double eps = ( nOrder > 1 || nDim != nRealDim )? 0.1*h : 1e-8*h;
+        for ( int c=0;c<nRealDim;++c )
+            boxes.push_back( bmin[c]-eps );
+        for ( int c=0;c<nRealDim;++c )
+            boxes.push_back( bmax[c]+eps );
+        M_bvhEltIds.push_back( elt.id() );
+
+        if constexpr ( useAffineInverse )
+        {
+            Eigen::Matrix<double,nDim,nDim> K;
+            for ( int i=0;i<nDim;++i )
+                for ( int c=0;c<nDim;++c )
+                    K( c, i ) = G( c, i+1 ) - G( c, 0 );
+            Eigen::Matrix<double,nDim,nDim> Kinv = K.inverse();
+            for ( int i=0;i<nDim;++i )
+                for ( int j=0;j<nDim;++j )
+                    M_bvhAffineInverse.push_back( Kinv( i, j ) );
+            for ( int c=0;c<nDim;++c )
+                M_bvhAffineInverse.push_back( G( c, 0 ) );
+        }
+    }
+    DCHECK( !useAffineInverse || M_bvhAffineInverse.size() == nAffine*M_bvhEltIds.size() ) << "invalid affine data";
+
+    typename WideBVH<nRealDim>::Config config;
+    config.nThreads = ( M_nThreadsBVH > 0 )? M_nThreadsBVH : std::max( 1u, std::thread::hardware_concurrency() );
+    auto bvh = std::make_shared<WideBVH<nRealDim>>( config );
+    bvh->build( boxes );
+    M_bvh = bvh;
+}
+
+template<typename MeshType>
+boost::tuple<std::vector<bool>, typename Localization<MeshType>::size_type>
+Localization<MeshType>::run_analysis_batch( const matrix_node_type & m )
+{
+    // if no init then init with all geo point
+    if ( !( this->isInit() || this->isInitBoundaryFaces() ) )
+        this->updateForUse();
+    // the bvh contains the elements, use the kd tree for the boundary faces
+    if ( !this->isInit() )
+        return this->runAnalysisWithKdTree( m, invalid_v<size_type> );
+    if ( !M_bvh )
+        this->initBVH();
+
+    static constexpr bool useAffineInverse = mesh_type::element_type::is_simplex && nOrder == 1 && nDim == nRealDim;
+    static constexpr int nAffine = nDim*nDim+nDim;
+    // tolerance on the barycentric coordinates
+    static constexpr double tolBarycentric = 1e-7;
+    static constexpr size_type batchSize = 256;
+
+    auto mesh = M_mesh.lock();
+    size_type nPts = m.size2();
+
+    // sort the points along a Morton curve : the points of a batch are close to each other
+    std::array<double,nRealDim> bmin, bmax;
+    bmin.fill( std::numeric_limits<double>::max() );
+    bmax.fill( std::numeric_limits<double>::lowest() );
+    for ( size_type i=0;i<nPts;++i )
+        for ( int c=0;c<nRealDim;++c )
+        {
+            bmin[c] = std::min( bmin[c], m( c, i ) );
+            bmax[c] = std::max( bmax[c], m( c, i ) );
+        }
+    std::vector<std::uint64_t> keys( nPts );
+    std::array<double,nRealDim> x;
+    for ( size_type i=0;i<nPts;++i )
+    {
+        for ( int c=0;c<nRealDim;++c )
+            x[c] = m( c, i );
+        keys[i] = Feel::detail::mortonKey( x, bmin, bmax, nRealDim );
+    }
+    std::vector<size_type> order( nPts );
+    std::iota( order.begin(), order.end(), 0 );
+    std::sort( order.begin(), order.end(), [&keys]( size_type a, size_type b ) { return keys[a] < keys[b]; } );
+
+    // reference coordinates of the vertices of the reference simplex
+    auto const& refVertices = M_refelem.vertices();
+
+    std::vector<size_type> eltFound( nPts, invalid_v<size_type> );
+    std::vector<node_type> xRefFound( nPts, node_type( nDim ) );
+    auto const& bvh = *M_bvh;
+
+    // localise the points order[start:end] by batches
+    auto localiseRange = [&]( size_type start, size_type end, gmc_inverse_type * gic, gmc1_inverse_type * gic1 )
+        {
+            std::vector<size_type> candidatePts;
+            std::vector<std::int32_t> candidatePrims;
+            std::vector<double> lambda;
+            std::array<double,nRealDim> pt;
+            for ( size_type batchStart = start; batchStart < end; batchStart += batchSize )
+            {
+                size_type batchEnd = std::min( end, batchStart+batchSize );
+                if constexpr ( useAffineInverse )
+                {
+                    // collect the candidates of the batch
+                    candidatePts.clear();
+                    candidatePrims.clear();
+                    for ( size_type k=batchStart;k<batchEnd;++k )
+                    {
+                        for ( int c=0;c<nRealDim;++c )
+                            pt[c] = m( c, order[k] );
+                        bvh.visit( pt, [&]( std::int32_t primId ) {
+                                candidatePts.push_back( k );
+                                candidatePrims.push_back( primId );
+                                return false;
+                            } );
+                    }
+                    // barycentric coordinates of all the candidates
+                    size_type nCandidates = candidatePts.size();
+                    lambda.resize( nCandidates*(nDim+1) );
+                    for ( size_type j=0;j<nCandidates;++j )
+                    {
+                        size_type ptId = order[candidatePts[j]];
+                        double const* A = M_bvhAffineInverse.data() + nAffine*candidatePrims[j];
+                        double const* v0 = A + nDim*nDim;
+                        double* l = lambda.data() + j*(nDim+1);
+                        l[0] = 1.;
+                        for ( int i=0;i<nDim;++i )
+                        {
+                            double li = 0;
+                            for ( int c=0;c<nDim;++c )
+                                li += A[i*nDim+c]*( m( c, ptId ) - v0[c] );
+                            l[i+1] = li;
+                            l[0] -= li;
+                        }
+                    }
+                    // the first candidate which contains the point is kept
+                    for ( size_type j=0;j<nCandidates;++j )
+                    {
+                        size_type ptId = order[candidatePts[j]];
+                        if ( eltFound[ptId] != invalid_v<size_type> )
+                            continue;
+                        double const* l = lambda.data() + j*(nDim+1);
+                        if ( *std::min_element( l, l+nDim+1 ) < -tolBarycentric )
+                            continue;
+                        eltFound[ptId] = M_bvhEltIds[candidatePrims[j]];
+                        auto & xRef = xRefFound[ptId];
+                        for ( int c=0;c<nDim;++c )
+                        {
+                            xRef[c] = refVertices( c, 0 );
+                            for ( int i=0;i<nDim;++i )
+                                xRef[c] += l[i+1]*( refVertices( c, i+1 ) - refVertices( c, 0 ) );
+                        }
+                    }
+                }
+                else
+                {
+                    node_type p( nRealDim );
+                    for ( size_type k=batchStart;k<batchEnd;++k )
+                    {
+                        size_type ptId = order[k];
+                        p = ublas::column( m, ptId );
+                        bvh.visit( p, [&]( std::int32_t primId ) {
+                                size_type eltId = M_bvhEltIds[primId];
+                                bool isin = false;
+                                node_type xRef;
+                                double dmin = 0;
+                                boost::tie( isin, xRef, dmin ) = this->isIn( mesh->element( eltId ), p, *gic, *gic1 );
+                                if ( isin )
+                                {
+                                    eltFound[ptId] = eltId;
+                                    xRefFound[ptId] = xRef;
+                                }
+                                return isin;
+                            } );
+                    }
+                }
+            }
+        };
+
+    // the points are split in contiguous chunks, one by thread (each thread has its own inverse geometric transformations)
+    int nThreadsPool = ( M_nThreadsBVH > 0 )? M_nThreadsBVH : std::max( 1u, std::thread::hardware_concurrency() );
+    int nThreads = std::max( 1, std::min<int>( nThreadsPool, ( nPts+batchSize-1 )/batchSize ) );
+    std::vector<std::shared_ptr<gmc_inverse_type>> gics( nThreads );
+    std::vector<std::shared_ptr<gmc1_inverse_type>> gic1s( nThreads );
+    if constexpr ( !useAffineInverse )
+    {
+        if ( !M_bvhEltIds.empty() )
+        {
+            auto const& elt = mesh->element( M_bvhEltIds.front() );
+            for ( int t=0;t<nThreads;++t )
+            {
+                gics[t] = std::make_shared<gmc_inverse_type>( mesh->gm(), elt, mesh->worldComm().subWorldCommSeqPtr() );
+                gic1s[t] = std::make_shared<gmc1_inverse_type>( mesh->gm1(), elt, mpl::int_<1>(), mesh->worldComm().subWorldCommSeqPtr() );
+            }
+        }
+    }
+    if ( nThreads == 1 )
+        localiseRange( 0, nPts, gics[0].get(), gic1s[0].get() );
+    else
+    {
+        // the chunks contain complete batches
+        size_type nBatches = ( nPts+batchSize-1 )/batchSize;
+        auto pool = sharedThreadPool( nThreadsPool );
+        std::vector<std::future<void>> futures;
+        size_type start = 0;
+        for ( int t=0;t<nThreads;++t )
+        {
+            size_type end = std::min( nPts, ( nBatches*(t+1)/nThreads )*batchSize );
+            futures.push_back( pool->submit( [&localiseRange,start,end,gic=gics[t].get(),gic1=gic1s[t].get()]{ localiseRange( start, end, gic, gic1 ); } ) );
+            start = end;
+        }
+        for ( auto& fut : futures )
+            fut.get();
+    }
+
+    M_resultAnalysis.clear();
+    std::vector<bool> hasFindPts( nPts,false );
+    size_type cv_id = invalid_v<size_type>;
+    std::vector<size_type> ptsNotFound;
+    for ( size_type i=0;i<nPts;++i )
+    {
+        if ( eltFound[i] == invalid_v<size_type> )
+        {
+            ptsNotFound.push_back( i );
+            continue;
+        }
+        cv_id = eltFound[i];
+        M_resultAnalysis[cv_id].push_back( boost::make_tuple( i, xRefFound[i] ) );
+        hasFindPts[i] = true;
+    }
+
+    // the points outside of the boxes are searched with the kd tree (with extrapolation if enabled)
+    if ( !ptsNotFound.empty() )
+    {
+        DVLOG(1) << "localisation tool (bvh) : " << ptsNotFound.size() << " points not found in the element boxes";
+        matrix_node_type mNotFound( m.size1(), ptsNotFound.size() );
+        for ( size_type k=0;k<ptsNotFound.size();++k )
+            ublas::column( mNotFound, k ) = ublas::column( m, ptsNotFound[k] );
+        container_search_type resultAnalysisBatch;
+        resultAnalysisBatch.swap( M_resultAnalysis );
+        auto resKdTree = this->runAnalysisWithKdTree( mNotFound, invalid_v<size_type> );
+        for ( auto const& [eltId,ptsInElt] : M_resultAnalysis )
+        {
+            auto & ptsInEltBatch = resultAnalysisBatch[eltId];
+            for ( auto const& ptInElt : ptsInElt )
+            {
+                size_type i = ptsNotFound[boost::get<0>( ptInElt )];
+                ptsInEltBatch.push_back( boost::make_tuple( i, boost::get<1>( ptInElt ) ) );
+                hasFindPts[i] = true;
+            }
+        }
+        M_resultAnalysis.swap( resultAnalysisBatch );
+        if ( boost::get<1>( resKdTree ) != invalid_v<size_type> )
+            cv_id = boost::get<1>( resKdTree );
+    }
+
+    return boost::make_tuple( hasFindPts, cv_id );
+}
+
 
 
 template<typename MeshType>
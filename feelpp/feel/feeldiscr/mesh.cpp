@@ -130,6 +130,10 @@ po::options_description mesh_options( int Dim, std::string const& prefix )
           "use extrapolation if localisation fails" )
         ( prefixvm( prefix, (boost::format("mesh%1%d.localisation.nelt-in-leaf-kdtree") % Dim).str() ).c_str(), Feel::po::value<int>()->default_value(-1),
           "use extrapolation if localisation fails" )
+        ( prefixvm( prefix, (boost::format("mesh%1%d.localisation.use-bvh") % Dim).str() ).c_str(), Feel::po::value<bool>()->default_value(false),
+          "localise a set of points with a bounding volume hierarchy of the elements (batched search)" )
+        ( prefixvm( prefix, (boost::format("mesh%1%d.localisation.bvh.nthreads") % Dim).str() ).c_str(), Feel::po::value<int>()->default_value(1),
+          "number of threads used by the batched localisation (0: hardware concurrency)" )
         ;
     return _options;
 }
@@ -45,6 +45,7 @@
 #include <feel/feelmesh/geoentity.hpp>
 #include <feel/feelmesh/hypercube.hpp>
 #include <feel/feelmesh/simplex.hpp>
+#include <feel/feelmesh/entitiesmatching.hpp>
 #include <feel/feeldiscr/measures.hpp>
 
 namespace Feel
@@ -1051,65 +1052,8 @@ void
     const bool updateComponentAddElements = this->components().test( MESH_ADD_ELEMENTS_INFO );
 
     rank_type currentPid = MeshBase<IndexT>::worldComm().localRank();
-    rank_type numPartition = MeshBase<IndexT>::worldComm().localSize();
-
-    // stores local vertex ids of the faces to identify them
-    std::vector<size_type> lids( face_type::numVertices );
 
-    size_type next_face = 0;
-    bool faceinserted = false;
     const uint16_type _numLocalFaces = this->numLocalFaces();
-    // element_iterator iv,  en;
-    // boost::tie( iv, en ) = this->elementsRange();
-    auto iv = this->beginOrderedElement();
-    auto en = this->endOrderedElement();
-
-    size_type nElt = std::distance( iv, en );
-    typedef std::unordered_map<std::vector /*set*/<size_type>, std::tuple<element_type*, uint16_type, face_type*>, Feel::HashTables::HasherContainers<size_type>> pointstoface_container_type;
-    pointstoface_container_type _faces( nElt * _numLocalFaces );
-    typename pointstoface_container_type::iterator _faceit;
-
-    tic();
-    // First We check if we have already Faces stored
-    if ( !this->faces().empty() )
-    {
-        face_iterator __it = this->beginFace();
-        face_iterator __en = this->endFace();
-        LOG( INFO ) << "We have " << std::distance( __it, __en ) << " faces in the database";
-        for ( ; __it != __en; )
-        {
-            auto& face = __it->second;
-            for ( int f = 0; f < face_type::numVertices; ++f )
-            {
-                lids[f] = face.point( f ).id();
-            }
-            std::sort( lids.begin(), lids.end() );
-
-            boost::tie( _faceit, faceinserted ) = _faces.emplace( std::piecewise_construct,
-                                                                  std::forward_as_tuple( lids ),
-                                                                  std::forward_as_tuple( nullptr, invalid_uint16_type_value, &face ) );
-
-            DVLOG_IF( 2, faceinserted ) << "added face with id " << face.id() << "\n";
-            DVLOG_IF( 2, !faceinserted ) << "not added face with id " << face.id()
-                                         << " was already face with id = " << std::get<2>( _faceit->second )->id() << "\n";
-
-            if ( faceinserted )
-            {
-                next_face = std::max( next_face, face.id() + 1 );
-                ++__it;
-            }
-            else
-            {
-                // if ( __it->hasMarker() && ( !facePtr->hasMarker() || ( __it->marker() != facePtr->marker() ) ) )
-                //     facePtr->setMarker( __it->marker().value() );
-                __it = this->eraseFace( __it );
-            }
-        }
-    }
-    toc( "Mesh.updateEntitiesCoDimensionOne.add_faces", FLAGS_v > 1 );
-
-    bool inserted = false;
-    face_iterator __fit;
 
     std::vector<uint16_type> myfToP( face_type::numVertices * _numLocalFaces );
     for ( uint16_type j = 0; j < _numLocalFaces; j++ )
@@ -1118,150 +1062,176 @@ void
             myfToP[j * face_type::numVertices + f] = ( nDim == 1 ) ? j : /*iv->*/ element_type::fToP( j, f );
     }
 
-    // std::vector< std::set<size_type> > pointsFromFace( this->numLocalFaces() );
-    // std::array<size_type,element_type::numVertices> pointIdInElt;
-    Eigen::Matrix<size_type, element_type::numVertices, 1> pointIdInElt;
-    // for ( uint16_type f = 0; f < element_type::numVertices; ++f )
-    //     pointIdInElt[f] = iv->point( f ).id();
-
-    // std::set<size_type> s;
-    tic();
+    // the faces already stored come first to keep their numbering
+    std::vector<face_type*> existingFaces;
+    existingFaces.reserve( this->faces().size() );
+    for ( auto& [id,face] : this->faces() )
+        existingFaces.push_back( &face );
+    LOG_IF( INFO, !existingFaces.empty() ) << "We have " << existingFaces.size() << " faces in the database";
 
     // get an ordering by process (need in // for have a deterministic choice of face connection (0 and 1) and therfore to define the permutations )
     std::map<rank_type, std::vector<element_type*>, std::less<rank_type>> elementsByProcOrdering;
-    for ( ; iv != en; ++iv )
+    for ( auto iv = this->beginOrderedElement(), en = this->endOrderedElement(); iv != en; ++iv )
     {
         auto& elt = unwrap_ref( *iv );
-        rank_type pid = elt.processId();
-        elementsByProcOrdering[pid].push_back( &elt );
+        elementsByProcOrdering[elt.processId()].push_back( &elt );
     }
-    // iterator over all element
+    std::vector<element_type*> orderedElements;
+    orderedElements.reserve( this->numElements() );
     for ( auto const& elementsByProcPair : elementsByProcOrdering )
+        orderedElements.insert( orderedElements.end(), elementsByProcPair.second.begin(), elementsByProcPair.second.end() );
+    elementsByProcOrdering.clear();
+
+    // the keys are the faces already stored then the faces (element,local face) in the ordering above,
+    // the faces are identified by their vertices
+    tic();
+    const size_type nExistingFaces = existingFaces.size();
+    const size_type nKeys = nExistingFaces + orderedElements.size() * _numLocalFaces;
+    auto firstFace = firstEntityWithSameVertices<face_type::numVertices, size_type>(
+        nKeys,
+        [&]( size_type k, auto& ids )
+        {
+            if ( k < nExistingFaces )
+            {
+                for ( int f = 0; f < face_type::numVertices; ++f )
+                    ids[f] = existingFaces[k]->point( f ).id();
+            }
+            else
+            {
+                element_type const& elt = *orderedElements[( k - nExistingFaces ) / _numLocalFaces];
+                uint16_type j = ( k - nExistingFaces ) % _numLocalFaces;
+                for ( int f = 0; f < face_type::numVertices; ++f )
+                    ids[f] = elt.point( myfToP[j * face_type::numVertices + f] ).id();
+            }
+        },
+        this->nThreadsUpdate() );
+    toc( "Mesh.updateEntitiesCoDimensionOne.match_faces", FLAGS_v > 1 );
+
+    // element connected 0, its local face and face of the first key of each group of identical faces
+    std::vector<std::tuple<element_type*, uint16_type, face_type*>> faceInfos( nKeys, std::make_tuple( nullptr, invalid_uint16_type_value, nullptr ) );
+
+    tic();
+    size_type next_face = 0;
+    for ( size_type k = 0; k < nExistingFaces; ++k )
     {
-        for ( element_type* eltPtr : elementsByProcPair.second )
+        face_type* face = existingFaces[k];
+        if ( firstFace[k] == k )
         {
-            element_type& elt = *eltPtr;
-            const size_type eltId = elt.id();
-            const rank_type eltPid = elt.processId();
+            DVLOG( 2 ) << "added face with id " << face->id() << "\n";
+            std::get<2>( faceInfos[k] ) = face;
+            next_face = std::max( next_face, face->id() + 1 );
+        }
+        else
+        {
+            DVLOG( 2 ) << "not added face with id " << face->id()
+                       << " was already face with id = " << std::get<2>( faceInfos[firstFace[k]] )->id() << "\n";
+            this->eraseFace( this->faceIterator( face->id() ) );
+        }
+    }
+    existingFaces.clear();
+    toc( "Mesh.updateEntitiesCoDimensionOne.add_faces", FLAGS_v > 1 );
 
-            for ( uint16_type f = 0; f < element_type::numVertices; ++f )
-                pointIdInElt[f] = elt.point( f ).id();
+    tic();
+    // iterator over all element
+    for ( size_type e = 0; e < orderedElements.size(); ++e )
+    {
+        element_type* eltPtr = orderedElements[e];
+        element_type& elt = *eltPtr;
+        const size_type eltId = elt.id();
+        const rank_type eltPid = elt.processId();
 
-            for ( uint16_type j = 0; j < _numLocalFaces; j++ )
+        for ( uint16_type j = 0; j < _numLocalFaces; j++ )
+        {
+            const size_type k = nExistingFaces + e * _numLocalFaces + j;
+            if ( firstFace[k] == k )
             {
-#if !defined( NDEBUG )
-                DVLOG( 2 ) << "------------------------------------------------------------\n";
-                DVLOG( 2 ) << "Element id: " << eltId << " local face id: " << j << "\n";
-#endif
-                for ( uint16_type f = 0; f < face_type::numVertices; ++f )
-                {
-                    // uint16_type pt_localid = ( nDim==1 )?j:/*__element.*/element_type::fToP( j, f );
-                    // lids[f]= __element.point( pt_localid ).id();
-                    lids[f] = pointIdInElt[myfToP[j * face_type::numVertices + f]];
+                DVLOG( 2 ) << "creating a new face : " << next_face << "\n";
+
+                face_type newFace;
+                newFace.setId( next_face++ );
+                newFace.setProcessIdInPartition( currentPid );
+                newFace.setProcessId( eltPid );
+                newFace.setOnBoundary( true, face_type::nDim );
+                newFace.setConnection0( boost::make_tuple( &elt, j ) );
+                for ( uint16_type p = 0; p < face_type::numPoints; ++p )
+                    newFace.setPoint( p, elt.point( /*ele.*/ element_type::fToP( j, p ) ) );
+                if ( updateComponentAddElements )
+                    newFace.addElement( eltId );
+                auto res = this->addFace( newFace );
+                auto& faceInserted = res.first->second;
+                elt.setFace( j, faceInserted );
+                faceInfos[k] = std::make_tuple( eltPtr, j, &faceInserted );
 
 #if !defined( NDEBUG )
-                    VLOG( 3 ) << "add point local id " << f << " to face " << j << " " << elt.fToP( j, f )
-                              << " global id " << myfToP[j * face_type::numVertices + f] /*__element.point( pt_localid ).id()*/ << "\n";
+                DVLOG( 2 ) << "Adding [new] face info : \n";
+                DVLOG( 2 ) << "element id: " << eltId << "\n";
+                DVLOG( 2 ) << "process id: " << faceInserted.processId() << "\n";
+                DVLOG( 2 ) << "id: " << faceInserted.id() << "\n";
+                DVLOG( 2 ) << "bdy: " << faceInserted.isOnBoundary() << "\n";
+                DVLOG( 2 ) << "ad_first: " << faceInserted.ad_first() << "\n";
+                DVLOG( 2 ) << "pos_first: " << faceInserted.pos_first() << "\n";
+                DVLOG( 2 ) << "proc_first: " << faceInserted.proc_first() << "\n";
 #endif
-                }
-                std::sort( lids.begin(), lids.end() );
-
-                //boost::tie( _faceit, faceinserted ) = _faces.insert( std::make_pair( lids, nullptr/*next_face*/ ) );
-                boost::tie( _faceit, faceinserted ) = _faces.emplace( std::piecewise_construct,
-                                                                      std::forward_as_tuple( lids ),
-                                                                      std::forward_as_tuple( eltPtr, j, nullptr ) );
+            }
+            else
+            {
+                DVLOG( 2 ) << "found the face in element " << eltId << " and local face: " << j << "\n";
 
-                if ( faceinserted )
+                auto& f2eVal = faceInfos[firstFace[k]];
+                element_type* elt0 = std::get<0>( f2eVal );
+                face_type* facePtr = std::get<2>( f2eVal );
+                if ( !elt0 )
                 {
-                    DVLOG( 2 ) << "creating a new face : " << next_face << "\n";
-
-                    face_type newFace;
-                    newFace.setId( next_face++ );
-                    newFace.setProcessIdInPartition( currentPid );
-                    newFace.setProcessId( eltPid );
-                    newFace.setOnBoundary( true, face_type::nDim );
-                    newFace.setConnection0( boost::make_tuple( &elt, j ) );
-                    for ( size_type k = 0; k < face_type::numPoints; ++k )
-                        newFace.setPoint( k, elt.point( /*ele.*/ element_type::fToP( j, k ) ) );
+                    // the face could have been entered apriori given by
+                    // the mesh generator, so just set the connection0
+                    // properly .
+                    CHECK( facePtr != nullptr ) << "invalid face";
+                    facePtr->setConnection0( boost::make_tuple( eltPtr, j ) );
+                    facePtr->setProcessId( eltPid );
+                    facePtr->setOnBoundary( true, face_type::nDim );
                     if ( updateComponentAddElements )
-                        newFace.addElement( eltId );
-                    auto res = this->addFace( newFace );
-                    auto& faceInserted = res.first->second;
-                    elt.setFace( j, faceInserted );
-                    std::get<2>( _faceit->second ) = &faceInserted;
-
+                        facePtr->addElement( eltId );
+                    std::get<0>( f2eVal ) = &elt;
+                    std::get<1>( f2eVal ) = j;
+                    elt.setFace( j, *facePtr );
 #if !defined( NDEBUG )
-                    DVLOG( 2 ) << "Adding [new] face info : \n";
-                    DVLOG( 2 ) << "element id: " << eltId << "\n";
-                    DVLOG( 2 ) << "process id: " << faceInserted.processId() << "\n";
-                    DVLOG( 2 ) << "id: " << faceInserted.id() << "\n";
-                    DVLOG( 2 ) << "bdy: " << faceInserted.isOnBoundary() << "\n";
-                    DVLOG( 2 ) << "ad_first: " << faceInserted.ad_first() << "\n";
-                    DVLOG( 2 ) << "pos_first: " << faceInserted.pos_first() << "\n";
-                    DVLOG( 2 ) << "proc_first: " << faceInserted.proc_first() << "\n";
+                    DVLOG( 2 ) << "adding [!isConnectedTo0] face info : \n";
+                    DVLOG( 2 ) << "id: " << facePtr->id() << "\n";
+                    DVLOG( 2 ) << "process id: " << facePtr->processId() << "\n";
+                    DVLOG( 2 ) << "bdy: " << facePtr->isOnBoundary() << "\n";
+                    if ( facePtr->hasMarker() )
+                        DVLOG( 2 ) << "marker: " << facePtr->marker() << "\n";
+                    DVLOG( 2 ) << "ad_first: " << facePtr->ad_first() << "\n";
+                    DVLOG( 2 ) << "pos_first: " << facePtr->pos_first() << "\n";
+                    DVLOG( 2 ) << "proc_first: " << facePtr->proc_first() << "\n";
 #endif
                 }
                 else
                 {
-                    DVLOG( 2 ) << "found the face in element " << eltId << " and local face: " << j << "\n";
+                    // found an internal faces
+                    elt0->setNeighbor( std::get<1>( f2eVal ), eltId );
+                    elt.setNeighbor( j, elt0->id() );
 
-#if 0
-                    face_type* facePtr =  _faceit->second;
-                    face_type const& cface = *facePtr;
-                    if ( updateComponentAddElements )
-                        facePtr->addElement( __element_id );
-
-                    // the three conditions below typically arise after reading a serialized mesh
-                    if ( cface.isConnectedTo0() && cface.connection0().template get<0>() == 0 && ( __element_id == cface.ad_first() ) )
-                    {
-                        DVLOG(2) << "fixing connection 0 in face\n";
-                        // reconnect the elements to the face
-                        auto connect0 = facePtr->connection0();
-                        connect0.template get<0>() = boost::addressof( __element );
-                        facePtr->setConnection0( connect0 );
-                    }
-                    if ( cface.isConnectedTo1() && cface.connection1().template get<0>() == 0 && ( __element_id == cface.ad_second() ) )
-                    {
-                        DVLOG(2) << "fixing connection 1 in face\n";
-                        // reconnect the elements to the face
-                        auto connect1 = cface.connection1();
-                        connect1.template get<0>() = boost::addressof( __element );
-                        facePtr->setConnection1( connect1 );
-                    }
-                    if ( cface.isConnectedTo0() && cface.isConnectedTo1() )
+                    CHECK( facePtr && facePtr->isConnectedTo0() ) << "invalid face";
+                    if ( !facePtr->isConnectedTo1() ) // add connection1 to the face
                     {
-                        DVLOG(2) << "internal face, fixing process id if necessary\n";
-                        FEELPP_ASSERT( __element.facePtr( j ) )( j )( __element.id() ).warn( "invalid element face error" );
-                        FEELPP_ASSERT( cface.isConnectedTo0() && cface.isConnectedTo1() )
-                            ( cface.isConnectedTo0() )( cface.isConnectedTo1() ).error ("inconsistent data structure" );
-                        if ( cface.processId()!=MeshBase<IndexT>::worldComm().localRank() )
+                        facePtr->setConnection1( boost::make_tuple( eltPtr, j ) );
+                        facePtr->setOnBoundary( false );
+                        elt.setFace( j, *facePtr );
+                        if ( updateComponentAddElements )
+                            facePtr->addElement( eltId );
+                        // fix duplication of point in connection1 with 3d mesh at order 3 and 4
+                        this->fixPointDuplicationInHOMesh( elt, *facePtr, mpl::bool_ < nDim == 3 && nOrder >= 3 > () );
+
+                        // force processId equal to M_comm.rank() if face on interprocessfaces
+                        if ( facePtr->processId() != currentPid )
                         {
-                            if ( ( cface.element0().processId()==MeshBase<IndexT>::worldComm().localRank() ) ||
-                                 ( cface.element1().processId()==MeshBase<IndexT>::worldComm().localRank() ) )
+                            if ( ( facePtr->element0().processId() == currentPid ) || ( facePtr->element1().processId() == currentPid ) )
                                 facePtr->setProcessId( currentPid );
                         }
-                    }
-#endif
 
-                    auto& f2eVal = _faceit->second;
-                    element_type* elt0 = std::get<0>( f2eVal );
-                    face_type* facePtr = std::get<2>( f2eVal );
-                    if ( !elt0 )
-                    {
-                        // the face could have been entered apriori given by
-                        // the mesh generator, so just set the connection0
-                        // properly .
-                        CHECK( facePtr != nullptr ) << "invalid face";
-                        facePtr->setConnection0( boost::make_tuple( eltPtr, j ) );
-                        facePtr->setProcessId( eltPid );
-                        facePtr->setOnBoundary( true, face_type::nDim );
-                        if ( updateComponentAddElements )
-                            facePtr->addElement( eltId );
-                        std::get<0>( _faceit->second ) = &elt;
-                        std::get<1>( _faceit->second ) = j;
-                        elt.setFace( j, *facePtr );
 #if !defined( NDEBUG )
-                        DVLOG( 2 ) << "adding [!isConnectedTo0] face info : \n";
+                        DVLOG( 2 ) << "adding face info : \n";
                         DVLOG( 2 ) << "id: " << facePtr->id() << "\n";
                         DVLOG( 2 ) << "process id: " << facePtr->processId() << "\n";
                         DVLOG( 2 ) << "bdy: " << facePtr->isOnBoundary() << "\n";
@@ -1270,59 +1240,22 @@ void
                         DVLOG( 2 ) << "ad_first: " << facePtr->ad_first() << "\n";
                         DVLOG( 2 ) << "pos_first: " << facePtr->pos_first() << "\n";
                         DVLOG( 2 ) << "proc_first: " << facePtr->proc_first() << "\n";
+                        DVLOG( 2 ) << "ad_second: " << facePtr->ad_second() << "\n";
+                        DVLOG( 2 ) << "pos_second: " << facePtr->pos_second() << "\n";
+                        DVLOG( 2 ) << "proc_second: " << facePtr->proc_second() << "\n";
 #endif
                     }
-                    else
-                    {
-                        // found an internal faces
-                        elt0->setNeighbor( std::get<1>( f2eVal ), eltId );
-                        elt.setNeighbor( j, elt0->id() );
-
-                        CHECK( facePtr && facePtr->isConnectedTo0() ) << "invalid face";
-                        if ( !facePtr->isConnectedTo1() ) // add connection1 to the face
-                        {
-                            facePtr->setConnection1( boost::make_tuple( eltPtr, j ) );
-                            facePtr->setOnBoundary( false );
-                            elt.setFace( j, *facePtr );
-                            if ( updateComponentAddElements )
-                                facePtr->addElement( eltId );
-                            // fix duplication of point in connection1 with 3d mesh at order 3 and 4
-                            this->fixPointDuplicationInHOMesh( elt, *facePtr, mpl::bool_ < nDim == 3 && nOrder >= 3 > () );
-
-                            // force processId equal to M_comm.rank() if face on interprocessfaces
-                            if ( facePtr->processId() != currentPid )
-                            {
-                                if ( ( facePtr->element0().processId() == currentPid ) || ( facePtr->element1().processId() == currentPid ) )
-                                    facePtr->setProcessId( currentPid );
-                            }
 
 #if !defined( NDEBUG )
-                            DVLOG( 2 ) << "adding face info : \n";
-                            DVLOG( 2 ) << "id: " << facePtr->id() << "\n";
-                            DVLOG( 2 ) << "process id: " << facePtr->processId() << "\n";
-                            DVLOG( 2 ) << "bdy: " << facePtr->isOnBoundary() << "\n";
-                            if ( facePtr->hasMarker() )
-                                DVLOG( 2 ) << "marker: " << facePtr->marker() << "\n";
-                            DVLOG( 2 ) << "ad_first: " << facePtr->ad_first() << "\n";
-                            DVLOG( 2 ) << "pos_first: " << facePtr->pos_first() << "\n";
-                            DVLOG( 2 ) << "proc_first: " << facePtr->proc_first() << "\n";
-                            DVLOG( 2 ) << "ad_second: " << facePtr->ad_second() << "\n";
-                            DVLOG( 2 ) << "pos_second: " << facePtr->pos_second() << "\n";
-                            DVLOG( 2 ) << "proc_second: " << facePtr->proc_second() << "\n";
+                    CHECK( ( facePtr->processId() == facePtr->proc_first() ) ||
+                           ( facePtr->processId() == facePtr->proc_second() ) )
+                        << "invalid process id " << facePtr->processId() << " with element proc first = " << facePtr->proc_first()
+                        << " and element proc second " << facePtr->proc_second();
 #endif
-                        }
-
-#if !defined( NDEBUG )
-                        CHECK( ( facePtr->processId() == facePtr->proc_first() ) ||
-                               ( facePtr->processId() == facePtr->proc_second() ) )
-                            << "invalid process id " << facePtr->processId() << " with element proc first = " << facePtr->proc_first()
-                            << " and element proc second " << facePtr->proc_second();
-#endif
-                    }
                 }
-            } // face loop
-        }     // element loop
-    }
+            }
+        } // face loop
+    }     // element loop
     toc( "Mesh.updateEntitiesCoDimensionOne.add_faces_from_elements", FLAGS_v > 1 );
     DVLOG( 2 ) << "[Mesh::updateFaces] finish elements loop";
 
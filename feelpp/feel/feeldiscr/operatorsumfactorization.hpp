@@ -0,0 +1,673 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+
+  This file is part of the Feel++ library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3.0 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#ifndef FEELPP_DISCR_OPERATORSUMFACTORIZATION_H
+#define FEELPP_DISCR_OPERATORSUMFACTORIZATION_H 1
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <feel/feelalg/matrixshell.hpp>
+#include <feel/feeldiscr/functionspace.hpp>
+#include <feel/feelpoly/jacobi.hpp>
+
+namespace Feel
+{
+namespace detail
+{
+/**
+ * 1D Lagrange basis associated to \p nodes and its derivative evaluated at
+ * \p pts : \c B[q*n+i] and \c D[q*n+i] are the values of the i-th basis
+ * function and of its derivative at the q-th point (n is the number of nodes)
+ */
+inline void
+lagrangeBasis1D( std::vector<double> const& nodes, std::vector<double> const& pts,
+                 std::vector<double>& B, std::vector<double>& D )
+{
+    int n = nodes.size(), nq = pts.size();
+    B.assign( nq*n, 0. );
+    D.assign( nq*n, 0. );
+    for ( int q = 0; q < nq; ++q )
+    {
+        for ( int i = 0; i < n; ++i )
+        {
+            double b = 1;
+            for ( int j = 0; j < n; ++j )
+                if ( j != i )
+                    b *= ( pts[q]-nodes[j] )/( nodes[i]-nodes[j] );
+            B[q*n+i] = b;
+            double d = 0;
+            for ( int k = 0; k < n; ++k )
+            {
+                if ( k == i )
+                    continue;
+                double t = 1./( nodes[i]-nodes[k] );
+                for ( int j = 0; j < n; ++j )
+                    if ( j != i && j != k )
+                        t *= ( pts[q]-nodes[j] )/( nodes[i]-nodes[j] );
+                d += t;
+            }
+            D[q*n+i] = d;
+        }
+    }
+}
+
+/**
+ * contract one direction of the array \p in of sizes (pre,m,post) with the
+ * matrix M of size r x m : out(i,b,p) = sum_a M(b,a) in(i,a,p) where
+ * M(b,a) = M[b*sb+a*sa], the first index is the fastest
+ */
+inline void
+contractDirection( double const* M, int sb, int sa, int r, int m, int pre, int post,
+                   double const* in, double* out )
+{
+    for ( int p = 0; p < post; ++p )
+    {
+        double const* inp = in + pre*m*p;
+        double* outp = out + pre*r*p;
+        for ( int b = 0; b < r; ++b )
+        {
+            double* o = outp + pre*b;
+            std::fill( o, o+pre, 0. );
+            for ( int a = 0; a < m; ++a )
+            {
+                double c = M[b*sb+a*sa];
+                double const* ia = inp + pre*a;
+                for ( int i = 0; i < pre; ++i )
+                    o[i] += c*ia[i];
+            }
+        }
+    }
+}
+
+/**
+ * apply the tensor product \f$A_{Dim-1} \otimes \dots \otimes A_0\f$ of the
+ * r x m matrices \p A (row major) to \p in, or its transpose if \p transpose.
+ * \p work must hold 2*max(r,m)^Dim values.
+ */
+template<int Dim>
+void
+tensorApply( std::array<double const*,Dim> const& A, int r, int m, bool transpose,
+             double const* in, double* out, double* work )
+{
+    int nRows = transpose? m : r;
+    int nCols = transpose? r : m;
+    int sb = transpose? 1 : m;
+    int sa = transpose? m : 1;
+    int s = std::max( r, m ), sDim = 1;
+    for ( int k = 0; k < Dim; ++k )
+        sDim *= s;
+    std::array<int,Dim> sizes;
+    sizes.fill( nCols );
+    double const* src = in;
+    for ( int k = 0; k < Dim; ++k )
+    {
+        int pre = 1, post = 1;
+        for ( int l = 0; l < k; ++l )
+            pre *= sizes[l];
+        for ( int l = k+1; l < Dim; ++l )
+            post *= sizes[l];
+        double* dst = ( k == Dim-1 )? out : work + ( k%2 )*sDim;
+        contractDirection( A[k], sb, sa, nRows, nCols, pre, post, src, dst );
+        sizes[k] = nRows;
+        src = dst;
+    }
+}
+
+/**
+ * @brief operator of an element applied by sum factorisation
+ *
+ * The NComp components of the fields are stored in lexicographic order of the
+ * tensor product of the n 1D nodes (first direction fastest). The geometric
+ * data of the element are, for each of the nq^Dim quadrature points (same
+ * order), the weight times the jacobian and the matrix \f$B = K^{-T}\f$ (row
+ * major, \f$\nabla_x = B \nabla_{\hat x}\f$), i.e. 1+Dim*Dim values.
+ *
+ * The operator is
+ * \f[ \int_K c\, u\cdot v + k\, \nabla u : \nabla v + (\beta\cdot\nabla) u \cdot v
+ *     + 2\mu\, \epsilon(u):\epsilon(v) + \lambda\, \nabla\cdot u\, \nabla\cdot v \f]
+ * the elasticity terms are only available if NComp == Dim.
+ */
+template<int Dim, int NComp>
+class SumFactorizationLocalOperator
+{
+public:
+    static constexpr int nGeometricData = 1+Dim*Dim;
+
+    SumFactorizationLocalOperator() = default;
+
+    /**
+     * \p nodes are the 1D nodes of the basis and \p nq the number of
+     * Gauss-Legendre points by direction
+     */
+    SumFactorizationLocalOperator( std::vector<double> const& nodes, int nq )
+        :
+        M_n( nodes.size() ),
+        M_nq( nq ),
+        M_nLocalDof( ipow( M_n ) ),
+        M_nPoints( ipow( M_nq ) )
+        {
+            M_weights.resize( nq );
+            M_points.resize( nq );
+            Feel::details::dyna::gaussjacobi( nq, M_weights, M_points, 0.0, 0.0 );
+            lagrangeBasis1D( nodes, M_points, M_B, M_D );
+            M_BB.resize( M_B.size() );
+            M_BD.resize( M_B.size() );
+            M_DD.resize( M_B.size() );
+            for ( std::size_t k = 0; k < M_B.size(); ++k )
+            {
+                M_BB[k] = M_B[k]*M_B[k];
+                M_BD[k] = M_B[k]*M_D[k];
+                M_DD[k] = M_D[k]*M_D[k];
+            }
+            int s = ipow( std::max( M_n, M_nq ) );
+            M_work.resize( 2*s );
+            M_tmp.resize( s );
+            M_values.resize( NComp*M_nPoints );
+            M_grads.resize( NComp*Dim*M_nPoints );
+        }
+
+    int nNodes1D() const { return M_n; }
+    int nPoints1D() const { return M_nq; }
+    //! number of nodes of the element (by component)
+    int nLocalDof() const { return M_nLocalDof; }
+    //! number of quadrature points of the element
+    int nPoints() const { return M_nPoints; }
+    //! Gauss-Legendre points and weights on [-1,1]
+    std::vector<double> const& points1D() const { return M_points; }
+    std::vector<double> const& weights1D() const { return M_weights; }
+
+    void setMass( double c ) { M_mass = c; }
+    void setDiffusion( double k ) { M_diffusion = k; }
+    void setConvection( std::array<double,Dim> const& beta )
+        {
+            M_convection = beta;
+            M_hasConvection = std::any_of( beta.begin(), beta.end(), []( double b ) { return b != 0; } );
+        }
+    void setElasticity( double lambda, double mu )
+        {
+            CHECK( NComp == Dim || ( lambda == 0 && mu == 0 ) ) << "elasticity requires a vectorial field";
+            M_lambda = lambda;
+            M_mu = mu;
+        }
+
+    /**
+     * \p v = A \p u where A is the operator of the element described by the
+     * geometric data \p geo
+     */
+    void apply( double const* geo, double const* u, double* v )
+        {
+            std::array<double const*,Dim> A;
+            // values and reference gradients at the quadrature points
+            for ( int c = 0; c < NComp; ++c )
+            {
+                double const* uc = u + c*M_nLocalDof;
+                if ( M_mass != 0 || M_hasConvection )
+                {
+                    A.fill( M_B.data() );
+                    tensorApply<Dim>( A, M_nq, M_n, false, uc, M_values.data()+c*M_nPoints, M_work.data() );
+                }
+                else
+                    std::fill( M_values.begin()+c*M_nPoints, M_values.begin()+(c+1)*M_nPoints, 0. );
+                for ( int p = 0; p < Dim; ++p )
+                {
+                    A.fill( M_B.data() );
+                    A[p] = M_D.data();
+                    tensorApply<Dim>( A, M_nq, M_n, false, uc, M_grads.data()+( c*Dim+p )*M_nPoints, M_work.data() );
+                }
+            }
+
+            // quadrature point kernel
+            for ( int q = 0; q < M_nPoints; ++q )
+            {
+                double const* g = geo + q*nGeometricData;
+                double wJ = g[0];
+                double const* Bq = g+1;
+                double gx[NComp][Dim];
+                for ( int c = 0; c < NComp; ++c )
+                    for ( int n = 0; n < Dim; ++n )
+                    {
+                        gx[c][n] = 0;
+                        for ( int p = 0; p < Dim; ++p )
+                            gx[c][n] += Bq[n*Dim+p]*M_grads[( c*Dim+p )*M_nPoints+q];
+                    }
+                double flux[NComp][Dim];
+                for ( int c = 0; c < NComp; ++c )
+                {
+                    double f = M_mass*M_values[c*M_nPoints+q];
+                    for ( int n = 0; n < Dim; ++n )
+                    {
+                        f += M_convection[n]*gx[c][n];
+                        flux[c][n] = M_diffusion*gx[c][n];
+                    }
+                    M_values[c*M_nPoints+q] = wJ*f;
+                }
+                if constexpr ( NComp == Dim )
+                {
+                    if ( M_lambda != 0 || M_mu != 0 )
+                    {
+                        double div = 0;
+                        for ( int n = 0; n < Dim; ++n )
+                            div += gx[n][n];
+                        for ( int c = 0; c < NComp; ++c )
+                        {
+                            for ( int n = 0; n < Dim; ++n )
+                                flux[c][n] += M_mu*( gx[c][n]+gx[n][c] );
+                            flux[c][c] += M_lambda*div;
+                        }
+                    }
+                }
+                // back to the reference gradient of the test functions
+                for ( int c = 0; c < NComp; ++c )
+                    for ( int p = 0; p < Dim; ++p )
+                    {
+                        double r = 0;
+                        for ( int n = 0; n < Dim; ++n )
+                            r += flux[c][n]*Bq[n*Dim+p];
+                        M_grads[( c*Dim+p )*M_nPoints+q] = wJ*r;
+                    }
+            }
+
+            // integration against the test functions
+            for ( int c = 0; c < NComp; ++c )
+            {
+                double* vc = v + c*M_nLocalDof;
+                std::fill( vc, vc+M_nLocalDof, 0. );
+                if ( M_mass != 0 || M_hasConvection )
+                {
+                    A.fill( M_B.data() );
+                    tensorApply<Dim>( A, M_nq, M_n, true, M_values.data()+c*M_nPoints, vc, M_work.data() );
+                }
+                for ( int p = 0; p < Dim; ++p )
+                {
+                    A.fill( M_B.data() );
+                    A[p] = M_D.data();
+                    tensorApply<Dim>( A, M_nq, M_n, true, M_grads.data()+( c*Dim+p )*M_nPoints, M_tmp.data(), M_work.data() );
+                    for ( int i = 0; i < M_nLocalDof; ++i )
+                        vc[i] += M_tmp[i];
+                }
+            }
+        }
+
+    /**
+     * diagonal of the operator of the element. The product of two basis
+     * functions (or of their derivatives) is a tensor product of products of
+     * 1D functions, so each term of the diagonal is the transposed tensor
+     * product of the squared 1D matrices (\f$B^2\f$, \f$BD\f$, \f$D^2\f$)
+     * applied to a field at the quadrature points : O(Dim^2 p^{Dim+1}) operations.
+     */
+    void diagonal( double const* geo, double* d )
+        {
+            std::array<double const*,Dim> A;
+            double* field = M_values.data();
+            // add to dc the contraction of field with the squared 1D matrices
+            // (BD in the directions p and pp if p != pp, DD in the direction p if p == pp)
+            auto addTerm = [&]( double* dc, int p, int pp )
+                {
+                    A.fill( M_BB.data() );
+                    if ( p >= 0 && p == pp )
+                        A[p] = M_DD.data();
+                    else
+                    {
+                        if ( p >= 0 )
+                            A[p] = M_BD.data();
+                        if ( pp >= 0 )
+                            A[pp] = M_BD.data();
+                    }
+                    tensorApply<Dim>( A, M_nq, M_n, true, field, M_tmp.data(), M_work.data() );
+                    for ( int i = 0; i < M_nLocalDof; ++i )
+                        dc[i] += M_tmp[i];
+                };
+
+            bool hasElasticity = ( NComp == Dim ) && ( M_lambda != 0 || M_mu != 0 );
+            for ( int c = 0; c < NComp; ++c )
+            {
+                double* dc = d + c*M_nLocalDof;
+                // without elasticity, the diagonal is the same for all the components
+                if ( c > 0 && !hasElasticity )
+                {
+                    std::copy( d, d+M_nLocalDof, dc );
+                    continue;
+                }
+                std::fill( dc, dc+M_nLocalDof, 0. );
+                if ( M_mass != 0 )
+                {
+                    for ( int q = 0; q < M_nPoints; ++q )
+                        field[q] = M_mass*geo[q*nGeometricData];
+                    addTerm( dc, -1, -1 );
+                }
+                if ( M_hasConvection )
+                {
+                    for ( int p = 0; p < Dim; ++p )
+                    {
+                        for ( int q = 0; q < M_nPoints; ++q )
+                        {
+                            double const* g = geo + q*nGeometricData;
+                            double bp = 0;
+                            for ( int n = 0; n < Dim; ++n )
+                                bp += M_convection[n]*g[1+n*Dim+p];
+                            field[q] = g[0]*bp;
+                        }
+                        addTerm( dc, p, -1 );
+                    }
+                }
+                // gradient terms : (k+mu) |grad phi|^2 + (mu+lambda) (d_c phi)^2
+                double coeffGrad = M_diffusion + ( hasElasticity? M_mu : 0. );
+                double coeffComp = hasElasticity? M_mu + M_lambda : 0.;
+                if ( coeffGrad == 0 && coeffComp == 0 )
+                    continue;
+                for ( int p = 0; p < Dim; ++p )
+                {
+                    for ( int pp = p; pp < Dim; ++pp )
+                    {
+                        for ( int q = 0; q < M_nPoints; ++q )
+                        {
+                            double const* g = geo + q*nGeometricData;
+                            double const* Bq = g+1;
+                            double m = 0;
+                            for ( int n = 0; n < Dim; ++n )
+                                m += Bq[n*Dim+p]*Bq[n*Dim+pp];
+                            m = coeffGrad*m + coeffComp*Bq[c*Dim+p]*Bq[c*Dim+pp];
+                            field[q] = ( ( p == pp )? 1. : 2. )*g[0]*m;
+                        }
+                        addTerm( dc, p, pp );
+                    }
+                }
+            }
+        }
+
+private:
+    static int ipow( int a )
+        {
+            int r = 1;
+            for ( int k = 0; k < Dim; ++k )
+                r *= a;
+            return r;
+        }
+
+private:
+    int M_n = 0, M_nq = 0, M_nLocalDof = 0, M_nPoints = 0;
+    std::vector<double> M_points, M_weights;
+    std::vector<double> M_B, M_D;
+    double M_mass = 0, M_diffusion = 0, M_lambda = 0, M_mu = 0;
+    std::array<double,Dim> M_convection = {};
+    bool M_hasConvection = false;
+    std::vector<double> M_BB, M_BD, M_DD;
+    std::vector<double> M_work, M_tmp, M_values, M_grads;
+};
+
+} // namespace detail
+
+/**
+ * \class OperatorSumFactorization
+ * \brief matrix-free operator on a tensor product (hypercube) Lagrange space
+ *
+ * The operator (mass, diffusion, convection by a constant field, linear
+ * elasticity for a vectorial space, see detail::SumFactorizationLocalOperator)
+ * is applied element by element by sum factorisation : the values and the
+ * gradients at the Gauss points are interpolated direction by direction, which
+ * costs O(p^{d+1}) operations by element instead of O(p^{2d}) for an element
+ * matrix. Only the geometric data at the quadrature points are stored, that is
+ * O(p^d) values by element instead of the O(p^{2d}) entries of the element matrix.
+ *
+ * \code
+ * auto Vh = Pch<4>( mesh ); // mesh of hypercubes
+ * auto op = opSumFactorization( Vh );
+ * op->setDiffusion( 1. );
+ * op->setMass( 1. );
+ * op->multVector( u, v );
+ * \endcode
+ */
+template<typename SpaceType>
+class OperatorSumFactorization : public MatrixShell<typename SpaceType::value_type>
+{
+    using super_type = MatrixShell<typename SpaceType::value_type>;
+public:
+    using space_type = SpaceType;
+    using space_ptrtype = std::shared_ptr<space_type>;
+    using value_type = typename space_type::value_type;
+    using vector_type = typename super_type::vector_type;
+    using mesh_type = typename space_type::mesh_type;
+    using fe_type = typename space_type::fe_type;
+    using gm_type = typename space_type::gm_type;
+
+    static constexpr uint16_type nDim = space_type::nDim;
+    static constexpr uint16_type nComponents = space_type::nComponents;
+    //! number of local dofs by component
+    static constexpr uint16_type nLocalDof = fe_type::nLocalDof;
+
+    static_assert( space_type::convex_type::is_hypercube, "sum factorisation requires a hypercube mesh" );
+    static_assert( nDim == space_type::nRealDim, "sum factorisation requires nDim == nRealDim" );
+    static_assert( std::is_same_v<value_type,double>, "sum factorisation is implemented for double" );
+
+    using local_operator_type = detail::SumFactorizationLocalOperator<nDim,nComponents>;
+
+    /**
+     * build the operator on the elements of \p Xh with \p nQuadPoints1D Gauss
+     * points by direction (the polynomial order + 1 by default)
+     */
+    explicit OperatorSumFactorization( space_ptrtype const& Xh, int nQuadPoints1D = -1 )
+        :
+        super_type(),
+        M_space( Xh )
+        {
+            this->initBasis( ( nQuadPoints1D > 0 )? nQuadPoints1D : fe_type::nOrder+1 );
+            this->initGeometricData();
+        }
+
+    space_ptrtype const& functionSpace() const { return M_space; }
+
+    //! coefficient of the mass term
+    void setMass( double c ) { M_localOperator.setMass( c ); M_diagonal.reset(); }
+    //! coefficient of the diffusion term
+    void setDiffusion( double k ) { M_localOperator.setDiffusion( k ); M_diagonal.reset(); }
+    //! constant convection field
+    void setConvection( std::array<double,nDim> const& beta ) { M_localOperator.setConvection( beta ); M_diagonal.reset(); }
+    //! Lamé coefficients of the elasticity term (vectorial space)
+    void setElasticity( double lambda, double mu ) { M_localOperator.setElasticity( lambda, mu ); M_diagonal.reset(); }
+
+    //! number of 1D nodes of the basis
+    int nNodes1D() const { return M_localOperator.nNodes1D(); }
+    //! number of Gauss points by direction
+    int nPoints1D() const { return M_localOperator.nPoints1D(); }
+    //! number of values stored by element
+    size_type nStoredValuesByElement() const { return M_localOperator.nPoints()*local_operator_type::nGeometricData; }
+
+    size_type size1() const override { return M_space->nDof(); }
+    size_type size2() const override { return M_space->nDof(); }
+
+    void diagonal( vector_type& d ) const override
+        {
+            if ( !M_diagonal )
+            {
+                M_diagonal = M_space->elementPtr();
+                M_diagonal->zero();
+                this->forEachElement( [&]( size_type k, auto const& indices, double const* geo )
+                                      {
+                                          M_localOperator.diagonal( geo, M_ve.data() );
+                                          this->scatter( M_ve.data(), indices, *M_diagonal );
+                                      } );
+                M_diagonal->close();
+                sync( *M_diagonal, "+" );
+            }
+            d = *M_diagonal;
+        }
+
+    void multVector( vector_type const& in, vector_type& out ) const override
+        {
+            if ( !M_u )
+            {
+                M_u = M_space->elementPtr();
+                M_v = M_space->elementPtr();
+            }
+            *M_u = in;
+            sync( *M_u, "=" );
+            M_v->zero();
+            this->forEachElement( [&]( size_type k, auto const& indices, double const* geo )
+                                  {
+                                      for ( int c = 0; c < nComponents; ++c )
+                                          for ( int i = 0; i < nLocalDof; ++i )
+                                              M_ue[c*nLocalDof+i] = M_u->operator()( indices( c*nLocalDof+M_lexToLocal[i] ) );
+                                      M_localOperator.apply( geo, M_ue.data(), M_ve.data() );
+                                      this->scatter( M_ve.data(), indices, *M_v );
+                                  } );
+            sync( *M_v, "+" );
+            out = *M_v;
+        }
+
+    void multAddVector( vector_type const& in, vector_type& out ) const override
+        {
+            if ( !M_w )
+                M_w = M_space->elementPtr();
+            this->multVector( in, *M_w );
+            out.add( 1., *M_w );
+        }
+
+private:
+    //! 1D nodes of the basis and lexicographic numbering of the local dofs
+    void initBasis( int nq )
+        {
+            auto const& pts = M_space->fe()->points();
+            CHECK( pts.size2() == nLocalDof ) << "invalid number of points " << pts.size2() << " != " << nLocalDof;
+            std::vector<double> nodes;
+            for ( int i = 0; i < nLocalDof; ++i )
+                nodes.push_back( pts( 0, i ) );
+            std::sort( nodes.begin(), nodes.end() );
+            nodes.erase( std::unique( nodes.begin(), nodes.end(),
+                                      []( double a, double b ) { return std::abs( a-b ) < 1e-10; } ),
+                         nodes.end() );
+            int n = nodes.size();
+            auto nodeIndex = [&nodes]( double x ) {
+                auto it = std::find_if( nodes.begin(), nodes.end(), [x]( double y ) { return std::abs( x-y ) < 1e-10; } );
+                CHECK( it != nodes.end() ) << "the nodes of the element are not a tensor product";
+                return int( it-nodes.begin() );
+            };
+            M_lexToLocal.assign( nLocalDof, invalid_uint16_type_value );
+            for ( int i = 0; i < nLocalDof; ++i )
+            {
+                int lex = 0;
+                for ( int k = nDim-1; k >= 0; --k )
+                    lex = lex*n + nodeIndex( pts( k, i ) );
+                CHECK( lex < nLocalDof && M_lexToLocal[lex] == invalid_uint16_type_value )
+                    << "the nodes of the element are not a tensor product";
+                M_lexToLocal[lex] = i;
+            }
+            M_localOperator = local_operator_type( nodes, nq );
+            M_ue.resize( nComponents*nLocalDof );
+            M_ve.resize( nComponents*nLocalDof );
+        }
+
+    //! weight times jacobian and \f$B\f$ at the Gauss points of each element
+    void initGeometricData()
+        {
+            int nq = M_localOperator.nPoints1D();
+            int nPoints = M_localOperator.nPoints();
+            auto const& pts1D = M_localOperator.points1D();
+            auto const& w1D = M_localOperator.weights1D();
+            typename matrix_node<value_type>::type pts( nDim, nPoints );
+            std::vector<double> weights( nPoints );
+            for ( int q = 0; q < nPoints; ++q )
+            {
+                weights[q] = 1;
+                for ( int k = 0, r = q; k < nDim; ++k, r /= nq )
+                {
+                    pts( k, q ) = pts1D[r%nq];
+                    weights[q] *= w1D[r%nq];
+                }
+            }
+
+            auto mesh = M_space->mesh();
+            auto gm = M_space->gm();
+            typename gm_type::precompute_ptrtype geopc( new typename gm_type::precompute_type( gm, pts ) );
+            static const size_type gmc_v = vm::JACOBIAN|vm::KB;
+            using gmc_type = typename gm_type::template Context<typename mesh_type::element_type>;
+            std::shared_ptr<gmc_type> ctx;
+
+            int nGeo = local_operator_type::nGeometricData;
+            M_eltIds.clear();
+            M_geometricData.clear();
+            for ( auto const& eltWrap : elements( mesh ) )
+            {
+                auto const& elt = unwrap_ref( eltWrap );
+                if ( ctx )
+                    ctx->template update<gmc_v>( elt );
+                else
+                    ctx = gm->template context<gmc_v>( elt, geopc );
+                M_eltIds.push_back( elt.id() );
+                size_type start = M_geometricData.size();
+                M_geometricData.resize( start + nPoints*nGeo );
+                for ( int q = 0; q < nPoints; ++q )
+                {
+                    double* g = M_geometricData.data() + start + q*nGeo;
+                    g[0] = weights[q]*ctx->J( q );
+                    auto const& B = ctx->B( q );
+                    for ( int n = 0; n < nDim; ++n )
+                        for ( int p = 0; p < nDim; ++p )
+                            g[1+n*nDim+p] = B( n, p );
+                }
+            }
+            DVLOG(1) << "[OperatorSumFactorization] " << M_eltIds.size() << " elements, "
+                     << this->nStoredValuesByElement() << " values by element";
+        }
+
+    //! apply \p f( k, indices, geo ) on each element
+    template<typename FuncType>
+    void forEachElement( FuncType&& f ) const
+        {
+            size_type nGeo = this->nStoredValuesByElement();
+            for ( size_type k = 0; k < M_eltIds.size(); ++k )
+                f( k, M_space->dof()->localToGlobalIndices( M_eltIds[k] ), M_geometricData.data() + k*nGeo );
+        }
+
+    //! add the lexicographic local vector \p ve to \p v
+    template<typename IndicesType>
+    void scatter( double const* ve, IndicesType const& indices, vector_type& v ) const
+        {
+            for ( int c = 0; c < nComponents; ++c )
+                for ( int i = 0; i < nLocalDof; ++i )
+                    v.add( indices( c*nLocalDof+M_lexToLocal[i] ), ve[c*nLocalDof+i] );
+        }
+
+private:
+    space_ptrtype M_space;
+    mutable local_operator_type M_localOperator;
+    std::vector<uint16_type> M_lexToLocal;
+    std::vector<size_type> M_eltIds;
+    std::vector<double> M_geometricData;
+    //! workspaces reused by the products
+    mutable std::shared_ptr<typename space_type::element_type> M_u, M_v, M_w, M_diagonal;
+    mutable std::vector<double> M_ue, M_ve;
+};
+
+/**
+ * \return the sum factorisation operator on \p Xh
+ */
+template<typename SpaceType>
+std::shared_ptr<OperatorSumFactorization<SpaceType>>
+opSumFactorization( std::shared_ptr<SpaceType> const& Xh, int nQuadPoints1D = -1 )
+{
+    return std::make_shared<OperatorSumFactorization<SpaceType>>( Xh, nQuadPoints1D );
+}
+
+} // namespace Feel
+
+#endif /* FEELPP_DISCR_OPERATORSUMFACTORIZATION_H */
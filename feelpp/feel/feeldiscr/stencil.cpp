@@ -28,6 +28,7 @@
    \date 2012-04-07
  */
 #include <sstream>
+#include <unordered_map>
 #include <feel/feeldiscr/stencil.hpp>
 
 namespace Feel
@@ -125,6 +126,82 @@ stencilManagerPrint()
     std::cout << "********************************************************************************\n";
 }
 
+std::vector<StencilTopology::size_type>
+StencilTopology::matchCouplings( StencilTopology const& t ) const
+{
+    std::unordered_map<index_type,std::vector<size_type>> couplingsOfTestElt;
+    for ( size_type kt = 0; kt < t.nCouplings(); ++kt )
+        couplingsOfTestElt[t.testEltIds[kt]].push_back( kt );
+
+    std::vector<size_type> match( this->nCouplings(), invalid_v<size_type> );
+    std::unordered_map<index_type,size_type> rankInTestElt;
+    for ( size_type k = 0; k < this->nCouplings(); ++k )
+    {
+        size_type rank = rankInTestElt[testEltIds[k]]++;
+        auto itFind = couplingsOfTestElt.find( testEltIds[k] );
+        if ( itFind != couplingsOfTestElt.end() && rank < itFind->second.size() )
+            match[k] = itFind->second[rank];
+    }
+    return match;
+}
+
+StencilTopology::size_type
+StencilTopology::nChanges( StencilTopology const& t ) const
+{
+    auto match = this->matchCouplings( t );
+    size_type nSame = 0;
+    for ( size_type k = 0; k < this->nCouplings(); ++k )
+        if ( match[k] != invalid_v<size_type> && this->isSameCoupling( k, t, match[k] ) )
+            ++nSame;
+    return ( this->nCouplings() - nSame ) + ( t.nCouplings() - nSame );
+}
+
+void
+StencilTopology::updateChangedRows( StencilTopology const& t, std::vector<bool>& rowsToUpdate ) const
+{
+    auto match = this->matchCouplings( t );
+    std::vector<bool> isSameInT( t.nCouplings(), false );
+    for ( size_type k = 0; k < this->nCouplings(); ++k )
+    {
+        if ( match[k] != invalid_v<size_type> && this->isSameCoupling( k, t, match[k] ) )
+            isSameInT[match[k]] = true;
+        else
+            for ( size_type r = rowsPtr[k]; r < rowsPtr[k+1]; ++r )
+                rowsToUpdate[rows[r]] = true;
+    }
+    for ( size_type kt = 0; kt < t.nCouplings(); ++kt )
+    {
+        if ( isSameInT[kt] )
+            continue;
+        for ( size_type r = t.rowsPtr[kt]; r < t.rowsPtr[kt+1]; ++r )
+            if ( t.rows[r] < rowsToUpdate.size() )
+                rowsToUpdate[t.rows[r]] = true;
+    }
+    // the rows which do not exist in t
+    for ( size_type i = t.nRows; i < rowsToUpdate.size(); ++i )
+        rowsToUpdate[i] = true;
+}
+
+void
+stencilTopologyCacheClear()
+{
+    VLOG(1) << "Deleting " << StencilTopologyCache::instance().size() << " entries of the stencil topology cache";
+    StencilTopologyCache::instance().clear();
+}
+
+StencilTopologyCacheImpl&
+stencilTopologyCache()
+{
+    // the cache is cleared when the Environment is deleted (before MPI is finalized)
+    static bool observed = false;
+    if ( !observed )
+    {
+        Environment::addDeleteObserver( &stencilTopologyCacheClear );
+        observed = true;
+    }
+    return StencilTopologyCache::instance();
+}
+
 StencilRangeMap0Type
 stencilRangeMap( )
 {
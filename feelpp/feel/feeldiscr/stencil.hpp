@@ -29,11 +29,13 @@
 #if FEELPP_EXPORT_GRAPH
 #include <feel/feelfilters/exporter.hpp>
 #endif
+#include <list>
 #include <type_traits>
 #include <feel/feelvf/pattern.hpp>
 #include <feel/feelalg/graphcsr.hpp>
 #include <feel/feeldiscr/functionspace.hpp>
 
+#include <boost/functional/hash.hpp>
 #include <boost/hana.hpp>
 #include <boost/hana/integral_constant.hpp>
 
@@ -386,7 +388,9 @@ public:
         M_graph( new graph_type( Xh->dof(),Yh->dof() ) ),
         M_block_pattern( block_pattern ),
         M_rangeIteratorTest( r ),
-        M_rangeIteratorExtended( rangeExtended )
+        M_rangeIteratorExtended( rangeExtended ),
+        M_diagIsNonZero( diag_is_nonzero ),
+        M_closeGraph( close )
     {
         // init block_pattern if empty
         uint16_type nbSubSpace1 = _M_X1->nSubFunctionSpace();
@@ -399,6 +403,10 @@ public:
 
         M_graph = this->computeGraph( graph_hints );
 
+        // graph reused from the stencil topology cache
+        if ( M_graph->isClosed() )
+            return;
+
         if ( diag_is_nonzero && _M_X1->nLocalDofWithoutGhost()>0 && _M_X2->nLocalDofWithoutGhost()>0 ) M_graph->addMissingZeroEntriesDiagonal();
 
         if ( close ) M_graph->close();
@@ -413,7 +421,9 @@ public:
         M_graph( g ),
         M_block_pattern(Xh->nSubFunctionSpace(),Yh->nSubFunctionSpace(),size_type( graph_hints/*Pattern::HAS_NO_BLOCK_PATTERN*/ )),
         M_rangeIteratorTest( r ),
-        M_rangeIteratorExtended( rangeExtended )
+        M_rangeIteratorExtended( rangeExtended ),
+        M_diagIsNonZero( false ),
+        M_closeGraph( true )
     {}
 
 
@@ -455,6 +465,8 @@ public:
 
     graph_ptrtype computeGraph( size_type hints, single_spaces_t );
     graph_ptrtype computeGraph( size_type hints, multiple_spaces_t );
+    //! stencil without extended pattern built directly in flat CSR form (see GraphCSRBuilder)
+    graph_ptrtype computeGraphFlat( size_type hints );
     graph_ptrtype computeGraph( size_type hints, multiple_space_t, multiple_space_t );
     graph_ptrtype computeGraph( size_type hints, single_space_t, multiple_space_t );
     graph_ptrtype computeGraph( size_type hints, multiple_space_t, single_space_t );
@@ -768,6 +780,8 @@ private:
     BlocksStencilPattern M_block_pattern;
     rangeiterator_test_type M_rangeIteratorTest;
     rangeiterator_extended_type M_rangeIteratorExtended;
+    bool M_diagIsNonZero;
+    bool M_closeGraph;
 };
 namespace detail
 {
@@ -832,6 +846,91 @@ void stencilManagerAdd(StencilManagerImpl::key_type const& key,StencilManagerImp
 //! print entries stored in stencil manager
 void stencilManagerPrint();
 
+/**
+ * topology of a stencil built in flat form (see Stencil::computeGraphFlat) :
+ * for each coupling (test element,trial element) visited, the test element
+ * id, the rows of the test element (process dof ids) and a hash of the
+ * columns of the trial element (global cluster dof ids).
+ */
+struct StencilTopology
+{
+    using size_type = GraphCSR::size_type;
+
+    //! number of rows (process dofs with ghosts)
+    size_type nRows = 0;
+    //! hash of the process to global cluster maps of the rows and the columns
+    std::size_t mapsHash = 0;
+    std::vector<index_type> testEltIds;
+    std::vector<size_type> rowsPtr = { 0 };
+    std::vector<size_type> rows;
+    std::vector<std::size_t> colsHash;
+
+    size_type nCouplings() const { return testEltIds.size(); }
+
+    //! \return true if the coupling \p k of this topology is the coupling \p kt of \p t
+    bool isSameCoupling( size_type k, StencilTopology const& t, size_type kt ) const
+        {
+            return testEltIds[k] == t.testEltIds[kt] && colsHash[k] == t.colsHash[kt] &&
+                rowsPtr[k+1]-rowsPtr[k] == t.rowsPtr[kt+1]-t.rowsPtr[kt] &&
+                std::equal( rows.begin()+rowsPtr[k], rows.begin()+rowsPtr[k+1], t.rows.begin()+t.rowsPtr[kt] );
+        }
+
+    /**
+     * \return for each coupling, the index of the coupling of \p t with the same
+     * test element and the same rank among the couplings of this test element,
+     * or invalid_v<size_type> if there is none
+     */
+    std::vector<size_type> matchCouplings( StencilTopology const& t ) const;
+
+    /**
+     * \return the number of couplings which differ from \p t : the couplings of
+     * this topology which are not in \p t and the couplings of \p t which are
+     * not in this topology (the number of rows and of couplings can differ)
+     */
+    size_type nChanges( StencilTopology const& t ) const;
+
+    /**
+     * set to true the rows (process dof ids of this topology) of the couplings
+     * which differ from \p t
+     */
+    void updateChangedRows( StencilTopology const& t, std::vector<bool>& rowsToUpdate ) const;
+};
+
+/**
+ * entry of the stencil topology cache : the open flat rows (before close) and
+ * the closed graph built for a topology. The graph is not owned by the cache
+ * so that the maps (dof tables and meshes) of the old spaces can be released.
+ */
+struct StencilTopologyCacheEntry
+{
+    StencilTopology topology;
+    std::shared_ptr<GraphCSRBuilder> rows;
+    std::weak_ptr<GraphCSR> graph;
+};
+
+/**
+ * cache of the stencils built in flat form when the option \c stencil.cache
+ * is enabled. Unlike the StencilManager, the entries are not attached to the
+ * function spaces : when the spaces are rebuilt (remeshing, ALE, ...) a graph
+ * is reused if the topology did not change and patched if only a few elements
+ * changed. The key is (test space type, trial space type, pattern,
+ * diag_is_nonzero) and at most \c stencil.cache.size entries are kept by key.
+ */
+class StencilTopologyCacheImpl:
+    public std::map<boost::tuple<std::string, std::string, size_type, bool>, std::list<StencilTopologyCacheEntry> >,
+    public boost::noncopyable
+{
+public:
+    typedef boost::tuple<std::string, std::string, size_type, bool> key_type;
+};
+
+typedef Feel::Singleton<StencilTopologyCacheImpl> StencilTopologyCache;
+
+//! remove all the entries of the stencil topology cache
+void stencilTopologyCacheClear();
+//! \return the stencil topology cache, which is cleared when the Environment is deleted
+StencilTopologyCacheImpl& stencilTopologyCache();
+
 extern BlocksStencilPattern default_block_pattern;
 
 template <typename ... Ts>
@@ -1529,6 +1628,9 @@ Stencil<X1, X2, RangeItTestType, RangeExtendedItType, QuadSetType>::computeGraph
         return sparsity_graph;
     }
 
+    if ( !graph.test( Pattern::EXTENDED ) && boption(_name="stencil.flat-csr") )
+        return this->computeGraphFlat( hints );
+
     //if (_M_X1->nLocalDofWithoutGhost()==0 && _M_X2->nLocalDofWithoutGhost()==0 ) return sparsity_graph;
 
     //auto elem_it  = _M_X1->mesh()->beginElementWithProcessId( _M_X1->mesh()->worldComm().localRank() /*proc_id*/ );
@@ -1798,6 +1900,213 @@ Stencil<X1, X2, RangeItTestType, RangeExtendedItType, QuadSetType>::computeGraph
 }
 #endif
 
+template <typename X1, typename X2, typename RangeItTestType, typename RangeExtendedItType, typename QuadSetType>
+typename Stencil<X1, X2, RangeItTestType, RangeExtendedItType, QuadSetType>::graph_ptrtype
+Stencil<X1, X2, RangeItTestType, RangeExtendedItType, QuadSetType>::computeGraphFlat( size_type hints )
+{
+    static const bool hasNotFindRangeStandard = rangeiteratorType<0, 0>::hasnotfindrange_type::value;
+#if !defined( NDEBUG )
+    tic();
+#endif
+    graph_ptrtype sparsity_graph( new graph_type( _M_X1->dof(), _M_X2->dof() ) );
+
+    Feel::Context graph( hints );
+    bool do_less = ( ( graph.test( Pattern::DEFAULT ) &&
+                       ( _M_X1->dof()->nComponents ==
+                         _M_X2->dof()->nComponents ) ) &&
+                     !graph.test( Pattern::COUPLED ) );
+
+    static const uint16_type nDimTest = test_space_type::mesh_type::nDim;
+    static const uint16_type nDimTrial = trial_space_type::mesh_type::nDim;
+    static const uint16_type nDimDiffBetweenTestTrial = ( nDimTest > nDimTrial ) ? nDimTest - nDimTrial : nDimTrial - nDimTest;
+
+    bool hasMeshSupportPartialX2 = _M_X2->dof()->hasMeshSupport() && _M_X2->dof()->meshSupport()->isPartialSupport();
+
+    auto rangeListTest = this->rangeiterator<0, 0>( mpl::bool_<hasNotFindRangeStandard>() );
+
+    // call f( idTestElt, element_dof2 ) for each coupling (test element,trial element)
+    // such that keepTestElement( idTestElt ) is true
+    auto forEachCouplings = [&]( auto&& keepTestElement, auto&& f )
+        {
+            std::vector<size_type> element_dof2( _M_X2->dof()->getIndicesSize() );
+            for ( auto const& rangeTest : rangeListTest )
+            {
+                auto iDimRange = rangeTest.idim();
+                for ( auto elem_it = rangeTest.begin(), elem_en = rangeTest.end(); elem_it != elem_en; ++elem_it )
+                {
+                    auto const& eltRange = boost::unwrap_ref( *elem_it );
+                    const std::set<std::pair<index_type, rank_type>> infoTestElts = testElementIdFromRange( iDimRange, eltRange );
+                    for ( auto const& [idTestElt,rankTestElt] : infoTestElts )
+                    {
+                        if ( !keepTestElement( idTestElt ) )
+                            continue;
+                        auto const domains_eid_set = trialElementId( idTestElt, mpl::int_<nDimDiffBetweenTestTrial>() );
+                        for ( const index_type domain_eid : domains_eid_set )
+                        {
+                            if ( hasMeshSupportPartialX2 && !_M_X2->dof()->meshSupport()->hasElement( domain_eid ) )
+                                continue;
+
+                            if ( trial_space_type::dof_type::is_mortar )
+                                element_dof2.resize( _M_X2->dof()->getIndicesSize( domain_eid ) );
+
+                            bool is_empty = _M_X2->dof()->getIndicesSetOnGlobalCluster( domain_eid, element_dof2 );
+                            if ( is_empty )
+                                continue;
+                            // sorted as in computeGraph : the per component slices of
+                            // Pattern::DEFAULT are taken in the sorted indices
+                            std::sort( element_dof2.begin(), element_dof2.end() );
+                            f( idTestElt, element_dof2 );
+                        }
+                    }
+                }
+            }
+        };
+
+    // the same couplings are visited twice by the builder : count and fill passes
+    auto forEachEntriesOfTestElements = [&]( auto&& insert, auto&& keepTestElement )
+        {
+            forEachCouplings( keepTestElement, [&]( index_type idTestElt, std::vector<size_type> const& element_dof2 )
+                              {
+                                  const uint16_type n1_dof_on_element = _M_X1->dof()->getIndicesSize( idTestElt );
+                                  const uint16_type n2_dof_on_element = element_dof2.size();
+                                  const int ndofpercomponent1 = n1_dof_on_element / _M_X1->dof()->nComponents;
+                                  const int ndofpercomponent2 = n2_dof_on_element / _M_X2->dof()->nComponents;
+                                  for ( size_type i = 0; i < n1_dof_on_element; i++ )
+                                  {
+                                      const size_type il1 = _M_X1->dof()->localToGlobalId( idTestElt, i );
+                                      const int ncomp1 = i / ndofpercomponent1;
+                                      if ( do_less )
+                                      {
+                                          auto colBegin = element_dof2.begin() + ncomp1 * ndofpercomponent2;
+                                          auto colEnd = ( ncomp1 == ( _M_X2->dof()->nComponents - 1 ) )?
+                                              element_dof2.end() : element_dof2.begin() + ( ncomp1 + 1 ) * ndofpercomponent2;
+                                          insert( il1, colBegin, colEnd );
+                                      }
+                                      else
+                                          insert( il1, element_dof2.begin(), element_dof2.end() );
+                                  }
+                              } );
+        };
+    auto forEachEntries = [&]( auto&& insert )
+        {
+            forEachEntriesOfTestElements( insert, []( index_type ) { return true; } );
+        };
+
+    const size_type nRows = _M_X1->dof()->nLocalDofWithGhost();
+    const int nThreads = ioption(_name="stencil.flat-csr.nthreads");
+
+    // the stencil topology cache is used only for the graphs kept by the StencilManager
+    bool useCache = boption(_name="stencil.cache") && M_closeGraph && this->M_rangeIteratorTest.isNullRange() && this->M_rangeIteratorExtended.isNullRange();
+    if ( !useCache )
+    {
+        GraphCSRBuilder rows( nRows, nThreads );
+        rows.build( forEachEntries );
+        sparsity_graph->setFlatRows( std::move( rows ) );
+#if !defined( NDEBUG )
+        toc( "[computeGraphFlat]", FLAGS_v > 1 );
+#endif
+        return sparsity_graph;
+    }
+
+    // topology of the stencil
+    StencilTopology topology;
+    topology.nRows = nRows;
+    boost::hash_combine( topology.mapsHash, boost::hash_range( _M_X1->dof()->mapGlobalProcessToGlobalCluster().begin(),
+                                                               _M_X1->dof()->mapGlobalProcessToGlobalCluster().end() ) );
+    boost::hash_combine( topology.mapsHash, boost::hash_range( _M_X2->dof()->mapGlobalProcessToGlobalCluster().begin(),
+                                                               _M_X2->dof()->mapGlobalProcessToGlobalCluster().end() ) );
+    forEachCouplings( []( index_type ) { return true; },
+                      [&]( index_type idTestElt, std::vector<size_type> const& element_dof2 )
+                      {
+                          topology.testEltIds.push_back( idTestElt );
+                          const uint16_type n1_dof_on_element = _M_X1->dof()->getIndicesSize( idTestElt );
+                          for ( size_type i = 0; i < n1_dof_on_element; i++ )
+                              topology.rows.push_back( _M_X1->dof()->localToGlobalId( idTestElt, i ) );
+                          topology.rowsPtr.push_back( topology.rows.size() );
+                          topology.colsHash.push_back( boost::hash_range( element_dof2.begin(), element_dof2.end() ) );
+                      } );
+
+    // look for the closest topology in the cache
+    auto& cacheEntries = stencilTopologyCache()[ boost::make_tuple( std::string( typeid( test_space_type ).name() ),
+                                                                             std::string( typeid( trial_space_type ).name() ),
+                                                                             hints, M_diagIsNonZero ) ];
+    auto cacheEntryIt = cacheEntries.end();
+    size_type nChanges = invalid_v<size_type>;
+    for ( auto it = cacheEntries.begin(), en = cacheEntries.end(); it != en; ++it )
+    {
+        size_type n = topology.nChanges( it->topology );
+        if ( n < nChanges )
+        {
+            nChanges = n;
+            cacheEntryIt = it;
+        }
+    }
+
+    // the graph is closed collectively : all processes must take the same decision
+    enum { REUSE = 0, INCREMENTAL = 1, REBUILD = 2 };
+    int mode = REBUILD;
+    std::shared_ptr<GraphCSR> cachedGraph;
+    if ( cacheEntryIt != cacheEntries.end() )
+    {
+        cachedGraph = cacheEntryIt->graph.lock();
+        if ( nChanges == 0 && topology.nRows == cacheEntryIt->topology.nRows && topology.mapsHash == cacheEntryIt->topology.mapsHash &&
+             cachedGraph && cachedGraph->isClosed() )
+            mode = REUSE;
+        else if ( nChanges <= doption(_name="stencil.cache.incremental-ratio")*topology.nCouplings() )
+            mode = INCREMENTAL;
+    }
+    mode = mpi::all_reduce( _M_X1->worldComm(), mode, mpi::maximum<int>() );
+    DVLOG(1) << "[computeGraphFlat] stencil topology cache : mode=" << mode << " nChanges=" << nChanges << "/" << topology.nCouplings();
+
+    if ( mode == REUSE )
+    {
+        // the closed graph is copied and bound to the maps of the new spaces (same numbering)
+        sparsity_graph = std::make_shared<graph_type>( *cachedGraph );
+        sparsity_graph->setMaps( _M_X1->dof(), _M_X2->dof() );
+        cacheEntryIt->graph = sparsity_graph;
+        // move the entry at the front (most recently used)
+        cacheEntries.splice( cacheEntries.begin(), cacheEntries, cacheEntryIt );
+        return sparsity_graph;
+    }
+
+    GraphCSRBuilder rows( nRows, nThreads );
+    if ( mode == INCREMENTAL )
+    {
+        // rows of the couplings which have changed, in the old and the new topologies
+        // (the rows which do not exist in the old topology are in new couplings)
+        std::vector<bool> rowsToUpdate( nRows, false );
+        topology.updateChangedRows( cacheEntryIt->topology, rowsToUpdate );
+        // only the test elements which have a row to update are visited
+        auto keepTestElement = [&]( index_type idTestElt )
+            {
+                for ( size_type i = 0, n = _M_X1->dof()->getIndicesSize( idTestElt ); i < n; i++ )
+                    if ( rowsToUpdate[_M_X1->dof()->localToGlobalId( idTestElt, i )] )
+                        return true;
+                return false;
+            };
+        rows.buildIncremental( *cacheEntryIt->rows, rowsToUpdate,
+                               [&]( auto&& insert ) { forEachEntriesOfTestElements( insert, keepTestElement ); } );
+        cacheEntries.erase( cacheEntryIt );
+    }
+    else
+        rows.build( forEachEntries );
+
+    StencilTopologyCacheEntry entry;
+    entry.topology = std::move( topology );
+    entry.rows = std::make_shared<GraphCSRBuilder>( rows );
+    entry.graph = sparsity_graph;
+    cacheEntries.push_front( std::move( entry ) );
+    if ( cacheEntries.size() > (std::size_t)std::max( ioption(_name="stencil.cache.size"), 1 ) )
+        cacheEntries.pop_back();
+
+    sparsity_graph->setFlatRows( std::move( rows ) );
+
+#if !defined( NDEBUG )
+    toc( "[computeGraphFlat]", FLAGS_v > 1 );
+#endif
+    return sparsity_graph;
+}
+
 template<typename X1,  typename X2,typename RangeItTestType, typename RangeExtendedItType, typename QuadSetType>
 typename Stencil<X1,X2,RangeItTestType,RangeExtendedItType,QuadSetType>::graph_ptrtype
 Stencil<X1,X2,RangeItTestType,RangeExtendedItType,QuadSetType>::computeGraphHDG( size_type hints,
@@ -31,13 +31,18 @@
 #ifndef FEELPP_FILTERS_EXPORTER_H
 #define FEELPP_FILTERS_EXPORTER_H
 
+#include <future>
+
 #include <feel/feelcore/feel.hpp>
+#include <feel/feelcore/environment.hpp>
+#include <feel/feelcore/profiler.hpp>
 #include <feel/feelcore/visitor.hpp>
 #include <feel/feelcore/factory.hpp>
 #include <feel/feelcore/singleton.hpp>
 
 #include <feel/feeldiscr/timeset.hpp>
 #include <feel/feelfilters/enums.hpp>
+#include <feel/feelfilters/exporteriothread.hpp>
 #include <feel/feelmesh/meshfragmentation.hpp>
 
 namespace Feel
@@ -65,6 +70,14 @@ namespace Feel
  * exporter->step(0)->add( "u", U );
  * \endcode
  *
+ * With the asynchronous save (option \c exporter.async), \c save() gives the
+ * steps (whose fields are already copied by \c add) to the ExporterIOThread
+ * and returns. The back-ends call MPI from this thread : the asynchronous
+ * save is used only if the Environment provides MPI_THREAD_MULTIPLE, the
+ * save is synchronous otherwise. The next call to \c step() or \c save() waits for the
+ * pending writes, so the disk writes overlap the computation done in
+ * between. The mesh must not be modified during this computation.
+ *
  * \sa Laplacian
  *
  * @author Christophe Prud'homme
@@ -74,7 +87,8 @@ class FEELPP_EXPORT Exporter
     :
         public CommObject,
         public VisitorBase,
-        public Visitor<MeshType>
+        public Visitor<MeshType>,
+        public std::enable_shared_from_this<Exporter<MeshType,N>>
 {
 public:
 
@@ -246,6 +260,14 @@ public:
         return M_path;
     }
 
+    /**
+     * \return true if the save is asynchronous
+     */
+    bool asyncSave() const
+    {
+        return M_asyncSave;
+    }
+
     //@}
 
     /** @name  Mutators
@@ -260,6 +282,15 @@ public:
         M_do_export = do_export;
     }
 
+    /**
+     * set the asynchronous save to \p async
+     */
+    void setAsyncSave( bool async )
+    {
+        M_asyncSave = async;
+        this->initAsyncSave();
+    }
+
     /**
      * set the options from the \p variables_map \p vm as well as the prefix \p
      * exp_prefix
@@ -475,6 +506,7 @@ public:
     step_ptrtype step( double time, int s )
     {
         CHECK( s >= 0 && s < M_ts_set.size() ) << "invalid timeset index " << s;
+        this->waitSave();
         timeset_ptrtype __ts = M_ts_set[s];
         return __ts->step( time, this->freq() );
     }
@@ -490,6 +522,7 @@ public:
      */
     uint16_type addTimeSet( timeset_ptrtype const& __ts )
     {
+        this->waitSave();
         if ( __ts )
         {
             M_ts_set.push_back( __ts );
@@ -510,7 +543,9 @@ public:
     {
         if ( !this->worldComm().isActive() )
             return;
+        FEELPP_PROFILE_REGION( "Exporter::save" );
 
+        this->waitSave();
         bool hasStepToWrite = false;
         steps_write_on_disk_type stepsToWriteOnDisk;
         timeset_const_iterator __ts_it = this->beginTimeSet();
@@ -524,20 +559,41 @@ public:
                 hasStepToWrite = true;
         }
 
-        if ( hasStepToWrite )
-            this->save( stepsToWriteOnDisk );
-
-        for ( auto & [__ts, steps ] : stepsToWriteOnDisk )
+        if ( M_asyncSave && !this->useAsyncSave() )
+            LOG_FIRST_N( WARNING, 1 ) << "[Exporter] the asynchronous save needs MPI_THREAD_MULTIPLE (Environment with _threading=mpi::threading::multiple)"
+                                      << " and, in parallel, a back-end which supports it : the save is synchronous";
+        if ( this->useAsyncSave() )
         {
-            for ( auto & step : steps )
-            {
-                step->setState( STEP_ON_DISK );
-                step->cleanup();
-            }
-            // save metadata file (sould be done even the if step is not write on the disk
-            std::string filename = (fs::path(this->path()) / (prefix()+".timeset")).string();
-            __ts->save( filename, this->worldComm() );
+            // the communications with another communicator than the
+            // exporter one are done here by the back-end
+            this->prepareSave( stepsToWriteOnDisk );
+            auto self = this->shared_from_this();
+            auto done = std::make_shared<std::promise<void>>();
+            M_saveDone = done->get_future().share();
+            ExporterIOThread::instance().push( [self,done,stepsToWriteOnDisk = std::move( stepsToWriteOnDisk ),hasStepToWrite]() {
+                                                   try
+                                                   {
+                                                       self->saveOnDisk( stepsToWriteOnDisk, hasStepToWrite );
+                                                       done->set_value();
+                                                   }
+                                                   catch ( ... )
+                                                   {
+                                                       done->set_exception( std::current_exception() );
+                                                   }
+                                               } );
         }
+        else
+            this->saveOnDisk( stepsToWriteOnDisk, hasStepToWrite );
+    }
+
+    //! wait for the end of the asynchronous save of this exporter
+    void waitSave() const
+    {
+        if ( !M_saveDone.valid() )
+            return;
+        auto saveDone = std::move( M_saveDone );
+        M_saveDone = std::shared_future<void>{};
+        saveDone.get();
     }
 
     //!
@@ -550,6 +606,7 @@ public:
      */
     void restart( double __time )
     {
+        this->waitSave();
         auto __ts_it = this->beginTimeSet();
         auto __ts_en = this->endTimeSet();
 
@@ -572,6 +629,67 @@ protected:
      */
     virtual void save( steps_write_on_disk_type const& stepsToWriteOnDisk ) const = 0;
 
+    /**
+     * called on the main thread before the asynchronous save of
+     * \p stepsToWriteOnDisk : the back-end does here the work which
+     * communicates with another communicator than the exporter one
+     */
+    virtual void prepareSave( steps_write_on_disk_type const& stepsToWriteOnDisk ) const {}
+
+    /**
+     * \return true if the back-end can save asynchronously, by default only
+     * in sequential
+     */
+    virtual bool hasAsyncSave() const
+    {
+        return this->worldComm().localSize() == 1;
+    }
+
+private:
+
+    //! the asynchronous save calls MPI from the I/O thread : it needs
+    //! MPI_THREAD_MULTIPLE, a communicator which is not a sub-communicator
+    //! (duplicated for the I/O) and a shared exporter
+    bool useAsyncSave() const
+    {
+        return M_asyncSave && M_ioWorldComm && this->hasAsyncSave() && !this->weak_from_this().expired();
+    }
+
+    //! the I/O thread communicates on a duplicate of the exporter
+    //! communicator, so that its collectives never mix with the ones of the
+    //! main thread (collective on the exporter communicator)
+    void initAsyncSave()
+    {
+        if ( !M_asyncSave || M_ioWorldComm || Environment::threadLevel() != mpi::threading::multiple )
+            return;
+        auto const& wc = this->worldComm();
+        if ( wc.localSize() != wc.globalSize() )
+            return;
+        mpi::communicator ioComm( wc.globalComm(), mpi::comm_duplicate );
+        M_ioWorldComm = std::make_shared<WorldComm>( ioComm, ioComm, wc.godComm(), 0, wc.activityOnWorld() );
+        this->setWorldComm( M_ioWorldComm );
+    }
+
+    //! write \p stepsToWriteOnDisk and the timeset metadata files
+    void saveOnDisk( steps_write_on_disk_type const& stepsToWriteOnDisk, bool hasStepToWrite ) const
+    {
+        if ( hasStepToWrite )
+            this->save( stepsToWriteOnDisk );
+
+        for ( auto & [__ts, steps ] : stepsToWriteOnDisk )
+        {
+            for ( auto & step : steps )
+            {
+                step->setState( STEP_ON_DISK );
+                step->cleanup();
+            }
+            // save metadata file (sould be done even the if step is not write on the disk
+            std::string filename = (fs::path(this->path()) / (prefix()+".timeset")).string();
+            __ts->save( filename, this->worldComm() );
+        }
+    }
+
+protected:
 
     bool M_do_export;
     MeshFragmentation<mesh_type> M_meshFragmentation;
@@ -584,6 +702,9 @@ protected:
     ExporterGeometry M_ex_geometry;
 
     mutable timeset_set_type M_ts_set;
+    bool M_asyncSave;
+    mutable std::shared_future<void> M_saveDone;
+    worldcomm_ptr_t M_ioWorldComm;
 };
 
 
@@ -177,6 +177,12 @@ protected:
      //! save the timeset
     void save( steps_write_on_disk_type const& stepsToWriteOnDisk ) const override;
 
+    //! build the mesh numbering caches (communications with the mesh communicator)
+    void prepareSave( steps_write_on_disk_type const& stepsToWriteOnDisk ) const override;
+
+    //! the asynchronous save is supported if the mesh numbering of a timeset does not change
+    bool hasAsyncSave() const override { return this->exporterGeometry() != EXPORTER_GEOMETRY_CHANGE; }
+
 private:
 
     //! init the ensight exporter
@@ -195,6 +201,9 @@ private:
     //! write the 'case' file for ensight
     FEELPP_NO_EXPORT void writeCaseFile() const;
 
+    //! build or update the mesh numbering cache of the timeset \p __ts
+    FEELPP_NO_EXPORT void updateGeoCache( timeset_ptrtype __ts, mesh_ptrtype mesh ) const;
+
     //! write the 'geo' file for ensight
     FEELPP_NO_EXPORT void writeGeoFiles( timeset_ptrtype __ts, mesh_ptrtype mesh, int timeIndex, bool isFirstStep ) const;
     FEELPP_NO_EXPORT void writeGeoMarkers( MPI_File fh, mesh_contiguous_numbering_mapping_type const& mp, bool writeHeaderBeginFile, bool writeBeginEndTimeSet, Feel::detail::FileIndex & index ) const;
@@ -222,6 +231,8 @@ private:
     // file position for explicit pointers
     mutable MPI_Offset posInFile;
     mutable std::map<std::string, mesh_contiguous_numbering_mapping_ptrtype > M_cache_mp;
+    // true if the caches have been updated by prepareSave for the next save
+    mutable bool M_geoCachePrepared = false;
     mutable std::map<int,std::vector<size_type>> M_mapNodalArrayToDofId;
     mutable std::map<int,std::vector<size_type>> M_mapElementArrayToDofId;
 };
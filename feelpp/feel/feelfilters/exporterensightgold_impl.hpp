@@ -166,6 +166,7 @@ ExporterEnsightGold<MeshType,N>::save( steps_write_on_disk_type const& stepsToWr
     writeSoSFile();
     toc("ExporterEnsightGold::save sos",FLAGS_v>1);
 
+    M_geoCachePrepared = false;
     toc("ExporterEnsightGold::save", FLAGS_v > 0 );
 }
 
@@ -496,7 +497,21 @@ ExporterEnsightGold<MeshType,N>::writeCaseFile() const
 
 template<typename MeshType, int N>
 void
-ExporterEnsightGold<MeshType,N>::writeGeoFiles( timeset_ptrtype __ts, mesh_ptrtype mesh, int timeIndex, bool isFirstStep ) const
+ExporterEnsightGold<MeshType,N>::prepareSave( steps_write_on_disk_type const& stepsToWriteOnDisk ) const
+{
+    for ( auto const& [__ts,steps] : stepsToWriteOnDisk )
+    {
+        if ( steps.empty() && __ts->numberOfSteps() == 0 && __ts->hasMesh() )
+            this->updateGeoCache( __ts, __ts->mesh() );
+        for ( auto const& __step : steps )
+            this->updateGeoCache( __ts, __step->mesh() );
+    }
+    M_geoCachePrepared = true;
+}
+
+template<typename MeshType, int N>
+void
+ExporterEnsightGold<MeshType,N>::updateGeoCache( timeset_ptrtype __ts, mesh_ptrtype mesh ) const
 {
     // prepare/udate cache
     bool buildNewCache = true;
@@ -522,6 +537,14 @@ ExporterEnsightGold<MeshType,N>::writeGeoFiles( timeset_ptrtype __ts, mesh_ptrty
         M_mapNodalArrayToDofId.clear();
         M_mapElementArrayToDofId.clear();
     }
+}
+
+template<typename MeshType, int N>
+void
+ExporterEnsightGold<MeshType,N>::writeGeoFiles( timeset_ptrtype __ts, mesh_ptrtype mesh, int timeIndex, bool isFirstStep ) const
+{
+    if ( !M_geoCachePrepared )
+        this->updateGeoCache( __ts, mesh );
 
     // mesh already write, do nothing
     if ( !isFirstStep && this->exporterGeometry() == EXPORTER_GEOMETRY_STATIC )
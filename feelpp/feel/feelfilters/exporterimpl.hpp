@@ -85,7 +85,8 @@ Exporter<MeshType, N>::Exporter( worldcomm_ptr_t const& worldComm )
     M_freq( 1 ),
     M_ft( ASCII ),
     M_path( "." ),
-    M_ex_geometry( EXPORTER_GEOMETRY_CHANGE_COORDS_ONLY )
+    M_ex_geometry( EXPORTER_GEOMETRY_CHANGE_COORDS_ONLY ),
+    M_asyncSave( false )
 {
     VLOG(1) << "[exporter::exporter] do export = " << doExport() << "\n";
 }
@@ -103,7 +104,8 @@ Exporter<MeshType, N>::Exporter( std::string const& __type, std::string const& _
     M_freq( __freq ),
     M_ft( ASCII ),
     M_path( "." ),
-    M_ex_geometry( EXPORTER_GEOMETRY_CHANGE_COORDS_ONLY )
+    M_ex_geometry( EXPORTER_GEOMETRY_CHANGE_COORDS_ONLY ),
+    M_asyncSave( false )
 {
 
 }
@@ -121,7 +123,8 @@ Exporter<MeshType, N>::Exporter( po::variables_map const& vm, std::string const&
     M_freq( 1 ),
     M_ft( ASCII ),
     M_path( "." ),
-    M_ex_geometry( EXPORTER_GEOMETRY_CHANGE_COORDS_ONLY )
+    M_ex_geometry( EXPORTER_GEOMETRY_CHANGE_COORDS_ONLY ),
+    M_asyncSave( false )
 {
     VLOG(1) << "[exporter::exporter] do export = " << doExport() << "\n";
 }
@@ -139,7 +142,8 @@ Exporter<MeshType, N>::Exporter( std::string const& exp_prefix, worldcomm_ptr_t
     M_freq( 1 ),
     M_ft( ASCII ),
     M_path( "." ),
-    M_ex_geometry( EXPORTER_GEOMETRY_CHANGE_COORDS_ONLY )
+    M_ex_geometry( EXPORTER_GEOMETRY_CHANGE_COORDS_ONLY ),
+    M_asyncSave( false )
 {
     VLOG(1) << "[exporter::exporter] do export = " << doExport() << "\n";
 }
@@ -157,7 +161,9 @@ Exporter<MeshType, N>::Exporter( Exporter const & __ex )
     M_freq( __ex.M_freq ),
     M_ft( __ex.M_ft ),
     M_path( __ex.M_path ),
-    M_ex_geometry( EXPORTER_GEOMETRY_CHANGE_COORDS_ONLY )
+    M_ex_geometry( EXPORTER_GEOMETRY_CHANGE_COORDS_ONLY ),
+    M_asyncSave( __ex.M_asyncSave ),
+    M_ioWorldComm( __ex.M_ioWorldComm )
 {
 
 }
@@ -275,11 +281,16 @@ Exporter<MeshType, N>::setOptions( std::string const& exp_prefix )
         M_ft = BINARY;
     else
         M_ft = ASCII;
+    M_asyncSave = boption(_name="exporter.async",_prefix=exp_prefix);
+    if ( M_asyncSave )
+        ExporterIOThread::instance().setCapacity( ioption(_name="exporter.async.queue-size",_prefix=exp_prefix) );
+    this->initAsyncSave();
 
     VLOG(1) << "[Exporter] type:  " << M_type << "\n";
     VLOG(1) << "[Exporter] prefix:  " << M_prefix << "\n";
     VLOG(1) << "[Exporter] freq:  " << M_freq << "\n";
     VLOG(1) << "[Exporter] ft:  " << M_ft << "\n";
+    VLOG(1) << "[Exporter] async:  " << M_asyncSave << "\n";
     return this;
 }
 
@@ -0,0 +1,150 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+
+  This file is part of the Feel library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#include <algorithm>
+
+#include <feel/feelcore/environment.hpp>
+#include <feel/feelfilters/exporteriothread.hpp>
+
+namespace Feel
+{
+
+ExporterIOThread::ExporterIOThread()
+    :
+    M_thread( [this]() { this->run(); } )
+{
+    // the pending writes must be done before MPI is finalized
+    Environment::addDeleteObserver( [this]() {
+                                        try
+                                        {
+                                            this->wait();
+                                        }
+                                        catch ( std::exception const& e )
+                                        {
+                                            LOG(ERROR) << "[ExporterIOThread] asynchronous save failed : " << e.what();
+                                        }
+                                    } );
+}
+
+ExporterIOThread::~ExporterIOThread()
+{
+    {
+        std::lock_guard<std::mutex> lock( M_mutex );
+        M_stop = true;
+    }
+    M_cvTask.notify_all();
+    if ( M_thread.joinable() )
+        M_thread.join();
+}
+
+ExporterIOThread&
+ExporterIOThread::instance()
+{
+    static ExporterIOThread ioThread;
+    return ioThread;
+}
+
+void
+ExporterIOThread::setCapacity( int c )
+{
+    std::lock_guard<std::mutex> lock( M_mutex );
+    M_capacity = std::max( c, 1 );
+}
+
+int
+ExporterIOThread::nPendingTasks() const
+{
+    std::lock_guard<std::mutex> lock( M_mutex );
+    return M_tasks.size() + M_nRunningTasks;
+}
+
+void
+ExporterIOThread::push( task_type t )
+{
+    std::unique_lock<std::mutex> lock( M_mutex );
+    M_cvDone.wait( lock, [this]() { return int( M_tasks.size() ) + M_nRunningTasks < M_capacity || M_error; } );
+    if ( M_error )
+    {
+        lock.unlock();
+        this->rethrowIfFailed();
+    }
+    M_tasks.push_back( std::move( t ) );
+    lock.unlock();
+    M_cvTask.notify_one();
+}
+
+void
+ExporterIOThread::wait()
+{
+    std::unique_lock<std::mutex> lock( M_mutex );
+    M_cvDone.wait( lock, [this]() { return M_tasks.empty() && M_nRunningTasks == 0; } );
+    lock.unlock();
+    this->rethrowIfFailed();
+}
+
+void
+ExporterIOThread::rethrowIfFailed()
+{
+    std::exception_ptr e;
+    {
+        std::lock_guard<std::mutex> lock( M_mutex );
+        std::swap( e, M_error );
+    }
+    if ( e )
+        std::rethrow_exception( e );
+}
+
+void
+ExporterIOThread::run()
+{
+    while ( true )
+    {
+        task_type t;
+        {
+            std::unique_lock<std::mutex> lock( M_mutex );
+            M_cvTask.wait( lock, [this]() { return M_stop || !M_tasks.empty(); } );
+            if ( M_tasks.empty() )
+                return;
+            t = std::move( M_tasks.front() );
+            M_tasks.pop_front();
+            ++M_nRunningTasks;
+        }
+        std::exception_ptr e;
+        try
+        {
+            t();
+        }
+        catch ( ... )
+        {
+            e = std::current_exception();
+        }
+        // release the snapshot before notifying the main thread
+        t = nullptr;
+        {
+            std::lock_guard<std::mutex> lock( M_mutex );
+            --M_nRunningTasks;
+            if ( e && !M_error )
+                M_error = e;
+        }
+        M_cvDone.notify_all();
+    }
+}
+
+} // namespace Feel
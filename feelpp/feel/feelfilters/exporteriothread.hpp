@@ -0,0 +1,91 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+
+  This file is part of the Feel library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef FEELPP_FILTERS_EXPORTERIOTHREAD_HPP
+#define FEELPP_FILTERS_EXPORTERIOTHREAD_HPP 1
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include <feel/feelcore/feel.hpp>
+
+namespace Feel
+{
+
+/**
+ * background thread which executes the disk writes of the exporters.
+ *
+ * The tasks are executed in the order in which they are pushed (the same on
+ * all the processes). The queue is bounded : \c push() blocks while
+ * \c capacity() tasks are pending, so that at most \c capacity() snapshots
+ * are kept in memory. An exception thrown by a task is rethrown by the next
+ * \c push() or \c wait() of the main thread.
+ *
+ * The pending tasks are flushed when the Environment is destroyed.
+ */
+class FEELPP_EXPORT ExporterIOThread
+{
+public:
+    using task_type = std::function<void()>;
+
+    ExporterIOThread( ExporterIOThread const& ) = delete;
+    ExporterIOThread& operator=( ExporterIOThread const& ) = delete;
+    ~ExporterIOThread();
+
+    //! \return the I/O thread shared by all the exporters
+    static ExporterIOThread& instance();
+
+    //! maximum number of pending tasks
+    int capacity() const { return M_capacity; }
+    void setCapacity( int c );
+
+    //! number of tasks pushed and not yet done
+    int nPendingTasks() const;
+
+    //! add the task \p t, wait if the queue is full
+    void push( task_type t );
+
+    //! wait that all the tasks are done
+    void wait();
+
+private:
+    ExporterIOThread();
+    void run();
+    void rethrowIfFailed();
+
+private:
+    mutable std::mutex M_mutex;
+    std::condition_variable M_cvTask;
+    std::condition_variable M_cvDone;
+    std::deque<task_type> M_tasks;
+    int M_capacity = 1;
+    int M_nRunningTasks = 0;
+    bool M_stop = false;
+    std::exception_ptr M_error;
+    std::thread M_thread;
+};
+
+} // namespace Feel
+
+#endif /* FEELPP_FILTERS_EXPORTERIOTHREAD_HPP */
@@ -0,0 +1,213 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+
+  This file is part of the Feel++ library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3.0 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#ifndef FEELPP_FILTERS_GMSHMAPPEDSTREAM_HPP
+#define FEELPP_FILTERS_GMSHMAPPEDSTREAM_HPP 1
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+namespace Feel
+{
+namespace detail
+{
+/**
+ * @brief read only stream on a memory mapped Gmsh file
+ *
+ * It provides the subset of \c std::istream used by the Gmsh importer
+ * (formatted extraction of numbers and words, \c get and \c read) with a
+ * number parser working in place on the mapped bytes. The pages of the file
+ * are only loaded when they are read, so that a block skipped with
+ * \c skipLines or \c skipBytes costs (almost) nothing.
+ */
+class GmshMappedStream
+{
+public:
+    explicit GmshMappedStream( std::string const& filename )
+        {
+            try
+            {
+                M_file.open( filename );
+            }
+            catch ( std::exception const& )
+            {
+                return;
+            }
+            M_begin = M_cur = M_file.data();
+            M_end = M_begin + M_file.size();
+        }
+
+    bool is_open() const { return M_file.is_open(); }
+    bool fail() const { return M_fail; }
+    explicit operator bool() const { return !M_fail; }
+
+    //! offset of the current position from the beginning of the file
+    std::size_t tellg() const { return M_cur - M_begin; }
+
+    //! formatted extraction of an integer or a floating point number, skipping the leading white spaces
+    template <typename T, std::enable_if_t<std::is_arithmetic_v<T>,int> = 0>
+    GmshMappedStream& operator>>( T& v )
+        {
+            this->skipWhiteSpaces();
+            if constexpr ( std::is_integral_v<T> )
+            {
+                // std::from_chars does not accept the plus sign
+                if ( M_cur < M_end && *M_cur == '+' )
+                    ++M_cur;
+                auto [ptr, ec] = std::from_chars( M_cur, M_end, v );
+                this->update( ptr, ec );
+            }
+            else
+            {
+#if defined( __cpp_lib_to_chars )
+                if ( M_cur < M_end && *M_cur == '+' )
+                    ++M_cur;
+                auto [ptr, ec] = std::from_chars( M_cur, M_end, v );
+                this->update( ptr, ec );
+#else
+                // the mapped file is not null terminated: parse a copy of the word
+                char buf[64];
+                std::size_t n = std::min<std::size_t>( this->wordLength(), sizeof( buf )-1 );
+                std::memcpy( buf, M_cur, n );
+                buf[n] = '\0';
+                char* ptr = nullptr;
+                v = static_cast<T>( std::strtod( buf, &ptr ) );
+                this->update( M_cur + ( ptr-buf ), ptr == buf ? std::errc::invalid_argument : std::errc() );
+#endif
+            }
+            return *this;
+        }
+
+    //! formatted extraction of a word
+    GmshMappedStream& operator>>( std::string& s )
+        {
+            this->skipWhiteSpaces();
+            std::size_t n = this->wordLength();
+            s.assign( M_cur, n );
+            M_cur += n;
+            M_fail = M_fail || n == 0;
+            return *this;
+        }
+
+    //! \return the next character, \c EOF at the end of the file
+    int get()
+        {
+            if ( M_cur >= M_end )
+            {
+                M_fail = true;
+                return std::char_traits<char>::eof();
+            }
+            return static_cast<unsigned char>( *M_cur++ );
+        }
+
+    GmshMappedStream& read( char* s, std::size_t n )
+        {
+            if ( std::size_t( M_end-M_cur ) < n )
+            {
+                M_fail = true;
+                n = M_end-M_cur;
+            }
+            std::memcpy( s, M_cur, n );
+            M_cur += n;
+            return *this;
+        }
+
+    void skipBytes( std::size_t n )
+        {
+            if ( std::size_t( M_end-M_cur ) < n )
+            {
+                M_fail = true;
+                n = M_end-M_cur;
+            }
+            M_cur += n;
+        }
+
+    //! move to the end of the current line, then skip \p n lines
+    void skipLines( std::size_t n )
+        {
+            for ( std::size_t k = 0; k <= n && !M_fail; ++k )
+            {
+                char const* p = static_cast<char const*>( std::memchr( M_cur, '\n', M_end-M_cur ) );
+                if ( !p )
+                {
+                    M_cur = M_end;
+                    M_fail = k < n;
+                    return;
+                }
+                M_cur = p+1;
+            }
+        }
+
+private:
+    static bool isSpace( char c ) { return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f'; }
+
+    void skipWhiteSpaces()
+        {
+            while ( M_cur < M_end && isSpace( *M_cur ) )
+                ++M_cur;
+        }
+
+    std::size_t wordLength() const
+        {
+            char const* p = M_cur;
+            while ( p < M_end && !isSpace( *p ) )
+                ++p;
+            return p-M_cur;
+        }
+
+    void update( char const* ptr, std::errc ec )
+        {
+            if ( ec != std::errc() )
+                M_fail = true;
+            else
+                M_cur = ptr;
+        }
+
+private:
+    boost::iostreams::mapped_file_source M_file;
+    char const* M_begin = nullptr;
+    char const* M_cur = nullptr;
+    char const* M_end = nullptr;
+    bool M_fail = false;
+};
+
+//! skip the end of the current line and \p n lines of \p is
+inline void gmshSkipLines( std::istream& is, std::size_t n )
+{
+    for ( std::size_t k = 0; k <= n; ++k )
+        is.ignore( std::numeric_limits<std::streamsize>::max(), '\n' );
+}
+inline void gmshSkipLines( GmshMappedStream& is, std::size_t n ) { is.skipLines( n ); }
+
+//! skip \p n bytes of \p is
+inline void gmshSkipBytes( std::istream& is, std::size_t n ) { is.seekg( n, std::ios_base::cur ); }
+inline void gmshSkipBytes( GmshMappedStream& is, std::size_t n ) { is.skipBytes( n ); }
+
+} // namespace detail
+} // namespace Feel
+
+#endif /* FEELPP_FILTERS_GMSHMAPPEDSTREAM_HPP */
@@ -42,6 +42,7 @@
 #include <feel/feeldiscr/mesh.hpp>
 #include <feel/feelfilters/importer.hpp>
 #include <feel/feelfilters/gmshenums.hpp>
+#include <feel/feelfilters/gmshmappedstream.hpp>
 #include <feel/feeltiming/tic.hpp>
 #include <boost/algorithm/string/trim.hpp>
 
@@ -406,6 +407,7 @@ public:
         M_in_memory( false ),
         M_use_elementary_region_as_physical_region( false ),
         M_respect_partition( false ),
+        M_use_mapped_file( true ),
         M_scale( 1 ),
         M_deleteGModelAfterUse( false )
     {
@@ -421,6 +423,7 @@ public:
         M_in_memory( false ),
         M_use_elementary_region_as_physical_region( false ),
         M_respect_partition( false ),
+        M_use_mapped_file( true ),
         M_scale( 1 ),
         M_deleteGModelAfterUse( false )
     {
@@ -436,6 +439,7 @@ public:
         M_ignorePhysicalGroup( i.M_ignorePhysicalGroup ),
         M_ignorePhysicalName( i.M_ignorePhysicalName ),
         M_respect_partition( i.M_respect_partition ),
+        M_use_mapped_file( i.M_use_mapped_file ),
         M_scale( i.M_scale ),
         M_gmodelName( i.M_gmodelName ),
         M_deleteGModelAfterUse( i.M_deleteGModelAfterUse )
@@ -506,6 +510,14 @@ public:
             M_respect_partition = r;
         }
 
+    /**
+     * read the msh file through a memory map (default) instead of a file
+     * stream: the numbers are parsed in place and the node and element
+     * blocks of the other partitions are skipped without being parsed
+     */
+    void setUseMappedFile( bool b ) { M_use_mapped_file = b; }
+    bool useMappedFile() const { return M_use_mapped_file; }
+
     void setGModelName( std::string const& name ) { M_gmodelName = name; }
 
     void setDeleteGModelAfterUse( bool b ) { M_deleteGModelAfterUse = b; }
@@ -530,10 +542,13 @@ protected:
 private:
     FEELPP_NO_EXPORT void readFromMemory( mesh_type* mesh );
     FEELPP_NO_EXPORT void readFromFile( mesh_type* mesh );
-    FEELPP_NO_EXPORT void readFromFileVersion2( mesh_type* mesh, std::ifstream & __is, std::string __buf,
+    template <typename IStreamType>
+    FEELPP_NO_EXPORT void readFromStream( mesh_type* mesh, IStreamType & __is );
+    template <typename IStreamType>
+    FEELPP_NO_EXPORT void readFromFileVersion2( mesh_type* mesh, IStreamType & __is, std::string __buf,
                                                 double version, bool binary, bool swap );
-    template <typename gmsh_size_type,typename gmsh_size_partition_type,typename gmsh_size_periodiclink_type,typename gmsh_elttag_type>
-    FEELPP_NO_EXPORT void readFromFileVersion4( mesh_type* mesh, std::ifstream & __is, std::string __buf,
+    template <typename gmsh_size_type,typename gmsh_size_partition_type,typename gmsh_size_periodiclink_type,typename gmsh_elttag_type,typename IStreamType>
+    FEELPP_NO_EXPORT void readFromFileVersion4( mesh_type* mesh, IStreamType & __is, std::string __buf,
                                                 double version, bool binary, bool swap );
 
 
@@ -571,6 +586,7 @@ private:
     std::set<std::string> M_ignorePhysicalName;
     bool M_use_elementary_region_as_physical_region;
     bool M_respect_partition;
+    bool M_use_mapped_file;
     double M_scale;
     //std::map<int,int> itoii;
     //std::vector<int> ptseen;
@@ -986,7 +1002,19 @@ void
 ImporterGmsh<MeshType>::readFromFile( mesh_type* mesh )
 {
     tic();
-    LOG(INFO) << "Reading Msh file " << this->filename();
+    LOG(INFO) << "Reading Msh file " << this->filename() << ( M_use_mapped_file ? " (memory mapped)" : "" );
+
+    if ( M_use_mapped_file )
+    {
+        Feel::detail::GmshMappedStream __is( this->filename() );
+        if ( __is.is_open() )
+        {
+            this->readFromStream( mesh, __is );
+            toc("read msh from file", FLAGS_v > 0);
+            return;
+        }
+        // empty files cannot be mapped, fallback on the file stream
+    }
 
     std::ifstream __is ( this->filename().c_str() );
     if ( !__is.is_open() )
@@ -996,7 +1024,16 @@ ImporterGmsh<MeshType>::readFromFile( mesh_type* mesh )
         ostr << "Invalid file name " << this->filename() << " (file not found)\n";
         throw std::invalid_argument( ostr.str() );
     }
+    this->readFromStream( mesh, __is );
+
+    toc("read msh from file", FLAGS_v > 0);
+}
 
+template<typename MeshType>
+template<typename IStreamType>
+void
+ImporterGmsh<MeshType>::readFromStream( mesh_type* mesh, IStreamType & __is )
+{
     //char __buf[256];
     std::string __buf;
     __is >> __buf;
@@ -1097,13 +1134,12 @@ ImporterGmsh<MeshType>::readFromFile( mesh_type* mesh )
         this->readFromFileVersion4<unsigned long,int,int,int>( mesh, __is, __buf, version, binary, swap );
     else
         this->readFromFileVersion4<size_t,size_t,size_t,size_t>( mesh, __is, __buf, version, binary, swap );
-
-    toc("read msh from file", FLAGS_v > 0);
 }
 
 template<typename MeshType>
+template<typename IStreamType>
 void
-ImporterGmsh<MeshType>::readFromFileVersion2( mesh_type* mesh, std::ifstream & __is, std::string __buf,
+ImporterGmsh<MeshType>::readFromFileVersion2( mesh_type* mesh, IStreamType & __is, std::string __buf,
                                               double version, bool binary, bool swap )
 {
     //
@@ -1607,9 +1643,9 @@ ImporterGmsh<MeshType>::readFromFileVersion2( mesh_type* mesh, std::ifstream & _
 }
 
 template<typename MeshType>
-template <typename gmsh_size_type,typename gmsh_size_partition_type,typename gmsh_size_periodiclink_type,typename gmsh_elttag_type>
+template <typename gmsh_size_type,typename gmsh_size_partition_type,typename gmsh_size_periodiclink_type,typename gmsh_elttag_type,typename IStreamType>
 void
-ImporterGmsh<MeshType>::readFromFileVersion4( mesh_type* mesh, std::ifstream & __is, std::string __buf,
+ImporterGmsh<MeshType>::readFromFileVersion4( mesh_type* mesh, IStreamType & __is, std::string __buf,
                                               double version, bool binary, bool swap )
 {
     rank_type procId = this->worldComm().localRank();
@@ -1995,6 +2031,18 @@ ImporterGmsh<MeshType>::readFromFileVersion4( mesh_type* mesh, std::ifstream & _
                 }
             }
 
+            // the nodes of the other partitions are skipped without being parsed
+            if ( !useThisNode )
+            {
+                if ( !binary )
+                    Feel::detail::gmshSkipLines( __is, ( version >= 4.1 ) ? 2*numNodesInBlock : numNodesInBlock );
+                else if ( version >= 4.1 )
+                    Feel::detail::gmshSkipBytes( __is, numNodesInBlock*( sizeof(gmsh_elttag_type)+3*sizeof(double) ) );
+                else
+                    Feel::detail::gmshSkipBytes( __is, numNodesInBlock*( sizeof(int)+3*sizeof(double) ) );
+                continue;
+            }
+
             std::vector<gmsh_elttag_type> nodeIds;
             if ( version >= 4.1 )
             {
@@ -2181,6 +2229,17 @@ ImporterGmsh<MeshType>::readFromFileVersion4( mesh_type* mesh, std::ifstream & _
 #endif
             CHECK(numVertices!=0) << "Unknown number of vertices for element type " << elementType << "\n";
 
+            // the elements of the other partitions are skipped without being parsed, except the
+            // elements of lower dimension of a partitioned mesh which may carry markers of local entities
+            if ( !useThisEntity && ( numPartitions <= 1 || entityDim == mesh_type::nDim ) )
+            {
+                if ( !binary )
+                    Feel::detail::gmshSkipLines( __is, numElementsInBlock );
+                else
+                    Feel::detail::gmshSkipBytes( __is, numElementsInBlock*( numVertices+1 )*sizeof(gmsh_elttag_type) );
+                continue;
+            }
+
             // update current gmsh element with read data
             it_gmshElt.type = elementType;
             it_gmshElt.physical = physicalTag;
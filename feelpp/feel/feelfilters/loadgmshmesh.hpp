@@ -120,6 +120,7 @@ loadGMSHMeshImpl( std::shared_ptr<MeshType> mesh, std::string const& filename, s
         if ( physical_are_elementary_regions )
             import.setElementRegionAsPhysicalRegion( physical_are_elementary_regions );
         import.setRespectPartition( respect_partition );
+        import.setUseMappedFile( boption(_prefix=prefix,_name="gmsh.mmap",_vm=vm) );
         if ( rebuild_partitions && partitions > 1 )
         {
             _mesh_ptrtype _meshSeq = std::make_shared<_mesh_type>( Environment::worldCommSeqPtr() );
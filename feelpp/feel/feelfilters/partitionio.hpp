@@ -25,12 +25,16 @@
 #define FEELPP_FILTERS_PARTITIONIO_H
 
 #if defined(FEELPP_HAS_HDF5)
+#include <unordered_map>
+#include <unordered_set>
+
 #include <boost/algorithm/string/split.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
 
 #include <feel/feelcore/hdf5.hpp>
 #include <feel/feelmesh/meshpartitionset.hpp>
+#include <feel/feelmesh/morton.hpp>
 
 namespace Feel
 {
@@ -56,6 +60,14 @@ namespace pt =  boost::property_tree;
   Creating, opening and closing the HDF5 file is done automatically by the
   object.
 
+  If the number of MPI processes differs from the number of parts stored in
+  the file, the mesh is repartitioned while reading : each process reads a
+  contiguous range of the active elements (one hyperslab per part crossed),
+  the points are gathered through a distributed directory (indexed by point
+  id), the elements are redistributed along a Morton space filling curve of
+  their barycenters and the ghost elements are rebuilt from the vertices
+  shared between processes.
+
   Description of the storage format:
   N - number of mesh parts
 
@@ -235,6 +247,13 @@ private:
     FEELPP_NO_EXPORT void readElements( std::vector<rank_type> const& partIds, std::map<rank_type,std::vector<size_type>> & mapGhostHdf5IdToFeelId );
     FEELPP_NO_EXPORT void readGhostElements( std::vector<rank_type> const& partIds, std::map<rank_type,std::vector<size_type>> const& mapGhostHdf5IdToFeelId );
     FEELPP_NO_EXPORT void readMarkedSubEntities( std::vector<rank_type> const& partIds );
+    // Methods for reading with a number of process different from the number of parts
+    FEELPP_NO_EXPORT void readRepartitioned( double scale );
+    FEELPP_NO_EXPORT void readAllStats();
+    FEELPP_NO_EXPORT void readRepartitionedMarkedSubEntities( std::unordered_map<size_type,std::vector<rank_type>> const& pointIdToProcess );
+    template <typename T>
+    FEELPP_NO_EXPORT void readHyperslabs( std::string const& tableName, hid_t memDataType,
+                                          std::vector<std::pair<size_type,size_type>> const& slabs, std::vector<T> & buffer );
     FEELPP_NO_EXPORT void prepareUpdateForUseStep1();
     FEELPP_NO_EXPORT void prepareUpdateForUseStep2();
 
@@ -399,6 +418,25 @@ void PartitionIO<MeshType>::read (mesh_ptrtype meshParts, size_type ctxMeshUpdat
     rank_type processId = M_meshPartIn->worldComm().localRank();
     rank_type nProcess =  M_meshPartIn->worldComm().localSize();
 
+    if ( nProcess > 1 && M_meshPartIn->numberOfPartitions() != nProcess )
+    {
+        tic();
+        M_HDF5IO.openFile (M_h5_filename, meshParts->worldComm(), true);
+        readRepartitioned( scale );
+        M_HDF5IO.closeFile();
+        toc("PartitionIO reading and repartitioning hdf5 file",FLAGS_v>0);
+
+        prepareUpdateForUseStep1();
+        prepareUpdateForUseStep2();
+
+        tic();
+        M_meshPartIn->components().reset();
+        M_meshPartIn->components().set( ctxMeshUpdate );
+        M_meshPartIn->updateForUse();
+        toc("PartitionIO mesh update for use",FLAGS_v>0);
+        return;
+    }
+
     std::set<rank_type> partIdsSet;
     std::vector<rank_type> countPartByPid(nProcess,0);
     for ( rank_type p=0;p<M_meshPartIn->numberOfPartitions();++p )
@@ -1605,6 +1643,509 @@ void PartitionIO<MeshType>::readMarkedSubEntities( std::vector<rank_type> const&
 
 }
 
+template<typename MeshType>
+template <typename T>
+void PartitionIO<MeshType>::readHyperslabs( std::string const& tableName, hid_t memDataType,
+                                            std::vector<std::pair<size_type,size_type>> const& slabs, std::vector<T> & buffer )
+{
+    // the reads are collective : all the processes do the same number of reads (some of them are empty)
+    int nSlabs = slabs.size(), nSlabsMax = 0;
+    mpi::all_reduce( M_meshPartIn->worldComm().localComm(), nSlabs, nSlabsMax, mpi::maximum<int>() );
+
+    int indexTable0 = 0, indexTable1 = 1;
+    if ( M_transposeInFile )
+    {
+        indexTable0 = 1;
+        indexTable1 = 0;
+    }
+
+    size_type bufferSize = 0;
+    for ( auto const& slab : slabs )
+        bufferSize += slab.second;
+    buffer.resize( bufferSize );
+
+    hsize_t localDims[2];
+    hsize_t offset[2];
+    size_type currentBufferIndex = 0;
+    for ( int k = 0; k < nSlabsMax; ++k )
+    {
+        localDims[indexTable0] = 1;
+        localDims[indexTable1] = ( k < nSlabs )? slabs[k].second : 0;
+        offset[indexTable0] = 0;
+        offset[indexTable1] = ( k < nSlabs )? slabs[k].first : 0;
+        T uselessValue{};
+        T* data = ( localDims[indexTable1] > 0 )? buffer.data() + currentBufferIndex : &uselessValue;
+        M_HDF5IO.read( tableName, memDataType, localDims, offset, data );
+        currentBufferIndex += localDims[indexTable1];
+    }
+}
+
+template<typename MeshType>
+void PartitionIO<MeshType>::readAllStats()
+{
+    // the whole N x 19 table is read at once
+    hsize_t currentSpaceDims[2];
+    hsize_t currentOffset[2] = { 0, 0 };
+    M_HDF5IO.openTable ("stats", currentSpaceDims);
+    rank_type nPart = ( !M_transposeInFile )? currentSpaceDims[0] : currentSpaceDims[1];
+    CHECK( nPart == M_meshPartIn->numberOfPartitions() ) << "number of parts in stats (" << nPart << ") and in meta data (" << M_meshPartIn->numberOfPartitions() << ") differ";
+    M_uintBuffer.resize( currentSpaceDims[0]*currentSpaceDims[1], 0 );
+    M_HDF5IO.read ("stats", H5T_NATIVE_UINT, currentSpaceDims, currentOffset, &M_uintBuffer[0]);
+    M_HDF5IO.closeTable ("stats");
+
+    auto stat = [this,nPart]( rank_type partId, int k ) -> size_type {
+        return ( !M_transposeInFile )? M_uintBuffer[partId*19+k] : M_uintBuffer[k*nPart+partId];
+    };
+    M_numGlobalPoints = stat( 0, 1 );
+    M_numGlobalElements = stat( 0, 4 );
+    M_numGlobalGhostElements = stat( 0, 7 );
+    M_numGlobalMarkedFaces = stat( 0, 10 );
+    M_numGlobalMarkedEdges = stat( 0, 13 );
+    M_numGlobalMarkedPoints = stat( 0, 16 );
+    for ( rank_type partId = 0; partId < nPart; ++partId )
+    {
+        CHECK( stat( partId, 0 ) == partId ) << "invalid stats row " << partId;
+        M_numLocalPoints[partId] = stat( partId, 2 );
+        M_pointsOffSet[partId] = stat( partId, 3 );
+        M_numLocalElements[partId] = stat( partId, 5 );
+        M_elementsOffSet[partId] = stat( partId, 6 );
+        M_numLocalGhostElements[partId] = stat( partId, 8 );
+        M_ghostElementsOffSet[partId] = stat( partId, 9 );
+        M_numLocalMarkedFaces[partId] = stat( partId, 11 );
+        M_markedFacesOffSet[partId] = stat( partId, 12 );
+        M_numLocalMarkedEdges[partId] = stat( partId, 14 );
+        M_markedEdgesOffSet[partId] = stat( partId, 15 );
+        M_numLocalMarkedPoints[partId] = stat( partId, 17 );
+        M_markedPointsOffSet[partId] = stat( partId, 18 );
+    }
+    M_uintBuffer.resize( 0 );
+}
+
+template<typename MeshType>
+void PartitionIO<MeshType>::readRepartitioned( double scale )
+{
+    auto const& theWorldComm = M_meshPartIn->worldComm();
+    auto const& comm = theWorldComm.localComm();
+    const rank_type rank = theWorldComm.localRank();
+    const rank_type nProc = theWorldComm.localSize();
+    const int d = mesh_type::nRealDim;
+    const int nPtsElt = element_type::numPoints;
+    const int nVal = 1 + nPtsElt;// marker+ points
+    // process storing a point in the distributed directory
+    auto directoryProcess = [nProc]( size_type ptId ) -> rank_type { return ptId % nProc; };
+
+    tic();
+    readAllStats();
+    const rank_type nPart = M_meshPartIn->numberOfPartitions();
+    M_meshPartIn->setNumberOfPartitions( nProc );
+    LOG(INFO) << "repartition mesh with " << nPart << " parts on " << nProc << " processes";
+
+    // each process reads a contiguous range of the active elements : the active elements
+    // of a part are the first elements of this part (the ghost ones are not read)
+    std::vector<size_type> activeEltsStart( nPart+1, 0 );
+    for ( rank_type p = 0; p < nPart; ++p )
+        activeEltsStart[p+1] = activeEltsStart[p] + M_numLocalElements[p] - M_numLocalGhostElements[p];
+    const size_type eltStart = ( activeEltsStart[nPart]*rank )/nProc;
+    const size_type eltEnd = ( activeEltsStart[nPart]*(rank+1) )/nProc;
+    std::vector<std::pair<size_type,size_type>> slabs;
+    for ( rank_type p = 0; p < nPart; ++p )
+    {
+        size_type s = std::max( eltStart, activeEltsStart[p] );
+        size_type e = std::min( eltEnd, activeEltsStart[p+1] );
+        if ( s < e )
+            slabs.push_back( std::make_pair( nVal*( M_elementsOffSet[p] + s - activeEltsStart[p] ), nVal*( e - s ) ) );
+    }
+    hsize_t globalDims[2];
+    std::vector<unsigned int> eltsBuffer;
+    M_HDF5IO.openTable ("elements", globalDims);
+    this->readHyperslabs( "elements", H5T_NATIVE_UINT, slabs, eltsBuffer );
+    M_HDF5IO.closeTable ("elements");
+    const size_type nReadElts = eltsBuffer.size()/nVal;
+
+    // each process reads a contiguous range of the points (the points shared by several parts are duplicated)
+    slabs.clear();
+    const size_type ptStart = ( M_numGlobalPoints*rank )/nProc;
+    const size_type ptEnd = ( M_numGlobalPoints*(rank+1) )/nProc;
+    if ( ptStart < ptEnd )
+        slabs.push_back( std::make_pair( ptStart, ptEnd - ptStart ) );
+    std::vector<unsigned int> ptIdsBuffer;
+    M_HDF5IO.openTable ("point_ids", globalDims);
+    this->readHyperslabs( "point_ids", H5T_NATIVE_UINT, slabs, ptIdsBuffer );
+    M_HDF5IO.closeTable ("point_ids");
+    for ( auto & slab : slabs )
+    {
+        slab.first *= d;
+        slab.second *= d;
+    }
+    M_HDF5IO.openTable ("point_coords", globalDims);
+    this->readHyperslabs( "point_coords", H5T_NATIVE_DOUBLE, slabs, M_realBuffer );
+    M_HDF5IO.closeTable ("point_coords");
+    toc("PartitionIO reading hyperslabs",FLAGS_v>0);
+
+    tic();
+    // send the points to the directory
+    std::vector<std::vector<size_type>> idsToSend( nProc ), idsRecv;
+    std::vector<std::vector<double>> coordsToSend( nProc ), coordsRecv;
+    for ( size_type k = 0; k < ptIdsBuffer.size(); ++k )
+    {
+        rank_type dirPid = directoryProcess( ptIdsBuffer[k] );
+        idsToSend[dirPid].push_back( ptIdsBuffer[k] );
+        coordsToSend[dirPid].insert( coordsToSend[dirPid].end(), M_realBuffer.begin()+k*d, M_realBuffer.begin()+(k+1)*d );
+    }
+    M_realBuffer.resize( 0 );
+    mpi::all_to_all( comm, idsToSend, idsRecv );
+    mpi::all_to_all( comm, coordsToSend, coordsRecv );
+    std::unordered_map<size_type,size_type> directoryPointIndex;
+    std::vector<double> directoryCoords;
+    for ( rank_type p = 0; p < nProc; ++p )
+    {
+        for ( size_type k = 0; k < idsRecv[p].size(); ++k )
+        {
+            size_type newIndex = directoryPointIndex.size();
+            if ( directoryPointIndex.emplace( idsRecv[p][k], newIndex ).second )
+                directoryCoords.insert( directoryCoords.end(), coordsRecv[p].begin()+k*d, coordsRecv[p].begin()+(k+1)*d );
+        }
+    }
+
+    // get from the directory the coordinates of the points of the elements read
+    std::unordered_map<size_type,size_type> readPointIndex;
+    for ( auto & ids : idsToSend )
+        ids.clear();
+    for ( size_type k = 0; k < nReadElts; ++k )
+    {
+        for ( int i = 0; i < nPtsElt; ++i )
+        {
+            size_type ptId = eltsBuffer[k*nVal+1+i];
+            if ( readPointIndex.emplace( ptId, invalid_v<size_type> ).second )
+                idsToSend[directoryProcess( ptId )].push_back( ptId );
+        }
+    }
+    mpi::all_to_all( comm, idsToSend, idsRecv );
+    for ( rank_type p = 0; p < nProc; ++p )
+    {
+        coordsToSend[p].clear();
+        for ( size_type ptId : idsRecv[p] )
+        {
+            auto itFindPt = directoryPointIndex.find( ptId );
+            CHECK( itFindPt != directoryPointIndex.end() ) << "point id " << ptId << " not found in directory";
+            coordsToSend[p].insert( coordsToSend[p].end(), directoryCoords.begin()+itFindPt->second*d, directoryCoords.begin()+(itFindPt->second+1)*d );
+        }
+    }
+    mpi::all_to_all( comm, coordsToSend, coordsRecv );
+    std::vector<double> readCoords;
+    readCoords.reserve( d*readPointIndex.size() );
+    for ( rank_type p = 0; p < nProc; ++p )
+    {
+        for ( size_type k = 0; k < idsToSend[p].size(); ++k )
+        {
+            readPointIndex[idsToSend[p][k]] = readCoords.size()/d;
+            readCoords.insert( readCoords.end(), coordsRecv[p].begin()+k*d, coordsRecv[p].begin()+(k+1)*d );
+        }
+    }
+    directoryCoords.clear();
+    directoryCoords.shrink_to_fit();
+    directoryPointIndex.clear();
+
+    // geometric partitioning : the elements are sorted along a Morton curve of their barycenters
+    // and the curve is split with splitters chosen from a regular sampling of the keys
+    std::vector<double> barycenters( d*nReadElts, 0. );
+    std::array<double,3> bminLocal, bmaxLocal, bmin, bmax;
+    bminLocal.fill( std::numeric_limits<double>::max() );
+    bmaxLocal.fill( std::numeric_limits<double>::lowest() );
+    for ( size_type k = 0; k < nReadElts; ++k )
+    {
+        for ( int i = 0; i < nPtsElt; ++i )
+        {
+            size_type ptIndex = readPointIndex.at( eltsBuffer[k*nVal+1+i] );
+            for ( int c = 0; c < d; ++c )
+                barycenters[k*d+c] += readCoords[ptIndex*d+c]/nPtsElt;
+        }
+        for ( int c = 0; c < d; ++c )
+        {
+            bminLocal[c] = std::min( bminLocal[c], barycenters[k*d+c] );
+            bmaxLocal[c] = std::max( bmaxLocal[c], barycenters[k*d+c] );
+        }
+    }
+    mpi::all_reduce( comm, bminLocal.data(), 3, bmin.data(), mpi::minimum<double>() );
+    mpi::all_reduce( comm, bmaxLocal.data(), 3, bmax.data(), mpi::maximum<double>() );
+
+    std::vector<std::uint64_t> keys( nReadElts );
+    for ( size_type k = 0; k < nReadElts; ++k )
+        keys[k] = Feel::detail::mortonKey( barycenters.data()+k*d, bmin, bmax, d );
+    std::vector<std::uint64_t> samples;
+    {
+        std::vector<std::uint64_t> sortedKeys( keys );
+        std::sort( sortedKeys.begin(), sortedKeys.end() );
+        size_type nSamples = std::min( nReadElts, (size_type)4*nProc );
+        for ( size_type i = 0; i < nSamples; ++i )
+            samples.push_back( sortedKeys[( i*nReadElts )/nSamples] );
+    }
+    std::vector<std::vector<std::uint64_t>> allSamples;
+    mpi::all_gather( comm, samples, allSamples );
+    samples.clear();
+    for ( auto const& s : allSamples )
+        samples.insert( samples.end(), s.begin(), s.end() );
+    std::sort( samples.begin(), samples.end() );
+    std::vector<std::uint64_t> splitters( nProc-1, std::numeric_limits<std::uint64_t>::max() );
+    if ( !samples.empty() )
+        for ( rank_type p = 0; p+1 < nProc; ++p )
+            splitters[p] = samples[( (p+1)*samples.size() )/nProc];
+
+    // send the elements (marker, point ids and coordinates) to their new process
+    std::vector<std::vector<size_type>> eltsToSend( nProc ), eltsRecv;
+    for ( auto & coords : coordsToSend )
+        coords.clear();
+    for ( size_type k = 0; k < nReadElts; ++k )
+    {
+        rank_type newPid = std::distance( splitters.begin(), std::upper_bound( splitters.begin(), splitters.end(), keys[k] ) );
+        eltsToSend[newPid].insert( eltsToSend[newPid].end(), eltsBuffer.begin()+k*nVal, eltsBuffer.begin()+(k+1)*nVal );
+        for ( int i = 0; i < nPtsElt; ++i )
+        {
+            size_type ptIndex = readPointIndex.at( eltsBuffer[k*nVal+1+i] );
+            coordsToSend[newPid].insert( coordsToSend[newPid].end(), readCoords.begin()+ptIndex*d, readCoords.begin()+(ptIndex+1)*d );
+        }
+    }
+    mpi::all_to_all( comm, eltsToSend, eltsRecv );
+    mpi::all_to_all( comm, coordsToSend, coordsRecv );
+    toc("PartitionIO repartitioning elements",FLAGS_v>0);
+
+    tic();
+    auto const& mapFragmentIdToMarker_elements = M_mapFragmentIdToMarker.at(ElementsType::MESH_ELEMENTS);
+    node_type coords( d );
+    auto addElementFromData = [&]( size_type const* eltData, double const* eltCoords, rank_type pid )
+        {
+            for ( int i = 0; i < nPtsElt; ++i )
+            {
+                size_type ptId = eltData[1+i];
+                if ( M_meshPartIn->hasPoint( ptId ) )
+                    continue;
+                for ( int c = 0; c < d; ++c )
+                    coords[c] = scale*eltCoords[i*d+c];
+                point_type pt( ptId, coords, false/*onbdy*/ );
+                pt.setProcessIdInPartition( rank );
+                M_meshPartIn->addPoint( pt );
+            }
+            element_type e;
+            e.setProcessIdInPartition( rank );
+            e.setMarker( mapFragmentIdToMarker_elements.at( eltData[0] ) );
+            e.setProcessId( pid );
+            for ( uint16_type k = 0; k < element_type::numPoints; ++k )
+                e.setPoint( k, M_meshPartIn->point( eltData[1+k] ) );
+            if ( pid != rank )
+                e.addNeighborPartitionId( rank );
+            M_meshPartIn->addElement( e, true );
+        };
+
+    // active elements
+    std::vector<size_type> activeEltsData;
+    std::vector<double> activeEltsCoords;
+    for ( rank_type p = 0; p < nProc; ++p )
+    {
+        activeEltsData.insert( activeEltsData.end(), eltsRecv[p].begin(), eltsRecv[p].end() );
+        activeEltsCoords.insert( activeEltsCoords.end(), coordsRecv[p].begin(), coordsRecv[p].end() );
+    }
+    const size_type nActiveElts = activeEltsData.size()/nVal;
+    for ( size_type k = 0; k < nActiveElts; ++k )
+        addElementFromData( activeEltsData.data()+k*nVal, activeEltsCoords.data()+k*nPtsElt*d, rank );
+
+    // register the points of the active elements in the directory to find the processes sharing them
+    std::unordered_set<size_type> activePointIds;
+    for ( size_type k = 0; k < nActiveElts; ++k )
+        activePointIds.insert( activeEltsData.begin()+k*nVal+1, activeEltsData.begin()+(k+1)*nVal );
+    for ( auto & ids : idsToSend )
+        ids.clear();
+    for ( size_type ptId : activePointIds )
+        idsToSend[directoryProcess( ptId )].push_back( ptId );
+    mpi::all_to_all( comm, idsToSend, idsRecv );
+    std::unordered_map<size_type,std::vector<rank_type>> pointIdToProcess;
+    for ( rank_type p = 0; p < nProc; ++p )
+        for ( size_type ptId : idsRecv[p] )
+            pointIdToProcess[ptId].push_back( p );
+
+    // send to each process the processes sharing its points : (ptId,nProcess,pid1,pid2,...)
+    for ( auto & ids : idsToSend )
+        ids.clear();
+    for ( auto const& [ptId,pids] : pointIdToProcess )
+    {
+        if ( pids.size() < 2 )
+            continue;
+        for ( rank_type p : pids )
+        {
+            idsToSend[p].push_back( ptId );
+            idsToSend[p].push_back( pids.size() );
+            idsToSend[p].insert( idsToSend[p].end(), pids.begin(), pids.end() );
+        }
+    }
+    mpi::all_to_all( comm, idsToSend, idsRecv );
+    std::unordered_map<size_type,std::vector<rank_type>> pointIdToNeighborProcess;
+    for ( rank_type p = 0; p < nProc; ++p )
+    {
+        for ( auto it = idsRecv[p].begin(); it != idsRecv[p].end(); )
+        {
+            size_type ptId = *it++;
+            size_type nPid = *it++;
+            auto & neighbors = pointIdToNeighborProcess[ptId];
+            for ( size_type i = 0; i < nPid; ++i, ++it )
+                if ( *it != rank )
+                    neighbors.push_back( *it );
+        }
+    }
+
+    // ghost elements : the active elements touching a point shared with another process are sent to this process
+    for ( rank_type p = 0; p < nProc; ++p )
+    {
+        eltsToSend[p].clear();
+        coordsToSend[p].clear();
+    }
+    std::set<rank_type> neighborPids;
+    for ( size_type k = 0; k < nActiveElts; ++k )
+    {
+        neighborPids.clear();
+        for ( int i = 0; i < nPtsElt; ++i )
+        {
+            auto itFindNeighbors = pointIdToNeighborProcess.find( activeEltsData[k*nVal+1+i] );
+            if ( itFindNeighbors != pointIdToNeighborProcess.end() )
+                neighborPids.insert( itFindNeighbors->second.begin(), itFindNeighbors->second.end() );
+        }
+        for ( rank_type p : neighborPids )
+        {
+            eltsToSend[p].insert( eltsToSend[p].end(), activeEltsData.begin()+k*nVal, activeEltsData.begin()+(k+1)*nVal );
+            coordsToSend[p].insert( coordsToSend[p].end(), activeEltsCoords.begin()+k*nPtsElt*d, activeEltsCoords.begin()+(k+1)*nPtsElt*d );
+        }
+    }
+    mpi::all_to_all( comm, eltsToSend, eltsRecv );
+    mpi::all_to_all( comm, coordsToSend, coordsRecv );
+    std::unordered_set<size_type> ghostPointIds;
+    for ( rank_type p = 0; p < nProc; ++p )
+    {
+        size_type nGhostElts = eltsRecv[p].size()/nVal;
+        for ( size_type k = 0; k < nGhostElts; ++k )
+        {
+            addElementFromData( eltsRecv[p].data()+k*nVal, coordsRecv[p].data()+k*nPtsElt*d, p );
+            for ( int i = 0; i < nPtsElt; ++i )
+            {
+                size_type ptId = eltsRecv[p][k*nVal+1+i];
+                if ( activePointIds.find( ptId ) == activePointIds.end() )
+                    ghostPointIds.insert( ptId );
+            }
+        }
+    }
+
+    // register also the points which are only in the ghost elements (used for the marked sub entities)
+    for ( auto & ids : idsToSend )
+        ids.clear();
+    for ( size_type ptId : ghostPointIds )
+        idsToSend[directoryProcess( ptId )].push_back( ptId );
+    mpi::all_to_all( comm, idsToSend, idsRecv );
+    for ( rank_type p = 0; p < nProc; ++p )
+        for ( size_type ptId : idsRecv[p] )
+            pointIdToProcess[ptId].push_back( p );
+    toc("PartitionIO building ghost elements",FLAGS_v>0);
+
+    tic();
+    this->readRepartitionedMarkedSubEntities( pointIdToProcess );
+    toc("PartitionIO reading marked_subentities",FLAGS_v>0);
+}
+
+template<typename MeshType>
+void PartitionIO<MeshType>::readRepartitionedMarkedSubEntities( std::unordered_map<size_type,std::vector<rank_type>> const& pointIdToProcess )
+{
+    auto const& theWorldComm = M_meshPartIn->worldComm();
+    auto const& comm = theWorldComm.localComm();
+    const rank_type rank = theWorldComm.localRank();
+    const rank_type nProc = theWorldComm.localSize();
+    const rank_type nPart = M_numLocalMarkedFaces.size();
+    auto directoryProcess = [nProc]( size_type ptId ) -> rank_type { return ptId % nProc; };
+
+    // number of values of a sub entity : marker + point ids
+    const std::array<int,3> nValSubEntity = { 1 + face_type::numPoints, 1 + edge_type::numPoints, 1 + 1 };
+
+    // the marked sub entities of a part are contiguous in the table : the parts are distributed on the processes
+    std::vector<std::pair<size_type,size_type>> slabs;
+    std::vector<std::array<size_type,3>> numSubEntitiesInSlabs;
+    for ( rank_type p = rank; p < nPart; p += nProc )
+    {
+        std::array<size_type,3> numSubEntities = { M_numLocalMarkedFaces[p], M_numLocalMarkedEdges[p], M_numLocalMarkedPoints[p] };
+        size_type count = nValSubEntity[0]*numSubEntities[0] + nValSubEntity[1]*numSubEntities[1] + nValSubEntity[2]*numSubEntities[2];
+        if ( count == 0 )
+            continue;
+        slabs.push_back( std::make_pair( nValSubEntity[0]*M_markedFacesOffSet[p] + nValSubEntity[1]*M_markedEdgesOffSet[p] + nValSubEntity[2]*M_markedPointsOffSet[p], count ) );
+        numSubEntitiesInSlabs.push_back( numSubEntities );
+    }
+    hsize_t globalDims[2];
+    std::vector<unsigned int> buffer;
+    M_HDF5IO.openTable ("marked_subentities", globalDims);
+    this->readHyperslabs( "marked_subentities", H5T_NATIVE_UINT, slabs, buffer );
+    M_HDF5IO.closeTable("marked_subentities");
+
+    // send each sub entity (kind,marker,ptId1,...) to the directory process of its first point
+    std::vector<std::vector<size_type>> dataToSend( nProc ), dataRecv;
+    size_type currentBufferIndex = 0;
+    for ( auto const& numSubEntities : numSubEntitiesInSlabs )
+    {
+        for ( int kind = 0; kind < 3; ++kind )
+        {
+            for ( size_type j = 0; j < numSubEntities[kind]; ++j )
+            {
+                auto & data = dataToSend[directoryProcess( buffer[currentBufferIndex+1] )];
+                data.push_back( kind );
+                data.insert( data.end(), buffer.begin()+currentBufferIndex, buffer.begin()+currentBufferIndex+nValSubEntity[kind] );
+                currentBufferIndex += nValSubEntity[kind];
+            }
+        }
+    }
+    mpi::all_to_all( comm, dataToSend, dataRecv );
+
+    // the directory forwards the sub entities to all the processes which have the first point
+    for ( auto & data : dataToSend )
+        data.clear();
+    for ( rank_type p = 0; p < nProc; ++p )
+    {
+        for ( auto it = dataRecv[p].begin(); it != dataRecv[p].end(); )
+        {
+            int kind = *it;
+            auto itEnd = it + 1 + nValSubEntity[kind];
+            auto itFindPt = pointIdToProcess.find( *(it+2) );
+            if ( itFindPt != pointIdToProcess.end() )
+                for ( rank_type pid : itFindPt->second )
+                    dataToSend[pid].insert( dataToSend[pid].end(), it, itEnd );
+            it = itEnd;
+        }
+    }
+    mpi::all_to_all( comm, dataToSend, dataRecv );
+
+    // keep the sub entities whose points are all in the mesh (the duplicates from several parts are removed)
+    std::array<std::vector<unsigned int>,3> subEntitiesBuffer;
+    std::set<std::vector<size_type>> subEntitiesAdded;
+    for ( rank_type p = 0; p < nProc; ++p )
+    {
+        for ( auto it = dataRecv[p].begin(); it != dataRecv[p].end(); )
+        {
+            int kind = *it;
+            auto itEnd = it + 1 + nValSubEntity[kind];
+            bool hasAllPoints = std::all_of( it+2, itEnd, [this]( size_type ptId ) { return M_meshPartIn->hasPoint( ptId ); } );
+            if ( hasAllPoints )
+            {
+                std::vector<size_type> key( it+2, itEnd );
+                std::sort( key.begin(), key.end() );
+                key.push_back( kind );
+                if ( subEntitiesAdded.insert( key ).second )
+                    subEntitiesBuffer[kind].insert( subEntitiesBuffer[kind].end(), it+1, itEnd );
+            }
+            it = itEnd;
+        }
+    }
+
+    M_uintBuffer.clear();
+    for ( auto const& b : subEntitiesBuffer )
+        M_uintBuffer.insert( M_uintBuffer.end(), b.begin(), b.end() );
+    if ( !M_uintBuffer.empty() )
+        Feel::detail::updateMarkedSubEntitiesMesh( M_uintBuffer, std::make_tuple( subEntitiesBuffer[0].size()/nValSubEntity[0],
+                                                                                  subEntitiesBuffer[1].size()/nValSubEntity[1],
+                                                                                  subEntitiesBuffer[2].size()/nValSubEntity[2] ),
+                                                   M_mapFragmentIdToMarker, *M_meshPartIn );
+    M_uintBuffer.resize( 0 );
+}
 
 template<typename MeshType>
 void PartitionIO<MeshType>::prepareUpdateForUseStep1()
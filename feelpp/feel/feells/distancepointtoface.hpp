@@ -229,6 +229,104 @@ distancePointToTriangle(
     return distancePointToTriangle( pt, tri.col(0), tri.col(1), tri.col(2) );
 }
 
+//--------------------------------------------------------------------//
+// Closest points
+// The feature of the segment or triangle which contains the closest point is returned in
+// feature: the vertex i (0 <= i < nVertices), the edge [Pi,Pi+1] (nVertices+i, triangle only)
+// or the interior (last feature: 2 for a segment, 6 for a triangle)
+
+template< typename Derived0, typename Derived1, typename Derived2 >
+Eigen::Matrix<typename Derived0::Scalar, Derived0::RowsAtCompileTime, 1>
+closestPointOnSegment(
+        // Point vertex
+        Eigen::MatrixBase<Derived0> const& P,
+        // Segment vertices
+        Eigen::MatrixBase<Derived1> const& P1,
+        Eigen::MatrixBase<Derived2> const& P2,
+        int & feature
+        )
+{
+    typedef typename Derived0::Scalar value_type;
+
+    auto const P1P2 = P2 - P1;
+    value_type r1 = (P - P1).dot(P1P2);
+    if( r1 <= 0. )
+    {
+        feature = 0;
+        return P1;
+    }
+    value_type r2 = P1P2.squaredNorm();
+    if( r2 <= r1 )
+    {
+        feature = 1;
+        return P2;
+    }
+    feature = 2;
+    return P1 + (r1/r2)*P1P2;
+}
+
+template< typename Derived0, typename Derived1, typename Derived2, typename Derived3 >
+Eigen::Matrix<typename Derived0::Scalar, 3, 1>
+closestPointOnTriangle(
+        // Point vertex
+        Eigen::MatrixBase<Derived0> const& P,
+        // Triangles vertices
+        Eigen::MatrixBase<Derived1> const& P1,
+        Eigen::MatrixBase<Derived2> const& P2,
+        Eigen::MatrixBase<Derived3> const& P3,
+        int & feature
+        )
+{
+    EIGEN_STATIC_ASSERT_VECTOR_SPECIFIC_SIZE(Derived0, 3)
+    typedef typename Derived0::Scalar value_type;
+
+    // Voronoi regions of the triangle features, see Ericson, Real-Time Collision Detection, 5.1.5
+    Eigen::Matrix<value_type, 3, 1> const P1P2 = P2 - P1;
+    Eigen::Matrix<value_type, 3, 1> const P1P3 = P3 - P1;
+    Eigen::Matrix<value_type, 3, 1> const P1P = P - P1;
+    value_type const d1 = P1P2.dot(P1P), d2 = P1P3.dot(P1P);
+    if( d1 <= 0. && d2 <= 0. )
+    {
+        feature = 0;
+        return P1;
+    }
+    Eigen::Matrix<value_type, 3, 1> const P2P = P - P2;
+    value_type const d3 = P1P2.dot(P2P), d4 = P1P3.dot(P2P);
+    if( d3 >= 0. && d4 <= d3 )
+    {
+        feature = 1;
+        return P2;
+    }
+    value_type const vc = d1*d4 - d3*d2;
+    if( vc <= 0. && d1 >= 0. && d3 <= 0. )
+    {
+        feature = 3;
+        return P1 + (d1/(d1-d3))*P1P2;
+    }
+    Eigen::Matrix<value_type, 3, 1> const P3P = P - P3;
+    value_type const d5 = P1P2.dot(P3P), d6 = P1P3.dot(P3P);
+    if( d6 >= 0. && d5 <= d6 )
+    {
+        feature = 2;
+        return P3;
+    }
+    value_type const vb = d5*d2 - d1*d6;
+    if( vb <= 0. && d2 >= 0. && d6 <= 0. )
+    {
+        feature = 5;
+        return P1 + (d2/(d2-d6))*P1P3;
+    }
+    value_type const va = d3*d6 - d5*d4;
+    if( va <= 0. && (d4-d3) >= 0. && (d5-d6) >= 0. )
+    {
+        feature = 4;
+        return P2 + ((d4-d3)/((d4-d3)+(d5-d6)))*(P3-P2);
+    }
+    feature = 6;
+    value_type const denom = 1./(va+vb+vc);
+    return P1 + (vb*denom)*P1P2 + (vc*denom)*P1P3;
+}
+
 } // namespace geometry
 } // namespace detail
 } // namespace Feel
@@ -0,0 +1,493 @@
+//! -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+//!
+//! This file is part of the Feel++ library
+//!
+//! This library is free software; you can redistribute it and/or
+//! modify it under the terms of the GNU Lesser General Public
+//! License as published by the Free Software Foundation; either
+//! version 2.1 of the License, or (at your option) any later version.
+//!
+//! This library is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//! Lesser General Public License for more details.
+//!
+//! You should have received a copy of the GNU Lesser General Public
+//! License along with this library; if not, write to the Free Software
+//! Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//!
+//! @file distancequery.hpp
+//! @copyright 2023 Feel++ Consortium
+//!
+
+#ifndef _DISTANCE_QUERY_HPP
+#define _DISTANCE_QUERY_HPP 1
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <type_traits>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include <feel/feelcore/feel.hpp>
+#include <feel/feelcore/threadpool.hpp>
+#include <feel/feelmesh/widebvh.hpp>
+
+#include <feel/feells/eigenmap.hpp>
+#include <feel/feells/distancepointtoface.hpp>
+
+namespace Feel {
+
+/**
+ * Methods computing the distance to a set of faces
+ * - FastMarching : exact distance on the dofs neighbouring the faces, then fast-marching
+ * - SpatialIndex : exact distance of all the dofs by nearest face queries (DistanceQuery)
+ */
+enum class DistanceMethod { FastMarching = 0, SpatialIndex = 1 };
+
+template< int RealDim >
+struct DistanceQueryResult
+{
+    typedef Eigen::Matrix<double, RealDim, 1> point_type;
+
+    //! distance to the closest face, negative behind the faces when the sign is computed
+    double distance = std::numeric_limits<double>::max();
+    //! closest point on the faces
+    point_type closestPoint = point_type::Zero();
+    //! id of the closest face on the process which owns it
+    size_type faceId = invalid_v<size_type>;
+    rank_type processId = invalid_v<rank_type>;
+
+    bool found() const { return faceId != invalid_v<size_type>; }
+};
+
+/**
+ * Nearest face queries on a set of segments (2D) or triangles (3D).
+ *
+ * The faces are indexed once in a bounding volume hierarchy, a query then
+ * only computes the distance to the faces whose box is closer than the
+ * closest face found so far. The queries of a set of points are done
+ * concurrently.
+ *
+ * In parallel, each process receives only the faces which can be the closest
+ * face of a point of its query box (by default the whole space, i.e. all the
+ * faces) : a face is sent if its box is closer to the query box than the
+ * farthest point of the query box to the nearest face box.
+ *
+ * The sign is given by the angle weighted pseudo-normal of the closest
+ * feature (vertex, edge or face) of the closest face, which is consistent on
+ * a closed surface whatever the face reached. The faces of a range of mesh
+ * faces are oriented outward of their inside element : the only element of a
+ * boundary face, the element given by the \c isInside predicate of update()
+ * for an interior face (the sign is not available without it). The distance
+ * is then negative inside, as with the fast-marching. The elements of a
+ * surface mesh are oriented by their vertex order.
+ *
+ * @code
+ * DistanceQuery<3> query( boundaryfaces( mesh ), 4 );
+ * auto res = query.nearest( Xh, -1., true ); // signed distance of all the dofs of Xh
+ * // interface between the elements marked "inside" and the other ones
+ * DistanceQuery<3> queryInterface( 4 );
+ * queryInterface.update( interfaceFaces, queryInterface.dofPointsBox( Xh ), -1.,
+ *                        [flag = mesh->markerId( "inside" )]( auto const& elt ) { return elt.hasMarker() && elt.marker().value() == flag; } );
+ * @endcode
+ */
+template< int RealDim >
+class DistanceQuery
+{
+    static_assert( RealDim == 2 || RealDim == 3, "Dimension must be 2 or 3" );
+    public:
+        typedef DistanceQuery< RealDim > self_type;
+
+        static constexpr int nRealDim = RealDim;
+        //! segments in 2D, triangles in 3D
+        static constexpr int nVerticesPerFace = RealDim;
+        static constexpr int nEdgesPerFace = ( RealDim == 3 ) ? 3 : 0;
+        //! vertices, edges and interior of a face
+        static constexpr int nFeaturesPerFace = nVerticesPerFace + nEdgesPerFace + 1;
+
+        typedef Eigen::Matrix<double, RealDim, 1> point_type;
+        typedef Eigen::AlignedBox<double, RealDim> box_type;
+        typedef DistanceQueryResult<RealDim> result_type;
+        typedef WideBVH<RealDim> bvh_type;
+
+    public:
+        //--------------------------------------------------------------------//
+        // Constructors
+        DistanceQuery() = default;
+        explicit DistanceQuery( int nThreads ) : M_nThreads( std::max( 1, nThreads ) ) {}
+        template< typename RangeType >
+        explicit DistanceQuery( RangeType const& rangeFaces, int nThreads = 1 ) :
+            M_nThreads( std::max( 1, nThreads ) )
+        {
+            this->update( rangeFaces );
+        }
+
+        //--------------------------------------------------------------------//
+        // Accessors
+        int nThreads() const { return M_nThreads; }
+        void setNThreads( int n ) { M_nThreads = std::max( 1, n ); }
+
+        //! number of faces indexed on this process
+        size_type nFaces() const { return M_faceIds.size(); }
+        bvh_type const& bvh() const { return M_bvh; }
+        //! true if all the faces are oriented, i.e. the sign is available
+        bool isOriented() const { return M_isOriented; }
+
+        //! box of the whole space
+        static box_type infiniteBox()
+        {
+            return box_type( point_type::Constant( -std::numeric_limits<double>::infinity() ),
+                             point_type::Constant( std::numeric_limits<double>::infinity() ) );
+        }
+        //! box of the local dof points of the scalar space \p Xh
+        template< typename SpaceType >
+        static box_type dofPointsBox( std::shared_ptr<SpaceType> const& Xh );
+
+        //--------------------------------------------------------------------//
+        // Index
+        /**
+         * index the faces of \p rangeFaces (range of faces or of elements of a
+         * surface mesh) which can be the closest face of a point of \p queryBox
+         * closer than \p maxDistance (no limit if negative). \p isInside(elt)
+         * gives the inside element of the interior faces, which orients them.
+         * Collective on the communicator of the mesh.
+         */
+        template< typename RangeType, typename InsideType = std::nullptr_t >
+        void update( RangeType const& rangeFaces, box_type const& queryBox = infiniteBox(), double maxDistance = -1.,
+                     InsideType const& isInside = nullptr );
+
+        //--------------------------------------------------------------------//
+        // Queries
+        /**
+         * closest face to \p pt. The faces farther than \p maxDistance are
+         * ignored (no limit if negative) : the result is then not found.
+         */
+        result_type nearest( point_type const& pt, double maxDistance = -1., bool withSign = false ) const;
+
+        //! closest faces to the points \p pts, computed on nThreads() threads
+        std::vector<result_type> nearest( std::vector<point_type> const& pts, double maxDistance = -1., bool withSign = false ) const;
+
+        //! closest faces to the local dof points of the scalar space \p Xh
+        template< typename SpaceType >
+        std::vector<result_type> nearest( std::shared_ptr<SpaceType> const& Xh, double maxDistance = -1., bool withSign = false ) const;
+
+    private:
+        void build( std::vector<double> const& vertices, std::vector<size_type> const& faceIds, std::vector<rank_type> const& processIds );
+        void updatePseudoNormals();
+
+        point_type closestPoint( size_type k, point_type const& pt, int & feature ) const;
+
+    private:
+        int M_nThreads = 1;
+        bool M_isOriented = true;
+        bvh_type M_bvh;
+        //! vertices, ids and pseudo-normals of the faces, stored in the order of the leaves of the hierarchy
+        Eigen::Matrix<double, RealDim, Eigen::Dynamic> M_vertices;
+        Eigen::Matrix<double, RealDim, Eigen::Dynamic> M_pseudoNormals;
+        std::vector<size_type> M_faceIds;
+        std::vector<rank_type> M_processIds;
+};
+
+template< int RealDim >
+template< typename SpaceType >
+typename DistanceQuery< RealDim >::box_type
+DistanceQuery< RealDim >::dofPointsBox( std::shared_ptr<SpaceType> const& Xh )
+{
+    static_assert( SpaceType::nRealDim == RealDim, "invalid space dimension" );
+    box_type box;
+    for( size_type k = 0; k < Xh->nLocalDof(); ++k )
+        box.extend( eigenMap<RealDim>( boost::get<0>( Xh->dof()->dofPoint( k ) ) ) );
+    return box;
+}
+
+template< int RealDim >
+template< typename RangeType, typename InsideType >
+void
+DistanceQuery< RealDim >::update( RangeType const& rangeFaces, box_type const& queryBox, double maxDistance, InsideType const& isInside )
+{
+    auto const& mesh = rangeFaces.mesh();
+    auto const& comm = mesh->worldComm().localComm();
+    rank_type const pid = mesh->worldComm().localRank();
+    rank_type const nProc = mesh->worldComm().localSize();
+
+    // Local faces, oriented outward of their inside element
+    std::vector<double> vertices;
+    std::vector<size_type> faceIds;
+    bool isOriented = true;
+    for( auto const& facew: rangeFaces )
+    {
+        auto const& face = boost::unwrap_ref( facew );
+        if( face.processId() != pid )
+            continue;
+        Eigen::Matrix<double, RealDim, nVerticesPerFace> F = eigenMap<RealDim>( face.vertices() ).leftCols( nVerticesPerFace );
+        if constexpr ( std::decay_t<RangeType>::entities() == MESH_FACES )
+        {
+            bool const isInterior = face.isConnectedTo0() && face.isConnectedTo1();
+            bool insideIs0 = face.isConnectedTo0();
+            if constexpr ( std::is_same_v<InsideType, std::nullptr_t> )
+                isOriented = isOriented && !isInterior;
+            else if( isInterior )
+                insideIs0 = isInside( face.element0() );
+            point_type n;
+            if constexpr ( RealDim == 2 )
+                n = point_type( F(1,1)-F(1,0), F(0,0)-F(0,1) );
+            else
+                n = ( F.col(1)-F.col(0) ).cross( F.col(2)-F.col(0) );
+            point_type const eltBarycenter = eigenMap<RealDim>( insideIs0 ? face.element0().barycenter() : face.element1().barycenter() );
+            if( n.dot( F.rowwise().mean() - eltBarycenter ) < 0. )
+                F.col(0).swap( F.col(1) );
+        }
+        vertices.insert( vertices.end(), F.data(), F.data()+RealDim*nVerticesPerFace );
+        faceIds.push_back( face.id() );
+    }
+
+    if( nProc == 1 )
+    {
+        M_isOriented = isOriented;
+        this->build( vertices, faceIds, std::vector<rank_type>( faceIds.size(), pid ) );
+        return;
+    }
+    M_isOriented = mpi::all_reduce( comm, isOriented, std::logical_and<bool>() );
+
+    size_type const nLocalFaces = faceIds.size();
+    std::vector<box_type, Eigen::aligned_allocator<box_type>> faceBoxes( nLocalFaces );
+    for( size_type f = 0; f < nLocalFaces; ++f )
+    {
+        Eigen::Map<const Eigen::Matrix<double, RealDim, nVerticesPerFace>> F( vertices.data()+RealDim*nVerticesPerFace*f );
+        faceBoxes[f] = box_type( F.rowwise().minCoeff(), F.rowwise().maxCoeff() );
+    }
+
+    // Query boxes of all the processes (an empty box requires no face)
+    std::vector<double> localBox( 2*RealDim );
+    Eigen::Map<point_type>( localBox.data() ) = queryBox.min();
+    Eigen::Map<point_type>( localBox.data()+RealDim ) = queryBox.max();
+    std::vector< std::vector<double> > allBoxes;
+    mpi::all_gather( comm, localBox, allBoxes );
+    std::vector<box_type, Eigen::aligned_allocator<box_type>> queryBoxes( nProc );
+    for( rank_type p = 0; p < nProc; ++p )
+        queryBoxes[p] = box_type( Eigen::Map<const point_type>( allBoxes[p].data() ), Eigen::Map<const point_type>( allBoxes[p].data()+RealDim ) );
+
+    // Upper bound of the distance of the points of each query box to their closest face
+    auto maxSquaredDistance = []( box_type const& a, box_type const& b ) {
+        return ( a.max()-b.min() ).cwiseAbs().cwiseMax( ( b.max()-a.min() ).cwiseAbs() ).squaredNorm();
+    };
+    std::vector<double> localBounds( nProc, std::numeric_limits<double>::infinity() );
+    for( rank_type p = 0; p < nProc; ++p )
+    {
+        if( queryBoxes[p].isEmpty() )
+            continue;
+        for( box_type const& fb: faceBoxes )
+            localBounds[p] = std::min( localBounds[p], maxSquaredDistance( queryBoxes[p], fb ) );
+    }
+    std::vector<double> bounds( nProc );
+    mpi::all_reduce( comm, localBounds.data(), nProc, bounds.data(), mpi::minimum<double>() );
+
+    // Send to each process the faces which can be the closest face of one of its points
+    double const d2maxDistance = ( maxDistance < 0. ) ? std::numeric_limits<double>::infinity() : maxDistance*maxDistance;
+    std::vector< std::vector<double> > verticesToSend( nProc ), verticesToRecv;
+    std::vector< std::vector<size_type> > faceIdsToSend( nProc ), faceIdsToRecv;
+    for( rank_type p = 0; p < nProc; ++p )
+    {
+        if( queryBoxes[p].isEmpty() )
+            continue;
+        double const d2max = std::min( bounds[p], d2maxDistance );
+        for( size_type f = 0; f < nLocalFaces; ++f )
+        {
+            if( queryBoxes[p].squaredExteriorDistance( faceBoxes[f] ) > d2max )
+                continue;
+            verticesToSend[p].insert( verticesToSend[p].end(), vertices.data()+RealDim*nVerticesPerFace*f, vertices.data()+RealDim*nVerticesPerFace*(f+1) );
+            faceIdsToSend[p].push_back( faceIds[f] );
+        }
+    }
+    mpi::all_to_all( comm, verticesToSend, verticesToRecv );
+    mpi::all_to_all( comm, faceIdsToSend, faceIdsToRecv );
+
+    vertices.clear();
+    faceIds.clear();
+    std::vector<rank_type> processIds;
+    for( rank_type p = 0; p < nProc; ++p )
+    {
+        vertices.insert( vertices.end(), verticesToRecv[p].begin(), verticesToRecv[p].end() );
+        faceIds.insert( faceIds.end(), faceIdsToRecv[p].begin(), faceIdsToRecv[p].end() );
+        processIds.insert( processIds.end(), faceIdsToRecv[p].size(), p );
+    }
+
+    this->build( vertices, faceIds, processIds );
+}
+
+template< int RealDim >
+void
+DistanceQuery< RealDim >::build( std::vector<double> const& vertices, std::vector<size_type> const& faceIds, std::vector<rank_type> const& processIds )
+{
+    size_type const nFaces = faceIds.size();
+    Eigen::Map<const Eigen::Matrix<double, RealDim, Eigen::Dynamic>> V( vertices.data(), RealDim, nVerticesPerFace*nFaces );
+
+    // Hierarchy of the face boxes
+    std::vector<double> boxes( 2*RealDim*nFaces );
+    for( size_type f = 0; f < nFaces; ++f )
+    {
+        auto const F = V.middleCols( nVerticesPerFace*f, nVerticesPerFace );
+        Eigen::Map<point_type>( boxes.data()+2*RealDim*f ) = F.rowwise().minCoeff();
+        Eigen::Map<point_type>( boxes.data()+2*RealDim*f+RealDim ) = F.rowwise().maxCoeff();
+    }
+    typename bvh_type::Config config;
+    config.nThreads = M_nThreads;
+    M_bvh = bvh_type( config );
+    M_bvh.build( boxes );
+
+    // Store the faces in the order of the leaves
+    M_vertices.resize( RealDim, nVerticesPerFace*nFaces );
+    M_faceIds.resize( nFaces );
+    M_processIds.resize( nFaces );
+    for( size_type k = 0; k < nFaces; ++k )
+    {
+        size_type const f = M_bvh.primitiveId( k );
+        M_vertices.middleCols( nVerticesPerFace*k, nVerticesPerFace ) = V.middleCols( nVerticesPerFace*f, nVerticesPerFace );
+        M_faceIds[k] = faceIds[f];
+        M_processIds[k] = processIds[f];
+    }
+
+    this->updatePseudoNormals();
+}
+
+template< int RealDim >
+void
+DistanceQuery< RealDim >::updatePseudoNormals()
+{
+    // The faces sharing a vertex or an edge are found by the vertex coordinates,
+    // which are the same on all the processes
+    typedef std::array<double, RealDim> vertex_key_type;
+    auto vertexKey = [this]( size_type k, int i ) {
+        vertex_key_type key;
+        Eigen::Map<point_type>( key.data() ) = M_vertices.col( nVerticesPerFace*k+i );
+        return key;
+    };
+    auto edgeKey = [&vertexKey]( size_type k, int i ) {
+        return std::make_pair( std::min( vertexKey( k, i ), vertexKey( k, (i+1)%3 ) ),
+                               std::max( vertexKey( k, i ), vertexKey( k, (i+1)%3 ) ) );
+    };
+
+    size_type const nFaces = M_faceIds.size();
+    Eigen::Matrix<double, RealDim, Eigen::Dynamic> faceNormals( RealDim, nFaces );
+    std::map<vertex_key_type, point_type> vertexNormals;
+    std::map<std::pair<vertex_key_type, vertex_key_type>, point_type> edgeNormals;
+    for( size_type k = 0; k < nFaces; ++k )
+    {
+        auto const F = M_vertices.middleCols( nVerticesPerFace*k, nVerticesPerFace );
+        if constexpr ( RealDim == 2 )
+        {
+            faceNormals.col(k) = point_type( F(1,1)-F(1,0), F(0,0)-F(0,1) ).normalized();
+            for( int i = 0; i < nVerticesPerFace; ++i )
+            {
+                auto it = vertexNormals.try_emplace( vertexKey( k, i ), point_type::Zero() ).first;
+                it->second += faceNormals.col(k);
+            }
+        }
+        else
+        {
+            faceNormals.col(k) = ( F.col(1)-F.col(0) ).cross( F.col(2)-F.col(0) ).normalized();
+            for( int i = 0; i < nVerticesPerFace; ++i )
+            {
+                point_type const e1 = ( F.col((i+1)%3) - F.col(i) ).normalized();
+                point_type const e2 = ( F.col((i+2)%3) - F.col(i) ).normalized();
+                double const angle = std::acos( std::clamp( e1.dot( e2 ), -1., 1. ) );
+                auto it = vertexNormals.try_emplace( vertexKey( k, i ), point_type::Zero() ).first;
+                it->second += angle*faceNormals.col(k);
+
+                auto ite = edgeNormals.try_emplace( edgeKey( k, i ), point_type::Zero() ).first;
+                ite->second += faceNormals.col(k);
+            }
+        }
+    }
+
+    M_pseudoNormals.resize( RealDim, nFeaturesPerFace*nFaces );
+    for( size_type k = 0; k < nFaces; ++k )
+    {
+        for( int i = 0; i < nVerticesPerFace; ++i )
+            M_pseudoNormals.col( nFeaturesPerFace*k+i ) = vertexNormals[vertexKey( k, i )];
+        for( int i = 0; i < nEdgesPerFace; ++i )
+            M_pseudoNormals.col( nFeaturesPerFace*k+nVerticesPerFace+i ) = edgeNormals[edgeKey( k, i )];
+        M_pseudoNormals.col( nFeaturesPerFace*k+nFeaturesPerFace-1 ) = faceNormals.col(k);
+    }
+}
+
+template< int RealDim >
+typename DistanceQuery< RealDim >::point_type
+DistanceQuery< RealDim >::closestPoint( size_type k, point_type const& pt, int & feature ) const
+{
+    auto const F = M_vertices.middleCols( nVerticesPerFace*k, nVerticesPerFace );
+    if constexpr ( RealDim == 2 )
+        return Feel::detail::geometry::closestPointOnSegment( pt, F.col(0), F.col(1), feature );
+    else
+        return Feel::detail::geometry::closestPointOnTriangle( pt, F.col(0), F.col(1), F.col(2), feature );
+}
+
+template< int RealDim >
+typename DistanceQuery< RealDim >::result_type
+DistanceQuery< RealDim >::nearest( point_type const& pt, double maxDistance, bool withSign ) const
+{
+    result_type res;
+    size_type closestFace = invalid_v<size_type>;
+    int closestFeature = -1;
+    double d2max = ( maxDistance < 0. ) ? std::numeric_limits<double>::max() : maxDistance*maxDistance;
+    M_bvh.nearest( pt.array(), d2max, [&]( std::int32_t first, std::int32_t n, double & d2max )
+            {
+                for( size_type k = first; k < size_type( first+n ); ++k )
+                {
+                    int feature;
+                    point_type const C = this->closestPoint( k, pt, feature );
+                    double const d2 = ( pt-C ).squaredNorm();
+                    if( d2 < d2max || ( closestFace == invalid_v<size_type> && d2 <= d2max ) )
+                    {
+                        d2max = d2;
+                        closestFace = k;
+                        closestFeature = feature;
+                        res.closestPoint = C;
+                    }
+                }
+            } );
+    if( closestFace == invalid_v<size_type> )
+        return res;
+
+    CHECK( !withSign || M_isOriented ) << "the sign needs the inside element of the interior faces (isInside of update)";
+    res.distance = std::sqrt( d2max );
+    res.faceId = M_faceIds[closestFace];
+    res.processId = M_processIds[closestFace];
+    if( withSign && ( pt-res.closestPoint ).dot( M_pseudoNormals.col( nFeaturesPerFace*closestFace+closestFeature ) ) < 0. )
+        res.distance = -res.distance;
+    return res;
+}
+
+template< int RealDim >
+std::vector<typename DistanceQuery< RealDim >::result_type>
+DistanceQuery< RealDim >::nearest( std::vector<point_type> const& pts, double maxDistance, bool withSign ) const
+{
+    std::vector<result_type> res( pts.size() );
+    parallelForChunks( pts.size(), M_nThreads, [&]( size_type begin, size_type end )
+            {
+                for( size_type i = begin; i < end; ++i )
+                    res[i] = this->nearest( pts[i], maxDistance, withSign );
+            } );
+    return res;
+}
+
+template< int RealDim >
+template< typename SpaceType >
+std::vector<typename DistanceQuery< RealDim >::result_type>
+DistanceQuery< RealDim >::nearest( std::shared_ptr<SpaceType> const& Xh, double maxDistance, bool withSign ) const
+{
+    static_assert( SpaceType::nRealDim == RealDim, "invalid space dimension" );
+    std::vector<point_type> pts( Xh->nLocalDof() );
+    for( size_type k = 0; k < pts.size(); ++k )
+        pts[k] = eigenMap<RealDim>( boost::get<0>( Xh->dof()->dofPoint( k ) ) );
+    return this->nearest( pts, maxDistance, withSign );
+}
+
+} // namespace Feel
+
+#endif // _DISTANCE_QUERY_HPP
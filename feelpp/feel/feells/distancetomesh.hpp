@@ -36,6 +36,7 @@
 #include "geometryconceptwrappers.hpp"
 #include "trianglesintersect.hpp"
 #include "distancepointtoface.hpp"
+#include "distancequery.hpp"
 
 namespace Feel {
 
@@ -79,6 +80,10 @@ class DistanceToMesh
         typedef ReinitializerFMS< functionspace_distance_type > fastmarching_type;
         typedef std::shared_ptr<fastmarching_type> fastmarching_ptrtype;
 
+        //--------------------------------------------------------------------//
+        // Nearest surface element queries
+        typedef DistanceQuery<nRealDim> distance_query_type;
+
     public:
         //--------------------------------------------------------------------//
         // Constructor
@@ -94,6 +99,17 @@ class DistanceToMesh
         // Fast-marching
         fastmarching_ptrtype const& fastMarching() const;
 
+        //--------------------------------------------------------------------//
+        // Options
+        /*
+         * Unsigned distance computation method: SpatialIndex computes the exact
+         * distance of all the dofs to the surface elements
+         */
+        DistanceMethod method() const { return M_method; }
+        void setMethod( DistanceMethod m ) { M_method = m; M_doUpdateUnsignedDistance = true; M_doUpdateSignedDistance = true; }
+        int nThreads() const { return M_nThreads; }
+        void setNThreads( int n ) { M_nThreads = std::max( 1, n ); }
+
         //--------------------------------------------------------------------//
         // Geometry
         static bool segmentsIntersect( matrix_node_type const& seg1, matrix_node_type const& seg2 );
@@ -122,6 +138,9 @@ class DistanceToMesh
 
         fastmarching_ptrtype M_fastMarching;
 
+        DistanceMethod M_method = DistanceMethod::FastMarching;
+        int M_nThreads = 1;
+
         mutable std::unordered_map< size_type, Eigen::Matrix<value_type,3,3> > M_meshSurfaceTriangleTransformationMatrices;
 
         std::unordered_set< size_type > M_intersectingElements;
@@ -415,6 +434,17 @@ DistanceToMesh< MeshType, FunctionSpaceType >::updateUnsignedDistance()
 {
     if( !M_unsignedDistance )
         M_unsignedDistance.reset( new element_distance_type( this->functionSpaceDistance(), "unsignedDistance" ) );
+    if( M_method == DistanceMethod::SpatialIndex )
+    {
+        // Exact distance of all the dofs (ghosts included) to the surface elements
+        distance_query_type distanceQuery( this->nThreads() );
+        distanceQuery.update( elements( this->meshSurface() ), distance_query_type::dofPointsBox( this->functionSpaceDistance() ) );
+        auto const res = distanceQuery.nearest( this->functionSpaceDistance() );
+        for( size_type dofId = 0; dofId < res.size(); ++dofId )
+            M_unsignedDistance->set( dofId, res[dofId].distance );
+        M_doUpdateUnsignedDistance = false;
+        return;
+    }
     // Find intersecting elements
     if( M_doUpdateIntersectingElements )
         this->updateIntersectingElements();
@@ -30,6 +30,7 @@
 #define _DISTANCE_TO_RANGE_HPP 1
 
 #include <algorithm>
+#include <thread>
 
 #include <feel/feelcore/feel.hpp>
 #include <feel/feeldiscr/functionspace.hpp>
@@ -42,6 +43,7 @@
 
 #include <feel/feells/geometryconceptwrappers.hpp>
 #include <feel/feells/distancepointtoface.hpp>
+#include <feel/feells/distancequery.hpp>
 
 namespace Feel {
 
@@ -84,6 +86,11 @@ class DistanceToRange
         //--------------------------------------------------------------------//
         typedef std::unordered_map< size_type, std::vector< size_type > > map_face_dofs_type;
 
+        //--------------------------------------------------------------------//
+        // Nearest face queries
+        typedef DistanceQuery<nRealDim> distance_query_type;
+        typedef typename distance_query_type::result_type distance_query_result_type;
+
     public:
         //--------------------------------------------------------------------//
         // Constructor
@@ -112,6 +119,16 @@ class DistanceToRange
          */
         value_type fastMarchingStride() const { return M_fastMarchingStride; }
         void setFastMarchingStride( const value_type & stride ) { M_fastMarchingStride = stride; }
+        /*
+         * Distance computation method
+         */
+        DistanceMethod method() const { return M_method; }
+        void setMethod( DistanceMethod m ) { M_method = m; }
+        /*
+         * Number of threads of the nearest face queries (SpatialIndex method)
+         */
+        int nThreads() const { return M_nThreads; }
+        void setNThreads( int n ) { M_nThreads = ( n > 0 ) ? n : std::max( 1u, std::thread::hardware_concurrency() ); }
 
         //--------------------------------------------------------------------//
         // Geometry
@@ -123,14 +140,27 @@ class DistanceToRange
         element_distance_type unsignedDistance( RangeType && rangeFaces ) const;
         template< typename RangeType >
         element_distance_type signedDistance( RangeType && rangeFaces ) const;
+        /*
+         * Signed distance, closest point and face id of the closest face of
+         * rangeFaces for all the local dofs, limited to maxDistance.
+         * The sign is the one of signedDistance
+         */
+        template< typename RangeType >
+        std::vector<distance_query_result_type> nearestFaces( RangeType && rangeFaces ) const;
 
     private:
+        template< typename RangeType >
+        element_distance_type distanceToFacesFromSpatialIndex( RangeType && rangeFaces, bool withSign ) const;
+
         template< typename RangeType >
         element_distance_type unsignedDistanceToFaces( RangeType && rangeFaces ) const;
 
         template< typename RangeType >
         element_distance_type signedDistanceToFaces( RangeType && rangeFaces ) const;
 
+        template< typename RangeType >
+        void setSignFromDomainBoundary( element_distance_type & distance, RangeType && rangeFaces ) const;
+
         template< typename RangeType >
         range_elements_distance_type const& eltsTouchingFaces( RangeType && rangeFaces ) const;
 
@@ -144,6 +174,8 @@ class DistanceToRange
 
         value_type M_maxDistance = -1.;
         value_type M_fastMarchingStride = -1.;
+        DistanceMethod M_method = DistanceMethod::FastMarching;
+        int M_nThreads = 1;
 
         mutable range_elements_distance_type M_eltsTouchingFaces;
         mutable std::unordered_map< size_type, std::vector< size_type > > M_dofsNeighbouringFaces;
@@ -202,6 +234,8 @@ template< typename RangeType >
 typename DistanceToRange< FunctionSpaceType >::element_distance_type
 DistanceToRange< FunctionSpaceType >::unsignedDistance( RangeType && rangeFaces ) const
 {
+    if( M_method == DistanceMethod::SpatialIndex )
+        return this->distanceToFacesFromSpatialIndex( std::forward<RangeType>(rangeFaces), false );
     return this->unsignedDistanceToFaces( std::forward<RangeType>(rangeFaces) );
 }
 
@@ -210,9 +244,64 @@ template< typename RangeType >
 typename DistanceToRange< FunctionSpaceType >::element_distance_type
 DistanceToRange< FunctionSpaceType >::signedDistance( RangeType && rangeFaces ) const
 {
+    if( M_method == DistanceMethod::SpatialIndex )
+        return this->distanceToFacesFromSpatialIndex( std::forward<RangeType>(rangeFaces), true );
     return this->signedDistanceToFaces( std::forward<RangeType>(rangeFaces) );
 }
 
+template< typename FunctionSpaceType >
+template< typename RangeType >
+std::vector<typename DistanceToRange< FunctionSpaceType >::distance_query_result_type>
+DistanceToRange< FunctionSpaceType >::nearestFaces( RangeType && rangeFaces ) const
+{
+    static_assert(decay_type<RangeType>::entities() == MESH_FACES, "RangeType must have entities() == MESH_FACES");
+
+    // Index the faces once, then query all the dofs
+    distance_query_type distanceQuery( this->nThreads() );
+    distanceQuery.update( rangeFaces, distance_query_type::dofPointsBox( this->functionSpaceDistance() ), this->maxDistance() );
+    auto res = distanceQuery.nearest( this->functionSpaceDistance(), this->maxDistance() );
+    // Same sign as the fast-marching
+    auto signedDistance = this->functionSpaceDistance()->element( "signedDistance" );
+    signedDistance.setConstant( std::numeric_limits<value_type>::max() );
+    for( size_type dofId = 0; dofId < res.size(); ++dofId )
+    {
+        if( res[dofId].found() )
+            signedDistance(dofId) = res[dofId].distance;
+    }
+    this->setSignFromDomainBoundary( signedDistance, std::forward<RangeType>(rangeFaces) );
+    for( size_type dofId = 0; dofId < res.size(); ++dofId )
+    {
+        if( res[dofId].found() )
+            res[dofId].distance = signedDistance(dofId);
+    }
+    return res;
+}
+
+template< typename FunctionSpaceType >
+template< typename RangeType >
+typename DistanceToRange< FunctionSpaceType >::element_distance_type
+DistanceToRange< FunctionSpaceType >::distanceToFacesFromSpatialIndex( RangeType && rangeFaces, bool withSign ) const
+{
+    static_assert(decay_type<RangeType>::entities() == MESH_FACES, "RangeType must have entities() == MESH_FACES");
+
+    auto distance = this->functionSpaceDistance()->element( withSign ? "signedDistance" : "unsignedDistance" );
+    // The dofs farther than maxDistance keep an arbitrarily large value
+    distance.setConstant( std::numeric_limits<value_type>::max() );
+    // Each process receives the faces which can be the closest face of its dofs (ghosts included): no sync needed
+    distance_query_type distanceQuery( this->nThreads() );
+    distanceQuery.update( rangeFaces, distance_query_type::dofPointsBox( this->functionSpaceDistance() ), this->maxDistance() );
+    auto const res = distanceQuery.nearest( this->functionSpaceDistance(), this->maxDistance() );
+    for( size_type dofId = 0; dofId < res.size(); ++dofId )
+    {
+        if( res[dofId].found() )
+            distance(dofId) = res[dofId].distance;
+    }
+    // Same sign as the fast-marching
+    if( withSign )
+        this->setSignFromDomainBoundary( distance, std::forward<RangeType>(rangeFaces) );
+    return distance;
+}
+
 template< typename FunctionSpaceType >
 template< typename RangeType >
 typename DistanceToRange< FunctionSpaceType >::element_distance_type
@@ -265,24 +354,39 @@ DistanceToRange< FunctionSpaceType >::signedDistanceToFaces( RangeType && rangeF
 {
     static_assert(decay_type<RangeType>::entities() == MESH_FACES, "RangeType must have entities() == MESH_FACES");
 
-    // Compute unsigned distance
-    // Set sign: set negative everywhere, then propagate + sign from the domain boundary
-    // note: the element container (VectorUblas) does not provide unary operators at the moment -> TODO: need to improve
-    // note2: elements touching the faces are cached by unsignedDistanceToFaces in M_eltsTouchingFaces
     auto signedDistance = this->unsignedDistanceToFaces( std::forward<RangeType>(rangeFaces) );
-    signedDistance->scale( -1. );
+    this->setSignFromDomainBoundary( signedDistance, std::forward<RangeType>(rangeFaces) );
+    return signedDistance;
+}
+
+template< typename FunctionSpaceType >
+template< typename RangeType >
+void
+DistanceToRange< FunctionSpaceType >::setSignFromDomainBoundary( element_distance_type & signedDistance, RangeType && rangeFaces ) const
+{
+    // Set sign: set negative everywhere, then propagate + sign from the domain boundary
+    // up to the elements touching the faces: the distance is negative in the regions
+    // enclosed by the faces (inside the domain for its boundary faces)
+    std::unordered_set< size_type > eltsTouchingFacesIds;
+    for( auto const& eltw: this->eltsTouchingFaces( std::forward<RangeType>(rangeFaces) ) )
+        eltsTouchingFacesIds.insert( boost::unwrap_ref( eltw ).id() );
+    signedDistance.scale( -1. );
 
     // Communication
     rank_type const pidMeshDistance = this->meshDistance()->worldCommPtr()->localRank();
     std::set<rank_type> const& neighborSubdomainsMeshDistance = this->meshDistance()->neighborSubdomains();
     int nRequests = 2*neighborSubdomainsMeshDistance.size();
-    mpi::request * mpiRequests = new mpi::request[nRequests];
+    std::vector<mpi::request> mpiRequests( nRequests );
 
     std::unordered_set< size_type > eltsToVisit, eltsVisited;
-    auto const& intersectingElements = this->intersectingElements();
-    auto const rangeMeshBoundaryElements = boundaryelements( this->meshDistance() );
-    std::for_each( rangeMeshBoundaryElements.begin(), rangeMeshBoundaryElements.end(),
-            [&eltsToVisit]( auto const& elt ) { eltsToVisit.insert( elt.id() ); } );
+    // elements with a face on the domain boundary
+    auto const rangeMeshBoundaryElements = boundaryelements( this->meshDistance(), mesh_distance_type::nDim-1, mesh_distance_type::nDim-1 );
+    for( auto const& eltw: rangeMeshBoundaryElements )
+    {
+        auto const& elt = boost::unwrap_ref( eltw );
+        if( elt.processId() == pidMeshDistance && eltsTouchingFacesIds.find( elt.id() ) == eltsTouchingFacesIds.end() )
+            eltsToVisit.insert( elt.id() );
+    }
 
     bool eltsToVisitIsEmptyOnAllProc = false;
     while( !eltsToVisitIsEmptyOnAllProc )
@@ -320,8 +424,8 @@ DistanceToRange< FunctionSpaceType >::signedDistanceToFaces( RangeType && rangeF
                     continue;
                 }
                 if( eltsVisited.find( neighId ) != eltsVisited.end()
-                        // stop when reaching an intersecting elt
-                        || intersectingElements.find( neighId ) != intersectingElements.end() )
+                        // stop when reaching an elt touching the faces
+                        || eltsTouchingFacesIds.find( neighId ) != eltsTouchingFacesIds.end() )
                     continue;
                 // need to visit neighbor
                 eltsToVisit.insert( neighId );
@@ -337,7 +441,7 @@ DistanceToRange< FunctionSpaceType >::signedDistanceToFaces( RangeType && rangeF
             mpiRequests[cntRequests++] = this->meshDistance()->worldCommPtr()->localComm().isend( neighborRank, 0, dataToSend[neighborRank] );
             mpiRequests[cntRequests++] = this->meshDistance()->worldCommPtr()->localComm().irecv( neighborRank, 0, dataToRecv[neighborRank] );
         }
-        mpi::wait_all( mpiRequests, mpiRequests + cntRequests );
+        mpi::wait_all( mpiRequests.data(), mpiRequests.data() + cntRequests );
 
         /* Process received ghosts */
         for( auto const& data: dataToRecv )
@@ -345,8 +449,8 @@ DistanceToRange< FunctionSpaceType >::signedDistanceToFaces( RangeType && rangeF
             for( size_type const eltId: data.second )
             {
                 if( eltsVisited.find( eltId ) != eltsVisited.end()
-                        // stop when reaching an intersecting elt
-                        || M_eltsTouchingFaces->find( eltId ) != intersectingElements.end() )
+                        // stop when reaching an elt touching the faces
+                        || eltsTouchingFacesIds.find( eltId ) != eltsTouchingFacesIds.end() )
                     continue;
                 // need to visit neighbor
                 eltsToVisit.insert( eltId );
@@ -360,12 +464,7 @@ DistanceToRange< FunctionSpaceType >::signedDistanceToFaces( RangeType && rangeF
                 std::logical_and<bool>() );
     }
 
-    delete [] mpiRequests;
-
     sync( signedDistance, "max" );
-
-    // Return
-    return signedDistance;
 }
 
 template< typename FunctionSpaceType >
@@ -440,9 +539,11 @@ DistanceToRange< FunctionSpaceType >::dofsNeighbouringFaces( RangeType && rangeF
 namespace na::distancetorange {
     using max_distance = NA::named_argument_t<struct max_distance_tag>;
     using fm_stride = NA::named_argument_t<struct fm_stride_tag>;
+    using distance_method = NA::named_argument_t<struct distance_method_tag>;
 }
 inline constexpr auto& _max_distance = NA::identifier<na::distancetorange::max_distance>;
 inline constexpr auto& _fm_stride = NA::identifier<na::distancetorange::fm_stride>;
+inline constexpr auto& _distance_method = NA::identifier<na::distancetorange::distance_method>;
 
 template< typename ... Args >
 auto distanceToRange( Args && ... nargs )
@@ -452,9 +553,13 @@ auto distanceToRange( Args && ... nargs )
     auto && range = args.get( _range );
     double maxDistance = args.get_else( _max_distance, -1. );
     double fastMarchingStride = args.get_else( _fm_stride, -1. );
+    DistanceMethod method = args.get_else( _distance_method, DistanceMethod::FastMarching );
+    int nThreads = args.get_else( _nthreads, 1 );
     DistanceToRange distToRange( std::forward<decltype(space)>(space) );
     distToRange.setMaxDistance( maxDistance );
     distToRange.setFastMarchingStride( fastMarchingStride );
+    distToRange.setMethod( method );
+    distToRange.setNThreads( nThreads );
     return distToRange.unsignedDistance( std::forward<decltype(range)>(range) );
 }
 
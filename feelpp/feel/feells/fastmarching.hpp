@@ -32,11 +32,21 @@
 #include <feel/feelcore/feel.hpp>
 #include <feel/feeldiscr/functionspace.hpp>
 
+#include <thread>
+
 #include "fastmarchingdofstatus.hpp"
 #include "simplexeikonalsolver.hpp"
 
 namespace Feel {
 
+/**
+ * Eikonal solvers of FastMarching
+ * - FMM : fast marching, sequential narrow band heap on each rank
+ * - FIM : fast iterative method, the active dofs are updated concurrently
+ *   (multithreaded) and the ghost dofs are exchanged during the local updates
+ */
+enum class FastMarchingMethod { FMM = 0, FIM = 1 };
+
 template< typename FunctionSpaceType, template < typename > class LocalEikonalSolver = SimplexEikonalSolver >
 class FastMarching: private LocalEikonalSolver< FunctionSpaceType >
 {
@@ -289,6 +299,22 @@ class FastMarching: private LocalEikonalSolver< FunctionSpaceType >
          */
         value_type stride() const { return M_stride; }
         void setStride( const value_type & s ) { M_stride = s; }
+        /*
+         * Eikonal solver (fast marching by default)
+         */
+        FastMarchingMethod method() const { return M_method; }
+        void setMethod( FastMarchingMethod m ) { M_method = m; }
+        /*
+         * Number of threads of the fast iterative method (0 for the hardware concurrency)
+         */
+        int nThreads() const { return M_nThreads; }
+        void setNThreads( int n ) { M_nThreads = ( n > 0 ) ? n : std::max( 1u, std::thread::hardware_concurrency() ); }
+        /*
+         * Minimal number of active dofs updated by each thread of the fast iterative method
+         * (64 by default : the active lists are often small, each update is a local eikonal solve)
+         */
+        size_type grainSize() const { return M_grainSize; }
+        void setGrainSize( size_type n ) { M_grainSize = std::max( size_type( 1 ), n ); }
 
         //--------------------------------------------------------------------//
         // Result
@@ -306,7 +332,12 @@ class FastMarching: private LocalEikonalSolver< FunctionSpaceType >
 
         void syncDofs( element_type & sol, const value_type & positiveBound = -1., const value_type & negativeBound = -1. );
 
+        void initDoneDofs( element_type const& sol, range_elements_type const& rangeDone );
+
         element_type runImpl( element_type const& phi, range_elements_type const& rangeDone );
+        element_type runFastIterative( element_type const& phi, range_elements_type const& rangeDone );
+        value_type fastIterativeUpdate( size_type dofId, element_type const& sol );
+        bool isInNarrowBand( value_type const& val ) const;
 
     private:
         functionspace_ptrtype M_space;
@@ -316,6 +347,10 @@ class FastMarching: private LocalEikonalSolver< FunctionSpaceType >
 
         value_type M_stride = -1.;
 
+        FastMarchingMethod M_method = FastMarchingMethod::FMM;
+        int M_nThreads = 1;
+        size_type M_grainSize = 64;
+
         std::map< size_type, std::set< rank_type > > M_dofSharedOnCluster;
         std::map< size_type, size_type > M_mapSharedDofGlobalClusterToGlobalProcess;
 
@@ -28,6 +28,7 @@
 
 
 #include <feel/feeldiscr/syncdofs.hpp>
+#include <feel/feelcore/threadpool.hpp>
 
 #include "fastmarching.hpp"
 
@@ -116,6 +117,8 @@ template< typename FunctionSpaceType, template < typename > class LocalEikonalSo
 typename FastMarching< FunctionSpaceType, LocalEikonalSolver >::element_type
 FastMarching< FunctionSpaceType, LocalEikonalSolver >::run( element_type const& phi, range_elements_type const& rangeDone )
 {
+    if( M_method == FastMarchingMethod::FIM )
+        return this->runFastIterative( phi, rangeDone );
     return this->runImpl( phi, rangeDone );
 }
 
@@ -128,53 +131,10 @@ FastMarching< FunctionSpaceType, LocalEikonalSolver >::runImpl( element_type con
     sol = phi;
 
     // Initialize helper structures
-    std::fill( M_dofStatus.begin(), M_dofStatus.end(), FastMarchingDofStatus::FAR );
     M_positiveCloseDofHeap.clear();
     M_negativeCloseDofHeap.clear();
+    this->initDoneDofs( sol, rangeDone );
 
-    // Initialize DONE dofs
-    auto itEltDone = rangeDone.begin();
-    auto enEltDone = rangeDone.end();
-    for( ; itEltDone != enEltDone; ++itEltDone )
-    {
-        auto const eltDone = boost::unwrap_ref( *itEltDone );
-        size_type const eltDoneId = eltDone.id();
-#ifdef DEBUG_FM_COUT
-        std::cout << "["<<this->mesh()->worldCommPtr()->localRank()<<"]" 
-            << "fixing elt " << eltDoneId << " with dofs { ";
-#endif
-        for( auto const& lDof: this->functionSpace()->dof()->localDof( eltDoneId ) )
-        {
-            size_type dofId = lDof.second.index();
-            M_dofStatus[dofId] = FastMarchingDofStatus::DONE_FIX;
-#ifdef DEBUG_FM_COUT
-            std::cout << "(" 
-                << lDof.first.localDof() << ","
-                << dofId << ","
-                << this->functionSpace()->dof()->mapGlobalProcessToGlobalCluster( dofId ) << "; "
-                << sol( dofId ) << "); ";
-#endif
-        }
-#ifdef DEBUG_FM_COUT
-        std::cout << " }" << std::endl;
-#endif
-    }
-    Feel::syncDofs( M_dofStatus, *sol.dof(), rangeDone,
-            []( FastMarchingDofStatus curStatus, std::set<FastMarchingDofStatus> ghostVals ) 
-            -> FastMarchingDofStatus
-            {
-                if( curStatus == FastMarchingDofStatus::DONE_FIX )
-                    return FastMarchingDofStatus::DONE_FIX;
-                for( auto const& ghostStatus: ghostVals )
-                {
-                    if( ghostStatus == FastMarchingDofStatus::DONE_FIX )
-                    {
-                        return FastMarchingDofStatus::DONE_FIX;
-                    }
-                }
-                return curStatus;
-            }
-            );
     // Initialize CLOSE (M_closeDofHeap) dofs
     for( size_type dofId = 0; dofId < this->functionSpace()->nLocalDofWithGhost(); ++dofId )
     {
@@ -289,6 +249,57 @@ FastMarching< FunctionSpaceType, LocalEikonalSolver >::runImpl( element_type con
 }
 
 
+template< typename FunctionSpaceType, template < typename > class LocalEikonalSolver >
+void
+FastMarching< FunctionSpaceType, LocalEikonalSolver >::initDoneDofs( element_type const& sol, range_elements_type const& rangeDone )
+{
+    std::fill( M_dofStatus.begin(), M_dofStatus.end(), FastMarchingDofStatus::FAR );
+
+    // Initialize DONE dofs
+    auto itEltDone = rangeDone.begin();
+    auto enEltDone = rangeDone.end();
+    for( ; itEltDone != enEltDone; ++itEltDone )
+    {
+        auto const eltDone = boost::unwrap_ref( *itEltDone );
+        size_type const eltDoneId = eltDone.id();
+#ifdef DEBUG_FM_COUT
+        std::cout << "["<<this->mesh()->worldCommPtr()->localRank()<<"]" 
+            << "fixing elt " << eltDoneId << " with dofs { ";
+#endif
+        for( auto const& lDof: this->functionSpace()->dof()->localDof( eltDoneId ) )
+        {
+            size_type dofId = lDof.second.index();
+            M_dofStatus[dofId] = FastMarchingDofStatus::DONE_FIX;
+#ifdef DEBUG_FM_COUT
+            std::cout << "(" 
+                << lDof.first.localDof() << ","
+                << dofId << ","
+                << this->functionSpace()->dof()->mapGlobalProcessToGlobalCluster( dofId ) << "; "
+                << sol( dofId ) << "); ";
+#endif
+        }
+#ifdef DEBUG_FM_COUT
+        std::cout << " }" << std::endl;
+#endif
+    }
+    Feel::syncDofs( M_dofStatus, *sol.dof(), rangeDone,
+            []( FastMarchingDofStatus curStatus, std::set<FastMarchingDofStatus> ghostVals ) 
+            -> FastMarchingDofStatus
+            {
+                if( curStatus == FastMarchingDofStatus::DONE_FIX )
+                    return FastMarchingDofStatus::DONE_FIX;
+                for( auto const& ghostStatus: ghostVals )
+                {
+                    if( ghostStatus == FastMarchingDofStatus::DONE_FIX )
+                    {
+                        return FastMarchingDofStatus::DONE_FIX;
+                    }
+                }
+                return curStatus;
+            }
+            );
+}
+
 template< typename FunctionSpaceType, template < typename > class LocalEikonalSolver >
 void
 FastMarching< FunctionSpaceType, LocalEikonalSolver >::updateNeighborDofs( size_type dofDoneId, element_type & sol )
@@ -567,5 +578,184 @@ FastMarching< FunctionSpaceType, LocalEikonalSolver >::syncDofs( element_type &
     delete [] mpiRequests;
 }
 
+template< typename FunctionSpaceType, template < typename > class LocalEikonalSolver >
+bool
+FastMarching< FunctionSpaceType, LocalEikonalSolver >::isInNarrowBand( value_type const& val ) const
+{
+    if( val >= 0. )
+        return M_positiveNarrowBandWidth <= 0. || val <= M_positiveNarrowBandWidth;
+    else
+        return M_negativeNarrowBandWidth <= 0. || -val <= M_negativeNarrowBandWidth;
+}
+
+template< typename FunctionSpaceType, template < typename > class LocalEikonalSolver >
+typename FastMarching< FunctionSpaceType, LocalEikonalSolver >::value_type
+FastMarching< FunctionSpaceType, LocalEikonalSolver >::fastIterativeUpdate( size_type dofId, element_type const& sol )
+{
+    // The dof keeps its sign, it is updated from the DONE dofs of the same
+    // sign (or zero) of the elements containing it
+    value_type const dofVal = sol(dofId);
+    int const dofSgn = ( dofVal < 0. ) ? -1 : 1;
+    value_type minAbsVal = std::abs( dofVal );
+    auto const& [beg,end] = this->functionSpace()->dof()->globalDof( dofId );
+    std::vector< size_type > dofDoneIds;
+    for( auto eltIt = beg; eltIt != end; ++eltIt )
+    {
+        size_type const eltId = eltIt->second.elementId();
+        dofDoneIds.clear();
+        for( auto const& [lid,gid]: this->functionSpace()->dof()->localDof( eltId ) )
+        {
+            size_type const neighId = gid.index();
+            if( neighId == dofId || !( M_dofStatus[neighId] & FastMarchingDofStatus::DONE ) )
+                continue;
+            value_type const neighVal = sol(neighId);
+            if( neighVal != 0. && ( ( neighVal < 0. ) ? -1 : 1 ) != dofSgn )
+                continue;
+            dofDoneIds.push_back( neighId );
+        }
+        if( dofDoneIds.empty() )
+            continue;
+        // the smallest DONE value is kept by all the sub-simplices of the local solver
+        auto minIt = std::min_element( dofDoneIds.begin(), dofDoneIds.end(),
+                [&sol]( size_type a, size_type b ) { return std::abs( sol(a) ) < std::abs( sol(b) ); } );
+        std::iter_swap( dofDoneIds.begin(), minIt );
+        auto const vals = this->solveEikonal( { dofId }, dofDoneIds, eltId, sol );
+        auto valIt = vals.find( dofId );
+        if( valIt != vals.end() && valIt->second < minAbsVal )
+            minAbsVal = valIt->second;
+    }
+    return dofSgn*minAbsVal;
+}
+
+template< typename FunctionSpaceType, template < typename > class LocalEikonalSolver >
+typename FastMarching< FunctionSpaceType, LocalEikonalSolver >::element_type
+FastMarching< FunctionSpaceType, LocalEikonalSolver >::runFastIterative( element_type const& phi, range_elements_type const& rangeDone )
+{
+    auto const& dofTable = this->functionSpace()->dof();
+    size_type const nDofs = dofTable->nLocalDofWithGhost();
+    auto const& localComm = dofTable->worldCommPtr()->localComm();
+    bool const isParallel = dofTable->worldCommPtr()->localSize() > 1;
+
+    element_type sol = this->functionSpace()->element();
+    sol = phi;
+    this->initDoneDofs( sol, rangeDone );
+    // the dof points are generated before the concurrent updates
+    if( nDofs > 0 )
+        dofTable->dofPoint( 0 );
+
+    // Active list: the dofs which have a DONE neighbor updated
+    std::vector< size_type > activeDofs, nextActiveDofs;
+    std::vector< char > isActive( nDofs, 0 );
+    auto activateNeighbors = [&]( size_type dofId, std::vector< size_type > & active )
+        {
+            auto const& [beg,end] = dofTable->globalDof( dofId );
+            for( auto eltIt = beg; eltIt != end; ++eltIt )
+            {
+                for( auto const& [lid,gid]: dofTable->localDof( eltIt->second.elementId() ) )
+                {
+                    size_type const neighId = gid.index();
+                    if( neighId == dofId || isActive[neighId] || M_dofStatus[neighId] == FastMarchingDofStatus::DONE_FIX )
+                        continue;
+                    isActive[neighId] = 1;
+                    active.push_back( neighId );
+                }
+            }
+        };
+    for( size_type dofId = 0; dofId < nDofs; ++dofId )
+        if( M_dofStatus[dofId] == FastMarchingDofStatus::DONE_FIX )
+            activateNeighbors( dofId, activeDofs );
+
+    std::vector< value_type > newValues;
+    auto updateLocally = [&]()
+        {
+            // Jacobi sweeps over the active list: the new values are computed
+            // concurrently from the current ones, then applied
+            while( !activeDofs.empty() )
+            {
+                newValues.resize( activeDofs.size() );
+                parallelForChunks( activeDofs.size(), M_nThreads,
+                        [&]( size_type begin, size_type end )
+                        {
+                            for( size_type k = begin; k < end; ++k )
+                                newValues[k] = this->fastIterativeUpdate( activeDofs[k], sol );
+                        }, M_grainSize );
+                for( size_type dofId: activeDofs )
+                    isActive[dofId] = 0;
+                nextActiveDofs.clear();
+                for( size_type k = 0; k < activeDofs.size(); ++k )
+                {
+                    size_type const dofId = activeDofs[k];
+                    value_type const newVal = newValues[k];
+                    value_type const curVal = sol(dofId);
+                    bool const isDone = M_dofStatus[dofId] & FastMarchingDofStatus::DONE;
+                    if( !less_abs<value_type>()( newVal, curVal )
+                            || ( isDone && std::abs( curVal ) - std::abs( newVal ) <= 1e-12 * std::abs( curVal ) ) )
+                        continue;
+                    sol(dofId) = newVal;
+                    M_dofStatus[dofId] = FastMarchingDofStatus::DONE_NEW;
+                    if( this->isInNarrowBand( newVal ) )
+                        activateNeighbors( dofId, nextActiveDofs );
+                }
+                std::swap( activeDofs, nextActiveDofs );
+            }
+        };
+
+    std::vector< mpi::request > mpiRequests;
+    while( true )
+    {
+        // Send the shared dofs updated by the previous local iterations
+        std::map< rank_type, std::vector< std::pair<size_type, value_type> > > dataToSend, dataToRecv;
+        if( isParallel )
+        {
+            for( auto const& [dofId,pids]: M_dofSharedOnCluster )
+            {
+                if( !( M_dofStatus[dofId] & FastMarchingDofStatus::NEW ) )
+                    continue;
+                M_dofStatus[dofId] &= ~FastMarchingDofStatus::NEW;
+                M_dofStatus[dofId] |= FastMarchingDofStatus::OLD;
+                size_type const dofGCId = dofTable->mapGlobalProcessToGlobalCluster( dofId );
+                for( rank_type p: pids )
+                    dataToSend[p].emplace_back( dofGCId, sol(dofId) );
+            }
+            mpiRequests.clear();
+            for( rank_type p: dofTable->neighborSubdomains() )
+            {
+                mpiRequests.push_back( localComm.isend( p, 0, dataToSend[p] ) );
+                mpiRequests.push_back( localComm.irecv( p, 0, dataToRecv[p] ) );
+            }
+        }
+
+        // Local updates overlapping the communications
+        updateLocally();
+
+        if( !isParallel )
+            break;
+
+        mpi::wait_all( mpiRequests.begin(), mpiRequests.end() );
+        for( auto const& dataR: dataToRecv )
+        {
+            for( auto const& [dofGCId,valNew]: dataR.second )
+            {
+                size_type const dofId = M_mapSharedDofGlobalClusterToGlobalProcess[dofGCId];
+                if( M_dofStatus[dofId] == FastMarchingDofStatus::DONE_FIX || !less_abs<value_type>()( valNew, sol(dofId) ) )
+                    continue;
+                sol.set( dofId, valNew );
+                M_dofStatus[dofId] = FastMarchingDofStatus::DONE_OLD;
+                if( this->isInNarrowBand( valNew ) )
+                    activateNeighbors( dofId, activeDofs );
+            }
+        }
+
+        // Converged when there is no active dof and no shared dof to send on all ranks
+        bool hasNewSharedDofs = std::any_of( M_dofSharedOnCluster.begin(), M_dofSharedOnCluster.end(),
+                [this]( auto const& d ) { return M_dofStatus[d.first] & FastMarchingDofStatus::NEW; } );
+        bool isConverged = activeDofs.empty() && !hasNewSharedDofs;
+        if( mpi::all_reduce( this->functionSpace()->worldComm(), isConverged, std::logical_and<bool>() ) )
+            break;
+    }
+
+    return sol;
+}
+
 } // namespace Feel
 
@@ -9,11 +9,14 @@
 #include <bvh/v2/bvh.h>
 #include <bvh/v2/default_builder.h>
 #include <bvh/v2/stack.h>
+#include <bvh/v2/thread_pool.h>
 #include <bvh/v2/tri.h>
 
 #include <feel/feelcore/feel.hpp>
 #include <feel/feelalg/glas.hpp>
 #include <feel/feeldiscr/mesh.hpp>
+#include <feel/feelcore/threadpool.hpp>
+#include <feel/feelmesh/widebvh.hpp>
 
 namespace Feel
 {
@@ -225,6 +228,12 @@ public:
     //! return primitive info at index i
     BVHPrimitiveInfo const& primitiveInfo( index_type i ) const { return M_primitiveInfo.at( i ); }
 
+    //! number of threads used to build the tree and to trace the batches of rays
+    int nThreads() const { return M_nThreads; }
+
+    //! set the number of threads (hardware concurrency if 0), to be called before updateForUse
+    void setNThreads( int n ) { M_nThreads = n > 0 ? n : std::max( 1u, std::thread::hardware_concurrency() ); }
+
     //! compute intersection(s) with a ray from the BVH built and return a vector of intersection result
     template<typename... Ts>
     auto intersect( Ts && ... v )
@@ -267,12 +276,32 @@ public:
             {
                 std::vector<std::vector<rayintersection_result_type>> resSeq;
                 resSeq.reserve( ray.size() );
-                for ( auto const& currentRay : ray )
+                if ( ctx == IntersectContext::all )
+                {
+                    for ( auto const& currentRay : ray )
+                        resSeq.push_back( this->intersectSequential( currentRay,useRobustTraversal ) );
+                }
+                else
                 {
-                    auto currentResSeq = this->intersectSequential( currentRay,useRobustTraversal );
-                    if ( closestOnly && currentResSeq.size() > 1 )
-                        currentResSeq.resize(1);
-                    resSeq.push_back( std::move( currentResSeq ) );
+                    // one intersection by ray : the rays are traced by batches
+                    std::vector<ray_type> raysContiguous;
+                    ray_type const* raysData = nullptr;
+                    if constexpr ( std::is_same_v<std::decay_t<decltype(ray)>,std::vector<ray_type>> )
+                        raysData = ray.data();
+                    else
+                    {
+                        raysContiguous.assign( ray.begin(), ray.end() );
+                        raysData = raysContiguous.data();
+                    }
+                    std::vector<rayintersection_result_type> resBatch( ray.size() );
+                    this->intersectClosest( raysData, ray.size(), resBatch.data(), useRobustTraversal );
+                    for ( auto & currentRes : resBatch )
+                    {
+                        if ( currentRes.primitiveId() != invalid_v<index_type> )
+                            resSeq.push_back( { std::move( currentRes ) } );
+                        else
+                            resSeq.push_back( {} );
+                    }
                 }
                 if ( !parallel )
                     return resSeq;
@@ -348,10 +377,54 @@ public:
 #endif
             }
         }
+
+    /**
+     * compute the closest intersection of \p nRays rays with the primitives of this process
+     * (no communication). The id of the primitive hit (or invalid_v<index_type>) is written
+     * in \p primitiveIds. Once the BVH is built, it can be called concurrently from several threads.
+     */
+    void intersectClosest( ray_type const* rays, std::size_t nRays, index_type* primitiveIds, bool useRobustTraversal = true )
+        {
+            parallelForChunks( nRays, M_nThreads, [&]( std::size_t begin, std::size_t end ) {
+                                                      this->intersectClosestSequential( rays+begin, end-begin, primitiveIds+begin, useRobustTraversal );
+                                                  } );
+        }
+
+    /**
+     * compute the closest intersection of \p nRays rays with the primitives of this process
+     * (no communication), \p res[k] has an invalid primitive id if the ray \c k hits nothing.
+     * The rays are split among nThreads() threads.
+     */
+    void intersectClosest( ray_type const* rays, std::size_t nRays, rayintersection_result_type* res, bool useRobustTraversal = true )
+        {
+            parallelForChunks( nRays, M_nThreads, [&]( std::size_t begin, std::size_t end ) {
+                                                      this->intersectClosestSequential( rays+begin, end-begin, res+begin, useRobustTraversal );
+                                                  } );
+        }
 protected:
 
     virtual std::vector<rayintersection_result_type> intersectSequential( ray_type const& rayon, bool useRobustTraversal = true ) = 0;
 
+    //! default implementation of the batch of closest intersections, based on intersectSequential
+    virtual void intersectClosestSequential( ray_type const* rays, std::size_t nRays, index_type* primitiveIds, bool useRobustTraversal )
+        {
+            for ( std::size_t k = 0; k < nRays; ++k )
+            {
+                auto res = this->intersectSequential( rays[k], useRobustTraversal );
+                primitiveIds[k] = res.empty() ? invalid_v<index_type> : res.front().primitiveId();
+            }
+        }
+
+    //! default implementation of the batch of closest intersections with the results, based on intersectSequential
+    virtual void intersectClosestSequential( ray_type const* rays, std::size_t nRays, rayintersection_result_type* res, bool useRobustTraversal )
+        {
+            for ( std::size_t k = 0; k < nRays; ++k )
+            {
+                auto resRay = this->intersectSequential( rays[k], useRobustTraversal );
+                res[k] = resRay.empty() ? rayintersection_result_type{} : std::move( resRay.front() );
+            }
+        }
+
     template <typename RangeType>
     void
     updateForUse( RangeType const& range )
@@ -370,6 +443,7 @@ protected:
 protected:
     std::vector<BVHPrimitiveInfo> M_primitiveInfo;
     BVHEnum::Quality M_quality = BVHEnum::Quality::High;
+    int M_nThreads = 1;
 };
 
 
@@ -380,6 +454,7 @@ class BVH_ThirdParty : public BVH<MeshEntityType>
 {
     using super_type = BVH<MeshEntityType>;
     using mesh_entity_type = typename super_type::mesh_entity_type;
+    using index_type = typename super_type::index_type;
     using vector_realdim_type = typename super_type::vector_realdim_type;
     static constexpr uint16_type nRealDim = super_type::nRealDim;
 
@@ -427,8 +502,13 @@ public:
             case BVHEnum::Quality::Medium: config.quality = bvh::v2::DefaultBuilder<node_type>::Quality::Medium; break;
             case BVHEnum::Quality::Low: config.quality = bvh::v2::DefaultBuilder<node_type>::Quality::Low; break;
             }
-            if ( !bboxes.empty() )
-                M_bvh = std::make_unique<backend_bvh_type>( bvh::v2::DefaultBuilder<node_type>::build(/*thread_pool,*/ bboxes, centers, config) );
+            if ( !bboxes.empty() && this->nThreads() > 1 )
+            {
+                bvh::v2::ThreadPool threadPool( this->nThreads() );
+                M_bvh = std::make_unique<backend_bvh_type>( bvh::v2::DefaultBuilder<node_type>::build( threadPool, bboxes, centers, config ) );
+            }
+            else if ( !bboxes.empty() )
+                M_bvh = std::make_unique<backend_bvh_type>( bvh::v2::DefaultBuilder<node_type>::build( bboxes, centers, config ) );
             else
                 M_bvh.reset();
 
@@ -458,6 +538,7 @@ public:
         }
 
 private:
+    using super_type::intersectClosestSequential;
 
     std::vector<rayintersection_result_type> intersectSequential( ray_type const& ray, bool useRobustTraversal = true ) override
         {
@@ -472,6 +553,48 @@ private:
                 return this->intersectImpl<false>( rayBackend );
         };
 
+    //! closest hit only : the stack is shared by the rays and nothing is allocated
+    void intersectClosestSequential( ray_type const* rays, std::size_t nRays, index_type* primitiveIds, bool useRobustTraversal ) override
+        {
+            if constexpr ( nRealDim != 3 )
+                super_type::intersectClosestSequential( rays, nRays, primitiveIds, useRobustTraversal );
+            else
+            {
+                static constexpr size_t stack_size = 64;
+                bvh::v2::SmallStack<typename backend_bvh_type::Index, stack_size> stack;
+                for ( std::size_t k = 0; k < nRays; ++k )
+                {
+                    primitiveIds[k] = invalid_v<index_type>;
+                    if ( !M_bvh )
+                        continue;
+                    auto const& ray = rays[k];
+                    auto rayBackend = bvh::v2::Ray<value_type,nRealDim>{
+                        backend_vector_realdim_type::generate([&ray] (std::size_t i) { return ray.origin()[i]; }),
+                        backend_vector_realdim_type::generate([&ray] (std::size_t i) { return ray.dir()[i]; }),
+                        ray.distanceMin(), ray.distanceMax()
+                    };
+                    stack.size = 0;
+                    // tmax is reduced at each hit, so the last primitive hit is the closest one
+                    auto hitLeaf = [this,&rayBackend,&primitiveIds,k] (std::size_t begin, std::size_t end) {
+                        bool hasHit = false;
+                        for ( std::size_t i = begin; i < end; ++i )
+                        {
+                            if ( M_precomputeTriangle[i].intersect( rayBackend ) )
+                            {
+                                primitiveIds[k] = M_bvh->prim_ids[i];
+                                hasHit = true;
+                            }
+                        }
+                        return hasHit;
+                    };
+                    if ( useRobustTraversal )
+                        M_bvh->template intersect<false, true>( rayBackend, M_bvh->get_root().index, stack, hitLeaf );
+                    else
+                        M_bvh->template intersect<false, false>( rayBackend, M_bvh->get_root().index, stack, hitLeaf );
+                }
+            }
+        }
+
     template <bool UseRobustTraversal>
     std::vector<rayintersection_result_type> intersectImpl( bvh::v2::Ray<value_type,nRealDim> & rayBackend )
         {
@@ -531,185 +654,26 @@ private:
 
 
 //! @brief in house implementation of BVH tool
-template <typename MeshEntityType>
+//!
+//! The primitives (segments in 2D, triangles in 3D) are stored in a WideBVH of
+//! \c Width children per node built with a binned SAH, possibly on several
+//! threads. The batches of rays are traced by packets of \c packetSize rays
+//! which share the traversal of the tree.
+template <typename MeshEntityType, int Width = 4>
 class BVH_InHouse : public BVH<MeshEntityType>
 {
     using super_type = BVH<MeshEntityType>;
-    using self_type = BVH_InHouse<MeshEntityType>;
+    using self_type = BVH_InHouse<MeshEntityType,Width>;
     using mesh_entity_type = typename super_type::mesh_entity_type;
+    using index_type = typename super_type::index_type;
     using vector_realdim_type = typename super_type::vector_realdim_type;
     static constexpr uint16_type nRealDim = super_type::nRealDim;
     using primitiveinfo_type = typename super_type::primitiveinfo_type;
 public:
     using ray_type = typename super_type::ray_type;
     using rayintersection_result_type = typename super_type::rayintersection_result_type;
-
-    class BVHNode
-    {
-        friend class BVH_InHouse<mesh_entity_type>;
-    public:
-        BVHNode() = default;
-
-        //! return the parent of this node
-        BVHNode * parent() const { return M_parent; }
-
-        vector_realdim_type const& boundMin() const noexcept { return M_bounds_min; }
-        vector_realdim_type const& boundMax() const noexcept { return M_bounds_max; }
-        vector_realdim_type centroid() const { return 0.5*(M_bounds_min + M_bounds_max); }
-        int splitAxis() const noexcept { return M_splitAxis; }
-        int nPrimitives() const noexcept { return M_nPrimitives; }
-        int firstPrimOffset() const noexcept { return M_firstPrimOffset; }
-
-        BVHNode* child( int k ) const { return M_children[k].get(); }
-
-        bool isLeaf() const { return !M_children[0] && !M_children[1]; }
-
-
-        BVHNode * nearChild( ray_type const& ray ) const
-            {
-                if( ray.dir()(this->splitAxis()) > 0 )
-                    return this->child(0);
-                else
-                    return this->child(1);
-            }
-
-        BVH_InHouse::BVHNode * siblingNode() const
-            {
-                if ( !M_parent )
-                    return nullptr;
-                return M_parent->child( this == M_parent->child(0)? 1 : 0 );
-            }
-
-        bool checkIntersection(ray_type const& rayon)
-            {
-                double tmin = 0.0;
-                double tmax = FLT_MAX;
-
-                for(int i=0; i<nRealDim; i++)
-                {
-                    double ratio = 1.0/(rayon.dir()[i]+2*FLT_MIN);
-                    double t1 = (M_bounds_min[i]-rayon.origin()[i]) * ratio;
-                    double t2 = (M_bounds_max[i]-rayon.origin()[i]) * ratio;
-                    if (t1 > t2)
-                    {
-                        double tTemp = t1;
-                        t1 = t2;
-                        t2 = tTemp;
-                    }
-                    if ( t1 > tmin)
-                        tmin = t1;
-                    if (t2 > tmax)
-                        tmax = t2;
-                    if (tmin > tmax)
-                        return false;
-                }
-
-                return true;
-            }
-
-        std::pair<bool,double> checkIntersectionWithSegment( ray_type const& ray, std::vector<primitiveinfo_type> const& primitiveInfo ) const
-            {
-                auto const& meshElt = primitiveInfo[this->firstPrimOffset()].meshEntity();
-                auto p1 = Eigen::Map<const Eigen::Matrix<double,nRealDim,1>>( meshElt.point(0).node().data().begin() );
-                auto p2 = Eigen::Map<const Eigen::Matrix<double,nRealDim,1>>( meshElt.point(1).node().data().begin() );
-
-                auto const& origin = ray.origin();
-                auto const& direction = ray.dir();
-
-                vector_realdim_type v1 = origin - p1;
-                vector_realdim_type v2 = p2 - p1;
-                vector_realdim_type v3{ -direction[1], direction[0] };
-
-                double dot = v2.dot(v3);
-                if (math::abs(dot) < 1e-6)
-                    return std::make_pair(false,0);
-
-                double t1 = (v2[0]*v1[1]-v2[1]*v1[0])/ dot;
-                double t2 = v1.dot(v3) / dot;
-
-                if (t1 > 2*FLT_MIN && (t2 >= 0.0 && t2 <= 1.0))
-                {
-#if 0
-                    vector_realdim_type w_{
-                        origin[0] + direction[0]*t1,
-                        origin[1] + direction[1]*t1; };
-#endif
-                    return std::make_pair(true,t1);
-                }
-                return std::make_pair(false,t1);
-            }
-
-        // Verify if the ray intersects the element
-        std::pair<bool,double> checkIntersectionWithTriangle( ray_type const& ray, std::vector<primitiveinfo_type> const& primitiveInfo ) const
-            {
-                DCHECK( this->isLeaf() ) << "should be a leaf: ";
-
-                auto const& meshElt = primitiveInfo[this->firstPrimOffset()].meshEntity();
-                auto p1 = Eigen::Map<const Eigen::Matrix<double,nRealDim,1>>( meshElt.point(0).node().data().begin() );
-                auto p2 = Eigen::Map<const Eigen::Matrix<double,nRealDim,1>>( meshElt.point(1).node().data().begin() );
-                auto p3 = Eigen::Map<const Eigen::Matrix<double,nRealDim,1>>( meshElt.point(2).node().data().begin() );
-
-                auto const& origin = ray.origin();
-                auto const& direction = ray.dir();
-
-                // // normal vector
-                auto n1 = (p2-p1).cross(p3-p1);
-                n1 = n1/n1.norm();
-                double n_dot_dir = direction.dot(n1);
-                // Ray is parallel to the triangle's plane
-                if (math::abs(n_dot_dir)<1e-6)
-                {
-                    return std::make_pair(false,0);
-                }
-                double d = -p1.dot(n1);
-                double t_line = -(origin.dot(n1)+d)/n_dot_dir;
-                if( t_line <= 1e-10) // intersection not in the same direction as the ray
-                    return std::make_pair(false,0);
-                // intersection point
-                auto w = origin + direction* t_line;
-
-                Eigen::Matrix<double,3,3> m;
-                m.col(0) = p2-p1;
-                m.col(1) = p3-p1;
-                m.col(2) = n1;
-                auto w_ = m.inverse()*(w-p1);
-
-                return std::make_pair((w_(0)> 2*FLT_MIN ) && (w_(1)>0) && (w_(0) +  w_(1)<1),t_line);
-            }
-
-        std::pair<bool,double> checkLeafIntersection(ray_type const& rayon, std::vector<primitiveinfo_type> const& primitiveInfo)
-            {
-                if constexpr ( nRealDim == 2 )
-                    return checkIntersectionWithSegment( rayon, primitiveInfo );
-                else if constexpr ( nRealDim == 3 )
-                    return checkIntersectionWithTriangle( rayon, primitiveInfo );
-            }
-
-    private:
-        BVHNode* setChild( uint16_type k, std::unique_ptr<BVHNode> && childNode )
-            {
-                if ( childNode->M_parent ) { /*TODO remove child in this parent*/ }
-
-                childNode->M_parent = this;
-                M_children[k] = std::move( childNode );
-                return M_children[k].get();
-            }
-
-        void updateForUse( int firstPrimOffset, int nPrimitives, int splitAxis, Eigen::VectorXd const& bounds_min, Eigen::VectorXd const& bounds_max )
-            {
-                M_firstPrimOffset = firstPrimOffset;
-                M_nPrimitives = nPrimitives;
-                M_bounds_min = bounds_min;
-                M_bounds_max = bounds_max;
-                M_splitAxis = splitAxis;
-            }
-
-    private:
-        std::array<std::unique_ptr<BVHNode>,2> M_children;
-        BVHNode *M_parent = nullptr;
-        int M_splitAxis = 0, M_nPrimitives = 0, M_firstPrimOffset = 0;
-        vector_realdim_type M_bounds_min, M_bounds_max;
-    };
+    using tree_type = WideBVH<nRealDim,Width>;
+    static constexpr int packetSize = 8;
 
     BVH_InHouse( worldcomm_ptr_t worldComm ) : super_type( BVHEnum::Quality::High, worldComm ) {}
 
@@ -723,216 +687,184 @@ public:
             this->buildTree();
         }
 
+    //! return the tree of the primitive boxes
+    tree_type const& tree() const { return M_tree; }
+
 private:
-    // Verify if the ray intersects the whole bounding structure
-    // Returns the integer corresponding to the intersected element
-    // If no element is intersected, return -1
-    std::vector<rayintersection_result_type> intersectSequential( ray_type const& rayon, bool useRobustTraversal = true ) override
+    // the traversal is exact for the in-house primitive tests, useRobustTraversal is not used
+    std::vector<rayintersection_result_type> intersectSequential( ray_type const& ray, bool useRobustTraversal = true ) override
         {
-            M_intersected_leaf = {};
-            M_lengths = {};
-            if ( !M_rootNode )
-                buildTree();
-            if ( this->M_primitiveInfo.empty() )
-                return {};
-
             std::vector<rayintersection_result_type> res;
-            if ( M_rootNode->checkIntersection(rayon) )
-            {
-                traverse_stackless( M_rootNode.get(), rayon );
-            }
-            if ( !M_intersected_leaf.empty() )
-            {
-                int argmin_lengths = std::distance(M_lengths.begin(), std::min_element(M_lengths.begin(), M_lengths.end()));
-                res.push_back( rayintersection_result_type(this->worldComm().rank(), M_intersected_leaf[argmin_lengths], M_lengths[argmin_lengths] ) );
-            }
+            this->intersectPackets<1>( &ray, 1, [this,&ray,&res]( std::size_t, std::int32_t primId, double t ) {
+                                                    if ( primId >= 0 )
+                                                        res.push_back( this->makeResult( ray, primId, t ) );
+                                                } );
             return res;
         }
 
-    void buildTree()
+    void intersectClosestSequential( ray_type const* rays, std::size_t nRays, index_type* primitiveIds, bool useRobustTraversal ) override
         {
-            if ( M_rootNode )
-                return;
-
-            M_rootNode = std::make_unique<BVHNode>();
-
-            std::stack<std::tuple<BVHNode*,int,int,int>> stack;
-            stack.push( std::make_tuple(M_rootNode.get(),0,0,this->M_primitiveInfo.size()) );
-            // TODO case only one 1 element
-            while ( !stack.empty() )
-            {
-                auto [currentNode,cut_dimension,start_index_primitive,end_index_primitive] = stack.top();
-                stack.pop();
-
-                int nPrimitives = end_index_primitive - start_index_primitive;
-                auto [bound_min_node,bound_max_node] = nPrimitives > 0 ? this->bounds( start_index_primitive,end_index_primitive ) : std::make_tuple( vector_realdim_type{}, vector_realdim_type{});
-
-                if ( nPrimitives <= 1 )
-                {
-                    // Create a leaf, since there is only one primitive in the list
-                    int firstPrimOffset = M_orderedPrims.size();
-                    for (int i = start_index_primitive; i < end_index_primitive; ++i)
-                    {
-                        int primNum = this->M_primitiveInfo[i].meshEntity().id();
-                        M_orderedPrims.push_back(primNum);
-                    }
-                    currentNode->updateForUse( firstPrimOffset, nPrimitives, -1, bound_min_node, bound_max_node );
-                }
-                else
-                {
-                    CHECK( start_index_primitive >=0 && end_index_primitive <= this->M_primitiveInfo.size() ) << start_index_primitive << " " << end_index_primitive;
-                    auto mid = (start_index_primitive + end_index_primitive) / 2;
-                    std::nth_element(&this->M_primitiveInfo[start_index_primitive], &this->M_primitiveInfo[mid],
-                                     &this->M_primitiveInfo[end_index_primitive-1]+1,
-                                     [cut_dimension=cut_dimension](primitiveinfo_type const&a, primitiveinfo_type const& b) {
-                                         return a.centroid()[cut_dimension] < b.centroid()[cut_dimension];
-                                     });
-
-                    int next_cut_dimension=(cut_dimension+1)%nRealDim;
-                    auto childNode0 = currentNode->setChild( 0, std::make_unique<BVHNode>() );
-                    stack.push( std::make_tuple(childNode0, next_cut_dimension, start_index_primitive, mid) );
-                    auto childNode1 = currentNode->setChild( 1, std::make_unique<BVHNode>() );
-                    stack.push( std::make_tuple( childNode1, next_cut_dimension, mid, end_index_primitive ) );
-
-                    currentNode->updateForUse( -1, nPrimitives, next_cut_dimension, bound_min_node, bound_max_node );
-                }
-            }
+            this->intersectPackets<packetSize>( rays, nRays, [primitiveIds]( std::size_t k, std::int32_t primId, double ) {
+                                                                 primitiveIds[k] = primId >= 0 ? index_type( primId ) : invalid_v<index_type>;
+                                                             } );
         }
 
-
-    std::tuple<vector_realdim_type,vector_realdim_type> bounds( int start_index_primitive, int end_index_primitive ) const
+    void intersectClosestSequential( ray_type const* rays, std::size_t nRays, rayintersection_result_type* res, bool useRobustTraversal ) override
         {
-            if ( start_index_primitive >= end_index_primitive )
-                throw std::logic_error("Error in BVHNode : compute bounds with no elemnent");
+            this->intersectPackets<packetSize>( rays, nRays, [this,rays,res]( std::size_t k, std::int32_t primId, double t ) {
+                                                                 res[k] = primId >= 0 ? this->makeResult( rays[k], primId, t ) : rayintersection_result_type{};
+                                                             } );
+        }
 
-            //vector_realdim_type newBoundsMin, newBoundsMax;
-            vector_realdim_type newBoundsMin = this->M_primitiveInfo[start_index_primitive].boundMin();
-            vector_realdim_type newBoundsMax = this->M_primitiveInfo[start_index_primitive].boundMax();
-            for (int i = start_index_primitive+1; i < end_index_primitive; ++i)
+    void buildTree()
+        {
+            auto const& primitiveInfo = this->M_primitiveInfo;
+            std::vector<double> boxes( 2*nRealDim*primitiveInfo.size() );
+            for ( std::size_t i = 0; i < primitiveInfo.size(); ++i )
             {
-                auto const& primitiveInfo = this->M_primitiveInfo[i];
-                for ( uint8_type d=0;d<vector_realdim_type::SizeAtCompileTime;++d )
+                for ( int c = 0; c < nRealDim; ++c )
                 {
-                    newBoundsMin[d] = std::min( newBoundsMin[d], primitiveInfo.boundMin()[d] );
-                    newBoundsMax[d] = std::max( newBoundsMax[d], primitiveInfo.boundMax()[d] );
+                    boxes[2*nRealDim*i+c] = primitiveInfo[i].boundMin()[c];
+                    boxes[2*nRealDim*i+nRealDim+c] = primitiveInfo[i].boundMax()[c];
                 }
             }
-            return std::make_tuple( std::move(newBoundsMin), std::move(newBoundsMax) );
+            typename tree_type::Config config;
+            config.nThreads = this->nThreads();
+            M_tree = tree_type( config );
+            M_tree.build( boxes );
+
+            // vertices stored in the order of the leaves : the first vertex and the edges from it
+            M_primitiveVertices.resize( primitiveInfo.size() );
+            for ( std::size_t k = 0; k < primitiveInfo.size(); ++k )
+            {
+                auto const& meshEntity = primitiveInfo[M_tree.primitiveId( k )].meshEntity();
+                auto p0 = Eigen::Map<const Eigen::Matrix<double,nRealDim,1>>( meshEntity.point( 0 ).node().data().begin() );
+                M_primitiveVertices[k].col( 0 ) = p0;
+                for ( int j = 1; j < nRealDim; ++j )
+                    M_primitiveVertices[k].col( j ) = Eigen::Map<const Eigen::Matrix<double,nRealDim,1>>( meshEntity.point( j ).node().data().begin() ) - p0;
+            }
         }
 
-
-    void traverse_stackless( BVH_InHouse::BVHNode * tree, ray_type const& rayon )
+    //! trace the rays by packets of \c N rays, \p f(k,primId,t) is called with the closest hit of each ray (primId < 0 if no hit)
+    template <int N, typename F>
+    void intersectPackets( ray_type const* rays, std::size_t nRays, F&& f ) const
         {
-            auto current_node = M_rootNode->nearChild(rayon);
-            if ( !current_node ) // case where root is leaf
+            using points_type = Eigen::Array<double,nRealDim,N>;
+            using row_type = Eigen::Array<double,1,N>;
+            using mask_type = Eigen::Array<bool,1,N>;
+            for ( std::size_t r0 = 0; r0 < nRays; r0 += N )
             {
-                auto [has_intersected_leaf,distance] = M_rootNode->checkLeafIntersection(rayon,this->M_primitiveInfo);
-                if ( has_intersected_leaf )
+                points_type origin, dir;
+                row_type tmin, tmax;
+                mask_type active;
+                std::array<std::int32_t,N> primHit;
+                primHit.fill( -1 );
+                for ( int p = 0; p < N; ++p )
                 {
-                    M_intersected_leaf.push_back(M_rootNode->firstPrimOffset());
-                    M_lengths.push_back(distance);
+                    // the missing rays of the last packet are copies of its first ray, inactive
+                    ray_type const& ray = rays[r0+p < nRays ? r0+p : r0];
+                    origin.col( p ) = ray.origin().array();
+                    dir.col( p ) = ray.dir().array();
+                    tmin[p] = std::max( ray.distanceMin(), S_distanceMinEpsilon );
+                    tmax[p] = ray.distanceMax();
+                    active[p] = r0+p < nRays;
                 }
-                return;
-            }
-            char state = 'P'; // the current node is being traversed from its Parent ('P')
-
-            while(true)
-            {
-                switch (state)
+                if constexpr ( N > 1 )
                 {
-                case 'C': // the node is being traversed from its child
-
-                    if ( current_node == M_rootNode.get() ) return;
-
-                    if ( current_node == current_node->parent()->nearChild( rayon ) )
-                    {
-                        current_node = current_node->siblingNode();
-                        state = 'S'; // the current node has been accessed from its sibling
-                    }
-                    else
-                    {
-                        current_node = current_node->parent();
-                        state = 'C'; // the current node has been accessed from its sibling
-                    }
-                    break;
-
-                case 'S': // the node is being traversed from its Sibling ('S')
-
-                    if ( current_node->checkIntersection( rayon ) == false ) // back to parent
-                    {
-                        current_node = current_node->parent();
-                        state = 'C'; // the current node is being accessed from its child
-                    }
-                    else if ( current_node->isLeaf() )
+                    // a packet is only efficient if its rays go in the same octant, otherwise they are traced one by one
+                    bool isCoherent = true;
+                    for ( int c = 0; c < nRealDim; ++c )
+                        isCoherent = isCoherent && ( ( dir.row( c ) >= 0 ).all() || ( dir.row( c ) < 0 ).all() );
+                    if ( !isCoherent )
                     {
-                        auto [has_intersected_leaf,distance] = current_node->checkLeafIntersection(rayon,this->M_primitiveInfo);
-                        if ( has_intersected_leaf )
-                        {
-                            //if ( std::find(M_intersected_leaf.begin(), M_intersected_leaf.end(), this->M_primitiveInfo[current_node->firstPrimOffset()].meshEntity().id()) == M_intersected_leaf.end() )
-                            if ( std::find(M_intersected_leaf.begin(), M_intersected_leaf.end(), current_node->firstPrimOffset() ) == M_intersected_leaf.end() )
-                            {
-                                //M_intersected_leaf.push_back(this->M_primitiveInfo[current_node->firstPrimOffset()].meshEntity().id());
-                                M_intersected_leaf.push_back(current_node->firstPrimOffset());
-                                M_lengths.push_back(distance);
-                            }
-                        }
-                        current_node = current_node->parent();
-                        state='C'; // the current node is being accessed from its child
-                    }
-                    else
-                    {
-                        current_node = current_node->nearChild(rayon);
-                        state='P';// the current node has been accessed from its parent
-                    }
-                    break;
-
-                case 'P':
-                    if ( current_node->checkIntersection(rayon) == false )
-                    {
-                        current_node=current_node->siblingNode();
-                        state = 'S'; // the current node has been accessed from its sibling
-                    }
-                    else if ( current_node->isLeaf() )
-                    {
-                        auto [has_intersected_leaf,distance] = current_node->checkLeafIntersection(rayon,this->M_primitiveInfo);
-                        if ( has_intersected_leaf )
-                        {
-                            //if ( std::find(M_intersected_leaf.begin(), M_intersected_leaf.end(), this->M_primitiveInfo[current_node->firstPrimOffset()].meshEntity().id()) == M_intersected_leaf.end() )
-                            if ( std::find(M_intersected_leaf.begin(), M_intersected_leaf.end(), current_node->firstPrimOffset()) == M_intersected_leaf.end() )
-                            {
-                                //M_intersected_leaf.push_back(this->M_primitiveInfo[current_node->firstPrimOffset()].meshEntity().id());
-                                M_intersected_leaf.push_back(current_node->firstPrimOffset());
-                                M_lengths.push_back(distance);
-                            }
-                        }
-                        current_node = current_node->siblingNode();
-                        state = 'S'; // the current node has been accessed from its sibling
+                        this->intersectPackets<1>( rays+r0, std::min<std::size_t>( N, nRays-r0 ),
+                                                   [&f,r0]( std::size_t k, std::int32_t primId, double t ) { f( r0+k, primId, t ); } );
+                        continue;
                     }
-                    else
-                    {
-                        current_node = current_node->nearChild( rayon );
-                        state = 'P'; // the current node has been accessed from its parent
-                    }
-                    break;
-
-                default:
-
-                    LOG(ERROR) << "ERROR: None of the previous cases has been traversed";
+                }
+                auto hitLeaf = [this,&origin,&dir,&tmin,&primHit]( std::int32_t first, std::int32_t n, mask_type const& mask, row_type& tmaxCurrent ) {
+                                   for ( std::int32_t k = first; k < first+n; ++k )
+                                   {
+                                       row_type t = this->intersectPrimitive( k, origin, dir );
+                                       mask_type hit = mask && ( t > tmin ) && ( t < tmaxCurrent );
+                                       if ( !hit.any() )
+                                           continue;
+                                       tmaxCurrent = hit.select( t, tmaxCurrent );
+                                       for ( int p = 0; p < N; ++p )
+                                           if ( hit[p] )
+                                               primHit[p] = M_tree.primitiveId( k );
+                                   }
+                               };
+                if constexpr ( N == 1 )
+                {
+                    double tmax0 = tmax[0];
+                    M_tree.intersect( origin.col( 0 ).eval(), dir.col( 0 ).eval(), tmin[0], tmax0,
+                                      [&hitLeaf,&active]( std::int32_t first, std::int32_t n, double& tmaxCurrent ) {
+                                          row_type tmaxRow = row_type::Constant( tmaxCurrent );
+                                          hitLeaf( first, n, active, tmaxRow );
+                                          tmaxCurrent = tmaxRow[0];
+                                      } );
+                    tmax[0] = tmax0;
+                }
+                else
+                    M_tree.intersect( origin, dir, tmin, tmax, active, hitLeaf );
 
-                    throw std::logic_error("Error in BVH traversal: none of the previous cases has been traversed.");
+                for ( int p = 0; p < N && r0+p < nRays; ++p )
+                    f( r0+p, primHit[p], tmax[p] );
+            }
+        }
 
-                    break;
-                }
+    //! distance along the rays \p origin + t \p dir to the primitive \p k (-1 if not hit)
+    template <int N>
+    Eigen::Array<double,1,N> intersectPrimitive( std::int32_t k, Eigen::Array<double,nRealDim,N> const& origin, Eigen::Array<double,nRealDim,N> const& dir ) const
+        {
+            using row_type = Eigen::Array<double,1,N>;
+            auto const& V = M_primitiveVertices[k];
+            if constexpr ( nRealDim == 2 )
+            {
+                // segment p0 + s e, s in [0,1]
+                row_type wx = V( 0, 0 ) - origin.row( 0 );
+                row_type wy = V( 1, 0 ) - origin.row( 1 );
+                row_type den = dir.row( 0 )*V( 1, 1 ) - dir.row( 1 )*V( 0, 1 );
+                row_type s = ( wx*dir.row( 1 ) - wy*dir.row( 0 ) )/den;
+                row_type t = ( wx*V( 1, 1 ) - wy*V( 0, 1 ) )/den;
+                return ( ( den != 0 ) && ( s >= -S_barycentricEpsilon ) && ( s <= 1+S_barycentricEpsilon ) ).select( t, row_type::Constant( -1 ) );
+            }
+            else
+            {
+                // triangle p0 + u e1 + v e2 (Moller-Trumbore)
+                Eigen::Array<double,3,N> pvec, qvec;
+                pvec.row( 0 ) = dir.row( 1 )*V( 2, 2 ) - dir.row( 2 )*V( 1, 2 );
+                pvec.row( 1 ) = dir.row( 2 )*V( 0, 2 ) - dir.row( 0 )*V( 2, 2 );
+                pvec.row( 2 ) = dir.row( 0 )*V( 1, 2 ) - dir.row( 1 )*V( 0, 2 );
+                row_type det = V( 0, 1 )*pvec.row( 0 ) + V( 1, 1 )*pvec.row( 1 ) + V( 2, 1 )*pvec.row( 2 );
+                row_type invDet = det.inverse();
+                Eigen::Array<double,3,N> tvec = origin.colwise() - V.col( 0 ).array();
+                row_type u = ( tvec*pvec ).colwise().sum()*invDet;
+                qvec.row( 0 ) = tvec.row( 1 )*V( 2, 1 ) - tvec.row( 2 )*V( 1, 1 );
+                qvec.row( 1 ) = tvec.row( 2 )*V( 0, 1 ) - tvec.row( 0 )*V( 2, 1 );
+                qvec.row( 2 ) = tvec.row( 0 )*V( 1, 1 ) - tvec.row( 1 )*V( 0, 1 );
+                row_type v = ( dir*qvec ).colwise().sum()*invDet;
+                row_type t = ( V( 0, 2 )*qvec.row( 0 ) + V( 1, 2 )*qvec.row( 1 ) + V( 2, 2 )*qvec.row( 2 ) )*invDet;
+                return ( ( det != 0 ) && ( u >= -S_barycentricEpsilon ) && ( v >= -S_barycentricEpsilon ) && ( u+v <= 1+S_barycentricEpsilon ) ).select( t, row_type::Constant( -1 ) );
             }
         }
 
-private:
-    std::unique_ptr<BVHNode> M_rootNode;
+    rayintersection_result_type makeResult( ray_type const& ray, std::int32_t primId, double t ) const
+        {
+            rayintersection_result_type res( this->worldComm().rank(), primId, t );
+            res.setCoordinates( vector_realdim_type( ray.origin() + t*ray.dir() ) );
+            return res;
+        }
 
-    thread_local static inline std::vector<int> M_intersected_leaf;
-    thread_local static inline std::vector<double> M_lengths;
+private:
+    //! intersections closer to the ray origin are ignored
+    static constexpr double S_distanceMinEpsilon = 1e-10;
+    //! tolerance on the barycentric coordinates, so that a ray through an edge shared by two primitives hits one of them
+    static constexpr double S_barycentricEpsilon = 1e-12;
 
-    std::vector<int> M_orderedPrims; // order of traversed primitives for depth-first search
+    tree_type M_tree;
+    std::vector<Eigen::Matrix<double,nRealDim,nRealDim>,Eigen::aligned_allocator<Eigen::Matrix<double,nRealDim,nRealDim>>> M_primitiveVertices;
 };
 
 
@@ -944,6 +876,7 @@ auto boundingVolumeHierarchy( Ts && ... v )
     using mesh_entity_type = std::remove_const_t<entity_range_t<std::decay_t<decltype(range)>>>;
     std::string const& kind = args.get_else(_kind, mesh_entity_type::nRealDim == 3 ? "third-party" : "in-house");
     BVHEnum::Quality quality = args.get_else(_quality, BVHEnum::Quality::High );
+    int nThreads = args.get_else(_nthreads, 1 );
     worldcomm_ptr_t worldcomm = args.get_else(_worldcomm,Environment::worldCommPtr()); // TODO : use default worldcomm from range
 
     using bvh_type = BVH<mesh_entity_type>;
@@ -953,6 +886,7 @@ auto boundingVolumeHierarchy( Ts && ... v )
     {
         using bvh_inhouse_type = BVH_InHouse<mesh_entity_type>;
         auto bvhInHouse = std::make_unique<bvh_inhouse_type>(worldcomm);
+        bvhInHouse->setNThreads( nThreads );
         bvhInHouse->updateForUse(range);
         bvh = std::move( bvhInHouse );
     }
@@ -961,6 +895,7 @@ auto boundingVolumeHierarchy( Ts && ... v )
         if constexpr ( mesh_entity_type::nRealDim != 3 )
             throw std::invalid_argument("third-party only implement with triangle in 3D");
         auto bvhThirdParty = std::make_unique<BVH_ThirdParty<mesh_entity_type>>( quality, worldcomm );
+        bvhThirdParty->setNThreads( nThreads );
         bvhThirdParty->updateForUse(range);
         bvh = std::move( bvhThirdParty );
     }
@@ -0,0 +1,328 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+
+  This file is part of the Feel++ library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3.0 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#ifndef FEELPP_MESH_DENSEIDMAP_HPP
+#define FEELPP_MESH_DENSEIDMAP_HPP 1
+
+#include <bitset>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <feel/feelcore/feel.hpp>
+
+namespace Feel
+{
+/**
+ * \class DenseIdMap
+ * \brief associative container of entities indexed by a dense integer id
+ *
+ * The entities are stored in pages of \c PageSize contiguous slots, the slot
+ * of an entity being given by its id : the lookup is an index computation
+ * (no hashing) and there is no per entity allocation. The pages are never
+ * moved, hence the references and pointers to the entities remain valid
+ * after an insertion, as for \c std::unordered_map. The iteration visits the
+ * entities by increasing id.
+ *
+ * The interface is the subset of the \c std::unordered_map interface used by
+ * the containers of mesh entities, the value type is \c std::pair<const Key,T>.
+ * The memory is proportional to the largest id, the ids should be dense.
+ */
+template<typename Key, typename T, std::size_t PageSize = 1024>
+class DenseIdMap
+{
+    static_assert( std::is_integral_v<Key>, "DenseIdMap requires an integral key" );
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key,T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = value_type const&;
+    using pointer = value_type*;
+    using const_pointer = value_type const*;
+
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+private:
+    struct Page
+    {
+        struct alignas( value_type ) Slot { unsigned char data[sizeof( value_type )]; };
+        // the slots are not initialized
+        Page() {}
+        value_type* slot( size_type i ) { return std::launder( reinterpret_cast<value_type*>( slots[i].data ) ); }
+        value_type const* slot( size_type i ) const { return std::launder( reinterpret_cast<value_type const*>( slots[i].data ) ); }
+        std::bitset<PageSize> used;
+        size_type count = 0;
+        Slot slots[PageSize];
+    };
+
+    template<bool IsConst>
+    class iterator_impl
+    {
+        using map_type = std::conditional_t<IsConst, DenseIdMap const, DenseIdMap>;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename DenseIdMap::value_type;
+        using difference_type = typename DenseIdMap::difference_type;
+        using reference = std::conditional_t<IsConst, value_type const&, value_type&>;
+        using pointer = std::conditional_t<IsConst, value_type const*, value_type*>;
+
+        iterator_impl() = default;
+        iterator_impl( map_type* m, size_type pos ) : M_map( m ), M_pos( pos ) {}
+        //! conversion from iterator to const_iterator
+        template<bool C = IsConst, std::enable_if_t<C,int> = 0>
+        iterator_impl( iterator_impl<false> const& it ) : M_map( it.map() ), M_pos( it.position() ) {}
+
+        reference operator*() const { return *M_map->slot( M_pos ); }
+        pointer operator->() const { return M_map->slot( M_pos ); }
+        iterator_impl& operator++() { M_pos = M_map->nextUsed( M_pos+1 ); return *this; }
+        iterator_impl operator++( int ) { iterator_impl tmp( *this ); ++*this; return tmp; }
+
+        map_type* map() const { return M_map; }
+        //! slot of the entity (npos for end)
+        size_type position() const { return M_pos; }
+
+        template<bool C>
+        bool operator==( iterator_impl<C> const& it ) const { return M_pos == it.position(); }
+        template<bool C>
+        bool operator!=( iterator_impl<C> const& it ) const { return M_pos != it.position(); }
+    private:
+        map_type* M_map = nullptr;
+        size_type M_pos = npos;
+    };
+
+public:
+    using iterator = iterator_impl<false>;
+    using const_iterator = iterator_impl<true>;
+
+    DenseIdMap() = default;
+    DenseIdMap( DenseIdMap const& m )
+        {
+            this->reserve( m.M_pages.size()*PageSize );
+            for ( auto const& v : m )
+                this->emplace( v );
+        }
+    DenseIdMap( DenseIdMap && m ) noexcept
+        :
+        M_pages( std::move( m.M_pages ) ),
+        M_size( std::exchange( m.M_size, 0 ) )
+        {}
+    DenseIdMap& operator=( DenseIdMap const& m )
+        {
+            if ( this != &m )
+            {
+                DenseIdMap tmp( m );
+                this->swap( tmp );
+            }
+            return *this;
+        }
+    DenseIdMap& operator=( DenseIdMap && m ) noexcept
+        {
+            if ( this != &m )
+            {
+                this->clear();
+                M_pages = std::move( m.M_pages );
+                M_size = std::exchange( m.M_size, 0 );
+            }
+            return *this;
+        }
+    ~DenseIdMap() { this->clear(); }
+
+    void swap( DenseIdMap& m ) noexcept
+        {
+            std::swap( M_pages, m.M_pages );
+            std::swap( M_size, m.M_size );
+        }
+
+    size_type size() const { return M_size; }
+    bool empty() const { return M_size == 0; }
+    //! number of slots allocated
+    size_type capacity() const
+        {
+            size_type n = 0;
+            for ( auto const& p : M_pages )
+                if ( p )
+                    n += PageSize;
+            return n;
+        }
+
+    iterator begin() { return iterator( this, this->nextUsed( 0 ) ); }
+    const_iterator begin() const { return const_iterator( this, this->nextUsed( 0 ) ); }
+    const_iterator cbegin() const { return this->begin(); }
+    iterator end() { return iterator( this, npos ); }
+    const_iterator end() const { return const_iterator( this, npos ); }
+    const_iterator cend() const { return this->end(); }
+
+    iterator find( key_type const& k ) { return iterator( this, this->isUsed( k )? size_type( k ) : npos ); }
+    const_iterator find( key_type const& k ) const { return const_iterator( this, this->isUsed( k )? size_type( k ) : npos ); }
+    size_type count( key_type const& k ) const { return this->isUsed( k )? 1 : 0; }
+    bool contains( key_type const& k ) const { return this->isUsed( k ); }
+
+    T& at( key_type const& k )
+        {
+            CHECK( this->isUsed( k ) ) << "no entity with id " << k;
+            return this->slot( k )->second;
+        }
+    T const& at( key_type const& k ) const
+        {
+            CHECK( this->isUsed( k ) ) << "no entity with id " << k;
+            return this->slot( k )->second;
+        }
+    T& operator[]( key_type const& k )
+        {
+            if ( !this->isUsed( k ) )
+                this->construct( k, std::piecewise_construct, std::forward_as_tuple( k ), std::forward_as_tuple() );
+            return this->slot( k )->second;
+        }
+
+    //! the pages of the ids lower than \p n are allocated when they are first used
+    void reserve( size_type n ) { M_pages.reserve( ( n+PageSize-1 )/PageSize ); }
+
+    template<typename... Args>
+    std::pair<iterator,bool> emplace( Args&&... args )
+        {
+            value_type v( std::forward<Args>( args )... );
+            key_type k = v.first;
+            if ( this->isUsed( k ) )
+                return std::make_pair( iterator( this, k ), false );
+            this->construct( k, std::move( v ) );
+            return std::make_pair( iterator( this, k ), true );
+        }
+    std::pair<iterator,bool> insert( value_type const& v ) { return this->emplace( v ); }
+
+    iterator erase( const_iterator it )
+        {
+            size_type pos = it.position();
+            this->destroy( pos );
+            return iterator( this, this->nextUsed( pos+1 ) );
+        }
+    iterator erase( iterator it ) { return this->erase( const_iterator( it ) ); }
+    size_type erase( key_type const& k )
+        {
+            if ( !this->isUsed( k ) )
+                return 0;
+            this->destroy( k );
+            return 1;
+        }
+
+    void clear()
+        {
+            for ( auto& p : M_pages )
+            {
+                if ( !p )
+                    continue;
+                for ( size_type i = 0; i < PageSize && p->count > 0; ++i )
+                {
+                    if ( p->used[i] )
+                    {
+                        p->slot( i )->~value_type();
+                        p->used[i] = false;
+                        --p->count;
+                    }
+                }
+            }
+            M_pages.clear();
+            M_size = 0;
+        }
+
+private:
+    bool isUsed( key_type const& k ) const
+        {
+            if constexpr ( std::is_signed_v<Key> )
+                if ( k < 0 )
+                    return false;
+            size_type page = size_type( k )/PageSize;
+            return page < M_pages.size() && M_pages[page] && M_pages[page]->used[size_type( k )%PageSize];
+        }
+    value_type* slot( size_type pos ) { return M_pages[pos/PageSize]->slot( pos%PageSize ); }
+    value_type const* slot( size_type pos ) const { return M_pages[pos/PageSize]->slot( pos%PageSize ); }
+
+    //! first used slot from \p pos (npos if none)
+    size_type nextUsed( size_type pos ) const
+        {
+            for ( size_type page = pos/PageSize; page < M_pages.size(); ++page )
+            {
+                auto const& p = M_pages[page];
+                if ( p && p->count > 0 )
+                {
+                    for ( size_type i = ( page == pos/PageSize )? pos%PageSize : 0; i < PageSize; ++i )
+                        if ( p->used[i] )
+                            return page*PageSize+i;
+                }
+            }
+            return npos;
+        }
+
+    template<typename... Args>
+    void construct( key_type k, Args&&... args )
+        {
+            if constexpr ( std::is_signed_v<Key> )
+            {
+                CHECK( k >= 0 ) << "invalid id " << k;
+            }
+            size_type page = size_type( k )/PageSize, i = size_type( k )%PageSize;
+            if ( page >= M_pages.size() )
+                M_pages.resize( page+1 );
+            if ( !M_pages[page] )
+                M_pages[page] = std::make_unique<Page>();
+            auto& p = *M_pages[page];
+            ::new ( static_cast<void*>( p.slots[i].data ) ) value_type( std::forward<Args>( args )... );
+            p.used[i] = true;
+            ++p.count;
+            ++M_size;
+        }
+
+    void destroy( size_type pos )
+        {
+            auto& p = *M_pages[pos/PageSize];
+            p.slot( pos%PageSize )->~value_type();
+            p.used[pos%PageSize] = false;
+            --p.count;
+            --M_size;
+        }
+
+private:
+    std::vector<std::unique_ptr<Page>> M_pages;
+    size_type M_size = 0;
+};
+
+/**
+ * container of the mesh entities (elements, faces, edges, points) indexed by
+ * their id : a hash map by default, a DenseIdMap if Feel++ is configured
+ * with \c FEELPP_ENABLE_MESH_DENSE_STORAGE
+ */
+#if defined( FEELPP_ENABLE_MESH_DENSE_STORAGE )
+template<typename IndexT, typename EntityT>
+using mesh_entities_storage_t = DenseIdMap<IndexT,EntityT>;
+#else
+template<typename IndexT, typename EntityT>
+using mesh_entities_storage_t = std::unordered_map<IndexT,EntityT>;
+#endif
+
+} // namespace Feel
+
+#endif /* FEELPP_MESH_DENSEIDMAP_HPP */
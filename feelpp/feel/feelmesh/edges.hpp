@@ -31,6 +31,7 @@
 
 #include <unordered_map>
 #include <feel/feelcore/commobject.hpp>
+#include <feel/feelmesh/denseidmap.hpp>
 #include <feel/feelmesh/geoelement.hpp>
 
 namespace Feel
@@ -60,7 +61,7 @@ public:
                               mpl::identity<GeoElement1D<3, EdgeType,SubFaceOfMany<FaceType>,value_type > >,
                               mpl::identity<boost::none_t> >::type::type edge_type;
 
-    typedef std::unordered_map<size_type,edge_type> edges_type;
+    typedef mesh_entities_storage_t<size_type,edge_type> edges_type;
 
     typedef typename edges_type::iterator edge_iterator;
     typedef typename edges_type::const_iterator edge_const_iterator;
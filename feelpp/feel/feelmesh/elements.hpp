@@ -34,6 +34,7 @@
 #include <unordered_map>
 
 #include <feel/feelcore/commobject.hpp>
+#include <feel/feelmesh/denseidmap.hpp>
 #include <feel/feelmesh/geoelement.hpp>
 #include <feel/feelmesh/filters.hpp>
 
@@ -100,7 +101,7 @@ public:
         >;
     using element_ptrtype = std::shared_ptr<element_type>;
 
-    typedef std::unordered_map<size_type,element_type> elements_type;
+    typedef mesh_entities_storage_t<size_type,element_type> elements_type;
 
     typedef typename elements_type::iterator element_iterator;
     typedef typename elements_type::const_iterator element_const_iterator;
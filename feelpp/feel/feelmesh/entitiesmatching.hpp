@@ -0,0 +1,103 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+
+  This file is part of the Feel++ library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3.0 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#ifndef FEELPP_MESH_ENTITIESMATCHING_HPP
+#define FEELPP_MESH_ENTITIESMATCHING_HPP 1
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include <feel/feelcore/feel.hpp>
+#include <feel/feelcore/threadpool.hpp>
+
+namespace Feel
+{
+/**
+ * find the entities (faces, edges) which have the same vertices.
+ *
+ * \p vertices( k, ids ) fills the \c NV vertex ids (\c std::array) of the entity
+ * \c k, \c 0 <= k < n. The vertex ids of each entity are sorted and the
+ * entities are sorted by vertex ids : the keys are fixed size arrays stored
+ * in a single buffer, there is no hashing and no allocation by entity. The
+ * keys are computed and sorted on \p nThreads threads (\p vertices must be
+ * callable concurrently).
+ *
+ * \return for each entity, the smallest index of the entities which have the same vertices
+ */
+template<int NV, typename IndexT, typename VerticesFuncType>
+std::vector<IndexT>
+firstEntityWithSameVertices( IndexT n, VerticesFuncType&& vertices, int nThreads = 1 )
+{
+    struct Key
+    {
+        std::array<IndexT,NV> ids;
+        IndexT index;
+        bool operator<( Key const& k ) const { return ( ids < k.ids ) || ( ids == k.ids && index < k.index ); }
+    };
+    std::vector<Key> keys( n );
+    parallelForChunks( n, nThreads, [&]( IndexT begin, IndexT end )
+                               {
+                                   for ( IndexT k = begin; k < end; ++k )
+                                   {
+                                       vertices( k, keys[k].ids );
+                                       std::sort( keys[k].ids.begin(), keys[k].ids.end() );
+                                       keys[k].index = k;
+                                   }
+                               } );
+
+    // sort the chunks in parallel then merge them two by two
+    nThreads = std::max( 1, std::min<int>( nThreads, ( n+1023 )/1024 ) );
+    std::vector<IndexT> bounds( nThreads+1 );
+    for ( int t = 0; t <= nThreads; ++t )
+        bounds[t] = std::min( n, t*( ( n+nThreads-1 )/nThreads ) );
+    // one thread by chunk
+    parallelForChunks( IndexT( nThreads ), nThreads, [&]( IndexT begin, IndexT end )
+                       {
+                           for ( IndexT t = begin; t < end; ++t )
+                               std::sort( keys.begin()+bounds[t], keys.begin()+bounds[t+1] );
+                       }, IndexT( 1 ) );
+    for ( int width = 1; width < nThreads; width *= 2 )
+    {
+        int nMerges = ( nThreads+2*width-1 )/( 2*width );
+        parallelForChunks( IndexT( nMerges ), nMerges, [&]( IndexT begin, IndexT end )
+                           {
+                               for ( IndexT m = begin; m < end; ++m )
+                               {
+                                   int first = 2*width*m, middle = std::min( first+width, nThreads ), last = std::min( first+2*width, nThreads );
+                                   std::inplace_merge( keys.begin()+bounds[first], keys.begin()+bounds[middle], keys.begin()+bounds[last] );
+                               }
+                           }, IndexT( 1 ) );
+    }
+
+    // the first key of a group of equal ids has the smallest index
+    std::vector<IndexT> first( n );
+    for ( IndexT k = 0; k < n; )
+    {
+        IndexT g = k;
+        for ( ; k < n && keys[k].ids == keys[g].ids; ++k )
+            first[keys[k].index] = keys[g].index;
+    }
+    return first;
+}
+
+} // namespace Feel
+
+#endif /* FEELPP_MESH_ENTITIESMATCHING_HPP */
@@ -32,6 +32,7 @@
 
 #include <unordered_map>
 #include <feel/feelcore/commobject.hpp>
+#include <feel/feelmesh/denseidmap.hpp>
 #include <feel/feelmesh/geoelement.hpp>
 #include <feel/feelmesh/filters.hpp>
 
@@ -74,7 +75,7 @@ public:
                                                                                 >::type>::type> >::type::type::type face_type;
 
 
-    typedef std::unordered_map<index_type,face_type,std::hash<index_type>> faces_type;
+    typedef mesh_entities_storage_t<index_type,face_type> faces_type;
 
     typedef typename faces_type::iterator face_iterator;
     typedef typename faces_type::const_iterator face_const_iterator;
@@ -46,6 +46,7 @@
 #include <feel/feelmesh/geoelement.hpp>
 
 #include <feel/feelmesh/edges.hpp>
+#include <feel/feelmesh/entitiesmatching.hpp>
 #include <feel/feelmesh/elements.hpp>
 #include <feel/feelmesh/faces.hpp>
 #include <feel/feelmesh/functors.hpp>
@@ -560,168 +561,126 @@ void Mesh3D<GEOSHAPE, T, IndexT>::updateEntitiesCoDimensionTwo()
 {
     rank_type currentPid = this->worldComm().localRank();
 
-    //typedef std::unordered_map<std::set<size_type>, edge_type*, Feel::HashTables::HasherContainers<size_type> > pointstoedge_container_type;
-    typedef std::unordered_map<std::vector<size_type>, std::tuple<edge_type*, size_type>, Feel::HashTables::HasherContainers<size_type>> pointstoedge_container_type;
-    pointstoedge_container_type _edges;
-    typename pointstoedge_container_type::iterator _edgeit;
+    const bool updateComponentAddElements = this->components().test( MESH_ADD_ELEMENTS_INFO );
 
-    size_type next_edge = 0;
-    bool edgeinserted = false;
-    std::vector<size_type> lids( edge_type::numVertices );
+    // the keys are the edges already stored (to maintain the correct numbering),
+    // the edges of the boundary faces (in order that the first edges be those on
+    // the boundary, to obey the paradigm for a Mesh3D) and the edges of the elements
+    std::vector<edge_type*> existingEdges;
+    existingEdges.reserve( this->edges().size() );
+    for ( auto& [id,edge] : this->edges() )
+        existingEdges.push_back( &edge );
 
-    size_type vid, i1, i2;
-    const bool updateComponentAddElements = this->components().test( MESH_ADD_ELEMENTS_INFO );
-    tic();
-    // First We check if we have already Edges stored
-    if ( !this->edges().empty() )
+    std::vector<face_type const*> boundaryFaces;
+    auto rangeBoundaryFaces = this->facesOnBoundary();
+    for ( auto ifa = std::get<0>( rangeBoundaryFaces ), efa = std::get<1>( rangeBoundaryFaces ); ifa != efa; ++ifa )
+        boundaryFaces.push_back( &boost::unwrap_ref( *ifa ) );
+
+    std::vector<element_type*> orderedElements;
+    orderedElements.reserve( this->numElements() );
+    for ( auto elt_it = this->beginOrderedElement(), elt_en = this->endOrderedElement(); elt_it != elt_en; ++elt_it )
+        orderedElements.push_back( &unwrap_ref( *elt_it ) );
+
+    std::vector<uint16_type> myeToP( edge_type::numVertices * element_type::numEdges );
+    for ( uint16_type j = 0; j < element_type::numEdges; j++ )
     {
-        // dump first the existing edges, to maintain the correct numbering
-        // if everything is correct, the numbering structure will reflect
-        // the actual edge numbering
-        edge_iterator eit = this->beginEdge();
-        edge_iterator een = this->endEdge();
-        for ( ; eit != een; )
+        for ( uint16_type f = 0; f < edge_type::numVertices; ++f )
+            myeToP[j * edge_type::numVertices + f] = element_type::eToP( j, f );
+    }
+
+    tic();
+    const size_type nExistingEdges = existingEdges.size();
+    const size_type startElementEdges = nExistingEdges + boundaryFaces.size() * face_type::numEdges;
+    const size_type nKeys = startElementEdges + orderedElements.size() * element_type::numEdges;
+    auto firstEdge = firstEntityWithSameVertices<2, size_type>(
+        nKeys,
+        [&]( size_type k, auto& ids )
         {
-            auto& edge = eit->second;
-            i1 = edge.point( 0 ).id();
-            i2 = edge.point( 1 ).id();
-            //std::set<size_type> s( {i1, i2} );
-            if ( i1 < i2 )
+            if ( k < nExistingEdges )
             {
-                lids[0] = i1;
-                lids[1] = i2;
+                ids[0] = existingEdges[k]->point( 0 ).id();
+                ids[1] = existingEdges[k]->point( 1 ).id();
             }
-            else
+            else if ( k < startElementEdges )
             {
-                lids[1] = i1;
-                lids[0] = i2;
-            }
-
-            boost::tie( _edgeit, edgeinserted ) = _edges.emplace( std::piecewise_construct,
-                                                                  std::forward_as_tuple( lids ),
-                                                                  std::forward_as_tuple( &edge, invalid_v<size_type> ) );
-
-            if ( edgeinserted )
-            {
-                next_edge = std::max( next_edge, edge.id() + 1 );
-                ++eit;
+                face_type const& bface = *boundaryFaces[( k - nExistingEdges ) / face_type::numEdges];
+                uint16_type j = ( k - nExistingEdges ) % face_type::numEdges;
+                ids[0] = bface.point( face_type::eToP( j, 0 ) ).id();
+                ids[1] = bface.point( face_type::eToP( j, 1 ) ).id();
             }
             else
             {
-                eit = this->eraseEdge( eit );
+                element_type const& elt = *orderedElements[( k - startElementEdges ) / element_type::numEdges];
+                uint16_type j = ( k - startElementEdges ) % element_type::numEdges;
+                ids[0] = elt.point( myeToP[j * edge_type::numVertices + 0] ).id();
+                ids[1] = elt.point( myeToP[j * edge_type::numVertices + 1] ).id();
             }
-#if 0
-            FEELPP_ASSERT( edgeinserted )( i1 )( i2 )(j)( this->edge( j ).id() )( _edgeit->second )( this->edge( j ).hasMarker() )
-                ( this->edge( _edgeit->second ).point( 0 ).node() )( this->edge( _edgeit->second ).point( 1 ).node() )
-                ( this->edge( j ).point( 0 ).node() )( this->edge( j ).point( 1 ).node() ).error( "Two identical Edges stored in EdgeList" );
-            FEELPP_ASSERT( _edgeit->second == this->edge( j ).id() )( _edgeit->second )( this->edge( j ).id() ).error( "Edges in EdgeList have inconsistent id" );
-#endif
+        },
+        this->nThreadsUpdate() );
+    toc( "[Mesh3D::updateEdges] matching edges", FLAGS_v > 1 );
+
+    // edge associated to the first key of each group of identical edges
+    std::vector<edge_type*> edgePtrs( nKeys, nullptr );
+    size_type next_edge = 0;
+
+    tic();
+    for ( size_type k = 0; k < nExistingEdges; ++k )
+    {
+        edge_type* edge = existingEdges[k];
+        if ( firstEdge[k] == k )
+        {
+            edgePtrs[k] = edge;
+            next_edge = std::max( next_edge, edge->id() + 1 );
         }
+        else
+            this->eraseEdge( this->edgeIterator( edge->id() ) );
     }
+    existingEdges.clear();
     toc( "[Mesh3D::updateEdges] adding edges already registered", FLAGS_v > 1 );
-    tic();
 
-    if ( true ) //this->edges().empty() )
+    tic();
+    for ( size_type k = nExistingEdges; k < startElementEdges; ++k )
     {
-        // We want that the first edges be those on the boundary, in order to obey the paradigm for
-        // a Mesh3D
-        auto rangeBoundaryFaces = this->facesOnBoundary();
-        auto ifa = std::get<0>( rangeBoundaryFaces );
-        auto efa = std::get<1>( rangeBoundaryFaces );
-        for ( ; ifa != efa; ++ifa )
+        if ( firstEdge[k] == k )
         {
-            auto& bface = boost::unwrap_ref( *ifa );
-            for ( uint16_type j = 0; j < face_type::numEdges; j++ )
-            {
-                i1 = bface.point( face_type::eToP( j, 0 ) ).id();
-                i2 = bface.point( face_type::eToP( j, 1 ) ).id();
-                //std::set<size_type> s( { i1,i2 } );
-                if ( i1 < i2 )
-                {
-                    lids[0] = i1;
-                    lids[1] = i2;
-                }
-                else
-                {
-                    lids[1] = i1;
-                    lids[0] = i2;
-                }
-
-                boost::tie( _edgeit, edgeinserted ) = _edges.emplace( std::piecewise_construct,
-                                                                      std::forward_as_tuple( lids ),
-                                                                      std::forward_as_tuple( nullptr, invalid_v<size_type> ) );
-
-                if ( edgeinserted )
-                {
-                    edge_type edg;
-                    edg.setProcessIdInPartition( currentPid );
-                    edg.setId( next_edge++ );
-                    edg.setOnBoundary( true, 0 );
-                    edg.setProcessId( invalid_rank_type_value );
-                    for ( uint16_type k = 0; k < 2 + face_type::nbPtsPerEdge; k++ )
-                        edg.setPoint( k, const_cast<point_type&>( bface.point( face_type::eToP( j, k ) ) ) );
-
-                    auto res = this->addEdge( std::move(edg) );
-                    auto& edgeInserted = res.first->second;
-                    std::get<0>( _edgeit->second ) = &edgeInserted;
-                }
-                else
-                {
-                    auto edgePtr = std::get<0>( _edgeit->second );
-                    if ( !edgePtr->isOnBoundary() )
-                        edgePtr->setOnBoundary( true, 0 );
-                }
-            }
+            face_type const& bface = *boundaryFaces[( k - nExistingEdges ) / face_type::numEdges];
+            uint16_type j = ( k - nExistingEdges ) % face_type::numEdges;
+            edge_type edg;
+            edg.setProcessIdInPartition( currentPid );
+            edg.setId( next_edge++ );
+            edg.setOnBoundary( true, 0 );
+            edg.setProcessId( invalid_rank_type_value );
+            for ( uint16_type p = 0; p < 2 + face_type::nbPtsPerEdge; p++ )
+                edg.setPoint( p, const_cast<point_type&>( bface.point( face_type::eToP( j, p ) ) ) );
+
+            auto res = this->addEdge( std::move(edg) );
+            edgePtrs[k] = &res.first->second;
+        }
+        else
+        {
+            auto edgePtr = edgePtrs[firstEdge[k]];
+            if ( !edgePtr->isOnBoundary() )
+                edgePtr->setOnBoundary( true, 0 );
         }
     }
+    boundaryFaces.clear();
     toc( "[Mesh3D::updateEdges] adding boundaryfaces/edges", FLAGS_v > 1 );
+
     tic();
     edge_permutation_type reversePermutation( edge_permutation_type::REVERSE_PERMUTATION );
-
-    std::vector<uint16_type> myeToP( edge_type::numVertices * element_type::numEdges );
-    for ( uint16_type j = 0; j < element_type::numEdges; j++ )
-    {
-        for ( uint16_type f = 0; f < edge_type::numVertices; ++f )
-            myeToP[j * edge_type::numVertices + f] = element_type::eToP( j, f );
-    }
-    Eigen::Matrix<size_type, element_type::numVertices, 1> pointIdInElt;
-
-    auto elt_it = this->beginOrderedElement();
-    auto elt_en = this->endOrderedElement();
-    for ( ; elt_it != elt_en; ++elt_it )
+    for ( size_type e = 0; e < orderedElements.size(); ++e )
     {
-        auto& elt = unwrap_ref( *elt_it );
+        auto& elt = *orderedElements[e];
         rank_type eltPid = elt.processId();
-        vid = elt.id();
-
-        for ( uint16_type f = 0; f < element_type::numVertices; ++f )
-            pointIdInElt[f] = elt.point( f ).id();
+        size_type vid = elt.id();
 
         for ( uint16_type j = 0; j < element_type::numEdges; ++j )
         {
-            //auto const& pt0 = elt.point( element_type::eToP( j, 0 ) );
-            //auto const& pt1 = elt.point( element_type::eToP( j, 1 ) );
-            //i1 = pt0.id();
-            //i2 = pt1.id();
-            i1 = pointIdInElt[myeToP[j * edge_type::numVertices + 0]];
-            i2 = pointIdInElt[myeToP[j * edge_type::numVertices + 1]];
-            //std::set<size_type> s( {i1, i2} );
-            if ( i1 < i2 )
-            {
-                lids[0] = i1;
-                lids[1] = i2;
-            }
-            else
-            {
-                lids[1] = i1;
-                lids[0] = i2;
-            }
+            const size_type k = startElementEdges + e * element_type::numEdges + j;
+            size_type i1 = elt.point( myeToP[j * edge_type::numVertices + 0] ).id();
+            size_type i2 = elt.point( myeToP[j * edge_type::numVertices + 1] ).id();
 
-            boost::tie( _edgeit, edgeinserted ) = _edges.emplace( std::piecewise_construct,
-                                                                  std::forward_as_tuple( lids ),
-                                                                  std::forward_as_tuple( nullptr, i1 ) );
-
-            if ( edgeinserted )
+            if ( firstEdge[k] == k )
             {
                 edge_type edg;
                 edg.setProcessIdInPartition( currentPid );
@@ -742,45 +701,29 @@ void Mesh3D<GEOSHAPE, T, IndexT>::updateEntitiesCoDimensionTwo()
                 auto& pt1 = elt.point( element_type::eToP( j, 1 ) );
                 edg.setPoint( 0, pt0 );
                 edg.setPoint( 1, pt1 );
-                for ( uint16_type k = 2; k < 2 + element_type::nbPtsPerEdge; k++ )
-                    edg.setPoint( k, elt.point( element_type::eToP( j, k ) ) );
+                for ( uint16_type p = 2; p < 2 + element_type::nbPtsPerEdge; p++ )
+                    edg.setPoint( p, elt.point( element_type::eToP( j, p ) ) );
 
                 // add edge in mesh container
                 auto res = this->addEdge( std::move(edg) );
                 auto& edgeInserted = res.first->second;
                 // update edge pointer in element
                 elt.setEdge( j, boost::cref( edgeInserted ) );
-                std::get<0>( _edgeit->second ) = &edgeInserted;
-
-                if ( i1 > i2 )
-                    elt.setEdgePermutation( j, reversePermutation );
+                edgePtrs[k] = &edgeInserted;
             }
             else
             {
-                auto edgePtr = std::get<0>( _edgeit->second );
+                auto edgePtr = edgePtrs[firstEdge[k]];
                 // update edge pointer in element
                 elt.setEdge( j, boost::cref( *edgePtr ) );
                 // set the process id from element (only active element)
                 if ( !elt.isGhostCell() && edgePtr->processId() != eltPid )
                     edgePtr->setProcessId( eltPid );
                 if ( updateComponentAddElements || edgePtr->hasMarker() )
-                {
-                    //DLOG_IF(INFO, eit->marker().isOn()) << "found edge " << eit->id() << " with marker:" << eit->marker() << ", adding element id : " << vid <<  "  local edge id " << j;
                     edgePtr->addElement( vid, j );
-                }
-#if 0
-                // update edge orientation in element
-                size_type& ptForPermutation = std::get<1>( _edgeit->second );
-                if ( ptForPermutation == invalid_v<size_type> )
-                    ptForPermutation = i1;
-                else if ( ptForPermutation != i1 )
-                    elt.setEdgePermutation( j, reversePermutation );
-                // if ( i1 != edgePtr->point( 0 ).id() )
-                //     elt.setEdgePermutation( j, reversePermutation );
-#endif
-                if ( i1 > i2 )
-                    elt.setEdgePermutation( j, reversePermutation );
             }
+            if ( i1 > i2 )
+                elt.setEdgePermutation( j, reversePermutation );
 
         } // for ( uint16_type j = 0; j < element_type::numEdges; ++j )
     }
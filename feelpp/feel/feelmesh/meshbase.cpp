@@ -45,6 +45,7 @@ MeshBase<IndexT>::MeshBase( std::string const& name, uint16_type topoDim, uint16
     M_n_vertices( 0 ),
     M_n_parts( 1 )
 {
+    this->setNThreadsUpdate( ioption( _name="mesh.update.nthreads" ) );
     DVLOG(2) << "[MeshBase] constructor...\n";
     DVLOG(2) << "[MeshBase] worldcomm:" << worldComm->globalRank() ;
     CHECK( worldComm ) << "invalid mesh worldcomm";
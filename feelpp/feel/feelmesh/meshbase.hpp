@@ -25,6 +25,7 @@
 #ifndef FEELPP_MESHBASE_HPP
 #define FEELPP_MESHBASE_HPP 1
 
+#include <thread>
 #include <unordered_map>
 
 #include <feel/feelcore/feel.hpp>
@@ -236,6 +237,12 @@ public:
         return M_n_parts;
     }
 
+    //! number of threads used to build the faces and edges of the mesh
+    int nThreadsUpdate() const
+    {
+        return M_nThreadsUpdate;
+    }
+
     /**
      * \return \c true if mesh is partitioned, \c false otherwise
      */
@@ -287,6 +294,12 @@ public:
         M_n_vertices = n ;
     }
 
+    //! set the number of threads used to build the faces and edges (0: hardware concurrency)
+    void setNThreadsUpdate( int n )
+    {
+        M_nThreadsUpdate = ( n > 0 )? n : std::max( 1u, std::thread::hardware_concurrency() );
+    }
+
     /**
      * set the components to be updated by \c updateForUse()
      * \sa updateForUse
@@ -912,6 +925,9 @@ private:
      */
     rank_type M_n_parts;
 
+    //! number of threads used to build the faces and edges
+    int M_nThreadsUpdate = 1;
+
     // sub mesh data
     smd_ptrtype M_smd;
 
@@ -0,0 +1,116 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+
+  This file is part of the Feel++ library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3.0 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#ifndef FEELPP_MESH_MORTON_HPP
+#define FEELPP_MESH_MORTON_HPP 1
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Feel
+{
+namespace detail
+{
+//! spread the 21 lower bits of \p x every 3 bits
+inline std::uint64_t mortonSpreadBits3( std::uint64_t x )
+{
+    x &= 0x1fffff;
+    x = ( x | x << 32 ) & 0x1f00000000ffffull;
+    x = ( x | x << 16 ) & 0x1f0000ff0000ffull;
+    x = ( x | x << 8 ) & 0x100f00f00f00f00full;
+    x = ( x | x << 4 ) & 0x10c30c30c30c30c3ull;
+    x = ( x | x << 2 ) & 0x1249249249249249ull;
+    return x;
+}
+
+/**
+ * key of the point \p x on the Morton (Z-order) curve of the box [\p bmin,\p bmax]
+ * in dimension \p d (<=3), each coordinate is quantized on 21 bits
+ */
+template<typename PointType, typename BoxType>
+std::uint64_t mortonKey( PointType const& x, BoxType const& bmin, BoxType const& bmax, int d )
+{
+    constexpr std::uint64_t nCells = std::uint64_t(1) << 21;
+    std::uint64_t key = 0;
+    for ( int c = 0; c < d; ++c )
+    {
+        double len = bmax[c] - bmin[c];
+        double t = ( len > 0 )? ( x[c] - bmin[c] )/len : 0.;
+        std::uint64_t xi = std::min( nCells-1, static_cast<std::uint64_t>( std::max( 0., t )*nCells ) );
+        key |= mortonSpreadBits3( xi ) << c;
+    }
+    return key;
+}
+
+/**
+ * key of the point \p x on the Hilbert curve of the box [\p bmin,\p bmax]
+ * in dimension \p d (<=3), each coordinate is quantized on 21 bits.
+ * Unlike the Morton curve, two consecutive cells of the Hilbert curve are
+ * always neighbours, which gives more compact parts when the curve is split.
+ * The key is built with the transposition algorithm of J. Skilling (2004).
+ */
+template<typename PointType, typename BoxType>
+std::uint64_t hilbertKey( PointType const& x, BoxType const& bmin, BoxType const& bmax, int d )
+{
+    constexpr int nBits = 21;
+    constexpr std::uint32_t nCells = std::uint32_t(1) << nBits;
+    std::uint32_t X[3] = { 0, 0, 0 };
+    for ( int c = 0; c < d; ++c )
+    {
+        double len = bmax[c] - bmin[c];
+        double t = ( len > 0 )? ( x[c] - bmin[c] )/len : 0.;
+        X[c] = std::min( nCells-1, static_cast<std::uint32_t>( std::max( 0., t )*nCells ) );
+    }
+    // inverse undo of the rotations and reflections
+    for ( std::uint32_t Q = nCells >> 1; Q > 1; Q >>= 1 )
+    {
+        std::uint32_t P = Q - 1;
+        for ( int c = 0; c < d; ++c )
+        {
+            if ( X[c] & Q )
+                X[0] ^= P;
+            else
+            {
+                std::uint32_t t = ( X[0] ^ X[c] ) & P;
+                X[0] ^= t;
+                X[c] ^= t;
+            }
+        }
+    }
+    // Gray encoding
+    for ( int c = 1; c < d; ++c )
+        X[c] ^= X[c-1];
+    std::uint32_t t = 0;
+    for ( std::uint32_t Q = nCells >> 1; Q > 1; Q >>= 1 )
+        if ( X[d-1] & Q )
+            t ^= Q - 1;
+    for ( int c = 0; c < d; ++c )
+        X[c] ^= t;
+    // interleave the transposed coordinates, the first one holds the most significant bit
+    std::uint64_t key = 0;
+    for ( int b = nBits-1; b >= 0; --b )
+        for ( int c = 0; c < d; ++c )
+            key = ( key << 1 ) | ( ( X[c] >> b ) & 1 );
+    return key;
+}
+} // namespace detail
+} // namespace Feel
+
+#endif /* FEELPP_MESH_MORTON_HPP */
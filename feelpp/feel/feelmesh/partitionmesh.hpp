@@ -27,6 +27,8 @@
 #include <boost/iterator/counting_iterator.hpp>
 #include <feel/feelmesh/meshpartitionset.hpp>
 #include <feel/feelpartition/partitioner.hpp>
+#include <feel/feelpartition/partitionergeometric.hpp>
+#include <feel/feelpartition/migratemesh.hpp>
 #if defined(FEELPP_HAS_METIS)
 #include <feel/feelpartition/partitionermetis.hpp>
 #endif
@@ -63,6 +65,23 @@ partitionMesh( std::shared_ptr<MeshType> mesh,
 #endif
 }
 
+/**
+ * partition in parallel a distributed mesh with a geometric partitioner, one
+ * part per process, and migrate the elements to their new process
+ *
+ * @return a std::unique_ptr to a MeshPartitionSet of the migrated mesh
+ */
+template<typename MeshType>
+std::unique_ptr<MeshPartitionSet<MeshType>>
+partitionMeshGeometric( std::shared_ptr<MeshType> mesh,
+                        GeometricPartitioning method = GeometricPartitioning::Hilbert,
+                        size_type ctxMeshUpdate = MESH_UPDATE_EDGES|MESH_UPDATE_FACES )
+{
+    PartitionerGeometric<MeshType> partitioner( method );
+    auto parts = partitioner.partitionIds( mesh, mesh->worldComm().localSize() );
+    return std::make_unique<MeshPartitionSet<MeshType>>( migrateMesh( mesh, parts, ctxMeshUpdate ) );
+}
+
 
 
 }
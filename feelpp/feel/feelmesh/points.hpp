@@ -32,6 +32,7 @@
 #include <unordered_map>
 
 #include <feel/feelcore/commobject.hpp>
+#include <feel/feelmesh/denseidmap.hpp>
 #include <feel/feelmesh/geoelement.hpp>
 
 namespace Feel
@@ -55,7 +56,7 @@ class Points
     using size_type = index_type;
     typedef GeoElement0D<nDim, SubFace, T, IndexT> point_type;
 
-    typedef std::unordered_map<size_type, point_type> points_type;
+    typedef mesh_entities_storage_t<size_type,point_type> points_type;
 
     typedef typename points_type::iterator point_iterator;
     typedef typename points_type::const_iterator point_const_iterator;
@@ -0,0 +1,586 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+
+  This file is part of the Feel++ library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3.0 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#ifndef FEELPP_MESH_WIDEBVH_HPP
+#define FEELPP_MESH_WIDEBVH_HPP 1
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <boost/container/small_vector.hpp>
+#include <Eigen/Core>
+
+#include <feel/feelcore/threadpool.hpp>
+
+namespace Feel
+{
+/**
+ * @brief bounding volume hierarchy of axis aligned boxes with \c Width children per node
+ *
+ * A binary tree is built with a binned surface area heuristic (SAH), the
+ * large subtrees being built concurrently by the threads of the shared
+ * ThreadPool. It is then collapsed into nodes of \c Width (4 or 8) children
+ * whose boxes are stored by coordinate in a flat array, so that a ray, a
+ * packet of rays or a point is tested against all the children of a node
+ * with a few vector operations.
+ *
+ * It is used for the ray tracing (BVH_InHouse), the distance queries and the
+ * localisation of points in the elements of a mesh. The primitives are only
+ * known through their boxes : the intersection with the primitives of a leaf
+ * is done by a callback.
+ *
+ * @code
+ * WideBVH<3,4> bvh;
+ * bvh.build( boxes ); // boxes[6*i..6*i+2] = min of box i, boxes[6*i+3..6*i+5] = max
+ * double tmax = 1e30;
+ * bvh.intersect( origin, dir, 0., tmax, [&]( int first, int n, double& tmax ) {
+ *     for ( int k = first; k < first+n; ++k ) // hit with bvh.primitiveId( k ) reduces tmax
+ * } );
+ * bvh.visit( x, [&]( int i ) { return isIn( i, x ); } ); // stop when true is returned
+ * @endcode
+ */
+template <int RealDim, int Width = 4>
+class WideBVH
+{
+    static_assert( Width >= 2 && Width <= 16, "invalid node width" );
+public:
+    static constexpr int nRealDim = RealDim;
+    static constexpr int width = Width;
+    using point_type = Eigen::Array<double,RealDim,1>;
+    using box_array_type = Eigen::Array<double,RealDim,Width>;
+
+    //! node storing the boxes of its children
+    struct Node
+    {
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+        box_array_type childMin;
+        box_array_type childMax;
+        //! node index (inner child), first primitive (leaf child) or -1 (no child)
+        std::array<std::int32_t,Width> child;
+        //! number of primitives of a leaf child, 0 for an inner child
+        std::array<std::int32_t,Width> nPrimitives;
+    };
+
+    struct Config
+    {
+        //! a node with more primitives is always split
+        int maxLeafSize = 4;
+        //! number of bins of the SAH evaluation along each axis
+        int nBins = 16;
+        //! cost of the traversal of a node relative to the intersection of a primitive
+        double traversalCost = 1.;
+        //! number of threads used by the build (threads of the shared ThreadPool)
+        int nThreads = 1;
+        //! subtrees with less primitives are built on the current thread
+        std::size_t parallelThreshold = 4096;
+    };
+
+    WideBVH() = default;
+    explicit WideBVH( Config const& config ) : M_config( config ) {}
+    WideBVH( WideBVH && ) = default;
+    WideBVH& operator=( WideBVH && ) = default;
+
+    Config const& config() const { return M_config; }
+    bool empty() const { return M_nodes.empty(); }
+    std::size_t nPrimitives() const { return M_primitiveIds.size(); }
+    std::size_t nNodes() const { return M_nodes.size(); }
+    std::vector<Node,Eigen::aligned_allocator<Node>> const& nodes() const { return M_nodes; }
+
+    //! index of the primitive stored at position \p k in the leaves
+    std::int32_t primitiveId( std::size_t k ) const { return M_primitiveIds[k]; }
+
+    /**
+     * build the hierarchy of the boxes : the box \c i is given by
+     * \c boxes[2*RealDim*i+c] (min) and \c boxes[2*RealDim*i+RealDim+c] (max)
+     */
+    void build( std::vector<double> const& boxes )
+        {
+            std::size_t n = boxes.size()/(2*RealDim);
+            M_nodes.clear();
+            M_primitiveIds.resize( n );
+            std::iota( M_primitiveIds.begin(), M_primitiveIds.end(), 0 );
+            if ( n == 0 )
+                return;
+            M_boxMin.resize( RealDim, n );
+            M_boxMax.resize( RealDim, n );
+            M_centers.resize( RealDim, n );
+            for ( std::size_t i = 0; i < n; ++i )
+            {
+                for ( int c = 0; c < RealDim; ++c )
+                {
+                    M_boxMin( c, i ) = boxes[2*RealDim*i+c];
+                    M_boxMax( c, i ) = boxes[2*RealDim*i+RealDim+c];
+                }
+            }
+            M_centers = 0.5*( M_boxMin + M_boxMax );
+
+            // the top of the tree is split on this thread, the subtrees below
+            // are then built concurrently by the threads of the pool
+            bool parallel = M_config.nThreads > 1 && n >= M_config.parallelThreshold;
+            int maxParallelDepth = 0;
+            while ( ( 1 << maxParallelDepth ) < 2*M_config.nThreads )
+                ++maxParallelDepth;
+            std::vector<PendingSubtree> pending;
+            auto root = this->buildBinary( 0, n, maxParallelDepth, parallel ? &pending : nullptr );
+            if ( !pending.empty() )
+            {
+                auto pool = sharedThreadPool( M_config.nThreads );
+                std::vector<std::future<void>> futures;
+                futures.reserve( pending.size() );
+                for ( auto const& sub : pending )
+                    futures.push_back( pool->submit( [this,sub]{ *sub.slot = this->buildBinary( sub.first, sub.last, 0, nullptr ); } ) );
+                for ( auto& f : futures )
+                    f.get();
+            }
+            this->collapse( *root );
+
+            // the boxes of the primitives are kept for the point queries
+            M_centers.resize( RealDim, 0 );
+        }
+
+    /**
+     * traverse the nodes hit by the ray \p origin + t \p dir, t in [\p tmin, \p tmax],
+     * the closest first. \p f(first,n,tmax) is called for the leaves hit and
+     * reduces \p tmax when a primitive is hit.
+     */
+    template <typename F>
+    void intersect( point_type const& origin, point_type const& dir, double tmin, double& tmax, F&& f ) const
+        {
+            if ( M_nodes.empty() )
+                return;
+            point_type invDir = dir.unaryExpr( &WideBVH::safeInverse );
+            struct Entry { std::int32_t child, nPrimitives; double tNear; };
+            boost::container::small_vector<Entry,64> stack;
+            stack.push_back( Entry{ 0, 0, tmin } );
+            while ( !stack.empty() )
+            {
+                Entry e = stack.back();
+                stack.pop_back();
+                if ( e.tNear > tmax )
+                    continue;
+                if ( e.nPrimitives > 0 )
+                {
+                    f( e.child, e.nPrimitives, tmax );
+                    continue;
+                }
+                Node const& node = M_nodes[e.child];
+                box_array_type t0 = ( node.childMin.colwise() - origin ).colwise()*invDir;
+                box_array_type t1 = ( node.childMax.colwise() - origin ).colwise()*invDir;
+                Eigen::Array<double,1,Width> tNear = t0.min( t1 ).colwise().maxCoeff().max( tmin );
+                Eigen::Array<double,1,Width> tFar = ( t0.max( t1 ).colwise().minCoeff()*S_robustFactor ).min( tmax );
+                std::size_t firstHit = stack.size();
+                for ( int k = 0; k < Width; ++k )
+                {
+                    if ( node.child[k] < 0 || tNear[k] > tFar[k] )
+                        continue;
+                    stack.push_back( Entry{ node.child[k], node.nPrimitives[k], tNear[k] } );
+                }
+                // the closest child is popped first
+                std::sort( stack.begin()+firstHit, stack.end(), []( Entry const& a, Entry const& b ) { return a.tNear > b.tNear; } );
+            }
+        }
+
+    /**
+     * traverse the nodes hit by a packet of \c P rays : a node is visited if
+     * it is hit by one of the rays of \p active. \p f(first,n,mask,tmax) is
+     * called for the leaves hit, \c mask being the rays whose path hits the
+     * leaf box.
+     */
+    template <int P, typename F>
+    void intersect( Eigen::Array<double,RealDim,P> const& origin, Eigen::Array<double,RealDim,P> const& dir,
+                    Eigen::Array<double,1,P> const& tmin, Eigen::Array<double,1,P>& tmax,
+                    Eigen::Array<bool,1,P> const& active, F&& f ) const
+        {
+            using mask_type = Eigen::Array<bool,1,P>;
+            using row_type = Eigen::Array<double,1,P>;
+            if ( M_nodes.empty() || !active.any() )
+                return;
+            Eigen::Array<double,RealDim,P> invDir = dir.unaryExpr( &WideBVH::safeInverse );
+            struct Entry { std::int32_t child, nPrimitives; double tNear; mask_type mask; };
+            boost::container::small_vector<Entry,64> stack;
+            stack.push_back( Entry{ 0, 0, tmin.minCoeff(), active } );
+            while ( !stack.empty() )
+            {
+                Entry e = stack.back();
+                stack.pop_back();
+                if ( e.tNear > e.mask.select( tmax, row_type::Constant( std::numeric_limits<double>::lowest() ) ).maxCoeff() )
+                    continue;
+                if ( e.nPrimitives > 0 )
+                {
+                    f( e.child, e.nPrimitives, e.mask, tmax );
+                    continue;
+                }
+                Node const& node = M_nodes[e.child];
+                std::size_t firstHit = stack.size();
+                for ( int k = 0; k < Width; ++k )
+                {
+                    if ( node.child[k] < 0 )
+                        continue;
+                    Eigen::Array<double,RealDim,P> t0 = ( (-origin).colwise() + node.childMin.col( k ) )*invDir;
+                    Eigen::Array<double,RealDim,P> t1 = ( (-origin).colwise() + node.childMax.col( k ) )*invDir;
+                    row_type tNear = t0.min( t1 ).colwise().maxCoeff().max( tmin );
+                    row_type tFar = ( t0.max( t1 ).colwise().minCoeff()*S_robustFactor ).min( tmax );
+                    mask_type hit = e.mask && ( tNear <= tFar );
+                    if ( !hit.any() )
+                        continue;
+                    double tNearMin = hit.select( tNear, row_type::Constant( std::numeric_limits<double>::max() ) ).minCoeff();
+                    stack.push_back( Entry{ node.child[k], node.nPrimitives[k], tNearMin, hit } );
+                }
+                std::sort( stack.begin()+firstHit, stack.end(), []( Entry const& a, Entry const& b ) { return a.tNear > b.tNear; } );
+            }
+        }
+
+    /**
+     * traverse the nodes whose box is at a squared distance of \p p lower
+     * than \p d2max, the closest first. \p f(first,n,d2max) is called for
+     * these leaves and reduces \p d2max when a closer primitive is found, the
+     * farther boxes are then pruned.
+     */
+    template <typename F>
+    void nearest( point_type const& p, double& d2max, F&& f ) const
+        {
+            if ( M_nodes.empty() )
+                return;
+            struct Entry { std::int32_t child, nPrimitives; double d2; };
+            boost::container::small_vector<Entry,64> stack;
+            stack.push_back( Entry{ 0, 0, 0. } );
+            while ( !stack.empty() )
+            {
+                Entry e = stack.back();
+                stack.pop_back();
+                if ( e.d2 > d2max )
+                    continue;
+                if ( e.nPrimitives > 0 )
+                {
+                    f( e.child, e.nPrimitives, d2max );
+                    continue;
+                }
+                Node const& node = M_nodes[e.child];
+                box_array_type delta = ( node.childMin.colwise() - p ).max( 0. ) + ( (-node.childMax).colwise() + p ).max( 0. );
+                Eigen::Array<double,1,Width> d2 = delta.square().colwise().sum();
+                std::size_t firstHit = stack.size();
+                for ( int k = 0; k < Width; ++k )
+                {
+                    if ( node.child[k] < 0 || d2[k] > d2max )
+                        continue;
+                    stack.push_back( Entry{ node.child[k], node.nPrimitives[k], d2[k] } );
+                }
+                std::sort( stack.begin()+firstHit, stack.end(), []( Entry const& a, Entry const& b ) { return a.d2 > b.d2; } );
+            }
+        }
+
+    /**
+     * call \p f(i) for each primitive \c i whose box contains \p x (enlarged by
+     * \p tol), the traversal stops as soon as \p f returns true
+     * @return true if \p f has returned true
+     */
+    template <typename PointType, typename F>
+    bool visit( PointType const& x, F&& f, double tol = 0 ) const
+        {
+            if ( M_nodes.empty() )
+                return false;
+            point_type p;
+            for ( int c = 0; c < RealDim; ++c )
+                p[c] = x[c];
+            boost::container::small_vector<std::int32_t,64> stack{ 0 };
+            while ( !stack.empty() )
+            {
+                Node const& node = M_nodes[stack.back()];
+                stack.pop_back();
+                Eigen::Array<bool,1,Width> inside = ( ( node.childMin.colwise() - p ) <= tol ).colwise().all() &&
+                    ( ( (-node.childMax).colwise() + p ) <= tol ).colwise().all();
+                for ( int k = 0; k < Width; ++k )
+                {
+                    if ( node.child[k] < 0 || !inside[k] )
+                        continue;
+                    if ( node.nPrimitives[k] == 0 )
+                    {
+                        stack.push_back( node.child[k] );
+                        continue;
+                    }
+                    for ( std::int32_t j = node.child[k]; j < node.child[k] + node.nPrimitives[k]; ++j )
+                    {
+                        std::int32_t i = M_primitiveIds[j];
+                        if ( ( M_boxMin.col( i ) - p <= tol ).all() && ( p - M_boxMax.col( i ) <= tol ).all() && f( i ) )
+                            return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+private:
+    //! node of the binary tree built before the collapse
+    struct BuildNode
+    {
+        point_type boundMin, boundMax;
+        std::size_t first = 0, count = 0;
+        std::array<std::unique_ptr<BuildNode>,2> children;
+        bool isLeaf() const { return !children[0]; }
+    };
+
+    //! subtree of the primitives [first,last) to build in \c *slot
+    struct PendingSubtree
+    {
+        std::unique_ptr<BuildNode>* slot;
+        std::size_t first, last;
+    };
+
+    //! enlarge the exit distance of the boxes, so that the rounding errors do not miss a primitive on a box face
+    static constexpr double S_robustFactor = 1 + 4*std::numeric_limits<double>::epsilon();
+
+    static double safeInverse( double d )
+        {
+            constexpr double eps = std::numeric_limits<double>::epsilon();
+            return std::abs( d ) > eps ? 1./d : std::copysign( 1./eps, d );
+        }
+
+    //! half of the surface of a box (half of the perimeter in 2D)
+    static double halfArea( point_type const& bmin, point_type const& bmax )
+        {
+            point_type e = ( bmax - bmin ).max( 0. );
+            if constexpr ( RealDim == 3 )
+                return e[0]*e[1] + e[1]*e[2] + e[2]*e[0];
+            else if constexpr ( RealDim == 2 )
+                return e[0] + e[1];
+            else
+                return 1.;
+        }
+
+    /**
+     * build the binary tree of the primitives [first,last). If \p pending is
+     * given, the subtrees below the depth \p parallelDepth are not built but
+     * added to \p pending
+     */
+    std::unique_ptr<BuildNode> buildBinary( std::size_t first, std::size_t last, int parallelDepth, std::vector<PendingSubtree>* pending )
+        {
+            auto node = std::make_unique<BuildNode>();
+            node->first = first;
+            node->count = last-first;
+            node->boundMin = point_type::Constant( std::numeric_limits<double>::max() );
+            node->boundMax = point_type::Constant( std::numeric_limits<double>::lowest() );
+            point_type cmin = node->boundMin, cmax = node->boundMax;
+            for ( std::size_t k = first; k < last; ++k )
+            {
+                std::int32_t i = M_primitiveIds[k];
+                node->boundMin = node->boundMin.min( M_boxMin.col( i ) );
+                node->boundMax = node->boundMax.max( M_boxMax.col( i ) );
+                cmin = cmin.min( M_centers.col( i ) );
+                cmax = cmax.max( M_centers.col( i ) );
+            }
+            std::size_t n = node->count;
+            if ( n <= 1 )
+                return node;
+
+            // binned SAH : best split among the bins boundaries of all the axes
+            int nBins = std::max( 2, M_config.nBins );
+            double bestCost = std::numeric_limits<double>::max();
+            int bestAxis = -1, bestBin = -1;
+            std::vector<std::size_t> binCount( nBins );
+            std::vector<point_type> binMin( nBins ), binMax( nBins ), rightMin( nBins ), rightMax( nBins );
+            for ( int axis = 0; axis < RealDim; ++axis )
+            {
+                double extent = cmax[axis]-cmin[axis];
+                if ( !( extent > 0 ) )
+                    continue;
+                double scale = nBins/extent;
+                std::fill( binCount.begin(), binCount.end(), 0 );
+                std::fill( binMin.begin(), binMin.end(), point_type::Constant( std::numeric_limits<double>::max() ) );
+                std::fill( binMax.begin(), binMax.end(), point_type::Constant( std::numeric_limits<double>::lowest() ) );
+                for ( std::size_t k = first; k < last; ++k )
+                {
+                    std::int32_t i = M_primitiveIds[k];
+                    int b = std::min( nBins-1, int( ( M_centers( axis, i )-cmin[axis] )*scale ) );
+                    ++binCount[b];
+                    binMin[b] = binMin[b].min( M_boxMin.col( i ) );
+                    binMax[b] = binMax[b].max( M_boxMax.col( i ) );
+                }
+                rightMin[nBins-1] = binMin[nBins-1];
+                rightMax[nBins-1] = binMax[nBins-1];
+                for ( int b = nBins-2; b >= 0; --b )
+                {
+                    rightMin[b] = rightMin[b+1].min( binMin[b] );
+                    rightMax[b] = rightMax[b+1].max( binMax[b] );
+                }
+                point_type leftMin = point_type::Constant( std::numeric_limits<double>::max() );
+                point_type leftMax = point_type::Constant( std::numeric_limits<double>::lowest() );
+                std::size_t leftCount = 0;
+                for ( int b = 1; b < nBins; ++b )
+                {
+                    leftMin = leftMin.min( binMin[b-1] );
+                    leftMax = leftMax.max( binMax[b-1] );
+                    leftCount += binCount[b-1];
+                    if ( leftCount == 0 || leftCount == n )
+                        continue;
+                    double cost = halfArea( leftMin, leftMax )*leftCount + halfArea( rightMin[b], rightMax[b] )*( n-leftCount );
+                    if ( cost < bestCost )
+                    {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestBin = b;
+                    }
+                }
+            }
+
+            double area = halfArea( node->boundMin, node->boundMax );
+            bool hasSplit = bestAxis >= 0;
+            double splitCost = hasSplit ? M_config.traversalCost + ( area > 0 ? bestCost/area : 0. ) : 0.;
+            if ( n <= std::size_t( M_config.maxLeafSize ) && ( !hasSplit || double( n ) <= splitCost ) )
+                return node;
+
+            std::size_t mid = first;
+            if ( hasSplit )
+            {
+                double scale = nBins/( cmax[bestAxis]-cmin[bestAxis] );
+                auto itMid = std::partition( M_primitiveIds.begin()+first, M_primitiveIds.begin()+last,
+                                             [&]( std::int32_t i ) {
+                                                 return std::min( nBins-1, int( ( M_centers( bestAxis, i )-cmin[bestAxis] )*scale ) ) < bestBin;
+                                             } );
+                mid = std::distance( M_primitiveIds.begin(), itMid );
+            }
+            if ( mid == first || mid == last )
+            {
+                // all the centers in the same bin : median split along the largest extent
+                int axis = 0;
+                for ( int c = 1; c < RealDim; ++c )
+                    if ( cmax[c]-cmin[c] > cmax[axis]-cmin[axis] )
+                        axis = c;
+                mid = first + n/2;
+                std::nth_element( M_primitiveIds.begin()+first, M_primitiveIds.begin()+mid, M_primitiveIds.begin()+last,
+                                  [this,axis]( std::int32_t a, std::int32_t b ) { return M_centers( axis, a ) < M_centers( axis, b ); } );
+            }
+
+            if ( pending && parallelDepth > 0 && n >= M_config.parallelThreshold )
+            {
+                node->children[0] = this->buildBinary( first, mid, parallelDepth-1, pending );
+                node->children[1] = this->buildBinary( mid, last, parallelDepth-1, pending );
+            }
+            else if ( pending )
+            {
+                pending->push_back( PendingSubtree{ &node->children[0], first, mid } );
+                pending->push_back( PendingSubtree{ &node->children[1], mid, last } );
+            }
+            else
+            {
+                node->children[0] = this->buildBinary( first, mid, 0, nullptr );
+                node->children[1] = this->buildBinary( mid, last, 0, nullptr );
+            }
+            return node;
+        }
+
+    //! collapse the binary tree into nodes of Width children
+    void collapse( BuildNode const& root )
+        {
+            std::vector<std::pair<BuildNode const*,std::int32_t>> toFill;
+            M_nodes.emplace_back();
+            if ( root.isLeaf() )
+            {
+                this->initNode( M_nodes[0] );
+                this->setChild( M_nodes[0], 0, root, -1 );
+                return;
+            }
+            toFill.push_back( std::make_pair( &root, 0 ) );
+            while ( !toFill.empty() )
+            {
+                auto [binaryNode,nodeId] = toFill.back();
+                toFill.pop_back();
+
+                // open the inner child of largest surface until Width children are found
+                boost::container::small_vector<BuildNode const*,Width> children{ binaryNode->children[0].get(), binaryNode->children[1].get() };
+                while ( children.size() < Width )
+                {
+                    int toOpen = -1;
+                    double maxArea = -1;
+                    for ( int k = 0; k < int( children.size() ); ++k )
+                    {
+                        if ( children[k]->isLeaf() )
+                            continue;
+                        double a = halfArea( children[k]->boundMin, children[k]->boundMax );
+                        if ( a > maxArea )
+                        {
+                            maxArea = a;
+                            toOpen = k;
+                        }
+                    }
+                    if ( toOpen < 0 )
+                        break;
+                    BuildNode const* opened = children[toOpen];
+                    children[toOpen] = opened->children[0].get();
+                    children.push_back( opened->children[1].get() );
+                }
+
+                Node node;
+                this->initNode( node );
+                for ( int k = 0; k < int( children.size() ); ++k )
+                {
+                    std::int32_t childNodeId = -1;
+                    if ( !children[k]->isLeaf() )
+                    {
+                        childNodeId = M_nodes.size();
+                        M_nodes.emplace_back();
+                        toFill.push_back( std::make_pair( children[k], childNodeId ) );
+                    }
+                    this->setChild( node, k, *children[k], childNodeId );
+                }
+                M_nodes[nodeId] = node;
+            }
+        }
+
+    static void initNode( Node& node )
+        {
+            node.childMin.setConstant( std::numeric_limits<double>::max() );
+            node.childMax.setConstant( std::numeric_limits<double>::lowest() );
+            node.child.fill( -1 );
+            node.nPrimitives.fill( 0 );
+        }
+
+    static void setChild( Node& node, int k, BuildNode const& b, std::int32_t childNodeId )
+        {
+            node.childMin.col( k ) = b.boundMin;
+            node.childMax.col( k ) = b.boundMax;
+            if ( b.isLeaf() )
+            {
+                node.child[k] = b.first;
+                node.nPrimitives[k] = b.count;
+            }
+            else
+            {
+                node.child[k] = childNodeId;
+                node.nPrimitives[k] = 0;
+            }
+        }
+
+private:
+    Config M_config;
+    std::vector<Node,Eigen::aligned_allocator<Node>> M_nodes;
+    std::vector<std::int32_t> M_primitiveIds;
+    Eigen::Array<double,RealDim,Eigen::Dynamic> M_boxMin, M_boxMax, M_centers;
+};
+
+} // namespace Feel
+
+#endif /* FEELPP_MESH_WIDEBVH_HPP */
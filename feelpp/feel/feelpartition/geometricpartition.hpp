@@ -0,0 +1,367 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+
+  This file is part of the Feel++ library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3.0 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#ifndef FEELPP_PARTITION_GEOMETRICPARTITION_HPP
+#define FEELPP_PARTITION_GEOMETRICPARTITION_HPP 1
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <feel/feelcore/feel.hpp>
+#include <feel/feelmesh/morton.hpp>
+
+namespace Feel
+{
+/**
+ * geometric partitioning methods
+ * - Morton : split of the Z-order curve of the points
+ * - Hilbert : split of the Hilbert curve of the points
+ * - RCB : recursive coordinate bisection
+ */
+enum class GeometricPartitioning { Morton = 0, Hilbert = 1, RCB = 2 };
+
+inline GeometricPartitioning geometricPartitioningFromString( std::string const& s )
+{
+    if ( s == "morton" )
+        return GeometricPartitioning::Morton;
+    if ( s == "hilbert" )
+        return GeometricPartitioning::Hilbert;
+    if ( s == "rcb" )
+        return GeometricPartitioning::RCB;
+    CHECK( false ) << "invalid geometric partitioning " << s << ", should be morton, hilbert or rcb";
+    return GeometricPartitioning::Hilbert;
+}
+
+namespace detail
+{
+//! global bounding box of the points \p coords (stored by blocks of \p d values)
+inline void
+geometricPartitionBoundingBox( mpi::communicator const& comm, std::vector<double> const& coords, int d,
+                               std::array<double,3>& bmin, std::array<double,3>& bmax )
+{
+    std::array<double,3> bminLocal, bmaxLocal;
+    bminLocal.fill( std::numeric_limits<double>::max() );
+    bmaxLocal.fill( std::numeric_limits<double>::lowest() );
+    for ( std::size_t k = 0; k < coords.size()/d; ++k )
+    {
+        for ( int c = 0; c < d; ++c )
+        {
+            bminLocal[c] = std::min( bminLocal[c], coords[k*d+c] );
+            bmaxLocal[c] = std::max( bmaxLocal[c], coords[k*d+c] );
+        }
+    }
+    mpi::all_reduce( comm, bminLocal.data(), 3, bmin.data(), mpi::minimum<double>() );
+    mpi::all_reduce( comm, bmaxLocal.data(), 3, bmax.data(), mpi::maximum<double>() );
+}
+
+/**
+ * split the space filling curve : the keys are sorted locally and the \p nParts-1
+ * splitters are found together by a bisection of the key space, each step being a
+ * reduction of the weights below the current splitters. The splitters are exact
+ * up to the weight of the points sharing the same key.
+ */
+inline std::vector<rank_type>
+geometricPartitionCurve( mpi::communicator const& comm, std::vector<std::uint64_t> const& keys,
+                         std::vector<double> const& weights, rank_type nParts )
+{
+    const std::size_t n = keys.size();
+    std::vector<std::size_t> order( n );
+    std::iota( order.begin(), order.end(), 0 );
+    std::sort( order.begin(), order.end(), [&keys]( std::size_t a, std::size_t b ) { return keys[a] < keys[b]; } );
+    std::vector<std::uint64_t> sortedKeys( n );
+    std::vector<double> cumulatedWeights( n+1, 0. );
+    for ( std::size_t k = 0; k < n; ++k )
+    {
+        sortedKeys[k] = keys[order[k]];
+        cumulatedWeights[k+1] = cumulatedWeights[k] + ( weights.empty()? 1. : weights[order[k]] );
+    }
+    double totalWeight = 0.;
+    mpi::all_reduce( comm, cumulatedWeights[n], totalWeight, std::plus<double>() );
+
+    // invariant : weight(key < lo) < target <= weight(key < hi)
+    const rank_type nSplitters = nParts-1;
+    std::vector<std::uint64_t> lo( nSplitters, 0 ), hi( nSplitters, std::uint64_t(1) << 63 );
+    std::vector<std::uint64_t> mid( nSplitters );
+    std::vector<double> weightBelowLocal( nSplitters ), weightBelow( nSplitters );
+    for ( int it = 0; it < 64; ++it )
+    {
+        bool converged = true;
+        for ( rank_type p = 0; p < nSplitters; ++p )
+        {
+            mid[p] = lo[p] + ( hi[p] - lo[p] )/2;
+            converged = converged && ( hi[p] - lo[p] <= 1 );
+            auto pos = std::lower_bound( sortedKeys.begin(), sortedKeys.end(), mid[p] ) - sortedKeys.begin();
+            weightBelowLocal[p] = cumulatedWeights[pos];
+        }
+        if ( converged )
+            break;
+        mpi::all_reduce( comm, weightBelowLocal.data(), nSplitters, weightBelow.data(), std::plus<double>() );
+        for ( rank_type p = 0; p < nSplitters; ++p )
+        {
+            double target = ( totalWeight*(p+1) )/nParts;
+            if ( weightBelow[p] < target )
+                lo[p] = mid[p];
+            else
+                hi[p] = mid[p];
+        }
+    }
+
+    // a point goes to the part given by the number of splitters lower or equal to its key
+    std::vector<rank_type> parts( n );
+    for ( std::size_t k = 0; k < n; ++k )
+        parts[k] = std::upper_bound( hi.begin(), hi.end(), keys[k] ) - hi.begin();
+    return parts;
+}
+
+/**
+ * recursive coordinate bisection : all the groups of a level are bisected together,
+ * a group of parts [p0,p1) is cut orthogonally to the longest side of its bounding box
+ * and its weight is shared between its halves proportionally to their number of parts
+ */
+inline std::vector<rank_type>
+geometricPartitionRCB( mpi::communicator const& comm, std::vector<double> const& coords, int d,
+                       std::vector<double> const& weights, rank_type nParts )
+{
+    const std::size_t n = coords.size()/d;
+    // first part of the group of each point, the group of parts starting at p0 is [p0,groupEnd[p0])
+    std::vector<rank_type> parts( n, 0 );
+    std::vector<rank_type> groupEnd( nParts, invalid_rank_type_value );
+    groupEnd[0] = nParts;
+
+    // global index of the points, used to share the points aligned on a cut
+    std::uint64_t nGlobal = 0, offset = 0;
+    mpi::all_reduce( comm, std::uint64_t( n ), nGlobal, std::plus<std::uint64_t>() );
+    mpi::scan( comm, std::uint64_t( n ), offset, std::plus<std::uint64_t>() );
+    offset -= n;
+
+    std::vector<std::size_t> order( n );
+    std::vector<double> cumulatedWeights( n+1, 0. );
+    while ( true )
+    {
+        std::vector<rank_type> groups;
+        for ( rank_type p0 = 0; p0 < nParts; ++p0 )
+            if ( groupEnd[p0] != invalid_rank_type_value && groupEnd[p0] - p0 > 1 )
+                groups.push_back( p0 );
+        if ( groups.empty() )
+            break;
+        const std::size_t nGroups = groups.size();
+        std::vector<int> groupIndex( nParts, -1 );
+        for ( std::size_t g = 0; g < nGroups; ++g )
+            groupIndex[groups[g]] = g;
+
+        // bounding box and weight of each group, the maxima are reduced as minima of the opposite values
+        std::vector<double> boxLocal( 6*nGroups, std::numeric_limits<double>::max() ), box( 6*nGroups );
+        std::vector<double> groupWeightLocal( nGroups, 0. ), groupWeight( nGroups );
+        for ( std::size_t k = 0; k < n; ++k )
+        {
+            int g = groupIndex[parts[k]];
+            if ( g < 0 )
+                continue;
+            for ( int c = 0; c < d; ++c )
+            {
+                boxLocal[6*g+c] = std::min( boxLocal[6*g+c], coords[k*d+c] );
+                boxLocal[6*g+3+c] = std::min( boxLocal[6*g+3+c], -coords[k*d+c] );
+            }
+            groupWeightLocal[g] += weights.empty()? 1. : weights[k];
+        }
+        mpi::all_reduce( comm, boxLocal.data(), boxLocal.size(), box.data(), mpi::minimum<double>() );
+        mpi::all_reduce( comm, groupWeightLocal.data(), nGroups, groupWeight.data(), std::plus<double>() );
+
+        std::vector<int> axis( nGroups, 0 );
+        for ( std::size_t g = 0; g < nGroups; ++g )
+        {
+            double lenMax = -1.;
+            for ( int c = 0; c < d; ++c )
+            {
+                double len = -box[6*g+3+c] - box[6*g+c];
+                if ( len > lenMax )
+                {
+                    lenMax = len;
+                    axis[g] = c;
+                }
+            }
+        }
+
+        // sort the points by group then by coordinate along the cutting axis of the group
+        std::vector<std::size_t> groupStart( nGroups+1, 0 );
+        order.clear();
+        for ( std::size_t k = 0; k < n; ++k )
+            if ( groupIndex[parts[k]] >= 0 )
+                order.push_back( k );
+        auto coordAxis = [&]( std::size_t k ) { return coords[k*d+axis[groupIndex[parts[k]]]]; };
+        std::sort( order.begin(), order.end(), [&]( std::size_t a, std::size_t b ) {
+                int ga = groupIndex[parts[a]], gb = groupIndex[parts[b]];
+                if ( ga != gb )
+                    return ga < gb;
+                return ( coordAxis( a ) < coordAxis( b ) ) || ( coordAxis( a ) == coordAxis( b ) && a < b );
+            } );
+        for ( std::size_t i = 0; i < order.size(); ++i )
+        {
+            groupStart[groupIndex[parts[order[i]]]+1] = i+1;
+            cumulatedWeights[i+1] = cumulatedWeights[i] + ( weights.empty()? 1. : weights[order[i]] );
+        }
+        for ( std::size_t g = 0; g < nGroups; ++g )
+            groupStart[g+1] = std::max( groupStart[g+1], groupStart[g] );
+
+        // bisection of the cut coordinate, invariant : weight(x < lo) < target <= weight(x < hi)
+        std::vector<double> lo( nGroups ), hi( nGroups ), mid( nGroups ), target( nGroups );
+        for ( std::size_t g = 0; g < nGroups; ++g )
+        {
+            rank_type p0 = groups[g];
+            rank_type nLeft = ( groupEnd[p0] - p0 )/2;
+            target[g] = groupWeight[g]*nLeft/( groupEnd[p0] - p0 );
+            lo[g] = box[6*g+axis[g]];
+            hi[g] = std::nextafter( -box[6*g+3+axis[g]], std::numeric_limits<double>::max() );
+        }
+        std::vector<double> weightBelowLocal( nGroups ), weightBelow( nGroups );
+        for ( int it = 0; it < 64; ++it )
+        {
+            for ( std::size_t g = 0; g < nGroups; ++g )
+            {
+                mid[g] = lo[g] + 0.5*( hi[g] - lo[g] );
+                auto first = order.begin() + groupStart[g];
+                auto last = order.begin() + groupStart[g+1];
+                auto pos = std::lower_bound( first, last, mid[g], [&]( std::size_t k, double v ) { return coordAxis( k ) < v; } );
+                weightBelowLocal[g] = cumulatedWeights[pos-order.begin()] - cumulatedWeights[groupStart[g]];
+            }
+            mpi::all_reduce( comm, weightBelowLocal.data(), nGroups, weightBelow.data(), std::plus<double>() );
+            bool converged = true;
+            for ( std::size_t g = 0; g < nGroups; ++g )
+            {
+                if ( mid[g] <= lo[g] || mid[g] >= hi[g] )
+                    continue;
+                converged = false;
+                if ( weightBelow[g] < target[g] )
+                    lo[g] = mid[g];
+                else
+                    hi[g] = mid[g];
+            }
+            if ( converged )
+                break;
+        }
+
+        // the points at the cut, lo <= x < hi, are shared between the halves by their global index,
+        // invariant : weight(x < lo or (x < hi and index < slo)) < target <= same with shi
+        std::vector<std::size_t> tiedStart( nGroups ), tiedEnd( nGroups );
+        for ( std::size_t g = 0; g < nGroups; ++g )
+        {
+            auto first = order.begin() + groupStart[g];
+            auto last = order.begin() + groupStart[g+1];
+            auto comp = [&]( std::size_t k, double v ) { return coordAxis( k ) < v; };
+            tiedStart[g] = std::lower_bound( first, last, lo[g], comp ) - order.begin();
+            tiedEnd[g] = std::lower_bound( first, last, hi[g], comp ) - order.begin();
+            std::sort( order.begin()+tiedStart[g], order.begin()+tiedEnd[g] );
+            for ( std::size_t i = tiedStart[g]; i < tiedEnd[g]; ++i )
+                cumulatedWeights[i+1] = cumulatedWeights[i] + ( weights.empty()? 1. : weights[order[i]] );
+        }
+        std::vector<std::uint64_t> slo( nGroups, 0 ), shi( nGroups, nGlobal ), smid( nGroups );
+        for ( int it = 0; it < 65; ++it )
+        {
+            bool converged = true;
+            for ( std::size_t g = 0; g < nGroups; ++g )
+            {
+                smid[g] = slo[g] + ( shi[g] - slo[g] )/2;
+                converged = converged && ( shi[g] - slo[g] <= 1 || groupWeight[g] <= 0 );
+                auto pos = std::lower_bound( order.begin()+tiedStart[g], order.begin()+tiedEnd[g], smid[g],
+                                             [offset]( std::size_t k, std::uint64_t s ) { return offset + k < s; } );
+                weightBelowLocal[g] = cumulatedWeights[pos-order.begin()] - cumulatedWeights[groupStart[g]];
+            }
+            if ( converged )
+                break;
+            mpi::all_reduce( comm, weightBelowLocal.data(), nGroups, weightBelow.data(), std::plus<double>() );
+            for ( std::size_t g = 0; g < nGroups; ++g )
+            {
+                if ( shi[g] - slo[g] <= 1 )
+                    continue;
+                if ( weightBelow[g] < target[g] )
+                    slo[g] = smid[g];
+                else
+                    shi[g] = smid[g];
+            }
+        }
+
+        // the points below the cut stay in the left half, the others go to the right half
+        std::vector<rank_type> rightStart( nGroups );
+        for ( std::size_t g = 0; g < nGroups; ++g )
+        {
+            rank_type p0 = groups[g];
+            rank_type p1 = groupEnd[p0];
+            rightStart[g] = p0 + ( p1 - p0 )/2;
+            groupEnd[p0] = rightStart[g];
+            groupEnd[rightStart[g]] = p1;
+        }
+        for ( std::size_t k = 0; k < n; ++k )
+        {
+            int g = groupIndex[parts[k]];
+            if ( g < 0 )
+                continue;
+            double x = coordAxis( k );
+            if ( x >= hi[g] || ( x >= lo[g] && offset + k >= shi[g] ) )
+                parts[k] = rightStart[g];
+        }
+    }
+    return parts;
+}
+} // namespace detail
+
+/**
+ * partition of points distributed on the processes of \p comm in \p nParts parts
+ * balanced with respect to the \p weights (1 by default), this is a collective operation
+ *
+ * @param comm communicator of the processes owning the points
+ * @param coords coordinates of the local points stored by blocks of \p d values
+ * @param d dimension of the points (<=3)
+ * @param nParts number of parts
+ * @param method geometric partitioning method
+ * @param weights weights of the local points, empty for unit weights
+ * @return the part of each local point
+ */
+inline std::vector<rank_type>
+geometricPartition( mpi::communicator const& comm, std::vector<double> const& coords, int d, rank_type nParts,
+                    GeometricPartitioning method = GeometricPartitioning::Hilbert,
+                    std::vector<double> const& weights = std::vector<double>() )
+{
+    CHECK( d >= 1 && d <= 3 ) << "invalid dimension " << d;
+    CHECK( nParts > 0 ) << "invalid number of parts " << nParts;
+    CHECK( weights.empty() || weights.size()*d == coords.size() ) << "invalid number of weights " << weights.size();
+    if ( nParts == 1 )
+        return std::vector<rank_type>( coords.size()/d, 0 );
+
+    if ( method == GeometricPartitioning::RCB )
+        return detail::geometricPartitionRCB( comm, coords, d, weights, nParts );
+
+    std::array<double,3> bmin, bmax;
+    detail::geometricPartitionBoundingBox( comm, coords, d, bmin, bmax );
+    std::vector<std::uint64_t> keys( coords.size()/d );
+    for ( std::size_t k = 0; k < keys.size(); ++k )
+        keys[k] = ( method == GeometricPartitioning::Hilbert )?
+            Feel::detail::hilbertKey( coords.data()+k*d, bmin, bmax, d ) :
+            Feel::detail::mortonKey( coords.data()+k*d, bmin, bmax, d );
+    return detail::geometricPartitionCurve( comm, keys, weights, nParts );
+}
+
+} // namespace Feel
+
+#endif /* FEELPP_PARTITION_GEOMETRICPARTITION_HPP */
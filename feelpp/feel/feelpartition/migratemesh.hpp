@@ -0,0 +1,404 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*-
+
+ This file is part of the Feel++ library
+
+ Copyright (C) 2023 Feel++ Consortium
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef FEELPP_MIGRATEMESH_HPP
+#define FEELPP_MIGRATEMESH_HPP 1
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include <feel/feeldiscr/mesh.hpp>
+
+namespace Feel {
+
+namespace detail
+{
+//! append the marker of \p entity to \p data : (number of flags, flag1, flag2, ...)
+template<typename EntityType>
+void
+migrateMeshAppendMarker( std::vector<size_type>& data, EntityType const& entity )
+{
+    if ( !entity.hasMarker() )
+    {
+        data.push_back( 0 );
+        return;
+    }
+    auto const& marker = entity.marker();
+    data.push_back( marker.size() );
+    data.insert( data.end(), marker.begin(), marker.end() );
+}
+
+//! read a marker from \p it and move \p it after it
+template<typename MarkerType, typename IteratorType>
+MarkerType
+migrateMeshReadMarker( IteratorType& it )
+{
+    MarkerType marker;
+    size_type nFlags = *it++;
+    for ( size_type i = 0; i < nFlags; ++i )
+        marker.insert( *it++ );
+    return marker;
+}
+} // namespace detail
+
+/**
+ * migrate the active elements of the distributed mesh \p mesh to the process
+ * given by \p parts (in the order of \c elements(mesh), see
+ * \c PartitionerGeometric::partitionIds), this is a collective operation on
+ * the mesh communicator.
+ *
+ * The elements are sent with their markers, the coordinates of their points
+ * and their marked faces, edges and points. The new mesh is built on the same
+ * communicator with one part per process and a layer of ghost elements (the
+ * elements sharing a point with the part), the processes sharing a point being
+ * found with a directory of the points distributed by point id, like in the
+ * repartitioned reading of \c PartitionIO. The point ids of \p mesh must be
+ * global.
+ *
+ * @param mesh distributed mesh
+ * @param parts new process of the active elements of this process
+ * @param ctxMeshUpdate components of the mesh update of the new mesh
+ * @return the new mesh, ready to be wrapped in a \c MeshPartitionSet and
+ *         written with \c PartitionIO
+ */
+template<typename MeshType>
+std::shared_ptr<MeshType>
+migrateMesh( std::shared_ptr<MeshType> const& mesh, std::vector<rank_type> const& parts,
+             size_type ctxMeshUpdate = MESH_UPDATE_EDGES|MESH_UPDATE_FACES )
+{
+    using mesh_type = MeshType;
+    using node_type = typename mesh_type::node_type;
+    using point_type = typename mesh_type::point_type;
+    using edge_type = typename mesh_type::edge_type;
+    using face_type = typename mesh_type::face_type;
+    using element_type = typename mesh_type::element_type;
+    using marker_type = typename element_type::marker_type;
+
+    auto const& theWorldComm = mesh->worldComm();
+    auto const& comm = theWorldComm.localComm();
+    const rank_type rank = theWorldComm.localRank();
+    const rank_type nProc = theWorldComm.localSize();
+    const int d = mesh_type::nRealDim;
+    const int nPtsElt = element_type::numPoints;
+    // process storing a point in the distributed directory
+    auto directoryProcess = [nProc]( size_type ptId ) -> rank_type { return ptId % nProc; };
+    // number of points of the marked sub entities : faces, edges and points
+    std::array<int,3> nPtsSubEntity = { 1, 1, 1 };
+    if constexpr ( mesh_type::nDim >= 2 )
+        nPtsSubEntity[0] = face_type::numPoints;
+    if constexpr ( mesh_type::nDim == 3 )
+        nPtsSubEntity[1] = edge_type::numPoints;
+
+    LOG(INFO) << "migrateMesh starts...";
+    tic();
+    auto rangeElements = elements( mesh );
+    CHECK( parts.size() == nelements( rangeElements ) ) << "invalid number of parts " << parts.size()
+                                                         << ", should be the number of active elements " << nelements( rangeElements );
+
+    // an element is sent as (marker, point ids, number of marked sub entities, sub entities...)
+    // where a sub entity is (kind, marker, point ids), kind being 0 for a face, 1 for an edge and 2 for a point
+    std::vector<std::vector<size_type>> eltsToSend( nProc ), eltsRecv;
+    std::vector<std::vector<double>> coordsToSend( nProc ), coordsRecv;
+    std::vector<size_type> subEntities;
+    size_type k = 0;
+    for ( auto const& eltWrap : rangeElements )
+    {
+        auto const& elt = unwrap_ref( eltWrap );
+        rank_type newPid = parts[k++];
+        CHECK( newPid < nProc ) << "invalid part " << newPid << ", should be lower than the number of processes " << nProc;
+
+        subEntities.clear();
+        size_type nSubEntities = 0;
+        if constexpr ( mesh_type::nDim >= 2 )
+        {
+            for ( uint16_type f = 0; f < element_type::numTopologicalFaces; ++f )
+            {
+                auto const* face = elt.facePtr( f );
+                if ( !face || !face->hasMarker() )
+                    continue;
+                subEntities.push_back( 0 );
+                Feel::detail::migrateMeshAppendMarker( subEntities, *face );
+                for ( uint16_type i = 0; i < face_type::numPoints; ++i )
+                    subEntities.push_back( face->point( i ).id() );
+                ++nSubEntities;
+            }
+        }
+        if constexpr ( mesh_type::nDim == 3 )
+        {
+            for ( uint16_type e = 0; e < element_type::numEdges; ++e )
+            {
+                auto const* edge = elt.edgePtr( e );
+                if ( !edge || !edge->hasMarker() )
+                    continue;
+                subEntities.push_back( 1 );
+                Feel::detail::migrateMeshAppendMarker( subEntities, *edge );
+                for ( uint16_type i = 0; i < edge_type::numPoints; ++i )
+                    subEntities.push_back( edge->point( i ).id() );
+                ++nSubEntities;
+            }
+        }
+        for ( uint16_type i = 0; i < nPtsElt; ++i )
+        {
+            auto const& pt = elt.point( i );
+            if ( !pt.hasMarker() )
+                continue;
+            subEntities.push_back( 2 );
+            Feel::detail::migrateMeshAppendMarker( subEntities, pt );
+            subEntities.push_back( pt.id() );
+            ++nSubEntities;
+        }
+
+        auto & data = eltsToSend[newPid];
+        Feel::detail::migrateMeshAppendMarker( data, elt );
+        for ( uint16_type i = 0; i < nPtsElt; ++i )
+            data.push_back( elt.point( i ).id() );
+        data.push_back( nSubEntities );
+        data.insert( data.end(), subEntities.begin(), subEntities.end() );
+        for ( uint16_type i = 0; i < nPtsElt; ++i )
+            for ( int c = 0; c < d; ++c )
+                coordsToSend[newPid].push_back( elt.point( i )[c] );
+    }
+    mpi::all_to_all( comm, eltsToSend, eltsRecv );
+    mpi::all_to_all( comm, coordsToSend, coordsRecv );
+    toc("migrateMesh sending active elements",FLAGS_v>0);
+
+    tic();
+    auto newMesh = std::make_shared<mesh_type>( mesh->worldCommPtr() );
+    newMesh->setMarkerNames( mesh->markerNames() );
+    newMesh->setNumberOfPartitions( nProc );
+
+    // marked sub entities, the duplicates coming from several elements are removed
+    std::array<std::vector<size_type>,3> subEntitiesBuffer;
+    std::set<std::vector<size_type>> subEntitiesAdded;
+    std::vector<size_type> subEntityKey;
+
+    node_type coords( d );
+    // add an element from its data and return the position after the data
+    auto addElementFromData = [&]( std::vector<size_type>::const_iterator it, double const* eltCoords, rank_type pid, size_type& eid )
+        {
+            marker_type marker = Feel::detail::migrateMeshReadMarker<marker_type>( it );
+            for ( int i = 0; i < nPtsElt; ++i )
+            {
+                size_type ptId = *(it+i);
+                if ( newMesh->hasPoint( ptId ) )
+                    continue;
+                for ( int c = 0; c < d; ++c )
+                    coords[c] = eltCoords[i*d+c];
+                point_type pt( ptId, coords, false/*onbdy*/ );
+                pt.setProcessIdInPartition( rank );
+                newMesh->addPoint( pt );
+            }
+            element_type e;
+            e.setProcessIdInPartition( rank );
+            if ( !marker.empty() )
+                e.setMarker( marker );
+            e.setProcessId( pid );
+            for ( uint16_type i = 0; i < element_type::numPoints; ++i )
+                e.setPoint( i, newMesh->point( *it++ ) );
+            auto [eit,inserted] = newMesh->addElement( e, true );
+            eid = eit->first;
+
+            size_type nSubEntities = *it++;
+            for ( size_type j = 0; j < nSubEntities; ++j )
+            {
+                auto itStart = it;
+                int kind = *it++;
+                size_type nFlags = *it++;
+                it += nFlags;
+                subEntityKey.assign( it, it + nPtsSubEntity[kind] );
+                it += nPtsSubEntity[kind];
+                std::sort( subEntityKey.begin(), subEntityKey.end() );
+                subEntityKey.push_back( kind );
+                if ( subEntitiesAdded.insert( subEntityKey ).second )
+                    subEntitiesBuffer[kind].insert( subEntitiesBuffer[kind].end(), itStart+1, it );
+            }
+            return it;
+        };
+
+    // active elements, their data is kept to be sent to the processes where they are ghost elements
+    std::vector<size_type> activeEltsData;
+    std::vector<double> activeEltsCoords;
+    std::vector<size_type> activeEltsDataStart, activeEltsIds;
+    for ( rank_type p = 0; p < nProc; ++p )
+    {
+        activeEltsData.insert( activeEltsData.end(), eltsRecv[p].begin(), eltsRecv[p].end() );
+        activeEltsCoords.insert( activeEltsCoords.end(), coordsRecv[p].begin(), coordsRecv[p].end() );
+        eltsRecv[p].clear();
+        coordsRecv[p].clear();
+    }
+    std::unordered_set<size_type> activePointIds;
+    for ( auto it = activeEltsData.cbegin(); it != activeEltsData.cend(); )
+    {
+        size_type eid = invalid_v<size_type>;
+        activeEltsDataStart.push_back( it - activeEltsData.cbegin() );
+        it = addElementFromData( it, activeEltsCoords.data() + activeEltsIds.size()*nPtsElt*d, rank, eid );
+        activeEltsIds.push_back( eid );
+        auto const& elt = newMesh->element( eid );
+        for ( uint16_type i = 0; i < nPtsElt; ++i )
+            activePointIds.insert( elt.point( i ).id() );
+    }
+    activeEltsDataStart.push_back( activeEltsData.size() );
+    const size_type nActiveElts = activeEltsIds.size();
+
+    // register the points of the active elements in the directory to find the processes sharing them
+    std::vector<std::vector<size_type>> idsToSend( nProc ), idsRecv;
+    for ( size_type ptId : activePointIds )
+        idsToSend[directoryProcess( ptId )].push_back( ptId );
+    mpi::all_to_all( comm, idsToSend, idsRecv );
+    std::unordered_map<size_type,std::vector<rank_type>> pointIdToProcess;
+    for ( rank_type p = 0; p < nProc; ++p )
+        for ( size_type ptId : idsRecv[p] )
+            pointIdToProcess[ptId].push_back( p );
+
+    // send to each process the processes sharing its points : (ptId,nProcess,pid1,pid2,...)
+    for ( auto & ids : idsToSend )
+        ids.clear();
+    for ( auto const& [ptId,pids] : pointIdToProcess )
+    {
+        if ( pids.size() < 2 )
+            continue;
+        for ( rank_type p : pids )
+        {
+            idsToSend[p].push_back( ptId );
+            idsToSend[p].push_back( pids.size() );
+            idsToSend[p].insert( idsToSend[p].end(), pids.begin(), pids.end() );
+        }
+    }
+    pointIdToProcess.clear();
+    mpi::all_to_all( comm, idsToSend, idsRecv );
+    std::unordered_map<size_type,std::vector<rank_type>> pointIdToNeighborProcess;
+    for ( rank_type p = 0; p < nProc; ++p )
+    {
+        for ( auto it = idsRecv[p].begin(); it != idsRecv[p].end(); )
+        {
+            size_type ptId = *it++;
+            size_type nPid = *it++;
+            auto & neighbors = pointIdToNeighborProcess[ptId];
+            for ( size_type i = 0; i < nPid; ++i, ++it )
+                if ( *it != rank )
+                    neighbors.push_back( *it );
+        }
+    }
+
+    // ghost elements : the active elements touching a point shared with another process are sent
+    // to this process with their id, the active element is then ghost in this process
+    for ( rank_type p = 0; p < nProc; ++p )
+    {
+        eltsToSend[p].clear();
+        coordsToSend[p].clear();
+    }
+    std::set<rank_type> neighborPids;
+    for ( size_type j = 0; j < nActiveElts; ++j )
+    {
+        auto & elt = newMesh->elementIterator( activeEltsIds[j] )->second;
+        neighborPids.clear();
+        for ( uint16_type i = 0; i < nPtsElt; ++i )
+        {
+            auto itFindNeighbors = pointIdToNeighborProcess.find( elt.point( i ).id() );
+            if ( itFindNeighbors != pointIdToNeighborProcess.end() )
+                neighborPids.insert( itFindNeighbors->second.begin(), itFindNeighbors->second.end() );
+        }
+        for ( rank_type p : neighborPids )
+        {
+            elt.addNeighborPartitionId( p );
+            eltsToSend[p].push_back( activeEltsIds[j] );
+            eltsToSend[p].insert( eltsToSend[p].end(), activeEltsData.begin()+activeEltsDataStart[j], activeEltsData.begin()+activeEltsDataStart[j+1] );
+            coordsToSend[p].insert( coordsToSend[p].end(), activeEltsCoords.begin()+j*nPtsElt*d, activeEltsCoords.begin()+(j+1)*nPtsElt*d );
+        }
+    }
+    activeEltsData.clear();
+    activeEltsCoords.clear();
+    mpi::all_to_all( comm, eltsToSend, eltsRecv );
+    mpi::all_to_all( comm, coordsToSend, coordsRecv );
+    for ( rank_type p = 0; p < nProc; ++p )
+    {
+        size_type nGhostElts = 0;
+        for ( auto it = eltsRecv[p].cbegin(); it != eltsRecv[p].cend(); ++nGhostElts )
+        {
+            size_type idInActivePart = *it++;
+            size_type eid = invalid_v<size_type>;
+            it = addElementFromData( it, coordsRecv[p].data() + nGhostElts*nPtsElt*d, p, eid );
+            auto & ghostElt = newMesh->elementIterator( eid )->second;
+            ghostElt.addNeighborPartitionId( rank );
+            ghostElt.setIdInOtherPartitions( p, idInActivePart );
+        }
+    }
+
+    // the points of the active elements belong to this process, the ones only in ghost elements are not set
+    auto rangeGhostElements = newMesh->ghostElements();
+    for ( auto it = std::get<0>( rangeGhostElements ), en = std::get<1>( rangeGhostElements ); it != en; ++it )
+    {
+        auto const& ghostElt = unwrap_ref( *it );
+        for ( uint16_type i = 0; i < nPtsElt; ++i )
+        {
+            size_type ptId = ghostElt.point( i ).id();
+            if ( activePointIds.find( ptId ) == activePointIds.end() )
+                newMesh->pointIterator( ptId )->second.setProcessId( invalid_rank_type_value );
+        }
+    }
+    for ( size_type ptId : activePointIds )
+        newMesh->pointIterator( ptId )->second.setProcessId( rank );
+    toc("migrateMesh building ghost elements",FLAGS_v>0);
+
+    // marked sub entities
+    if constexpr ( mesh_type::nDim >= 2 )
+    {
+        face_type newFace;
+        for ( auto it = subEntitiesBuffer[0].cbegin(); it != subEntitiesBuffer[0].cend(); )
+        {
+            newFace.setId( newMesh->numFaces() );
+            newFace.setProcessIdInPartition( rank );
+            newFace.setMarker( Feel::detail::migrateMeshReadMarker<marker_type>( it ) );
+            for ( uint16_type i = 0; i < face_type::numPoints ; ++i )
+                newFace.setPoint( i, newMesh->point( *it++ ) );
+            newMesh->addFace( newFace );
+        }
+    }
+    if constexpr ( mesh_type::nDim == 3 )
+    {
+        edge_type newEdge;
+        for ( auto it = subEntitiesBuffer[1].cbegin(); it != subEntitiesBuffer[1].cend(); )
+        {
+            newEdge.setId( newMesh->numEdges() );
+            newEdge.setProcessIdInPartition( rank );
+            newEdge.setMarker( Feel::detail::migrateMeshReadMarker<marker_type>( it ) );
+            for ( uint16_type i = 0; i < edge_type::numPoints ; ++i )
+                newEdge.setPoint( i, newMesh->point( *it++ ) );
+            newMesh->addEdge( newEdge );
+        }
+    }
+    for ( auto it = subEntitiesBuffer[2].cbegin(); it != subEntitiesBuffer[2].cend(); )
+    {
+        marker_type marker = Feel::detail::migrateMeshReadMarker<marker_type>( it );
+        newMesh->pointIterator( *it++ )->second.setMarker( marker );
+    }
+
+    tic();
+    newMesh->components().reset();
+    newMesh->components().set( ctxMeshUpdate );
+    newMesh->updateForUse();
+    toc("migrateMesh mesh update for use",FLAGS_v>0);
+    LOG(INFO) << "migrateMesh done";
+    return newMesh;
+}
+
+} // Feel
+
+#endif
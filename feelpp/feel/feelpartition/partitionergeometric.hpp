@@ -0,0 +1,122 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*-
+
+ This file is part of the Feel++ library
+
+ Copyright (C) 2023 Feel++ Consortium
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef FEELPP_PARTITIONERGEOMETRIC_HPP
+#define FEELPP_PARTITIONERGEOMETRIC_HPP 1
+
+#include <feel/feelpartition/partitioner.hpp>
+#include <feel/feelpartition/geometricpartition.hpp>
+
+
+namespace Feel {
+
+/**
+ * @brief geometric partitioner
+ *
+ * The elements are partitioned from their barycenters, either by splitting a
+ * space filling curve (Hilbert or Morton) or by recursive coordinate
+ * bisection. Contrary to \c PartitionerMetis, the computation is distributed
+ * on the processes of the mesh communicator : each process only handles the
+ * elements it owns and the parts are found with reductions, so that the mesh
+ * never has to be gathered on one process. The elements can then be sent to
+ * their new process with \c migrateMesh.
+ *
+ * The method can be given in the json configuration : { "partitioner": { "method": "hilbert" } }
+ */
+template<typename MeshType>
+class PartitionerGeometric : public Partitioner<MeshType>
+{
+public:
+    using super = Partitioner<MeshType>;
+    using mesh_type = typename super::mesh_type;
+    using mesh_ptrtype = typename super::mesh_ptrtype;
+    using clone_ptrtype = typename super::clone_ptrtype;
+    using element_type = typename super::element_type;
+    using range_element_type = typename super::range_element_type;
+
+    /**
+     * Constructor.
+     */
+    explicit PartitionerGeometric( GeometricPartitioning method = GeometricPartitioning::Hilbert )
+        : M_method( method ) {}
+
+    /**
+     * @brief Construct a new geometric partitioner object
+     *
+     * @param j json data
+     */
+    PartitionerGeometric( json const& j )
+        : super( j ),
+          M_method( ( j.contains( "partitioner" ) && j["partitioner"].contains( "method" ) )?
+                    geometricPartitioningFromString( j["partitioner"]["method"].template get<std::string>() ) :
+                    GeometricPartitioning::Hilbert )
+        {}
+
+    /**
+     * Creates a new partitioner of this type
+     */
+    clone_ptrtype clone () const override
+        {
+            return std::make_unique<PartitionerGeometric<mesh_type>>( M_method );
+        }
+
+    /**
+     * the weights are indexed by the element ids
+     */
+    void attachWeights( std::vector<double> const& weights) override
+        { this->M_weights = weights; }
+
+    GeometricPartitioning method() const { return M_method; }
+    void setMethod( GeometricPartitioning method ) { M_method = method; }
+
+    /**
+     * compute the part in [0,n) of the elements of \p range, this is a
+     * collective operation on the mesh communicator and each element must be
+     * in the range of only one process (the active elements for example)
+     *
+     * @return the part of each element of \p range, in the order of the range
+     */
+    std::vector<rank_type> partitionIds( mesh_ptrtype const& mesh, rank_type n, range_element_type const& range ) const;
+
+    /**
+     * compute the part in [0,n) of the active elements of the process
+     */
+    std::vector<rank_type> partitionIds( mesh_ptrtype const& mesh, rank_type n ) const
+        {
+            return this->partitionIds( mesh, n, elements( mesh ) );
+        }
+
+protected:
+    /**
+     * Partition the \p MeshBase<> into \p n subdomains.
+     */
+    void partitionImpl ( mesh_ptrtype mesh, rank_type n, std::vector<range_element_type> const& partitionByRange ) override;
+
+private :
+    GeometricPartitioning M_method;
+};
+
+
+} // Feel
+
+#include <feel/feelpartition/partitionergeometric_impl.hpp>
+
+
+#endif
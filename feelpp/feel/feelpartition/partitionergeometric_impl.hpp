@@ -0,0 +1,92 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*-
+
+ This file is part of the Feel++ library
+
+ Copyright (C) 2023 Feel++ Consortium
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+#ifndef FEELPP_PARTITIONERGEOMETRIC_IMPL_HPP
+#define FEELPP_PARTITIONERGEOMETRIC_IMPL_HPP 1
+
+#include <feel/feelpartition/partitionergeometric.hpp>
+
+namespace Feel {
+
+template<typename MeshType>
+std::vector<rank_type>
+PartitionerGeometric<MeshType>::partitionIds( mesh_ptrtype const& mesh, rank_type n, range_element_type const& range ) const
+{
+    CHECK( n != invalid_rank_type_value && n > 0 ) << "Invalid number of partitions : " << n;
+
+    const int d = mesh_type::nRealDim;
+    const size_type nElts = nelements( range );
+    std::vector<double> barycenters;
+    barycenters.reserve( d*nElts );
+    std::vector<double> weights;
+    if ( !this->M_weights.empty() )
+        weights.reserve( nElts );
+    for ( auto const& eltWrap : range )
+    {
+        auto const& elt = unwrap_ref( eltWrap );
+        auto bary = elt.barycenter();
+        for ( int c = 0; c < d; ++c )
+            barycenters.push_back( bary[c] );
+        if ( !this->M_weights.empty() )
+        {
+            CHECK( elt.id() < this->M_weights.size() ) << "no weight for the element " << elt.id();
+            weights.push_back( this->M_weights[elt.id()] );
+        }
+    }
+    return geometricPartition( mesh->worldComm().localComm(), barycenters, d, n, M_method, weights );
+}
+
+template<typename MeshType>
+void
+PartitionerGeometric<MeshType>::partitionImpl( mesh_ptrtype mesh, rank_type np, std::vector<range_element_type> const& partitionByRange )
+{
+    LOG(INFO) << "PartitionerGeometric::partitionImpl starts...";
+    tic();
+
+    // Check for an easy return
+    if (np == 1)
+    {
+        this->singlePartition (mesh);
+        return;
+    }
+
+    // the elements are all on this process (see migrateMesh for a distributed mesh)
+    std::vector<range_element_type> ranges = partitionByRange;
+    if ( ranges.empty() )
+        ranges.push_back( allelements( mesh ) );
+
+    for ( auto const& rangeMeshElt : ranges )
+    {
+        auto parts = this->partitionIds( mesh, np, rangeMeshElt );
+        size_type k = 0;
+        for ( auto const& eltWrap : rangeMeshElt )
+        {
+            auto & eltToUpdate = mesh->elementIterator( unwrap_ref( eltWrap ).id() )->second;
+            eltToUpdate.setProcessId( parts[k++] );
+        }
+    }
+
+    auto t = toc("PartitionerGeometric::partitionImpl", FLAGS_v > 0 );
+    LOG(INFO) << "PartitionerGeometric::partitionImpl done in " << t << "s";
+}
+
+} // Feel
+
+#endif
@@ -75,11 +75,12 @@ public :
         return timer_type::time();
     }
 
+    //! one stack per thread (the exporters may save in a background thread)
     std::stack<type>& times() const
     {
+        thread_local std::stack<type> localStack;
         return localStack;
     }
-    mutable std::stack<type> localStack;
 };
 }
 
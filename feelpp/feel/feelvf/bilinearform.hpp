@@ -832,6 +832,16 @@ public:
 
         void assembleInCaseOfInterpolate();
 
+        /**
+         * insert the element matrices with BilinearForm::addMatrixConcurrent
+         * (without lock) and keep in \p buffer the rows which can not be added
+         * in place, null restores the insertion with BilinearForm::addMatrix
+         */
+        void setConcurrentInsertionBuffer( ConcurrentInsertionBuffer<value_type>* buffer )
+        {
+            M_concurrentInsertionBuffer = buffer;
+        }
+
 
         /**
          * precompute the basis function associated with the test and
@@ -1009,12 +1019,27 @@ public:
         void integrateInCaseOfInterpolate( mpl::int_<1>,
                                            std::vector<boost::tuple<index_type,index_type> > const& indexLocalToQuad,
                                            bool isFirstExperience );
+    private:
+
+        void addElementMatrix( int* rows, int nrows,
+                               int* cols, int ncols,
+                               value_type* data,
+                               size_type K,
+                               size_type K2 = invalid_v<size_type> )
+        {
+            if ( M_concurrentInsertionBuffer )
+                M_form.addMatrixConcurrent( rows, nrows, cols, ncols, data, *M_concurrentInsertionBuffer );
+            else
+                M_form.addMatrix( rows, nrows, cols, ncols, data, K, K2 );
+        }
+
     private:
 
         form_type& M_form;
         const list_block_type& M_lb;
         dof_1_type* M_test_dof;
         dof_2_type* M_trial_dof;
+        ConcurrentInsertionBuffer<value_type>* M_concurrentInsertionBuffer = nullptr;
 
         test_precompute_ptrtype M_test_pc;
         std::map<uint16_type, std::map<permutation_1_type,test_precompute_ptrtype> > M_test_pc_face;
@@ -406,6 +406,40 @@ public:
                     size_type K  = 0,
                     size_type K2 = invalid_v<size_type> );
 
+    /**
+     * prepare the concurrent insertion of the element matrices, see
+     * MatrixSparse::beginConcurrentInsertion()
+     */
+    bool beginConcurrentInsertion()
+    {
+        return M_matrix->beginConcurrentInsertion();
+    }
+
+    /**
+     * add the element matrix without lock, the rows which can not be added
+     * in place are kept in the thread buffer \p buffer
+     */
+    void addMatrixConcurrent( int* rows, int nrows,
+                              int* cols, int ncols,
+                              value_type* data,
+                              ConcurrentInsertionBuffer<value_type>& buffer )
+    {
+        M_matrix->addMatrixConcurrent( rows, nrows, cols, ncols, data, buffer );
+    }
+
+    //! end the concurrent insertion
+    void endConcurrentInsertion()
+    {
+        M_matrix->endConcurrentInsertion();
+    }
+
+    //! add the rows kept in \p buffer in the matrix and clear it
+    void addConcurrentInsertionBuffer( ConcurrentInsertionBuffer<value_type>& buffer )
+    {
+        std::lock_guard<std::mutex> guard( b_mutex );
+        M_matrix->addConcurrentInsertionBuffer( buffer );
+    }
+
 
     /**
      * set value \p v at position (\p i, \p j) of the matrix
@@ -142,6 +142,25 @@ void ginacBuildLibrary( GiNaC::lst const& exprs, GiNaC::lst const& syml, std::st
     }
 }
 
+FEELPP_EXPORT std::shared_ptr<GinacTape>
+ginacBuildTape( GiNaC::lst const& exprs, GiNaC::lst const& syml, std::string const& exprDesc )
+{
+    if ( boption( _name="ginac.compile" ) )
+        return {};
+    try
+    {
+        auto tape = std::make_shared<GinacTape>( exprs, syml );
+        DVLOG( 2 ) << "GinacTape for " << exprDesc << " : " << tape->nInstructions() << " instructions, "
+                   << tape->nRegisters() << " registers\n";
+        return tape;
+    }
+    catch ( std::invalid_argument const& e )
+    {
+        VLOG( 1 ) << "GinacTape not available for " << exprDesc << " (" << e.what() << "), use GiNaC::compile_ex\n";
+        return {};
+    }
+}
+
 FEELPP_EXPORT std::string
 ginacGetDefaultFileName( std::string const& exprDesc, std::string const& dirLibExpr )
 {
@@ -47,6 +47,7 @@ extern template GiNaC::registered_class_info GiNaC::container<std::vector>::reg_
 
 #include <feel/feelcore/singleton.hpp>
 #include <feel/feelcore/worldcomm.hpp>
+#include <feel/feelvf/detail/ginactape.hpp>
 
 namespace Feel
 {
@@ -65,6 +66,14 @@ FEELPP_EXPORT void
 ginacBuildLibrary( GiNaC::lst const& exprs, GiNaC::lst const& syml, std::string const& exprDesc, std::string const& filename,WorldComm const& world,
                    std::shared_ptr<GiNaC::FUNCP_CUBA> & cfun );
 
+/**
+ * @brief build the in-process evaluator (GinacTape) of the expressions
+ * - return a null pointer if the option ginac.compile is true or if the
+ *   expressions cannot be translated, ginacBuildLibrary must be used then
+ */
+FEELPP_EXPORT std::shared_ptr<GinacTape>
+ginacBuildTape( GiNaC::lst const& exprs, GiNaC::lst const& syml, std::string const& exprDesc );
+
 /**
  * @brief get a filename for ginac lib define by use a singleton counter
  */
@@ -255,8 +255,10 @@ public:
                     M_filename = Feel::vf::detail::ginacGetDefaultFileName( M_exprDesc, dirLibExpr );
                 }
 
-                // build ginac lib and link if necessary
-                Feel::vf::detail::ginacBuildLibrary( exprs, syml, M_exprDesc, M_filename, world, M_cfun );
+                // in-process evaluator, else build ginac lib and link if necessary
+                M_tape = Feel::vf::detail::ginacBuildTape( exprs, syml, M_exprDesc );
+                if ( !M_tape )
+                    Feel::vf::detail::ginacBuildLibrary( exprs, syml, M_exprDesc, M_filename, world, M_cfun );
             }
 
             this->updateForUse();
@@ -320,8 +322,10 @@ public:
                     M_filename = Feel::vf::detail::ginacGetDefaultFileName( M_exprDesc, dirLibExpr );
                 }
 
-                // build ginac lib and link if necessary
-                Feel::vf::detail::ginacBuildLibrary( exprs, syml, M_exprDesc, M_filename, world, M_cfun );
+                // in-process evaluator, else build ginac lib and link if necessary
+                M_tape = Feel::vf::detail::ginacBuildTape( exprs, syml, M_exprDesc );
+                if ( !M_tape )
+                    Feel::vf::detail::ginacBuildLibrary( exprs, syml, M_exprDesc, M_filename, world, M_cfun );
             }
 
             this->updateForUse();
@@ -329,11 +333,13 @@ public:
 
     template <typename SymbolsExpressionArgType>
         explicit GinacMatrix( GiNaC::ex const & fun, std::vector<GiNaC::symbol> const& syms,
-                              GiNaC::FUNCP_CUBA const& cfun,  std::string const& exprDesc, SymbolsExpressionArgType/*symbols_expression_type*/ const& expr )
+                              GiNaC::FUNCP_CUBA const& cfun,  std::string const& exprDesc, SymbolsExpressionArgType/*symbols_expression_type*/ const& expr,
+                              std::shared_ptr<Feel::vf::detail::GinacTape> const& tape = nullptr )
         :
         super(syms),
         M_fun(fun.evalm()),
         M_cfun( new GiNaC::FUNCP_CUBA( cfun ) ),
+        M_tape( tape ),
         M_exprDesc( exprDesc ),
         M_expr( expr ),
         M_isPolynomial( false ),
@@ -352,6 +358,7 @@ public:
         super( symbolicExpr ),
         M_fun( symbolicExpr.M_fun ),
         M_cfun( symbolicExpr.M_cfun ),
+        M_tape( symbolicExpr.M_tape ),
         M_exprDesc( symbolicExpr.M_exprDesc ),
         M_expr( expr ),
         M_isPolynomial( false ),
@@ -505,7 +512,7 @@ public:
         if constexpr( is_symbols_expression_empty_v<symbols_expression_type> )
         {
             using new_expr_type = GinacMatrix<M,N,Order,ExpandSymbolsExprType>;
-            new_expr_type res( this->expression(), this->symbols(), this->fun(), this->exprDesc(), se );
+            new_expr_type res( this->expression(), this->symbols(), this->fun(), this->exprDesc(), se, this->tape() );
             res.setParameterValues( this->symbolNameToValue() );
             return res;
         }
@@ -513,7 +520,7 @@ public:
         {
             auto newSymbolExpr = symbolsExpr( this->symbolsExpression(), se );
             using new_expr_type = GinacMatrix<M,N,Order,std::decay_t<decltype(newSymbolExpr)>>;
-            new_expr_type res( this->expression(), this->symbols(), this->fun(), this->exprDesc(), newSymbolExpr );
+            new_expr_type res( this->expression(), this->symbols(), this->fun(), this->exprDesc(), newSymbolExpr, this->tape() );
             res.setParameterValues( this->symbolNameToValue() );
             return res;
         }
@@ -681,6 +688,12 @@ public:
             return *M_cfun;
         }
 
+    //! in-process evaluator, null if the expression is evaluated with the compiled library fun()
+    std::shared_ptr<Feel::vf::detail::GinacTape> const& tape() const
+        {
+            return M_tape;
+        }
+
     std::vector<GiNaC::symbol> const& syms() const { return M_syms; }
 
     std::string const& exprDesc() const { return M_exprDesc; }
@@ -803,6 +816,7 @@ public:
             :
             M_expr( expr ),
             M_fun( expr.fun() ),
+            M_tape( expr.tape() ),
             M_is_constant( expr.isConstant() ),
             M_gmc( fusion::at_key<key_type>( geom ).get() ),
             M_nsyms( expr.syms().size() ),
@@ -821,6 +835,7 @@ public:
             :
             M_expr( expr ),
             M_fun( expr.fun() ),
+            M_tape( expr.tape() ),
             M_is_constant( expr.isConstant() ),
             M_gmc( fusion::at_key<key_type>( geom ).get() ),
             M_nsyms( expr.syms().size() ),
@@ -838,6 +853,7 @@ public:
             :
             M_expr( expr ),
             M_fun( expr.fun() ),
+            M_tape( expr.tape() ),
             M_is_constant( expr.isConstant() ),
             M_gmc( fusion::at_key<key_type>( geom ).get() ),
             M_nsyms( expr.syms().size() ),
@@ -856,6 +872,7 @@ public:
             :
             M_expr( expr ),
             M_fun( expr.fun() ),
+            M_tape( expr.tape() ),
             M_is_constant( expr.isConstant() ),
             M_gmc( fusion::at_key<key_type>( geom ).get() ),
             M_nsyms( expr.syms().size() ),
@@ -876,6 +893,7 @@ public:
             M_expr( expr ),
             //M_fun( expr.fun() ),
             M_fun( exprExpanded.fun() ),
+            M_tape( exprExpanded.tape() ),
             M_is_constant( exprExpanded.isConstant() ),
             M_gmc( fusion::at_key<key_type>( geom ).get() ),
             M_nsyms( exprExpanded.syms().size() ),
@@ -994,6 +1012,12 @@ public:
 
                 int no = M*N;
                 int ni = M_nsyms;//gmc_type::nDim;
+                const int nPoints = M_gmc->nPoints();
+                if ( M_tape )
+                {
+                    M_xBatch.resize( ni*nPoints );
+                    M_yBatch.resize( no*nPoints );
+                }
                 for ( auto const& comp : M_expr.indexSymbolGeom() )
                 {
                     switch ( comp.first )
@@ -1016,7 +1040,7 @@ public:
                             break;
                     }
                 }
-                for(int q = 0; q < M_gmc->nPoints();++q )
+                for(int q = 0; q < nPoints;++q )
                 {
                     for ( auto const& comp : M_expr/*exprExpanded*/.indexSymbolXYZ() )
                         M_x[comp.second] = M_gmc->xReal( q )[comp.first];
@@ -1031,7 +1055,22 @@ public:
                             M_x[idx] = v;
                     }
 
-                    M_fun(&ni,M_x.data(),&no,M_y[q].data());
+                    if ( M_tape )
+                    {
+                        for ( int k = 0; k < ni; ++k )
+                            M_xBatch[k*nPoints+q] = M_x[k];
+                    }
+                    else
+                        M_fun(&ni,M_x.data(),&no,M_y[q].data());
+                }
+
+                // evaluate all the points in one call
+                if ( M_tape )
+                {
+                    M_tape->evaluate( nPoints, M_xBatch.data(), nPoints, M_yBatch.data(), nPoints, M_tapeWork );
+                    for ( int q = 0; q < nPoints; ++q )
+                        for ( int c = 0; c < no; ++c )
+                            M_y[q].data()[c] = M_yBatch[c*nPoints+q];
                 }
             }
 
@@ -1111,6 +1150,7 @@ public:
 
         this_type const& M_expr;
         GiNaC::FUNCP_CUBA M_fun;
+        std::shared_ptr<Feel::vf::detail::GinacTape> M_tape;
         const bool M_is_constant;
         gmc_ptrtype M_gmc;
         int M_nsyms;
@@ -1121,6 +1161,9 @@ public:
 
         tuple_tensor_symbols_expr_type M_ttse;
         std::map<uint16_type,uint16_type> M_subexprIdToSubtensorId;
+
+        // inputs/outputs of the batched evaluation with M_tape (stored by symbol/component)
+        std::vector<value_type> M_xBatch, M_yBatch, M_tapeWork;
     };
 
 private :
@@ -1319,7 +1362,10 @@ private :
                         });
 
         evaluate_type res = evaluate_type::Zero();
-        (*M_cfun)(&ni,x.data(),&no,res.data());
+        if ( M_tape )
+            (*M_tape)(&ni,x.data(),&no,res.data());
+        else
+            (*M_cfun)(&ni,x.data(),&no,res.data());
         return res;
     }
 
@@ -1446,6 +1492,7 @@ private :
 private:
     mutable expression_type  M_fun;
     std::shared_ptr<GiNaC::FUNCP_CUBA> M_cfun;
+    std::shared_ptr<Feel::vf::detail::GinacTape> M_tape;
     std::string M_filename;
     std::string M_exprDesc;
     symbols_expression_storage_type/*symbols_expression_type*/ M_expr;
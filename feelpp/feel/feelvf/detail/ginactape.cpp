@@ -0,0 +1,385 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*-
+
+  This file is part of the Feel library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include <feel/feelvf/detail/ginactape.hpp>
+
+namespace Feel
+{
+namespace vf
+{
+namespace detail
+{
+
+GinacTape::GinacTape( int nInputs )
+    :
+    M_nInputs( nInputs ),
+    M_nRegisters( 0 ),
+    M_isFinalized( false )
+{}
+
+int
+GinacTape::push( Instruction const& ins )
+{
+    M_isFinalized = false;
+    M_instructions.push_back( ins );
+    return M_instructions.size()-1;
+}
+
+int
+GinacTape::addConst( double c )
+{
+    return this->push( Instruction{ OpCode::Const, 0, 0, 0, c } );
+}
+int
+GinacTape::addUnary( OpCode op, int a )
+{
+    return this->push( Instruction{ op, a, 0, 0, 0. } );
+}
+int
+GinacTape::addBinary( OpCode op, int a, int b )
+{
+    return this->push( Instruction{ op, a, b, 0, 0. } );
+}
+int
+GinacTape::addPowInt( int a, int n )
+{
+    return this->push( Instruction{ OpCode::PowInt, a, 0, n, 0. } );
+}
+
+void
+GinacTape::finalize()
+{
+    int nIns = M_instructions.size();
+    auto isBinary = []( OpCode op ) {
+        return op == OpCode::Add || op == OpCode::Sub || op == OpCode::Mul || op == OpCode::Div ||
+            op == OpCode::Pow || op == OpCode::Atan2 || op == OpCode::Mod || op == OpCode::Min ||
+            op == OpCode::Max || op == OpCode::Step1;
+    };
+
+    // last instruction reading each value, outputs are alive until the end
+    std::vector<int> lastUse( nIns, -1 );
+    for ( int i = 0; i < nIns; ++i )
+    {
+        auto const& ins = M_instructions[i];
+        if ( ins.op == OpCode::Const )
+            continue;
+        if ( ins.a >= 0 )
+            lastUse[ins.a] = i;
+        if ( isBinary( ins.op ) && ins.b >= 0 )
+            lastUse[ins.b] = i;
+    }
+    for ( int v : M_outputs )
+        if ( v >= 0 )
+            lastUse[v] = nIns;
+
+    // linear scan : the operands dying at instruction i are released before
+    // the result is allocated since all the operations are pointwise
+    M_registers.assign( nIns, -1 );
+    M_nRegisters = 0;
+    std::vector<int> freeRegisters;
+    auto release = [&]( int v, int i ) {
+        if ( v >= 0 && lastUse[v] == i )
+            freeRegisters.push_back( M_registers[v] );
+    };
+    for ( int i = 0; i < nIns; ++i )
+    {
+        auto const& ins = M_instructions[i];
+        if ( ins.op != OpCode::Const )
+        {
+            release( ins.a, i );
+            if ( isBinary( ins.op ) && ins.b != ins.a )
+                release( ins.b, i );
+        }
+        if ( !freeRegisters.empty() )
+        {
+            M_registers[i] = freeRegisters.back();
+            freeRegisters.pop_back();
+        }
+        else
+            M_registers[i] = M_nRegisters++;
+        // result never read
+        if ( lastUse[i] < 0 )
+            freeRegisters.push_back( M_registers[i] );
+    }
+    M_isFinalized = true;
+}
+
+std::size_t
+GinacTape::workspaceSize( int nPoints ) const
+{
+    return std::size_t( M_nRegisters )*std::min( nPoints, blockSize );
+}
+
+void
+GinacTape::evaluate( int nPoints, double const* x, int ldx, double* y, int ldy, std::vector<double>& work ) const
+{
+    if ( !M_isFinalized )
+        throw std::logic_error( "GinacTape::evaluate : the tape is not finalized" );
+    std::size_t ws = this->workspaceSize( nPoints );
+    if ( work.size() < ws )
+        work.resize( ws );
+    for ( int p = 0; p < nPoints; p += blockSize )
+        this->evaluateBlock( std::min( blockSize, nPoints-p ), x+p, ldx, y+p, ldy, work.data() );
+}
+
+void
+GinacTape::operator()( const int* /*ni*/, const double* x, const int* no, double* y ) const
+{
+    std::vector<double> work( M_nRegisters );
+    std::vector<double> yt( M_outputs.size() );
+    this->evaluate( 1, x, 1, yt.data(), 1, work );
+    std::copy( yt.begin(), yt.begin() + std::min( *no, int(yt.size()) ), y );
+}
+
+void
+GinacTape::evaluateBlock( int np, double const* x, int ldx, double* y, int ldy, double* work ) const
+{
+    const int bs = std::min( np, blockSize );
+    auto value = [&]( int v ) -> double const* {
+        return ( v < 0 )? x + std::size_t(-v-1)*ldx : work + std::size_t(M_registers[v])*bs;
+    };
+    auto unary = [np]( double* r, double const* a, auto&& f ) {
+        for ( int p = 0; p < np; ++p )
+            r[p] = f( a[p] );
+    };
+    auto binary = [np]( double* r, double const* a, double const* b, auto&& f ) {
+        for ( int p = 0; p < np; ++p )
+            r[p] = f( a[p], b[p] );
+    };
+
+    const int nIns = M_instructions.size();
+    for ( int i = 0; i < nIns; ++i )
+    {
+        auto const& ins = M_instructions[i];
+        double* r = work + std::size_t(M_registers[i])*bs;
+        if ( ins.op == OpCode::Const )
+        {
+            std::fill( r, r+np, ins.c );
+            continue;
+        }
+        double const* a = value( ins.a );
+        switch ( ins.op )
+        {
+        case OpCode::Add: binary( r, a, value( ins.b ), []( double u, double v ) { return u+v; } ); break;
+        case OpCode::Sub: binary( r, a, value( ins.b ), []( double u, double v ) { return u-v; } ); break;
+        case OpCode::Mul: binary( r, a, value( ins.b ), []( double u, double v ) { return u*v; } ); break;
+        case OpCode::Div: binary( r, a, value( ins.b ), []( double u, double v ) { return u/v; } ); break;
+        case OpCode::Pow: binary( r, a, value( ins.b ), []( double u, double v ) { return std::pow( u, v ); } ); break;
+        case OpCode::Atan2: binary( r, a, value( ins.b ), []( double u, double v ) { return std::atan2( u, v ); } ); break;
+        case OpCode::Mod: binary( r, a, value( ins.b ), []( double u, double v ) { return std::fmod( u, v ); } ); break;
+        case OpCode::Min: binary( r, a, value( ins.b ), []( double u, double v ) { return ( v < u )? v : u; } ); break;
+        case OpCode::Max: binary( r, a, value( ins.b ), []( double u, double v ) { return ( u < v )? v : u; } ); break;
+        case OpCode::Step1: binary( r, a, value( ins.b ), []( double u, double v ) { return ( u < v )? 0. : 1.; } ); break;
+        case OpCode::Neg: unary( r, a, []( double u ) { return -u; } ); break;
+        case OpCode::PowInt:
+        {
+            const int n = ins.n;
+            unary( r, a, [n]( double u ) {
+                       unsigned int e = ( n < 0 )? -n : n;
+                       double res = 1.;
+                       for ( ; e; e >>= 1, u *= u )
+                           if ( e & 1u )
+                               res *= u;
+                       return ( n < 0 )? 1./res : res;
+                   } );
+            break;
+        }
+        case OpCode::Sqrt: unary( r, a, []( double u ) { return std::sqrt( u ); } ); break;
+        case OpCode::Exp: unary( r, a, []( double u ) { return std::exp( u ); } ); break;
+        case OpCode::Log: unary( r, a, []( double u ) { return std::log( u ); } ); break;
+        case OpCode::Sin: unary( r, a, []( double u ) { return std::sin( u ); } ); break;
+        case OpCode::Cos: unary( r, a, []( double u ) { return std::cos( u ); } ); break;
+        case OpCode::Tan: unary( r, a, []( double u ) { return std::tan( u ); } ); break;
+        case OpCode::Asin: unary( r, a, []( double u ) { return std::asin( u ); } ); break;
+        case OpCode::Acos: unary( r, a, []( double u ) { return std::acos( u ); } ); break;
+        case OpCode::Atan: unary( r, a, []( double u ) { return std::atan( u ); } ); break;
+        case OpCode::Sinh: unary( r, a, []( double u ) { return std::sinh( u ); } ); break;
+        case OpCode::Cosh: unary( r, a, []( double u ) { return std::cosh( u ); } ); break;
+        case OpCode::Tanh: unary( r, a, []( double u ) { return std::tanh( u ); } ); break;
+        case OpCode::Asinh: unary( r, a, []( double u ) { return std::asinh( u ); } ); break;
+        case OpCode::Acosh: unary( r, a, []( double u ) { return std::acosh( u ); } ); break;
+        case OpCode::Atanh: unary( r, a, []( double u ) { return std::atanh( u ); } ); break;
+        case OpCode::Abs: unary( r, a, []( double u ) { return std::abs( u ); } ); break;
+        // same convention as GiNaC : step(0) = 1/2
+        case OpCode::Step: unary( r, a, []( double u ) { return ( u > 0 )? 1. : ( ( u < 0 )? 0. : 0.5 ); } ); break;
+        case OpCode::Floor: unary( r, a, []( double u ) { return std::floor( u ); } ); break;
+        case OpCode::Ceil: unary( r, a, []( double u ) { return std::ceil( u ); } ); break;
+        case OpCode::Sign: unary( r, a, []( double u ) { return double( 0. < u ) - double( u < 0. ); } ); break;
+        case OpCode::Const: break;
+        }
+    }
+
+    for ( int o = 0, no = M_outputs.size(); o < no; ++o )
+    {
+        double const* v = value( M_outputs[o] );
+        std::copy( v, v+np, y + std::size_t(o)*ldy );
+    }
+}
+
+//
+// translation of GiNaC expressions
+//
+namespace
+{
+class GinacTapeTranslator
+{
+public:
+    GinacTapeTranslator( GinacTape& tape, GiNaC::lst const& syml )
+        :
+        M_tape( tape )
+        {
+            int k = 0;
+            for ( auto it = syml.begin(); it != syml.end(); ++it, ++k )
+                M_values[*it] = GinacTape::input( k );
+        }
+
+    int operator()( GiNaC::ex const& e )
+        {
+            auto it = M_values.find( e );
+            if ( it != M_values.end() )
+                return it->second;
+            int v = this->translate( e );
+            M_values[e] = v;
+            return v;
+        }
+
+private:
+    using OpCode = GinacTape::OpCode;
+
+    static double toDouble( GiNaC::ex const& e )
+        {
+            GiNaC::numeric const& n = GiNaC::ex_to<GiNaC::numeric>( e );
+            if ( !n.is_real() )
+                throw std::invalid_argument( "GinacTape : complex number " + str( e ) );
+            return n.to_double();
+        }
+    static std::string str( GiNaC::ex const& e )
+        {
+            std::ostringstream os;
+            os << e;
+            return os.str();
+        }
+
+    int translate( GiNaC::ex const& e )
+        {
+            if ( GiNaC::is_a<GiNaC::numeric>( e ) )
+                return M_tape.addConst( toDouble( e ) );
+            if ( GiNaC::is_a<GiNaC::constant>( e ) )
+                return M_tape.addConst( toDouble( e.evalf() ) );
+            if ( GiNaC::is_a<GiNaC::symbol>( e ) )
+                throw std::invalid_argument( "GinacTape : unknown symbol " + str( e ) );
+            if ( GiNaC::is_a<GiNaC::add>( e ) || GiNaC::is_a<GiNaC::mul>( e ) )
+            {
+                OpCode op = GiNaC::is_a<GiNaC::add>( e )? OpCode::Add : OpCode::Mul;
+                int v = (*this)( e.op( 0 ) );
+                for ( std::size_t i = 1; i < e.nops(); ++i )
+                {
+                    GiNaC::ex const& t = e.op( i );
+                    // x*(-1) and x+(-1)*y are the usual forms of -x and x-y
+                    if ( op == OpCode::Mul && t.is_equal( GiNaC::ex( -1 ) ) )
+                        v = M_tape.addUnary( OpCode::Neg, v );
+                    else if ( op == OpCode::Add && GiNaC::is_a<GiNaC::mul>( t ) && t.nops() == 2 && t.op( 1 ).is_equal( GiNaC::ex( -1 ) ) )
+                        v = M_tape.addBinary( OpCode::Sub, v, (*this)( t.op( 0 ) ) );
+                    else
+                        v = M_tape.addBinary( op, v, (*this)( t ) );
+                }
+                return v;
+            }
+            if ( GiNaC::is_a<GiNaC::power>( e ) )
+            {
+                GiNaC::ex const& expo = e.op( 1 );
+                int b = (*this)( e.op( 0 ) );
+                if ( GiNaC::is_a<GiNaC::numeric>( expo ) )
+                {
+                    GiNaC::numeric const& n = GiNaC::ex_to<GiNaC::numeric>( expo );
+                    if ( n.is_integer() && GiNaC::abs( n ) <= 64 )
+                        return M_tape.addPowInt( b, n.to_int() );
+                    if ( n.is_equal( GiNaC::numeric( 1, 2 ) ) )
+                        return M_tape.addUnary( OpCode::Sqrt, b );
+                    if ( n.is_equal( GiNaC::numeric( -1, 2 ) ) )
+                        return M_tape.addPowInt( M_tape.addUnary( OpCode::Sqrt, b ), -1 );
+                }
+                return M_tape.addBinary( OpCode::Pow, b, (*this)( expo ) );
+            }
+            if ( GiNaC::is_a<GiNaC::function>( e ) )
+            {
+                static const std::map<std::string,OpCode> unaryFunctions = {
+                    { "sin", OpCode::Sin }, { "cos", OpCode::Cos }, { "tan", OpCode::Tan },
+                    { "asin", OpCode::Asin }, { "acos", OpCode::Acos }, { "atan", OpCode::Atan },
+                    { "sinh", OpCode::Sinh }, { "cosh", OpCode::Cosh }, { "tanh", OpCode::Tanh },
+                    { "asinh", OpCode::Asinh }, { "acosh", OpCode::Acosh }, { "atanh", OpCode::Atanh },
+                    { "exp", OpCode::Exp }, { "log", OpCode::Log }, { "abs", OpCode::Abs }, { "step", OpCode::Step },
+                    { "floor", OpCode::Floor }, { "ceil", OpCode::Ceil }, { "sign", OpCode::Sign } };
+                static const std::map<std::string,OpCode> binaryFunctions = {
+                    { "atan2", OpCode::Atan2 }, { "mod", OpCode::Mod }, { "step1", OpCode::Step1 } };
+                std::string name = GiNaC::ex_to<GiNaC::function>( e ).get_name();
+                auto itbf = binaryFunctions.find( name );
+                if ( itbf != binaryFunctions.end() && e.nops() == 2 )
+                    return M_tape.addBinary( itbf->second, (*this)( e.op( 0 ) ), (*this)( e.op( 1 ) ) );
+                // functions of the default reader written with the operations above
+                if ( name == "fract" && e.nops() == 1 )
+                {
+                    int x = (*this)( e.op( 0 ) );
+                    return M_tape.addBinary( OpCode::Sub, x, M_tape.addUnary( OpCode::Floor, x ) );
+                }
+                if ( name == "clamp" && e.nops() == 3 )
+                    return M_tape.addBinary( OpCode::Min,
+                                             M_tape.addBinary( OpCode::Max, (*this)( e.op( 0 ) ), (*this)( e.op( 1 ) ) ),
+                                             (*this)( e.op( 2 ) ) );
+                if ( name == "rectangle" && e.nops() == 3 )
+                {
+                    int x = (*this)( e.op( 0 ) );
+                    return M_tape.addBinary( OpCode::Mul,
+                                             M_tape.addBinary( OpCode::Step1, x, (*this)( e.op( 1 ) ) ),
+                                             M_tape.addBinary( OpCode::Step1, (*this)( e.op( 2 ) ), x ) );
+                }
+                auto itf = unaryFunctions.find( name );
+                if ( itf != unaryFunctions.end() && e.nops() == 1 )
+                    return M_tape.addUnary( itf->second, (*this)( e.op( 0 ) ) );
+                throw std::invalid_argument( "GinacTape : unsupported function " + name );
+            }
+            throw std::invalid_argument( "GinacTape : unsupported expression " + str( e ) );
+        }
+
+private:
+    GinacTape& M_tape;
+    std::map<GiNaC::ex,int,GiNaC::ex_is_less> M_values;
+};
+} // anonymous namespace
+
+GinacTape::GinacTape( GiNaC::lst const& exprs, GiNaC::lst const& syml )
+    :
+    GinacTape( syml.nops() )
+{
+    GinacTapeTranslator translate( *this, syml );
+    for ( auto it = exprs.begin(); it != exprs.end(); ++it )
+        this->addOutput( translate( *it ) );
+    this->finalize();
+}
+
+} // namespace detail
+} // namespace vf
+} // namespace Feel
@@ -0,0 +1,142 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*-
+
+  This file is part of the Feel library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#ifndef FEELPP_DETAIL_GINACTAPE_HPP
+#define FEELPP_DETAIL_GINACTAPE_HPP 1
+
+#include <cstdint>
+#include <vector>
+
+#include <ginac/ginac.h>
+
+#include <feel/feelcore/feelmacros.hpp>
+
+namespace Feel
+{
+namespace vf
+{
+namespace detail
+{
+
+/**
+ * @brief in-process evaluator of GiNaC expressions
+ *
+ * The expressions are translated once into a linear list of instructions
+ * (common subexpressions are shared) whose registers are reused as soon as
+ * they are dead. The evaluation is done for a batch of points at a time :
+ * each instruction loops over the points of a block, so that the loops are
+ * vectorised by the compiler and no external compiler is needed.
+ *
+ * The inputs and outputs of the batch evaluation are stored by symbol
+ * (resp. component) : \c x[k*ldx+p] is the value of the k-th symbol at the
+ * point p and \c y[o*ldy+p] the o-th output at the point p.
+ */
+class FEELPP_EXPORT GinacTape
+{
+public:
+    enum class OpCode : std::uint8_t
+    {
+        Const, Add, Sub, Mul, Div, Neg, PowInt, Pow, Mod, Min, Max,
+        Sqrt, Exp, Log, Sin, Cos, Tan, Asin, Acos, Atan, Atan2,
+        Sinh, Cosh, Tanh, Asinh, Acosh, Atanh, Abs, Step, Step1,
+        Floor, Ceil, Sign
+    };
+
+    //! number of points evaluated by each instruction in a row
+    static constexpr int blockSize = 64;
+
+    //! empty tape with \p nInputs symbols
+    explicit GinacTape( int nInputs = 0 );
+
+    /**
+     * translate the expressions \p exprs depending on the symbols \p syml,
+     * throw std::invalid_argument if an expression contains something
+     * which cannot be evaluated (complex number, unknown symbol or function,...)
+     */
+    GinacTape( GiNaC::lst const& exprs, GiNaC::lst const& syml );
+
+    GinacTape( GinacTape const& ) = default;
+    GinacTape( GinacTape && ) = default;
+    GinacTape& operator=( GinacTape const& ) = default;
+    GinacTape& operator=( GinacTape && ) = default;
+
+    int nInputs() const { return M_nInputs; }
+    int nOutputs() const { return M_outputs.size(); }
+    int nInstructions() const { return M_instructions.size(); }
+    int nRegisters() const { return M_nRegisters; }
+
+    /** @name construction of the tape
+     * a value is either an input (\c input(k)) or the result of a previous
+     * instruction ; finalize() must be called once the outputs are set
+     */
+    //@{
+    static int input( int k ) { return -k-1; }
+    int addConst( double c );
+    int addUnary( OpCode op, int a );
+    int addBinary( OpCode op, int a, int b );
+    int addPowInt( int a, int n );
+    void addOutput( int v ) { M_outputs.push_back( v ); }
+    //! allocate the registers
+    void finalize();
+    //@}
+
+    //! size of the workspace needed by evaluate() for \p nPoints points
+    std::size_t workspaceSize( int nPoints ) const;
+
+    /**
+     * evaluate the outputs for \p nPoints points
+     * @param x inputs, \c x[k*ldx+p]
+     * @param y outputs, \c y[o*ldy+p]
+     * @param work workspace, resized if necessary
+     */
+    void evaluate( int nPoints, double const* x, int ldx, double* y, int ldy, std::vector<double>& work ) const;
+
+    /**
+     * evaluate at one point with the same signature as GiNaC::FUNCP_CUBA
+     */
+    void operator()( const int* ni, const double* x, const int* no, double* y ) const;
+
+private:
+    struct Instruction
+    {
+        OpCode op;
+        int a, b;
+        int n;
+        double c;
+    };
+
+    int push( Instruction const& ins );
+    void evaluateBlock( int nPoints, double const* x, int ldx, double* y, int ldy, double* work ) const;
+
+private:
+    int M_nInputs;
+    int M_nRegisters;
+    bool M_isFinalized;
+    std::vector<Instruction> M_instructions;
+    //! register of each instruction (after finalize)
+    std::vector<int> M_registers;
+    std::vector<int> M_outputs;
+};
+
+} // namespace detail
+} // namespace vf
+} // namespace Feel
+
+#endif /* FEELPP_DETAIL_GINACTAPE_HPP */
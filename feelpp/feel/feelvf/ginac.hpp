@@ -530,7 +530,7 @@ expr( Expr<GinacEx<Order>> const& s, const ExprT&... expr )
 {
     auto const& symbexpr = s.expression();
     typedef GinacExVF<Order,symbols_expression_t<ExprT...> > _expr_type;
-    auto res = Expr< _expr_type >( _expr_type( symbexpr.expression(), symbexpr.symbols(), symbexpr.fun(), symbexpr.exprDesc(), symbolsExpr(expr...) ) );
+    auto res = Expr< _expr_type >( _expr_type( symbexpr.expression(), symbexpr.symbols(), symbexpr.fun(), symbexpr.exprDesc(), symbolsExpr(expr...), symbexpr.tape() ) );
     res.setParameterValues( symbexpr.symbolNameToValue() );
     return res;
 }
@@ -542,7 +542,7 @@ expr( Expr<GinacMatrix<M,N,Order>> const& s, const ExprT&... expr )
 {
     auto const& symbexpr = s.expression();
     typedef GinacMatrix<M,N,Order,symbols_expression_t<ExprT...> > _expr_type;
-    auto res = Expr< _expr_type >( _expr_type( symbexpr.expression(), symbexpr.symbols(), symbexpr.fun(), symbexpr.exprDesc(), symbolsExpr(expr...) ) );
+    auto res = Expr< _expr_type >( _expr_type( symbexpr.expression(), symbexpr.symbols(), symbexpr.fun(), symbexpr.exprDesc(), symbolsExpr(expr...), symbexpr.tape() ) );
     res.setParameterValues( symbexpr.symbolNameToValue() );
     return res;
 }
@@ -33,11 +33,15 @@
 
 #include <cxxabi.h>
 #include <typeinfo>
+#include <future>
+#include <mutex>
+#include <thread>
 
 #include <Eigen/Eigen>
 
 #include <feel/feelcore/feel.hpp>
 #include <feel/feelcore/parameter.hpp>
+#include <feel/feelcore/threadpool.hpp>
 
 #include <feel/feelmesh/filters.hpp>
 #include <feel/feelpoly/quadmapped.hpp>
@@ -52,6 +56,7 @@
 #include <feel/feelvf/linearform.hpp>
 #include <feel/feelvf/matvec.hpp>
 #include <feel/feeldiscr/quadptlocalization.hpp>
+#include <feel/feeldiscr/elementcoloring.hpp>
 #if defined( FEELPP_HAS_GOOGLE_PROFILER_H )
 #include <google/profiler.h>
 #endif
@@ -93,6 +98,17 @@ enum IntegratorType
 
 };
 
+namespace detail_integrator
+{
+//! true if the form has a trial space (bilinear form)
+template<typename FormType, typename = void>
+struct has_trial_space : std::false_type {};
+template<typename FormType>
+struct has_trial_space<FormType, std::void_t<decltype( std::declval<FormType const&>().trialSpace() )>> : std::true_type {};
+template<typename FormType>
+inline constexpr bool has_trial_space_v = has_trial_space<FormType>::value;
+} // namespace detail_integrator
+
 /**
  * \class Integrator
  * \brief base class for integrators
@@ -789,6 +805,18 @@ private:
     template<typename FormType>
     void assemble( FormType& __form, mpl::int_<MESH_ELEMENTS> /**/, mpl::bool_<false> /**/, bool hasRelation ) const;
 
+    /**
+     * shared memory assembly over elements : the element range is coloured
+     * such that two elements of one colour do not share a test dof and each
+     * colour is assembled by the threads of the shared pool, each one with its
+     * own geometric mapping and form contexts. The element contributions of
+     * one colour are added in place in the matrix/vector without lock.
+     * \return false if the form/range is not supported (mortar spaces, range
+     * or trial space not defined on the mesh of the test space), true otherwise
+     */
+    template<typename FormType>
+    bool assembleWithColoring( FormType& __form ) const;
+
     template<typename FormType>
     void assemble( FormType& __form, mpl::int_<MESH_FACES> /**/, mpl::bool_<true> /**/, bool hasRelation ) const;
     template<typename FormType>
@@ -980,6 +1008,16 @@ Integrator<Elements, Im, Expr, Im2>::assemble( FormType& __form, mpl::int_<MESH_
     tic();
     DLOG(INFO) << "[integrator::assemble FormType& __form, mpl::int_<MESH_ELEMENTS> /**/, mpl::bool_<true>\n";
 
+    if ( boption(_name="parallel.cpu.enable") && soption(_name="parallel.cpu.impl") == "coloring" )
+    {
+        if ( this->assembleWithColoring( __form ) )
+        {
+            toc("Integrator::assemble form MESH_ELEMENTS (coloring)", FLAGS_v>1);
+            return;
+        }
+        DLOG(INFO) << "[integrator::assemble] coloring assembly not supported for this form, use serial assembly";
+    }
+
 #if defined(FEELPP_HAS_TBB)
 
     //std::cout << "Integrator Uses TBB: " << M_use_tbb << "\n";
@@ -1237,6 +1275,175 @@ Integrator<Elements, Im, Expr, Im2>::assemble( FormType& __form, mpl::int_<MESH_
 #endif // FEELPP_HAS_TBB
 }
 
+template<typename Elements, typename Im, typename Expr, typename Im2>
+template<typename FormType>
+bool
+Integrator<Elements, Im, Expr, Im2>::assembleWithColoring( FormType& __form ) const
+{
+    static const bool has_mortar = FormType::test_space_type::is_mortar || FormType::trial_space_type::is_mortar;
+    if constexpr ( has_mortar )
+        return false;
+    else
+    {
+        typedef typename eval::gmc_type gmc_type;
+        typedef std::shared_ptr<gmc_type> gmc_ptrtype;
+        typedef fusion::map<fusion::pair<vf::detail::gmc<0>, gmc_ptrtype> > map_gmc_type;
+        typedef typename FormType::template Context<map_gmc_type, expression_type, im_type> form_context_type;
+        using focb_ptrtype = std::shared_ptr<form_context_type>;
+
+        typedef typename eval::gmc1_type gmc1_type;
+        typedef std::shared_ptr<gmc1_type> gmc1_ptrtype;
+        typedef fusion::map<fusion::pair<vf::detail::gmc<0>, gmc1_ptrtype> > map_gmc1_type;
+        typedef typename FormType::template Context<map_gmc1_type, expression_type, im2_type> form1_context_type;
+        using focb1_ptrtype = std::shared_ptr<form1_context_type>;
+
+        using element_cref_type = std::reference_wrapper<const typename eval::the_element_type>;
+
+        auto const& testMesh = __form.testSpace()->mesh();
+        auto const& testDof = __form.testSpace()->dof();
+        bool trialIsTestMesh = true;
+        if constexpr ( detail_integrator::has_trial_space_v<FormType> )
+            trialIsTestMesh = __form.trialSpace()->mesh()->isSameMesh( testMesh );
+        if ( !trialIsTestMesh )
+            return false;
+
+        std::vector<element_cref_type> elts;
+        std::vector<size_type> eltIds;
+        for( auto lit = M_elts.begin(), len = M_elts.end(); lit != len; ++lit )
+        {
+            for ( auto it = lit->begin(), en = lit->end(); it != en; ++it )
+            {
+                auto const& eltCur = boost::unwrap_ref( *it );
+                if ( !eltCur.mesh()->isSameMesh( testMesh ) )
+                    return false;
+                elts.push_back( std::cref( eltCur ) );
+                eltIds.push_back( eltCur.id() );
+            }
+        }
+        if ( elts.empty() )
+            return true;
+
+        // the colouring only depends on the elements and the dof table, it is
+        // computed once and reused by the next assemblies of the same range
+        auto colors = testDof->elementColoringCache().get( eltIds, testDof->nLocalDofWithGhost(),
+                                                           [&eltIds,&testDof]( size_type k ) -> auto {
+                                                               return testDof->localToGlobalIndices( eltIds[k] );
+                                                           } );
+
+        int nThreads = ioption(_name="parallel.cpu.restrict");
+        if ( nThreads <= 0 )
+            nThreads = std::max( 1u, std::thread::hardware_concurrency() );
+        DVLOG(1) << "[integrator::assembleWithColoring] " << elts.size() << " elements in " << colors->size()
+                 << " colors with " << nThreads << " threads";
+
+        bool useGeomapHO = (M_gt == GeomapStrategyType::GEOMAP_HO) || (M_gt == GeomapStrategyType::GEOMAP_OPT );
+        bool useGeomapO1 = (M_gt == GeomapStrategyType::GEOMAP_O1) || (M_gt == GeomapStrategyType::GEOMAP_OPT );
+
+        // one set of geometric mapping and form contexts per thread, the form
+        // contexts insert the element contributions through the thread buffer
+        using value_type = typename FormType::value_type;
+        struct ThreadContext
+        {
+            gmc_ptrtype c;
+            focb_ptrtype formc;
+            gmc1_ptrtype c1;
+            focb1_ptrtype formc1;
+            ConcurrentInsertionBuffer<value_type> buffer;
+        };
+        std::vector<ThreadContext> ctx( nThreads );
+        auto const& eltInit = elts.front().get();
+        for ( auto& tc : ctx )
+        {
+            if ( useGeomapHO )
+            {
+                auto geopc = __form.gm()->preCompute( this->im().points() );
+                tc.c = __form.gm()->template context<eval::gmc_context_v>( eltInit, geopc, this->expression().dynamicContext() );
+                auto mapgmc = vf::mapgmc( tc.c );
+                tc.formc = std::make_shared<form_context_type>( __form, mapgmc, mapgmc, mapgmc,
+                                                                this->expression(), this->im() );
+                tc.formc->setConcurrentInsertionBuffer( &tc.buffer );
+            }
+            if ( useGeomapO1 )
+            {
+                auto geopc1 = __form.gm1()->preCompute( this->im2().points() );
+                tc.c1 = __form.gm1()->template context<eval::gmc_context_v>( eltInit, geopc1, this->expression().dynamicContext() );
+                auto mapgmc1 = vf::mapgmc( tc.c1 );
+                tc.formc1 = std::make_shared<form1_context_type>( __form, mapgmc1, mapgmc1, mapgmc1,
+                                                                  this->expression(), this->im2() );
+                tc.formc1->setConcurrentInsertionBuffer( &tc.buffer );
+            }
+        }
+
+        // the elements of one colour share no dof : their rows owned by the
+        // process are added in place in the matrix/vector without lock. The
+        // other rows (ghost rows, entries out of the pattern) are kept in the
+        // thread buffers and added at the end. If the container does not
+        // support the insertion in place, all the rows go to the buffers which
+        // are then flushed by batches under the lock.
+        bool inPlace = __form.beginConcurrentInsertion();
+        static const std::size_t flushBatchSize = 1 << 16;
+        std::mutex flushMutex;
+        auto assembleElement = [this,&__form,inPlace,&flushMutex]( ThreadContext& tc, typename eval::the_element_type const& eltCur )
+            {
+                bool useHO = ( M_gt == GeomapStrategyType::GEOMAP_HO ) ||
+                    ( M_gt == GeomapStrategyType::GEOMAP_OPT && eltCur.isOnBoundary() );
+                if ( useHO )
+                {
+                    if ( tc.formc->isZero( eltCur.id() ) )
+                        return;
+                    tc.c->template update<eval::gmc_context_v>( eltCur );
+                    auto mapgmc = vf::mapgmc( tc.c );
+                    tc.formc->update( mapgmc, mapgmc, mapgmc );
+                    tc.formc->integrate();
+                    tc.formc->assemble();
+                }
+                else
+                {
+                    if ( tc.formc1->isZero( eltCur.id() ) )
+                        return;
+                    tc.c1->template update<eval::gmc_context_v>( eltCur );
+                    auto mapgmc1 = vf::mapgmc( tc.c1 );
+                    tc.formc1->update( mapgmc1, mapgmc1, mapgmc1 );
+                    tc.formc1->integrate();
+                    tc.formc1->assemble();
+                }
+                if ( !inPlace && tc.buffer.size() >= flushBatchSize )
+                {
+                    std::lock_guard<std::mutex> guard( flushMutex );
+                    __form.addConcurrentInsertionBuffer( tc.buffer );
+                }
+            };
+
+        auto pool = ( nThreads > 1 )? sharedThreadPool( nThreads-1 ) : std::shared_ptr<ThreadPool>{};
+        for ( auto const& color : *colors )
+        {
+            int nThreadsColor = std::min( nThreads, (int)color.size() );
+            size_type chunkSize = color.size()/nThreadsColor;
+            size_type remainder = color.size()%nThreadsColor;
+            auto assembleChunk = [&]( int t )
+                {
+                    size_type start = t*chunkSize + std::min( (size_type)t, remainder );
+                    size_type end = start + chunkSize + ( (size_type)t < remainder ? 1 : 0 );
+                    for ( size_type k = start; k < end; ++k )
+                        assembleElement( ctx[t], elts[color[k]].get() );
+                };
+            // the calling thread assembles the first chunk
+            std::vector<std::future<void>> futures;
+            for ( int t = 1; t < nThreadsColor; ++t )
+                futures.push_back( pool->submit( [&assembleChunk,t]{ assembleChunk( t ); } ) );
+            assembleChunk( 0 );
+            for ( auto& f : futures )
+                f.get();
+        }
+
+        __form.endConcurrentInsertion();
+        for ( auto& tc : ctx )
+            __form.addConcurrentInsertionBuffer( tc.buffer );
+
+        return true;
+    }
+}
+
 template<typename Elements, typename Im, typename Expr, typename Im2>
 template<typename FormType>
 void
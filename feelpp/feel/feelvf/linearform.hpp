@@ -38,6 +38,7 @@
 #include <boost/multi_array.hpp>
 #include <feel/feelvf/block.hpp>
 #include <feel/feelalg/vectorvalue.hpp>
+#include <feel/feelalg/concurrentinsertionbuffer.hpp>
 #include <feel/feelvf/fec.hpp>
 #include <feel/feelvf/formcontextbase.hpp>
 
@@ -414,6 +415,16 @@ public:
         }
         void assemble( index_type elt_0, index_type elt_1 );
 
+        /**
+         * insert the element vectors with LinearForm::addVectorConcurrent
+         * (without lock) and keep in \p buffer the entries which can not be
+         * added in place, null restores the insertion with LinearForm::addVector
+         */
+        void setConcurrentInsertionBuffer( ConcurrentInsertionBuffer<value_type>* buffer )
+        {
+            M_concurrentInsertionBuffer = buffer;
+        }
+
         /**
          * precompute the basis function associated with the test and
          * trial space at a set of points
@@ -503,11 +514,22 @@ public:
                                            std::vector<boost::tuple<index_type,index_type> > const& indexLocalToQuad,
                                            bool isFirstExperience );
 
+    private:
+
+        void addElementVector( int* i, int n, value_type* v, size_type K )
+        {
+            if ( M_concurrentInsertionBuffer )
+                M_form.addVectorConcurrent( i, n, v, *M_concurrentInsertionBuffer );
+            else
+                M_form.addVector( i, n, v, K );
+        }
+
     private:
 
         form_type& M_form;
         dof_type* M_test_dof;
         const list_block_type& M_lb;
+        ConcurrentInsertionBuffer<value_type>* M_concurrentInsertionBuffer = nullptr;
 
         test_precompute_ptrtype M_test_pc;
         std::map<uint16_type, std::map<permutation_type,test_precompute_ptrtype> > M_test_pc_face;
@@ -943,6 +965,36 @@ public:
         M_F->addVector( i, n, v, K, K2 );
     }
 
+    /**
+     * prepare the concurrent insertion of the element vectors, see
+     * Vector::beginConcurrentInsertion()
+     */
+    bool beginConcurrentInsertion()
+    {
+        return M_F->beginConcurrentInsertion();
+    }
+
+    /**
+     * add data \p v at indices \c i without lock, the entries which can not
+     * be added in place are kept in the thread buffer \p buffer
+     */
+    void addVectorConcurrent( int* i, int n, value_type* v, ConcurrentInsertionBuffer<value_type>& buffer )
+    {
+        M_F->addVectorConcurrent( i, n, v, buffer );
+    }
+
+    //! end the concurrent insertion
+    void endConcurrentInsertion()
+    {
+        M_F->endConcurrentInsertion();
+    }
+
+    //! add the entries kept in \p buffer in the vector and clear it
+    void addConcurrentInsertionBuffer( ConcurrentInsertionBuffer<value_type>& buffer )
+    {
+        M_F->addConcurrentInsertionBuffer( buffer );
+    }
+
     /**
      * set value \p v at position (\p i) of the vector
      * associated with the linear form
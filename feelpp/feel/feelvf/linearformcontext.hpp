@@ -405,7 +405,7 @@ LinearForm<SpaceType, VectorType, ElemContType>::Context<GeomapContext,ExprT,IM,
             M_rep.array() *= M_local_rowsigns.array().template cast<value_type>();
             DVLOG(2) << "rep after sign change = " << M_rep;
         }
-        M_form.addVector( M_local_rows.data(), M_local_rows.size(),
+        addElementVector( M_local_rows.data(), M_local_rows.size(),
                           M_rep.data(), elt_0 );
     }
     else
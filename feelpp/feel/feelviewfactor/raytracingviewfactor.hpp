@@ -11,11 +11,16 @@
  */
 #pragma once
 
+#include <array>
 #include <random>
 #include <cmath>
 #include <iostream>
 #include <future>
+#include <limits>
 
+#include <boost/serialization/utility.hpp>
+
+#include <feel/feelcore/threadpool.hpp>
 #include <feel/feelviewfactor/viewfactorbase.hpp>
 #include <feel/feelmesh/bvh.hpp>
 #include <feel/feelvf/vf.hpp>
@@ -183,8 +188,20 @@ public:
         :
         super(mesh,specs)
         {
+            M_mesh = mesh;
             M_Nrays = specs["viewfactor"]["Nrays"].get<double>() ;
             M_Nthreads = specs["viewfactor"]["Nthreads"].get<double>() ;
+            // optional : stop when the standard error of all view factors of a row is below the tolerance
+            M_tolerance = specs["viewfactor"].value( "tolerance", 0. );
+            // number of rays per element launched in each round (a round is an independent estimate)
+            M_NraysPerRound = specs["viewfactor"].value( "raysPerRound", std::max( 1, ( M_Nrays + 7 ) / 8 ) );
+            M_sampling = specs["viewfactor"].value( "sampling", std::string( "qmc" ) );
+            if ( M_sampling != "qmc" && M_sampling != "random" )
+                throw std::invalid_argument( fmt::format( "invalid viewfactor sampling {} (should be qmc or random)", M_sampling ) );
+            if ( specs["viewfactor"].contains( "seed" ) )
+                M_seed = specs["viewfactor"]["seed"].get<unsigned int>();
+            else
+                M_seed = std::random_device{}();
             if(this->list_of_bdys_.empty())
                 M_submesh = createSubmesh(_mesh=mesh,_range=boundaryfaces(mesh),_update=MESH_ADD_ELEMENTS_INFO);
             else
@@ -211,19 +228,18 @@ public:
             // std::cout <<      M_markers_string << std::endl;
             // std::cout <<      M_markers_int << std::endl;
 
-            std::random_device rd;  // Will be used to obtain a seed for the random number engine
-            std::random_device rd2;  // Will be used to obtain a seed for the random number engine
-            std::mt19937 gen(rd()); // Standard mersenne_twister_engine seeded with rd()
-            std::mt19937 gen2(rd2()); // Standard mersenne_twister_engine seeded with rd()
-            gen.seed(std::chrono::high_resolution_clock::now()
-                                   .time_since_epoch()
-                                   .count());
-            gen2.seed(std::chrono::high_resolution_clock::now()
-                                   .time_since_epoch()
-                                   .count());
-
-            M_gen=gen;
-            M_gen2=gen2;
+            // index in the list of markers of each primitive of the bvh (-1 if not in the list)
+            M_primitive_marker_index.resize( M_bvh_tree->primitiveInfo().size(), -1 );
+            for ( std::size_t k = 0; k < M_primitive_marker_index.size(); ++k )
+            {
+                auto const& meshEntity = M_bvh_tree->primitiveInfo( k ).meshEntity();
+                if ( !meshEntity.hasMarker() )
+                    continue;
+                auto itMarker = std::find( M_markers_int.begin(), M_markers_int.end(), meshEntity.marker().value() );
+                if ( itMarker != M_markers_int.end() )
+                    M_primitive_marker_index[k] = std::distance( M_markers_int.begin(), itMarker );
+            }
+            M_view_factors_error = Eigen::MatrixXd::Zero( this->list_of_bdys_.size(), this->list_of_bdys_.size() );
         }
     RayTracingViewFactor( const RayTracingViewFactor& ) = default;
     RayTracingViewFactor( RayTracingViewFactor&& ) = default;
@@ -241,10 +257,17 @@ public:
     std::vector<int> M_point_indices;
     Eigen::VectorXd M_view_factor_row;
     std::shared_ptr<bvh_type> M_bvh_tree;
-    std::random_device M_rd;  // Will be used to obtain a seed for the random number engine
-    std::random_device M_rd2;  // Will be used to obtain a seed for the random number engine
-    std::mt19937 M_gen; // Standard mersenne_twister_engine seeded with rd()
-    std::mt19937 M_gen2; // Standard mersenne_twister_engine seeded with rd2()
+    std::vector<int> M_primitive_marker_index;
+    double M_tolerance = 0.;
+    int M_NraysPerRound = 1;
+    std::string M_sampling = "qmc";
+    unsigned int M_seed = 0;
+    //! standard error of the view factors (estimated from the independent rounds)
+    Eigen::MatrixXd M_view_factors_error;
+    //! number of rays launched from each element of the markers
+    std::vector<int> M_Nrays_used;
+    //! persistent pool of threads used by all the markers
+    std::shared_ptr<ThreadPool> M_pool;
 
     Eigen::VectorXd get_random_point(matrix_node_type const& element_points)
     {
@@ -325,10 +348,18 @@ public:
 
     mesh_ptrtype mesh() {return M_mesh;}
     std::vector<std::string> markerNames(){return M_markers_string;}
+
+    //! standard error of the view factors computed by the last compute()
+    Eigen::MatrixXd const& viewFactorsError() const { return M_view_factors_error; }
+
+    //! number of rays launched from each element of the markers by the last compute()
+    std::vector<int> const& numberOfRaysUsed() const { return M_Nrays_used; }
+
     void compute(bool elementwise=false)
     {
         if(this->j_["viewfactor"]["type"]=="Raytracing")
         {
+            M_Nrays_used.assign( this->list_of_bdys_.size(), 0 );
             for(int i=0;i<this->list_of_bdys_.size();i++)
             {
                 // Surface with marker i launches rays to surface of marker j
@@ -342,107 +373,258 @@ public:
         }
     };
 
+    /**
+     * compute the view factors from the surface \p marker to all the markers.
+     *
+     * The rays are launched by rounds : in each round, M_NraysPerRound rays are
+     * launched from each element and the rows obtained are independent estimates
+     * of the view factors (the samples of each round are randomised independently).
+     * The standard error is estimated from these rounds, and the computation stops
+     * when it is below the tolerance or when M_Nrays rays per element are launched.
+     * The work items (a chunk of elements for one round) are processed by a
+     * persistent thread pool.
+     *
+     * In parallel, each process launches the rays of its elements, the rays are
+     * sent to all the processes and the closest hit among the processes is kept
+     * (as in BVH::intersect).
+     */
     Eigen::VectorXd computeViewFactor_bvh(std::string const& marker)
     {
-        int dim = M_mesh->dimension();
-        M_view_factor_row.setZero();
+        if constexpr ( tr_mesh_t::nRealDim != 3 )
+        {
+            throw std::logic_error( "raytracing view factors only implemented in 3D" );
+        }
+        else
+        {
+        int nMarkers = this->list_of_bdys_.size();
+        auto index_marker = std::distance( M_markers_string.begin(), std::find(M_markers_string.begin(),M_markers_string.end(),marker) );
+        auto const& worldComm = M_submesh->worldComm();
+        const rank_type nProc = worldComm.size();
+        const rank_type myRank = worldComm.rank();
+
+        // geometry of the emitting elements
+        std::vector<emitting_element_type> emitters;
+        auto rangeEmitting = markedelements(M_submesh,marker);
+        emitters.reserve( nelements( rangeEmitting ) );
+        double totalArea = 0.;
+        for ( auto const& eltWrap : rangeEmitting )
+        {
+            auto const& elt = unwrap_ref( eltWrap );
+            emitting_element_type e;
+            for ( int i = 0; i < 3; ++i )
+            {
+                e.p1(i) = elt.point(0).node()[i];
+                e.u(i) = elt.point(2).node()[i] - e.p1(i);
+                e.v(i) = elt.point(1).node()[i] - e.p1(i);
+            }
+            // same orientation as the previous implementation : (p3-p1)x(p2-p1)
+            Eigen::Vector3d n = e.u.cross( e.v );
+            e.area = 0.5*n.norm();
+            e.normal = n.normalized();
+            // orthonormal frame around the normal
+            Eigen::Vector3d a = std::abs( e.normal(0) ) < 0.9 ? Eigen::Vector3d::UnitX() : Eigen::Vector3d::UnitY();
+            e.t1 = e.normal.cross( a ).normalized();
+            e.t2 = e.normal.cross( e.t1 );
+            // the samples only depend on the element id, not on the partitioning
+            e.id = elt.id();
+            totalArea += e.area;
+            emitters.push_back( std::move( e ) );
+        }
 
-        auto ray_submesh = createSubmesh(_mesh=M_submesh,_range=markedelements(M_submesh,marker));
-        std::vector<double> random_direction(dim);
+        this->areas_[index_marker] = integrate(_range=rangeEmitting,_expr=cst(1.)).evaluate()(0,0);
 
+        Eigen::VectorXd row = Eigen::VectorXd::Zero( nMarkers );
+        M_view_factors_error.row( index_marker ).setZero();
+        if ( nProc > 1 )
+            totalArea = mpi::all_reduce( worldComm, totalArea, std::plus<double>() );
+        if ( totalArea <= 0 )
+            return row;
 
-        for(auto const &el : ray_submesh->elements()) // from each element of the submesh, launch M_Nrays randomly oriented
-        {
-            auto rays_from_element = [&](int n_rays_thread){
-                Eigen::VectorXd row_vf_matrix(M_view_factor_row.size());
-                row_vf_matrix.setZero();
-                // for(int i=0;i<M_Nrays;i++)
-                for(int i=0;i<n_rays_thread;i++)
-                {
+        if ( !M_pool || M_pool->size() != (std::size_t)std::max( M_Nthreads, 1 ) )
+            M_pool = std::make_shared<ThreadPool>( std::max( M_Nthreads, 1 ) );
+
+        int nRaysPerRound = std::max( 1, std::min( M_NraysPerRound, M_Nrays ) );
+        int nRoundsMax = std::max( 1, ( M_Nrays + nRaysPerRound - 1 ) / nRaysPerRound );
+        bool useQMC = M_sampling == "qmc";
 
-                    // Construct the ray emitting from a random point of the element
-                    auto random_origin = get_random_point(el.second.vertices());
+        // chunks of elements : several work items per thread to balance the load
+        std::size_t nEmitters = emitters.size();
+        std::size_t nChunks = std::min( nEmitters, 4*M_pool->size() );
 
-                    Eigen::VectorXd rand_dir(dim);
-                    Eigen::VectorXd p1(dim),p2(dim),p3(dim),origin(3);
+        // closest hit of a ray : distance and index of the marker hit (-1 if none
+        // or if the primitive is not in the markers)
+        using hit_type = std::pair<double,int>;
+        const hit_type noHit( std::numeric_limits<double>::max(), -1 );
+        auto closerHit = []( hit_type const& a, hit_type const& b ) { return b.first < a.first ? b : a; };
+
+        std::vector<hit_type> hits( nEmitters*nRaysPerRound );
+        // rays of the round, sent to the other processes
+        std::vector<bvh_ray_type> raysRound( nProc > 1 ? nEmitters*nRaysPerRound : 0 );
+
+        auto traceRays = [this,&noHit]( bvh_ray_type const* rays, std::size_t nRays, hit_type* rayHits )
+            {
+                std::vector<typename bvh_type::rayintersection_result_type> res( nRays );
+                M_bvh_tree->intersectClosest( rays, nRays, res.data() );
+                for ( std::size_t k = 0; k < nRays; ++k )
+                {
+                    if ( res[k].primitiveId() == invalid_v<typename bvh_type::index_type> )
+                        rayHits[k] = noHit;
+                    else
+                        rayHits[k] = hit_type( res[k].distance(), M_primitive_marker_index[res[k].primitiveId()] );
+                }
+            };
 
-                    if(dim==3)
+        auto processChunk = [this,&emitters,&hits,&raysRound,&traceRays,nRaysPerRound,useQMC,nProc]( int round, std::size_t eltStart, std::size_t eltEnd )
+            {
+                std::vector<bvh_ray_type> rays( nRaysPerRound );
+                for ( std::size_t k = eltStart; k < eltEnd; ++k )
+                {
+                    auto const& e = emitters[k];
+                    std::seed_seq seq{ M_seed, (unsigned int)round, (unsigned int)e.id };
+                    std::mt19937 gen( seq );
+                    std::uniform_real_distribution<double> unif( 0., 1. );
+                    // random shift of the rank-1 lattice for this element and this round
+                    std::array<double,4> shift = { unif( gen ), unif( gen ), unif( gen ), unif( gen ) };
+                    for ( int i = 0; i < nRaysPerRound; ++i )
                     {
-                        for(int i=0;i<dim;i++)
-                        {
-                            p1(i)=column(el.second.vertices(), 0)[i];
-                            p2(i)=column(el.second.vertices(), 1)[i];
-                            p3(i)=column(el.second.vertices(), 2)[i];
-                            origin(i) = random_origin[i];
-                            rand_dir(i) = random_direction[i];
-                        }
-                        auto element_normal = ((p3-p1).head<3>()).cross((p2-p1).head<3>());
-                        element_normal.normalize();
-                        getRandomDirection(random_direction,M_gen,M_gen2,element_normal);
-                        for(int i=0;i<dim;i++)
+                        std::array<double,4> xi;
+                        for ( int d = 0; d < 4; ++d )
                         {
-                            rand_dir(i) = random_direction[i];
+                            if ( useQMC )
+                            {
+                                double x = shift[d] + (i+1)*S_kroneckerAlpha[d];
+                                xi[d] = x - std::floor( x );
+                            }
+                            else
+                                xi[d] = unif( gen );
                         }
-                        if(rand_dir.dot(element_normal)<0.) // if the ray direction is inward to the emitting surface, invert its direction
+                        // uniform point in the triangle (parallelogram folded on the diagonal)
+                        double s = xi[0], t = xi[1];
+                        if ( s + t > 1 )
                         {
-                            rand_dir(0) = rand_dir(0) * (-1.);
-                            rand_dir(1) = rand_dir(1) * (-1.);
-                            rand_dir(2) = rand_dir(2) * (-1.);
+                            s = 1 - s;
+                            t = 1 - t;
                         }
-
+                        typename bvh_ray_type::vec_t origin = e.p1 + s*e.u + t*e.v;
+                        // cosine weighted direction around the normal
+                        double phi = 2.*M_PI*xi[2];
+                        double sinTheta = std::sqrt( xi[3] );
+                        double cosTheta = std::sqrt( std::max( 0., 1. - xi[3] ) );
+                        typename bvh_ray_type::vec_t dir = sinTheta*std::cos( phi )*e.t1 + sinTheta*std::sin( phi )*e.t2 + cosTheta*e.normal;
+                        rays[i] = bvh_ray_type( origin, dir, 1e-8 ); // warning, put a minimal distance > 0
                     }
-                    Eigen::VectorXd pQ1(3),pQ2(3),pQ3(3),pQ4(3),normal(3);
+                    traceRays( rays.data(), rays.size(), hits.data()+k*nRaysPerRound );
+                    if ( nProc > 1 )
+                        std::copy( rays.begin(), rays.end(), raysRound.begin()+k*nRaysPerRound );
+                }
+            };
 
-                    bvh_ray_type ray(origin,rand_dir,1e-8); // warning, put a minimal distance > 0
+        // each round gives an independent estimate of the row
+        Eigen::VectorXd sum = Eigen::VectorXd::Zero( nMarkers );
+        Eigen::VectorXd sum2 = Eigen::VectorXd::Zero( nMarkers );
+        Eigen::VectorXd error = Eigen::VectorXd::Zero( nMarkers );
+        int nRounds = 0;
+        std::vector<std::future<void>> futures;
+        futures.reserve( nChunks );
+        std::vector<std::vector<bvh_ray_type>> raysByProc;
+        std::vector<std::vector<hit_type>> hitsToSend( nProc ), hitsRecv;
+        while ( nRounds < nRoundsMax )
+        {
+            futures.clear();
+            for ( std::size_t c = 0; c < nChunks; ++c )
+            {
+                std::size_t eltStart = ( c*nEmitters )/nChunks;
+                std::size_t eltEnd = ( (c+1)*nEmitters )/nChunks;
+                futures.push_back( M_pool->submit( [&processChunk,nRounds,eltStart,eltEnd]{ processChunk( nRounds, eltStart, eltEnd ); } ) );
+            }
+            for ( auto& f : futures )
+                f.get();
 
-                    auto rayIntersectionResult = M_bvh_tree->intersect(_ray=ray) ;
-                    if ( !rayIntersectionResult.empty() )
+            if ( nProc > 1 )
+            {
+                // trace the rays of the other processes with the primitives of this process
+                // and keep the closest hit of each ray on the process which launched it
+                mpi::all_gather( worldComm, raysRound, raysByProc );
+                for ( rank_type p = 0; p < nProc; ++p )
+                {
+                    hitsToSend[p].resize( p == myRank ? 0 : raysByProc[p].size() );
+                    std::size_t nRaysProc = hitsToSend[p].size();
+                    std::size_t nChunksProc = std::min( nRaysProc, 4*M_pool->size() );
+                    futures.clear();
+                    for ( std::size_t c = 0; c < nChunksProc; ++c )
                     {
-                        auto const& prim = M_bvh_tree->primitiveInfo( rayIntersectionResult.front().primitiveId() );
-                        auto marker_index = prim.meshEntity().marker().value();
-
-                        // Find the marker's index corresponding to the element being intersected by the ray
-                        auto index_view_factor = std::find(M_markers_int.begin(), M_markers_int.end(), marker_index);
-
-                        // M_view_factor_row(std::distance(M_markers_int.begin(),index_view_factor))++;
-                        row_vf_matrix(std::distance(M_markers_int.begin(),index_view_factor))++;
-                    }
-                    else{
-                        //std::cout << "RAY NOT INTERSECTING: Rand origin" << ray.origin() << "rand_dir" <<  ray.dir() <<std::endl;
+                        std::size_t rayStart = ( c*nRaysProc )/nChunksProc;
+                        std::size_t rayEnd = ( (c+1)*nRaysProc )/nChunksProc;
+                        futures.push_back( M_pool->submit( [&traceRays,&raysByProc,&hitsToSend,p,rayStart,rayEnd]{
+                                    traceRays( raysByProc[p].data()+rayStart, rayEnd-rayStart, hitsToSend[p].data()+rayStart ); } ) );
                     }
+                    for ( auto& f : futures )
+                        f.get();
                 }
-                return row_vf_matrix;
-            };
-                std::vector<int> n_rays_thread;
-                n_rays_thread.push_back(M_Nrays - (M_Nthreads-1) * (int)(M_Nrays / M_Nthreads));
-                for(int t= 1; t < M_Nthreads; ++t){
-                   n_rays_thread.push_back( M_Nrays / M_Nthreads);
-                }
-                // Used to store the future results
-                std::vector<std::future<Eigen::VectorXd>> futures;
-                for(int t = 0; t < M_Nthreads; ++t){
-                    // Start a new asynchronous task
-                    // std::cout << n_rays_thread[t] << std::endl;
-                    futures.emplace_back(std::async(std::launch::async, rays_from_element, n_rays_thread[t]));
+                mpi::all_to_all( worldComm, hitsToSend, hitsRecv );
+                for ( rank_type p = 0; p < nProc; ++p )
+                {
+                    if ( p == myRank )
+                        continue;
+                    CHECK( hitsRecv[p].size() == hits.size() ) << "invalid number of hits received from process " << p;
+                    std::transform( hits.begin(), hits.end(), hitsRecv[p].begin(), hits.begin(), closerHit );
                 }
+            }
 
-
-                for(std::future<Eigen::VectorXd>& f : futures){
-                    // Wait for the result to be ready
-                    M_view_factor_row += f.get();
+            Eigen::VectorXd rowRound = Eigen::VectorXd::Zero( nMarkers );
+            for ( std::size_t k = 0; k < nEmitters; ++k )
+            {
+                double w = emitters[k].area/nRaysPerRound;
+                for ( int i = 0; i < nRaysPerRound; ++i )
+                {
+                    int j = hits[k*nRaysPerRound+i].second;
+                    if ( j >= 0 )
+                        rowRound( j ) += w;
                 }
-
+            }
+            if ( nProc > 1 )
+                mpi::all_reduce( worldComm, mpi::inplace( rowRound.data() ), nMarkers, std::plus<double>() );
+            rowRound /= totalArea;
+            sum += rowRound;
+            sum2 += rowRound.cwiseProduct( rowRound );
+            ++nRounds;
+
+            if ( nRounds > 1 )
+            {
+                Eigen::VectorXd mean = sum/nRounds;
+                Eigen::VectorXd variance = ( ( sum2 - nRounds*mean.cwiseProduct( mean ) )/( nRounds-1 ) ).cwiseMax( 0. );
+                error = ( variance/nRounds ).cwiseSqrt();
+                if ( M_tolerance > 0 && nRounds >= S_minRounds && error.maxCoeff() <= M_tolerance )
+                    break;
+            }
         }
-        M_view_factor_row /=(1.*M_Nrays*ray_submesh->numElements());
-        //std::cout << M_Nrays*ray_submesh->numElements() << std::endl;
+        row = sum/nRounds;
+        M_view_factors_error.row( index_marker ) = error.transpose();
+        M_Nrays_used[index_marker] = nRounds*nRaysPerRound;
+        M_view_factor_row = row;
+        VLOG(1) << fmt::format( "[RayTracingViewFactor] marker {} : {} rounds of {} rays per element, standard error {}", marker, nRounds, nRaysPerRound, error.maxCoeff() );
 
-        auto index_marker =std::find(M_markers_string.begin(),M_markers_string.end(),marker);
-        this->areas_[std::distance(M_markers_string.begin(),index_marker)] = integrate(_range=elements(ray_submesh),_expr=cst(1.)).evaluate()(0,0);
+        return row;
+        }
+    }
 
-        //std::cout << "Areas_" << marker << " " << this->areas_[std::distance(M_markers_string.begin(),index_marker)] << std::endl;
+private:
+    //! precomputed geometry of an emitting triangle
+    struct emitting_element_type
+    {
+        Eigen::Vector3d p1, u, v, normal, t1, t2;
+        double area = 0.;
+        index_type id = 0;
+    };
 
-        return M_view_factor_row;
-    }
+    //! minimal number of rounds before checking the tolerance
+    static constexpr int S_minRounds = 4;
 
+    //! generator of the 4D Kronecker sequence (R-sequence) : alpha_k = 1/phi^k with phi^5 = phi + 1
+    static constexpr double S_kroneckerPhi = 1.1673039782614187;
+    static constexpr std::array<double,4> S_kroneckerAlpha = { 1./S_kroneckerPhi,
+                                                               1./(S_kroneckerPhi*S_kroneckerPhi),
+                                                               1./(S_kroneckerPhi*S_kroneckerPhi*S_kroneckerPhi),
+                                                               1./(S_kroneckerPhi*S_kroneckerPhi*S_kroneckerPhi*S_kroneckerPhi) };
 };
 }
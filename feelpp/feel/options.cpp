@@ -99,6 +99,11 @@ generic_options()
         ( "show-preconditioner-options", "show on the fly the preconditioner options used" )
         ( "serialization-library", po::value<std::string>()->default_value("boost"), "Library used for serialization" )
         ( "display-stats", po::value<bool>()->default_value(false), "display statistics (timers, iterations counts...)" )
+        ( "profiler", po::value<bool>()->default_value(false), "enable the profiler of nested regions (summary reduced over the ranks at exit)" )
+        ( "profiler.summary.filename", po::value<std::string>()->default_value("profiler-summary.txt"), "file of the profiler summary, relative to the application repository (empty: not saved)" )
+        ( "profiler.trace", po::value<bool>()->default_value(false), "record the calls of the profiler regions and save them in the Chrome trace format" )
+        ( "profiler.trace.filename", po::value<std::string>()->default_value("profiler-trace.json"), "file of the profiler trace, relative to the application repository" )
+        ( "profiler.trace.max-events", po::value<int>()->default_value(1000000), "maximum number of trace events recorded by thread" )
         ( "subdir.expr", po::value<std::string>()->default_value("exprs"), "subdirectory for expressions" )
         ;
     return generic;
@@ -121,6 +126,11 @@ functionspace_options( std::string const& prefix )
     po::options_description _options( "Function Space options" );
     _options.add_options()
         ( prefixvm( prefix, "connect").c_str(), Feel::po::value<bool>()->default_value(false), "Update dof when MESH_CHANGE_COORD ?" )
+        ( prefixvm( prefix, "stencil.flat-csr").c_str(), Feel::po::value<bool>()->default_value(true), "build the sparsity pattern of non extended stencils in flat CSR form (count, prefix sum, fill, sort+unique)" )
+        ( prefixvm( prefix, "stencil.flat-csr.nthreads").c_str(), Feel::po::value<int>()->default_value(1), "number of threads used to sort and compact the rows of the flat CSR sparsity pattern" )
+        ( prefixvm( prefix, "stencil.cache").c_str(), Feel::po::value<bool>()->default_value(false), "keep the flat CSR sparsity patterns to reuse or patch them when the function spaces are rebuilt (remeshing, ALE)" )
+        ( prefixvm( prefix, "stencil.cache.size").c_str(), Feel::po::value<int>()->default_value(4), "maximum number of sparsity patterns kept by pair of function space types" )
+        ( prefixvm( prefix, "stencil.cache.incremental-ratio").c_str(), Feel::po::value<double>()->default_value(0.2), "maximum ratio of changed couplings to patch a cached sparsity pattern instead of rebuilding it" )
         ;
     return _options;
 }
@@ -223,7 +233,8 @@ mesh_options( std::string const& prefix )
         ( prefixvm( prefix,"mesh.save.formats" ).c_str(), Feel::po::value<std::vector<std::string>>()->default_value( {"json+h5","msh"} ), "format of the mesh: json+h5, msh" )
         ( prefixvm( prefix,"mesh.load.enable" ).c_str(), Feel::po::value<bool>()->default_value( false ), "enable loading mesh from disk, overriding file name extension" )
         ( prefixvm( prefix,"mesh.load.format" ).c_str(), Feel::po::value<std::string>()->default_value( "json+h5" ), "file format to load: msh, json" )
-        ( prefixvm( prefix,"mesh.scale" ).c_str(), Feel::po::value<double>()->default_value( 1 ), "scale the mesh after loading" );
+        ( prefixvm( prefix,"mesh.scale" ).c_str(), Feel::po::value<double>()->default_value( 1 ), "scale the mesh after loading" )
+        ( prefixvm( prefix,"mesh.update.nthreads" ).c_str(), Feel::po::value<int>()->default_value( 1 ), "number of threads used to build the faces and edges of the mesh (0: hardware concurrency)" );
 
     return _options;
 }
@@ -250,6 +261,7 @@ gmsh_options( std::string const& prefix )
         ( prefixvm( prefix,"gmsh.use-json" ).c_str(), Feel::po::value<bool>()->default_value( false ), "use json/hdf5 file if it exists, instead of the Gmsh files (geo or msh)" )
         ( prefixvm( prefix,"gmsh.partition" ).c_str(), Feel::po::value<bool>()->default_value( false ), "Partition Gmsh mesh once generated or loaded" )
         ( prefixvm( prefix,"gmsh.respect_partition" ).c_str(), Feel::po::value<bool>()->default_value( false ), "true to respect partitioning when mesh is loaded, false to ensure that partition is within the number of processors" )
+        ( prefixvm( prefix,"gmsh.mmap" ).c_str(), Feel::po::value<bool>()->default_value( true ), "read msh files through a memory map, the blocks of the other partitions are skipped" )
         ( prefixvm( prefix,"gmsh.npartitions" ).c_str(), Feel::po::value<int>()->default_value( 1 ), "Number of partitions" )
         ( prefixvm( prefix,"gmsh.partitioner" ).c_str(), Feel::po::value<int>()->default_value( GMSH_PARTITIONER_DEFAULT ), "Gmsh partitioner (1=CHACO, 2=METIS)" )
         ( prefixvm( prefix,"gmsh.verbosity" ).c_str(), Feel::po::value<int>()->default_value( 2 ), "Gmsh verbosity level (0:silent except fatal errors, 1:+errors, 2:+warnings, 3:+direct, 4:+info except status bar, 5:normal, 99:debug)" )
@@ -347,10 +359,10 @@ parallel_options( std::string const& prefix )
 {
     po::options_description _options( "Parallel " + prefix + " options" );
     _options.add_options()
-#if defined(FEELPP_HAS_HARTS)
         ( prefixvm( prefix,"parallel.cpu.enable" ).c_str(), Feel::po::value<bool>()->default_value( false ), "Enable the use of additional cores for parallelization" )
-        ( prefixvm( prefix,"parallel.cpu.impl" ).c_str(), Feel::po::value<std::string>()->default_value( "" ), "Specify the implementation for multithreading" )
+        ( prefixvm( prefix,"parallel.cpu.impl" ).c_str(), Feel::po::value<std::string>()->default_value( "" ), "Specify the implementation for multithreading (coloring: threaded assembly of forms over graph-coloured element ranges)" )
         ( prefixvm( prefix,"parallel.cpu.restrict" ).c_str(), Feel::po::value<int>()->default_value( 0 ), "Restrict the multithreading to N additional cores per MPI process (0: guess the maximum number of usable cores)" )
+#if defined(FEELPP_HAS_HARTS)
 #if defined(HARTS_HAS_OPENCL)
         ( prefixvm( prefix,"parallel.opencl.enable" ).c_str(), Feel::po::value<bool>()->default_value( false ), "Enable the use of OpenCL for parallelization" )
         ( prefixvm( prefix,"parallel.opencl.device" ).c_str(), Feel::po::value<std::string>()->default_value("cpu"), "Specify the device to use for OpenCL (Valid entries: cpu or gpu" )
@@ -722,6 +734,9 @@ crbOptions( std::string const& prefix )
         ( prefixvm( prefix, "crb.fixedpoint.aitken").c_str(),Feel::po::value<bool>()->default_value( true ), "use Aitken relaxtion algorithm in nonlinear fixpoint solver" )
 
         ( prefixvm( prefix, "crb.fixedpoint.maxit").c_str(),Feel::po::value<int>()->default_value( 20 ), "nb iteration max for the fixed point (online part)" )
+        ( prefixvm( prefix, "crb.online.batch").c_str(),Feel::po::value<bool>()->default_value( true ), "evaluate the samples of steady linear models without error estimation with the batched online evaluation (runBatch)" )
+        ( prefixvm( prefix, "crb.online.batch.nthreads").c_str(),Feel::po::value<int>()->default_value( 1 ), "number of threads of the batched online evaluation (runBatch)" )
+        ( prefixvm( prefix, "crb.online.batch.size").c_str(),Feel::po::value<int>()->default_value( 64 ), "number of parameters by block in the batched online evaluation (runBatch)" )
         ( prefixvm( prefix, "crb.fixedpoint.increment-tol").c_str(),Feel::po::value<double>()->default_value( 1e-10 ), "tolerance on solution for fixed point (online part)" )
         ( prefixvm( prefix, "crb.fixedpoint.output-tol").c_str(),Feel::po::value<double>()->default_value( 1e-10 ), "tolerance on output for fixed point (online part)" )
         ( prefixvm( prefix, "crb.fixedpoint.verbose").c_str(),Feel::po::value<bool>()->default_value( false ), "fixed point verbose if true" )
@@ -863,6 +878,7 @@ ginac_options( std::string const& prefix )
     _options.add_options()
     // solver options
         ( prefixvm( prefix,"ginac.strict-parser" ).c_str(), Feel::po::value<bool>()->default_value( false ), "enable strict parsing of GiNaC expressions, no extra variables/symbols can be defined if set to true" )
+        ( prefixvm( prefix,"ginac.compile" ).c_str(), Feel::po::value<bool>()->default_value( false ), "compile GiNaC expressions into shared libraries with the system compiler (cached in the expression repository) instead of evaluating them in-process" )
         ;
     return _options;
 }
@@ -973,6 +989,10 @@ exporter_options( std::string const& prefix )
         //  geometry
         ( prefixvm( prefix,"exporter.geometry" ).c_str(), Feel::po::value<std::string>()->default_value( "change_coords_only" ), "Mesh change type, this option tells the exporter whether the mesh does not change(static), changes only the coordinates of the vertices (change_coords_only) or changes entirely (change). Choices: change_coords_only, change, static" )
 
+        // asynchronous save
+        ( prefixvm( prefix,"exporter.async" ).c_str(), Feel::po::value<bool>()->default_value( false ), "write the exported files in a background thread (needs MPI_THREAD_MULTIPLE, synchronous otherwise)" )
+        ( prefixvm( prefix,"exporter.async.queue-size" ).c_str(), Feel::po::value<int>()->default_value( 2 ), "maximum number of pending asynchronous saves" )
+
         // prefix options
         ( prefixvm( prefix,"exporter.prefix" ).c_str(), Feel::po::value<std::string>()->default_value( prefix ), "prefix for exported files" )
 
@@ -1214,9 +1234,7 @@ feel_options( std::string const& prefix  )
                    /* gmsh domain options */
                    .add( gmsh_domain_options( prefix ) )
         #
-#if defined(FEELPP_HAS_HARTS)
                    .add( parallel_options( prefix ) )
-#endif
 
                    /* ginac options */
                    .add( ginac_options( prefix ) )
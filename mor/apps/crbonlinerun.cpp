@@ -306,6 +306,7 @@ int main(int argc, char**argv )
             ( "sampling.size", po::value<int>()->default_value( 10 ), "size of sampling" )
             ( "sampling.type", po::value<std::string>()->default_value( "random" ), "type of sampling" )
             ( "rb-dim", po::value<int>()->default_value( -1 ), "reduced basis dimension used (-1 use the max dim)" )
+            ( "print-rb-matrix", po::value<bool>()->default_value( false ), "write the reduced matrix of each parameter (disables the batched evaluation)" )
             ( "output_results.save.path", po::value<std::string>(), "output_results.save.path" )
             ( "output_results.precision", po::value<int>()->default_value( 6 ), "float precision for output results")
             ( "output_results.print", po::value<bool>()->default_value( true ), "print results in shell")
@@ -314,6 +315,7 @@ int main(int argc, char**argv )
             ( "compare", po::value<std::string>(), "compare results from query in mongodb DB feelpp.crbdb" )
             ( "list", "list registered DB in mongoDB  in feelpp.crbdb" )
             ( "export-solution", po::value<bool>()->default_value(false), "export the solutions for visualization")
+            ( "export-online-db", po::value<std::string>(), "directory where the binary reduced databases (.rbdb) of the models are written" )
             ;
         po::options_description crbonlinerunliboptions( "crb online run lib options" );
     #if 1
@@ -339,9 +341,23 @@ int main(int argc, char**argv )
 
         MORModels ms{ js };
         ms.load();
+        if ( Environment::vm().count( "export-online-db" ) )
+        {
+            fs::path dir( Environment::expand( soption(_name="export-online-db") ) );
+            if ( Environment::isMasterRank() && !fs::exists( dir ) )
+                fs::create_directories( dir );
+            Environment::worldComm().barrier();
+            for ( auto const& m : ms )
+            {
+                std::string filename = ( dir / fmt::format( "{}{}.rbdb", m.name, m.output.empty()? "" : "-"+m.output ) ).string();
+                m.saveOnlineDB( filename, ioption(_name="rb-dim") );
+                if ( Environment::isMasterRank() )
+                    std::cout << " . write binary reduced database " << filename << std::endl;
+            }
+        }
         MORTable table( ms );
         ms.addObserver( std::make_shared<MORTable>( table ) );
-        ms.run(setupSampling( ms ), nl::json{ { "N", ioption(_name="rb-dim") }, { "print_rb_matrix", true }, { "tolerance", 1e-2 } } );
+        ms.run(setupSampling( ms ), nl::json{ { "N", ioption(_name="rb-dim") }, { "print_rb_matrix", boption(_name="print-rb-matrix") }, { "tolerance", 1e-2 } } );
 #if 0
         if ( Environment::vm().count( "list" )  )
         {
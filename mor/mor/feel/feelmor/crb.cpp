@@ -75,6 +75,9 @@ crbOptions( std::string const& prefix )
 
         ( "crb.use-newton",Feel::po::value<bool>()->default_value( false ), "use newton algorithm (need to provide a jacobian and a residual)" )
         ( "crb.fixedpoint.maxit",Feel::po::value<int>()->default_value( 10 ), "nb iteration max for the fixed point (online part)" )
+        ( "crb.online.batch",Feel::po::value<bool>()->default_value( true ), "evaluate the samples of steady linear models without error estimation with the batched online evaluation (runBatch)" )
+        ( "crb.online.batch.nthreads",Feel::po::value<int>()->default_value( 1 ), "number of threads of the batched online evaluation (runBatch)" )
+        ( "crb.online.batch.size",Feel::po::value<int>()->default_value( 64 ), "number of parameters by block in the batched online evaluation (runBatch)" )
         ( "crb.fixedpoint.increment-tol",Feel::po::value<double>()->default_value( 1e-10 ), "tolerance on solution for fixed point (online part)" )
         ( "crb.fixedpoint.output-tol",Feel::po::value<double>()->default_value( 1e-10 ), "tolerance on output for fixed point (online part)" )
         ( "crb.fixedpoint.verbose",Feel::po::value<bool>()->default_value( false ), "fixed point verbose if true" )
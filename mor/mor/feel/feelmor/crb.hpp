@@ -76,6 +76,7 @@
 
 #include <feel/feelmor/crbenums.hpp>
 #include <feel/feelmor/crbdata.hpp>
+#include <feel/feelmor/crbaffinetensors.hpp>
 #include <feel/feelmor/options.hpp>
 #include <feel/feelmor/parameterspace.hpp>
 #include <feel/feelmor/crbdb.hpp>
@@ -1314,6 +1315,8 @@ public:
          int N = -1,
          bool print_rb_matrix=false )
         {
+            if ( !print_rb_matrix && this->canRunBatch() )
+                return this->runBatchResults( S, N );
             std::vector<CRBResults> res;
             res.reserve( S.size() );
             for( auto const& mu : S )
@@ -1324,6 +1327,136 @@ public:
             return res;
         }
 
+    /**
+     * \return true if run() on a sample can use the batched evaluation
+     * runBatch() (option \c crb.online.batch) : steady linear model without
+     * error bound, dual problem or extra online computations, the results
+     * are then the ones of run() on each parameter
+     */
+    bool canRunBatch() const
+        {
+            return boption(_prefix=M_prefix,_name="crb.online.batch") &&
+                M_model->isSteady() && M_model->isLinear() &&
+                M_error_type == CRB_NO_RESIDUAL && !M_solve_dual_problem &&
+                !( M_SER_errorEstimation && M_SER_useGreedyInRb ) &&
+                !M_computeMatrixInfo && !M_compute_variance && !M_save_output_behavior;
+        }
+
+    /**
+     * evaluate the sample \p S with runBatch() and return the results in the
+     * layout of run() (see canRunBatch())
+     */
+    std::vector<CRBResults>
+    runBatchResults( std::vector<parameter_type> const& S, int N = -1 )
+        {
+            auto batch = this->runBatch( S, N );
+            int Nwn = batch.coefficients.rows();
+            std::vector<CRBResults> res;
+            res.reserve( S.size() );
+            for ( int p = 0; p < int( S.size() ); ++p )
+            {
+                std::vector<vectorN_type> uN( 1, batch.coefficients.col( p ) );
+                std::vector<vectorN_type> uNdu( 1, vectorN_type::Zero( Nwn ) ), uNold( uNdu ), uNduold( uNdu );
+                std::vector<double> output_vector( 1, batch.outputs( p ) );
+                // no error estimation (CRB_NO_RESIDUAL)
+                std::vector<double> output_upper_bound( 1, -1 );
+                std::vector<std::vector<double>> primal_coefficients, dual_coefficients;
+                auto upper_bounds = boost::make_tuple( output_upper_bound, 0., 0., primal_coefficients, dual_coefficients );
+                auto solutions = boost::make_tuple( uN, uNdu, uNold, uNduold );
+                CRBResults r( boost::make_tuple( output_vector, double( Nwn ), solutions, boost::make_tuple( 0., 0. ), 0., 0., upper_bounds ) );
+                r.setParameter( S[p] );
+                res.push_back( std::move( r ) );
+            }
+            return res;
+        }
+
+    /**
+     * evaluate the reduced basis approximation for all the parameters of \p S
+     * with the packed affine decomposition (steady linear models only) : the
+     * parameters are processed by blocks of \c crb.online.batch.size on
+     * \c crb.online.batch.nthreads threads
+     *
+     * \return the coefficients, the outputs and, with the residual error
+     * estimator, the primal residuals of each parameter
+     */
+    CRBBatchResults
+    runBatch( std::vector<parameter_type> const& S, int N = -1 )
+        {
+            CHECK( M_model->isSteady() && M_model->isLinear() ) << "runBatch requires a steady linear model";
+            if ( N <= 0 || N > M_N )
+                N = M_N;
+            this->packAffineTensors( N );
+
+            // the coefficients of the affine decompositions are computed sequentially
+            int P = S.size();
+            matrixN_type betaA( M_affineTensors.nTermsA(), P );
+            matrixN_type betaF( M_affineTensors.nTermsF(), P );
+            matrixN_type betaL( M_affineTensors.nTermsL(), P );
+            beta_vector_type betaAqm, betaMqm;
+            std::vector<beta_vector_type> betaFqm;
+            for ( int p = 0; p < P; ++p )
+            {
+                boost::tie( betaMqm, betaAqm, betaFqm ) = M_model->computeBetaQm( S[p] );
+                int t = 0;
+                for ( size_type q = 0; q < M_Aqm_pr.size(); ++q )
+                    for ( size_type m = 0; m < M_Aqm_pr[q].size(); ++m )
+                        betaA( t++, p ) = betaAqm[q][m];
+                t = 0;
+                for ( size_type q = 0; q < M_Fqm_pr.size(); ++q )
+                    for ( size_type m = 0; m < M_Fqm_pr[q].size(); ++m )
+                        betaF( t++, p ) = betaFqm[0][q][m];
+                t = 0;
+                for ( size_type q = 0; q < M_Lqm_pr.size(); ++q )
+                    for ( size_type m = 0; m < M_Lqm_pr[q].size(); ++m )
+                        betaL( t++, p ) = betaFqm[M_output_index][q][m];
+            }
+
+            auto res = M_affineTensors.evaluate( betaA, betaF, betaL,
+                                                 ioption(_prefix=M_prefix,_name="crb.online.batch.nthreads"),
+                                                 ioption(_prefix=M_prefix,_name="crb.online.batch.size") );
+            VLOG(2) << "CRB::runBatch " << P << " parameters, N=" << N << ", " << res.evaluationsPerSecond << " evaluations/s";
+            return res;
+        }
+
+    /**
+     * write the reduced operators and outputs of dimension \p N (steady
+     * linear models only) in the binary database \p filename which can be
+     * mapped by CRBOnlineDB without Feel++ environment
+     */
+    void
+    saveOnlineDB( std::string const& filename, int N = -1 )
+        {
+            CHECK( M_model->isSteady() && M_model->isLinear() ) << "saveOnlineDB requires a steady linear model";
+            if ( N < 0 || N > M_N )
+                N = M_N;
+            this->packAffineTensors( N );
+            auto const& Dmu = this->Dmu();
+            auto muMin = Dmu->min(), muMax = Dmu->max();
+            std::vector<double> bmin( muMin.size() ), bmax( muMax.size() );
+            for ( int d = 0; d < muMin.size(); ++d )
+            {
+                bmin[d] = muMin( d );
+                bmax[d] = muMax( d );
+            }
+            if ( Environment::isMasterRank() )
+                M_affineTensors.save( filename, bmin, bmax );
+            LOG(INFO) << "CRB::saveOnlineDB " << filename << " N=" << N;
+        }
+
+    //! pack the reduced affine decomposition of dimension \p N if needed, the
+    //! packed copy is cleared when the reduced basis is built or loaded
+    void
+    packAffineTensors( int N )
+        {
+            if ( M_affineTensors.dimension() == N )
+                return;
+            tic();
+            M_affineTensors.pack( N, M_Aqm_pr, M_Fqm_pr, M_Lqm_pr );
+            if ( M_error_type == CRB_RESIDUAL || M_error_type == CRB_RESIDUAL_SCM )
+                M_affineTensors.packErrorEstimator( M_C0_pr, M_Lambda_pr, M_Gamma_pr );
+            toc("CRB::packAffineTensors", FLAGS_v>1);
+        }
+
     /**
      * run the certified reduced basis with P parameters and returns 1 output
      */
@@ -1717,6 +1850,9 @@ protected:
     std::vector < std::vector<vectorN_type> > M_Lqm_pr;
     std::vector < std::vector<vectorN_type> > M_Lqm_du;
 
+    //! packed copy of the reduced affine decomposition used by runBatch
+    CRBAffineTensors M_affineTensors;
+
     //initial guess
     std::vector < std::vector<vectorN_type> > M_InitialGuessV_pr;
 
@@ -2450,6 +2586,7 @@ typename CRB<TruthModelType>::convergence_type
 CRB<TruthModelType>::offline()
 {
     this->setOfflineStep( true );
+    M_affineTensors.clear();
 
     if ( this->worldComm().isMasterRank() )
     {
@@ -3130,6 +3267,7 @@ CRB<TruthModelType>::offline()
         if (boption(_prefix=M_prefix,_name="crb.visualize-basis"))
             this->exportBasisFunctions();
     }
+    M_affineTensors.clear();
     return M_rbconv;
 }
 
@@ -10777,6 +10915,8 @@ CRB<TruthModelType>::load( Archive & ar, const unsigned int version )
 
     LOG(INFO) <<"[CRB::load] version"<< version <<"\n";
 
+    M_affineTensors.clear();
+
 #if 0
     mesh_ptrtype mesh;
     space_ptrtype Xh;
@@ -11715,6 +11855,7 @@ CRB<TruthModelType>::setup( boost::property_tree::ptree const& ptree, size_type
     else if ( !dbDir.empty() )
         this->setDBDirectory( dbDir );
     this->setIsLoaded( false );
+    M_affineTensors.clear();
     CHECK( this->loadDB() ) << "crb load fails";
     if ( M_error_type == CRBErrorType::CRB_RESIDUAL_SCM )
     {
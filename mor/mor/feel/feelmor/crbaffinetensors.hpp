@@ -0,0 +1,306 @@
+//! -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+//!
+//! This file is part of the Feel++ library
+//!
+//! This library is free software; you can redistribute it and/or
+//! modify it under the terms of the GNU Lesser General Public
+//! License as published by the Free Software Foundation; either
+//! version 2.1 of the License, or (at your option) any later version.
+//!
+//! This library is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//! Lesser General Public License for more details.
+//!
+//! You should have received a copy of the GNU Lesser General Public
+//! License along with this library; if not, write to the Free Software
+//! Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//!
+//! @file
+//! @copyright 2023 Feel++ Consortium
+//!
+
+#ifndef FEELPP_CRBAFFINETENSORS_HPP
+#define FEELPP_CRBAFFINETENSORS_HPP 1
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/LU>
+
+#include <feel/feelcore/feel.hpp>
+#include <feel/feelmor/crbdata.hpp>
+#include <feel/feelmor/crbonlinedb.hpp>
+
+namespace Feel {
+
+//!
+//! results of the online evaluation of a block of parameters, one column or
+//! one entry by parameter
+//!
+struct CRBBatchResults
+{
+    //! reduced coefficients of the solutions
+    matrixN_type coefficients;
+    //! outputs
+    vectorN_type outputs;
+    //! squared dual norms of the primal residuals (empty if the error estimator is not available)
+    vectorN_type primalResiduals;
+    //! throughput of the evaluation
+    double evaluationsPerSecond = 0;
+};
+
+//!
+//! packed affine decomposition of a steady linear reduced problem
+//!
+//! The terms \f$(q,m)\f$ of each affine decomposition are numbered
+//! contiguously and stored in the columns of dense matrices: the column
+//! \f$t\f$ of the matrix of the operator terms is the (column major) reduced
+//! matrix \f$A_t\f$ of size \f$N\times N\f$. The reduced operators of a
+//! block of parameters are then assembled with a single matrix product with
+//! the coefficients of the parameters, and so are the terms of the residual
+//! error estimator.
+//!
+class CRBAffineTensors
+{
+public:
+    //! reduced dimension
+    int dimension() const { return M_N; }
+    int nTermsA() const { return M_A.cols(); }
+    int nTermsF() const { return M_F.cols(); }
+    int nTermsL() const { return M_L.cols(); }
+    //! \return true if the terms of the residual error estimator are packed
+    bool hasErrorEstimator() const { return M_Gamma.size() > 0; }
+
+    //! remove the packed terms (reduced basis rebuilt or reloaded)
+    void clear()
+        {
+            M_N = 0;
+            M_mA.clear();
+            M_mF.clear();
+            M_mL.clear();
+            for ( auto* m : { &M_A, &M_F, &M_L, &M_C0, &M_Lambda, &M_Gamma } )
+                m->resize( 0, 0 );
+        }
+
+    //!
+    //! pack the reduced operator, right hand side and output terms
+    //! \p Aqm[q][m], \p Fqm[q][m], \p Lqm[q][m] restricted to the first \p N basis functions
+    //!
+    template<typename AqmT, typename FqmT, typename LqmT>
+    void pack( int N, AqmT const& Aqm, FqmT const& Fqm, LqmT const& Lqm )
+        {
+            M_N = N;
+            M_mA = nTerms( Aqm );
+            M_mF = nTerms( Fqm );
+            M_mL = nTerms( Lqm );
+            auto A = flatten( Aqm );
+            auto F = flatten( Fqm );
+            auto L = flatten( Lqm );
+            M_A.resize( N*N, A.size() );
+            for ( int t = 0; t < int( A.size() ); ++t )
+                Eigen::Map<matrixN_type>( M_A.col( t ).data(), N, N ) = A[t]->block( 0, 0, N, N );
+            M_F.resize( N, F.size() );
+            for ( int t = 0; t < int( F.size() ); ++t )
+                M_F.col( t ) = F[t]->head( N );
+            M_L.resize( N, L.size() );
+            for ( int t = 0; t < int( L.size() ); ++t )
+                M_L.col( t ) = L[t]->head( N );
+            M_C0.resize( 0, 0 );
+            M_Lambda.resize( 0, 0 );
+            M_Gamma.resize( 0, 0 );
+        }
+
+    //!
+    //! pack the terms of the residual error estimator
+    //! \f$\|r(\mu)\|^2 = \sum f f C0 + \sum a f \Lambda\cdot u + \sum a a\, u^T \Gamma u\f$
+    //! given as \p C0[qf][mf][qf'][mf'], \p Lambda[qa][ma][qf][mf] and \p Gamma[qa][ma][qa'][ma']
+    //!
+    template<typename C0T, typename LambdaT, typename GammaT>
+    void packErrorEstimator( C0T const& C0, LambdaT const& Lambda, GammaT const& Gamma )
+        {
+            int N = M_N, nA = this->nTermsA(), nF = this->nTermsF();
+            M_C0.resize( nF, nF );
+            auto c0 = flatten( C0 );
+            CHECK( int( c0.size() ) == nF ) << "invalid number of terms " << c0.size() << " != " << nF;
+            for ( int t1 = 0; t1 < nF; ++t1 )
+            {
+                auto c0t = flatten( *c0[t1] );
+                for ( int t2 = 0; t2 < nF; ++t2 )
+                    M_C0( t1, t2 ) = *c0t[t2];
+            }
+            M_Lambda.resize( N, nA*nF );
+            auto lambda = flatten( Lambda );
+            CHECK( int( lambda.size() ) == nA ) << "invalid number of terms " << lambda.size() << " != " << nA;
+            for ( int t1 = 0; t1 < nA; ++t1 )
+            {
+                auto lambdat = flatten( *lambda[t1] );
+                for ( int t2 = 0; t2 < nF; ++t2 )
+                    M_Lambda.col( t1*nF+t2 ) = lambdat[t2]->head( N );
+            }
+            M_Gamma.resize( N*N, nA*nA );
+            auto gamma = flatten( Gamma );
+            CHECK( int( gamma.size() ) == nA ) << "invalid number of terms " << gamma.size() << " != " << nA;
+            for ( int t1 = 0; t1 < nA; ++t1 )
+            {
+                auto gammat = flatten( *gamma[t1] );
+                for ( int t2 = 0; t2 < nA; ++t2 )
+                    Eigen::Map<matrixN_type>( M_Gamma.col( t1*nA+t2 ).data(), N, N ) = gammat[t2]->block( 0, 0, N, N );
+            }
+        }
+
+    //!
+    //! evaluate the parameters given by the coefficients \p betaA, \p betaF
+    //! and \p betaL of the affine decompositions (one column by parameter)
+    //! by blocks of \p blockSize parameters distributed on \p nThreads threads
+    //!
+    CRBBatchResults evaluate( matrixN_type const& betaA, matrixN_type const& betaF, matrixN_type const& betaL,
+                              int nThreads = 1, int blockSize = 64 ) const
+        {
+            int P = betaA.cols();
+            CHECK( betaA.rows() == this->nTermsA() && betaF.rows() == this->nTermsF() && betaL.rows() == this->nTermsL() )
+                << "invalid number of coefficients";
+            CHECK( betaF.cols() == P && betaL.cols() == P ) << "invalid number of parameters";
+            auto t0 = std::chrono::steady_clock::now();
+
+            CRBBatchResults res;
+            res.coefficients.resize( M_N, P );
+            res.outputs.resize( P );
+            if ( this->hasErrorEstimator() )
+                res.primalResiduals.resize( P );
+
+            blockSize = std::max( 1, blockSize );
+            int nBlocks = ( P+blockSize-1 )/blockSize;
+            std::atomic<int> nextBlock( 0 );
+            auto evaluateBlocks = [&]()
+                {
+                    for ( int b = nextBlock++; b < nBlocks; b = nextBlock++ )
+                    {
+                        int p0 = b*blockSize, nb = std::min( blockSize, P-p0 );
+                        this->evaluateBlock( betaA.middleCols( p0, nb ), betaF.middleCols( p0, nb ), betaL.middleCols( p0, nb ), p0, res );
+                    }
+                };
+            nThreads = std::max( 1, std::min( nThreads, nBlocks ) );
+            std::vector<std::thread> threads;
+            for ( int t = 1; t < nThreads; ++t )
+                threads.emplace_back( evaluateBlocks );
+            evaluateBlocks();
+            for ( auto& t : threads )
+                t.join();
+
+            double elapsed = std::chrono::duration<double>( std::chrono::steady_clock::now() - t0 ).count();
+            res.evaluationsPerSecond = ( elapsed > 0 )? P/elapsed : 0.;
+            return res;
+        }
+
+    //!
+    //! write the packed terms in the binary reduced basis database \p filename
+    //! which can be mapped by CRBOnlineDB, \p muMin and \p muMax being the
+    //! bounds of the parameter space
+    //!
+    void save( std::string const& filename, std::vector<double> const& muMin, std::vector<double> const& muMax ) const
+        {
+            CHECK( muMin.size() == muMax.size() ) << "invalid parameter space bounds";
+            CRBOnlineDBHeader h {};
+            std::memcpy( h.magic, CRBOnlineDBHeader::magicString, sizeof( h.magic ) );
+            h.version = CRBOnlineDBHeader::currentVersion;
+            h.hasErrorEstimator = this->hasErrorEstimator();
+            h.N = M_N;
+            h.Qa = M_mA.size();
+            h.Qf = M_mF.size();
+            h.Ql = M_mL.size();
+            h.nA = this->nTermsA();
+            h.nF = this->nTermsF();
+            h.nL = this->nTermsL();
+            h.parameterDimension = muMin.size();
+
+            std::ofstream ofs( filename, std::ios::binary );
+            CHECK( ofs ) << "cannot write " << filename;
+            auto write = [&ofs]( auto const* data, std::size_t n ) {
+                             ofs.write( reinterpret_cast<char const*>( data ), sizeof( *data )*n );
+                         };
+            write( &h, 1 );
+            write( M_mA.data(), M_mA.size() );
+            write( M_mF.data(), M_mF.size() );
+            write( M_mL.data(), M_mL.size() );
+            write( muMin.data(), muMin.size() );
+            write( muMax.data(), muMax.size() );
+            for ( auto const* m : { &M_A, &M_F, &M_L, &M_C0, &M_Lambda, &M_Gamma } )
+                write( m->data(), m->size() );
+            CHECK( ofs ) << "error while writing " << filename;
+        }
+
+private:
+    //! number of terms \c m of each \c q of \c x[q][m]
+    template<typename T>
+    static std::vector<std::int64_t> nTerms( std::vector<std::vector<T>> const& x )
+        {
+            std::vector<std::int64_t> n;
+            for ( auto const& xq : x )
+                n.push_back( xq.size() );
+            return n;
+        }
+
+    //! flat list of the terms \c x[q][m]
+    template<typename T>
+    static std::vector<T const*> flatten( std::vector<std::vector<T>> const& x )
+        {
+            std::vector<T const*> f;
+            for ( auto const& xq : x )
+                for ( auto const& xqm : xq )
+                    f.push_back( &xqm );
+            return f;
+        }
+
+    template<typename BA, typename BF, typename BL>
+    void evaluateBlock( BA const& betaA, BF const& betaF, BL const& betaL, int p0, CRBBatchResults& res ) const
+        {
+            int N = M_N, nb = betaA.cols(), nA = this->nTermsA(), nF = this->nTermsF();
+            // assembly of the reduced systems of the block
+            matrixN_type A = M_A*betaA;
+            matrixN_type F = M_F*betaF;
+            matrixN_type L = M_L*betaL;
+            Eigen::PartialPivLU<matrixN_type> lu( N );
+            for ( int j = 0; j < nb; ++j )
+            {
+                lu.compute( Eigen::Map<const matrixN_type>( A.col( j ).data(), N, N ) );
+                res.coefficients.col( p0+j ) = lu.solve( F.col( j ) );
+                res.outputs( p0+j ) = L.col( j ).dot( res.coefficients.col( p0+j ) );
+            }
+            if ( !this->hasErrorEstimator() )
+                return;
+
+            auto U = res.coefficients.middleCols( p0, nb );
+            matrixN_type WAF( nA*nF, nb ), WAA( nA*nA, nb );
+            for ( int j = 0; j < nb; ++j )
+            {
+                for ( int t1 = 0; t1 < nA; ++t1 )
+                {
+                    WAF.col( j ).segment( t1*nF, nF ) = betaA( t1, j )*betaF.col( j );
+                    WAA.col( j ).segment( t1*nA, nA ) = betaA( t1, j )*betaA.col( j );
+                }
+            }
+            vectorN_type c0 = ( M_C0*betaF ).cwiseProduct( betaF ).colwise().sum().transpose();
+            vectorN_type lambda = ( M_Lambda*WAF ).cwiseProduct( U ).colwise().sum().transpose();
+            matrixN_type G = M_Gamma*WAA;
+            for ( int j = 0; j < nb; ++j )
+            {
+                double gamma = U.col( j ).dot( Eigen::Map<const matrixN_type>( G.col( j ).data(), N, N )*U.col( j ) );
+                res.primalResiduals( p0+j ) = math::abs( c0( j ) + lambda( j ) + gamma );
+            }
+        }
+
+private:
+    int M_N = 0;
+    std::vector<std::int64_t> M_mA, M_mF, M_mL;
+    matrixN_type M_A, M_F, M_L;
+    matrixN_type M_C0, M_Lambda, M_Gamma;
+};
+
+} // namespace Feel
+
+#endif /* FEELPP_CRBAFFINETENSORS_HPP */
@@ -0,0 +1,272 @@
+//! -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+//!
+//! This file is part of the Feel++ library
+//!
+//! This library is free software; you can redistribute it and/or
+//! modify it under the terms of the GNU Lesser General Public
+//! License as published by the Free Software Foundation; either
+//! version 2.1 of the License, or (at your option) any later version.
+//!
+//! This library is distributed in the hope that it will be useful,
+//! but WITHOUT ANY WARRANTY; without even the implied warranty of
+//! MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//! Lesser General Public License for more details.
+//!
+//! You should have received a copy of the GNU Lesser General Public
+//! License along with this library; if not, write to the Free Software
+//! Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//!
+//! @file
+//! @copyright 2023 Feel++ Consortium
+//!
+
+#ifndef FEELPP_CRBONLINEDB_HPP
+#define FEELPP_CRBONLINEDB_HPP 1
+
+//
+// This header depends only on the standard library, Eigen and POSIX : it can
+// be used by an application which evaluates a reduced basis model without
+// linking with Feel++ (no Environment, no PETSc, no mesh).
+//
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <Eigen/Core>
+#include <Eigen/LU>
+
+namespace Feel {
+
+//!
+//! header of a binary reduced basis database (.rbdb)
+//!
+//! The header is followed by the number of terms of each affine
+//! decomposition (int64 : mA[Qa], mF[Qf], mL[Ql]), the bounds of the
+//! parameter space (double : min[P], max[P]) and the packed reduced terms
+//! (double, column major) :
+//! - A : \f$N^2 \times nA\f$, F : \f$N \times nF\f$, L : \f$N \times nL\f$
+//! - if hasErrorEstimator : C0 : \f$nF \times nF\f$, Lambda : \f$N \times nA\,nF\f$, Gamma : \f$N^2 \times nA^2\f$
+//!
+//! the terms \f$(q,m)\f$ being numbered contiguously, see CRBAffineTensors
+//!
+struct CRBOnlineDBHeader
+{
+    static constexpr char magicString[8] = { 'F','P','P','R','B','D','B','\0' };
+    static constexpr std::uint32_t currentVersion = 1;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t hasErrorEstimator;
+    std::int64_t N;
+    std::int64_t Qa, Qf, Ql;
+    std::int64_t nA, nF, nL;
+    std::int64_t parameterDimension;
+};
+
+//!
+//! result of the evaluation of a parameter
+//!
+struct CRBOnlineDBResult
+{
+    //! reduced coefficients of the solution
+    Eigen::VectorXd coefficients;
+    //! output
+    double output = 0;
+    //! squared dual norm of the primal residual (-1 if the error estimator is not available)
+    double primalResidual = -1;
+};
+
+//!
+//! read only memory mapped binary reduced basis database
+//!
+//! The affine coefficients of the parameters are given by the caller (e.g.
+//! computed by the \c computeBetaQm of the model), either flattened or as
+//! \c beta[q][m].
+//!
+class CRBOnlineDB
+{
+public:
+    using vector_type = Eigen::VectorXd;
+    using const_map_type = Eigen::Map<const Eigen::MatrixXd>;
+    using beta_vector_type = std::vector<std::vector<double>>;
+
+    CRBOnlineDB() = default;
+    explicit CRBOnlineDB( std::string const& filename ) { this->open( filename ); }
+    CRBOnlineDB( CRBOnlineDB const& ) = delete;
+    CRBOnlineDB& operator=( CRBOnlineDB const& ) = delete;
+    ~CRBOnlineDB() { this->close(); }
+
+    //! map the database \p filename
+    void open( std::string const& filename )
+        {
+            this->close();
+            int fd = ::open( filename.c_str(), O_RDONLY );
+            if ( fd < 0 )
+                throw std::runtime_error( "CRBOnlineDB: cannot open " + filename );
+            struct stat st;
+            if ( ::fstat( fd, &st ) != 0 || st.st_size < std::int64_t( sizeof( CRBOnlineDBHeader ) ) )
+            {
+                ::close( fd );
+                throw std::runtime_error( "CRBOnlineDB: invalid file " + filename );
+            }
+            void* data = ::mmap( nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+            ::close( fd );
+            if ( data == MAP_FAILED )
+                throw std::runtime_error( "CRBOnlineDB: cannot map " + filename );
+            M_data = data;
+            M_size = st.st_size;
+
+            auto const* h = static_cast<CRBOnlineDBHeader const*>( M_data );
+            if ( std::memcmp( h->magic, CRBOnlineDBHeader::magicString, 8 ) != 0 || h->version != CRBOnlineDBHeader::currentVersion )
+            {
+                this->close();
+                throw std::runtime_error( "CRBOnlineDB: " + filename + " is not a reduced basis database" );
+            }
+            M_header = *h;
+            std::int64_t N = M_header.N, nA = M_header.nA, nF = M_header.nF, nL = M_header.nL;
+            std::size_t expected = sizeof( CRBOnlineDBHeader )
+                + sizeof( std::int64_t )*( M_header.Qa + M_header.Qf + M_header.Ql )
+                + sizeof( double )*( 2*M_header.parameterDimension + N*N*nA + N*nF + N*nL );
+            if ( M_header.hasErrorEstimator )
+                expected += sizeof( double )*( nF*nF + N*nA*nF + N*N*nA*nA );
+            if ( expected != M_size )
+            {
+                this->close();
+                throw std::runtime_error( "CRBOnlineDB: truncated file " + filename );
+            }
+
+            char const* p = static_cast<char const*>( M_data ) + sizeof( CRBOnlineDBHeader );
+            auto next = [&p]( auto const* t, std::int64_t n ) {
+                            auto const* r = reinterpret_cast<decltype( t )>( p );
+                            p += sizeof( *t )*n;
+                            return r;
+                        };
+            M_mA = next( M_mA, M_header.Qa );
+            M_mF = next( M_mF, M_header.Qf );
+            M_mL = next( M_mL, M_header.Ql );
+            M_muMin = next( M_muMin, M_header.parameterDimension );
+            M_muMax = next( M_muMax, M_header.parameterDimension );
+            M_A = next( M_A, N*N*nA );
+            M_F = next( M_F, N*nF );
+            M_L = next( M_L, N*nL );
+            if ( M_header.hasErrorEstimator )
+            {
+                M_C0 = next( M_C0, nF*nF );
+                M_Lambda = next( M_Lambda, N*nA*nF );
+                M_Gamma = next( M_Gamma, N*N*nA*nA );
+            }
+        }
+
+    void close()
+        {
+            if ( M_data )
+                ::munmap( M_data, M_size );
+            M_data = nullptr;
+            M_size = 0;
+        }
+
+    bool isOpen() const { return M_data != nullptr; }
+
+    //! reduced dimension
+    int dimension() const { return M_header.N; }
+    int Qa() const { return M_header.Qa; }
+    int Qf() const { return M_header.Qf; }
+    int Ql() const { return M_header.Ql; }
+    int mMaxA( int q ) const { return M_mA[q]; }
+    int mMaxF( int q ) const { return M_mF[q]; }
+    int mMaxL( int q ) const { return M_mL[q]; }
+    int nTermsA() const { return M_header.nA; }
+    int nTermsF() const { return M_header.nF; }
+    int nTermsL() const { return M_header.nL; }
+    bool hasErrorEstimator() const { return M_header.hasErrorEstimator != 0; }
+
+    int parameterDimension() const { return M_header.parameterDimension; }
+    Eigen::Map<const vector_type> parameterMin() const { return Eigen::Map<const vector_type>( M_muMin, M_header.parameterDimension ); }
+    Eigen::Map<const vector_type> parameterMax() const { return Eigen::Map<const vector_type>( M_muMax, M_header.parameterDimension ); }
+
+    //! evaluate the parameter given by the flattened coefficients of the affine decompositions
+    CRBOnlineDBResult evaluate( vector_type const& betaA, vector_type const& betaF, vector_type const& betaL ) const
+        {
+            if ( betaA.size() != M_header.nA || betaF.size() != M_header.nF || betaL.size() != M_header.nL )
+                throw std::invalid_argument( "CRBOnlineDB: invalid number of coefficients" );
+            int N = M_header.N, nA = M_header.nA, nF = M_header.nF;
+            CRBOnlineDBResult res;
+            vector_type a = const_map_type( M_A, N*N, nA )*betaA;
+            vector_type f = const_map_type( M_F, N, nF )*betaF;
+            res.coefficients = const_map_type( a.data(), N, N ).partialPivLu().solve( f );
+            res.output = ( const_map_type( M_L, N, M_header.nL )*betaL ).dot( res.coefficients );
+            if ( !this->hasErrorEstimator() )
+                return res;
+
+            auto const& u = res.coefficients;
+            double c0 = betaF.dot( const_map_type( M_C0, nF, nF )*betaF );
+            double lambda = 0;
+            vector_type lambdaU = const_map_type( M_Lambda, N, nA*nF ).transpose()*u;
+            vector_type betaAA( nA*nA );
+            for ( int t1 = 0; t1 < nA; ++t1 )
+            {
+                lambda += betaA( t1 )*betaF.dot( lambdaU.segment( t1*nF, nF ) );
+                betaAA.segment( t1*nA, nA ) = betaA( t1 )*betaA;
+            }
+            vector_type g = const_map_type( M_Gamma, N*N, nA*nA )*betaAA;
+            double gamma = u.dot( const_map_type( g.data(), N, N )*u );
+            res.primalResidual = std::abs( c0 + lambda + gamma );
+            return res;
+        }
+
+    //! evaluate the parameter given by the coefficients \c beta[q][m] of the affine decompositions
+    CRBOnlineDBResult evaluate( beta_vector_type const& betaAqm, beta_vector_type const& betaFqm, beta_vector_type const& betaLqm ) const
+        {
+            return this->evaluate( flatten( betaAqm, M_mA, M_header.Qa ),
+                                   flatten( betaFqm, M_mF, M_header.Qf ),
+                                   flatten( betaLqm, M_mL, M_header.Ql ) );
+        }
+
+private:
+    static vector_type flatten( beta_vector_type const& beta, std::int64_t const* mMax, std::int64_t Q )
+        {
+            if ( std::int64_t( beta.size() ) != Q )
+                throw std::invalid_argument( "CRBOnlineDB: invalid number of affine terms" );
+            std::int64_t n = 0;
+            for ( std::int64_t q = 0; q < Q; ++q )
+                n += mMax[q];
+            vector_type f( n );
+            n = 0;
+            for ( std::int64_t q = 0; q < Q; ++q )
+            {
+                if ( std::int64_t( beta[q].size() ) != mMax[q] )
+                    throw std::invalid_argument( "CRBOnlineDB: invalid number of affine terms" );
+                for ( double b : beta[q] )
+                    f( n++ ) = b;
+            }
+            return f;
+        }
+
+private:
+    void* M_data = nullptr;
+    std::size_t M_size = 0;
+    CRBOnlineDBHeader M_header {};
+    std::int64_t const* M_mA = nullptr;
+    std::int64_t const* M_mF = nullptr;
+    std::int64_t const* M_mL = nullptr;
+    double const* M_muMin = nullptr;
+    double const* M_muMax = nullptr;
+    double const* M_A = nullptr;
+    double const* M_F = nullptr;
+    double const* M_L = nullptr;
+    double const* M_C0 = nullptr;
+    double const* M_Lambda = nullptr;
+    double const* M_Gamma = nullptr;
+};
+
+} // namespace Feel
+
+#endif /* FEELPP_CRBONLINEDB_HPP */
@@ -255,10 +255,16 @@ public:
     std::vector<CRBResults> run( std::vector<ParameterSpaceX::Element> const& S,
                                  double eps , int N, bool print_rb_matrix ) const override
         {
-
+            DCHECK( M_crb ) << "DB not loaded";
             return M_crb->run( S, eps, N, print_rb_matrix );
         }
 
+    void saveOnlineDB( std::string const& filename, int N ) const override
+        {
+            DCHECK( M_crb ) << "DB not loaded";
+            M_crb->saveOnlineDB( filename, N );
+        }
+
     void expansion( vectorN_type const& uRB, Vector<double> & uFE,  int N ) const override
         {
             DCHECK( M_crb ) << "DB not loaded";
@@ -156,6 +156,13 @@ public:
     virtual std::vector<CRBResults> run( std::vector<ParameterSpaceX::Element> const& S,
                                          double eps , int N, bool print_rb_matrix ) const = 0;
 
+    //!
+    //! write the reduced operators and outputs in a binary database mapped by CRBOnlineDB
+    //! @param filename binary database filename
+    //! @param N number of basis functions
+    //!
+    virtual void saveOnlineDB( std::string const& filename, int N ) const = 0;
+
     //!
     //! expand the rb field to fe field
     //!
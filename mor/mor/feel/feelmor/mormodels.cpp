@@ -87,20 +87,24 @@ MORModels::run( std::shared_ptr<ParameterSpaceX::Sampling> const& sampling, nl::
     using namespace Feel;
 
     auto N = data.value("N",-1);
-    Eigen::VectorXd /*typename crb_type::vectorN_type*/ time_crb;
     auto online_tol = data.value( "tolerance", 1e-2 );
     auto print_rb_matrix = data.value( "print_rb_matrix", false );
 
+    // each model evaluates the whole sampling (batched evaluation when available)
+    std::vector<ParameterSpaceX::Element> S( sampling->begin(), sampling->end() );
     std::vector<std::vector<CRBResults>> results( sampling->size() );
+    for ( auto& r : results )
+        r.reserve( this->size() );
+    for ( auto const& p : *this )
+    {
+        tic();
+        auto res = p.run( S, online_tol, N, print_rb_matrix );
+        double t = toc( fmt::format( "rb-online-{}-{}", p.name, p.output ), FLAGS_v > 0 );
+        for ( int k = 0; k < int( res.size() ); ++k )
+            results[k].push_back( std::move( res[k] ) );
+    }
     for ( auto const& [k, mu] : enumerate( *sampling ) )
     {
-        results[k].reserve( this->size() );
-        for ( auto const& p : *this )
-        {
-            tic();
-            results[k].emplace_back( p.run( mu, time_crb, online_tol, N, print_rb_matrix ) );
-            double t = toc( fmt::format( "rb-online-{}-{}", p.name, p.output ), FLAGS_v > 0 );
-        }
         for ( auto const& o : observers_ )
         {
             o->update( std::pair{ k, mu }, results[k] );
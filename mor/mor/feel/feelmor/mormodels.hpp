@@ -61,6 +61,11 @@ class MORModel
     {
         return p_->parameterSpace();
     }
+    void
+    saveOnlineDB( std::string const& filename, int N = -1 ) const
+    {
+        p_->saveOnlineDB( filename, N );
+    }
 
     void
     initExporter()
@@ -0,0 +1,150 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*-
+
+  This file is part of the Feel library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#define BOOST_TEST_MODULE crb affine tensors testsuite
+#include <feel/feelcore/testsuite.hpp>
+
+#include <feel/feelmor/crbaffinetensors.hpp>
+#include <feel/feelmor/crbonlinedb.hpp>
+
+using namespace Feel;
+
+FEELPP_ENVIRONMENT_NO_OPTIONS
+
+BOOST_AUTO_TEST_SUITE( crbaffinetensorssuite )
+
+BOOST_AUTO_TEST_CASE( batch_vs_loop )
+{
+    // reduced data larger than the evaluated dimension
+    int Nmax = 8, N = 6, P = 37;
+    std::vector<int> mA = { 2, 1 }, mF = { 1, 3 }, mL = { 2 };
+    std::srand( 1 );
+    auto terms = []( std::vector<int> const& m, auto const& f ) {
+        using T = std::decay_t<decltype( f() )>;
+        std::vector<std::vector<T>> x( m.size() );
+        for ( int q = 0; q < int( m.size() ); ++q )
+            for ( int k = 0; k < m[q]; ++k )
+                x[q].push_back( f() );
+        return x;
+    };
+    auto Aqm = terms( mA, [&]{ return matrixN_type( matrixN_type::Random( Nmax, Nmax ) + 4*Nmax*matrixN_type::Identity( Nmax, Nmax ) ); } );
+    auto Fqm = terms( mF, [&]{ return vectorN_type( vectorN_type::Random( Nmax ) ); } );
+    auto Lqm = terms( mL, [&]{ return vectorN_type( vectorN_type::Random( Nmax ) ); } );
+    auto C0 = terms( mF, [&]{ return terms( mF, [&]{ return double( std::rand() )/RAND_MAX; } ); } );
+    auto Lambda = terms( mA, [&]{ return terms( mF, [&]{ return vectorN_type( vectorN_type::Random( Nmax ) ); } ); } );
+    auto Gamma = terms( mA, [&]{ return terms( mA, [&]{ return matrixN_type( matrixN_type::Random( Nmax, Nmax ) ); } ); } );
+
+    CRBAffineTensors tensors;
+    tensors.pack( N, Aqm, Fqm, Lqm );
+    tensors.packErrorEstimator( C0, Lambda, Gamma );
+    BOOST_CHECK_EQUAL( tensors.dimension(), N );
+    BOOST_CHECK_EQUAL( tensors.nTermsA(), 3 );
+    BOOST_CHECK_EQUAL( tensors.nTermsF(), 4 );
+    BOOST_CHECK_EQUAL( tensors.nTermsL(), 2 );
+    BOOST_CHECK( tensors.hasErrorEstimator() );
+
+    matrixN_type betaA = matrixN_type::Random( 3, P ), betaF = matrixN_type::Random( 4, P ), betaL = matrixN_type::Random( 2, P );
+    auto res = tensors.evaluate( betaA, betaF, betaL, 3, 8 );
+    BOOST_CHECK_GT( res.evaluationsPerSecond, 0 );
+
+    auto flatten = []( auto const& x ) {
+        std::vector<std::decay_t<decltype( x[0][0] )>> f;
+        for ( auto const& xq : x )
+            for ( auto const& xqm : xq )
+                f.push_back( xqm );
+        return f;
+    };
+    auto A = flatten( Aqm );
+    auto F = flatten( Fqm );
+    auto L = flatten( Lqm );
+    auto fC0 = flatten( C0 );
+    auto fLambda = flatten( Lambda );
+    auto fGamma = flatten( Gamma );
+    for ( int p = 0; p < P; ++p )
+    {
+        matrixN_type Ap = matrixN_type::Zero( N, N );
+        vectorN_type Fp = vectorN_type::Zero( N ), Lp = vectorN_type::Zero( N );
+        for ( int t = 0; t < 3; ++t )
+            Ap += betaA( t, p )*A[t].block( 0, 0, N, N );
+        for ( int t = 0; t < 4; ++t )
+            Fp += betaF( t, p )*F[t].head( N );
+        for ( int t = 0; t < 2; ++t )
+            Lp += betaL( t, p )*L[t].head( N );
+        vectorN_type u = Ap.lu().solve( Fp );
+        BOOST_CHECK_SMALL( ( u - res.coefficients.col( p ) ).norm(), 1e-10 );
+        BOOST_CHECK_SMALL( Lp.dot( u ) - res.outputs( p ), 1e-10 );
+
+        double c0 = 0, lambda = 0, gamma = 0;
+        for ( int t1 = 0; t1 < 4; ++t1 )
+        {
+            auto c0t = flatten( fC0[t1] );
+            for ( int t2 = 0; t2 < 4; ++t2 )
+                c0 += betaF( t1, p )*betaF( t2, p )*c0t[t2];
+        }
+        for ( int t1 = 0; t1 < 3; ++t1 )
+        {
+            auto lambdat = flatten( fLambda[t1] );
+            for ( int t2 = 0; t2 < 4; ++t2 )
+                lambda += betaA( t1, p )*betaF( t2, p )*lambdat[t2].head( N ).dot( u );
+            auto gammat = flatten( fGamma[t1] );
+            for ( int t2 = 0; t2 < 3; ++t2 )
+                gamma += betaA( t1, p )*betaA( t2, p )*u.dot( gammat[t2].block( 0, 0, N, N )*u );
+        }
+        BOOST_CHECK_SMALL( std::abs( c0 + lambda + gamma ) - res.primalResiduals( p ), 1e-10 );
+    }
+
+    // same results with one thread and one block
+    auto res1 = tensors.evaluate( betaA, betaF, betaL, 1, P );
+    BOOST_CHECK_SMALL( ( res1.outputs - res.outputs ).norm(), 1e-12 );
+    BOOST_CHECK_SMALL( ( res1.primalResiduals - res.primalResiduals ).norm(), 1e-12 );
+
+    // binary reduced database
+    std::string filename = "test_crbaffinetensors.rbdb";
+    tensors.save( filename, { 0., 1. }, { 1., 2. } );
+    {
+        CRBOnlineDB db( filename );
+        BOOST_CHECK_EQUAL( db.dimension(), N );
+        BOOST_CHECK_EQUAL( db.Qa(), 2 );
+        BOOST_CHECK_EQUAL( db.mMaxF( 1 ), 3 );
+        BOOST_CHECK( db.hasErrorEstimator() );
+        BOOST_CHECK_EQUAL( db.parameterDimension(), 2 );
+        BOOST_CHECK_CLOSE( db.parameterMax()( 1 ), 2., 1e-12 );
+        for ( int p = 0; p < P; ++p )
+        {
+            auto r = db.evaluate( vectorN_type( betaA.col( p ) ), vectorN_type( betaF.col( p ) ), vectorN_type( betaL.col( p ) ) );
+            BOOST_CHECK_SMALL( r.output - res.outputs( p ), 1e-10 );
+            BOOST_CHECK_SMALL( r.primalResidual - res.primalResiduals( p ), 1e-10 );
+        }
+        std::vector<std::vector<double>> betaAqm = { { betaA( 0, 0 ), betaA( 1, 0 ) }, { betaA( 2, 0 ) } };
+        std::vector<std::vector<double>> betaFqm = { { betaF( 0, 0 ) }, { betaF( 1, 0 ), betaF( 2, 0 ), betaF( 3, 0 ) } };
+        std::vector<std::vector<double>> betaLqm = { { betaL( 0, 0 ), betaL( 1, 0 ) } };
+        BOOST_CHECK_SMALL( db.evaluate( betaAqm, betaFqm, betaLqm ).output - res.outputs( 0 ), 1e-10 );
+    }
+    fs::remove( filename );
+
+    // without error estimator
+    tensors.pack( N, Aqm, Fqm, Lqm );
+    BOOST_CHECK( !tensors.hasErrorEstimator() );
+    auto res2 = tensors.evaluate( betaA, betaF, betaL, 2, 5 );
+    BOOST_CHECK_EQUAL( res2.primalResiduals.size(), 0 );
+    BOOST_CHECK_SMALL( ( res2.outputs - res.outputs ).norm(), 1e-12 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -40,6 +40,7 @@
 
 #include <feel/feelmor/modelcrbbase.hpp>
 #include <feel/feelmor/crb.hpp>
+#include <feel/feelmor/crbplugin.hpp>
 
 namespace Feel
 {
@@ -339,4 +340,46 @@ BOOST_AUTO_TEST_CASE( crd_db_test1 )
     std::cout << "Samples OK" << std::endl;
 
 }
+
+/* The run of a sample through the plugin API uses the batched evaluation */
+/* (CRB::runBatch) for a steady linear model without error estimation */
+BOOST_AUTO_TEST_CASE( crb_db_plugin_batch )
+{
+    Environment::setOptionValue("crb.results-repo-name", std::string("test_db"));
+    Environment::setOptionValue("crb.rebuild-database", true);
+    Environment::setOptionValue("crb.db.format", std::string("boost"));
+    Environment::setOptionValue("crb.error-type", (int)CRB_NO_RESIDUAL );
+    Environment::setOptionValue("crb.solve-dual-problem", false );
+
+    using crbmodel_type = CRBModel<Feel::TestDbHeat1d>;
+    using crb_type = CRB<crbmodel_type>;
+    auto crbmodel = std::make_shared<crbmodel_type>( "crb_db_plugin_batch", Environment::nameUUID( boost::uuids::nil_uuid(), "batch" ), crb::stage::offline );
+    auto crb = crb_type::New( crbmodel->model()->modelName(), crbmodel, crb::stage::offline );
+    crb->offline();
+    fs::path jsonPath = fs::path(crbmodel->model()->crbModelDb().dbRepository())/crbmodel->model()->crbModelDb().jsonFilename();
+
+    CRBPlugin<Feel::TestDbHeat1d> plugin( "testdbheat1d" );
+    CRBPluginAPI& api = plugin;
+    api.loadDB( jsonPath.string(), crb::load::rb );
+
+    auto sampling = api.parameterSpace()->sampling();
+    sampling->randomize( 20, true );
+    std::vector<ParameterSpaceX::Element> S( sampling->begin(), sampling->end() );
+
+    Environment::setOptionValue("crb.online.batch", true );
+    auto batch = api.run( S, 1e-2, -1, false );
+    Environment::setOptionValue("crb.online.batch", false );
+    auto ref = api.run( S, 1e-2, -1, false );
+
+    BOOST_REQUIRE_EQUAL( batch.size(), S.size() );
+    BOOST_REQUIRE_EQUAL( ref.size(), S.size() );
+    for ( int k = 0; k < S.size(); ++k )
+    {
+        BOOST_CHECK_CLOSE( batch[k].output(), ref[k].output(), 1e-6 );
+        BOOST_CHECK_SMALL( ( batch[k].coefficients() - ref[k].coefficients() ).norm(), 1e-8*( 1+ref[k].coefficients().norm() ) );
+        BOOST_CHECK_EQUAL( batch[k].errorbound(), ref[k].errorbound() );
+        BOOST_CHECK( batch[k].parameter() == S[k] );
+    }
+    Environment::setOptionValue("crb.online.batch", true );
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -8,6 +8,7 @@
 
 #include <feel/feelalg/backend.hpp>
 #include <feel/feeldiscr/functionspace.hpp>
+#include <feel/feeldiscr/pchv.hpp>
 //#include <feel/feeldiscr/createsubmesh.hpp>
 #include <feel/feelfilters/gmsh.hpp>
 #include <feel/feelvf/vf.hpp>
@@ -147,6 +148,154 @@ void run()
 
 } // run
 
+/**
+ * compare the sparsity pattern built in flat CSR form with the one built
+ * with the std::set rows
+ */
+void runFlat()
+{
+    typedef Mesh< Simplex<2,1,2> > mesh_type;
+    GeoTool::Node x1( 0,0 );
+    GeoTool::Node x2( 1,1 );
+    GeoTool::Rectangle Omega( doption(_name="hsize"),"Omega",x1,x2 );
+    auto mesh = Omega.createMesh( _mesh=new mesh_type, _name="omega_flat" );
+
+    auto Xh = Pchv<2>( mesh );
+
+    for ( int nThreads : { 1, 3 } )
+    {
+        Environment::setOptionValue( "stencil.flat-csr.nthreads", nThreads );
+        for ( size_type pattern : { size_type(Pattern::DEFAULT), size_type(Pattern::COUPLED) } )
+        {
+            // a range is given to bypass the StencilManager cache
+            Environment::setOptionValue( "stencil.flat-csr", false );
+            auto gSet = stencil( _test=Xh, _trial=Xh, _pattern=pattern, _range=elements(mesh), _diag_is_nonzero=true )->graph();
+            Environment::setOptionValue( "stencil.flat-csr", true );
+            auto gFlat = stencil( _test=Xh, _trial=Xh, _pattern=pattern, _range=elements(mesh), _diag_is_nonzero=true )->graph();
+
+            BOOST_CHECK( gFlat->hasFlatRows() );
+            BOOST_CHECK_EQUAL( gFlat->nNz(), gSet->nNz() );
+            BOOST_CHECK_EQUAL( gFlat->maxNnz(), gSet->maxNnz() );
+            BOOST_CHECK( gFlat->ia() == gSet->ia() );
+            BOOST_CHECK( gFlat->ja() == gSet->ja() );
+            BOOST_CHECK( gFlat->nNzOnProc() == gSet->nNzOnProc() );
+            BOOST_CHECK( gFlat->nNzOffProc() == gSet->nNzOffProc() );
+
+            // the std::set rows (of the process) are only built on demand
+            auto gFlatExpand = stencil( _test=Xh, _trial=Xh, _pattern=pattern, _range=elements(mesh), _diag_is_nonzero=true )->graph();
+            size_type nRows = gFlatExpand->size();
+            gFlatExpand->expandFlatRows();
+            BOOST_CHECK( !gFlatExpand->hasFlatRows() );
+            BOOST_CHECK_EQUAL( gFlatExpand->size(), nRows );
+            for ( auto const& [ig,row] : gFlatExpand->storage() )
+                BOOST_CHECK( row.get<2>() == gSet->row( ig ).get<2>() );
+        }
+    }
+    Environment::setOptionValue( "stencil.flat-csr", true );
+}
+
+/**
+ * rebuild the space on the same mesh : the graph is reused from the stencil
+ * topology cache, and check the incremental build of a flat pattern
+ */
+void runCache()
+{
+    typedef Mesh< Simplex<2,1,2> > mesh_type;
+    GeoTool::Node x1( 0,0 );
+    GeoTool::Node x2( 1,1 );
+    GeoTool::Rectangle Omega( doption(_name="hsize"),"Omega",x1,x2 );
+    auto mesh = Omega.createMesh( _mesh=new mesh_type, _name="omega_cache" );
+
+    // the stencil topology cache is used by the flat CSR builder (default)
+    Environment::setOptionValue( "stencil.cache", true );
+    auto Xh1 = Pchv<2>( mesh );
+    auto g1 = stencil( _test=Xh1, _trial=Xh1, _diag_is_nonzero=true )->graph();
+    auto Xh2 = Pchv<2>( mesh );
+    auto g2 = stencil( _test=Xh2, _trial=Xh2, _diag_is_nonzero=true )->graph();
+    // the graph is reused and bound to the maps of the new space
+    BOOST_CHECK( g2->isClosed() );
+    BOOST_CHECK( g2->mapRowPtr() == Xh2->dof() );
+    BOOST_CHECK( g2->mapColPtr() == Xh2->dof() );
+    BOOST_CHECK( g1->ia() == g2->ia() );
+    BOOST_CHECK( g1->ja() == g2->ja() );
+
+    // the cache does not keep the old spaces alive
+    std::weak_ptr<const DataMap<>> dof1 = Xh1->dof();
+    g1.reset();
+    Xh1.reset();
+    stencilManagerGarbageCollect();
+    BOOST_CHECK( dof1.expired() );
+    auto Xh3 = Pchv<2>( mesh );
+    auto g3 = stencil( _test=Xh3, _trial=Xh3, _diag_is_nonzero=true )->graph();
+    BOOST_CHECK( g3->mapRowPtr() == Xh3->dof() );
+    BOOST_CHECK( g3->ja() == g2->ja() );
+    stencilTopologyCacheClear();
+    Environment::setOptionValue( "stencil.cache", false );
+
+    // rows i couple i-1,i,i+1 then the rows 3 and 4 couple 0 only
+    auto entries = []( size_type nRows, bool changed )
+        {
+            return [nRows,changed]( auto&& insert )
+            {
+                for ( size_type i = 0; i < nRows; ++i )
+                {
+                    std::vector<size_type> cols;
+                    if ( changed && ( i == 3 || i == 4 ) )
+                        cols = { 0 };
+                    else
+                        cols = { ( i > 0 )? i-1 : i, i, std::min( i+1, nRows-1 ) };
+                    insert( i, cols.begin(), cols.end() );
+                }
+            };
+        };
+    size_type nRows = 10;
+    GraphCSRBuilder oldRows( nRows );
+    oldRows.build( entries( nRows, false ) );
+    GraphCSRBuilder fullRows( nRows );
+    fullRows.build( entries( nRows, true ) );
+    std::vector<bool> rowsToUpdate( nRows, false );
+    rowsToUpdate[3] = rowsToUpdate[4] = true;
+    GraphCSRBuilder incrementalRows( nRows );
+    incrementalRows.buildIncremental( oldRows, rowsToUpdate, entries( nRows, true ) );
+    BOOST_CHECK( incrementalRows.ia() == fullRows.ia() );
+    BOOST_CHECK( incrementalRows.ja() == fullRows.ja() );
+
+    // incremental build with two more rows
+    size_type nRowsNew = nRows+2;
+    GraphCSRBuilder fullRowsNew( nRowsNew );
+    fullRowsNew.build( entries( nRowsNew, true ) );
+    std::vector<bool> rowsToUpdateNew( nRowsNew, false );
+    rowsToUpdateNew[3] = rowsToUpdateNew[4] = rowsToUpdateNew[9] = rowsToUpdateNew[10] = rowsToUpdateNew[11] = true;
+    GraphCSRBuilder incrementalRowsNew( nRowsNew );
+    incrementalRowsNew.buildIncremental( oldRows, rowsToUpdateNew, entries( nRowsNew, true ) );
+    BOOST_CHECK( incrementalRowsNew.ia() == fullRowsNew.ia() );
+    BOOST_CHECK( incrementalRowsNew.ja() == fullRowsNew.ja() );
+
+    // topologies with a different number of rows and couplings :
+    // the element 1 gets a new coupling and the element 2 is removed
+    StencilTopology oldTopology, newTopology;
+    auto addCoupling = []( StencilTopology& t, index_type eltId, std::vector<size_type> const& rows, std::size_t colsHash )
+        {
+            t.testEltIds.push_back( eltId );
+            t.rows.insert( t.rows.end(), rows.begin(), rows.end() );
+            t.rowsPtr.push_back( t.rows.size() );
+            t.colsHash.push_back( colsHash );
+        };
+    oldTopology.nRows = 4;
+    addCoupling( oldTopology, 0, { 0, 1 }, 10 );
+    addCoupling( oldTopology, 1, { 1, 2 }, 11 );
+    addCoupling( oldTopology, 2, { 2, 3 }, 12 );
+    newTopology.nRows = 5;
+    addCoupling( newTopology, 0, { 0, 1 }, 10 );
+    addCoupling( newTopology, 1, { 1, 2 }, 11 );
+    addCoupling( newTopology, 1, { 1, 2 }, 13 );
+    addCoupling( newTopology, 3, { 3, 4 }, 14 );
+    BOOST_CHECK_EQUAL( newTopology.nChanges( oldTopology ), 3 );
+    std::vector<bool> changedRows( newTopology.nRows, false );
+    newTopology.updateChangedRows( oldTopology, changedRows );
+    BOOST_CHECK( changedRows == std::vector<bool>( { false, true, true, true, true } ) );
+}
+
 } //namespace test_graphcsr
 
 
@@ -163,6 +312,14 @@ BOOST_AUTO_TEST_CASE( graphcsr_case1 )
 {
     test_graphcsr::run();
 }
+BOOST_AUTO_TEST_CASE( graphcsr_flat )
+{
+    test_graphcsr::runFlat();
+}
+BOOST_AUTO_TEST_CASE( graphcsr_cache )
+{
+    test_graphcsr::runCache();
+}
 BOOST_AUTO_TEST_SUITE_END()
 
 
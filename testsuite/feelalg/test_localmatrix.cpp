@@ -0,0 +1,86 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*-
+
+  This file is part of the Feel library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include <map>
+#include <random>
+
+#define BOOST_TEST_MODULE local matrix testsuite
+#include <feel/feelcore/testsuite.hpp>
+
+#include <feel/feelalg/staticcondensation.hpp>
+
+using namespace Feel;
+
+FEELPP_ENVIRONMENT_NO_OPTIONS
+
+BOOST_AUTO_TEST_SUITE( localmatrixsuite )
+
+BOOST_AUTO_TEST_CASE( batched_store )
+{
+    using sc_type = StaticCondensation<double>;
+    using key_type = sc_type::block_element_t;
+    using local_matrix_t = sc_type::local_matrix_t;
+    sc_type::block_local_matrices_t lm;
+    std::map<key_type,local_matrix_t> ref;
+    std::mt19937 gen( 1 );
+    for ( int k = 0; k < 3000; ++k )
+    {
+        // three shapes of matrices, for instance three types of elements
+        key_type key( gen() % 200, gen() % 3 );
+        local_matrix_t m = local_matrix_t::Random( 2+key.second, 3+key.second );
+        lm.add( key, m );
+        auto [it,inserted] = ref.emplace( key, m );
+        if ( !inserted )
+            it->second += m;
+    }
+    BOOST_CHECK_EQUAL( lm.size(), ref.size() );
+    BOOST_CHECK_EQUAL( lm.nBatches(), 3 );
+
+    // the matrices of a batch are contiguous
+    for ( int b = 0; b < lm.nBatches(); ++b )
+    {
+        auto const& batch = lm.batch( b );
+        BOOST_CHECK_EQUAL( batch.values.size(), batch.size()*batch.rows*batch.cols );
+        for ( std::size_t i = 0; i < batch.size(); ++i )
+            BOOST_CHECK_EQUAL( lm.at( batch.keys[i] ).data(), batch.data( i ) );
+    }
+
+    std::size_t n = 0;
+    for ( auto const& [key,m] : lm )
+    {
+        BOOST_CHECK_SMALL( ( m - ref.at( key ) ).norm(), 1e-12 );
+        ++n;
+    }
+    BOOST_CHECK_EQUAL( n, ref.size() );
+    auto it = lm.find( ref.begin()->first );
+    BOOST_REQUIRE( it != lm.end() );
+    BOOST_CHECK( it->first == ref.begin()->first );
+
+    lm.set( key_type( 1000, 0 ), local_matrix_t::Ones( 2, 3 ) );
+    BOOST_CHECK_CLOSE( lm.at( key_type( 1000, 0 ) ).sum(), 6., 1e-12 );
+    auto lmCopy = lm;
+    lmCopy.setZero();
+    BOOST_CHECK_EQUAL( lmCopy.size(), lm.size() );
+    for ( auto const& [key,m] : lmCopy )
+        BOOST_CHECK_EQUAL( m.norm(), 0. );
+    BOOST_CHECK_CLOSE( lm.at( key_type( 1000, 0 ) ).sum(), 6., 1e-12 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,89 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+
+  This file is part of the Feel library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 3.0 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#define BOOST_TEST_MODULE profiler testsuite
+#include <feel/feelcore/testsuite.hpp>
+
+#include <fstream>
+#include <thread>
+
+#include <feel/feelcore/environment.hpp>
+#include <feel/feelcore/json.hpp>
+#include <feel/feelcore/profiler.hpp>
+
+using namespace Feel;
+
+FEELPP_ENVIRONMENT_NO_OPTIONS
+
+BOOST_AUTO_TEST_SUITE( profilersuite )
+
+BOOST_AUTO_TEST_CASE( regions )
+{
+    auto& profiler = Profiler::instance();
+    profiler.clear();
+    profiler.setEnabled( true );
+    profiler.setTraceEnabled( true );
+    for ( int i = 0; i < 3; ++i )
+    {
+        FEELPP_PROFILE_REGION( "solve" );
+        {
+            FEELPP_PROFILE_REGION( "assembly" );
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        }
+        profiler.addRegion( "io", 1e-3 );
+    }
+    std::thread t( []() { FEELPP_PROFILE_REGION( "worker" ); } );
+    t.join();
+
+    auto stats = profiler.localStats();
+    BOOST_REQUIRE_EQUAL( stats.size(), 4 );
+    BOOST_CHECK_EQUAL( stats[0].path, "solve" );
+    BOOST_CHECK_EQUAL( stats[1].path, "solve/assembly" );
+    BOOST_CHECK_EQUAL( stats[1].level, 1 );
+    BOOST_CHECK_EQUAL( stats[1].count, 3 );
+    BOOST_CHECK( stats[1].min >= 1e-3 );
+    BOOST_CHECK( stats[0].total >= stats[1].total );
+    BOOST_CHECK_EQUAL( stats[2].path, "solve/io" );
+    BOOST_CHECK_CLOSE( stats[2].total, 3e-3, 1e-3 );
+    BOOST_CHECK_EQUAL( stats[3].path, "worker" );
+
+    auto reduced = profiler.reducedStats( Environment::worldComm() );
+    if ( Environment::isMasterRank() )
+    {
+        BOOST_REQUIRE_EQUAL( reduced.size(), 4 );
+        BOOST_CHECK_EQUAL( reduced[1].nRanks, Environment::numberOfProcessors() );
+        BOOST_CHECK_EQUAL( reduced[1].count, 3*Environment::numberOfProcessors() );
+        BOOST_CHECK( reduced[1].minTotal <= reduced[1].meanTotal && reduced[1].meanTotal <= reduced[1].maxTotal );
+    }
+
+    profiler.saveTrace( Environment::worldComm(), "test_profiler_trace.json" );
+    if ( Environment::isMasterRank() )
+    {
+        std::ifstream ifs( "test_profiler_trace.json" );
+        auto j = nl::json::parse( ifs );
+        // one process name and 10 calls by rank
+        BOOST_CHECK_EQUAL( j["traceEvents"].size(), 11*Environment::numberOfProcessors() );
+    }
+    profiler.clear();
+    profiler.setEnabled( false );
+    profiler.setTraceEnabled( false );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
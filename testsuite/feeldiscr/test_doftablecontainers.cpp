@@ -0,0 +1,121 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*-
+
+  This file is part of the Feel library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#define BOOST_TEST_MODULE dof table containers testsuite
+#include <feel/feelcore/testsuite.hpp>
+
+#include <boost/mpl/list.hpp>
+
+#include <feel/feeldiscr/doftablecontainers.hpp>
+#include <feel/feeldiscr/pch.hpp>
+#include <feel/feelfilters/unithypercube.hpp>
+
+using namespace Feel;
+
+FEELPP_ENVIRONMENT_NO_OPTIONS
+
+BOOST_AUTO_TEST_SUITE( doftablecontainerssuite )
+
+BOOST_AUTO_TEST_CASE( test_elementdofindices )
+{
+    ElementDofIndices<int> indices;
+    indices.init( std::vector<size_type>{ 3, 0, 5 }, 4 );
+    BOOST_CHECK_EQUAL( indices.size(), 6 );
+    BOOST_CHECK_EQUAL( indices.nIndices(), 12 );
+    BOOST_CHECK( indices.has( 0 ) && indices.has( 3 ) && indices.has( 5 ) );
+    BOOST_CHECK( !indices.has( 1 ) && !indices.has( 6 ) );
+    indices[3][2] = 7;
+    indices[5][3] = 9;
+
+    // the indices of the elements which are not resized are kept
+    indices.resize( { { 5, 6 }, { 7, 2 } } );
+    BOOST_CHECK_EQUAL( indices[3][2], 7 );
+    BOOST_CHECK_EQUAL( indices[5].size(), 6 );
+    BOOST_CHECK_EQUAL( indices[5][3], 9 );
+    BOOST_CHECK_EQUAL( indices[7].size(), 2 );
+    BOOST_CHECK( !indices.has( 6 ) );
+
+    // the const rows are views on the storage and a copy refers to its own storage
+    ElementDofIndices<int> const indicesCopy( indices );
+    auto row = indicesCopy[3];
+    indices[3][2] = 8;
+    BOOST_CHECK_EQUAL( row[2], 7 );
+    BOOST_CHECK_EQUAL( indicesCopy[3].data(), row.data() );
+}
+
+BOOST_AUTO_TEST_CASE( test_facedofscontainer )
+{
+    FaceDofsContainer<size_type> faceDofs( 2 );
+    faceDofs.add( 7, std::vector<size_type>{ 4, 5 } );
+    faceDofs.add( 3, std::vector<size_type>{ 2, 3 } );
+    faceDofs.add( 7, std::vector<size_type>{ 0, 1 } );
+    faceDofs.add( 7, std::vector<size_type>{ 4, 5 } );
+    faceDofs.finalize();
+
+    // faces sorted by id, records sorted and unique
+    BOOST_CHECK_EQUAL( faceDofs.size(), 2 );
+    BOOST_CHECK_EQUAL( faceDofs.faceId( 0 ), 3 );
+    BOOST_CHECK_EQUAL( faceDofs.faceId( 1 ), 7 );
+    BOOST_CHECK_EQUAL( faceDofs.nDofs( 0 ), 1 );
+    BOOST_CHECK_EQUAL( faceDofs.nDofs( 1 ), 2 );
+    BOOST_CHECK_EQUAL( faceDofs.dof( 0, 0, 1 ), 3 );
+    BOOST_CHECK_EQUAL( faceDofs.dof( 1, 0, 0 ), 0 );
+    BOOST_CHECK_EQUAL( faceDofs.dof( 1, 1, 1 ), 5 );
+}
+
+BOOST_AUTO_TEST_CASE( test_dofpointscontainer )
+{
+    DofPointsContainer<std::tuple<double,size_type>> points;
+    points.reserve( 10 );
+    BOOST_CHECK( points.empty() );
+    points[4] = { 1., 4 };
+    points[2] = { 2., 2 };
+    points[12] = { 3., 12 };
+    BOOST_CHECK_EQUAL( points.size(), 3 );
+
+    // only the points set are visited, by increasing dof id
+    std::vector<size_type> dofIds;
+    for ( auto const& dofPoint : points )
+        dofIds.push_back( dofPoint.first );
+    BOOST_CHECK( dofIds == std::vector<size_type>( { 2, 4, 12 } ) );
+    BOOST_CHECK( points.find( 3 ) == points.end() );
+    BOOST_CHECK( points.find( 20 ) == points.end() );
+    BOOST_CHECK_EQUAL( std::get<0>( points.find( 12 )->second ), 3. );
+}
+
+typedef boost::mpl::list<boost::mpl::int_<2>,boost::mpl::int_<3> > dim_types;
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_doftable, T, dim_types )
+{
+    auto mesh = unitHypercube<T::value>();
+    auto Vh = Pch<2>( mesh );
+    auto const& dof = Vh->dof();
+    for ( auto const& eltWrap : elements( mesh ) )
+    {
+        size_type eltId = unwrap_ref( eltWrap ).id();
+        auto const& indices = dof->localToGlobalIndices( eltId );
+        for ( auto const& ldof : dof->localDof( eltId ) )
+            BOOST_CHECK_EQUAL( indices( ldof.first.localDof() ), ldof.second.index() );
+    }
+    BOOST_CHECK( dof->dofPoints().size() <= dof->nLocalDofWithGhost() );
+    for ( auto const& dofPoint : dof->dofPoints() )
+        BOOST_CHECK( dofPoint.first < dof->nLocalDofWithGhost() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,109 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+
+   This file is part of the Feel library
+
+   Copyright (C) 2023 Feel++ Consortium
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define BOOST_TEST_MODULE test_iqnils
+#include <feel/feelcore/testsuite.hpp>
+
+#include <feel/feeldiscr/pdh.hpp>
+#include <feel/feelfilters/loadmesh.hpp>
+#include <feel/feelalg/iqnils.hpp>
+
+using namespace Feel;
+
+namespace test_iqnils
+{
+/**
+ * fixed point map H(x) = a x + 1 with a piecewise factor a in {0.9,-0.8,0.5},
+ * the Picard iterations need about 150 iterations to converge
+ */
+template<typename ElementType>
+void
+applyMap( ElementType const& x, ElementType & hx )
+{
+    static const std::vector<double> factors = { 0.9, -0.8, 0.5 };
+    for ( size_type k = 0; k < x.localSize(); ++k )
+    {
+        hx.set( k, factors[k%factors.size()]*x( k ) + 1. );
+    }
+    hx.close();
+}
+
+template<typename IQNILSType, typename ElementType>
+int
+solveFixedPoint( IQNILSType & iqnils, ElementType & u )
+{
+    auto Xh = u.functionSpace();
+    auto uold = Xh->element();
+    auto residual = Xh->element();
+    iqnils.restart();
+    while ( !iqnils.isFinished() )
+    {
+        uold = u;
+        applyMap( uold, u );
+        residual = u;
+        residual.add( -1., uold );
+        iqnils.apply( u, residual, u );
+        iqnils.printInfo();
+        iqnils.shiftRight();
+    }
+    BOOST_CHECK( iqnils.hasConverged() );
+    return iqnils.nIterations();
+}
+}
+
+FEELPP_ENVIRONMENT_NO_OPTIONS
+
+BOOST_AUTO_TEST_SUITE( iqnils_suite )
+
+BOOST_AUTO_TEST_CASE( test_linear_map )
+{
+    using namespace test_iqnils;
+    auto mesh = loadMesh( _mesh=new Mesh<Simplex<2>>, _h=0.2 );
+    auto Xh = Pdh<0>( mesh );
+    auto u = Xh->element();
+
+    IQNILS<decay_type<decltype(Xh)>> iqnils( Xh, 0.5, 1e-8 );
+    int nIt = solveFixedPoint( iqnils, u );
+    BOOST_TEST_MESSAGE( "iqn-ils iterations : " << nIt );
+    BOOST_CHECK_LT( nIt, 10 );
+
+    // the fixed point is 1/(1-a)
+    static const std::vector<double> factors = { 0.9, -0.8, 0.5 };
+    for ( size_type k = 0; k < u.localSize(); ++k )
+        BOOST_CHECK_CLOSE( u( k ), 1./(1.-factors[k%factors.size()]), 1e-4 );
+}
+
+BOOST_AUTO_TEST_CASE( test_reuse )
+{
+    using namespace test_iqnils;
+    auto mesh = loadMesh( _mesh=new Mesh<Simplex<2>>, _h=0.2 );
+    auto Xh = Pdh<0>( mesh );
+    auto u = Xh->element();
+
+    IQNILS<decay_type<decltype(Xh)>> iqnils( Xh, 0.5, 1e-8, 1 );
+    int nItFirst = solveFixedPoint( iqnils, u );
+    // second time step from another initial guess : the columns of the first one are reused
+    u.zero();
+    int nItSecond = solveFixedPoint( iqnils, u );
+    BOOST_TEST_MESSAGE( "iqn-ils iterations : " << nItFirst << " then " << nItSecond << " with reuse" );
+    BOOST_CHECK_LE( nItSecond, nItFirst );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
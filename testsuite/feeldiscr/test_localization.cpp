@@ -0,0 +1,108 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*-
+
+  This file is part of the Feel library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include <random>
+
+#define BOOST_TEST_MODULE localization testsuite
+#include <feel/feelcore/testsuite.hpp>
+
+#include <boost/mpl/list.hpp>
+
+#include <feel/feeldiscr/mesh.hpp>
+#include <feel/feelfilters/loadmesh.hpp>
+
+using namespace Feel;
+
+FEELPP_ENVIRONMENT_NO_OPTIONS
+
+BOOST_AUTO_TEST_SUITE( localizationsuite )
+
+typedef boost::mpl::list<boost::mpl::int_<2>,boost::mpl::int_<3> > dim_types;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( batch, T, dim_types )
+{
+    using mesh_type = Mesh<Simplex<T::value,1>>;
+    using node_type = typename mesh_type::node_type;
+    using matrix_node_type = typename matrix_node<double>::type;
+    auto mesh = loadMesh( _mesh=new mesh_type, _h=( T::value == 2 )? 0.05 : 0.2 );
+
+    // random points in the elements of the mesh
+    std::mt19937 gen( 1 );
+    std::uniform_real_distribution<double> dis( 0., 1. );
+    int nPts = 3000;
+    matrix_node_type pts( T::value, nPts );
+    auto r = elements( mesh );
+    int nElts = nelements( r );
+    std::vector<index_type> eltIds;
+    for ( auto const& eltWrap : r )
+        eltIds.push_back( unwrap_ref( eltWrap ).id() );
+    for ( int i = 0; i < nPts; ++i )
+    {
+        auto const& elt = mesh->element( eltIds[i % nElts] );
+        std::vector<double> lambda( T::value+1 );
+        double sum = 0;
+        for ( auto & l : lambda )
+            sum += ( l = dis( gen ) );
+        for ( int c = 0; c < T::value; ++c )
+        {
+            pts( c, i ) = 0;
+            for ( int v = 0; v <= T::value; ++v )
+                pts( c, i ) += lambda[v]/sum*elt.point( v ).node()[c];
+        }
+    }
+
+    auto loc = mesh->tool_localization();
+    loc->setUseBVH( false );
+    loc->run_analysis( pts, invalid_v<size_type> );
+    auto resKdTree = loc->result_analysis();
+
+    for ( int nThreads : { 1, 4 } )
+    {
+        loc->setUseBVH( true );
+        loc->setNThreadsBVH( nThreads );
+        auto res = loc->run_analysis( pts, invalid_v<size_type> );
+        for ( bool found : boost::get<0>( res ) )
+            BOOST_CHECK( found );
+
+        // each point is in the element found with the same reference coordinates as the kd-tree search
+        int nPtsFound = 0;
+        for ( auto const& [eltId,ptsInElt] : loc->result_analysis() )
+        {
+            for ( auto const& ptInElt : ptsInElt )
+            {
+                ++nPtsFound;
+                node_type x = ublas::column( pts, boost::get<0>( ptInElt ) );
+                bool isin;
+                node_type xRef;
+                double dmin;
+                boost::tie( isin, xRef, dmin ) = loc->isIn( eltId, x );
+                BOOST_CHECK( isin );
+                BOOST_CHECK_SMALL( ublas::norm_2( xRef - boost::get<1>( ptInElt ) ), 1e-8 );
+            }
+        }
+        BOOST_CHECK_EQUAL( nPtsFound, nPts );
+    }
+    int nPtsKdTree = 0;
+    for ( auto const& [eltId,ptsInElt] : resKdTree )
+        nPtsKdTree += ptsInElt.size();
+    BOOST_CHECK_EQUAL( nPtsKdTree, nPts );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
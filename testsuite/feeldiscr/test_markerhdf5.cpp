@@ -14,6 +14,7 @@
 #include <feel/feeldiscr/createsubmesh.hpp>
 #include <feel/feeldiscr/projector.hpp>
 #include <feel/feeldiscr/pch.hpp>
+#include <feel/feeldiscr/thch.hpp>
 #include <feel/feelfilters/loadmesh.hpp>
 
 #define STRINGIFY(x) #x
@@ -69,6 +70,49 @@ run()
                                                                           % p.string()
                                                                           ).str());
     checkMarker(mesh3);
+    /// Load the msh file partitioned with a number of parts different from the number of processes
+    p.replace_extension("msh");
+    std::cout << "Check repartitioning with " << p << std::endl;
+    auto mesh4 = loadMesh(_mesh = new mesh_type, _filename=(boost::format( "%1%/%2%" )
+                                                                          % fs::current_path().string()
+                                                                          % p.string()
+                                                                          ).str(),
+                          _rebuild_partitions=true,
+                          _rebuild_partitions_filename=(fs::current_path() / fs::path( "markerhdf5_repartitioned.json" )).string(),
+                          _partitions=Environment::numberOfProcessors()+1 );
+    checkMarker(mesh4);
+    double meas1 = integrate( _range = elements( mesh1 ),_expr = cst(1.) ).evaluate()(0,0);
+    double meas4 = integrate( _range = elements( mesh4 ),_expr = cst(1.) ).evaluate()(0,0);
+    BOOST_CHECK_CLOSE( meas1, meas4, 1e-10 );
+    BOOST_CHECK_EQUAL( nelements( elements( mesh1 ), true ), nelements( elements( mesh4 ), true ) );
+
+#if defined(FEELPP_HAS_HDF5)
+    /// Save an element with the partition independent hdf5 format and reload it on the other partition
+    auto Xh2 = Pch<2>( mesh2 );
+    auto u2 = Xh2->element( Px()*Px()+Py() );
+    u2.save( _path=fs::current_path().string(), _name="markerhdf5_u", _type="hdf5-global" );
+    auto Xh4 = Pch<2>( mesh4 );
+    auto u4 = Xh4->element();
+    BOOST_CHECK( u4.load( _path=fs::current_path().string(), _name="markerhdf5_u", _type="hdf5-global" ) );
+    auto v4 = Xh4->element( Px()*Px()+Py() );
+    v4.add( -1., u4 );
+    BOOST_CHECK_SMALL( v4.linftyNorm(), 1e-10 );
+
+    /// Same with a composite space
+    auto Zh2 = THch<1>( mesh2 );
+    auto U2 = Zh2->element();
+    U2.element<0>().on( _range=elements( mesh2 ), _expr=P() );
+    U2.element<1>().on( _range=elements( mesh2 ), _expr=Px()-Py() );
+    U2.save( _path=fs::current_path().string(), _name="markerhdf5_U", _type="hdf5-global" );
+    auto Zh4 = THch<1>( mesh4 );
+    auto U4 = Zh4->element();
+    BOOST_CHECK( U4.load( _path=fs::current_path().string(), _name="markerhdf5_U", _type="hdf5-global" ) );
+    auto V4 = Zh4->element();
+    V4.element<0>().on( _range=elements( mesh4 ), _expr=P() );
+    V4.element<1>().on( _range=elements( mesh4 ), _expr=Px()-Py() );
+    V4.add( -1., U4 );
+    BOOST_CHECK_SMALL( V4.linftyNorm(), 1e-10 );
+#endif
 } // run
 
 } //namespace test_matching
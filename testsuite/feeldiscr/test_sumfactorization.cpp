@@ -0,0 +1,123 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*-
+
+  This file is part of the Feel library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#define BOOST_TEST_MODULE sum factorization testsuite
+#include <feel/feelcore/testsuite.hpp>
+
+#include <boost/mpl/list.hpp>
+
+#include <feel/feelalg/backend.hpp>
+#include <feel/feeldiscr/operatorsumfactorization.hpp>
+#include <feel/feeldiscr/pch.hpp>
+#include <feel/feeldiscr/pchv.hpp>
+#include <feel/feelfilters/unithypercube.hpp>
+#include <feel/feelvf/vf.hpp>
+
+using namespace Feel;
+
+FEELPP_ENVIRONMENT_NO_OPTIONS
+
+BOOST_AUTO_TEST_SUITE( sumfactorizationsuite )
+
+typedef boost::mpl::list<boost::mpl::int_<2>,boost::mpl::int_<3> > dim_types;
+
+//! max norm of the difference of the matrix-free and assembled products
+template<typename SpaceType, typename OpType, typename FormType>
+void
+checkOperator( std::shared_ptr<SpaceType> const& Vh, OpType const& op, FormType const& a )
+{
+    auto u = Vh->element();
+    u.on( _range=elements( Vh->mesh() ), _expr=Px()*Px()+Py()*Py()*Py()-2*Px()*Py() );
+    auto U = backend()->newVector( Vh );
+    *U = u;
+    U->close();
+
+    auto AU = backend()->newVector( Vh );
+    a.matrixPtr()->multVector( *U, *AU );
+    auto V = backend()->newVector( Vh );
+    op->multVector( *U, *V );
+    V->add( -1., *AU );
+    BOOST_CHECK_SMALL( V->linftyNorm(), 1e-10*std::max( 1., AU->linftyNorm() ) );
+
+    // the workspace of multAddVector is reused by the second product
+    auto W = backend()->newVector( Vh );
+    for ( int k = 1; k <= 2; ++k )
+    {
+        op->multAddVector( *U, *W );
+        auto E = backend()->newVector( Vh );
+        *E = *W;
+        E->add( -k, *AU );
+        BOOST_CHECK_SMALL( E->linftyNorm(), 1e-10*std::max( 1., k*AU->linftyNorm() ) );
+    }
+
+    auto dA = backend()->newVector( Vh );
+    a.matrixPtr()->diagonal( *dA );
+    auto d = backend()->newVector( Vh );
+    op->diagonal( *d );
+    d->add( -1., *dA );
+    BOOST_CHECK_SMALL( d->linftyNorm(), 1e-10*std::max( 1., dA->linftyNorm() ) );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( scalar, T, dim_types )
+{
+    int const order = 3;
+    auto mesh = unitHypercube<T::value,Hypercube<T::value>>( ( T::value == 2 )? 0.2 : 0.4 );
+    auto Vh = Pch<order>( mesh );
+    auto u = Vh->element();
+
+    auto op = opSumFactorization( Vh );
+    BOOST_CHECK_EQUAL( op->nNodes1D(), order+1 );
+    BOOST_CHECK_EQUAL( op->nStoredValuesByElement(), std::pow( order+1, T::value )*( 1+T::value*T::value ) );
+    op->setMass( 2. );
+    op->setDiffusion( 0.5 );
+    std::array<double,T::value> beta;
+    beta.fill( 0. );
+    beta[0] = 0.3;
+    beta[1] = 1.2;
+    op->setConvection( beta );
+
+    auto a = form2( _test=Vh, _trial=Vh );
+    a = integrate( _range=elements( mesh ),
+                   _expr=2*idt( u )*id( u ) + 0.5*gradt( u )*trans( grad( u ) ) + ( 0.3*dxt( u )+1.2*dyt( u ) )*id( u ),
+                   _quad=2*order );
+    a.close();
+    checkOperator( Vh, op, a );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( elasticity, T, dim_types )
+{
+    int const order = 2;
+    auto mesh = unitHypercube<T::value,Hypercube<T::value>>( ( T::value == 2 )? 0.2 : 0.4 );
+    auto Vh = Pchv<order>( mesh );
+    auto u = Vh->element();
+    double lambda = 2., mu = 0.7;
+
+    auto op = opSumFactorization( Vh );
+    op->setElasticity( lambda, mu );
+
+    auto a = form2( _test=Vh, _trial=Vh );
+    a = integrate( _range=elements( mesh ),
+                   _expr=mu*inner( gradt( u )+trans( gradt( u ) ), grad( u ) ) + lambda*divt( u )*div( u ),
+                   _quad=2*order );
+    a.close();
+    checkOperator( Vh, op, a );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
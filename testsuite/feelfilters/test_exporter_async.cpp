@@ -0,0 +1,103 @@
+#define BOOST_TEST_MODULE test_exporter_async
+#include <feel/feelcore/testsuite.hpp>
+
+#include <fstream>
+#include <iterator>
+
+#include <feel/feelfilters/exporter.hpp>
+#include <feel/feelfilters/unitsquare.hpp>
+#include <feel/feeldiscr/pch.hpp>
+#include <feel/feeldiscr/pchv.hpp>
+
+/** use Feel namespace */
+using namespace Feel;
+
+// the asynchronous save needs MPI_THREAD_MULTIPLE
+struct Feelpp
+{
+    Feelpp()
+        :env( _argc=boost::unit_test::framework::master_test_suite().argc,
+              _argv=boost::unit_test::framework::master_test_suite().argv,
+              _threading=mpi::threading::multiple )
+        {
+            BOOST_TEST_MESSAGE( "setup Feel++" );
+        }
+    ~Feelpp()
+        {
+            BOOST_TEST_MESSAGE( "teardown Feel++" );
+        }
+    Environment env;
+};
+FEELPP_BOOST_GLOBAL_FIXTURE( Feelpp )
+
+namespace
+{
+std::string
+readFile( fs::path const& p )
+{
+    std::ifstream ifs( p.string(), std::ios::binary );
+    return std::string( std::istreambuf_iterator<char>( ifs ), std::istreambuf_iterator<char>() );
+}
+
+template <typename MeshType>
+void
+writeSteps( std::shared_ptr<MeshType> const& mesh, std::string const& path, bool async )
+{
+    auto e = exporter(_mesh=mesh,_name="async",_path=path );
+    e->setAsyncSave( async );
+    BOOST_CHECK_EQUAL( e->asyncSave(), async );
+
+    auto Xh = Pch<2>( mesh );
+    auto Vh = Pchv<1>( mesh );
+    auto u = Xh->element();
+    auto v = Vh->element();
+    for ( int k=0; k<5; ++k )
+    {
+        double t = 0.1*k;
+        u.on(_range=elements(mesh),_expr=t*Px()*Py() );
+        v.on(_range=elements(mesh),_expr=t*vec(Py(),-Px()) );
+        e->step(t)->add( "u", u );
+        e->step(t)->add( "v", v, std::set<std::string>{"nodal","element"} );
+        e->save();
+        // the fields are copied in the step : modifying them does not change the saved step
+        u.zero();
+        v.zero();
+    }
+    e->waitSave();
+}
+}
+
+BOOST_AUTO_TEST_SUITE( exporter_async )
+
+BOOST_AUTO_TEST_CASE( test_readback )
+{
+    BOOST_TEST_MESSAGE( "thread level : " << Environment::threadLevel() );
+    auto mesh = unitSquare();
+    fs::path basePath = fs::path(Environment::exportsRepository())/fs::path("test_exporter_async")/fs::path(soption("exporter.format"));
+    fs::path pathSync = basePath/fs::path("sync");
+    fs::path pathAsync = basePath/fs::path("async");
+
+    writeSteps( mesh, pathSync.string(), false );
+    writeSteps( mesh, pathAsync.string(), true );
+    Environment::worldComm().barrier();
+
+    // read back the files written by the I/O thread : they are the same as the
+    // ones of the synchronous save (the sos files contain the path)
+    if ( !Environment::isMasterRank() )
+        return;
+    int nFiles = 0;
+    for ( auto const& entry : fs::directory_iterator( pathSync ) )
+    {
+        if ( !fs::is_regular_file( entry.status() ) || entry.path().extension() == ".sos" )
+            continue;
+        fs::path asyncFile = pathAsync/entry.path().filename();
+        BOOST_CHECK_MESSAGE( fs::exists( asyncFile ), "missing file " << asyncFile.string() );
+        if ( !fs::exists( asyncFile ) )
+            continue;
+        BOOST_CHECK_MESSAGE( readFile( entry.path() ) == readFile( asyncFile ), "file " << asyncFile.string() << " differs" );
+        ++nFiles;
+    }
+    BOOST_CHECK( nFiles > 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
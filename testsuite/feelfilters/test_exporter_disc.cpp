@@ -372,4 +372,32 @@ BOOST_AUTO_TEST_CASE( test_3 )
     e->save();
 }
 
+BOOST_AUTO_TEST_CASE( test_async )
+{
+    auto mesh = unitSquare();
+    auto e = exporter(_mesh=mesh,
+                      _path=(fs::path(Environment::exportsRepository())/fs::path("test_async")/fs::path(soption("exporter.format"))).string() );
+    e->setAsyncSave( true );
+    BOOST_CHECK( e->asyncSave() );
+
+    auto Xh = Pch<1>( mesh );
+    auto u = Xh->element();
+    std::vector<decltype( e->step( 0. ) )> steps;
+    for ( double t=0; t<0.45; t+=0.1 )
+    {
+        u.on(_range=elements(mesh),_expr=t*Px() );
+        steps.push_back( e->step(t) );
+        e->step(t)->add( "u", u );
+        e->save();
+        // the fields are copied in the step : modifying u does not change the saved step
+        u.zero();
+    }
+    e->waitSave();
+    for ( auto const& s : steps )
+    {
+        BOOST_CHECK( !s->isInMemory() );
+        BOOST_CHECK( s->isOnDisk() );
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
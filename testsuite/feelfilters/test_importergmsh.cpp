@@ -26,6 +26,7 @@
    \author Christophe Prud'homme <christophe.prudhomme@feelpp.org>
    \date 2007-06-16
  */
+#include <fstream>
 #include <sstream>
 
 // Boost.Test
@@ -267,6 +268,119 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( gmshimportexport, T, dim_types )
     BOOST_TEST_MESSAGE( "[gmshimportexport] for dimension " << T::value << " done.\n" );
 }
 
+BOOST_AUTO_TEST_CASE( gmshmappedfile )
+{
+    typedef Mesh<Simplex<2,1> > mesh_type;
+
+    // unit square split in two triangles, msh format 4.1 (ASCII)
+    std::string fname = "gmshmapped.msh";
+    if ( Environment::isMasterRank() )
+    {
+        std::ofstream ofs( fname );
+        ofs << "$MeshFormat\n4.1 0 8\n$EndMeshFormat\n"
+            << "$PhysicalNames\n2\n1 1 \"Gamma\"\n2 2 \"Omega\"\n$EndPhysicalNames\n"
+            << "$Entities\n4 4 1 0\n"
+            << "1 0 0 0 0\n2 1 0 0 0\n3 1 1 0 0\n4 0 1 0 0\n"
+            << "1 0 0 0 1 0 0 1 1 2 1 -2\n2 1 0 0 1 1 0 1 1 2 2 -3\n"
+            << "3 0 1 0 1 1 0 1 1 2 3 -4\n4 0 0 0 0 1 0 1 1 2 4 -1\n"
+            << "1 0 0 0 1 1 0 1 2 4 1 2 3 4\n$EndEntities\n"
+            << "$Nodes\n1 4 1 4\n2 1 0 4\n1\n2\n3\n4\n0 0 0\n1 0 0\n1 1 0\n0 1 0\n$EndNodes\n"
+            << "$Elements\n5 6 1 6\n"
+            << "1 1 1 1\n1 1 2\n1 2 1 1\n2 2 3\n1 3 1 1\n3 3 4\n1 4 1 1\n4 4 1\n"
+            << "2 1 2 2\n5 1 2 3\n6 1 3 4\n$EndElements\n";
+    }
+    Environment::worldComm().barrier();
+
+    // the memory mapped reader and the file stream reader build the same mesh
+    for ( bool mapped : { true, false } )
+    {
+        BOOST_TEST_MESSAGE( "[gmshmappedfile] mapped file : " << mapped );
+        auto mesh = std::make_shared<mesh_type>( Environment::worldCommSeqPtr() );
+        ImporterGmsh<mesh_type> import( fname, FEELPP_GMSH_FORMAT_VERSION, Environment::worldCommSeqPtr() );
+        import.setUseMappedFile( mapped );
+        mesh->accept( import );
+        mesh->components().set( MESH_CHECK|MESH_UPDATE_FACES|MESH_UPDATE_EDGES );
+        mesh->updateForUse();
+
+        BOOST_CHECK_EQUAL( nelements( points( mesh ) ), 4 );
+        BOOST_CHECK_EQUAL( nelements( elements( mesh ) ), 2 );
+        BOOST_CHECK_EQUAL( nelements( markedfaces( mesh, "Gamma" ) ), 4 );
+        BOOST_CHECK_EQUAL( nelements( markedelements( mesh, "Omega" ) ), 2 );
+        double area = integrate( _range=elements( mesh ), _expr=cst( 1. ) ).evaluate()(0,0);
+        double perimeter = integrate( _range=markedfaces( mesh, "Gamma" ), _expr=cst( 1. ) ).evaluate()(0,0);
+        BOOST_CHECK_SMALL( area-1., 1e-12 );
+        BOOST_CHECK_SMALL( perimeter-4., 1e-12 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( gmshmappedfile_partitioned )
+{
+    typedef Mesh<Simplex<2,1> > mesh_type;
+    typedef std::shared_ptr<mesh_type> mesh_ptrtype;
+
+    auto const& worldComm = Environment::worldComm();
+    int nProc = worldComm.localSize();
+
+    // msh file partitioned on all the processes : the node and element blocks of the
+    // other partitions are skipped by lines (ASCII) or by bytes (binary)
+    for ( GMSH_FORMAT format : { GMSH_FORMAT_ASCII, GMSH_FORMAT_BINARY } )
+    {
+        std::string fname;
+        if ( worldComm.isMasterRank() )
+        {
+            auto desc = geo( _filename="feel.geo", _dim=2, _order=1, _h=0.1 );
+            desc->setPrefix( ( boost::format( "gmshmapped-part%1%-%2%" ) % nProc % ( ( format == GMSH_FORMAT_ASCII )? "ascii" : "binary" ) ).str() );
+            desc->setWorldComm( Environment::worldCommSeqPtr() );
+            desc->setNumberOfPartitions( nProc );
+            desc->setMshFileByPartition( 0 );
+            desc->setFileFormat( format );
+            fname = boost::get<0>( desc->generate( desc->prefix(), desc->description(), true ) );
+        }
+        mpi::broadcast( worldComm.globalComm(), fname, worldComm.masterRank() );
+        BOOST_TEST_MESSAGE( "[gmshmappedfile_partitioned] " << fname << " on " << nProc << " processes" );
+
+        std::vector<mesh_ptrtype> meshes;
+        for ( bool mapped : { true, false } )
+        {
+            auto mesh = std::make_shared<mesh_type>( Environment::worldCommPtr() );
+            ImporterGmsh<mesh_type> import( fname, FEELPP_GMSH_FORMAT_VERSION, Environment::worldCommPtr() );
+            import.setUseMappedFile( mapped );
+            mesh->accept( import );
+            mesh->components().set( MESH_CHECK|MESH_UPDATE_FACES|MESH_UPDATE_EDGES );
+            mesh->updateForUse();
+            meshes.push_back( mesh );
+        }
+        auto const& meshMapped = meshes[0];
+        auto const& meshStream = meshes[1];
+
+        // each process only owns its partition
+        size_type nLocalElements = nelements( elements( meshMapped ), false );
+        size_type nGlobalElements = nelements( elements( meshMapped ), true );
+        BOOST_CHECK_GT( nLocalElements, 0 );
+        if ( nProc > 1 )
+            BOOST_CHECK_LT( nLocalElements, nGlobalElements );
+
+        // the memory mapped reader and the file stream reader build the same partition
+        BOOST_CHECK_EQUAL( nLocalElements, nelements( elements( meshStream ), false ) );
+        BOOST_CHECK_EQUAL( meshMapped->numElements(), meshStream->numElements() );
+        BOOST_CHECK_EQUAL( meshMapped->numPoints(), meshStream->numPoints() );
+        BOOST_CHECK_EQUAL( nelements( boundaryfaces( meshMapped ), false ), nelements( boundaryfaces( meshStream ), false ) );
+        for ( auto const& eltWrap : elements( meshMapped ) )
+        {
+            auto const& elt = boost::unwrap_ref( eltWrap );
+            BOOST_REQUIRE( meshStream->hasElement( elt.id() ) );
+            BOOST_CHECK_SMALL( ublas::norm_2( elt.barycenter() - meshStream->element( elt.id() ).barycenter() ), 1e-12 );
+        }
+        double areaMapped = integrate( _range=elements( meshMapped ), _expr=cst( 1. ) ).evaluate()(0,0);
+        double areaStream = integrate( _range=elements( meshStream ), _expr=cst( 1. ) ).evaluate()(0,0);
+        double perimeterMapped = integrate( _range=boundaryfaces( meshMapped ), _expr=cst( 1. ) ).evaluate()(0,0);
+        double perimeterStream = integrate( _range=boundaryfaces( meshStream ), _expr=cst( 1. ) ).evaluate()(0,0);
+        BOOST_CHECK_GT( areaMapped, 0. );
+        BOOST_CHECK_SMALL( areaMapped-areaStream, 1e-12 );
+        BOOST_CHECK_SMALL( perimeterMapped-perimeterStream, 1e-12 );
+    }
+}
+
 /*
 int BOOST_TEST_CALL_DECL
 main( int argc, char* argv[] )
@@ -93,6 +93,9 @@ class TestDistanceToRange
         mesh_ptrtype const& mesh() const { return M_mesh; }
 
         int run();
+        void runFastIterative();
+        void runSpatialIndex();
+        void runInterface();
 
     private:
         mesh_ptrtype M_mesh;
@@ -159,6 +162,174 @@ TestDistanceToRange<Dim, Order>::run()
     return 1;
 }
 
+template<uint16_type Dim, uint16_type Order>
+void
+TestDistanceToRange<Dim, Order>::runFastIterative()
+{
+    if( !M_mesh )
+        this->setMesh();
+    auto const& mesh = this->mesh();
+    auto Vh = Pch<Order>( mesh );
+
+    DistanceToRange distToRange( Vh );
+    auto distFMM = distToRange.unsignedDistance( boundaryfaces( mesh ) );
+    distToRange.fastMarching()->setMethod( FastMarchingMethod::FIM );
+    distToRange.fastMarching()->setNThreads( 4 );
+    // the active lists of this coarse mesh have a few tens of dofs: lower the
+    // grain size so that the sweeps are actually split between the threads
+    distToRange.fastMarching()->setGrainSize( 8 );
+    auto distFIM = distToRange.unsignedDistance( boundaryfaces( mesh ) );
+
+    // the fast iterative method converges to the fast marching solution
+    double errMax = 0.;
+    for( size_type k = 0; k < Vh->nLocalDof(); ++k )
+        errMax = std::max( errMax, std::abs( distFIM(k) - distFMM(k) ) );
+    errMax = mpi::all_reduce( Vh->worldComm(), errMax, mpi::maximum<double>() );
+    BOOST_TEST_MESSAGE( "|FIM-FMM|_inf = " << errMax );
+    BOOST_CHECK_SMALL( errMax, 1e-2*mesh->hAverage() );
+}
+
+template<uint16_type Dim, uint16_type Order>
+void
+TestDistanceToRange<Dim, Order>::runSpatialIndex()
+{
+    if( !M_mesh )
+        this->setMesh();
+    auto const& mesh = this->mesh();
+    auto Vh = Pch<Order>( mesh );
+
+    DistanceToRange distToRange( Vh );
+    distToRange.setMethod( DistanceMethod::SpatialIndex );
+    distToRange.setNThreads( 4 );
+    auto signedDist = distToRange.signedDistance( boundaryfaces( mesh ) );
+    auto const nearest = distToRange.nearestFaces( boundaryfaces( mesh ) );
+
+    // exact signed distance to the boundary of the unit square/cube, negative inside
+    double errMax = 0.;
+    for( size_type k = 0; k < Vh->nLocalDof(); ++k )
+    {
+        auto const& pt = boost::get<0>( Vh->dof()->dofPoint( k ) );
+        double exactDist = 1.;
+        for( int c = 0; c < Dim; ++c )
+            exactDist = std::min( exactDist, std::min( pt[c], 1.-pt[c] ) );
+        errMax = std::max( errMax, std::abs( signedDist(k) + exactDist ) );
+        BOOST_CHECK( nearest[k].found() );
+        BOOST_CHECK_SMALL( nearest[k].distance - signedDist(k), 1e-12 );
+        auto P = eigenMap<Dim>( pt );
+        BOOST_CHECK_SMALL( (P - nearest[k].closestPoint).norm() - std::abs( nearest[k].distance ), 1e-12 );
+        if( nearest[k].processId == mesh->worldComm().localRank() )
+            BOOST_CHECK( mesh->face( nearest[k].faceId ).isOnBoundary() );
+    }
+    errMax = mpi::all_reduce( Vh->worldComm(), errMax, mpi::maximum<double>() );
+    BOOST_TEST_MESSAGE( "|d-d_exact|_inf = " << errMax );
+    BOOST_CHECK_SMALL( errMax, 1e-10 );
+
+    // the narrow band distance is exact in the band
+    distToRange.setMaxDistance( 3.*mesh->hAverage() );
+    auto unsignedDistNarrowBand = distToRange.unsignedDistance( boundaryfaces( mesh ) );
+    for( size_type k = 0; k < Vh->nLocalDof(); ++k )
+    {
+        if( -signedDist(k) < 3.*mesh->hAverage() )
+            BOOST_CHECK_SMALL( unsignedDistNarrowBand(k) + signedDist(k), 1e-12 );
+    }
+}
+
+template<uint16_type Dim, uint16_type Order>
+void
+TestDistanceToRange<Dim, Order>::runInterface()
+{
+    if( !M_mesh )
+        this->setMesh();
+    auto const& mesh = this->mesh();
+    auto Vh = Pch<Order>( mesh );
+    rank_type const pid = mesh->worldComm().localRank();
+
+    // interior interface: boundary of the elements whose barycenter is in [0.3,0.7]^d
+    auto isInside = []( auto const& elt ) {
+        auto const G = elt.barycenter();
+        bool inside = true;
+        for( int c = 0; c < Dim; ++c )
+            inside = inside && G[c] > 0.3 && G[c] < 0.7;
+        return inside;
+    };
+    Range<mesh_type,MESH_FACES> interfaceFaces( mesh );
+    std::vector<double> interfaceVertices;
+    std::set<size_type> interfaceFaceIds;
+    // the faces of the partition interfaces are also needed by the process which does not own them
+    for( auto const& facew: faces( mesh, EntityProcessType::ALL ) )
+    {
+        auto const& face = boost::unwrap_ref( facew );
+        if( !face.isConnectedTo0() || !face.isConnectedTo1() || isInside( face.element0() ) == isInside( face.element1() )
+                || !interfaceFaceIds.insert( face.id() ).second )
+            continue;
+        interfaceFaces.push_back( face );
+        if( face.processId() == pid )
+        {
+            auto const F = eigenMap<Dim>( face.vertices() );
+            interfaceVertices.insert( interfaceVertices.end(), F.data(), F.data()+Dim*Dim );
+        }
+    }
+    interfaceFaces.shrink_to_fit();
+    std::vector< std::vector<double> > allInterfaceVertices;
+    mpi::all_gather( mesh->worldComm().localComm(), interfaceVertices, allInterfaceVertices );
+    interfaceVertices.clear();
+    for( auto const& v: allInterfaceVertices )
+        interfaceVertices.insert( interfaceVertices.end(), v.begin(), v.end() );
+
+    // the dofs of the inside elements which are not on the interface are inside
+    std::vector<int> dofSide( Vh->nLocalDof(), 0 );
+    for( auto const& eltw: elements( mesh ) )
+    {
+        auto const& elt = boost::unwrap_ref( eltw );
+        for( auto const& ldof: Vh->dof()->localDof( elt.id() ) )
+            dofSide[ldof.second.index()] = isInside( elt ) ? -1 : 1;
+    }
+
+    DistanceToRange distToRange( Vh );
+    distToRange.setMethod( DistanceMethod::SpatialIndex );
+    distToRange.setNThreads( 4 );
+    auto signedDist = distToRange.signedDistance( interfaceFaces );
+    auto const nearest = distToRange.nearestFaces( interfaceFaces );
+    distToRange.setMethod( DistanceMethod::FastMarching );
+    auto signedDistFMM = distToRange.signedDistance( interfaceFaces );
+
+    // the faces are oriented by the inside elements: same sign as the flood fill
+    DistanceQuery<Dim> query( 4 );
+    query.update( interfaceFaces, DistanceQuery<Dim>::dofPointsBox( Vh ), -1., isInside );
+    BOOST_CHECK( query.isOriented() );
+    auto const signedQuery = query.nearest( Vh, -1., true );
+    DistanceQuery<Dim> queryNotOriented( interfaceFaces, 4 );
+    BOOST_CHECK( !queryNotOriented.isOriented() );
+
+    double const h = mesh->hAverage();
+    for( size_type k = 0; k < Vh->nLocalDof(); ++k )
+    {
+        auto P = eigenMap<Dim>( boost::get<0>( Vh->dof()->dofPoint( k ) ) );
+        // brute force distance to all the interface faces
+        double distExact = std::numeric_limits<double>::max();
+        for( size_type f = 0; f < interfaceVertices.size()/(Dim*Dim); ++f )
+        {
+            Eigen::Map<const Eigen::Matrix<double,Dim,Dim>> F( interfaceVertices.data()+Dim*Dim*f );
+            int feature;
+            Eigen::Matrix<double,Dim,1> C;
+            if constexpr ( Dim == 2 )
+                C = Feel::detail::geometry::closestPointOnSegment( P, F.col(0), F.col(1), feature );
+            else
+                C = Feel::detail::geometry::closestPointOnTriangle( P, F.col(0), F.col(1), F.col(2), feature );
+            distExact = std::min( distExact, ( P-C ).norm() );
+        }
+        BOOST_CHECK_SMALL( std::abs( signedDist(k) ) - distExact, 1e-12 );
+        BOOST_CHECK_SMALL( nearest[k].distance - signedDist(k), 1e-12 );
+        if( distExact < 1e-10 )
+            continue;
+        // negative inside, as the fast-marching
+        BOOST_CHECK_EQUAL( signedDist(k) < 0., dofSide[k] < 0 );
+        BOOST_CHECK_EQUAL( signedQuery[k].distance < 0., dofSide[k] < 0 );
+        if( std::abs( signedDistFMM(k) ) > h )
+            BOOST_CHECK_EQUAL( signedDistFMM(k) < 0., signedDist(k) < 0. );
+    }
+}
+
 FEELPP_ENVIRONMENT_WITH_OPTIONS( makeAbout(), makeOptions() )
 
 
@@ -177,4 +348,31 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( testnD, T, dim_types )
 
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE( testFastIterative, T, dim_types )
+{
+    using namespace Feel;
+
+    TestDistanceToRange<T::value, 1> test;
+    test.setMesh();
+    test.runFastIterative();
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( testSpatialIndex, T, dim_types )
+{
+    using namespace Feel;
+
+    TestDistanceToRange<T::value, 1> test;
+    test.setMesh();
+    test.runSpatialIndex();
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( testInterface, T, dim_types )
+{
+    using namespace Feel;
+
+    TestDistanceToRange<T::value, 1> test;
+    test.setMesh();
+    test.runInterface();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
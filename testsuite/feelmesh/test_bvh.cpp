@@ -2,6 +2,7 @@
 #include <feel/feelcore/testsuite.hpp>
 #include <feel/feelfilters/loadmesh.hpp>
 #include <feel/feelmesh/bvh.hpp>
+#include <random>
 using namespace Feel;
 
 inline
@@ -167,4 +168,48 @@ BOOST_AUTO_TEST_CASE( intersection_bvh_3D )
     test3D( elements(submesh) );
 }
 
+BOOST_AUTO_TEST_CASE( intersection_bvh_3D_batch )
+{
+    using mesh_type = Mesh<Simplex<3,1,3>>;
+    using bvh_ray_type = BVHRay<3>;
+    auto mesh = loadMesh(_mesh = new mesh_type, _filename=soption(_name="mesh3D.filename" ) );
+    auto rangeFaces = markedfaces(mesh,{"CavityBottom","CavitySides","CavityTop"});
+
+    // rays inside the cavity [-1,1]^3, half of them by packets of the same direction
+    std::mt19937 gen( 42 );
+    std::uniform_real_distribution<double> dist( -0.9, 0.9 );
+    std::vector<bvh_ray_type> rays;
+    std::vector<double> distances;
+    for ( int k = 0; k < 2000; ++k )
+    {
+        Eigen::Vector3d origin( dist( gen ), dist( gen ), dist( gen ) );
+        Eigen::Vector3d dir( dist( gen ), dist( gen ), dist( gen ) );
+        if ( ( k/8 ) % 2 == 0 )
+            dir = Eigen::Vector3d( 1., 0.2, 0.1 );
+        dir.normalize();
+        double d = std::numeric_limits<double>::max();
+        for ( int c = 0; c < 3; ++c )
+            if ( std::abs( dir[c] ) > 1e-12 )
+                d = std::min( d, ( ( dir[c] > 0 ? 1. : -1. ) - origin[c] )/dir[c] );
+        rays.push_back( bvh_ray_type( origin, dir ) );
+        distances.push_back( d );
+    }
+
+    for ( std::string kind : { "in-house", "third-party" } )
+    {
+        for ( int nThreads : { 1, 4 } )
+        {
+            BOOST_TEST_MESSAGE( "kind=" << kind << " nthreads=" << nThreads );
+            auto bvh = boundingVolumeHierarchy(_range=rangeFaces,_kind=kind,_nthreads=nThreads);
+            auto res = bvh->intersect(_ray=rays);
+            BOOST_REQUIRE_EQUAL( res.size(), rays.size() );
+            for ( std::size_t k = 0; k < rays.size(); ++k )
+            {
+                BOOST_REQUIRE_EQUAL( res[k].size(), 1 );
+                BOOST_CHECK_SMALL( res[k].front().distance() - distances[k], 1e-8 );
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
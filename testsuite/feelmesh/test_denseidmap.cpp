@@ -0,0 +1,119 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*-
+
+  This file is part of the Feel library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include <map>
+#include <random>
+
+#define BOOST_TEST_MODULE dense id map testsuite
+#include <feel/feelcore/testsuite.hpp>
+
+#include <feel/feelmesh/denseidmap.hpp>
+#include <feel/feeldiscr/mesh.hpp>
+#include <feel/feelfilters/loadmesh.hpp>
+
+using namespace Feel;
+
+FEELPP_ENVIRONMENT_NO_OPTIONS
+
+BOOST_AUTO_TEST_SUITE( denseidmapsuite )
+
+BOOST_AUTO_TEST_CASE( container )
+{
+    // small pages to cross the page boundaries
+    using map_type = DenseIdMap<uint32_type,std::string,8>;
+    map_type m;
+    std::map<uint32_type,std::string> ref;
+    std::mt19937 gen( 1 );
+    for ( int k = 0; k < 5000; ++k )
+    {
+        uint32_type id = gen() % 200;
+        if ( gen() % 3 < 2 )
+        {
+            auto [it,inserted] = m.emplace( std::make_pair( id, std::to_string( id ) ) );
+            BOOST_CHECK_EQUAL( inserted, ref.emplace( id, std::to_string( id ) ).second );
+            BOOST_CHECK_EQUAL( it->first, id );
+        }
+        else
+        {
+            auto it = m.find( id );
+            auto itRef = ref.find( id );
+            BOOST_REQUIRE_EQUAL( it == m.end(), itRef == ref.end() );
+            if ( it != m.end() )
+            {
+                auto next = m.erase( it );
+                auto nextRef = ref.erase( itRef );
+                BOOST_REQUIRE_EQUAL( next == m.end(), nextRef == ref.end() );
+                if ( next != m.end() )
+                    BOOST_CHECK_EQUAL( next->first, nextRef->first );
+            }
+        }
+    }
+    BOOST_CHECK_EQUAL( m.size(), ref.size() );
+
+    // iteration by increasing id
+    auto itRef = ref.begin();
+    for ( auto const& [id,s] : m )
+    {
+        BOOST_REQUIRE( itRef != ref.end() );
+        BOOST_CHECK_EQUAL( id, itRef->first );
+        BOOST_CHECK_EQUAL( s, itRef->second );
+        ++itRef;
+    }
+
+    map_type c( m );
+    BOOST_CHECK_EQUAL( c.size(), m.size() );
+    map_type d( std::move( c ) );
+    BOOST_CHECK_EQUAL( d.size(), m.size() );
+    BOOST_CHECK( c.empty() );
+
+    // the references are not invalidated by the insertions
+    std::string const* first = &m.begin()->second;
+    for ( uint32_type id = 1000; id < 3000; ++id )
+        m.emplace( std::make_pair( id, std::string( "x" ) ) );
+    BOOST_CHECK_EQUAL( first, &m.begin()->second );
+    map_type::const_iterator cit = m.find( 2000 );
+    BOOST_CHECK( cit != m.end() );
+    BOOST_CHECK_EQUAL( cit->second, "x" );
+
+    m.clear();
+    BOOST_CHECK( m.empty() );
+    BOOST_CHECK( m.begin() == m.end() );
+}
+
+BOOST_AUTO_TEST_CASE( mesh_storage )
+{
+    using mesh_type = Mesh<Simplex<2>>;
+    auto mesh = loadMesh( _mesh=new mesh_type );
+    // the storage of the entities is indexed by the ids
+    for ( auto const& [id,elt] : mesh->elements() )
+        BOOST_CHECK_EQUAL( id, elt.id() );
+    for ( auto const& [id,pt] : mesh->points() )
+        BOOST_CHECK_EQUAL( id, pt.id() );
+    size_type nElts = 0;
+    for ( auto const& eltWrap : elements( mesh ) )
+    {
+        auto const& elt = unwrap_ref( eltWrap );
+        BOOST_CHECK_EQUAL( &mesh->element( elt.id() ), &elt );
+        ++nElts;
+    }
+    BOOST_CHECK_EQUAL( nElts, nelements( elements( mesh ) ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,110 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*-
+
+  This file is part of the Feel library
+
+  Copyright (C) 2023 Feel++ Consortium
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+#include <map>
+#include <random>
+
+#define BOOST_TEST_MODULE entities matching testsuite
+#include <feel/feelcore/testsuite.hpp>
+
+#include <boost/mpl/list.hpp>
+
+#include <feel/feelmesh/entitiesmatching.hpp>
+#include <feel/feeldiscr/mesh.hpp>
+#include <feel/feelfilters/unithypercube.hpp>
+
+using namespace Feel;
+
+FEELPP_ENVIRONMENT_NO_OPTIONS
+
+BOOST_AUTO_TEST_SUITE( entitiesmatchingsuite )
+
+typedef boost::mpl::list<boost::mpl::int_<2>,boost::mpl::int_<3> > dim_types;
+
+BOOST_AUTO_TEST_CASE( first_entity )
+{
+    // random triangles with a few vertices to get many duplicates
+    size_type n = 20000;
+    std::mt19937 gen( 1 );
+    std::vector<std::array<size_type,3>> tri( n );
+    for ( auto& t : tri )
+        for ( auto& v : t )
+            v = gen() % 30;
+
+    std::map<std::array<size_type,3>,size_type> ref;
+    std::vector<size_type> firstRef( n );
+    for ( size_type k = 0; k < n; ++k )
+    {
+        auto s = tri[k];
+        std::sort( s.begin(), s.end() );
+        firstRef[k] = ref.emplace( s, k ).first->second;
+    }
+    for ( int nThreads : { 1, 3, 8 } )
+    {
+        auto first = firstEntityWithSameVertices<3,size_type>( n, [&tri]( size_type k, auto& ids ) { ids = tri[k]; }, nThreads );
+        BOOST_CHECK( first == firstRef );
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( mesh_entities, T, dim_types )
+{
+    using mesh_type = Mesh<Simplex<T::value>>;
+    auto nThreadsDefault = ioption( _name="mesh.update.nthreads" );
+    double h = ( T::value == 2 )? 0.05 : 0.15;
+
+    Environment::setOptionValue( "mesh.update.nthreads", int( 1 ) );
+    auto mesh = unitHypercube<T::value,Simplex<T::value>>( h );
+    Environment::setOptionValue( "mesh.update.nthreads", int( 4 ) );
+    auto meshThreaded = unitHypercube<T::value,Simplex<T::value>>( h );
+    Environment::setOptionValue( "mesh.update.nthreads", nThreadsDefault );
+    BOOST_CHECK_EQUAL( meshThreaded->nThreadsUpdate(), 4 );
+
+    BOOST_CHECK_EQUAL( mesh->numElements(), meshThreaded->numElements() );
+    BOOST_CHECK_EQUAL( mesh->numFaces(), meshThreaded->numFaces() );
+    BOOST_CHECK_EQUAL( nelements( boundaryfaces( mesh ) ), nelements( boundaryfaces( meshThreaded ) ) );
+    if constexpr ( T::value == 3 )
+        BOOST_CHECK_EQUAL( mesh->numEdges(), meshThreaded->numEdges() );
+
+    // the faces are numbered in the same order and connect the same elements
+    for ( auto const& [id,face] : mesh->faces() )
+    {
+        BOOST_REQUIRE( meshThreaded->hasFace( id ) );
+        auto const& faceThreaded = meshThreaded->face( id );
+        BOOST_CHECK_EQUAL( face.isOnBoundary(), faceThreaded.isOnBoundary() );
+        BOOST_CHECK_EQUAL( face.element0().id(), faceThreaded.element0().id() );
+        if ( face.isConnectedTo1() )
+            BOOST_CHECK_EQUAL( face.element1().id(), faceThreaded.element1().id() );
+    }
+    // each internal face of an element is shared with its neighbor
+    for ( auto const& eltWrap : elements( meshThreaded ) )
+    {
+        auto const& elt = unwrap_ref( eltWrap );
+        for ( uint16_type j = 0; j < elt.nNeighbors(); ++j )
+        {
+            auto const& face = elt.face( j );
+            if ( face.isOnBoundary() )
+                continue;
+            size_type neighId = ( face.element0().id() == elt.id() )? face.element1().id() : face.element0().id();
+            BOOST_CHECK_EQUAL( elt.neighbor( j ), neighId );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
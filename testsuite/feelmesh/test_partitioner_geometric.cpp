@@ -0,0 +1,99 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*-
+
+ This file is part of the Feel++ library
+
+ Copyright (C) 2023 Feel++ Consortium
+
+ This library is free software; you can redistribute it and/or
+ modify it under the terms of the GNU Lesser General Public
+ License as published by the Free Software Foundation; either
+ version 2.1 of the License, or (at your option) any later version.
+
+ This library is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ Lesser General Public License for more details.
+
+ You should have received a copy of the GNU Lesser General Public
+ License along with this library; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#define BOOST_TEST_MODULE test_partitioner_geometric
+#include <feel/feelcore/testsuite.hpp>
+
+#include <feel/feelfilters/loadmesh.hpp>
+#include <feel/feelmesh/partitionmesh.hpp>
+
+
+FEELPP_ENVIRONMENT_NO_OPTIONS
+
+BOOST_AUTO_TEST_SUITE( partitioner_geometric )
+
+BOOST_AUTO_TEST_CASE( partitioner_geometric_balance )
+{
+    using namespace Feel;
+    auto const& comm = Environment::worldComm().localComm();
+    // points of a 16x16 grid distributed on the processes
+    const int d = 2, nx = 16;
+    std::vector<double> coords;
+    for ( int i = comm.rank(); i < nx*nx; i += comm.size() )
+    {
+        coords.push_back( i % nx );
+        coords.push_back( i / nx );
+    }
+    const rank_type nParts = 4;
+    for ( auto method : { GeometricPartitioning::Morton, GeometricPartitioning::Hilbert, GeometricPartitioning::RCB } )
+    {
+        auto parts = geometricPartition( comm, coords, d, nParts, method );
+        BOOST_CHECK_EQUAL( parts.size(), coords.size()/d );
+        std::vector<int> nPtsByPart( nParts, 0 ), nPtsByPartGlobal( nParts, 0 );
+        for ( rank_type p : parts )
+        {
+            BOOST_REQUIRE( p < nParts );
+            ++nPtsByPart[p];
+        }
+        mpi::all_reduce( comm, nPtsByPart.data(), nParts, nPtsByPartGlobal.data(), std::plus<int>() );
+        for ( rank_type p = 0; p < nParts; ++p )
+            BOOST_CHECK_EQUAL( nPtsByPartGlobal[p], nx*nx/nParts );
+    }
+}
+
+BOOST_AUTO_TEST_CASE( partitioner_geometric_sequential )
+{
+    using namespace Feel;
+    if ( Environment::isMasterRank() )
+    {
+        auto mesh = loadMesh(_mesh=new Mesh<Simplex<2>>( Environment::worldCommSeqPtr()),
+                             _update=size_type(MESH_UPDATE_ELEMENTS_ADJACENCY|MESH_NO_UPDATE_MEASURES) );
+
+        int numPartition = std::min((int)4, (int)mesh->numElements() );
+        PartitionerGeometric<decltype(mesh)> partitioner( GeometricPartitioning::RCB );
+        partitioner.partition( mesh, numPartition );
+
+        for (rank_type p=0;p<numPartition;++p)
+        {
+            auto rangeElements = mesh->elementsWithProcessId( p );
+            int nElt = std::distance( std::get<0>( rangeElements ), std::get<1>( rangeElements ) );
+            BOOST_CHECK( nElt > 0 );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE( partitioner_geometric_migrate )
+{
+    using namespace Feel;
+    using mesh_type = Mesh<Simplex<2>>;
+    auto mesh = loadMesh(_mesh=new mesh_type );
+    size_type nEltsGlobal = mesh->numGlobalElements();
+
+    auto partitionSet = partitionMeshGeometric( mesh, GeometricPartitioning::Hilbert );
+    auto newMesh = partitionSet->mesh();
+    BOOST_CHECK_EQUAL( newMesh->numGlobalElements(), nEltsGlobal );
+    BOOST_CHECK_EQUAL( partitionSet->numLocalPartition(), 1 );
+    BOOST_CHECK_EQUAL( newMesh->markerNames().size(), mesh->markerNames().size() );
+    int nActiveElts = nelements( elements( newMesh ) );
+    BOOST_CHECK( nActiveElts > 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,88 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t  -*- */
+
+#define BOOST_TEST_MODULE test_assembly_coloring
+
+#include <feel/feelcore/testsuite.hpp>
+#include <feel/feelfilters/loadmesh.hpp>
+#include <feel/feelfilters/unithypercube.hpp>
+#include <feel/feeldiscr/pch.hpp>
+#include <feel/feeldiscr/elementcoloring.hpp>
+#include <feel/feelvf/vf.hpp>
+
+using namespace Feel;
+
+FEELPP_ENVIRONMENT_NO_OPTIONS
+BOOST_AUTO_TEST_SUITE( assembly_coloring_suite )
+
+typedef boost::mpl::list<boost::mpl::int_<2>,boost::mpl::int_<3> > dim_types;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_coloring, T, dim_types )
+{
+    auto mesh = unitHypercube<T::value>();
+    auto Vh = Pch<2>( mesh );
+    auto const& dof = Vh->dof();
+    std::vector<size_type> eltIds;
+    for ( auto const& eltWrap : elements( mesh ) )
+        eltIds.push_back( unwrap_ref( eltWrap ).id() );
+
+    auto colors = elementColoring( eltIds.size(), dof->nLocalDofWithGhost(),
+                                   [&]( size_type k ) -> auto { return dof->localToGlobalIndices( eltIds[k] ); } );
+    BOOST_CHECK( !colors.empty() );
+
+    size_type nColoredElements = 0;
+    for ( auto const& color : colors )
+    {
+        nColoredElements += color.size();
+        std::set<size_type> dofsInColor;
+        for ( size_type k : color )
+        {
+            auto const& indices = dof->localToGlobalIndices( eltIds[k] );
+            for ( int i = 0; i < indices.size(); ++i )
+                BOOST_CHECK( dofsInColor.insert( indices(i) ).second );
+        }
+    }
+    BOOST_CHECK_EQUAL( nColoredElements, eltIds.size() );
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_assembly, T, dim_types )
+{
+    auto mesh = unitHypercube<T::value>();
+    auto Vh = Pch<2>( mesh );
+    auto u = Vh->element( Px()*Px()+Py() );
+
+    auto assembleForms = [&]()
+        {
+            auto a = form2( _test=Vh, _trial=Vh );
+            a = integrate( _range=elements( mesh ), _expr=gradt( u )*trans( grad( u ) ) + idt( u )*id( u ) );
+            // second assembly in the same (not closed) matrix/vector
+            a += integrate( _range=elements( mesh ), _expr=Px()*idt( u )*id( u ) );
+            a.close();
+            auto l = form1( _test=Vh );
+            l = integrate( _range=elements( mesh ), _expr=( Px()+1 )*id( u ) );
+            l += integrate( _range=elements( mesh ), _expr=Py()*id( u ) );
+            l.close();
+            return std::make_pair( a( u, u ), l( u ) );
+        };
+
+    bool parCPUEnable = boption( _name="parallel.cpu.enable" );
+    std::string parCPUImpl = soption( _name="parallel.cpu.impl" );
+    int parCPURestrict = ioption( _name="parallel.cpu.restrict" );
+
+    auto [aSerial,lSerial] = assembleForms();
+
+    Environment::setOptionValue( "parallel.cpu.enable", bool( true ) );
+    Environment::setOptionValue( "parallel.cpu.impl", std::string( "coloring" ) );
+    Environment::setOptionValue( "parallel.cpu.restrict", int( 4 ) );
+    auto [aColoring,lColoring] = assembleForms();
+    // all the assemblies use the same range : the colouring is computed once
+    BOOST_CHECK_EQUAL( Vh->dof()->elementColoringCache().size(), 1 );
+
+    Environment::setOptionValue( "parallel.cpu.enable", parCPUEnable );
+    Environment::setOptionValue( "parallel.cpu.impl", parCPUImpl );
+    Environment::setOptionValue( "parallel.cpu.restrict", parCPURestrict );
+
+    BOOST_CHECK_CLOSE( aSerial, aColoring, 1e-10 );
+    BOOST_CHECK_CLOSE( lSerial, lColoring, 1e-10 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
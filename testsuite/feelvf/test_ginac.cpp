@@ -960,4 +960,36 @@ BOOST_AUTO_TEST_CASE( test_mapabcd )
     a1b.setParameterValues( { { "t", 1.75 } } );
     BOOST_CHECK_CLOSE( a1b.evaluate()(0,0), 0.5, 1e-12 );
 }
+BOOST_AUTO_TEST_CASE( test_tape )
+{
+    // in-process evaluation (GinacTape) against the compiled library
+    using mesh_t = Mesh<Simplex<2, 1>>;
+    auto mesh = loadMesh( _mesh = new mesh_t );
+    std::vector<std::string> exprs = { "x*y+sin(x)^2-y:x:y",
+                                       "exp(-x)/(1+y^2)+u*y^(-3/2):x:y:u",
+                                       "sqrt(x^2+y^2)*atan2(y,x+2)-abs(x-y):x:y",
+                                       "clamp(x,0.2,0.6)+mod(3*y,1)+step1(x,0.5)+rectangle(y,0.2,0.4):x:y" };
+    for ( std::string const& e : exprs )
+    {
+        Environment::setOptionValue( "ginac.compile", true );
+        auto ec = expr( e );
+        ec.setParameterValues( { { "u", 2 } } );
+        Environment::setOptionValue( "ginac.compile", false );
+        auto et = expr( e );
+        et.setParameterValues( { { "u", 2 } } );
+        BOOST_CHECK( !ec.expression().tape() );
+        BOOST_CHECK( et.expression().tape() );
+
+        double intc = integrate( _range=elements(mesh), _expr=ec ).evaluate()(0,0);
+        double intt = integrate( _range=elements(mesh), _expr=et ).evaluate()(0,0);
+        BOOST_CHECK_CLOSE( intc, intt, 1e-10 );
+    }
+
+    Environment::setOptionValue( "ginac.compile", false );
+    auto m = expr<2,2>( "{x^2,-y,x*y,cos(x)}:x:y" );
+    BOOST_CHECK( m.expression().tape() );
+    auto intm = integrate( _range=elements(mesh), _expr=m ).evaluate();
+    auto intmRef = integrate( _range=elements(mesh), _expr=mat<2,2>( Px()*Px(), -Py(), Px()*Py(), cos(Px()) ) ).evaluate();
+    BOOST_CHECK_SMALL( ( intm - intmRef ).norm(), 1e-10 );
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -138,6 +138,11 @@ void checkViewFactorRaytracing(std::string const& prefix)
 
     BOOST_CHECK_MESSAGE(rtvf.maxDevReciprocity()<2e-2, fmt::format("Max dev reciprocity less than 2e-2, {}",rtvf.maxDevReciprocity()));
 
+    // standard error estimated from the rounds of rays
+    double maxError = rtvf.viewFactorsError().maxCoeff();
+    BOOST_TEST_MESSAGE( fmt::format("Max standard error {}", maxError ) );
+    BOOST_CHECK_MESSAGE( maxError > 0 && maxError < 2e-2, fmt::format("Max standard error less than 2e-2, {}", maxError ) );
+
     double rtol=8e-2;
     if(prefix=="cube-raytracing")
     {
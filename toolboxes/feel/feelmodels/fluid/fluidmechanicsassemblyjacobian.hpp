@@ -192,6 +192,7 @@ FluidMechanics<ConvexType,BasisVelocityType,BasisPressureType>::updateJacobian(
         {
             auto const& range = this->materialsProperties()->rangeMeshElementsByMaterial( this->mesh(),matName );
             auto const& matProps = this->materialsProperties()->materialProperties( matName );
+            boost::mpi::timer timerMaterialAssembly; // element cost for the load rebalancing
 
             // stress tensor sigma : grad(v)
             if ( BuildCstPart )
@@ -327,12 +328,15 @@ FluidMechanics<ConvexType,BasisVelocityType,BasisPressureType>::updateJacobian(
                 }
             }
 
+            // the GLS stabilization charges its cost to its own element ranges
+            double materialAssemblyCost = timerMaterialAssembly.elapsed();
             // stabilization gls
             if ( M_stabilizationGLS && M_stabilizationGLSDoAssembly )
             {
                 this->updateJacobianStabilizationGLS( data, mctx, *physicFluidData, matProps, range );
             }
 
+            this->addElementCost( this->keyword(), range, materialAssemblyCost );
         } // foreach mat
     } // foreach physic
 
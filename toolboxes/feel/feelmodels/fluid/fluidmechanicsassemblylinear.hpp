@@ -105,6 +105,7 @@ FluidMechanics<ConvexType,BasisVelocityType,BasisPressureType>::updateLinearPDE(
         {
             auto const& range = this->materialsProperties()->rangeMeshElementsByMaterial( this->mesh(),matName );
             auto const& matProps = this->materialsProperties()->materialProperties( matName );
+            boost::mpi::timer timerMaterialAssembly; // element cost for the load rebalancing
 
             // stress tensor sigma : grad(v)
             this->timerTool("Solve").start();
@@ -306,12 +307,15 @@ FluidMechanics<ConvexType,BasisVelocityType,BasisPressureType>::updateLinearPDE(
             }
 
             //--------------------------------------------------------------------------------------------------//
+            // the GLS stabilization charges its cost to its own element ranges
+            double materialAssemblyCost = timerMaterialAssembly.elapsed();
             if ( M_stabilizationGLS && M_stabilizationGLSDoAssembly )
             {
                 this->updateLinearPDEStabilizationGLS( data, mctx, *physicFluidData, matProps, range );
             }
 
 
+            this->addElementCost( this->keyword(), range, materialAssemblyCost );
         } // foreach material
 
         // incompressibility term
@@ -220,6 +220,7 @@ FluidMechanics<ConvexType,BasisVelocityType,BasisPressureType>::updateLinearPDES
 
     if ( tauExprSUPG )
     {
+        boost::mpi::timer timerStabilization; // element cost for the load rebalancing
         tauExprSUPG->expression().setDiffusion( muExpr );
 
         auto densityExpr = expr( matProps.property("density").template expr<1,1>(), se );
@@ -284,10 +285,12 @@ FluidMechanics<ConvexType,BasisVelocityType,BasisPressureType>::updateLinearPDES
             integrate( _range=rangeEltConvectionDiffusion,
                        _expr=lambdaCoeff*2.0*inner(idv(beta_u))*tau*divt(u)*div(v),
                        _geomap=this->geomap() );
+        this->addElementCost( this->keyword(), rangeEltConvectionDiffusion, timerStabilization.elapsed() );
     }
 
     if ( tauExprPSPG )
     {
+        boost::mpi::timer timerStabilization; // element cost for the load rebalancing
         tauExprPSPG->expression().setDiffusion( muExpr );
 
         auto stab_test = -trans(grad(p));
@@ -327,6 +330,7 @@ FluidMechanics<ConvexType,BasisVelocityType,BasisPressureType>::updateLinearPDES
                                            _expr=tau*inner(std::get<2>(e),stab_test ),
                                            _geomap=this->geomap() );
                         });
+        this->addElementCost( this->keyword(), rangeEltPressure, timerStabilization.elapsed() );
     }
 }
 
@@ -413,6 +417,7 @@ FluidMechanics<ConvexType,BasisVelocityType,BasisPressureType>::updateJacobianSt
 
     if ( this->stabilizationGLSType() != "pspg" )
     {
+        boost::mpi::timer timerStabilization; // element cost for the load rebalancing
         auto densityExpr = expr( matProps.property("density").template expr<1,1>(), se );
 #if 1
         int coeffNatureStabilization = ( this->stabilizationGLSType() == "supg" || this->stabilizationGLSType() == "supg-pspg" )? 0 : (this->stabilizationGLSType() == "gls")? 1 : -1;
@@ -465,10 +470,12 @@ FluidMechanics<ConvexType,BasisVelocityType,BasisPressureType>::updateJacobianSt
             integrate( _range=rangeEltConvectionDiffusion,
                        _expr=lambdaCoeff*2.0*inner(idv(u))*tau*divt(u)*div(v),
                        _geomap=this->geomap() );
+        this->addElementCost( this->keyword(), rangeEltConvectionDiffusion, timerStabilization.elapsed() );
     }
 
     if ( this->stabilizationGLSType() == "pspg" || this->stabilizationGLSType() == "supg-pspg" || this->stabilizationGLSType() == "gls" )
     {
+        boost::mpi::timer timerStabilization; // element cost for the load rebalancing
         auto stab_test = -trans(grad(p));
         auto rangeEltPressure = this->stabilizationGLSEltRangePressure( matName );
         auto tauFieldPtr = this->stabilizationGLSParameterPressure()->fieldTauPtr();
@@ -499,6 +506,7 @@ FluidMechanics<ConvexType,BasisVelocityType,BasisPressureType>::updateJacobianSt
                                            _expr=tau*inner( std::get<2>(e),stab_test ),
                                            _geomap=this->geomap() );
                         });
+        this->addElementCost( this->keyword(), rangeEltPressure, timerStabilization.elapsed() );
     }
 
 }
@@ -582,6 +590,7 @@ FluidMechanics<ConvexType,BasisVelocityType,BasisPressureType>::updateResidualSt
     }
     if ( tauExprSUPG )
     {
+        boost::mpi::timer timerStabilization; // element cost for the load rebalancing
         tauExprSUPG->expression().setDiffusion( muExpr );
 
         auto densityExpr = expr( matProps.property("density").template expr<1,1>(), se );
@@ -617,10 +626,12 @@ FluidMechanics<ConvexType,BasisVelocityType,BasisPressureType>::updateResidualSt
             integrate( _range=rangeEltConvectionDiffusion,
                        _expr=lambdaCoeff*2.0*inner(idv(u))*tau*divv(u)*div(v),
                        _geomap=this->geomap() );
+        this->addElementCost( this->keyword(), rangeEltConvectionDiffusion, timerStabilization.elapsed() );
     }
 
     if ( tauExprPSPG )
     {
+        boost::mpi::timer timerStabilization; // element cost for the load rebalancing
         tauExprPSPG->expression().setDiffusion( muExpr );
 
         auto stab_test = -trans(grad(p));
@@ -633,6 +644,7 @@ FluidMechanics<ConvexType,BasisVelocityType,BasisPressureType>::updateResidualSt
             integrate( _range=rangeEltPressure,
                        _expr=tau*inner(residual_full,stab_test ),
                        _geomap=this->geomap() );
+        this->addElementCost( this->keyword(), rangeEltPressure, timerStabilization.elapsed() );
     }
 
 }
@@ -2899,6 +2899,7 @@ aggregateGraph( std::vector<std::shared_ptr<GraphCSR>> const& graphs, std::share
     auto sparsity_graph = std::make_shared<GraphCSR>( graphs.front()->mapRowPtr(), mapCol );
     for ( auto const& g : graphs )
     {
+        g->expandFlatRows();
         for ( auto it = g->begin(), en=g->end(); it!=en ;++it )
         {
             auto/*row_type*/ const& irow = it->second;
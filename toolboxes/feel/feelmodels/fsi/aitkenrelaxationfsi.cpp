@@ -40,12 +40,23 @@ AitkenRelaxationFSI<SolidType>::AitkenRelaxationFSI( solid_ptrtype solid,
                                                      std::string aitkenType,
                                                      double initialTheta,
                                                      double tolPtFixe,
-                                                     double minTheta )
+                                                     double minTheta,
+                                                     int iqnilsReuse,
+                                                     int iqnilsMaxColumns,
+                                                     double iqnilsFilteringTolerance )
     :
-    M_solid(solid)
+    M_solid(solid),
+    M_useIQNILS( aitkenType == "iqn-ils" )
 {
 
-    if (M_solid->isStandardModel())
+    if (M_solid->isStandardModel() && M_useIQNILS )
+    {
+        M_oldSol.reset( new element_disp_type( M_solid->functionSpaceDisplacement() ) );
+        M_residual.reset( new element_disp_type( M_solid->functionSpaceDisplacement() ) );
+        M_iqnils = std::make_shared<iqnils_type>( M_solid->functionSpaceDisplacement(), initialTheta, tolPtFixe,
+                                                  iqnilsReuse, iqnilsMaxColumns, iqnilsFilteringTolerance );
+    }
+    else if (M_solid->isStandardModel())
     {
         M_oldSol.reset( new element_disp_type( M_solid->functionSpaceDisplacement() ) );
         M_residual.reset( new element_disp_type( M_solid->functionSpaceDisplacement() ) );
@@ -66,6 +77,14 @@ AitkenRelaxationFSI<SolidType>::AitkenRelaxationFSI( solid_ptrtype solid,
         //_expr=cst(1.)).evaluate()(0,0);
 
     }
+    else if ( M_solid->is1dReducedModel() && M_useIQNILS )
+    {
+        M_oldSol1dReduced.reset( new element_disp_1dreduced_type( M_solid->solid1dReduced()->fieldDisplacementScal1dReduced().functionSpace() ) );
+        M_residual1dReduced.reset( new element_disp_1dreduced_type( M_solid->solid1dReduced()->fieldDisplacementScal1dReduced().functionSpace() ) );
+        M_iqnils1dReduced = std::make_shared<iqnils_1dreduced_type>( M_solid->solid1dReduced()->fieldDisplacementScal1dReduced().functionSpace(),
+                                                                     initialTheta, tolPtFixe,
+                                                                     iqnilsReuse, iqnilsMaxColumns, iqnilsFilteringTolerance );
+    }
     else if ( M_solid->is1dReducedModel() )
     {
         M_oldSol1dReduced.reset( new element_disp_1dreduced_type( M_solid->solid1dReduced()->fieldDisplacementScal1dReduced().functionSpace() ) );
@@ -107,9 +126,19 @@ AitkenRelaxationFSI<SolidType>::isFinished()
 {
     bool res=false;
     if (M_solid->isStandardModel())
-        res=M_aitken->isFinished();
+    {
+        if ( M_useIQNILS )
+            res=M_iqnils->isFinished();
+        else
+            res=M_aitken->isFinished();
+    }
     else if ( M_solid->is1dReducedModel() )
-        res=M_aitken1dReduced->isFinished();
+    {
+        if ( M_useIQNILS )
+            res=M_iqnils1dReduced->isFinished();
+        else
+            res=M_aitken1dReduced->isFinished();
+    }
     return res;
 }
 
@@ -120,9 +149,19 @@ void
 AitkenRelaxationFSI<SolidType>::restart()
 {
     if (M_solid->isStandardModel())
-        M_aitken->restart();
+    {
+        if ( M_useIQNILS )
+            M_iqnils->restart();
+        else
+            M_aitken->restart();
+    }
     else if ( M_solid->is1dReducedModel() )
-        M_aitken1dReduced->restart();
+    {
+        if ( M_useIQNILS )
+            M_iqnils1dReduced->restart();
+        else
+            M_aitken1dReduced->restart();
+    }
 }
 
 //-----------------------------------------------------------------------------------//
@@ -133,9 +172,19 @@ AitkenRelaxationFSI<SolidType>::printInfo()
 {
     std::cout << std::scientific;
     if (M_solid->isStandardModel())
-        M_aitken->printInfo();
+    {
+        if ( M_useIQNILS )
+            M_iqnils->printInfo();
+        else
+            M_aitken->printInfo();
+    }
     else if ( M_solid->is1dReducedModel() )
-        M_aitken1dReduced->printInfo();
+    {
+        if ( M_useIQNILS )
+            M_iqnils1dReduced->printInfo();
+        else
+            M_aitken1dReduced->printInfo();
+    }
 }
 
 //-----------------------------------------------------------------------------------//
@@ -151,9 +200,12 @@ AitkenRelaxationFSI<SolidType>::applyRelaxation()
                        _expr=vf::idv(M_solid->fieldDisplacement() ));
         *M_residual -= *M_oldSol;
 
-        M_aitken->apply2(_newElt=M_solid->fieldDisplacement(),
-                         _residual=*M_residual,
-                         _currentElt=M_solid->fieldDisplacement() );
+        if ( M_useIQNILS )
+            M_iqnils->apply( M_solid->fieldDisplacement(), *M_residual, M_solid->fieldDisplacement() );
+        else
+            M_aitken->apply2(_newElt=M_solid->fieldDisplacement(),
+                             _residual=*M_residual,
+                             _currentElt=M_solid->fieldDisplacement() );
     }
     else if ( M_solid->is1dReducedModel() )
     {
@@ -161,9 +213,13 @@ AitkenRelaxationFSI<SolidType>::applyRelaxation()
                                 _expr=vf::idv(M_solid->solid1dReduced()->fieldDisplacementScal1dReduced() ));
         *M_residual1dReduced -= *M_oldSol1dReduced;
 
-        M_aitken1dReduced->apply2(_newElt=M_solid->solid1dReduced()->fieldDisplacementScal1dReduced(),
-                                  _residual=*M_residual1dReduced,
-                                  _currentElt=M_solid->solid1dReduced()->fieldDisplacementScal1dReduced() );
+        if ( M_useIQNILS )
+            M_iqnils1dReduced->apply( M_solid->solid1dReduced()->fieldDisplacementScal1dReduced(), *M_residual1dReduced,
+                                      M_solid->solid1dReduced()->fieldDisplacementScal1dReduced() );
+        else
+            M_aitken1dReduced->apply2(_newElt=M_solid->solid1dReduced()->fieldDisplacementScal1dReduced(),
+                                      _residual=*M_residual1dReduced,
+                                      _currentElt=M_solid->solid1dReduced()->fieldDisplacementScal1dReduced() );
     }
 }
 
@@ -174,9 +230,19 @@ void
 AitkenRelaxationFSI<SolidType>::shiftRight()
 {
     if (M_solid->isStandardModel())
-        M_aitken->shiftRight();
+    {
+        if ( M_useIQNILS )
+            M_iqnils->shiftRight();
+        else
+            M_aitken->shiftRight();
+    }
     else if ( M_solid->is1dReducedModel() )
-        M_aitken1dReduced->shiftRight();
+    {
+        if ( M_useIQNILS )
+            M_iqnils1dReduced->shiftRight();
+        else
+            M_aitken1dReduced->shiftRight();
+    }
 }
 
 //-----------------------------------------------------------------------------------//
@@ -187,9 +253,19 @@ AitkenRelaxationFSI<SolidType>::nIterations()
 {
     uint16_type res=0;
     if (M_solid->isStandardModel())
-        res = M_aitken->nIterations();
+    {
+        if ( M_useIQNILS )
+            res = M_iqnils->nIterations();
+        else
+            res = M_aitken->nIterations();
+    }
     else if ( M_solid->is1dReducedModel() )
-        res = M_aitken1dReduced->nIterations();
+    {
+        if ( M_useIQNILS )
+            res = M_iqnils1dReduced->nIterations();
+        else
+            res = M_aitken1dReduced->nIterations();
+    }
 
     return res;
 }
@@ -202,9 +278,19 @@ AitkenRelaxationFSI<SolidType>::residualNorm()
 {
     double res=0;
     if (M_solid->isStandardModel())
-        res=M_aitken->residualNorm();
+    {
+        if ( M_useIQNILS )
+            res=M_iqnils->residualNorm();
+        else
+            res=M_aitken->residualNorm();
+    }
     else if ( M_solid->is1dReducedModel() )
-        res=M_aitken1dReduced->residualNorm();
+    {
+        if ( M_useIQNILS )
+            res=M_iqnils1dReduced->residualNorm();
+        else
+            res=M_aitken1dReduced->residualNorm();
+    }
 
     return res;
 }
@@ -216,9 +302,19 @@ void
 AitkenRelaxationFSI<SolidType>::setTheta(double v)
 {
     if (M_solid->isStandardModel())
-        M_aitken->setTheta(v);
-    else if (M_solid->is1dReducedModel())
-        M_aitken1dReduced->setTheta(v);
+    {
+        if ( M_useIQNILS )
+            M_iqnils->setTheta(v);
+        else
+            M_aitken->setTheta(v);
+    }
+    else if ( M_solid->is1dReducedModel() )
+    {
+        if ( M_useIQNILS )
+            M_iqnils1dReduced->setTheta(v);
+        else
+            M_aitken1dReduced->setTheta(v);
+    }
 }
 
 //-----------------------------------------------------------------------------------//
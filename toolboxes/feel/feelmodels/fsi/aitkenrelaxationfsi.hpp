@@ -33,6 +33,7 @@
 
 #include <feel/feelcore/feel.hpp>
 #include <feel/feelalg/aitken.hpp>
+#include <feel/feelalg/iqnils.hpp>
 
 
 namespace Feel
@@ -54,20 +55,34 @@ public :
     typedef typename solid_type::element_displacement_ptrtype element_disp_ptrtype;
     typedef Aitken<space_disp_type> aitken_type;
     typedef std::shared_ptr<aitken_type> aitken_ptrtype;
+    typedef IQNILS<space_disp_type> iqnils_type;
+    typedef std::shared_ptr<iqnils_type> iqnils_ptrtype;
 
     typedef typename solid_type::solid_1dreduced_type::space_displacement_component_type space_disp_1dreduced_type;
     typedef typename solid_type::solid_1dreduced_type::element_displacement_component_type element_disp_1dreduced_type;
     typedef typename solid_type::solid_1dreduced_type::element_displacement_component_ptrtype element_disp_1dreduced_ptrtype;
     typedef Aitken<space_disp_1dreduced_type> aitken_1dreduced_type;
     typedef std::shared_ptr<aitken_1dreduced_type> aitken_1dreduced_ptrtype;
+    typedef IQNILS<space_disp_1dreduced_type> iqnils_1dreduced_type;
+    typedef std::shared_ptr<iqnils_1dreduced_type> iqnils_1dreduced_ptrtype;
 
     //-----------------------------------------------------------------------------------//
 
+    /**
+     * @param aitkenType relaxation method : a type of Aitken (method1, standard, fixed-relaxation)
+     *        or iqn-ils for the interface quasi-Newton method (see IQNILS)
+     * @param iqnilsReuse number of previous time steps whose secant columns are reused (iqn-ils)
+     * @param iqnilsMaxColumns maximal number of secant columns (iqn-ils)
+     * @param iqnilsFilteringTolerance tolerance of the filtering of the secant columns (iqn-ils)
+     */
     AitkenRelaxationFSI( solid_ptrtype solid,
                          std::string aitkenType = "method1",
                          double initialTheta = 1.0,
                          double tolPtFixe =1.0e-6,
-                         double minTheta =1e-4 );
+                         double minTheta =1e-4,
+                         int iqnilsReuse = 0,
+                         int iqnilsMaxColumns = 100,
+                         double iqnilsFilteringTolerance = 1e-8 );
     AitkenRelaxationFSI( self_type const & M ) = default;
 
     //-----------------------------------------------------------------------------------//
@@ -90,15 +105,21 @@ public :
 
     void setTheta(double v);
 
+    //! return true if the interface quasi-Newton method is used instead of Aitken relaxation
+    bool useIQNILS() const { return M_useIQNILS; }
+
 private :
 
     solid_ptrtype M_solid;
+    bool M_useIQNILS;
 
     aitken_ptrtype M_aitken;
+    iqnils_ptrtype M_iqnils;
     element_disp_ptrtype M_oldSol;
     element_disp_ptrtype M_residual;
 
     aitken_1dreduced_ptrtype M_aitken1dReduced;
+    iqnils_1dreduced_ptrtype M_iqnils1dReduced;
     element_disp_1dreduced_ptrtype M_oldSol1dReduced;
     element_disp_1dreduced_ptrtype M_residual1dReduced;
 
@@ -53,6 +53,7 @@ FSI<FluidType,SolidType>::FSI( std::string const& prefix,
     M_fixPointMinTheta( doption(_name="fixpoint.min_theta",_prefix=this->prefix()) ),
     M_fixPointMaxIt( ioption(_name="fixpoint.maxit",_prefix=this->prefix()) ),
     M_fixPointMinItConvergence( ioption(_name="fixpoint.minit-convergence",_prefix=this->prefix()) ),
+    M_fixPointAcceleration( soption(_name="fixpoint.acceleration",_prefix=this->prefix()) ),
     M_previousTimeOrder(0),M_currentTimeOrder(1),
     M_reusePrecOptFluid(false),
     M_reusePrecRebuildAtFirstFSIStepOptFluid( boption(_name="fluid.reuse-prec.rebuild-at-first-fsi-step",_prefix=this->prefix()) ),
@@ -462,12 +463,19 @@ FSI<FluidType,SolidType>::init()
     aitkenType = "fixed-relaxation";
     M_fixPointInitialTheta=0;
 #endif
+    if ( M_fixPointAcceleration == "iqn-ils" )
+        aitkenType = "iqn-ils";
+    else if ( M_fixPointAcceleration != "aitken" )
+        CHECK( false ) << "invalid fixpoint.acceleration " << M_fixPointAcceleration << ", should be aitken or iqn-ils";
     M_fixPointConvergenceFSI.reset(new fixpointconvergenceFSI_type(M_solidModel) );
     M_aitkenFSI.reset(new aitkenrelaxationFSI_type(M_solidModel,
                                                    aitkenType,//AITKEN_METHOD_1,
                                                    M_fixPointInitialTheta,
                                                    M_fixPointTolerance,
-                                                   M_fixPointMinTheta));
+                                                   M_fixPointMinTheta,
+                                                   ioption(_name="fixpoint.iqn-ils.reuse",_prefix=this->prefix()),
+                                                   ioption(_name="fixpoint.iqn-ils.max-columns",_prefix=this->prefix()),
+                                                   doption(_name="fixpoint.iqn-ils.filtering-tol",_prefix=this->prefix()) ));
 
     //-------------------------------------------------------------------------//
     // build interface operator for generalized robin-neumann
@@ -1412,7 +1420,9 @@ FSI<FluidType,SolidType>::getInfo() const
     }
 
     *_ostr << "\n   Solver";
-    if ( useAitken )
+    if ( useAitken && M_fixPointAcceleration == "iqn-ils" )
+        *_ostr << "\n     -- method        : fix point with IQN-ILS acceleration";
+    else if ( useAitken )
         *_ostr << "\n     -- method        : fix point with Aitken relaxation";
     else
         *_ostr << "\n     -- method        : fix point";
@@ -1473,7 +1483,7 @@ FSI<FluidType,SolidType>::updateInformationObject( nl::json & p ) const
     p["Coupling"] = std::move( subPt );
 
     subPt.clear();
-    subPt["method"] = useAitken? "fix point with Aitken relaxation" : "fix point";
+    subPt["method"] = useAitken? ( M_fixPointAcceleration == "iqn-ils"? "fix point with IQN-ILS acceleration" : "fix point with Aitken relaxation" ) : "fix point";
     subPt["tolerance"] = M_fixPointTolerance;
     subPt["maxit"] = M_fixPointMaxIt;
     if ( useAitken )
@@ -246,6 +246,8 @@ public :
     double fixPointMinTheta() const { return M_fixPointMinTheta; }
     int fixPointMaxIt() const { return M_fixPointMaxIt; }
     int fixPointMinItConvergence() const { return M_fixPointMinItConvergence; }
+    //! acceleration of the fixed point iterations : aitken or iqn-ils
+    std::string const& fixPointAcceleration() const { return M_fixPointAcceleration; }
 
     //interpolationFSI_ptrtype interpolationTool() { return M_interpolationFSI; }
     //interpolationFSI_ptrtype const& interpolationTool() const { return M_interpolationFSI; }
@@ -384,6 +386,7 @@ private :
     bool M_interfaceFSIisConforme;
     double M_fixPointTolerance, M_fixPointInitialTheta, M_fixPointMinTheta;
     int M_fixPointMaxIt, M_fixPointMinItConvergence;
+    std::string M_fixPointAcceleration;
 
     //interpolationFSI_ptrtype M_interpolationFSI;
     aitkenrelaxationFSI_ptrtype M_aitkenFSI;
@@ -91,6 +91,8 @@ LevelSetRedistanciationFM<FunctionSpaceType>::LevelSetRedistanciationFM(
     }
 
     M_fastMarching.reset( new fastmarching_type( M_spaceFM ) );
+    M_fastMarching->setMethod( M_fastMarchingMethod );
+    M_fastMarching->setNThreads( M_fastMarchingNThreads );
 }
 
 template<typename FunctionSpaceType>
@@ -146,6 +148,11 @@ LevelSetRedistanciationFM<FunctionSpaceType>::loadParametersFromOptionsVm()
     const std::string fm_init_method = soption( _name="fm-init-method", _prefix=this->prefix() );
     CHECK(FastMarchingInitialisationMethodMap.left.count(fm_init_method)) << fm_init_method <<" is not in the list of possible fast-marching initialisation methods\n";
     M_fastMarchingInitialisationMethod = FastMarchingInitialisationMethodMap.left.at(fm_init_method);
+
+    const std::string fm_method = soption( _name="fm-method", _prefix=this->prefix() );
+    CHECK( fm_method == "fmm" || fm_method == "fim" ) << fm_method << " is not in the list of possible fast-marching methods (fmm, fim)\n";
+    M_fastMarchingMethod = ( fm_method == "fim" ) ? FastMarchingMethod::FIM : FastMarchingMethod::FMM;
+    M_fastMarchingNThreads = ioption( _name="fm-nthreads", _prefix=this->prefix() );
 }
 
 template<typename FunctionSpaceType>
@@ -199,6 +199,8 @@ class LevelSetRedistanciationFM :
         // Fast-marching
         fastmarching_ptrtype M_fastMarching;
         FastMarchingInitialisationMethod M_fastMarchingInitialisationMethod;
+        FastMarchingMethod M_fastMarchingMethod;
+        int M_fastMarchingNThreads;
         //--------------------------------------------------------------------//
         //--------------------------------------------------------------------//
         // Options
@@ -54,9 +54,13 @@ ModelAlgebraicFactory::ModelAlgebraicFactory( std::string const& prefix, po::var
     M_pseudoTransientContinuationExpurThresholdLow( doption(_prefix=prefix,_name="pseudo-transient-continuation.expur.threshold-low",_vm=vm) ),
     M_pseudoTransientContinuationExpurBetaHigh( doption(_prefix=prefix,_name="pseudo-transient-continuation.expur.beta-high",_vm=vm) ),
     M_pseudoTransientContinuationExpurBetaLow( doption(_prefix=prefix,_name="pseudo-transient-continuation.expur.beta-low",_vm=vm) ),
-    M_solverPicardRelaxationParameter( doption(_prefix=prefix,_name="solver.picard.relaxation-parameter",_vm=vm) )
+    M_solverPicardRelaxationParameter( doption(_prefix=prefix,_name="solver.picard.relaxation-parameter",_vm=vm) ),
+    M_useJacobianFree( boption(_prefix=prefix,_name="solver.nonlinear.jacobian-free",_vm=vm) ),
+    M_jacobianFreeLagPreconditioner( ioption(_prefix=prefix,_name="solver.nonlinear.jacobian-free.lag-preconditioner",_vm=vm) ),
+    M_jacobianFreeLagPreconditionerPersists( boption(_prefix=prefix,_name="solver.nonlinear.jacobian-free.lag-preconditioner-persists",_vm=vm) )
 {
     CHECK( M_solverPicardRelaxationParameter>0 && M_solverPicardRelaxationParameter <=1 ) << "invalid solver.picard.relaxation-parameter : " << M_solverPicardRelaxationParameter;
+    CHECK( M_jacobianFreeLagPreconditioner == -1 || M_jacobianFreeLagPreconditioner >= 1 ) << "invalid solver.nonlinear.jacobian-free.lag-preconditioner : " << M_jacobianFreeLagPreconditioner;
 }
 
 ModelAlgebraicFactory::ModelAlgebraicFactory( model_ptrtype const& model, backend_ptrtype const& backend )
@@ -465,6 +469,12 @@ void ModelAlgebraicFactory::initSolverPtAP( sparse_matrix_ptrtype matP, function
             subPt.emplace( "reuse-jac rebuild at first Newton step", this->backend()->reuseJacRebuildAtFirstNewtonStep() );
             subPt.emplace( "maxit with reuse", this->backend()->maxIterationsSNESReuse() );
         }
+        subPt.emplace( "jacobian-free", M_useJacobianFree );
+        if ( M_useJacobianFree )
+        {
+            subPt.emplace( "jacobian-free lag preconditioner", M_jacobianFreeLagPreconditioner );
+            subPt.emplace( "jacobian-free lag preconditioner persists", M_jacobianFreeLagPreconditionerPersists );
+        }
         p["SNES"] = subPt;
 
         // KSP in SNES
@@ -850,7 +860,7 @@ ModelAlgebraicFactory::tabulateInformations( nl::json const& jsonInfo, TabulateI
     //---------------------------------------------------------------------------------------------------------------//
 
     void
-    ModelAlgebraicFactory::updateResidual(const vector_ptrtype& XX, vector_ptrtype& RR, std::optional<std::vector<int/*index_type*/>> const& dofEliminationIds)
+    ModelAlgebraicFactory::updateResidual(const vector_ptrtype& XX, vector_ptrtype& RR, std::optional<std::vector<int/*index_type*/>> const& dofEliminationIds, bool useJacobianFree)
     {
         auto model = this->model();
         model->timerTool("Solve").start();
@@ -914,7 +924,9 @@ ModelAlgebraicFactory::tabulateInformations( nl::json const& jsonInfo, TabulateI
 
         if ( dofEliminationIds )
         {
-            if ( M_applyDofEliminationOnInitialGuess )
+            // the finite differences of a zero residual row give a singular matrix-free jacobian,
+            // so the jacobian-free mode always uses the rows x-g (identity in the jacobian)
+            if ( M_applyDofEliminationOnInitialGuess && !useJacobianFree )
             {
                 for ( size_type k : *dofEliminationIds )
                     RR->set( k, 0. );
@@ -959,6 +971,15 @@ ModelAlgebraicFactory::tabulateInformations( nl::json const& jsonInfo, TabulateI
         //---------------------------------------------------------------------//
         model->timerTool("Solve").start();
 
+        // the Picard linearization is not the derivative of the residual, the jacobian is always assembled
+        bool useJacobianFree = M_useJacobianFree && !usePicardLinearization;
+        if ( useJacobianFree )
+        {
+            // the lag of the jacobian is used for the preconditioner in jacobian-free mode
+            CHECK( !M_backend->reuseJac() && !( M_useSolverPtAP && M_solverPtAP_backend->reuseJac() ) )
+                << "solver.nonlinear.jacobian-free is not compatible with the backend option reuse-jac, use solver.nonlinear.jacobian-free.lag-preconditioner";
+        }
+
         if ( !M_applyDofEliminationOnInitialGuess )
             M_dofEliminationValues->zero();
 
@@ -1003,6 +1024,13 @@ ModelAlgebraicFactory::tabulateInformations( nl::json const& jsonInfo, TabulateI
 
             dofEliminationIds.emplace();
             dofEliminationIds->assign( setDofIds.begin(), setDofIds.end() );
+
+            // the residual rows x-g of the jacobian-free mode need the values imposed on the initial guess
+            if ( M_applyDofEliminationOnInitialGuess && useJacobianFree )
+            {
+                U->close();
+                *M_dofEliminationValues = *U;
+            }
         }
 
         model->timerTool("Solve").elapsed("algebraic-newton-initial-guess");
@@ -1079,8 +1107,10 @@ ModelAlgebraicFactory::tabulateInformations( nl::json const& jsonInfo, TabulateI
         }
 
 
-        pre_solve_type pre_solve = [this,&dofEliminationIds]( vector_ptrtype rhs, vector_ptrtype sol ) {
-                                       if ( !M_applyDofEliminationOnInitialGuess && dofEliminationIds )
+        // with a matrix-free jacobian, the operator is not modified by the dof elimination (only the preconditioner is),
+        // so the rhs is kept unchanged
+        pre_solve_type pre_solve = [this,&dofEliminationIds,useJacobianFree]( vector_ptrtype rhs, vector_ptrtype sol ) {
+                                       if ( !M_applyDofEliminationOnInitialGuess && dofEliminationIds && !useJacobianFree )
                                        {
                                            std::vector<double> zeroValues( dofEliminationIds->size(), 0. );
                                            rhs->setVector( dofEliminationIds->data(), dofEliminationIds->size(), zeroValues.data() );
@@ -1097,8 +1127,8 @@ ModelAlgebraicFactory::tabulateInformations( nl::json const& jsonInfo, TabulateI
         auto update_jacobian = [this,&dofEliminationIds,usePicardLinearization]( const vector_ptrtype& X, sparse_matrix_ptrtype& J ) {
                                    this->updateJacobian( X,J,dofEliminationIds,usePicardLinearization );
                                };
-        auto update_residual = [this,&dofEliminationIds]( const vector_ptrtype& X, vector_ptrtype& R ) {
-                                   this->updateResidual( X,R,dofEliminationIds );
+        auto update_residual = [this,&dofEliminationIds,useJacobianFree]( const vector_ptrtype& X, vector_ptrtype& R ) {
+                                   this->updateResidual( X,R,dofEliminationIds,useJacobianFree );
                                };
 
         typename backend_type::nl_solve_return_type solveStat;
@@ -1111,6 +1141,7 @@ ModelAlgebraicFactory::tabulateInformations( nl::json const& jsonInfo, TabulateI
 
             M_solverPtAP_backend->nlSolver()->jacobian = update_jacobian;
             M_solverPtAP_backend->nlSolver()->residual = update_residual;
+            M_solverPtAP_backend->nlSolver()->setJacobianFree( useJacobianFree, M_jacobianFreeLagPreconditioner, M_jacobianFreeLagPreconditionerPersists );
 
             solveStat = M_solverPtAP_backend->nlSolve( _jacobian=M_solverPtAP_matPtAP,
                                                        _solution=M_solverPtAP_solution,
@@ -1126,6 +1157,7 @@ ModelAlgebraicFactory::tabulateInformations( nl::json const& jsonInfo, TabulateI
         {
             M_backend->nlSolver()->jacobian = update_jacobian;
             M_backend->nlSolver()->residual = update_residual;
+            M_backend->nlSolver()->setJacobianFree( useJacobianFree, M_jacobianFreeLagPreconditioner, M_jacobianFreeLagPreconditionerPersists );
 
             solveStat = M_backend->nlSolve( _jacobian=M_J,
                                             _solution=U,
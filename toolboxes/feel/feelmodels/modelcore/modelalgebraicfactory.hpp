@@ -188,7 +188,7 @@ namespace FeelModels
         void solvePicard( vector_ptrtype &U );
 
         void updateJacobian( const vector_ptrtype& X, sparse_matrix_ptrtype& J, std::optional<std::vector<int/*index_type*/>> const& dofEliminationIds, bool usePicardLinearization );
-        void updateResidual( const vector_ptrtype& X, vector_ptrtype& R, std::optional<std::vector<int/*index_type*/>> const& dofEliminationIds );
+        void updateResidual( const vector_ptrtype& X, vector_ptrtype& R, std::optional<std::vector<int/*index_type*/>> const& dofEliminationIds, bool useJacobianFree = false );
 
         void preSolveNewton( vector_ptrtype rhs, vector_ptrtype sol ) const;
         void postSolveNewton( vector_ptrtype rhs, vector_ptrtype sol ) const;
@@ -329,6 +329,10 @@ namespace FeelModels
         double M_pseudoTransientContinuationExpurBetaHigh, M_pseudoTransientContinuationExpurBetaLow;
 
         double M_solverPicardRelaxationParameter;
+
+        bool M_useJacobianFree;
+        int M_jacobianFreeLagPreconditioner;
+        bool M_jacobianFreeLagPreconditionerPersists;
     };
 
 
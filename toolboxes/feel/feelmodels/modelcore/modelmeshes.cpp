@@ -3,9 +3,7 @@
 
 #include <feel/feelmodels/modelcore/modelmeshes.hpp>
 
-#include <boost/preprocessor/comparison/greater_equal.hpp>
-#include <boost/preprocessor/array/to_list.hpp>
-#include <boost/preprocessor/list/append.hpp>
+#include <feel/feelmodels/modelcore/modelmeshesinstantiation.hpp>
 
 #include <feel/feeldiscr/mesh.hpp>
 #include <feel/feelfilters/loadmesh.hpp>
@@ -427,6 +425,9 @@ ModelMesh<IndexType>::setup( nl::json const& jarg, ModelMeshes<IndexType> const&
         else
             throw std::runtime_error( "meshadaptation JSON value should be a an object or an array" );
     }
+
+    if ( jarg.contains("LoadRebalancing") )
+        M_loadRebalancingSetup.emplace( mMeshes, jarg.at("LoadRebalancing") );
 }
 
 template <typename IndexType>
@@ -735,6 +736,8 @@ ModelMesh<IndexType>::applyRemesh( std::shared_ptr<MeshType> const& newMesh )
     this->setMesh( newMesh );
 
     M_mmeshCommon->clearFunctionSpaces();
+    // the element ids of the costs refer to the old mesh
+    M_elementCosts.clear();
     // TODO : common clear space + applyRemesh to pointmeasure
 
     M_distanceToRanges.clear();
@@ -784,6 +787,9 @@ ModelMesh<IndexType>::updateInformationObject( nl::json & p, std::string const&
     if ( !j_meshAdapArray.empty() )
         p["MeshAdaptation"] = std::move( j_meshAdapArray );
 
+    if ( M_loadRebalancingSetup )
+        M_loadRebalancingSetup->updateInformationObject( p["LoadRebalancing"] );
+
     // TODO here : other types
     using geoshape_list_type = boost::mp11::mp_list< boost::mp11::mp_identity_t<Simplex<2>>,
                                                      boost::mp11::mp_identity_t<Simplex<3>> >;
@@ -892,6 +898,17 @@ ModelMesh<IndexType>::tabulateInformations( nl::json const& jsonInfo, TabulateIn
         tabInfo->add("Mesh Adaptation", tabInfoMeshAdaptation );
     }
 
+    if ( jsonInfo.contains( "LoadRebalancing" ) )
+    {
+        Feel::Table tableInfoLoadRebalancing;
+        TabulateInformationTools::FromJSON::addAllKeyToValues( tableInfoLoadRebalancing, jsonInfo.at( "LoadRebalancing" ), tabInfoProp );
+        tableInfoLoadRebalancing.format()
+            .setShowAllBorders( false )
+            .setColumnSeparator(":")
+            .setHasRowSeparator( false );
+        tabInfo->add("Load Rebalancing", TabulateInformations::New( tableInfoLoadRebalancing, tabInfoProp ) );
+    }
+
     // fields
     if ( jsonInfo.contains("Fields") )
         tabInfo->add( "Fields", TabulateInformationTools::FromJSON::tabulateInformationsModelFields( jsonInfo.at("Fields"), tabInfoProp ) );
@@ -965,75 +982,6 @@ template class ModelMesh<uint32_type>;
 template class ModelMeshes<uint32_type>;
 
 
-#define FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_GEOSHAPE_ORDER1_LIST \
-    BOOST_PP_TUPLE_TO_LIST(                                             \
-        ( ( Simplex,2,1,2),                                             \
-          ( Simplex,3,1,3),                                             \
-          ( Simplex,1,1,2),                                             \
-          ( Simplex,1,1,3) ) )                                          \
-    /**/
-
-#if BOOST_PP_GREATER_EQUAL( FEELPP_MESH_MAX_ORDER, 2 )
-#define FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_GEOSHAPE_ORDER2_LIST \
-    BOOST_PP_TUPLE_TO_LIST(                                             \
-        ( ( Simplex,2,2,2),                                             \
-          ( Simplex,3,2,3),                                             \
-          ( Simplex,1,2,2),                                             \
-          ( Simplex,1,2,3) ) )                                          \
-    /**/
-#else
-#define FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_GEOSHAPE_ORDER2_LIST BOOST_PP_NIL
-#endif
-
-#if BOOST_PP_GREATER_EQUAL( FEELPP_MESH_MAX_ORDER, 3 )
-#define FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_GEOSHAPE_ORDER3_LIST \
-    BOOST_PP_TUPLE_TO_LIST(                                             \
-        ( ( Simplex,2,3,2),                                             \
-          ( Simplex,3,3,3) ) )                                          \
-    /**/
-#else
-#define FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_GEOSHAPE_ORDER3_LIST BOOST_PP_NIL
-#endif
-
-#if BOOST_PP_GREATER_EQUAL( FEELPP_MESH_MAX_ORDER, 4 )
-#define FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_GEOSHAPE_ORDER4_LIST \
-    BOOST_PP_TUPLE_TO_LIST(                                             \
-        ( ( Simplex,2,4,2),                                             \
-          ( Simplex,3,4,3) ) )                                          \
-    /**/
-#else
-#define FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_GEOSHAPE_ORDER4_LIST BOOST_PP_NIL
-#endif
-
-
-#define FEELPP_TOOLBOXES_PP_MODELMESHES_GEOSHAPE_CLASS_NAME(T)   BOOST_PP_TUPLE_ELEM(4, 0, T)
-#define FEELPP_TOOLBOXES_PP_MODELMESHES_GEOSHAPE_DIM(T)   BOOST_PP_TUPLE_ELEM(4, 1, T)
-#define FEELPP_TOOLBOXES_PP_MODELMESHES_GEOSHAPE_ORDER(T)   BOOST_PP_TUPLE_ELEM(4, 2, T)
-#define FEELPP_TOOLBOXES_PP_MODELMESHES_GEOSHAPE_REALDIM(T)   BOOST_PP_TUPLE_ELEM(4, 3, T)
-
-#define FEELPP_TOOLBOXES_PP_MODELMESHES_GEOSHAPE_CLASS(T)               \
-    FEELPP_TOOLBOXES_PP_MODELMESHES_GEOSHAPE_CLASS_NAME(T)              \
-    < FEELPP_TOOLBOXES_PP_MODELMESHES_GEOSHAPE_DIM(T),                  \
-      FEELPP_TOOLBOXES_PP_MODELMESHES_GEOSHAPE_ORDER(T),                \
-      FEELPP_TOOLBOXES_PP_MODELMESHES_GEOSHAPE_REALDIM(T) >             \
-    /**/
-
-#define FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_GEOSHAPE_LIST     \
-    BOOST_PP_LIST_APPEND( FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_GEOSHAPE_ORDER1_LIST, \
-                          BOOST_PP_LIST_APPEND( FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_GEOSHAPE_ORDER2_LIST, \
-                                                BOOST_PP_LIST_APPEND( FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_GEOSHAPE_ORDER3_LIST, \
-                                                                      FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_GEOSHAPE_ORDER4_LIST ) ) ) \
-    /**/
-
-#define FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_INDEXTYPE_LIST    \
-    BOOST_PP_ARRAY_TO_LIST((1, (uint32_type)))                          \
-    /**/
-
-
-/* Generates code for all binary operators and integral type pairs. */
-#define FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_METHODS_OP(_, IS) \
-    FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_METHODS_OP_CODE IS    \
-   /**/
 #define FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_METHODS_OP_CODE(PP_I,PP_GS) \
     template void ModelMesh<PP_I>::updateForUse<Mesh<FEELPP_TOOLBOXES_PP_MODELMESHES_GEOSHAPE_CLASS(PP_GS)>>( ModelMeshes<PP_I> const& ); \
     template void ModelMesh<PP_I>::applyRemesh<Mesh<FEELPP_TOOLBOXES_PP_MODELMESHES_GEOSHAPE_CLASS(PP_GS)>>( std::shared_ptr<Mesh<FEELPP_TOOLBOXES_PP_MODELMESHES_GEOSHAPE_CLASS(PP_GS)>> const& );
@@ -8,6 +8,7 @@
 #include <feel/feeldiscr/functionspace.hpp>
 #include <feel/feelpoly/nedelec.hpp>
 #include <feel/feelfilters/databymeshentity.hpp>
+#include <feel/feelpartition/geometricpartition.hpp>
 #include <feel/feelmodels/modelcore/modelbase.hpp>
 #include <feel/feelmodels/modelpostprocess.hpp>
 #include <feel/feelmodels/modelmarkers.hpp>
@@ -339,6 +340,34 @@ private :
         std::set<std::string> M_displacementZeroMarkers, M_displacementFreeMarkers;
     };
 
+    /**
+     * @brief setup of the dynamic load rebalancing
+     *
+     * The assembly cost of the elements is recorded along the run, at each
+     * check the imbalance (max/mean of the cost by process) is computed and if
+     * it exceeds the threshold, the mesh is repartitioned with these costs as
+     * weights and migrated.
+     * json : "LoadRebalancing": { "threshold": 1.2, "method": "hilbert", "frequency": 1 }
+     */
+    struct LoadRebalancingSetup
+    {
+        LoadRebalancingSetup( ModelMeshes<IndexType> const& mMeshes, nl::json const& jarg );
+
+        //! max/mean ratio of the process costs from which the mesh is repartitioned
+        double threshold() const { return M_threshold; }
+        //! geometric partitioning method (hilbert, morton or rcb)
+        GeometricPartitioning method() const { return M_method; }
+        //! number of time steps between two checks of the imbalance
+        size_type frequency() const { return M_frequency; }
+
+        void updateInformationObject( nl::json & jsonInfo ) const;
+
+    private :
+        double M_threshold;
+        GeometricPartitioning M_method;
+        size_type M_frequency;
+    };
+
 public :
 
     struct MeshAdaptation
@@ -753,6 +782,40 @@ public :
     using function_apply_remesh = std::function<void ( mesh_base_ptrtype,mesh_base_ptrtype )>;
     void setFunctionApplyRemesh( function_apply_remesh f ) { M_functionApplyRemesh = f; }
 
+    //! return true if the dynamic load rebalancing is enabled
+    bool hasLoadRebalancing() const { return M_loadRebalancingSetup.has_value(); }
+
+    //! add the assembly cost \p cost (in s) of the range \p range, spread uniformly on its elements
+    template <typename RangeType>
+    void addElementCost( RangeType const& range, double cost ) const
+        {
+            if ( !this->hasLoadRebalancing() )
+                return;
+            size_type nElt = nelements( range );
+            if ( nElt == 0 )
+                return;
+            double costByElement = cost/nElt;
+            for ( auto const& eltWrap : range )
+            {
+                size_type eltId = unwrap_ref( eltWrap ).id();
+                if ( eltId >= M_elementCosts.size() )
+                    M_elementCosts.resize( eltId+1, 0. );
+                M_elementCosts[eltId] += costByElement;
+            }
+        }
+
+    //! costs of the elements recorded since the last check of the imbalance (indexed by element id)
+    std::vector<double> const& elementCosts() const { return M_elementCosts; }
+
+    /**
+     * check the imbalance of the recorded costs and repartition/migrate the
+     * mesh if it exceeds the threshold, the fields of the model are then
+     * transferred by the function registered with setFunctionApplyRemesh
+     * @return true if the mesh has been migrated
+     */
+    template <typename MeshType>
+    bool updateLoadRebalancing( std::shared_ptr<typename MeshAdaptation::Event> event );
+
     template <typename MeshType>
     void applyRemesh( std::shared_ptr<MeshType> const& newMesh );
 
@@ -883,6 +946,8 @@ private:
     std::optional<MeshMotionSetup> M_meshMotionSetup;
     std::vector<typename MeshAdaptation::Setup> M_meshAdaptationSetup;
     function_apply_remesh M_functionApplyRemesh;
+    std::optional<LoadRebalancingSetup> M_loadRebalancingSetup;
+    mutable std::vector<double> M_elementCosts; // recorded during the assembly (const methods)
 
 };
 
@@ -1056,6 +1121,21 @@ public:
             this->modelMesh( meshName ).applyRemesh( newMesh );
         }
 
+    template <typename RangeType>
+    void addElementCost( std::string const& meshName, RangeType const& range, double cost ) const
+        {
+            if ( this->hasModelMesh( meshName ) )
+                this->modelMesh( meshName ).addElementCost( range, cost );
+        }
+
+    template <typename MeshType>
+    bool updateLoadRebalancing( std::string const& meshName, std::shared_ptr<typename mesh_adaptation_type::Event> event )
+        {
+            if ( this->hasModelMesh( meshName ) )
+                return this->modelMesh( meshName ).template updateLoadRebalancing<MeshType>( event );
+            return false;
+        }
+
     std::string repository_meshes() const { return (fs::path(this->repository().root())/fmt::format("{}.meshes",this->keyword())).string(); }
 
     void saveMetadata() const
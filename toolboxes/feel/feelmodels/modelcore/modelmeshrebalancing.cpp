@@ -0,0 +1,142 @@
+/* -*- mode: c++; coding: utf-8; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4; show-trailing-whitespace: t -*- vim:fenc=utf-8:ft=cpp:et:sw=4:ts=4:sts=4
+ */
+
+#include <feel/feelmodels/modelcore/modelmeshes.hpp>
+#include <feel/feelmodels/modelcore/modelmeshesinstantiation.hpp>
+
+#include <feel/feelpartition/partitionergeometric.hpp>
+#include <feel/feelpartition/migratemesh.hpp>
+
+namespace Feel
+{
+namespace FeelModels
+{
+
+template <typename IndexType>
+ModelMesh<IndexType>::LoadRebalancingSetup::LoadRebalancingSetup( ModelMeshes<IndexType> const& mMeshes, nl::json const& jarg )
+    :
+    M_threshold( 1.2 ),
+    M_method( GeometricPartitioning::Hilbert ),
+    M_frequency( 1 )
+{
+    if ( jarg.contains( "threshold" ) )
+    {
+        auto const& j_threshold = jarg.at( "threshold" );
+        if ( j_threshold.is_number() )
+            M_threshold = j_threshold.template get<double>();
+        else if ( j_threshold.is_string() )
+            M_threshold = std::stod( j_threshold.template get<std::string>() );
+        else
+            throw std::runtime_error( fmt::format("invalid threshold type {}", j_threshold.dump() ) );
+        if ( M_threshold < 1 )
+            throw std::runtime_error( fmt::format("invalid threshold {}, should be greater or equal to 1", M_threshold ) );
+    }
+    if ( jarg.contains( "method" ) )
+        M_method = geometricPartitioningFromString( jarg.at( "method" ).template get<std::string>() );
+    if ( jarg.contains( "frequency" ) )
+    {
+        auto const& j_frequency = jarg.at( "frequency" );
+        if ( j_frequency.is_number_unsigned() )
+            M_frequency = j_frequency.template get<int>();
+        else if ( j_frequency.is_string() )
+            M_frequency = std::stoi( j_frequency.template get<std::string>() );
+        else
+            throw std::runtime_error( fmt::format("invalid frequency type {}", j_frequency.dump() ) );
+        if ( M_frequency == 0 )
+            throw std::runtime_error( "invalid frequency 0" );
+    }
+}
+
+template <typename IndexType>
+void
+ModelMesh<IndexType>::LoadRebalancingSetup::updateInformationObject( nl::json & jsonInfo ) const
+{
+    static const std::map<GeometricPartitioning,std::string> mapMethodEnumToString = { { GeometricPartitioning::Morton, "morton" },
+                                                                                        { GeometricPartitioning::Hilbert, "hilbert" },
+                                                                                        { GeometricPartitioning::RCB, "rcb" } };
+    jsonInfo["threshold"] = M_threshold;
+    jsonInfo["method"] = mapMethodEnumToString.at( M_method );
+    jsonInfo["frequency"] = M_frequency;
+}
+
+template <typename IndexType>
+template <typename MeshType>
+bool
+ModelMesh<IndexType>::updateLoadRebalancing( std::shared_ptr<typename MeshAdaptation::Event> event )
+{
+    if ( !M_loadRebalancingSetup )
+        return false;
+    if ( event->type() != MeshAdaptation::Event::Type::each_time_step )
+        return false;
+    auto e_ets = std::dynamic_pointer_cast<typename MeshAdaptation::EventEachTimeStep>( event );
+    if ( ( e_ets->currentIndex() % M_loadRebalancingSetup->frequency() ) != 0 )
+        return false;
+
+    auto oldmesh = this->mesh<MeshType>();
+    auto const& theWorldComm = oldmesh->worldComm();
+    rank_type nProc = theWorldComm.localSize();
+    if ( nProc == 1 )
+    {
+        M_elementCosts.clear();
+        return false;
+    }
+
+    // cost of the active elements, the elements without recorded cost get a small part of the mean cost
+    // to still be distributed
+    auto rangeElements = elements( oldmesh );
+    double localCost = 0;
+    for ( auto const& eltWrap : rangeElements )
+    {
+        size_type eltId = unwrap_ref( eltWrap ).id();
+        if ( eltId < M_elementCosts.size() )
+            localCost += M_elementCosts[eltId];
+    }
+    std::array<double,2> localCostAndNElt = { localCost, (double)nelements( rangeElements ) }, globalCostAndNElt;
+    mpi::all_reduce( theWorldComm.localComm(), localCostAndNElt.data(), 2, globalCostAndNElt.data(), std::plus<double>() );
+    double meanCostByElement = ( globalCostAndNElt[1] > 0 )? globalCostAndNElt[0]/globalCostAndNElt[1] : 0.;
+    double costFloor = ( meanCostByElement > 0 )? 1e-3*meanCostByElement : 1.;
+
+    std::vector<double> weights( oldmesh->numElements(), costFloor );
+    double localLoad = 0;
+    for ( auto const& eltWrap : rangeElements )
+    {
+        size_type eltId = unwrap_ref( eltWrap ).id();
+        if ( eltId >= weights.size() )
+            weights.resize( eltId+1, costFloor );
+        if ( eltId < M_elementCosts.size() )
+            weights[eltId] += M_elementCosts[eltId];
+        localLoad += weights[eltId];
+    }
+    M_elementCosts.clear();
+
+    double maxLoad = mpi::all_reduce( theWorldComm.localComm(), localLoad, mpi::maximum<double>() );
+    double sumLoad = mpi::all_reduce( theWorldComm.localComm(), localLoad, std::plus<double>() );
+    double imbalance = ( sumLoad > 0 )? maxLoad*nProc/sumLoad : 1.;
+    LOG(INFO) << "ModelMesh " << M_name << " : load imbalance " << imbalance << " (threshold " << M_loadRebalancingSetup->threshold() << ")";
+    if ( imbalance <= M_loadRebalancingSetup->threshold() )
+        return false;
+
+    PartitionerGeometric<MeshType> partitioner( M_loadRebalancingSetup->method() );
+    partitioner.attachWeights( weights );
+    auto parts = partitioner.partitionIds( oldmesh, nProc );
+    auto newmesh = migrateMesh( oldmesh, parts );
+
+    if ( M_functionApplyRemesh )
+        std::invoke( M_functionApplyRemesh, oldmesh, newmesh );
+    else
+        this->applyRemesh( newmesh );
+    return true;
+}
+
+
+template class ModelMesh<uint32_type>;
+
+#define FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_METHODS_OP_CODE(PP_I,PP_GS) \
+    template bool ModelMesh<PP_I>::updateLoadRebalancing<Mesh<FEELPP_TOOLBOXES_PP_MODELMESHES_GEOSHAPE_CLASS(PP_GS)>>( std::shared_ptr<typename MeshAdaptation::Event> );
+    /**/
+
+BOOST_PP_LIST_FOR_EACH_PRODUCT( FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_METHODS_OP, 2, (FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_INDEXTYPE_LIST,FEELPP_TOOLBOXES_PP_MODELMESHES_INSTANTIATION_GEOSHAPE_LIST) )
+/**/
+
+} // namespace FeelModel
+} // namespace Feel
@@ -82,6 +82,9 @@ Feel::po::options_description modelalgebraic_options(std::string const& prefix)
         (prefixvm(prefix,"solver.picard.relaxation-parameter").c_str(), Feel::po::value<double>()->default_value( 1.0 ), "solver.picard.relaxation-parameter")
 
         (prefixvm(prefix,"solver.nonlinear.apply-dof-elimination-on-initial-guess").c_str(), Feel::po::value<bool>()->default_value( /*false*/true ), "solver.nonlinear.apply-dof-elimination-on-initial-guess")
+        (prefixvm(prefix,"solver.nonlinear.jacobian-free").c_str(), Feel::po::value<bool>()->default_value( false ), "use a Jacobian-free Newton-Krylov method : the jacobian action is computed by finite differences of the residual, the assembled jacobian is only used as preconditioner")
+        (prefixvm(prefix,"solver.nonlinear.jacobian-free.lag-preconditioner").c_str(), Feel::po::value<int>()->default_value( 1 ), "number of Newton iterations between two assemblies of the jacobian used as preconditioner (-1 : only at the first iteration)")
+        (prefixvm(prefix,"solver.nonlinear.jacobian-free.lag-preconditioner-persists").c_str(), Feel::po::value<bool>()->default_value( false ), "the lag of the preconditioner is counted across the nonlinear solves (e.g. the time steps)")
         ;
     return appliBaseOptions.add( modelbase_options(prefix ) ).add( on_options( prefix ) );//.add( backend_options( prefix ) );
 }
@@ -352,6 +355,10 @@ fluidStructInteraction_options( std::string const& prefix )
         (prefixvm(prefix,"fixpoint.min_theta").c_str(), Feel::po::value<double>()->default_value( 1.e-4 ), "min theta parameter")
         (prefixvm(prefix,"fixpoint.maxit").c_str(), Feel::po::value<int>()->default_value( 1000 ), "max iteration")
         (prefixvm(prefix,"fixpoint.minit-convergence").c_str(), Feel::po::value<int>()->default_value( 3 ), "max iteration")
+        (prefixvm(prefix,"fixpoint.acceleration").c_str(), Feel::po::value<std::string>()->default_value( "aitken" ), "acceleration of the fixed point : aitken or iqn-ils (interface quasi-Newton)")
+        (prefixvm(prefix,"fixpoint.iqn-ils.reuse").c_str(), Feel::po::value<int>()->default_value( 0 ), "iqn-ils : number of previous time steps whose secant columns are reused")
+        (prefixvm(prefix,"fixpoint.iqn-ils.max-columns").c_str(), Feel::po::value<int>()->default_value( 100 ), "iqn-ils : maximal number of secant columns")
+        (prefixvm(prefix,"fixpoint.iqn-ils.filtering-tol").c_str(), Feel::po::value<double>()->default_value( 1.e-8 ), "iqn-ils : tolerance of the QR filtering of the secant columns")
         // additionals options if reuse-prec or reuse-jac are activated
         (prefixvm(prefix,"fluid.reuse-prec.rebuild-at-first-fsi-step").c_str(), Feel::po::value<bool>()->default_value( true ), " fsi fluid reuse-prec.rebuild-at-first-fsi-step")
         (prefixvm(prefix,"solid.reuse-prec.rebuild-at-first-fsi-step").c_str(), Feel::po::value<bool>()->default_value( true ), " fsi solid reuse-prec.rebuild-at-first-fsi-step")
@@ -493,6 +500,8 @@ redistanciation_fm_options(std::string const& prefix, bool addProjectorsOpts )
     Feel::po::options_description redistanciationFMOptions("RedistanciationFM options");
     redistanciationFMOptions.add_options()
         (prefixvm(prefix,"fm-init-method").c_str(), Feel::po::value<std::string>()->default_value("ilp-nodal"), "strategy to initialise the first elements before the fast marching:\nnone = do nothing\nilp-[nodal/l2/smooth] = interface local projection by nodal, L2 or smooth (|grad phi|) projections\nhj = Hamilton Jacoby equation (with parameters given in options)")
+        (prefixvm(prefix,"fm-method").c_str(), Feel::po::value<std::string>()->default_value("fmm"), "eikonal solver: fmm (fast marching) or fim (multithreaded fast iterative method)")
+        (prefixvm(prefix,"fm-nthreads").c_str(), Feel::po::value<int>()->default_value(1), "number of threads of the fim eikonal solver (<=0 : hardware concurrency)")
         ;
 
     if( addProjectorsOpts )
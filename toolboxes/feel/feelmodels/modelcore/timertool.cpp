@@ -2,6 +2,7 @@
  */
 
 #include <feel/feelmodels/modelcore/timertool.hpp>
+#include <feel/feelcore/profiler.hpp>
 
 #include <algorithm>
 
@@ -90,6 +91,8 @@ TimerTool::stop( std::string const& key )
     {
         double res = this->elapsed( key, maxid );
         M_activeTimers[maxid] = false;
+        if ( !key.empty() && Profiler::instance().isEnabled() )
+            Profiler::instance().addRegion( key, res );
         return res;
     }
 }
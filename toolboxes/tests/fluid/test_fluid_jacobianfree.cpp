@@ -0,0 +1,81 @@
+#define BOOST_TEST_MODULE fluid jacobian-free testsuite
+#include <feel/feelcore/testsuite.hpp>
+#include <feel/feelmodels/fluid/fluidmechanics.hpp>
+
+using namespace Feel;
+
+inline
+po::options_description makeOptions()
+{
+    po::options_description options( "Test Fluid Jacobian-Free Options" );
+
+    options.add( feel_options() );
+    options.add( toolboxes_options("fluid") );
+    options.add( toolboxes_options("fluid","fluid_jfnk") );
+    options.add( toolboxes_options("fluid","fluid_jfnk_rhs") );
+    return options;
+}
+
+inline
+AboutData
+makeAbout()
+{
+    AboutData about( "test_fluid_jacobianfree" ,
+                     "test_fluid_jacobianfree" ,
+                     "0.1",
+                     "Fluid Jacobian-free Newton-Krylov test",
+                     Feel::AboutData::License_GPL,
+                     "Copyright (c) 2024 Feel++ Consortium" );
+
+    return about;
+}
+
+FEELPP_ENVIRONMENT_WITH_OPTIONS( makeAbout(), makeOptions() );
+
+BOOST_AUTO_TEST_SUITE( fluid_jacobianfree )
+
+BOOST_AUTO_TEST_CASE( test_newton_dirichlet )
+{
+    using model_type = FeelModels::FluidMechanics< Simplex<2,1>,
+                                                   Lagrange<2, Vectorial,Continuous,PointSetFekete>,
+                                                   Lagrange<1, Scalar,Continuous,PointSetFekete> >;
+
+    // reference : Newton with the assembled jacobian
+    auto fluidRef = model_type::New( "fluid" );
+    fluidRef->init();
+    BOOST_REQUIRE( fluidRef->isStationary() );
+    BOOST_REQUIRE( fluidRef->solverName() == "Newton" );
+    fluidRef->solve();
+
+    auto mesh = fluidRef->mesh();
+    auto const& uRef = fluidRef->fieldVelocity();
+    auto const& pRef = fluidRef->fieldPressure();
+    double normRefVelocity = normL2( _range=elements( mesh ), _expr=idv( uRef ) );
+    double normRefPressure = normL2( _range=elements( mesh ), _expr=idv( pRef ) );
+    BOOST_REQUIRE_GT( normRefVelocity, 0. );
+    BOOST_REQUIRE_GT( normRefPressure, 0. );
+
+    // the Dirichlet rows are x-g in the jacobian-free residual with or without the dof elimination on the initial guess
+    for ( std::string prefix : { "fluid_jfnk", "fluid_jfnk_rhs" } )
+    {
+        BOOST_TEST_MESSAGE( "jacobian-free Newton-Krylov with " << prefix );
+        auto fluid = model_type::New( prefix );
+        fluid->setMesh( mesh );
+        fluid->init();
+        fluid->solve();
+
+        auto const& u = fluid->fieldVelocity();
+        auto const& p = fluid->fieldPressure();
+        double errInlet = normL2( _range=markedfaces( mesh, "inlet" ), _expr=idv( u ) - vec( 4*Py()*(1-Py()), cst( 0. ) ) );
+        double errWall = normL2( _range=markedfaces( mesh, "wall" ), _expr=idv( u ) );
+        double errVelocity = normL2( _range=elements( mesh ), _expr=idv( u ) - idv( uRef ) );
+        double errPressure = normL2( _range=elements( mesh ), _expr=idv( p ) - idv( pRef ) );
+        BOOST_TEST_MESSAGE( "error velocity " << errVelocity << " pressure " << errPressure );
+        BOOST_CHECK_SMALL( errInlet, 1e-8 );
+        BOOST_CHECK_SMALL( errWall, 1e-8 );
+        BOOST_CHECK_SMALL( errVelocity/normRefVelocity, 1e-6 );
+        BOOST_CHECK_SMALL( errPressure/normRefPressure, 1e-6 );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
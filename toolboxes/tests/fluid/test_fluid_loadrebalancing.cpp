@@ -0,0 +1,98 @@
+#define BOOST_TEST_MODULE fluid load rebalancing testsuite
+#include <feel/feelcore/testsuite.hpp>
+#include <feel/feelmodels/fluid/fluidmechanics.hpp>
+
+using namespace Feel;
+
+inline
+po::options_description makeOptions()
+{
+    po::options_description options( "Test Fluid Load Rebalancing Options" );
+
+    options.add( feel_options() );
+    options.add( toolboxes_options("fluid") );
+    return options;
+}
+
+inline
+AboutData
+makeAbout()
+{
+    AboutData about( "test_fluid_loadrebalancing" ,
+                     "test_fluid_loadrebalancing" ,
+                     "0.1",
+                     "Fluid load rebalancing test",
+                     Feel::AboutData::License_GPL,
+                     "Copyright (c) 2024 Feel++ Consortium" );
+
+    return about;
+}
+
+FEELPP_ENVIRONMENT_WITH_OPTIONS( makeAbout(), makeOptions() );
+
+BOOST_AUTO_TEST_SUITE( fluid_loadrebalancing )
+
+BOOST_AUTO_TEST_CASE( test_migration_bdf )
+{
+    using model_type = FeelModels::FluidMechanics< Simplex<2,1>,
+                                                   Lagrange<2, Vectorial,Continuous,PointSetFekete>,
+                                                   Lagrange<1, Scalar,Continuous,PointSetFekete> >;
+    auto fluid = model_type::New( "fluid" );
+    fluid->init();
+    BOOST_REQUIRE( !fluid->isStationary() );
+    BOOST_REQUIRE_GE( fluid->timeStepBDF()->timeOrder(), 2 );
+
+    if ( fluid->worldComm().localSize() == 1 )
+    {
+        BOOST_TEST_MESSAGE( "the load rebalancing needs several processes" );
+        return;
+    }
+
+    auto normL2Velocity = []( auto const& u ) {
+        return normL2( _range=elements( u.functionSpace()->mesh() ), _expr=idv( u ) );
+    };
+
+    int nMigration = 0;
+    for ( fluid->startTimeStep(); !fluid->timeStepBase()->isFinished(); )
+    {
+        fluid->solve();
+
+        auto oldMesh = fluid->mesh();
+        auto bdf = fluid->timeStepBDF();
+        double normVelocity = normL2Velocity( fluid->fieldVelocity() );
+        double normPreviousVelocity = normL2Velocity( bdf->unknown( 0 ) );
+        double timeNext = bdf->time() + bdf->timeStep();
+        size_type nEltMaster = nelements( elements( oldMesh ), false );
+
+        // once the BDF history holds two nonzero steps, charge the master rank a
+        // cost far above the assembly cost of the other ranks
+        bool isImbalanced = ( bdf->iteration() == 2 );
+        if ( isImbalanced && fluid->worldComm().isMasterRank() )
+            fluid->addElementCost( fluid->keyword(), elements( oldMesh ), 1e3 );
+
+        fluid->updateTimeStep();
+
+        if ( fluid->mesh() == oldMesh )
+        {
+            BOOST_CHECK( !isImbalanced );
+            continue;
+        }
+        ++nMigration;
+        BOOST_TEST_MESSAGE( "mesh migrated at time " << bdf->time() );
+
+        // the master rank gives elements away
+        if ( isImbalanced && fluid->worldComm().isMasterRank() )
+            BOOST_CHECK_LT( nelements( elements( fluid->mesh() ), false ), nEltMaster );
+
+        // the fields and the BDF history are transferred on the new partition
+        bdf = fluid->timeStepBDF();
+        BOOST_CHECK( bdf->unknown( 0 ).functionSpace()->mesh() == fluid->mesh() );
+        BOOST_CHECK_SMALL( normL2Velocity( fluid->fieldVelocity() ) - normVelocity, 1e-10 );
+        BOOST_CHECK_SMALL( normL2Velocity( bdf->unknown( 0 ) ) - normVelocity, 1e-10 );
+        BOOST_CHECK_SMALL( normL2Velocity( bdf->unknown( 1 ) ) - normPreviousVelocity, 1e-10 );
+        BOOST_CHECK_SMALL( bdf->time() - timeNext, 1e-12 );
+    }
+    BOOST_CHECK_GT( nMigration, 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()